@@ -0,0 +1,134 @@
+﻿/**
+ * ArrayItemProcess 性能测试（原 examples/ArrayItemProcessTest 中的计时部分）
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/ArrayItemProcess.h>
+
+using namespace hgl;
+
+namespace
+{
+    struct Pod
+    {
+        int a{};
+        int b{};
+    };
+
+    void BM_RawTypeEqual(BenchmarkState &state)
+    {
+        const int count=int(state.GetArg());
+
+        std::vector<int> src(count),dst(count);
+
+        for(int i=0;i<count;i++)
+            src[i]=i*7+13;
+
+        RawTypeArrayItemProcessCallback<int> cb;
+
+        for(auto _:state)
+        {
+            cb.Equal(dst.data(),src.data(),count);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(uint64(count)*sizeof(int));
+    }
+
+    void BM_MemoryEqualPod(BenchmarkState &state)
+    {
+        const int count=int(state.GetArg());
+
+        std::vector<Pod> src(count),dst(count);
+
+        for(int i=0;i<count;i++)
+            src[i]=Pod{i,i*2};
+
+        MemoryArrayItemProcessCallback<Pod> cb;
+
+        for(auto _:state)
+        {
+            cb.Equal(dst.data(),src.data(),count);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(uint64(count)*sizeof(Pod));
+    }
+
+    /**
+     * 查找不存在的值，遍历整个数组（最差情况）
+     */
+    void BM_FindDataPositionInArray(BenchmarkState &state)
+    {
+        const int count=int(state.GetArg());
+
+        std::vector<int> data(count);
+
+        for(int i=0;i<count;i++)
+            data[i]=i*3+7;
+
+        int key=-9999;
+
+        for(auto _:state)
+        {
+            DoNotOptimize(key);
+            DoNotOptimize(FindDataPositionInArray(data.data(),int64(count),key));
+        }
+
+        state.SetBytesProcessed(uint64(count)*sizeof(int));
+    }
+
+    void BM_FindDataPositionInSortedArray(BenchmarkState &state)
+    {
+        const int count=int(state.GetArg());
+
+        std::vector<int> data(count);
+
+        for(int i=0;i<count;i++)
+            data[i]=i*2;
+
+        uint32 seed=1;
+
+        for(auto _:state)
+        {
+            seed=seed*1664525+1013904223;
+
+            const int value=int((seed>>8)%uint32(count))*2;
+
+            DoNotOptimize(FindDataPositionInSortedArray(data.data(),int64(count),value));
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_FindInsertPositionInSortedArray(BenchmarkState &state)
+    {
+        const int count=int(state.GetArg());
+
+        std::vector<int> data(count);
+
+        for(int i=0;i<count;i++)
+            data[i]=i*10;
+
+        uint32 seed=1;
+        int64 pos;
+
+        for(auto _:state)
+        {
+            seed=seed*1664525+1013904223;
+
+            const int value=int((seed>>8)%uint32(count*10));
+
+            DoNotOptimize(FindInsertPositionInSortedArray(&pos,data.data(),int64(count),value));
+            DoNotOptimize(pos);
+        }
+
+        state.SetItemsProcessed(1);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_RawTypeEqual)->Arg(100)->Arg(1000)->Arg(10000);
+HGL_BENCHMARK(BM_MemoryEqualPod)->Arg(100)->Arg(1000)->Arg(10000);
+HGL_BENCHMARK(BM_FindDataPositionInArray)->Arg(100)->Arg(1000)->Arg(10000);
+HGL_BENCHMARK(BM_FindDataPositionInSortedArray)->Arg(100)->Arg(1000)->Arg(10000);
+HGL_BENCHMARK(BM_FindInsertPositionInSortedArray)->Arg(100)->Arg(1000)->Arg(10000);
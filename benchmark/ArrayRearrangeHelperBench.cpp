@@ -0,0 +1,104 @@
+﻿/**
+ * ArrayRearrangeHelper 性能测试（原 examples/ArrayRearrangeHelperTest 中的计时部分）
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/ArrayRearrangeHelper.h>
+#include<hgl/type/MemoryAlloc.h>
+#include<hgl/type/ObjectUtil.h>
+#include<string>
+
+using namespace hgl;
+
+namespace
+{
+    struct Item
+    {
+        std::string text;
+    };
+
+    /**
+     * 前后两半交换
+     */
+    void BM_RearrangeSwapHalves(BenchmarkState &state)
+    {
+        const int64 count=state.GetArg();
+        const int64 half=count/2;
+
+        std::vector<int> src(count),dst(count);
+
+        for(int64 i=0;i<count;i++)
+            src[i]=int(i);
+
+        for(auto _:state)
+        {
+            DoNotOptimize(ArrayRearrange(dst.data(),src.data(),count,{half,count-half},{1,0}));
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(uint64(count)*sizeof(int));
+    }
+
+    /**
+     * 每个元素一个字段，逆序排列（字段数最多的情况，含 ArrayRearrangeHelper 的构造）
+     */
+    void BM_RearrangeReverse(BenchmarkState &state)
+    {
+        const int64 count=state.GetArg();
+
+        std::vector<int> src(count),dst(count);
+        std::vector<int64> index(count);
+
+        for(int64 i=0;i<count;i++)
+        {
+            src[i]=int(i);
+            index[i]=count-1-i;
+        }
+
+        for(auto _:state)
+        {
+            ArrayRearrangeHelper helper(count,count);
+
+            for(int64 i=0;i<count;i++)
+                helper.AddField(1);
+
+            DoNotOptimize(helper.Rearrange(dst.data(),src.data(),index.data()));
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(uint64(count)*sizeof(int));
+    }
+
+    /**
+     * 非平凡类型分4段打乱，每次迭代后析构目标数组（不计时）
+     */
+    void BM_RearrangeNonTrivial(BenchmarkState &state)
+    {
+        const int64 count=state.GetArg();
+        const int64 quarter=count/4;
+
+        std::vector<Item> src(count);
+
+        for(int64 i=0;i<count;i++)
+            src[i].text="item "+std::to_string(i);
+
+        Item *dst=array_alloc<Item>(count);
+
+        for(auto _:state)
+        {
+            DoNotOptimize(ArrayRearrange(dst,src.data(),count,{quarter,quarter,quarter,count-quarter*3},{2,0,3,1}));
+
+            state.PauseTiming();
+            destroy_range(dst,count);
+            state.ResumeTiming();
+        }
+
+        array_free(dst);
+
+        state.SetItemsProcessed(uint64(count));
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_RearrangeSwapHalves)->Arg(100)->Arg(1000)->Arg(10000);
+HGL_BENCHMARK(BM_RearrangeReverse)->Arg(100)->Arg(1000)->Arg(10000);
+HGL_BENCHMARK(BM_RearrangeNonTrivial)->Arg(100)->Arg(1000)->Arg(10000);
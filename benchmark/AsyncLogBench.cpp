@@ -0,0 +1,197 @@
+﻿/**
+ * 异步日志调用线程开销与多线程吞吐（原 examples/AsyncLogTest 中的计时部分）
+ *
+ * 调用开销：每次迭代在调用线程写 BATCH 条，迭代之间不计时地 Flush，只计调用线程的开销，
+ * 与同步 strfmt/snprintf+write 对比。输出到 /dev/null。
+ * 多线程吞吐：参数为写日志的线程数，共写 TOTAL_RECORDS 条（Block 策略，不丢弃），计到全部写出为止。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/log/AsyncLog.h>
+#include<hgl/type/ByteSink.h>
+#include<hgl/time/TscClock.h>
+#include<vector>
+#include<string>
+#include<thread>
+#include<cstdio>
+#include<cstdlib>
+#include<unistd.h>
+#include<fcntl.h>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr int BATCH=1024;
+    constexpr int TOTAL_RECORDS=1<<16;
+
+    /**
+     * 输出到 /dev/null 的日志会话
+     */
+    class NullLogSession
+    {
+        FdByteSink sink;
+
+    public:
+
+        explicit NullLogSession(const LogOverflowPolicy overflow):sink(open("/dev/null",O_WRONLY),true)
+        {
+            LogConfig config;
+
+            config.sink=&sink;
+            config.overflow=overflow;
+            config.thread_buffer_size=4*1024*1024;                  //调用线程的缓冲区在首次写日志时按此分配，之后的会话沿用
+            config.flush_interval_us=1000000;
+
+            AsyncLog::Start(config);
+        }
+
+        ~NullLogSession()
+        {
+            AsyncLog::Stop();
+        }
+
+        NO_COPY_NO_MOVE(NullLogSession)
+    };//class NullLogSession
+
+    template<typename F>
+    void CallerCost(BenchmarkState &state,F &&body)
+    {
+        NullLogSession session(LogOverflowPolicy::Drop);
+
+        for(int w=0;w<100;w++)                                      //先写过约一整个环，排除首次访问内存页的开销
+        {
+            for(int i=0;i<BATCH;i++)
+                body(i);
+
+            AsyncLog::Flush();
+        }
+
+        const uint64 dropped=AsyncLog::GetDroppedCount();
+
+        for(auto _:state)
+        {
+            for(int i=0;i<BATCH;i++)
+                body(i);
+
+            state.PauseTiming();
+            AsyncLog::Flush();
+            state.ResumeTiming();
+        }
+
+        state.SetItemsProcessed(BATCH);
+
+        if(AsyncLog::GetDroppedCount()!=dropped)
+            state.SetLabel("dropped "+std::to_string(AsyncLog::GetDroppedCount()-dropped));
+    }
+
+    void BM_AsyncLogNoArgs(BenchmarkState &state)
+    {
+        CallerCost(state,[](int){HGL_LOG_INFO("service started");});
+    }
+
+    void BM_AsyncLog3Ints(BenchmarkState &state)
+    {
+        CallerCost(state,[](int i){HGL_LOG_INFO("request {} status {} bytes {}",i,200,i*3);});
+    }
+
+    void BM_AsyncLogIntDoubleString(BenchmarkState &state)
+    {
+        const std::string host="192.168.1.20";
+
+        CallerCost(state,[&](int i){HGL_LOG_INFO("request {} from {} took {:.3f} ms",i,host,i*0.001);});
+    }
+
+    void BM_AsyncLogDisabledLevel(BenchmarkState &state)
+    {
+        CallerCost(state,[](int i){HGL_LOG_DEBUG("request {} status {} bytes {}",i,200,i*3);});
+    }
+
+    void BM_TscClockNowPerRecord(BenchmarkState &state)             //每条日志都要读一次时钟
+    {
+        uint64 sum=0;
+
+        for(auto _:state)
+            for(int i=0;i<BATCH;i++)
+                sum+=TscClock::Now();
+
+        DoNotOptimize(sum);
+        state.SetItemsProcessed(BATCH);
+    }
+
+    /**
+     * 同步写法的对照：格式化后立即write
+     */
+    void BM_SyncStrfmtWrite(BenchmarkState &state)
+    {
+        const int fd=open("/dev/null",O_WRONLY);
+        char buf[256];
+
+        for(auto _:state)
+            for(int i=0;i<BATCH;i++)
+            {
+                const int len=strfmt(buf,int(sizeof(buf)),"request {} status {} bytes {}\n",i,200,i*3);
+
+                if(write(fd,buf,size_t(len))<0)
+                    abort();
+            }
+
+        close(fd);
+        state.SetItemsProcessed(BATCH);
+    }
+
+    void BM_SyncSnprintfWrite(BenchmarkState &state)
+    {
+        const int fd=open("/dev/null",O_WRONLY);
+        char buf[256];
+
+        for(auto _:state)
+            for(int i=0;i<BATCH;i++)
+            {
+                const int len=snprintf(buf,sizeof(buf),"request %d status %d bytes %d\n",i,200,i*3);
+
+                if(write(fd,buf,size_t(len))<0)
+                    abort();
+            }
+
+        close(fd);
+        state.SetItemsProcessed(BATCH);
+    }
+
+    void BM_AsyncLogThreads(BenchmarkState &state)
+    {
+        const int thread_count=int(state.GetArg());
+        const int per_thread=TOTAL_RECORDS/thread_count;
+
+        NullLogSession session(LogOverflowPolicy::Block);
+
+        for(auto _:state)
+        {
+            std::vector<std::thread> threads;
+
+            for(int t=0;t<thread_count;t++)
+                threads.emplace_back([per_thread,t]
+                {
+                    for(int i=0;i<per_thread;i++)
+                        HGL_LOG_INFO("thread {} request {} status {}",t,i,200);
+                });
+
+            for(auto &th:threads)
+                th.join();
+
+            AsyncLog::Flush();
+        }
+
+        state.SetItemsProcessed(uint64(per_thread)*thread_count);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_AsyncLogNoArgs);
+HGL_BENCHMARK(BM_AsyncLog3Ints);
+HGL_BENCHMARK(BM_AsyncLogIntDoubleString);
+HGL_BENCHMARK(BM_AsyncLogDisabledLevel);
+HGL_BENCHMARK(BM_TscClockNowPerRecord);
+HGL_BENCHMARK(BM_SyncStrfmtWrite);
+HGL_BENCHMARK(BM_SyncSnprintfWrite);
+
+HGL_BENCHMARK(BM_AsyncLogThreads)->Range(1,8,2);
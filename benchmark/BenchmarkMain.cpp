@@ -0,0 +1,3 @@
+﻿#include<hgl/benchmark/Benchmark.h>
+
+HGL_BENCHMARK_MAIN()
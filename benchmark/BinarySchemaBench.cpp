@@ -0,0 +1,212 @@
+﻿/**
+ * BinarySchema 编解码速度（原 examples/BinarySchemaTest 中的计时部分）
+ *
+ * 对比手写ByteSpanWriter/Reader代码、Schema Packed格式与Schema Tagged(类protobuf)格式。
+ * 参数为MeshRecord个数，标签给出编码后的大小。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/BinarySchema.h>
+#include<random>
+#include<string>
+
+using namespace hgl;
+
+namespace
+{
+    enum class LodMode:uint8
+    {
+        Auto=0,
+        Fixed,
+        Dither
+    };
+
+    struct Transform                                                    //无Schema，整体按内存存储
+    {
+        float position[3];
+        float rotation[4];
+        float scale[3];
+    };
+
+    struct MeshRecord
+    {
+        uint32      id=0;
+        uint16      flags=0;
+        LodMode     lod=LodMode::Auto;
+        uint8       pad=0;
+        float       bounds[6]={};
+        Transform   transform={};
+        bool        visible=true;
+        int32       layer=0;
+        std::string name;
+        std::vector<float>  weights;
+        std::vector<uint32> indices;
+    };
+
+    //id..transform 在内存中连续，整段memcpy
+    HGL_SCHEMA(MeshRecord,1,
+        HGL_SCHEMA_FIELD(id,1),
+        HGL_SCHEMA_FIELD(flags,2),
+        HGL_SCHEMA_FIELD(lod,3),
+        HGL_SCHEMA_FIELD(pad,4),
+        HGL_SCHEMA_FIELD(bounds,5),
+        HGL_SCHEMA_FIELD(transform,6),
+        HGL_SCHEMA_FIELD(visible,7),
+        HGL_SCHEMA_FIELD(layer,8),
+        HGL_SCHEMA_FIELD(name,9),
+        HGL_SCHEMA_FIELD(weights,10),
+        HGL_SCHEMA_FIELD(indices,11))
+
+    std::vector<MeshRecord> MakeMeshes(const uint32 count)
+    {
+        std::mt19937 rng(1234);
+        std::vector<MeshRecord> meshes(count);
+
+        for(uint32 id=0;id<count;id++)
+        {
+            MeshRecord &m=meshes[id];
+
+            m.id=id;
+            m.flags=uint16(rng());
+            m.lod=LodMode(rng()%3);
+            for(float &b:m.bounds)b=float(rng()%1000)*0.5f;
+            for(int i=0;i<3;i++){m.transform.position[i]=float(i);m.transform.scale[i]=1.0f;}
+            m.transform.rotation[3]=1.0f;
+            m.visible=(rng()&1);
+            m.layer=int32(rng()%64)-32;
+            m.name="mesh_"+std::to_string(id);
+            m.weights.resize(rng()%8);
+            for(float &w:m.weights)w=float(rng()%100)/100.0f;
+            m.indices.resize(rng()%64);
+            for(uint32 &i:m.indices)i=rng()%4096;
+        }
+
+        return meshes;
+    }
+
+    //手写代码：与Packed正文布局相同，但不带版本与长度
+    bool HandWrite(ByteSpanWriter &w,const MeshRecord &m)
+    {
+        return w.u32(m.id)&&w.u16(m.flags)&&w.u8(uint8(m.lod))&&w.u8(m.pad)
+            &&w.array(m.bounds,6)
+            &&w.array(m.transform.position,3)&&w.array(m.transform.rotation,4)&&w.array(m.transform.scale,3)
+            &&w.u8(m.visible)&&w.i32(m.layer)
+            &&w.string(m.name)
+            &&w.varu64(m.weights.size())&&w.array(m.weights.data(),m.weights.size())
+            &&w.varu64(m.indices.size())&&w.array(m.indices.data(),m.indices.size());
+    }
+
+    bool HandRead(ByteSpanReader &r,MeshRecord &m)
+    {
+        uint8 lod,visible;
+        uint64 count;
+
+        if(!(r.u32(m.id)&&r.u16(m.flags)&&r.u8(lod)&&r.u8(m.pad)
+           &&r.array(m.bounds,6)
+           &&r.array(m.transform.position,3)&&r.array(m.transform.rotation,4)&&r.array(m.transform.scale,3)
+           &&r.u8(visible)&&r.i32(m.layer)
+           &&r.string(m.name)))
+            return false;
+
+        m.lod=LodMode(lod);
+        m.visible=visible;
+
+        return r.varu64(count)&&r.array(m.weights,size_t(count))
+             &&r.varu64(count)&&r.array(m.indices,size_t(count));
+    }
+
+    bool PackedWrite(ByteSpanWriter &w,const MeshRecord &m){return SchemaWrite(w,m);}
+    bool PackedRead(ByteSpanReader &r,MeshRecord &m){return SchemaRead(r,m);}
+
+    bool TaggedWrite(ByteSpanWriter &w,const MeshRecord &m)
+    {
+        return w.varu64(SchemaTaggedSize(m))&&SchemaWriteTagged(w,m);
+    }
+
+    bool TaggedRead(ByteSpanReader &r,MeshRecord &m)
+    {
+        uint64 length;
+        const uint8 *p;
+
+        if(!r.varu64(length)||!r.bytes_view(p,size_t(length)))
+            return false;
+
+        m.weights.clear();                                              //Tagged的数组是追加语义
+        m.indices.clear();
+
+        ByteSpanReader sub(p,size_t(length));
+        return SchemaReadTagged(sub,m);
+    }
+
+    using WriteFunc=bool(*)(ByteSpanWriter &,const MeshRecord &);
+    using ReadFunc=bool(*)(ByteSpanReader &,MeshRecord &);
+
+    void Encode(BenchmarkState &state,WriteFunc write)
+    {
+        const std::vector<MeshRecord> meshes=MakeMeshes(uint32(state.GetArg()));
+        std::vector<uint8> buffer(meshes.size()*512);
+        size_t bytes=0;
+
+        for(auto _:state)
+        {
+            ByteSpanWriter w(buffer.data(),buffer.size());
+
+            for(const MeshRecord &m:meshes)
+                if(!write(w,m))
+                {
+                    state.SetLabel("encode failed");
+                    return;
+                }
+
+            bytes=w.tell();
+            ClobberMemory();
+        }
+
+        state.SetItemsProcessed(meshes.size());
+        state.SetLabel("size "+std::to_string(bytes/1024)+" KB");
+    }
+
+    void Decode(BenchmarkState &state,WriteFunc write,ReadFunc read)
+    {
+        const std::vector<MeshRecord> meshes=MakeMeshes(uint32(state.GetArg()));
+        std::vector<uint8> buffer(meshes.size()*512);
+        std::vector<MeshRecord> decoded(meshes.size());
+
+        ByteSpanWriter w(buffer.data(),buffer.size());
+
+        for(const MeshRecord &m:meshes)
+            write(w,m);
+
+        const size_t bytes=w.tell();
+
+        for(auto _:state)
+        {
+            ByteSpanReader r(buffer.data(),bytes);
+
+            for(MeshRecord &m:decoded)
+                if(!read(r,m))
+                {
+                    state.SetLabel("decode failed");
+                    return;
+                }
+
+            ClobberMemory();
+        }
+
+        state.SetItemsProcessed(meshes.size());
+    }
+
+    void BM_HandWrittenEncode(BenchmarkState &state){Encode(state,HandWrite);}
+    void BM_HandWrittenDecode(BenchmarkState &state){Decode(state,HandWrite,HandRead);}
+    void BM_SchemaPackedEncode(BenchmarkState &state){Encode(state,PackedWrite);}
+    void BM_SchemaPackedDecode(BenchmarkState &state){Decode(state,PackedWrite,PackedRead);}
+    void BM_SchemaTaggedEncode(BenchmarkState &state){Encode(state,TaggedWrite);}
+    void BM_SchemaTaggedDecode(BenchmarkState &state){Decode(state,TaggedWrite,TaggedRead);}
+}//namespace
+
+HGL_BENCHMARK(BM_HandWrittenEncode)->Arg(200000);
+HGL_BENCHMARK(BM_HandWrittenDecode)->Arg(200000);
+HGL_BENCHMARK(BM_SchemaPackedEncode)->Arg(200000);
+HGL_BENCHMARK(BM_SchemaPackedDecode)->Arg(200000);
+HGL_BENCHMARK(BM_SchemaTaggedEncode)->Arg(200000);
+HGL_BENCHMARK(BM_SchemaTaggedDecode)->Arg(200000);
@@ -0,0 +1,209 @@
+﻿/**
+ * BitVector 批量运算、位计数、遍历与rank/select（原 examples/BitVectorTest 中的计时部分）
+ *
+ * 参数为位数量。Scalar 为逐字的标量实现，其余按 GetCpuTier() 分派。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/BitVector.h>
+#include<vector>
+#include<random>
+
+using namespace hgl;
+using namespace hgl::bit_vector_detail;
+
+namespace
+{
+    void RandomWords(BitVector &bv,std::mt19937_64 &rng,const bool sparse_and)
+    {
+        for(size_t i=0;i<bv.GetWordCount();i++)
+            bv.GetData()[i]=sparse_and?rng()&rng():rng();
+    }
+
+    void BM_BitVectorXorScalar(BenchmarkState &state)
+    {
+        std::mt19937_64 rng(5);
+        BitVector a(size_t(state.GetArg())),b(size_t(state.GetArg()));
+        RandomWords(a,rng,false);
+        RandomWords(b,rng,true);
+
+        for(auto _:state)
+        {
+            BulkScalar<BitOp::Xor>(a.GetData(),b.GetData(),a.GetWordCount());
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(a.GetWordCount()*sizeof(uint64));
+    }
+
+    void BM_BitVectorXor(BenchmarkState &state)
+    {
+        std::mt19937_64 rng(5);
+        BitVector a(size_t(state.GetArg())),b(size_t(state.GetArg()));
+        RandomWords(a,rng,false);
+        RandomWords(b,rng,true);
+
+        for(auto _:state)
+        {
+            a.Xor(b);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(a.GetWordCount()*sizeof(uint64));
+        state.SetLabel(GetCpuTierName(GetCpuTier()));
+    }
+
+    void BM_BitVectorCountScalar(BenchmarkState &state)
+    {
+        std::mt19937_64 rng(5);
+        BitVector a(size_t(state.GetArg()));
+        RandomWords(a,rng,false);
+
+        for(auto _:state)
+            DoNotOptimize(PopCountScalar(a.GetData(),a.GetWordCount()));
+
+        state.SetBytesProcessed(a.GetWordCount()*sizeof(uint64));
+    }
+
+    void BM_BitVectorCount(BenchmarkState &state)
+    {
+        std::mt19937_64 rng(5);
+        BitVector a(size_t(state.GetArg()));
+        RandomWords(a,rng,false);
+
+        for(auto _:state)
+            DoNotOptimize(a.Count());
+
+        state.SetBytesProcessed(a.GetWordCount()*sizeof(uint64));
+        state.SetLabel(GetCpuTierName(GetCpuTier()));
+    }
+
+    /**
+     * 0.1%的位被置1
+     */
+    BitVector MakeSparse(const size_t bit_count)
+    {
+        std::mt19937_64 rng(5);
+        BitVector sparse(bit_count);
+
+        for(size_t i=0;i<bit_count/1000;i++)
+            sparse.Set(rng()%bit_count);
+
+        return sparse;
+    }
+
+    void BM_PerBitIterateSparse(BenchmarkState &state)
+    {
+        const BitVector sparse=MakeSparse(size_t(state.GetArg()));
+        const size_t bit_count=sparse.GetCount();
+
+        for(auto _:state)
+        {
+            uint64 sum=0;
+
+            for(size_t i=0;i<bit_count;i++)
+                if(sparse[i])sum+=i;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetBytesProcessed(sparse.GetWordCount()*sizeof(uint64));
+    }
+
+    void BM_ForEachSetBitSparse(BenchmarkState &state)
+    {
+        const BitVector sparse=MakeSparse(size_t(state.GetArg()));
+
+        for(auto _:state)
+        {
+            uint64 sum=0;
+
+            sparse.ForEachSetBit([&](size_t i){sum+=i;});
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetBytesProcessed(sparse.GetWordCount()*sizeof(uint64));
+    }
+
+    constexpr size_t QUERY_COUNT=1<<20;                                 ///<rank/select每次迭代的查询数
+
+    void BM_BitVectorBuildRankIndex(BenchmarkState &state)
+    {
+        std::mt19937_64 rng(5);
+        BitVector rs(size_t(state.GetArg()));
+        RandomWords(rs,rng,false);
+
+        for(auto _:state)
+        {
+            state.PauseTiming();
+            rs.Flip(0);                                                 //使索引失效
+            state.ResumeTiming();
+
+            rs.BuildRankIndex();
+        }
+
+        state.SetBytesProcessed(rs.GetWordCount()*sizeof(uint64));
+        state.SetLabel("index "+std::to_string(rs.GetRankIndexBytes()/1024)+" KB");
+    }
+
+    void BM_BitVectorRank1(BenchmarkState &state)
+    {
+        std::mt19937_64 rng(5);
+        BitVector rs(size_t(state.GetArg()));
+        RandomWords(rs,rng,false);
+        rs.BuildRankIndex();
+
+        std::vector<uint64> queries(QUERY_COUNT);
+        for(auto &q:queries)q=rng()%rs.GetCount();
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+
+            for(uint64 q:queries)
+                sum+=rs.Rank1(q);
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+
+    void BM_BitVectorSelect1(BenchmarkState &state)
+    {
+        std::mt19937_64 rng(5);
+        BitVector rs(size_t(state.GetArg()));
+        RandomWords(rs,rng,false);
+        rs.BuildRankIndex();
+
+        const uint64 ones=uint64(rs.Rank1(rs.GetCount()));
+
+        std::vector<uint64> queries(QUERY_COUNT);
+        for(auto &q:queries)q=rng()%ones;
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+
+            for(uint64 q:queries)
+                sum+=rs.Select1(q);
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_BitVectorXorScalar)->Range(1<<16,1<<28,16);
+HGL_BENCHMARK(BM_BitVectorXor)->Range(1<<16,1<<28,16);
+HGL_BENCHMARK(BM_BitVectorCountScalar)->Range(1<<16,1<<28,16);
+HGL_BENCHMARK(BM_BitVectorCount)->Range(1<<16,1<<28,16);
+
+HGL_BENCHMARK(BM_PerBitIterateSparse)->Range(1<<16,1<<28,16);
+HGL_BENCHMARK(BM_ForEachSetBitSparse)->Range(1<<16,1<<28,16);
+
+HGL_BENCHMARK(BM_BitVectorBuildRankIndex)->Range(1<<16,1<<28,16);
+HGL_BENCHMARK(BM_BitVectorRank1)->Range(1<<16,1<<28,16);
+HGL_BENCHMARK(BM_BitVectorSelect1)->Range(1<<16,1<<28,16);
@@ -0,0 +1,183 @@
+﻿/**
+ * ByteSpanReader/ByteSpanWriter 与 ByteReader/ByteWriter 吞吐量（原 examples/ByteSpanBufferTest 中的计时部分）
+ *
+ * 参数为u32个数，数值按随机位宽生成，使变长编码长度分布在1~5字节。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/ByteSpanBuffer.h>
+#include<hgl/type/StdByteBuffer.h>
+#include<random>
+
+using namespace hgl;
+
+namespace
+{
+    std::vector<uint32> MakeValues(const size_t count)
+    {
+        std::vector<uint32> values(count);
+        std::mt19937 rng(1234);
+
+        for(auto &v:values)
+            v=rng()>>(rng()%32);
+
+        return values;
+    }
+
+    std::vector<uint8_t> MakeFixedBytes(const std::vector<uint32> &values)
+    {
+        std::vector<uint8_t> vec;
+        ByteWriter w(vec);
+
+        for(uint32 v:values)
+            w.u32(v);
+
+        return vec;
+    }
+
+    void BM_ByteWriterU32(BenchmarkState &state)
+    {
+        const std::vector<uint32> values=MakeValues(size_t(state.GetArg()));
+
+        for(auto _:state)
+        {
+            std::vector<uint8_t> vec;                               //包含vector增长的开销
+            ByteWriter w(vec);
+
+            for(uint32 v:values)
+                w.u32(v);
+
+            DoNotOptimize(vec.data());
+        }
+
+        state.SetBytesProcessed(values.size()*sizeof(uint32));
+    }
+
+    void BM_ByteSpanWriterU32(BenchmarkState &state)
+    {
+        const std::vector<uint32> values=MakeValues(size_t(state.GetArg()));
+        std::vector<uint8> buffer(values.size()*sizeof(uint32));
+
+        for(auto _:state)
+        {
+            ByteSpanWriter w(buffer.data(),buffer.size());
+
+            for(uint32 v:values)
+                w.u32(v);
+
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(values.size()*sizeof(uint32));
+    }
+
+    void BM_ByteSpanWriterU32Unchecked(BenchmarkState &state)
+    {
+        const std::vector<uint32> values=MakeValues(size_t(state.GetArg()));
+        std::vector<uint8> buffer(values.size()*sizeof(uint32));
+
+        for(auto _:state)
+        {
+            ByteSpanWriter w(buffer.data(),buffer.size());
+
+            if(w.require(values.size()*sizeof(uint32)))
+                for(uint32 v:values)
+                    w.u32_unchecked(v);
+
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(values.size()*sizeof(uint32));
+    }
+
+    void BM_ByteReaderU32(BenchmarkState &state)
+    {
+        const std::vector<uint8_t> vec=MakeFixedBytes(MakeValues(size_t(state.GetArg())));
+
+        for(auto _:state)
+        {
+            ByteReader r(vec);
+            uint64 sum=0;
+            uint32 v;
+
+            while(r.u32(v))
+                sum+=v;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetBytesProcessed(vec.size());
+    }
+
+    void BM_ByteSpanReaderU32(BenchmarkState &state)
+    {
+        const std::vector<uint8_t> vec=MakeFixedBytes(MakeValues(size_t(state.GetArg())));
+
+        for(auto _:state)
+        {
+            ByteSpanReader r(vec);
+            uint64 sum=0;
+            uint32 v;
+
+            while(r.u32(v))
+                sum+=v;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetBytesProcessed(vec.size());
+    }
+
+    void BM_ByteSpanWriterVarU32(BenchmarkState &state)
+    {
+        const std::vector<uint32> values=MakeValues(size_t(state.GetArg()));
+        std::vector<uint8> buffer(values.size()*VARINT32_MAX_BYTES);
+
+        for(auto _:state)
+        {
+            ByteSpanWriter w(buffer.data(),buffer.size());
+
+            for(uint32 v:values)
+                w.varu32(v);
+
+            ClobberMemory();
+        }
+
+        state.SetItemsProcessed(values.size());
+    }
+
+    void BM_ByteSpanReaderVarU32(BenchmarkState &state)
+    {
+        const std::vector<uint32> values=MakeValues(size_t(state.GetArg()));
+        std::vector<uint8> buffer(values.size()*VARINT32_MAX_BYTES);
+
+        ByteSpanWriter w(buffer.data(),buffer.size());
+
+        for(uint32 v:values)
+            w.varu32(v);
+
+        const size_t bytes=w.tell();
+
+        for(auto _:state)
+        {
+            ByteSpanReader r(buffer.data(),bytes);
+            uint64 sum=0;
+            uint32 v;
+
+            while(r.varu32(v))
+                sum+=v;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(values.size());
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_ByteWriterU32)->Arg(1<<12)->Arg(1<<22);
+HGL_BENCHMARK(BM_ByteSpanWriterU32)->Arg(1<<12)->Arg(1<<22);
+HGL_BENCHMARK(BM_ByteSpanWriterU32Unchecked)->Arg(1<<12)->Arg(1<<22);
+HGL_BENCHMARK(BM_ByteReaderU32)->Arg(1<<12)->Arg(1<<22);
+HGL_BENCHMARK(BM_ByteSpanReaderU32)->Arg(1<<12)->Arg(1<<22);
+HGL_BENCHMARK(BM_ByteSpanWriterVarU32)->Arg(1<<12)->Arg(1<<22);
+HGL_BENCHMARK(BM_ByteSpanReaderVarU32)->Arg(1<<12)->Arg(1<<22);
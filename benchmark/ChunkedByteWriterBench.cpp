@@ -0,0 +1,124 @@
+﻿/**
+ * ChunkedByteWriter 流式输出与 ByteWriter(vector) 的对比（原 examples/ChunkedByteWriterTest 中的计时部分）
+ *
+ * 参数为输出的u32记录总量(MB)，标签给出写入过程中的内存峰值。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/ChunkedByteWriter.h>
+#include<hgl/type/StdByteBuffer.h>
+#include<string>
+#include<cstdio>
+#include<fcntl.h>
+#include<unistd.h>
+
+using namespace hgl;
+
+namespace
+{
+    std::string TempFileName()
+    {
+        return "/tmp/hgl_chunked_writer_bench_"+std::to_string(getpid())+".bin";
+    }
+
+    /**
+     * 先整体写入std::vector，再一次fwrite
+     */
+    void BM_ByteWriterFwrite(BenchmarkState &state)
+    {
+        const size_t count=size_t(state.GetArg())*1024*1024/sizeof(uint32);
+        const std::string filename=TempFileName();
+        size_t peak=0;
+
+        for(auto _:state)
+        {
+            std::vector<uint8_t> out;
+            ByteWriter w(out);
+
+            for(size_t i=0;i<count;i++)
+                w.u32(uint32(i));
+
+            FILE *fp=fopen(filename.c_str(),"wb");
+
+            if(fp)
+            {
+                fwrite(out.data(),1,out.size(),fp);
+                fclose(fp);
+            }
+
+            peak=out.capacity();
+        }
+
+        std::remove(filename.c_str());
+
+        state.SetBytesProcessed(count*sizeof(uint32));
+        state.SetLabel("peak memory "+std::to_string(peak/1024)+" KB");
+    }
+
+    /**
+     * 分块写入，每批数据块以一次writev写入文件
+     */
+    void BM_ChunkedByteWriterFd(BenchmarkState &state)
+    {
+        const size_t count=size_t(state.GetArg())*1024*1024/sizeof(uint32);
+        const std::string filename=TempFileName();
+        size_t peak=0;
+
+        for(auto _:state)
+        {
+            const int fd=open(filename.c_str(),O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC,0644);
+            FdByteSink sink(fd,true);
+            ChunkedByteWriter w(&sink);
+
+            for(size_t i=0;i<count;i++)
+                w.u32(uint32(i));
+
+            if(!w.Finish())
+            {
+                state.SetLabel("write failed");
+                return;
+            }
+
+            peak=w.GetStats().allocated_blocks*w.GetConfig().block_size;
+        }
+
+        std::remove(filename.c_str());
+
+        state.SetBytesProcessed(count*sizeof(uint32));
+        state.SetLabel("peak memory "+std::to_string(peak/1024)+" KB");
+    }
+
+    /**
+     * 不涉及文件，只测分块写入本身（回调中累加校验和）
+     */
+    void BM_ChunkedByteWriterCallback(BenchmarkState &state)
+    {
+        const size_t count=size_t(state.GetArg())*1024*1024/sizeof(uint32);
+
+        for(auto _:state)
+        {
+            uint64 checksum=0;
+            CallbackByteSink sink([&checksum](const uint8 *data,size_t size)
+            {
+                for(size_t i=0;i<size;i+=64)
+                    checksum+=data[i];
+
+                return true;
+            });
+
+            ChunkedByteWriter w(&sink);
+
+            for(size_t i=0;i<count;i++)
+                w.u32(uint32(i));
+
+            w.Finish();
+            DoNotOptimize(checksum);
+        }
+
+        state.SetBytesProcessed(count*sizeof(uint32));
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_ByteWriterFwrite)->Arg(16)->Arg(256);
+HGL_BENCHMARK(BM_ChunkedByteWriterFd)->Arg(16)->Arg(256);
+HGL_BENCHMARK(BM_ChunkedByteWriterCallback)->Arg(16)->Arg(256);
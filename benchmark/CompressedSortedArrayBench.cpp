@@ -0,0 +1,82 @@
+﻿/**
+ * CompressedSortedArray 查找延迟（原 examples/CompressedSortedArrayTest 中的计时部分）
+ *
+ * 对比原始数组上的 FindDataPositionInSortedArray，一半查询命中。
+ * 参数为相邻ID的最大间隔，标签为压缩后的内存占用。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/CompressedSortedArray.h>
+#include<hgl/type/ArrayItemProcess.h>
+#include<vector>
+#include<random>
+#include<string>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr size_t ID_COUNT       =size_t(1)<<20;
+    constexpr size_t QUERY_COUNT    =size_t(1)<<18;                     ///<每次迭代的查询数
+
+    struct IdData
+    {
+        std::vector<int64> ids;
+        std::vector<int64> queries;
+
+        explicit IdData(const uint64 max_gap):ids(ID_COUNT),queries(QUERY_COUNT)
+        {
+            std::mt19937_64 rng(2);
+            int64 cur=int64(1)<<40;
+
+            for(size_t i=0;i<ID_COUNT;i++)
+            {
+                ids[i]=cur;
+                cur+=int64(rng()%(max_gap+1));
+            }
+
+            for(size_t i=0;i<QUERY_COUNT;i++)
+                queries[i]=(i&1)?ids[rng()%ID_COUNT]:ids[rng()%ID_COUNT]+1;
+        }
+    };
+
+    void BM_SortedInt64ArrayFind(BenchmarkState &state)
+    {
+        const IdData data(uint64(state.GetArg()));
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+
+            for(int64 q:data.queries)
+                sum+=FindDataPositionInSortedArray(data.ids.data(),int64(ID_COUNT),q)>=0;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+        state.SetLabel("memory "+std::to_string(ID_COUNT*sizeof(int64)/1024)+" KB");
+    }
+
+    void BM_CompressedSortedArrayFind(BenchmarkState &state)
+    {
+        const IdData data(uint64(state.GetArg()));
+        CompressedSortedArray<int64> csa(data.ids.data(),int64(ID_COUNT));
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+
+            for(int64 q:data.queries)
+                sum+=csa.Find(q)>=0;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+        state.SetLabel("memory "+std::to_string(csa.GetBytes()/1024)+" KB");
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_SortedInt64ArrayFind)->Range(16,4096,16);
+HGL_BENCHMARK(BM_CompressedSortedArrayFind)->Range(16,4096,16);
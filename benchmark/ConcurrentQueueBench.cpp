@@ -0,0 +1,171 @@
+﻿/**
+ * 并发队列吞吐量与延迟百分位（原 examples/ConcurrentQueueTest 中的计时部分）
+ *
+ * 对比 std::deque+std::mutex+std::condition_variable，容量1024。
+ * 参数为生产者数量（消费者数量相同），标签为从写入到取出的延迟百分位。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/thread/BlockingQueue.h>
+#include<hgl/time/LatencyHistogram.h>
+#include<vector>
+#include<deque>
+#include<string>
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<chrono>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr uint64 TOTAL_ITEMS    =1<<16;                             ///<每次迭代传递的数据量
+    constexpr int    SAMPLE_EVERY   =16;                                ///<每隔多少个数据记录一次延迟
+
+    /**
+     * 现有写法：std::deque+互斥锁+条件变量
+     */
+    class MutexDequeQueue
+    {
+        std::mutex lock;
+        std::condition_variable cv;
+        std::deque<uint64> queue;
+
+    public:
+
+        explicit MutexDequeQueue(size_t){}
+
+        void Push(uint64 v)
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                queue.push_back(v);
+            }
+
+            cv.notify_one();
+        }
+
+        void Pop(uint64 &v)
+        {
+            std::unique_lock<std::mutex> guard(lock);
+
+            cv.wait(guard,[this]{return !queue.empty();});
+
+            v=queue.front();
+            queue.pop_front();
+        }
+    };
+
+    /**
+     * 非阻塞队列的忙等包装
+     */
+    template<typename Q>
+    class SpinQueue
+    {
+        Q queue;
+
+    public:
+
+        explicit SpinQueue(size_t cap):queue(cap){}
+
+        void Push(uint64 v)
+        {
+            Backoff backoff;
+
+            while(!queue.TryPush(v))
+                backoff.Pause();
+        }
+
+        void Pop(uint64 &v)
+        {
+            Backoff backoff;
+
+            while(!queue.TryPop(v))
+                backoff.Pause();
+        }
+    };
+
+    uint64 NowNs()
+    {
+        return uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * 生产者写入当前时间，消费者计算从写入到取出的时间
+     */
+    template<typename Q>
+    void QueueThroughput(BenchmarkState &state)
+    {
+        const int producers=int(state.GetArg());
+        const int consumers=producers;
+
+        const uint64 per_producer=TOTAL_ITEMS/producers;
+        const uint64 total=per_producer*producers;
+
+        Q q(1024);
+        LatencyHistogram latency;
+        std::vector<std::vector<uint64>> samples(consumers);
+
+        for(auto _:state)
+        {
+            std::vector<std::thread> threads;
+
+            for(int p=0;p<producers;p++)
+                threads.emplace_back([&]
+                {
+                    for(uint64 i=0;i<per_producer;i++)
+                        q.Push(NowNs());
+                });
+
+            for(int c=0;c<consumers;c++)
+                threads.emplace_back([&,c]
+                {
+                    const uint64 n=total/consumers+(c==consumers-1?total%consumers:0);    //最后一个消费者补足
+
+                    auto &s=samples[c];
+                    uint64 v;
+
+                    for(uint64 i=0;i<n;i++)
+                    {
+                        q.Pop(v);
+
+                        if(i%SAMPLE_EVERY==0)
+                            s.push_back(NowNs()-v);
+                    }
+                });
+
+            for(auto &th:threads)
+                th.join();
+
+            state.PauseTiming();
+
+            for(auto &s:samples)
+            {
+                for(uint64 ns:s)
+                    latency.Record(ns);
+
+                s.clear();
+            }
+
+            state.ResumeTiming();
+        }
+
+        state.SetItemsProcessed(total);
+        state.SetLabel("p50 "+std::to_string(latency.GetPercentile(50))
+                      +" ns, p99 "+std::to_string(latency.GetPercentile(99))
+                      +" ns, p99.9 "+std::to_string(latency.GetPercentile(99.9))+" ns");
+    }
+
+    void BM_MutexDequeQueue     (BenchmarkState &state){QueueThroughput<MutexDequeQueue>(state);}
+    void BM_BlockingMPMCQueue   (BenchmarkState &state){QueueThroughput<BlockingMPMCQueue<uint64>>(state);}
+    void BM_MPMCQueueSpin       (BenchmarkState &state){QueueThroughput<SpinQueue<MPMCQueue<uint64>>>(state);}
+    void BM_BlockingSPSCQueue   (BenchmarkState &state){QueueThroughput<BlockingSPSCQueue<uint64>>(state);}
+    void BM_SPSCQueueSpin       (BenchmarkState &state){QueueThroughput<SpinQueue<SPSCQueue<uint64>>>(state);}
+}//namespace
+
+HGL_BENCHMARK(BM_MutexDequeQueue)->Range(1,8,2);
+HGL_BENCHMARK(BM_BlockingMPMCQueue)->Range(1,8,2);
+HGL_BENCHMARK(BM_MPMCQueueSpin)->Range(1,8,2);
+HGL_BENCHMARK(BM_BlockingSPSCQueue)->Arg(1);                            //单生产者单消费者
+HGL_BENCHMARK(BM_SPSCQueueSpin)->Arg(1);
@@ -0,0 +1,126 @@
+﻿/**
+ * CPU分派调用开销与各档次位计数、异或吞吐（原 examples/CpuDispatchTest 中的计时部分）
+ *
+ * SingleWord 每次迭代调用 BATCH 次单字位计数，与内联的标量版本对比衡量分派本身的开销；
+ * 其余参数为字数量，固定使用指定档次，高于当前CPU（或 HGL_CPU_TIER 限制）的档次跳过。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/platform/CpuDispatch.h>
+#include<hgl/type/BitVector.h>
+#include<vector>
+#include<random>
+
+using namespace hgl;
+using namespace hgl::bit_vector_detail;
+
+namespace
+{
+    constexpr int BATCH=1024;
+
+    void BM_PopCountSingleWordInline(BenchmarkState &state)
+    {
+        uint64 word=0x0123456789ABCDEFull;
+        uint64 sum=0;
+
+        for(auto _:state)
+            for(int i=0;i<BATCH;i++)
+            {
+                word+=i;
+                sum+=PopCountScalar(&word,1);
+            }
+
+        DoNotOptimize(sum);
+        state.SetItemsProcessed(BATCH);
+    }
+
+    void BM_PopCountSingleWordDispatched(BenchmarkState &state)
+    {
+        uint64 word=0x0123456789ABCDEFull;
+        uint64 sum=0;
+
+        for(auto _:state)
+            for(int i=0;i<BATCH;i++)
+            {
+                word+=i;
+                sum+=PopCount(&word,1);
+            }
+
+        DoNotOptimize(sum);
+        state.SetItemsProcessed(BATCH);
+        state.SetLabel(GetCpuTierName(GetCpuTier()));
+    }
+
+    void RandomWords(std::vector<uint64> &a,std::vector<uint64> &b)
+    {
+        std::mt19937_64 rng(7);
+
+        for(size_t i=0;i<a.size();i++)
+        {
+            a[i]=rng();
+            b[i]=rng();
+        }
+    }
+
+    template<CpuTier TIER>
+    void PopCountTier(BenchmarkState &state)
+    {
+        if(TIER>GetCpuTier())
+        {
+            state.SetLabel("skipped (tier unavailable)");
+            return;
+        }
+
+        std::vector<uint64> a(size_t(state.GetArg())),b(size_t(state.GetArg()));
+        RandomWords(a,b);
+
+        for(auto _:state)
+            DoNotOptimize(PopCount(a.data(),a.size(),TIER));
+
+        state.SetBytesProcessed(a.size()*sizeof(uint64));
+    }
+
+    template<CpuTier TIER>
+    void XorTier(BenchmarkState &state)
+    {
+        if(TIER>GetCpuTier())
+        {
+            state.SetLabel("skipped (tier unavailable)");
+            return;
+        }
+
+        std::vector<uint64> a(size_t(state.GetArg())),b(size_t(state.GetArg()));
+        RandomWords(a,b);
+
+        for(auto _:state)
+        {
+            BulkOp(BitOp::Xor,b.data(),a.data(),a.size(),TIER);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(a.size()*sizeof(uint64));
+    }
+
+    void BM_PopCountScalarTier  (BenchmarkState &state){PopCountTier<CpuTier::Scalar>(state);}
+    void BM_PopCountSSE42Tier   (BenchmarkState &state){PopCountTier<CpuTier::SSE42 >(state);}
+    void BM_PopCountAVX2Tier    (BenchmarkState &state){PopCountTier<CpuTier::AVX2  >(state);}
+    void BM_PopCountAVX512Tier  (BenchmarkState &state){PopCountTier<CpuTier::AVX512>(state);}
+
+    void BM_XorScalarTier       (BenchmarkState &state){XorTier<CpuTier::Scalar>(state);}
+    void BM_XorSSE42Tier        (BenchmarkState &state){XorTier<CpuTier::SSE42 >(state);}
+    void BM_XorAVX2Tier         (BenchmarkState &state){XorTier<CpuTier::AVX2  >(state);}
+    void BM_XorAVX512Tier       (BenchmarkState &state){XorTier<CpuTier::AVX512>(state);}
+}//namespace
+
+HGL_BENCHMARK(BM_PopCountSingleWordInline);
+HGL_BENCHMARK(BM_PopCountSingleWordDispatched);
+
+HGL_BENCHMARK(BM_PopCountScalarTier)->Range(1<<9,1<<21,16);
+HGL_BENCHMARK(BM_PopCountSSE42Tier)->Range(1<<9,1<<21,16);
+HGL_BENCHMARK(BM_PopCountAVX2Tier)->Range(1<<9,1<<21,16);
+HGL_BENCHMARK(BM_PopCountAVX512Tier)->Range(1<<9,1<<21,16);
+
+HGL_BENCHMARK(BM_XorScalarTier)->Range(1<<9,1<<21,16);
+HGL_BENCHMARK(BM_XorSSE42Tier)->Range(1<<9,1<<21,16);
+HGL_BENCHMARK(BM_XorAVX2Tier)->Range(1<<9,1<<21,16);
+HGL_BENCHMARK(BM_XorAVX512Tier)->Range(1<<9,1<<21,16);
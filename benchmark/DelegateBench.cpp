@@ -0,0 +1,196 @@
+﻿/**
+ * 属性读写与回调调用（原 examples/DelegateTest 中的计时部分）
+ *
+ * 对比 Property/EventFunc/std::function/直接调用，参数为对象数量，条目为一次访问或调用。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/platform/compiler/Delegate.h>
+#include<vector>
+#include<functional>
+
+using namespace hgl;
+
+namespace delegate_bench                                            //模板实参用到的类不放在匿名名字空间中
+{
+    class Item:public _Object
+    {
+        int value=0;
+
+    public:
+
+        int GetValue()const{return value;}
+        void SetValue(int v){value=v;}
+
+        void Hit(int v){value+=v;}
+    };
+
+    class OldItem:public Item
+    {
+    public:
+
+        Property<int> Value;
+
+        OldItem(){cmSetProperty(Value,this,Item::GetValue,Item::SetValue);}
+    };
+
+    class NewItem:public Item
+    {
+    public:
+
+        BoundProperty<&Item::GetValue,&Item::SetValue> Value{this};
+    };
+
+    template<typename T>
+    std::vector<T> MakeItems(BenchmarkState &state)
+    {
+        std::vector<T> items(size_t(state.GetArg()));
+
+        for(size_t i=0;i<items.size();i++)
+            items[i].SetValue(int(i));
+
+        state.SetItemsProcessed(items.size());
+        return items;
+    }
+
+    void BM_PropertyRead(BenchmarkState &state)
+    {
+        std::vector<OldItem> items=MakeItems<OldItem>(state);
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+            for(auto &it:items)sum+=it.Value;
+            DoNotOptimize(sum);
+        }
+    }
+
+    void BM_BoundPropertyRead(BenchmarkState &state)
+    {
+        std::vector<NewItem> items=MakeItems<NewItem>(state);
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+            for(auto &it:items)sum+=it.Value;
+            DoNotOptimize(sum);
+        }
+    }
+
+    void BM_GetValueRead(BenchmarkState &state)
+    {
+        std::vector<Item> items=MakeItems<Item>(state);
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+            for(auto &it:items)sum+=it.GetValue();
+            DoNotOptimize(sum);
+        }
+    }
+
+    void BM_PropertyAddAssign(BenchmarkState &state)
+    {
+        std::vector<OldItem> items=MakeItems<OldItem>(state);
+
+        for(auto _:state)
+        {
+            for(auto &it:items)it.Value+=1;
+            ClobberMemory();
+        }
+    }
+
+    void BM_BoundPropertyAddAssign(BenchmarkState &state)
+    {
+        std::vector<NewItem> items=MakeItems<NewItem>(state);
+
+        for(auto _:state)
+        {
+            for(auto &it:items)it.Value+=1;
+            ClobberMemory();
+        }
+    }
+
+    void BM_SetGetValueAddAssign(BenchmarkState &state)
+    {
+        std::vector<Item> items=MakeItems<Item>(state);
+
+        for(auto _:state)
+        {
+            for(auto &it:items)it.SetValue(it.GetValue()+1);
+            ClobberMemory();
+        }
+    }
+
+    /**
+     * 回调数组：目标在运行时才知道
+     */
+    template<typename Callback,typename BindFunc>
+    void CallRuntimeTargets(BenchmarkState &state,BindFunc bind)
+    {
+        std::vector<Item> items=MakeItems<Item>(state);
+        std::vector<Callback> callbacks(items.size());
+
+        for(size_t i=0;i<items.size();i++)
+            bind(callbacks[i],&items[i]);
+
+        for(auto _:state)
+        {
+            for(auto &cb:callbacks)cb(1);
+            ClobberMemory();
+        }
+    }
+
+    using OldCallback=EventFunc<void,void (_Object::*)(int)>;
+    using NewCallback=Delegate<void(int)>;
+
+    void BM_EventFuncCall(BenchmarkState &state)
+    {
+        CallRuntimeTargets<OldCallback>(state,[](OldCallback &cb,Item *it){SetEventCall(cb,it,Item,Hit);});
+    }
+
+    void BM_DelegateCall(BenchmarkState &state)
+    {
+        CallRuntimeTargets<NewCallback>(state,[](NewCallback &cb,Item *it){cb=NewCallback::Bind<&Item::Hit>(it);});
+    }
+
+    void BM_StdFunctionCall(BenchmarkState &state)
+    {
+        CallRuntimeTargets<std::function<void(int)>>(state,[](std::function<void(int)> &cb,Item *it){cb=[it](int v){it->Hit(v);};});
+    }
+
+    /**
+     * 目标在编译期已知
+     */
+    void BM_BoundMethodCall(BenchmarkState &state)
+    {
+        CallRuntimeTargets<BoundMethod<&Item::Hit>>(state,[](BoundMethod<&Item::Hit> &cb,Item *it){cb.Bind(it);});
+    }
+
+    void BM_DirectCall(BenchmarkState &state)
+    {
+        std::vector<Item> items=MakeItems<Item>(state);
+
+        for(auto _:state)
+        {
+            for(auto &it:items)it.Hit(1);
+            ClobberMemory();
+        }
+    }
+}//namespace delegate_bench
+
+using namespace delegate_bench;
+
+HGL_BENCHMARK(BM_PropertyRead)->Range(64,1<<16,16);
+HGL_BENCHMARK(BM_BoundPropertyRead)->Range(64,1<<16,16);
+HGL_BENCHMARK(BM_GetValueRead)->Range(64,1<<16,16);
+
+HGL_BENCHMARK(BM_PropertyAddAssign)->Range(64,1<<16,16);
+HGL_BENCHMARK(BM_BoundPropertyAddAssign)->Range(64,1<<16,16);
+HGL_BENCHMARK(BM_SetGetValueAddAssign)->Range(64,1<<16,16);
+
+HGL_BENCHMARK(BM_EventFuncCall)->Range(64,1<<16,16);
+HGL_BENCHMARK(BM_DelegateCall)->Range(64,1<<16,16);
+HGL_BENCHMARK(BM_StdFunctionCall)->Range(64,1<<16,16);
+HGL_BENCHMARK(BM_BoundMethodCall)->Range(64,1<<16,16);
+HGL_BENCHMARK(BM_DirectCall)->Range(64,1<<16,16);
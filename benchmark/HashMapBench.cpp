@@ -0,0 +1,178 @@
+﻿/**
+ * HashMap 与 std::unordered_map 的插入/查找对比（原 examples/HashMapTest 中的计时部分）
+ *
+ * 参数为元素数量。Seq 为间隔8的顺序ID（最容易在恒等哈希下聚集），Rand 为随机键。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/HashMap.h>
+#include<unordered_map>
+#include<string>
+#include<string_view>
+#include<vector>
+#include<random>
+#include<algorithm>
+#include<memory>
+
+using namespace hgl;
+
+namespace
+{
+    struct KeySet
+    {
+        std::vector<uint64> keys;                       ///<插入顺序
+        std::vector<uint64> probe;                      ///<打乱后的命中查找顺序
+        std::vector<uint64> miss;                       ///<一定不存在的键
+    };
+
+    KeySet MakeKeys(const size_t n,const bool sequential)
+    {
+        std::mt19937_64 rng(2024);
+        KeySet ks;
+
+        ks.keys.resize(n);
+        ks.miss.resize(n);
+
+        for(size_t i=0;i<n;i++)
+        {
+            ks.keys[i]=sequential?uint64(i)*8:rng()|1;
+            ks.miss[i]=sequential?uint64(i)*8+3:rng()&~uint64(1);
+        }
+
+        ks.probe=ks.keys;
+        std::shuffle(ks.probe.begin(),ks.probe.end(),rng);
+        return ks;
+    }
+
+    template<typename Map,bool SEQ>
+    void Insert(BenchmarkState &state)
+    {
+        const KeySet ks=MakeKeys(size_t(state.GetArg()),SEQ);
+
+        for(auto _:state)
+        {
+            auto map=std::make_unique<Map>();
+
+            for(size_t i=0;i<ks.keys.size();i++)
+                map->emplace(ks.keys[i],i);
+
+            DoNotOptimize(map->size());
+
+            state.PauseTiming();            //析构不计入插入耗时
+            map.reset();
+            state.ResumeTiming();
+        }
+
+        state.SetItemsProcessed(ks.keys.size());
+    }
+
+    template<typename Map,bool SEQ,bool HIT>
+    void Find(BenchmarkState &state)
+    {
+        const KeySet ks=MakeKeys(size_t(state.GetArg()),SEQ);
+        const std::vector<uint64> &lookup=HIT?ks.probe:ks.miss;
+
+        Map map;
+        for(size_t i=0;i<ks.keys.size();i++)
+            map.emplace(ks.keys[i],i);
+
+        for(auto _:state)
+        {
+            uint64 sum=0;
+
+            for(uint64 k:lookup)
+                sum+=(map.find(k)!=map.end());
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(lookup.size());
+    }
+
+    using StdMap=std::unordered_map<uint64,uint64>;
+    using HglMap=HashMap<uint64,uint64>;
+
+    void BM_StdUnorderedMapInsertSeq   (BenchmarkState &state){Insert<StdMap,true>(state);}
+    void BM_HashMapInsertSeq           (BenchmarkState &state){Insert<HglMap,true>(state);}
+    void BM_StdUnorderedMapInsertRand  (BenchmarkState &state){Insert<StdMap,false>(state);}
+    void BM_HashMapInsertRand          (BenchmarkState &state){Insert<HglMap,false>(state);}
+
+    void BM_StdUnorderedMapHitSeq      (BenchmarkState &state){Find<StdMap,true,true>(state);}
+    void BM_HashMapHitSeq              (BenchmarkState &state){Find<HglMap,true,true>(state);}
+    void BM_StdUnorderedMapHitRand     (BenchmarkState &state){Find<StdMap,false,true>(state);}
+    void BM_HashMapHitRand             (BenchmarkState &state){Find<HglMap,false,true>(state);}
+
+    void BM_StdUnorderedMapMissSeq     (BenchmarkState &state){Find<StdMap,true,false>(state);}
+    void BM_HashMapMissSeq             (BenchmarkState &state){Find<HglMap,true,false>(state);}
+    void BM_StdUnorderedMapMissRand    (BenchmarkState &state){Find<StdMap,false,false>(state);}
+    void BM_HashMapMissRand            (BenchmarkState &state){Find<HglMap,false,false>(state);}
+
+    std::vector<std::string> MakeStringKeys(const size_t n)
+    {
+        std::mt19937_64 rng(2024);
+        std::vector<std::string> keys(n);
+
+        for(size_t i=0;i<n;i++)
+            keys[i]="asset/path/"+std::to_string(rng())+".bin";
+
+        return keys;
+    }
+
+    void BM_StdUnorderedMapFindString(BenchmarkState &state)
+    {
+        const std::vector<std::string> keys=MakeStringKeys(size_t(state.GetArg()));
+
+        std::unordered_map<std::string,size_t> map;
+        for(size_t i=0;i<keys.size();i++)map.emplace(keys[i],i);
+
+        for(auto _:state)
+        {
+            size_t sum=0;
+
+            for(const std::string &k:keys)
+                sum+=map.find(std::string(std::string_view(k)))->second;    //std::unordered_map需要构造临时字符串
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(keys.size());
+    }
+
+    void BM_HashMapFindStringView(BenchmarkState &state)
+    {
+        const std::vector<std::string> keys=MakeStringKeys(size_t(state.GetArg()));
+
+        HashMap<std::string,size_t> map;
+        for(size_t i=0;i<keys.size();i++)map.emplace(keys[i],i);
+
+        for(auto _:state)
+        {
+            size_t sum=0;
+
+            for(const std::string &k:keys)
+                sum+=map.find(std::string_view(k))->second;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(keys.size());
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_StdUnorderedMapInsertSeq)->Range(1<<10,1<<22);
+HGL_BENCHMARK(BM_HashMapInsertSeq)->Range(1<<10,1<<22);
+HGL_BENCHMARK(BM_StdUnorderedMapInsertRand)->Range(1<<10,1<<22);
+HGL_BENCHMARK(BM_HashMapInsertRand)->Range(1<<10,1<<22);
+
+HGL_BENCHMARK(BM_StdUnorderedMapHitSeq)->Range(1<<10,1<<22);
+HGL_BENCHMARK(BM_HashMapHitSeq)->Range(1<<10,1<<22);
+HGL_BENCHMARK(BM_StdUnorderedMapHitRand)->Range(1<<10,1<<22);
+HGL_BENCHMARK(BM_HashMapHitRand)->Range(1<<10,1<<22);
+
+HGL_BENCHMARK(BM_StdUnorderedMapMissSeq)->Range(1<<10,1<<22);
+HGL_BENCHMARK(BM_HashMapMissSeq)->Range(1<<10,1<<22);
+HGL_BENCHMARK(BM_StdUnorderedMapMissRand)->Range(1<<10,1<<22);
+HGL_BENCHMARK(BM_HashMapMissRand)->Range(1<<10,1<<22);
+
+HGL_BENCHMARK(BM_StdUnorderedMapFindString)->Range(1<<10,1<<20);
+HGL_BENCHMARK(BM_HashMapFindStringView)->Range(1<<10,1<<20);
@@ -0,0 +1,112 @@
+﻿/**
+ * 以不同HashMixPolicy作为"已雪崩"哈希时的稠密表吞吐（原 examples/HashQualityTest 中的计时部分）
+ *
+ * 键为cache line对齐的对象地址，参数为元素数量。
+ * 恒等哈希在高位取桶时全部冲突，规模大了会退化为平方复杂度，因此只测到2^14。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/util/hash/QuickHash.h>
+#include<ankerl/unordered_dense.h>
+#include<vector>
+#include<random>
+#include<algorithm>
+#include<memory>
+
+using namespace hgl;
+
+namespace
+{
+    template<HashMixPolicy Policy>
+    struct PolicyHash
+    {
+        using is_avalanching=void;                                      //告诉ankerl不要再混合
+
+        uint64 operator()(uint64 v)const noexcept{return ComputeOptimalHash<Policy>(v);}
+    };
+
+    std::vector<uint64> MakeAlignedKeys(const size_t n)
+    {
+        std::vector<uint64> keys(n);
+
+        for(size_t i=0;i<n;i++)
+            keys[i]=0x7f0000000000ull+i*64;
+
+        return keys;
+    }
+
+    template<typename Map>
+    void Insert(BenchmarkState &state)
+    {
+        const std::vector<uint64> keys=MakeAlignedKeys(size_t(state.GetArg()));
+
+        for(auto _:state)
+        {
+            auto map=std::make_unique<Map>();
+            map->reserve(keys.size());
+
+            for(size_t i=0;i<keys.size();i++)
+                map->emplace(keys[i],i);
+
+            DoNotOptimize(map->size());
+
+            state.PauseTiming();            //析构不计入插入耗时
+            map.reset();
+            state.ResumeTiming();
+        }
+
+        state.SetItemsProcessed(keys.size());
+    }
+
+    template<typename Map>
+    void Lookup(BenchmarkState &state)
+    {
+        const std::vector<uint64> keys=MakeAlignedKeys(size_t(state.GetArg()));
+
+        std::vector<uint64> probe=keys;
+        std::mt19937_64 rng(5);
+        std::shuffle(probe.begin(),probe.end(),rng);
+
+        Map map;
+        map.reserve(keys.size());
+        for(size_t i=0;i<keys.size();i++)
+            map.emplace(keys[i],i);
+
+        for(auto _:state)
+        {
+            uint64 sum=0;
+
+            for(uint64 k:probe)
+                sum+=map.find(k)->second;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(probe.size());
+    }
+
+    using IdentityMap   =ankerl::unordered_dense::map<uint64,uint64,PolicyHash<HashMixPolicy::Identity>>;
+    using WyMixMap      =ankerl::unordered_dense::map<uint64,uint64,PolicyHash<HashMixPolicy::WyMix>>;
+    using MurmurMap     =ankerl::unordered_dense::map<uint64,uint64,PolicyHash<HashMixPolicy::Murmur>>;
+    using DefaultMap    =ankerl::unordered_dense::map<uint64,uint64>;
+
+    void BM_DenseIdentityInsert (BenchmarkState &state){Insert<IdentityMap>(state);}
+    void BM_DenseWyMixInsert    (BenchmarkState &state){Insert<WyMixMap>(state);}
+    void BM_DenseMurmurInsert   (BenchmarkState &state){Insert<MurmurMap>(state);}
+    void BM_DenseDefaultInsert  (BenchmarkState &state){Insert<DefaultMap>(state);}
+
+    void BM_DenseIdentityLookup (BenchmarkState &state){Lookup<IdentityMap>(state);}
+    void BM_DenseWyMixLookup    (BenchmarkState &state){Lookup<WyMixMap>(state);}
+    void BM_DenseMurmurLookup   (BenchmarkState &state){Lookup<MurmurMap>(state);}
+    void BM_DenseDefaultLookup  (BenchmarkState &state){Lookup<DefaultMap>(state);}
+}//namespace
+
+HGL_BENCHMARK(BM_DenseIdentityInsert)->Range(1<<8,1<<14);
+HGL_BENCHMARK(BM_DenseWyMixInsert)->Range(1<<8,1<<20);
+HGL_BENCHMARK(BM_DenseMurmurInsert)->Range(1<<8,1<<20);
+HGL_BENCHMARK(BM_DenseDefaultInsert)->Range(1<<8,1<<20);
+
+HGL_BENCHMARK(BM_DenseIdentityLookup)->Range(1<<8,1<<14);
+HGL_BENCHMARK(BM_DenseWyMixLookup)->Range(1<<8,1<<20);
+HGL_BENCHMARK(BM_DenseMurmurLookup)->Range(1<<8,1<<20);
+HGL_BENCHMARK(BM_DenseDefaultLookup)->Range(1<<8,1<<20);
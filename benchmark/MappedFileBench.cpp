@@ -0,0 +1,176 @@
+﻿/**
+ * MappedFile 打开并完整扫描一个文件的耗时（原 examples/MappedFileTest 中的计时部分）
+ *
+ * 对比"整个文件读入std::vector后解析"与各种映射/pread方式。参数为文件大小(MB)。
+ * 文件在页缓存中，测得的是映射/复制本身的开销而非磁盘读取。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/MappedFile.h>
+#include<fstream>
+#include<map>
+#include<string>
+#include<cstdio>
+#include<unistd.h>
+
+using namespace hgl;
+
+namespace
+{
+    /**
+     * 按大小缓存的临时测试文件，进程退出时删除
+     */
+    class TestFiles
+    {
+        std::map<size_t,std::string> files;
+
+    public:
+
+        ~TestFiles()
+        {
+            for(const auto &f:files)
+                std::remove(f.second.c_str());
+        }
+
+        const std::string &Get(const size_t mb)
+        {
+            auto it=files.find(mb);
+
+            if(it!=files.end())
+                return it->second;
+
+            const std::string filename="/tmp/hgl_mapped_file_bench_"+std::to_string(mb)+"_"+std::to_string(getpid())+".bin";
+
+            std::vector<uint8_t> data(mb*1024*1024);
+            for(size_t i=0;i<data.size();i++)
+                data[i]=uint8_t(i*131);
+
+            std::ofstream out(filename,std::ios::binary|std::ios::trunc);
+            out.write(reinterpret_cast<const char *>(data.data()),std::streamsize(data.size()));
+
+            return files.emplace(mb,filename).first->second;
+        }
+    };//class TestFiles
+
+    const std::string &GetTestFile(const size_t mb)
+    {
+        static TestFiles test_files;
+
+        return test_files.Get(mb);
+    }
+
+    uint64 Checksum(ByteSpanReader reader)
+    {
+        uint64 sum=0;
+        const size_t count=reader.left()/sizeof(uint64);
+
+        if(reader.require(count*sizeof(uint64)))
+            for(size_t i=0;i<count;i++)
+                sum+=reader.u64_unchecked();
+
+        uint8 tail;
+        while(reader.u8(tail))
+            sum+=tail;
+
+        return sum;
+    }
+
+    void BM_IfstreamToVector(BenchmarkState &state)
+    {
+        const std::string &filename=GetTestFile(size_t(state.GetArg()));
+
+        for(auto _:state)
+        {
+            std::ifstream in(filename,std::ios::binary);
+            in.seekg(0,std::ios::end);
+            std::vector<uint8_t> data(size_t(in.tellg()));
+            in.seekg(0);
+            in.read(reinterpret_cast<char *>(data.data()),std::streamsize(data.size()));
+
+            DoNotOptimize(Checksum(ByteSpanReader(data)));
+        }
+
+        state.SetBytesProcessed(uint64(state.GetArg())*1024*1024);
+    }
+
+    void OpenAndScan(BenchmarkState &state,const MappedFileConfig &config)
+    {
+        const std::string &filename=GetTestFile(size_t(state.GetArg()));
+
+        for(auto _:state)
+        {
+            MappedFile mf;
+
+            if(!mf.Open(filename.c_str(),config))
+            {
+                state.SetLabel("open failed");
+                break;
+            }
+
+            uint64 sum=0;
+
+            if(mf.GetMode()==MappedFileMode::Buffered)
+            {
+                constexpr size_t WINDOW=4*1024*1024;
+
+                for(size_t offset=0;offset<mf.GetSize();offset+=WINDOW)
+                    sum+=Checksum(mf.GetReader(offset,WINDOW));
+            }
+            else
+            {
+                sum=Checksum(mf.GetReader());
+            }
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetBytesProcessed(uint64(state.GetArg())*1024*1024);
+    }
+
+    void BM_MmapSequential(BenchmarkState &state)
+    {
+        OpenAndScan(state,MappedFileConfig());
+    }
+
+    void BM_MmapPopulate(BenchmarkState &state)
+    {
+        MappedFileConfig config;
+        config.populate=true;
+
+        OpenAndScan(state,config);
+    }
+
+    void BM_MmapHugePages(BenchmarkState &state)
+    {
+        MappedFileConfig config;
+        config.huge_pages=true;
+
+        OpenAndScan(state,config);
+    }
+
+    void BM_MmapWillNeed(BenchmarkState &state)
+    {
+        MappedFileConfig config;
+        config.will_need=true;
+
+        OpenAndScan(state,config);
+    }
+
+    /**
+     * 不映射，以4MB窗口pread流式扫描
+     */
+    void BM_PreadWindows(BenchmarkState &state)
+    {
+        MappedFileConfig config;
+        config.force_buffered=true;
+
+        OpenAndScan(state,config);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_IfstreamToVector)->Arg(16)->Arg(256);
+HGL_BENCHMARK(BM_MmapSequential)->Arg(16)->Arg(256);
+HGL_BENCHMARK(BM_MmapPopulate)->Arg(16)->Arg(256);
+HGL_BENCHMARK(BM_MmapHugePages)->Arg(16)->Arg(256);
+HGL_BENCHMARK(BM_MmapWillNeed)->Arg(16)->Arg(256);
+HGL_BENCHMARK(BM_PreadWindows)->Arg(16)->Arg(256);
@@ -0,0 +1,230 @@
+﻿/**
+ * MemoryUtil 吞吐量（原 examples/MemoryUtilTest 中 64B~1GB 的计时部分）
+ *
+ * 与 memset/memcpy/std::fill_n/逐元素memcpy 比较，较大的长度会走非临时存储路径。
+ * 默认只测到64MB，256MB与1GB需要 --large。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/MemoryUtil.h>
+#include<algorithm>
+#include<new>
+
+using namespace hgl;
+
+namespace
+{
+    struct Pixel12                                                  ///<长度不能整除32，走倍增复制
+    {
+        uint32 r,g,b;
+    };
+
+    /**
+     * 一对已写入过的缓冲区（写入后不计缺页时间）
+     */
+    class BufferPair
+    {
+        uint8 *a;
+        uint8 *b;
+
+    public:
+
+        const size_t bytes;
+
+    public:
+
+        BufferPair(BenchmarkState &state):bytes(size_t(state.GetArg()))
+        {
+            a=new(std::nothrow) uint8[bytes];
+            b=new(std::nothrow) uint8[bytes];
+
+            if(!a||!b)
+            {
+                delete[] a;
+                delete[] b;
+                a=b=nullptr;
+
+                state.SetLabel("skipped (out of memory)");
+                return;
+            }
+
+            memset(a,1,bytes);
+            memset(b,2,bytes);
+
+            state.SetBytesProcessed(bytes);
+        }
+
+        ~BufferPair()
+        {
+            delete[] a;
+            delete[] b;
+        }
+
+        bool IsValid()const{return a;}
+
+        uint8 *GetDst(){return a;}
+        uint8 *GetSrc(){return b;}
+    };//class BufferPair
+
+    void BM_memset(BenchmarkState &state)
+    {
+        BufferPair buf(state);
+
+        if(!buf.IsValid())
+            return;
+
+        uint8 *dst=buf.GetDst();
+
+        for(auto _:state)
+        {
+            memset(dst,0,buf.bytes);
+            DoNotOptimize(dst);
+            ClobberMemory();
+        }
+    }
+
+    void BM_mem_zero(BenchmarkState &state)
+    {
+        BufferPair buf(state);
+
+        if(!buf.IsValid())
+            return;
+
+        uint8 *dst=buf.GetDst();
+
+        for(auto _:state)
+        {
+            mem_zero(dst,buf.bytes);
+            DoNotOptimize(dst);
+            ClobberMemory();
+        }
+    }
+
+    void BM_memcpy(BenchmarkState &state)
+    {
+        BufferPair buf(state);
+
+        if(!buf.IsValid())
+            return;
+
+        uint8 *dst=buf.GetDst();
+        const uint8 *src=buf.GetSrc();
+
+        for(auto _:state)
+        {
+            memcpy(dst,src,buf.bytes);
+            DoNotOptimize(dst);
+            ClobberMemory();
+        }
+    }
+
+    void BM_mem_copy(BenchmarkState &state)
+    {
+        BufferPair buf(state);
+
+        if(!buf.IsValid())
+            return;
+
+        uint8 *dst=buf.GetDst();
+        const uint8 *src=buf.GetSrc();
+
+        for(auto _:state)
+        {
+            mem_copy(dst,src,buf.bytes);
+            DoNotOptimize(dst);
+            ClobberMemory();
+        }
+    }
+
+    void BM_fill_n_u32(BenchmarkState &state)
+    {
+        BufferPair buf(state);
+
+        if(!buf.IsValid())
+            return;
+
+        uint32 *dst=reinterpret_cast<uint32 *>(buf.GetDst());
+        const size_t count=buf.bytes/sizeof(uint32);
+
+        for(auto _:state)
+        {
+            std::fill_n(dst,count,0x01020304u);
+            DoNotOptimize(dst);
+            ClobberMemory();
+        }
+    }
+
+    void BM_mem_fill_u32(BenchmarkState &state)
+    {
+        BufferPair buf(state);
+
+        if(!buf.IsValid())
+            return;
+
+        uint32 *dst=reinterpret_cast<uint32 *>(buf.GetDst());
+        const size_t count=buf.bytes/sizeof(uint32);
+
+        for(auto _:state)
+        {
+            mem_fill(dst,0x01020304u,count);
+            DoNotOptimize(dst);
+            ClobberMemory();
+        }
+    }
+
+    /**
+     * 逐元素memcpy（原 mem_fill_pattern 的实现）
+     */
+    void BM_loop_Pixel12(BenchmarkState &state)
+    {
+        BufferPair buf(state);
+
+        if(!buf.IsValid())
+            return;
+
+        Pixel12 *dst=reinterpret_cast<Pixel12 *>(buf.GetDst());
+        const size_t count=buf.bytes/sizeof(Pixel12);
+        const Pixel12 pattern{1,2,3};
+
+        for(auto _:state)
+        {
+            for(size_t i=0;i<count;i++)
+                memcpy(dst+i,&pattern,sizeof(Pixel12));
+
+            DoNotOptimize(dst);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(count*sizeof(Pixel12));
+    }
+
+    void BM_mem_fill_pattern_Pixel12(BenchmarkState &state)
+    {
+        BufferPair buf(state);
+
+        if(!buf.IsValid())
+            return;
+
+        Pixel12 *dst=reinterpret_cast<Pixel12 *>(buf.GetDst());
+        const size_t count=buf.bytes/sizeof(Pixel12);
+        const Pixel12 pattern{1,2,3};
+
+        for(auto _:state)
+        {
+            mem_fill_pattern(dst,&pattern,count);
+            DoNotOptimize(dst);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(count*sizeof(Pixel12));
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_memset)->Range(64,int64(1)<<30,4)->LargeArgs(int64(1)<<28);
+HGL_BENCHMARK(BM_mem_zero)->Range(64,int64(1)<<30,4)->LargeArgs(int64(1)<<28);
+HGL_BENCHMARK(BM_memcpy)->Range(64,int64(1)<<30,4)->LargeArgs(int64(1)<<28);
+HGL_BENCHMARK(BM_mem_copy)->Range(64,int64(1)<<30,4)->LargeArgs(int64(1)<<28);
+HGL_BENCHMARK(BM_fill_n_u32)->Range(64,int64(1)<<30,4)->LargeArgs(int64(1)<<28);
+HGL_BENCHMARK(BM_mem_fill_u32)->Range(64,int64(1)<<30,4)->LargeArgs(int64(1)<<28);
+HGL_BENCHMARK(BM_loop_Pixel12)->Range(64,int64(1)<<30,4)->LargeArgs(int64(1)<<28);
+HGL_BENCHMARK(BM_mem_fill_pattern_Pixel12)->Range(64,int64(1)<<30,4)->LargeArgs(int64(1)<<28);
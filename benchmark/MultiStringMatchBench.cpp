@@ -0,0 +1,199 @@
+﻿/**
+ * MultiStringMatcher 日志过滤与名称查找（原 examples/MultiStringMatchTest 中的计时部分）
+ *
+ * LogFilter: 每行检查是否包含任一关键字，参数为关键字数量，对比逐关键字strstr循环。
+ * Lookup: 忽略大小写的精确查找，参数为名称数量，对比find_str_in_array。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/Str.MultiMatch.h>
+#include<hgl/type/Str.StringArray.h>
+#include<hgl/type/Str.Search.h>
+#include<vector>
+#include<string>
+#include<random>
+#include<cctype>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr size_t LINE_COUNT     =1<<15;                             ///<LogFilter每次迭代扫描的日志行数
+    constexpr size_t QUERY_COUNT    =1<<14;                             ///<Lookup每次迭代的查询数
+
+    std::vector<std::string> MakeKeywords(size_t count,std::mt19937 &rng)
+    {
+        static const char *roots[]={"error","warn","fatal","timeout","socket","texture","shader","mesh","audio","render",
+                                    "thread","mutex","vulkan","opengl","memory","alloc","cache","file","path","config"};
+
+        std::vector<std::string> keywords;
+
+        for(size_t i=0;i<count;i++)
+            keywords.push_back(std::string(roots[i%20])+"_"+std::to_string(rng()%100000));
+
+        return keywords;
+    }
+
+    /**
+     * 普通日志行，约1/50的行包含一个关键字
+     */
+    struct LogData
+    {
+        std::vector<std::string> keywords;
+        std::vector<const char *> list;
+        std::vector<std::string> lines;
+        size_t bytes=0;
+
+        explicit LogData(const size_t keyword_count)
+        {
+            std::mt19937 rng(3);
+
+            keywords=MakeKeywords(keyword_count,rng);
+
+            for(auto &k:keywords)
+                list.push_back(k.c_str());
+
+            lines.resize(LINE_COUNT);
+
+            for(size_t i=0;i<LINE_COUNT;i++)
+            {
+                lines[i]="2026-10-18 12:00:"+std::to_string(i%60)+" [render] frame "+std::to_string(i)+" submitted, draw calls "+std::to_string(rng()%5000)
+                        +", gpu time "+std::to_string(rng()%100)+"ms, queue idle";
+
+                if(i%50==0)
+                    lines[i]+=" "+keywords[rng()%keyword_count];
+
+                bytes+=lines[i].size();
+            }
+        }
+    };
+
+    void BM_StrstrLoopLogFilter(BenchmarkState &state)
+    {
+        LogData data(size_t(state.GetArg()));
+
+        for(auto _:state)
+        {
+            size_t hits=0;
+
+            for(const std::string &line:data.lines)
+                for(const std::string &k:data.keywords)
+                    if(hgl::strstr(line.c_str(),line.size(),k.c_str(),k.size()))
+                    {
+                        ++hits;
+                        break;
+                    }
+
+            DoNotOptimize(hits);
+        }
+
+        state.SetBytesProcessed(data.bytes);
+    }
+
+    void MatcherLogFilter(BenchmarkState &state,const MultiMatchEngine engine)
+    {
+        LogData data(size_t(state.GetArg()));
+
+        MultiStringMatcher<char> matcher;
+        matcher.Build(int(data.list.size()),data.list.data(),false,engine);
+
+        if(engine!=MultiMatchEngine::AhoCorasick&&matcher.GetEngine()==MultiMatchEngine::AhoCorasick)
+        {
+            state.SetLabel("skipped (engine unavailable)");
+            return;
+        }
+
+        for(auto _:state)
+        {
+            size_t hits=0;
+
+            for(const std::string &line:data.lines)
+                hits+=matcher.Contains(line.c_str(),line.size());
+
+            DoNotOptimize(hits);
+        }
+
+        state.SetBytesProcessed(data.bytes);
+    }
+
+    void BM_AhoCorasickLogFilter(BenchmarkState &state){MatcherLogFilter(state,MultiMatchEngine::AhoCorasick);}
+    void BM_TeddyAVX2LogFilter  (BenchmarkState &state){MatcherLogFilter(state,MultiMatchEngine::TeddyAVX2);}
+
+    /**
+     * 名称表与查询，一半查询命中，部分命中的查询改为大写
+     */
+    struct LookupData
+    {
+        std::vector<std::string> names;
+        std::vector<const char *> list;
+        std::vector<std::string> queries;
+
+        explicit LookupData(const size_t name_count)
+        {
+            std::mt19937 rng(11);
+
+            names=MakeKeywords(name_count,rng);
+
+            for(auto &k:names)
+                list.push_back(k.c_str());
+
+            list.push_back(nullptr);
+
+            queries.resize(QUERY_COUNT);
+
+            for(size_t i=0;i<QUERY_COUNT;i++)
+            {
+                queries[i]=(i&1)?names[rng()%names.size()]:"unknown_"+std::to_string(i);
+
+                if(i%4==3)
+                    for(char &ch:queries[i])
+                        ch=char(toupper((unsigned char)ch));
+            }
+        }
+    };
+
+    void BM_FindStrInArrayLookup(BenchmarkState &state)
+    {
+        LookupData data(size_t(state.GetArg()));
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+
+            for(const std::string &q:data.queries)
+                sum+=find_str_in_array(data.list.data(),q.c_str());
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+
+    void BM_MultiStringMatchLookup(BenchmarkState &state)
+    {
+        LookupData data(size_t(state.GetArg()));
+
+        //find_str_in_array使用stricmp比较，Match同样以忽略大小写构建
+        MultiStringMatcher<char> matcher;
+        matcher.Build(data.list.data(),true);
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+
+            for(const std::string &q:data.queries)
+                sum+=matcher.Match(q.c_str(),int(q.size()));
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_StrstrLoopLogFilter)->Range(8,128,4);
+HGL_BENCHMARK(BM_AhoCorasickLogFilter)->Range(8,2048,4);
+HGL_BENCHMARK(BM_TeddyAVX2LogFilter)->Range(8,64,2);                 //Teddy最多支持64个模式
+
+HGL_BENCHMARK(BM_FindStrInArrayLookup)->Range(16,1024,4);
+HGL_BENCHMARK(BM_MultiStringMatchLookup)->Range(16,1024,4);
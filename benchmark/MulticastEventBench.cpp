@@ -0,0 +1,116 @@
+﻿/**
+ * MulticastEvent 分发耗时（原 examples/MulticastEventTest 中的计时部分）
+ *
+ * 对比手写的 vector<EventFunc>+mutex，参数为目标数量，条目为一次目标调用。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/platform/compiler/MulticastEvent.h>
+#include<vector>
+#include<mutex>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr int EVENT_COUNT=1024;                                     ///<每次迭代触发的事件数
+
+    using ValueEvent=MulticastEvent<void (_Object::*)(int)>;
+
+    class Listener:public _Object
+    {
+    public:
+
+        int64 sum=0;
+
+        void OnValue(int v)
+        {
+            sum+=v;
+        }
+    };
+
+    /**
+     * 手写的观察者：vector<EventFunc>，每次触发加锁
+     */
+    class MutexObserverList
+    {
+        std::mutex lock;
+        std::vector<ValueEvent::Target> targets;
+
+    public:
+
+        void Add(void *t,void *f){std::lock_guard<std::mutex> l(lock);targets.push_back(ValueEvent::Target(t,f));}
+
+        void Call(int v)
+        {
+            std::lock_guard<std::mutex> l(lock);
+
+            for(auto &t:targets)t(v);
+        }
+    };
+
+    void BM_MutexObserverListCall(BenchmarkState &state)
+    {
+        const int n=int(state.GetArg());
+        std::vector<Listener> listeners(n);
+        MutexObserverList mol;
+
+        for(Listener &l:listeners)
+            mol.Add(&l,GetMemberFuncPointer(Listener,OnValue));
+
+        for(auto _:state)
+        {
+            for(int i=0;i<EVENT_COUNT;i++)
+                mol.Call(i);
+
+            ClobberMemory();
+        }
+
+        state.SetItemsProcessed(uint64(EVENT_COUNT)*n);
+    }
+
+    void BM_MulticastEventCall(BenchmarkState &state)
+    {
+        const int n=int(state.GetArg());
+        std::vector<Listener> listeners(n);
+        ValueEvent event;
+
+        for(Listener &l:listeners)
+            AddEventCall(event,&l,Listener,OnValue);
+
+        for(auto _:state)
+        {
+            for(int i=0;i<EVENT_COUNT;i++)
+                event.Call(i);
+
+            ClobberMemory();
+        }
+
+        state.SetItemsProcessed(uint64(EVENT_COUNT)*n);
+    }
+
+    void BM_MulticastEventPostFlush(BenchmarkState &state)
+    {
+        const int n=int(state.GetArg());
+        std::vector<Listener> listeners(n);
+        ValueEvent event;
+
+        for(Listener &l:listeners)
+            AddEventCall(event,&l,Listener,OnValue);
+
+        for(auto _:state)
+        {
+            for(int i=0;i<EVENT_COUNT;i++)
+                event.Post(i);
+
+            event.Flush();
+            ClobberMemory();
+        }
+
+        state.SetItemsProcessed(uint64(EVENT_COUNT)*n);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_MutexObserverListCall)->Range(1,1024,4);
+HGL_BENCHMARK(BM_MulticastEventCall)->Range(1,1024,4);
+HGL_BENCHMARK(BM_MulticastEventPostFlush)->Range(1,1024,4);
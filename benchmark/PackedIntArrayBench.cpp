@@ -0,0 +1,105 @@
+﻿/**
+ * PackedIntArray/BitStreamReader 解码速度（原 examples/PackedIntArrayTest 中的计时部分）
+ *
+ * 参数为位宽，吞吐量以解出的uint32计，标签为相对uint32[]的内存占用。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/PackedIntArray.h>
+#include<hgl/type/BitStream.h>
+#include<vector>
+#include<random>
+#include<string>
+#include<cstring>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr size_t COUNT=size_t(4)<<20;                               ///<数值数量
+
+    /**
+     * 以指定位宽打包的随机数值与解码输出缓冲区
+     */
+    struct PackedData
+    {
+        uint32 bits;
+        PackedIntArray packed;
+        std::vector<uint32> out;
+
+        explicit PackedData(BenchmarkState &state):bits(uint32(state.GetArg())),packed(bits),out(COUNT)
+        {
+            std::mt19937 rng(3);
+            std::vector<uint32> values(COUNT);
+
+            for(auto &v:values)
+                v=rng()&uint32(low_bits_mask(bits));
+
+            packed.Assign(values.data(),COUNT);
+
+            state.SetBytesProcessed(COUNT*sizeof(uint32));
+            state.SetLabel("memory "+std::to_string(100*packed.GetBytes()/(COUNT*sizeof(uint32)))+"%");
+        }
+    };
+
+    void BM_Uint32ArrayMemcpy(BenchmarkState &state)
+    {
+        std::mt19937 rng(3);
+        std::vector<uint32> plain(COUNT),out(COUNT);
+
+        for(auto &v:plain)
+            v=rng();
+
+        for(auto _:state)
+        {
+            memcpy(out.data(),plain.data(),COUNT*sizeof(uint32));
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(COUNT*sizeof(uint32));
+    }
+
+    void BM_PackedIntArrayUnpack(BenchmarkState &state)
+    {
+        PackedData data(state);
+
+        for(auto _:state)
+        {
+            data.packed.Unpack(data.out.data(),0,COUNT);
+            ClobberMemory();
+        }
+    }
+
+    void BM_PackedIntArrayGet(BenchmarkState &state)
+    {
+        PackedData data(state);
+
+        for(auto _:state)
+        {
+            for(size_t i=0;i<COUNT;i++)
+                data.out[i]=data.packed.Get(i);
+
+            ClobberMemory();
+        }
+    }
+
+    void BM_BitStreamReaderRead(BenchmarkState &state)
+    {
+        PackedData data(state);
+
+        for(auto _:state)
+        {
+            BitStreamReader br(data.packed.GetData(),data.packed.GetBytes());
+
+            for(size_t i=0;i<COUNT;i++)
+                data.out[i]=uint32(br.read_bits(data.bits));
+
+            ClobberMemory();
+        }
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_Uint32ArrayMemcpy);
+HGL_BENCHMARK(BM_PackedIntArrayUnpack)->Arg(1)->Arg(3)->Arg(5)->Arg(8)->Arg(12)->Arg(17)->Arg(25)->Arg(32);
+HGL_BENCHMARK(BM_PackedIntArrayGet)->Arg(1)->Arg(3)->Arg(5)->Arg(8)->Arg(12)->Arg(17)->Arg(25)->Arg(32);
+HGL_BENCHMARK(BM_BitStreamReaderRead)->Arg(1)->Arg(3)->Arg(5)->Arg(8)->Arg(12)->Arg(17)->Arg(25)->Arg(32);
@@ -0,0 +1,127 @@
+﻿/**
+ * 完美哈希字符串表查找（原 examples/PerfectHashTableTest 中的计时部分）
+ *
+ * 对比 find_str_in_array 与 HashMap<std::string_view>，参数为键数量，一半查询命中。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/PerfectHashTable.h>
+#include<hgl/type/Str.StringArray.h>
+#include<hgl/type/HashMap.h>
+#include<vector>
+#include<string>
+#include<string_view>
+#include<random>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr size_t QUERY_COUNT=1<<14;                                 ///<每次迭代的查询数
+
+    std::string RandomWord(std::mt19937 &rng,size_t max_len)
+    {
+        std::string s;
+        const size_t len=1+rng()%max_len;
+
+        for(size_t i=0;i<len;i++)
+            s.push_back(char('a'+rng()%26));
+
+        return s;
+    }
+
+    struct LookupData
+    {
+        std::vector<std::string> keys;
+        std::vector<const char *> list;
+        std::vector<std::string> queries;
+
+        explicit LookupData(const size_t n)
+        {
+            std::mt19937 rng(7);
+
+            HashSet<std::string> unique;
+            while(unique.size()<n)unique.insert("key_"+RandomWord(rng,12));
+
+            keys.assign(unique.begin(),unique.end());
+
+            for(auto &k:keys)
+                list.push_back(k.c_str());
+
+            queries.resize(QUERY_COUNT);
+
+            for(size_t i=0;i<QUERY_COUNT;i++)
+                queries[i]=(i&1)?keys[rng()%n]:"key_"+RandomWord(rng,12);
+        }
+
+        int Count()const{return int(keys.size());}
+    };
+
+    void BM_FindStrInArray(BenchmarkState &state)
+    {
+        LookupData data(size_t(state.GetArg()));
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+
+            for(const std::string &q:data.queries)
+                sum+=find_str_in_array(data.Count(),data.list.data(),q.c_str(),int(q.size()));
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+
+    template<bool IGNORE_CASE>
+    void PerfectHashFind(BenchmarkState &state)
+    {
+        LookupData data(size_t(state.GetArg()));
+        PerfectHashStringTable<char,IGNORE_CASE> table(data.Count(),data.list.data());
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+
+            for(const std::string &q:data.queries)
+                sum+=table.Find(q.c_str(),int(q.size()));
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+
+    void BM_PerfectHashTableIgnoreCase(BenchmarkState &state){PerfectHashFind<true>(state);}
+    void BM_PerfectHashTable          (BenchmarkState &state){PerfectHashFind<false>(state);}
+
+    void BM_HashMapStringView(BenchmarkState &state)
+    {
+        LookupData data(size_t(state.GetArg()));
+
+        HashMap<std::string_view,int> map;
+        for(int i=0;i<data.Count();i++)
+            map.emplace(data.keys[i],i);
+
+        for(auto _:state)
+        {
+            int64 sum=0;
+
+            for(const std::string &q:data.queries)
+            {
+                auto it=map.find(std::string_view(q));
+                sum+=(it==map.end()?-1:it->second);
+            }
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_FindStrInArray)->Range(8,2048,4);
+HGL_BENCHMARK(BM_PerfectHashTableIgnoreCase)->Range(8,2048,4);
+HGL_BENCHMARK(BM_PerfectHashTable)->Range(8,2048,4);
+HGL_BENCHMARK(BM_HashMapStringView)->Range(8,2048,4);
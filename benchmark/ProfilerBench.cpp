@@ -0,0 +1,100 @@
+﻿/**
+ * 读时钟、记录区间、直方图、计数器的单次开销（原 examples/ProfilerTest 中的计时部分）
+ *
+ * 每次迭代执行 BATCH 次操作，条目为一次操作。
+ */
+
+#define HGL_PROFILER
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/time/Profiler.h>
+#include<hgl/time/TscClock.h>
+#include<chrono>
+#include<memory>
+#include<string>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr int BATCH=1024;
+
+    void BM_SteadyClockNow(BenchmarkState &state)
+    {
+        for(auto _:state)
+            for(int i=0;i<BATCH;i++)
+                DoNotOptimize(std::chrono::steady_clock::now());
+
+        state.SetItemsProcessed(BATCH);
+    }
+
+    void BM_TscClockNow(BenchmarkState &state)
+    {
+        for(auto _:state)
+            for(int i=0;i<BATCH;i++)
+                DoNotOptimize(TscClock::Now());
+
+        state.SetItemsProcessed(BATCH);
+    }
+
+    void BM_ProfileZone(BenchmarkState &state)
+    {
+        Profiler::Reset();
+
+        for(auto _:state)
+        {
+            for(int i=0;i<BATCH;i++)
+            {
+                HGL_PROFILE_ZONE("bench");
+            }
+
+            state.PauseTiming();                //不超过每线程缓冲区上限
+            Profiler::Reset();
+            state.ResumeTiming();
+        }
+
+        state.SetItemsProcessed(BATCH);
+    }
+
+    void BM_LatencyHistogramRecord(BenchmarkState &state)
+    {
+        auto h=std::make_unique<LatencyHistogram>();
+
+        for(auto _:state)
+            for(int i=0;i<BATCH;i++)
+                h->Record(uint64(i)&0xFFFF);
+
+        DoNotOptimize(h->GetCount());
+        state.SetItemsProcessed(BATCH);
+    }
+
+    void BM_ProfileLatency(BenchmarkState &state)
+    {
+        auto h=std::make_unique<LatencyHistogram>();
+
+        for(auto _:state)
+            for(int i=0;i<BATCH;i++)
+            {
+                HGL_PROFILE_LATENCY(*h);
+            }
+
+        state.SetItemsProcessed(BATCH);
+        state.SetLabel("p50 "+std::to_string(h->GetPercentile(50))+" ns, p99.9 "+std::to_string(h->GetPercentile(99.9))+" ns");
+    }
+
+    void BM_ProfileCounterAdd(BenchmarkState &state)
+    {
+        for(auto _:state)
+            for(int i=0;i<BATCH;i++)
+                HGL_PROFILE_COUNTER_ADD("bench counter",1);
+
+        state.SetItemsProcessed(BATCH);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_SteadyClockNow);
+HGL_BENCHMARK(BM_TscClockNow);
+HGL_BENCHMARK(BM_ProfileZone);
+HGL_BENCHMARK(BM_LatencyHistogramRecord);
+HGL_BENCHMARK(BM_ProfileLatency);
+HGL_BENCHMARK(BM_ProfileCounterAdd);
@@ -0,0 +1,199 @@
+﻿/**
+ * Random 批量填充（原 examples/RandomTest 中的计时部分）
+ *
+ * 参数为每次调用生成的数值个数，吞吐量以输出字节计。Scalar 为逐个生成的标量实现。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/math/Random.h>
+#include<vector>
+#include<random>
+
+using namespace hgl;
+using namespace hgl::random_detail;
+
+namespace
+{
+    void BM_RandomFillU64Scalar(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<uint64> out(n);
+        uint64 seed=1;
+
+        for(auto _:state)
+        {
+            FillU64Scalar(seed,out.data(),n);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*sizeof(uint64));
+    }
+
+    void BM_RandomFillU64(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<uint64> out(n);
+        Random rng(1);
+
+        for(auto _:state)
+        {
+            rng.FillU64(out.data(),n);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*sizeof(uint64));
+    }
+
+    void BM_RandomFillFloatScalar(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<float> out(n);
+        uint64 seed=1;
+
+        for(auto _:state)
+        {
+            FillPairScalar(seed,n,[&out](size_t k,uint32 r){out[k]=U32ToFloat(r);});
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*sizeof(float));
+    }
+
+    void BM_RandomFillFloat(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<float> out(n);
+        Random rng(1);
+
+        for(auto _:state)
+        {
+            rng.FillFloat(out.data(),n);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*sizeof(float));
+    }
+
+    void BM_Mt19937UniformFloat(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<float> out(n);
+        std::mt19937 mt(1);
+        std::uniform_real_distribution<float> dist(0.0f,1.0f);
+
+        for(auto _:state)
+        {
+            for(size_t i=0;i<n;i++)
+                out[i]=dist(mt);
+
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*sizeof(float));
+    }
+
+    void BM_RandomFillDouble(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<double> out(n);
+        Random rng(1);
+
+        for(auto _:state)
+        {
+            rng.FillDouble(out.data(),n);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*sizeof(double));
+    }
+
+    void BM_RandomFillInt(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<int32> out(n);
+        Random rng(1);
+
+        for(auto _:state)
+        {
+            rng.FillInt(out.data(),n,0,999);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*sizeof(int32));
+    }
+
+    void BM_RandomFillGaussian(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<float> out(n);
+        Random rng(1);
+
+        for(auto _:state)
+        {
+            rng.FillGaussian(out.data(),n);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*sizeof(float));
+    }
+
+    void BM_Mt19937NormalFloat(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<float> out(n);
+        std::mt19937 mt(1);
+        std::normal_distribution<float> dist(0.0f,1.0f);
+
+        for(auto _:state)
+        {
+            for(size_t i=0;i<n;i++)
+                out[i]=dist(mt);
+
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*sizeof(float));
+    }
+
+    void BM_RandomFillUnitVector2(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<float> out(n*2);
+        Random rng(1);
+
+        for(auto _:state)
+        {
+            rng.FillUnitVector2(out.data(),n);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*2*sizeof(float));
+    }
+
+    void BM_RandomFillUnitVector3(BenchmarkState &state)
+    {
+        const size_t n=size_t(state.GetArg());
+        std::vector<float> out(n*3);
+        Random rng(1);
+
+        for(auto _:state)
+        {
+            rng.FillUnitVector3(out.data(),n);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(n*3*sizeof(float));
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_RandomFillU64Scalar)->Range(1<<10,1<<22,16);
+HGL_BENCHMARK(BM_RandomFillU64)->Range(1<<10,1<<22,16);
+HGL_BENCHMARK(BM_RandomFillFloatScalar)->Range(1<<10,1<<22,16);
+HGL_BENCHMARK(BM_RandomFillFloat)->Range(1<<10,1<<22,16);
+HGL_BENCHMARK(BM_Mt19937UniformFloat)->Range(1<<10,1<<22,16);
+HGL_BENCHMARK(BM_RandomFillDouble)->Range(1<<10,1<<22,16);
+HGL_BENCHMARK(BM_RandomFillInt)->Range(1<<10,1<<22,16);
+HGL_BENCHMARK(BM_RandomFillGaussian)->Range(1<<10,1<<22,16);
+HGL_BENCHMARK(BM_Mt19937NormalFloat)->Range(1<<10,1<<22,16);
+HGL_BENCHMARK(BM_RandomFillUnitVector2)->Range(1<<10,1<<22,16);
+HGL_BENCHMARK(BM_RandomFillUnitVector3)->Range(1<<10,1<<22,16);
@@ -0,0 +1,71 @@
+﻿/**
+ * SlabPool 多线程吞吐量（原 examples/SlabPoolTest 中的计时部分）
+ *
+ * 每个线程反复分配一批对象再倒序释放，与系统分配器(new/delete)对比。参数为线程数。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/SlabPool.h>
+#include<thread>
+
+using namespace hgl;
+
+namespace
+{
+    struct Node
+    {
+        int64 key=0;
+        int64 value=0;
+        Node *left=nullptr;
+        Node *right=nullptr;
+    };
+
+    constexpr int BATCH         =256;
+    constexpr int ROUNDS        =256;           ///<每次迭代中每个线程的批次数
+
+    template<typename AllocFunc,typename FreeFunc>
+    void RunThreads(BenchmarkState &state,AllocFunc alloc_func,FreeFunc free_func)
+    {
+        const int thread_count=int(state.GetArg());
+
+        for(auto _:state)
+        {
+            std::vector<std::thread> threads;
+
+            for(int t=0;t<thread_count;t++)
+            {
+                threads.emplace_back([&]
+                {
+                    Node *list[BATCH];
+
+                    for(int r=0;r<ROUNDS;r++)
+                    {
+                        for(int i=0;i<BATCH;i++)list[i]=alloc_func();
+                        DoNotOptimize(list);
+                        for(int i=BATCH-1;i>=0;i--)free_func(list[i]);
+                    }
+                });
+            }
+
+            for(auto &th:threads)
+                th.join();
+        }
+
+        state.SetItemsProcessed(uint64(thread_count)*ROUNDS*BATCH);          //每条目为一次分配加一次释放
+    }
+
+    void BM_NewDelete(BenchmarkState &state)
+    {
+        RunThreads(state,[]{return new Node;},[](Node *n){delete n;});
+    }
+
+    void BM_SlabPool(BenchmarkState &state)
+    {
+        SlabPool<Node> pool;
+
+        RunThreads(state,[&]{return pool.Create();},[&](Node *n){pool.Release(n);});
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_NewDelete)->Range(1,8,2);
+HGL_BENCHMARK(BM_SlabPool)->Range(1,8,2);
@@ -0,0 +1,182 @@
+﻿/**
+ * strfmt 与 snprintf 格式化典型日志行的性能对比（正确性见 examples/StrFormatTest）
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/Str.Format.h>
+#include<cstdio>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr int VALUE_COUNT=64;
+
+    struct LogValue
+    {
+        int64 id;
+        uint32 port;
+        int32 status;
+        double ms;
+    };
+
+    std::vector<LogValue> MakeValues()
+    {
+        std::vector<LogValue> values(VALUE_COUNT);
+
+        uint64 seed=0x9E3779B97F4A7C15ull;
+
+        for(int i=0;i<VALUE_COUNT;i++)
+        {
+            seed^=seed<<13;
+            seed^=seed>>7;
+            seed^=seed<<17;
+
+            values[i].id    =int64(seed%10000000000ull);
+            values[i].port  =uint32(1024+seed%60000);
+            values[i].status=(i%7)?200:-1;
+            values[i].ms    =double(seed%1000000)/997.0;
+        }
+
+        return values;
+    }
+
+    void BM_strfmt_MixedLine(BenchmarkState &state)
+    {
+        const std::vector<LogValue> values=MakeValues();
+        char buf[256];
+        int i=0;
+
+        for(auto _:state)
+        {
+            const LogValue &v=values[i];
+
+            DoNotOptimize(strfmt(buf,int(sizeof(buf)),"[{}] {} request {} from {}:{} took {:.3f} ms status={}",
+                                 "INFO","http",v.id,"192.168.1.20",v.port,v.ms,v.status));
+            DoNotOptimize(buf);
+            i=(i+1)%VALUE_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_snprintf_MixedLine(BenchmarkState &state)
+    {
+        const std::vector<LogValue> values=MakeValues();
+        char buf[256];
+        int i=0;
+
+        for(auto _:state)
+        {
+            const LogValue &v=values[i];
+
+            DoNotOptimize(snprintf(buf,sizeof(buf),"[%s] %s request %lld from %s:%u took %.3f ms status=%d",
+                                   "INFO","http",(long long)v.id,"192.168.1.20",v.port,v.ms,v.status));
+            DoNotOptimize(buf);
+            i=(i+1)%VALUE_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_strfmt_Integers(BenchmarkState &state)
+    {
+        const std::vector<LogValue> values=MakeValues();
+        char buf[128];
+        int i=0;
+
+        for(auto _:state)
+        {
+            const LogValue &v=values[i];
+
+            DoNotOptimize(strfmt(buf,int(sizeof(buf)),"id={} port={} status={} seq={}",v.id,v.port,v.status,i));
+            DoNotOptimize(buf);
+            i=(i+1)%VALUE_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_snprintf_Integers(BenchmarkState &state)
+    {
+        const std::vector<LogValue> values=MakeValues();
+        char buf[128];
+        int i=0;
+
+        for(auto _:state)
+        {
+            const LogValue &v=values[i];
+
+            DoNotOptimize(snprintf(buf,sizeof(buf),"id=%lld port=%u status=%d seq=%d",(long long)v.id,v.port,v.status,i));
+            DoNotOptimize(buf);
+            i=(i+1)%VALUE_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_strfmt_Hex(BenchmarkState &state)
+    {
+        const std::vector<LogValue> values=MakeValues();
+        char buf[128];
+        int i=0;
+
+        for(auto _:state)
+        {
+            const LogValue &v=values[i];
+
+            DoNotOptimize(strfmt(buf,int(sizeof(buf)),"addr={:#018x} flags={:08X}",uint64(v.id)*4099,v.port));
+            DoNotOptimize(buf);
+            i=(i+1)%VALUE_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_snprintf_Hex(BenchmarkState &state)
+    {
+        const std::vector<LogValue> values=MakeValues();
+        char buf[128];
+        int i=0;
+
+        for(auto _:state)
+        {
+            const LogValue &v=values[i];
+
+            DoNotOptimize(snprintf(buf,sizeof(buf),"addr=%#018llx flags=%08X",(unsigned long long)(uint64(v.id)*4099),v.port));
+            DoNotOptimize(buf);
+            i=(i+1)%VALUE_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    /**
+     * 连续追加到可增长缓冲区，每轮清空重用
+     */
+    void BM_strfmt_BufferAppend(BenchmarkState &state)
+    {
+        const std::vector<LogValue> values=MakeValues();
+        FormatBuffer<char> fb;
+
+        for(auto _:state)
+        {
+            fb.Clear();
+
+            for(const LogValue &v:values)
+                strfmt(fb,"{}:{:.2f};",v.id,v.ms);
+
+            DoNotOptimize(fb.GetData());
+        }
+
+        state.SetItemsProcessed(VALUE_COUNT);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_strfmt_MixedLine);
+HGL_BENCHMARK(BM_snprintf_MixedLine);
+HGL_BENCHMARK(BM_strfmt_Integers);
+HGL_BENCHMARK(BM_snprintf_Integers);
+HGL_BENCHMARK(BM_strfmt_Hex);
+HGL_BENCHMARK(BM_snprintf_Hex);
+HGL_BENCHMARK(BM_strfmt_BufferAppend);
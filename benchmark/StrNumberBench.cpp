@@ -0,0 +1,162 @@
+﻿/**
+ * 字符串/数值互转性能（对应 examples/StrNumber/StrNumberQuickTest 覆盖的函数）
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/Str.Number.h>
+#include<cstring>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr int VALUE_COUNT=256;
+
+    /**
+     * 位数分布较广的一组整数
+     */
+    std::vector<int64> MakeValues()
+    {
+        std::vector<int64> values(VALUE_COUNT);
+
+        uint64 seed=0x9E3779B97F4A7C15ull;
+
+        for(int i=0;i<VALUE_COUNT;i++)
+        {
+            seed^=seed<<13;
+            seed^=seed>>7;
+            seed^=seed<<17;
+
+            const int digits=1+i%18;
+            int64 limit=1;
+
+            for(int d=0;d<digits;d++)
+                limit*=10;
+
+            values[i]=int64(seed%uint64(limit))*((i&1)?-1:1);
+        }
+
+        return values;
+    }
+
+    void BM_itos(BenchmarkState &state)
+    {
+        const std::vector<int64> values=MakeValues();
+        char buf[32];
+        int i=0;
+
+        for(auto _:state)
+        {
+            itos(buf,int(sizeof(buf)),values[i]);
+            DoNotOptimize(buf);
+            i=(i+1)%VALUE_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_utos_hex(BenchmarkState &state)
+    {
+        const std::vector<int64> values=MakeValues();
+        char buf[32];
+        int i=0;
+
+        for(auto _:state)
+        {
+            utos(buf,int(sizeof(buf)),uint64(values[i]),16);
+            DoNotOptimize(buf);
+            i=(i+1)%VALUE_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_stoi(BenchmarkState &state)
+    {
+        const std::vector<int64> values=MakeValues();
+        std::vector<std::string> text;
+
+        for(int64 v:values)
+            text.push_back(std::to_string(v));
+
+        int64 result;
+        int i=0;
+
+        for(auto _:state)
+        {
+            DoNotOptimize(hgl::stoi(text[i].c_str(),result));
+            DoNotOptimize(result);
+            i=(i+1)%VALUE_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_xtou(BenchmarkState &state)
+    {
+        const std::vector<int64> values=MakeValues();
+        std::vector<std::string> text;
+        char buf[32];
+
+        for(int64 v:values)
+        {
+            utos(buf,int(sizeof(buf)),uint64(v)>>4,16);
+            text.push_back(buf);
+        }
+
+        uint64 result;
+        int i=0;
+
+        for(auto _:state)
+        {
+            DoNotOptimize(hgl::xtou(text[i].c_str(),result));
+            DoNotOptimize(result);
+            i=(i+1)%VALUE_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_stof(BenchmarkState &state)
+    {
+        const char *text[]={"3.14159","-2.5","123456.789",".5","0.000123","98765.4321"};
+        constexpr int TEXT_COUNT=sizeof(text)/sizeof(text[0]);
+
+        double result;
+        int i=0;
+
+        for(auto _:state)
+        {
+            DoNotOptimize(hgl::stof(text[i],result));
+            DoNotOptimize(result);
+            i=(i+1)%TEXT_COUNT;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+
+    void BM_ftos(BenchmarkState &state)
+    {
+        const double values[]={3.14159,-2.5,123456.789,0.5,0.000123,98765.4321};
+        constexpr int VALUES=sizeof(values)/sizeof(values[0]);
+
+        char buf[64];
+        int i=0;
+
+        for(auto _:state)
+        {
+            ftos(buf,int(sizeof(buf)),4,values[i]);
+            DoNotOptimize(buf);
+            i=(i+1)%VALUES;
+        }
+
+        state.SetItemsProcessed(1);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_itos);
+HGL_BENCHMARK(BM_utos_hex);
+HGL_BENCHMARK(BM_stoi);
+HGL_BENCHMARK(BM_xtou);
+HGL_BENCHMARK(BM_stof);
+HGL_BENCHMARK(BM_ftos);
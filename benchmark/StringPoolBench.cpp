@@ -0,0 +1,200 @@
+﻿/**
+ * StringPool 驻留与句柄比较/查表（原 examples/StringPoolTest 中的计时部分）
+ *
+ * 参数为名称数量。所有名称共享较长的前缀，strcmp需要比较到差异处。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/type/StringPool.h>
+#include<hgl/type/HashMap.h>
+#include<unordered_map>
+#include<string>
+#include<vector>
+#include<random>
+#include<memory>
+#include<cstring>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr uint32 QUERY_COUNT=1<<20;                                 ///<每次迭代的比较/查找次数
+
+    std::string MakeName(uint32 i)
+    {
+        return "material/asset_"+std::to_string(i*2654435761u)+".mat";
+    }
+
+    std::vector<std::string> MakeNames(const uint32 count)
+    {
+        std::vector<std::string> names(count);
+
+        for(uint32 i=0;i<count;i++)
+            names[i]=MakeName(i);
+
+        return names;
+    }
+
+    /**
+     * 随机查询对，一半相等
+     */
+    struct Queries
+    {
+        std::vector<uint32> a,b;
+
+        explicit Queries(const uint32 name_count):a(QUERY_COUNT),b(QUERY_COUNT)
+        {
+            std::mt19937 rng(7);
+
+            for(uint32 i=0;i<QUERY_COUNT;i++)
+            {
+                a[i]=rng()%name_count;
+                b[i]=(i&1)?a[i]:rng()%name_count;
+            }
+        }
+    };
+
+    void BM_StringPoolInternNew(BenchmarkState &state)
+    {
+        const std::vector<std::string> names=MakeNames(uint32(state.GetArg()));
+        StringPoolStats st{};
+
+        for(auto _:state)
+        {
+            auto pool=std::make_unique<StringPool<char>>();
+
+            for(const std::string &name:names)
+                DoNotOptimize(pool->Intern(name));
+
+            state.PauseTiming();            //析构不计入驻留耗时
+            st=pool->GetStats();
+            pool.reset();
+            state.ResumeTiming();
+        }
+
+        state.SetItemsProcessed(names.size());
+        state.SetLabel(std::to_string(st.char_bytes/1024)+" KB text in "+std::to_string(st.arena_reserved/1024)
+                       +" KB arena + "+std::to_string(st.index_bytes/1024)+" KB index");
+    }
+
+    void BM_StringPoolInternExisting(BenchmarkState &state)
+    {
+        const std::vector<std::string> names=MakeNames(uint32(state.GetArg()));
+
+        StringPool<char> pool;
+        for(const std::string &name:names)
+            pool.Intern(name);
+
+        for(auto _:state)
+        {
+            uint64 sum=0;
+
+            for(const std::string &name:names)
+                sum+=pool.Intern(name).id;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(names.size());
+    }
+
+    void BM_StrcmpEquality(BenchmarkState &state)
+    {
+        const std::vector<std::string> names=MakeNames(uint32(state.GetArg()));
+        const Queries q(uint32(names.size()));
+
+        for(auto _:state)
+        {
+            uint32 eq=0;
+
+            for(uint32 i=0;i<QUERY_COUNT;i++)
+                eq+=(std::strcmp(names[q.a[i]].c_str(),names[q.b[i]].c_str())==0);
+
+            DoNotOptimize(eq);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+
+    void BM_StringHandleEquality(BenchmarkState &state)
+    {
+        const std::vector<std::string> names=MakeNames(uint32(state.GetArg()));
+        const Queries q(uint32(names.size()));
+
+        StringPool<char> pool;
+        std::vector<StringHandle> handles(names.size());
+
+        for(size_t i=0;i<names.size();i++)
+            handles[i]=pool.Intern(names[i]);
+
+        for(auto _:state)
+        {
+            uint32 eq=0;
+
+            for(uint32 i=0;i<QUERY_COUNT;i++)
+                eq+=(handles[q.a[i]]==handles[q.b[i]]);
+
+            DoNotOptimize(eq);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+
+    void BM_StdUnorderedMapStringLookup(BenchmarkState &state)
+    {
+        const std::vector<std::string> names=MakeNames(uint32(state.GetArg()));
+        const Queries q(uint32(names.size()));
+
+        std::unordered_map<std::string,uint32> by_string;
+
+        for(uint32 i=0;i<names.size();i++)
+            by_string[names[i]]=i;
+
+        for(auto _:state)
+        {
+            uint64 sum=0;
+
+            for(uint32 i=0;i<QUERY_COUNT;i++)
+                sum+=by_string.find(names[q.a[i]])->second;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+
+    void BM_HashMapStringHandleLookup(BenchmarkState &state)
+    {
+        const std::vector<std::string> names=MakeNames(uint32(state.GetArg()));
+        const Queries q(uint32(names.size()));
+
+        StringPool<char> pool;
+        std::vector<StringHandle> handles(names.size());
+        HashMap<StringHandle,uint32> by_handle;
+
+        for(uint32 i=0;i<names.size();i++)
+        {
+            handles[i]=pool.Intern(names[i]);
+            by_handle[handles[i]]=i;
+        }
+
+        for(auto _:state)
+        {
+            uint64 sum=0;
+
+            for(uint32 i=0;i<QUERY_COUNT;i++)
+                sum+=by_handle.find(handles[q.a[i]])->second;
+
+            DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(QUERY_COUNT);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_StringPoolInternNew)->Range(1<<10,1<<16);
+HGL_BENCHMARK(BM_StringPoolInternExisting)->Range(1<<10,1<<16);
+HGL_BENCHMARK(BM_StrcmpEquality)->Range(1<<10,1<<16);
+HGL_BENCHMARK(BM_StringHandleEquality)->Range(1<<10,1<<16);
+HGL_BENCHMARK(BM_StdUnorderedMapStringLookup)->Range(1<<10,1<<16);
+HGL_BENCHMARK(BM_HashMapStringHandleLookup)->Range(1<<10,1<<16);
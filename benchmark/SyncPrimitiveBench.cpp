@@ -0,0 +1,224 @@
+﻿/**
+ * 同步原语争用下的吞吐量（原 examples/SyncPrimitiveTest 中的计时部分）
+ *
+ * 与 pthread_mutex_t/pthread_rwlock_t/sem_t 对比，参数为线程数，每次迭代完成固定的总操作数。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/thread/FutexMutex.h>
+#include<hgl/thread/TicketLock.h>
+#include<hgl/thread/SeqLock.h>
+#include<hgl/thread/Semaphore.h>
+#include<hgl/platform/os/PosixThread.h>
+#include<vector>
+#include<thread>
+#include<atomic>
+#include<chrono>
+#include<algorithm>
+
+using namespace hgl;
+
+namespace
+{
+    constexpr int64 TOTAL_OPS=1<<16;                                    ///<每次迭代所有线程合计的操作数
+
+    template<typename F>
+    void RunThreads(int count,F &&f)
+    {
+        std::vector<std::thread> threads;
+
+        for(int i=0;i<count;i++)
+            threads.emplace_back([&f,i]{f(i);});
+
+        for(auto &t:threads)
+            t.join();
+    }
+
+    /**
+     * 第i个线程分到的操作数
+     */
+    int64 ShareOf(const int i,const int count)
+    {
+        return TOTAL_OPS/count+(i<TOTAL_OPS%count?1:0);
+    }
+
+    /**
+     * pthread_mutex_t 包装成与其它锁相同的接口
+     */
+    class PthreadMutex
+    {
+        thread_mutex_ptr mutex;
+
+    public:
+
+        PthreadMutex(){pthread_mutex_init(&mutex,nullptr);}
+        ~PthreadMutex(){pthread_mutex_destroy(&mutex);}
+
+        void lock(){pthread_mutex_lock(&mutex);}
+        void unlock(){pthread_mutex_unlock(&mutex);}
+    };
+
+    /**
+     * 锁争用：每个线程反复加锁、修改两个缓存行、解锁、在锁外做少量工作
+     */
+    template<typename L>
+    void LockContention(BenchmarkState &state)
+    {
+        const int threads=int(state.GetArg());
+
+        L lock;
+        struct alignas(64) Line{int64 v=0;};
+        Line shared[2];
+
+        for(auto _:state)
+        {
+            RunThreads(threads,[&](int i)
+            {
+                uint32 local=uint32(i);
+
+                for(int64 n=ShareOf(i,threads);n>0;n--)
+                {
+                    lock.lock();
+                    ++shared[0].v;
+                    ++shared[1].v;
+                    lock.unlock();
+
+                    for(int k=0;k<16;k++)                               //锁外工作
+                        local=local*1664525u+1013904223u;
+                }
+
+                DoNotOptimize(local);
+            });
+        }
+
+        state.SetItemsProcessed(TOTAL_OPS);
+    }
+
+    void BM_PthreadMutexContention (BenchmarkState &state){LockContention<PthreadMutex>(state);}
+    void BM_FutexMutexContention   (BenchmarkState &state){LockContention<FutexMutex>(state);}
+    void BM_TicketLockContention   (BenchmarkState &state){LockContention<TicketLock>(state);}
+
+    struct Triple
+    {
+        uint64 a,b,c;
+        uint32 d;
+    };
+
+    class PthreadRWLock
+    {
+        rwlock_ptr lock;
+        Triple value{};
+
+    public:
+
+        PthreadRWLock(){pthread_rwlock_init(&lock,nullptr);}
+        ~PthreadRWLock(){pthread_rwlock_destroy(&lock);}
+
+        Triple Load(){pthread_rwlock_rdlock(&lock);Triple v=value;pthread_rwlock_unlock(&lock);return v;}
+        void Store(const Triple &v){pthread_rwlock_wrlock(&lock);value=v;pthread_rwlock_unlock(&lock);}
+    };
+
+    /**
+     * 读多写少：1个写者每隔100us写一次，其余线程读
+     */
+    template<typename S>
+    void ReadMostly(BenchmarkState &state)
+    {
+        const int readers=std::max(1,int(state.GetArg())-1);
+
+        S store;
+
+        for(auto _:state)
+        {
+            std::atomic<int> remaining{readers};
+
+            RunThreads(readers+1,[&](int i)
+            {
+                if(i==readers)                                          //写者
+                {
+                    for(uint64 a=1;remaining.load(std::memory_order_relaxed)>0;a++)
+                    {
+                        store.Store({a,a*2,a*3,uint32(a)});
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    }
+
+                    return;
+                }
+
+                uint64 sum=0;
+
+                for(int64 n=ShareOf(i,readers);n>0;n--)
+                    sum+=store.Load().b;
+
+                DoNotOptimize(sum);
+                remaining.fetch_sub(1,std::memory_order_relaxed);
+            });
+        }
+
+        state.SetItemsProcessed(TOTAL_OPS);
+    }
+
+    void BM_PthreadRWLockReadMostly(BenchmarkState &state){ReadMostly<PthreadRWLock>(state);}
+    void BM_SeqLockReadMostly      (BenchmarkState &state){ReadMostly<SeqLock<Triple>>(state);}
+
+    /**
+     * sem_t 包装
+     */
+    class PosixSemaphore
+    {
+        sem_t sem;
+
+    public:
+
+        PosixSemaphore(){sem_init(&sem,0,0);}
+        ~PosixSemaphore(){sem_destroy(&sem);}
+
+        void Acquire(){while(sem_wait(&sem)!=0);}
+        void Release(){sem_post(&sem);}
+    };
+
+    /**
+     * 信号量：一半线程Release，一半线程Acquire
+     */
+    template<typename S>
+    void SemaphoreHandoff(BenchmarkState &state)
+    {
+        const int threads=int(state.GetArg());
+        const int producers=std::max(1,threads/2);
+        const int consumers=std::max(1,threads-producers);
+
+        S sem;
+
+        for(auto _:state)
+        {
+            RunThreads(producers+consumers,[&](int i)
+            {
+                if(i<producers)
+                {
+                    for(int64 n=ShareOf(i,producers);n>0;n--)
+                        sem.Release();
+                }
+                else
+                {
+                    for(int64 n=ShareOf(i-producers,consumers);n>0;n--)
+                        sem.Acquire();
+                }
+            });
+        }
+
+        state.SetItemsProcessed(TOTAL_OPS);
+    }
+
+    void BM_PosixSemaphoreHandoff(BenchmarkState &state){SemaphoreHandoff<PosixSemaphore>(state);}
+    void BM_SemaphoreHandoff     (BenchmarkState &state){SemaphoreHandoff<Semaphore>(state);}
+}//namespace
+
+HGL_BENCHMARK(BM_PthreadMutexContention)->Range(1,64,2);
+HGL_BENCHMARK(BM_FutexMutexContention)->Range(1,64,2);
+HGL_BENCHMARK(BM_TicketLockContention)->Range(1,64,2);
+
+HGL_BENCHMARK(BM_PthreadRWLockReadMostly)->Range(2,64,2);
+HGL_BENCHMARK(BM_SeqLockReadMostly)->Range(2,64,2);
+
+HGL_BENCHMARK(BM_PosixSemaphoreHandoff)->Range(2,64,2);
+HGL_BENCHMARK(BM_SemaphoreHandoff)->Range(2,64,2);
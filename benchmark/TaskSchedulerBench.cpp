@@ -0,0 +1,195 @@
+﻿/**
+ * TaskScheduler 并行现有批量函数与任务开销（原 examples/TaskSchedulerTest 中的计时部分）
+ *
+ * 参数为线程数（含调用线程），Serial 为不经调度器直接调用批量函数。
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/thread/TaskScheduler.h>
+#include<hgl/color/ColorFormat.h>
+#include<hgl/type/Str.NumberArray.h>
+#include<vector>
+#include<string>
+#include<atomic>
+#include<algorithm>
+
+using namespace hgl;
+
+namespace
+{
+    TaskScheduler::Config MakeConfig(BenchmarkState &state)
+    {
+        TaskScheduler::Config cfg;
+        cfg.worker_count=int(state.GetArg())-1;
+        return cfg;
+    }
+
+    constexpr int64 PIXELS=int64(4)<<20;
+
+    std::vector<uint8> MakeRGB()
+    {
+        std::vector<uint8> rgb(PIXELS*3);
+
+        for(int64 i=0;i<PIXELS*3;i++)
+            rgb[i]=uint8(i*131+7);
+
+        return rgb;
+    }
+
+    void BM_RGB8toRGB565Serial(BenchmarkState &state)
+    {
+        std::vector<uint8> rgb=MakeRGB();
+        std::vector<uint16> out(PIXELS);
+
+        for(auto _:state)
+        {
+            RGB8toRGB565(out.data(),rgb.data(),uint(PIXELS));
+            ClobberMemory();
+        }
+
+        state.SetItemsProcessed(PIXELS);
+    }
+
+    /**
+     * RGB8->RGB565：直接把现有的批量函数用于每个子区间
+     */
+    void BM_RGB8toRGB565ParallelFor(BenchmarkState &state)
+    {
+        TaskScheduler ts(MakeConfig(state));
+
+        std::vector<uint8> rgb=MakeRGB();
+        std::vector<uint16> out(PIXELS);
+
+        for(auto _:state)
+        {
+            ts.ParallelFor(0,PIXELS,[&](int64 b,int64 e)
+            {
+                RGB8toRGB565(out.data()+b,rgb.data()+b*3,uint(e-b));
+            });
+
+            ClobberMemory();
+        }
+
+        state.SetItemsProcessed(PIXELS);
+    }
+
+    /**
+     * 逗号分隔的整数文本，按逗号切成若干段，各段可独立解析
+     * (parse_float_array 中 etof 每个数都向后扫描'e'直到字符串结尾，长文本是平方复杂度，不适合做这个测试)
+     */
+    struct IntText
+    {
+        static constexpr int64 COUNT    =int64(1)<<20;
+        static constexpr int64 SEGMENTS =64;
+
+        std::string text;
+        std::vector<size_t> seg_pos;                                    ///<每段的起始位置
+        std::vector<int64> seg_index;                                   ///<每段第一个元素的序号
+
+        IntText():seg_pos(SEGMENTS+1),seg_index(SEGMENTS+1)
+        {
+            text.reserve(COUNT*10);
+
+            for(int64 i=0;i<COUNT;i++)
+            {
+                if(i)text+=',';
+                text+=std::to_string((i*7919)%2000003-1000000);
+            }
+
+            seg_pos[0]=0;
+            seg_index[0]=0;
+
+            for(int64 s=1;s<SEGMENTS;s++)
+            {
+                size_t p=text.size()*size_t(s)/SEGMENTS;
+
+                while(text[p]!=',')++p;
+
+                seg_pos[s]=p+1;
+            }
+
+            seg_pos[SEGMENTS]=text.size()+1;
+
+            for(int64 s=1;s<=SEGMENTS;s++)                              //每段的元素数为段内逗号数+1
+                seg_index[s]=seg_index[s-1]+int64(std::count(text.begin()+seg_pos[s-1],text.begin()+(seg_pos[s]-1),','))+1;
+        }
+    };
+
+    void BM_ParseIntArraySerial(BenchmarkState &state)
+    {
+        const IntText data;
+        std::vector<int32> result(IntText::COUNT);
+
+        for(auto _:state)
+            DoNotOptimize(parse_int_array(data.text.c_str(),result.data(),size_t(IntText::COUNT)));
+
+        state.SetBytesProcessed(data.text.size());
+    }
+
+    void BM_ParseIntArrayParallelFor(BenchmarkState &state)
+    {
+        TaskScheduler ts(MakeConfig(state));
+
+        const IntText data;
+        std::vector<int32> result(IntText::COUNT);
+
+        for(auto _:state)
+        {
+            std::atomic<int64> parsed{0};
+
+            ts.ParallelFor(0,IntText::SEGMENTS,[&](int64 s)
+            {
+                const int n=parse_int_array(data.text.c_str()+data.seg_pos[s],result.data()+data.seg_index[s],size_t(data.seg_index[s+1]-data.seg_index[s]));
+                parsed.fetch_add(n,std::memory_order_relaxed);
+            },1);
+
+            DoNotOptimize(parsed.load());
+        }
+
+        state.SetBytesProcessed(data.text.size());
+    }
+
+    /**
+     * 任务开销：提交大量空任务后等待全部完成
+     */
+    void BM_TaskSchedulerRunWaitAll(BenchmarkState &state)
+    {
+        constexpr int TASKS=1<<16;
+
+        TaskScheduler ts(MakeConfig(state));
+        std::atomic<int64> n{0};
+
+        for(auto _:state)
+        {
+            for(int i=0;i<TASKS;i++)
+                ts.Run([&n]{n.fetch_add(1,std::memory_order_relaxed);});
+
+            ts.WaitAll();
+        }
+
+        state.SetItemsProcessed(TASKS);
+    }
+
+    void BM_TaskSchedulerParallelForItem(BenchmarkState &state)
+    {
+        constexpr int64 ITEMS=int64(1)<<22;
+
+        TaskScheduler ts(MakeConfig(state));
+        std::vector<int64> v(ITEMS);
+
+        for(auto _:state)
+        {
+            ts.ParallelFor(0,ITEMS,[&](int64 i){v[i]=i;});
+            ClobberMemory();
+        }
+
+        state.SetItemsProcessed(ITEMS);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_RGB8toRGB565Serial);
+HGL_BENCHMARK(BM_RGB8toRGB565ParallelFor)->Range(1,8,2);
+HGL_BENCHMARK(BM_ParseIntArraySerial);
+HGL_BENCHMARK(BM_ParseIntArrayParallelFor)->Range(1,8,2);
+HGL_BENCHMARK(BM_TaskSchedulerRunWaitAll)->Range(1,8,2);
+HGL_BENCHMARK(BM_TaskSchedulerParallelForItem)->Range(1,8,2);
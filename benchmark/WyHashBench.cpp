@@ -0,0 +1,42 @@
+﻿/**
+ * wyhash 吞吐量（examples/WyHashTest 只验证正确性，这里补充性能）
+ */
+
+#include<hgl/benchmark/Benchmark.h>
+#include<hgl/util/hash/QuickHash.h>
+
+using namespace hgl;
+
+namespace
+{
+    void BM_WyHashBytes(BenchmarkState &state)
+    {
+        const size_t len=size_t(state.GetArg());
+
+        std::vector<uint8> data(len);
+
+        for(size_t i=0;i<len;i++)
+            data[i]=uint8((i*131)&0xFF);
+
+        for(auto _:state)
+            DoNotOptimize(wyhash(data.data(),len,0,_wyp));
+
+        state.SetBytesProcessed(len);
+    }
+
+    void BM_HashMix64(BenchmarkState &state)
+    {
+        uint64 v=0x123456789ABCDEFull;
+
+        for(auto _:state)
+        {
+            v=HashMix64(v);
+            DoNotOptimize(v);
+        }
+
+        state.SetItemsProcessed(1);
+    }
+}//namespace
+
+HGL_BENCHMARK(BM_WyHashBytes)->Arg(8)->Arg(16)->Arg(32)->Arg(64)->Arg(256)->Arg(1024)->Arg(65536);
+HGL_BENCHMARK(BM_HashMix64);
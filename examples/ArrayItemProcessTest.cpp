@@ -3,7 +3,6 @@
 #include <vector>
 #include <iostream>
 #include <stdexcept>
-#include <chrono>
 #include <random>
 #include <algorithm>
 #include <sstream>
@@ -38,19 +37,6 @@ struct Pod
     }
 };
 
-// 性能计时辅助类
-class Timer
-{
-    std::chrono::high_resolution_clock::time_point start;
-public:
-    Timer() : start(std::chrono::high_resolution_clock::now()) {}
-    double ElapsedMs() const
-    {
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration<double, std::milli>(end - start).count();
-    }
-};
-
 void TestRawTypeCallback()
 {
     std::cout << "[TestRawTypeCallback] Running..." << std::endl;
@@ -86,9 +72,7 @@ void TestRawTypeCallback()
         for(int i = 0; i < scale; ++i)
             CHECK(large_dst[i] == -1, "Initial dst corruption");
 
-        Timer timer;
         cb.Equal(large_dst.data(), large_src.data(), scale);
-        double elapsed = timer.ElapsedMs();
 
         // 完整验证：逐个检查所有元素
         int mismatch_count = 0;
@@ -108,7 +92,7 @@ void TestRawTypeCallback()
         CHECK(large_dst[0] == large_src[0], "First element mismatch");
         CHECK(large_dst[scale-1] == large_src[scale-1], "Last element mismatch");
 
-        std::cout << "  [Scale " << scale << "] Bulk copy: " << elapsed << " ms (all " << scale << " elements verified)" << std::endl;
+        std::cout << "  [Scale " << scale << "] Bulk copy: all " << scale << " elements verified" << std::endl;
     }
 
     // 边界测试：空数组、单元素
@@ -162,9 +146,7 @@ void TestMemoryCallback()
         // 验证目标数组初始状态
         CHECK(large_dst[0].a == -999 && large_dst[0].b == -999, "Dst init failed");
 
-        Timer timer;
         cb.Equal(large_dst.data(), large_src.data(), scale);
-        double elapsed = timer.ElapsedMs();
 
         // 逐个验证所有元素的两个字段
         int error_count = 0;
@@ -189,8 +171,7 @@ void TestMemoryCallback()
             CHECK(large_dst[idx] == large_src[idx], "Random spot check failed");
         }
 
-        std::cout << "  [Scale " << scale << "] Pod bulk copy: " << elapsed
-                  << " ms (verified + 10 random checks)" << std::endl;
+        std::cout << "  [Scale " << scale << "] Pod bulk copy: verified + 10 random checks" << std::endl;
     }
 
     std::cout << "[TestMemoryCallback] Passed" << std::endl;
@@ -215,7 +196,6 @@ void TestFindDataPositionInArray()
         for(int i = 0; i < scale; ++i)
             data[i] = i * 3 + 7;
 
-        Timer timer;
         // 查找存在的元素（首、中、尾）
         int64 pos_first = FindDataPositionInArray(data.data(), static_cast<int64>(scale), data[0]);
         int64 pos_mid = FindDataPositionInArray(data.data(), static_cast<int64>(scale), data[scale / 2]);
@@ -238,15 +218,12 @@ void TestFindDataPositionInArray()
             }
         }
 
-        double elapsed = timer.ElapsedMs();
-
         CHECK(pos_first == 0, "Large scale find first failed");
         CHECK(pos_mid == scale / 2, "Large scale find mid failed");
         CHECK(pos_last == scale - 1, "Large scale find last failed");
         CHECK(pos_missing == -1, "Large scale find missing failed");
 
-        std::cout << "  [Scale " << scale << "] Unsorted search: " << elapsed
-                  << " ms (+ 20 random verifications)" << std::endl;
+        std::cout << "  [Scale " << scale << "] Unsorted search: first/mid/last/missing + 20 random verifications" << std::endl;
     }
 
     // 重复元素测试
@@ -280,7 +257,6 @@ void TestFindDataPositionInSortedArray()
         for(int i = 1; i < scale; ++i)
             CHECK(sorted_data[i] > sorted_data[i-1], "Data not sorted!");
 
-        Timer timer;
         // 查找存在的元素
         int64 pos_first = FindDataPositionInSortedArray(sorted_data.data(), static_cast<int64>(scale), 0);
         int64 pos_mid = FindDataPositionInSortedArray(sorted_data.data(), static_cast<int64>(scale), (scale / 2) * 2);
@@ -308,14 +284,11 @@ void TestFindDataPositionInSortedArray()
             CHECK(pos == -1, "Odd number should not be found");
         }
 
-        double elapsed = timer.ElapsedMs();
-
         CHECK(pos_first == 0, "Large scale sorted find first failed");
         CHECK(pos_mid == scale / 2, "Large scale sorted find mid failed");
         CHECK(pos_last == scale - 1, "Large scale sorted find last failed");
 
-        std::cout << "  [Scale " << scale << "] Binary search: " << elapsed
-                  << " ms (+ 30 random + 6 missing checks)" << std::endl;
+        std::cout << "  [Scale " << scale << "] Binary search: 30 random + 6 missing checks" << std::endl;
     }
 
     std::cout << "[TestFindDataPositionInSortedArray] Passed" << std::endl;
@@ -348,7 +321,6 @@ void TestFindInsertPositionInSortedArray()
         for(int i = 0; i < scale; ++i)
             sorted_data[i] = i * 10; // 间隔较大，方便测试插入
 
-        Timer timer;
         int64 insert_pos = -1;
 
         // 测试查找已存在元素
@@ -414,9 +386,7 @@ void TestFindInsertPositionInSortedArray()
             }
         }
 
-        double elapsed = timer.ElapsedMs();
-        std::cout << "  [Scale " << scale << "] Insert position search: " << elapsed
-                  << " ms (+ 20 random position verifications)" << std::endl;
+        std::cout << "  [Scale " << scale << "] Insert position search: 20 random position verifications" << std::endl;
     }
 
     std::cout << "[TestFindInsertPositionInSortedArray] Passed" << std::endl;
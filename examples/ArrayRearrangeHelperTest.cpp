@@ -6,7 +6,6 @@
 #include <iostream>
 #include <new>
 #include <stdexcept>
-#include <chrono>
 #include <random>
 #include <sstream>
 
@@ -16,19 +15,6 @@
     throw std::runtime_error(oss.str()); \
 } } while(0)
 
-// 性能计时辅助类
-class Timer
-{
-    std::chrono::high_resolution_clock::time_point start;
-public:
-    Timer() : start(std::chrono::high_resolution_clock::now()) {}
-    double ElapsedMs() const
-    {
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration<double, std::milli>(end - start).count();
-    }
-};
-
 struct Tracker
 {
     static int constructed;
@@ -119,10 +105,8 @@ void TestTrivialRearrange()
         // 模式1: 将数组分成两半并交换
         {
             int half = scale / 2;
-            Timer timer;
             bool ok = hgl::ArrayRearrange(dest, src.data(), scale,
                                          {half, scale - half}, {1, 0});
-            double elapsed = timer.ElapsedMs();
 
             CHECK(ok, "Large scale rearrange (swap halves) failed");
 
@@ -134,7 +118,7 @@ void TestTrivialRearrange()
             for(int i = half; i < scale; ++i)
                 CHECK(dest[i] == src[i - half], "Swap halves verification failed");
 
-            std::cout << "  [Scale " << scale << "] Swap halves: " << elapsed << " ms" << std::endl;
+            std::cout << "  [Scale " << scale << "] Swap halves verified" << std::endl;
         }
 
         // 模式2: 逆序排列
@@ -148,12 +132,10 @@ void TestTrivialRearrange()
                 indices.push_back(scale - 1 - i);
             }
 
-            Timer timer;
             hgl::ArrayRearrangeHelper helper(scale, scale);
             for(auto f : fields)
                 helper.AddField(f);
             bool ok = helper.Rearrange(dest, src.data(), indices.data());
-            double elapsed = timer.ElapsedMs();
 
             CHECK(ok, "Large scale reverse rearrange failed");
 
@@ -161,7 +143,7 @@ void TestTrivialRearrange()
             for(int i = 0; i < scale; ++i)
                 CHECK(dest[i] == src[scale - 1 - i], "Reverse order verification failed");
 
-            std::cout << "  [Scale " << scale << "] Reverse order: " << elapsed << " ms" << std::endl;
+            std::cout << "  [Scale " << scale << "] Reverse order verified" << std::endl;
         }
 
         hgl::array_free(dest);
@@ -215,11 +197,9 @@ void TestNonTrivialRearrange()
 
         // 测试：将数组分成4段并打乱顺序
         int quarter = scale / 4;
-        Timer timer;
         bool ok = hgl::ArrayRearrange(dest, src_vec.data(), scale,
                                      {quarter, quarter, quarter, scale - quarter * 3},
                                      {2, 0, 3, 1});
-        double elapsed = timer.ElapsedMs();
 
         CHECK(ok, "Large scale non-trivial rearrange failed");
 
@@ -263,8 +243,7 @@ void TestNonTrivialRearrange()
             throw std::runtime_error(oss.str());
         }
 
-        std::cout << "  [Scale " << scale << "] Non-trivial rearrange: " << elapsed
-                  << " ms (" << Tracker::moved << " moves, "
+        std::cout << "  [Scale " << scale << "] Non-trivial rearrange verified (" << Tracker::moved << " moves, "
                   << Tracker::Alive() << " objects alive)" << std::endl;
 
         // 清理
@@ -381,12 +360,10 @@ void TestStressRearrange()
             indices.push_back(i);
         std::shuffle(indices.begin(), indices.end(), gen);
 
-        Timer timer;
         hgl::ArrayRearrangeHelper helper(scale, num_fields);
         for(auto f : fields)
             helper.AddField(f);
         bool ok = helper.Rearrange(dest, src.data(), indices.data());
-        double elapsed = timer.ElapsedMs();
 
         CHECK(ok, "Random stress rearrange failed");
 
@@ -401,7 +378,7 @@ void TestStressRearrange()
             CHECK(counts[i] == 1, "Element duplication or loss detected");
 
         std::cout << "  [Scale " << scale << "] Random " << num_fields
-                  << "-way rearrange: " << elapsed << " ms" << std::endl;
+                  << "-way rearrange verified" << std::endl;
 
         hgl::array_free(dest);
     }
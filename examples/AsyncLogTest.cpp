@@ -0,0 +1,515 @@
+﻿/**
+ * 异步日志测试
+ *
+ * 1.SPSCByteRing：变长记录、环尾填充、最大记录长度、双线程压力
+ * 2.各类参数的输出与strfmt一致，行首时间/级别/线程号格式，字符串截断
+ * 3.级别过滤与运行时修改、Flush
+ * 4.多线程：每个线程的记录保持顺序，线程退出后缓冲区回收
+ * 5.缓冲区写满：Drop策略计数并输出丢弃条数，Block策略不丢失
+ *
+ * 调用线程每条日志的开销（对比同步 strfmt/snprintf+write）与多线程吞吐见 benchmark/AsyncLogBench.cpp
+ */
+
+#include<hgl/log/AsyncLog.h>
+#include<hgl/type/ByteSink.h>
+#include<iostream>
+#include<vector>
+#include<string>
+#include<thread>
+#include<random>
+#include<cstdio>
+#include<cstring>
+#include<cstdlib>
+#include<unistd.h>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    /**
+     * 输出到临时文件的日志会话，结束时停止日志并读回全部行
+     */
+    class LogSession
+    {
+        char path[64];
+        int fd;
+        FdByteSink *sink;
+
+    public:
+
+        explicit LogSession(LogConfig config)
+        {
+            strcpy(path,"/tmp/AsyncLogTestXXXXXX");
+            fd=mkstemp(path);
+            CHECK(fd>=0);
+
+            sink=new FdByteSink(fd,true);
+
+            config.sink=sink;
+            bool started=AsyncLog::Start(config);
+            CHECK(started);
+            started=AsyncLog::Start(config);                        //不能重复启动
+            CHECK(!started);
+        }
+
+        ~LogSession()
+        {
+            AsyncLog::Stop();
+            delete sink;
+            unlink(path);
+        }
+
+        NO_COPY_NO_MOVE(LogSession)
+
+        std::vector<std::string> ReadLines()const
+        {
+            std::vector<std::string> lines;
+
+            FILE *fp=fopen(path,"rb");
+            CHECK(fp);
+
+            std::string text;
+            char buf[4096];
+            size_t n;
+
+            while((n=fread(buf,1,sizeof(buf),fp))>0)
+                text.append(buf,n);
+
+            fclose(fp);
+
+            size_t pos=0;
+
+            while(pos<text.size())
+            {
+                size_t end=text.find('\n',pos);
+                CHECK(end!=std::string::npos);                     //每条记录都以换行结束
+
+                lines.push_back(text.substr(pos,end-pos));
+                pos=end+1;
+            }
+
+            return lines;
+        }
+
+        std::vector<std::string> StopAndRead()
+        {
+            AsyncLog::Stop();
+            return ReadLines();
+        }
+    };//class LogSession
+
+    /**
+     * "YYYY-MM-DD hh:mm:ss.uuuuuu L [tid] text" 取出级别与正文
+     */
+    bool SplitLine(const std::string &line,char &level,std::string &text)
+    {
+        if(line.size()<31)
+            return(false);
+
+        for(int i:{4,7})if(line[i]!='-')return(false);
+        for(int i:{13,16})if(line[i]!=':')return(false);
+        if(line[10]!=' '||line[19]!='.'||line[26]!=' '||line[28]!=' '||line[29]!='[')
+            return(false);
+
+        const size_t end=line.find("] ",30);
+
+        if(end==std::string::npos)
+            return(false);
+
+        level=line[27];
+        text=line.substr(end+2);
+        return(true);
+    }
+
+    std::vector<std::string> Texts(const std::vector<std::string> &lines)
+    {
+        std::vector<std::string> result;
+
+        for(const std::string &line:lines)
+        {
+            char level;
+            std::string text;
+
+            const bool split=SplitLine(line,level,text);
+            CHECK(split);
+            result.push_back(text);
+        }
+
+        return result;
+    }
+
+    void TestByteRing()
+    {
+        std::cout<<"[TestByteRing]"<<std::endl;
+
+        {
+            SPSCByteRing ring(200);
+            uint32 size;
+
+            CHECK(ring.GetCapacity()==256);
+            CHECK(ring.GetMaxRecordSize()==120);
+            const void *too_big=ring.Reserve(121);
+            CHECK(!too_big);
+            const void *record=ring.Peek(size);
+            CHECK(!record);
+
+            //反复写入大小不一的记录，覆盖环尾填充的各种位置
+            for(int round=0;round<1000;round++)
+            {
+                const size_t len=1+(round*37)%120;
+
+                auto drain=[&]
+                {
+                    while(const uint8 *q=static_cast<const uint8 *>(ring.Peek(size)))
+                    {
+                        CHECK(size>=1&&size<=120);
+
+                        for(uint32 i=0;i<size;i++)
+                            CHECK(q[i]==q[0]);
+
+                        ring.Release();
+                    }
+
+                    CHECK(ring.IsEmpty());
+                };
+
+                uint8 *p=static_cast<uint8 *>(ring.Reserve(len));
+
+                if(!p)                                              //积压的记录加上环尾填充放不下，取空后一定可以
+                {
+                    drain();
+                    p=static_cast<uint8 *>(ring.Reserve(len));
+                }
+
+                CHECK(p&&(reinterpret_cast<std::uintptr_t>(p)&7)==0);
+
+                memset(p,round&0xFF,len);
+                ring.Commit();
+
+                if(round%3!=0)                                      //每三条积压一次
+                    drain();
+            }
+
+            while(ring.Peek(size))
+                ring.Release();
+
+            //写满
+            int count=0;
+
+            while(ring.Reserve(24))
+            {
+                ring.Commit();
+                ++count;
+            }
+
+            CHECK(count==256/32||count==256/32-1);                  //环尾填充最多占去一条
+        }
+
+        //双线程：随机长度，内容为序号
+        {
+            SPSCByteRing ring(4096);
+            constexpr uint32 N=300000;
+
+            std::thread producer([&]
+            {
+                std::mt19937 rng(5);
+
+                for(uint32 i=0;i<N;i++)
+                {
+                    const size_t len=sizeof(uint32)*(1+rng()%100);
+
+                    void *p;
+
+                    while(!(p=ring.Reserve(len)))
+                        std::this_thread::yield();
+
+                    uint32 *w=static_cast<uint32 *>(p);
+
+                    for(size_t k=0;k<len/sizeof(uint32);k++)
+                        w[k]=i;
+
+                    ring.Commit();
+                }
+            });
+
+            uint32 expect=0;
+            uint32 size;
+
+            while(expect<N)
+            {
+                const uint32 *r=static_cast<const uint32 *>(ring.Peek(size));
+
+                if(!r)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                for(uint32 k=0;k<size/sizeof(uint32);k++)
+                    CHECK(r[k]==expect);
+
+                ring.Release();
+                ++expect;
+            }
+
+            producer.join();
+            CHECK(ring.IsEmpty());
+        }
+    }
+
+    enum class Color:uint8{Red=1,Green=2};
+
+    void TestFormat()
+    {
+        std::cout<<"[TestFormat]"<<std::endl;
+
+        const std::string str="string";
+        const char *cstr="cstr";
+        const char *null_str=nullptr;
+        const int value=0;
+        char ptr_text[32];
+
+        strfmt(ptr_text,32,"{}",&value);
+
+        std::vector<std::string> expect;
+
+        LogSession session(LogConfig{});
+
+        HGL_LOG_INFO("no args");                                                    expect.push_back("no args");
+        HGL_LOG_INFO("{} {} {} {}",-1,uint64(18446744073709551615ull),int8(-5),Color::Green);
+                                                                                    expect.push_back("-1 18446744073709551615 -5 2");
+        HGL_LOG_INFO("{:#x} {:08b} {:+} {:>5}|",255,5u,7,42);                       expect.push_back("0xff 00000101 +7    42|");
+        HGL_LOG_INFO("{} {:.3f} {:e} {}",0.1,3.14159,12345.678,2.5f);               expect.push_back("0.1 3.142 1.234568e+04 2.5");
+        HGL_LOG_INFO("{} {} {} [{}] {:.2}",str,cstr,"lit",null_str,str);            expect.push_back("string cstr lit [] st");
+        HGL_LOG_INFO("{} {} {:d}",true,'x','A');                                    expect.push_back("true x 65");
+        HGL_LOG_INFO("{} {}",&value,nullptr);                                       expect.push_back(std::string(ptr_text)+" 0x0");
+        HGL_LOG_INFO("{{}} {}%",100);                                               expect.push_back("{} 100%");
+
+        //字符串在调用时复制，之后修改不影响输出
+        {
+            char temp[16]="before";
+
+            HGL_LOG_INFO("{}",temp);                                                expect.push_back("before");
+
+            strcpy(temp,"after");
+        }
+
+        //超长字符串截断
+        const std::string long_text(3000,'z');
+
+        HGL_LOG_INFO("<{}>",long_text);                                             expect.push_back("<"+std::string(log_detail::MAX_STRING_LENGTH,'z')+">");
+
+        HGL_LOG_WARNING("w");
+        HGL_LOG_ERROR("e");
+        HGL_LOG_FATAL("f");
+
+        const std::vector<std::string> lines=session.StopAndRead();
+
+        CHECK(lines.size()==expect.size()+3);
+
+        for(size_t i=0;i<expect.size();i++)
+        {
+            char level;
+            std::string text;
+
+            const bool split=SplitLine(lines[i],level,text);
+            CHECK(split&&level=='I');
+
+            if(text!=expect[i])
+                std::cout<<"  mismatch: got \""<<text<<"\" expect \""<<expect[i]<<"\""<<std::endl;
+
+            CHECK(text==expect[i]);
+        }
+
+        char level;
+        std::string text;
+
+        bool split=SplitLine(lines[expect.size()  ],level,text);
+        CHECK(split&&level=='W'&&text=="w");
+        split=SplitLine(lines[expect.size()+1],level,text);
+        CHECK(split&&level=='E'&&text=="e");
+        split=SplitLine(lines[expect.size()+2],level,text);
+        CHECK(split&&level=='F'&&text=="f");
+
+        //时间戳非递减
+        for(size_t i=1;i<lines.size();i++)
+            CHECK(lines[i-1].compare(0,26,lines[i],0,26)<=0);
+    }
+
+    void TestLevelAndFlush()
+    {
+        std::cout<<"[TestLevelAndFlush]"<<std::endl;
+
+        //未启动时不写入
+        HGL_LOG_FATAL("not running {}",1);
+
+        LogConfig config;
+
+        config.level=LogLevel::Warning;
+        config.source_location=true;
+
+        LogSession session(config);
+
+        CHECK(AsyncLog::GetLevel()==LogLevel::Warning);
+
+        HGL_LOG_INFO("hidden");
+        HGL_LOG_WARNING("shown {}",1);                  const int line1=__LINE__;
+
+        AsyncLog::Flush();
+
+        std::vector<std::string> lines=session.ReadLines();         //Flush之后不停止也能读到
+
+        CHECK(lines.size()==1);
+        CHECK(lines[0].ends_with("shown 1 ("+std::string(__FILE__)+":"+std::to_string(line1)+")"));
+
+        AsyncLog::SetLevel(LogLevel::Trace);
+
+        HGL_LOG_TRACE("trace");
+        HGL_LOG_DEBUG("debug");
+
+        AsyncLog::SetLevel(LogLevel::Off);
+
+        HGL_LOG_FATAL("off");
+
+        lines=session.StopAndRead();
+
+        CHECK(lines.size()==3);
+        CHECK(lines[1].find(" T [")==26&&lines[1].find("trace (")!=std::string::npos);
+        CHECK(lines[2].find(" D [")==26);
+
+        HGL_LOG_FATAL("stopped");                       //停止后的调用被忽略
+    }
+
+    void TestMultiThread()
+    {
+        std::cout<<"[TestMultiThread]"<<std::endl;
+
+        constexpr int THREADS=4;
+        constexpr int N=20000;
+
+        LogConfig config;
+
+        config.thread_buffer_size=4096;
+        config.overflow=LogOverflowPolicy::Block;
+
+        LogSession session(config);
+
+        const uint64 written=AsyncLog::GetWrittenCount();
+
+        //两轮，第二轮的线程是新线程，第一轮的缓冲区应已回收
+        for(int round=0;round<2;round++)
+        {
+            std::vector<std::thread> threads;
+
+            for(int t=0;t<THREADS;t++)
+                threads.emplace_back([t,round]
+                {
+                    for(int i=0;i<N;i++)
+                        HGL_LOG_INFO("r={} t={} i={} pad={}",round,t,i,"0123456789abcdef");
+                });
+
+            for(auto &th:threads)
+                th.join();
+        }
+
+        const std::vector<std::string> texts=Texts(session.StopAndRead());
+
+        CHECK(texts.size()==size_t(2*THREADS*N));
+        CHECK(AsyncLog::GetWrittenCount()-written==texts.size());
+        CHECK(AsyncLog::GetDroppedCount()==0);
+
+        int next[2][THREADS]={};
+
+        for(const std::string &text:texts)
+        {
+            int r,t,i;
+
+            const int fields=sscanf(text.c_str(),"r=%d t=%d i=%d",&r,&t,&i);
+            CHECK(fields==3);
+            CHECK(i==next[r][t]);                                  //同一线程内保持顺序
+
+            ++next[r][t];
+        }
+    }
+
+    void TestDrop()
+    {
+        std::cout<<"[TestDrop]"<<std::endl;
+
+        constexpr int N=200000;
+
+        LogConfig config;
+
+        config.thread_buffer_size=4096;
+        config.overflow=LogOverflowPolicy::Drop;
+
+        LogSession session(config);
+
+        const uint64 written=AsyncLog::GetWrittenCount();
+        const uint64 dropped=AsyncLog::GetDroppedCount();
+
+        std::thread producer([]
+        {
+            for(int i=0;i<N;i++)
+                HGL_LOG_INFO("i={}",i);
+        });
+
+        producer.join();
+
+        const std::vector<std::string> lines=session.StopAndRead();
+
+        const uint64 w=AsyncLog::GetWrittenCount()-written;
+        const uint64 d=AsyncLog::GetDroppedCount()-dropped;
+
+        CHECK(w+d==N);
+
+        //正文行按顺序（有丢弃时跳号），丢弃数由后台线程输出
+        uint64 reported=0;
+        uint64 records=0;
+        int last=-1;
+
+        for(const std::string &line:lines)
+        {
+            char level;
+            std::string text;
+
+            const bool split=SplitLine(line,level,text);
+            CHECK(split);
+
+            unsigned long long n;
+            int i;
+
+            if(level=='W'&&sscanf(text.c_str(),"%llu log records dropped",&n)==1)
+                reported+=n;
+            else
+            {
+                const int fields=sscanf(text.c_str(),"i=%d",&i);
+                CHECK(level=='I'&&fields==1);
+                CHECK(i>last);
+
+                last=i;
+                ++records;
+            }
+        }
+
+        CHECK(records==w);
+        CHECK(reported==d);
+
+        std::cout<<"  written "<<w<<" dropped "<<d<<std::endl;
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestByteRing();
+    TestFormat();
+    TestLevelAndFlush();
+    TestMultiThread();
+    TestDrop();
+
+    std::cout<<"[AsyncLogTest] All tests passed"<<std::endl;
+
+    return 0;
+}
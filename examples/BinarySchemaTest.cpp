@@ -0,0 +1,324 @@
+﻿/**
+ * BinarySchema 测试
+ *
+ * 与手写ByteSpanWriter/Reader代码的编解码速度对比见 benchmark/BinarySchemaBench.cpp
+ */
+
+#include<hgl/type/BinarySchema.h>
+#include<iostream>
+#include<vector>
+#include<string>
+#include<random>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace game
+{
+    enum class LodMode:uint8
+    {
+        Auto=0,
+        Fixed,
+        Dither
+    };
+
+    struct Transform                                                    //无Schema，整体按内存存储
+    {
+        float position[3];
+        float rotation[4];
+        float scale[3];
+
+        bool operator==(const Transform &)const=default;
+    };
+
+    struct MeshRecord
+    {
+        uint32      id=0;
+        uint16      flags=0;
+        LodMode     lod=LodMode::Auto;
+        uint8       pad=0;
+        float       bounds[6]={};
+        Transform   transform={};
+        bool        visible=true;
+        int32       layer=0;
+        std::string name;
+        std::vector<float>  weights;
+        std::vector<uint32> indices;
+
+        bool operator==(const MeshRecord &)const=default;
+    };
+
+    //id..transform 在内存中连续，整段memcpy
+    HGL_SCHEMA(MeshRecord,1,
+        HGL_SCHEMA_FIELD(id,1),
+        HGL_SCHEMA_FIELD(flags,2),
+        HGL_SCHEMA_FIELD(lod,3),
+        HGL_SCHEMA_FIELD(pad,4),
+        HGL_SCHEMA_FIELD(bounds,5),
+        HGL_SCHEMA_FIELD(transform,6),
+        HGL_SCHEMA_FIELD(visible,7),
+        HGL_SCHEMA_FIELD(layer,8),
+        HGL_SCHEMA_FIELD(name,9),
+        HGL_SCHEMA_FIELD(weights,10),
+        HGL_SCHEMA_FIELD(indices,11))
+
+    struct Scene
+    {
+        std::string             title;
+        std::vector<MeshRecord> meshes;
+        std::vector<std::string>tags;
+
+        bool operator==(const Scene &)const=default;
+    };
+
+    HGL_SCHEMA(Scene,1,
+        HGL_SCHEMA_FIELD(title,1),
+        HGL_SCHEMA_FIELD(meshes,2),
+        HGL_SCHEMA_FIELD(tags,3))
+
+    //同一结构的两个版本
+    struct ConfigV1
+    {
+        uint32 width=0;
+        uint32 height=0;
+        std::string title;
+    };
+
+    HGL_SCHEMA(ConfigV1,1,
+        HGL_SCHEMA_FIELD(width,1),
+        HGL_SCHEMA_FIELD(height,2),
+        HGL_SCHEMA_FIELD(title,3))
+
+    struct ConfigV2
+    {
+        uint32 width=0;
+        uint32 height=0;
+        std::string title;
+        int64 seed=-1;
+        std::vector<std::string> plugins;
+    };
+
+    HGL_SCHEMA(ConfigV2,2,
+        HGL_SCHEMA_FIELD(width,1),
+        HGL_SCHEMA_FIELD(height,2),
+        HGL_SCHEMA_FIELD(title,3),
+        HGL_SCHEMA_FIELD_SINCE(seed,4,2),
+        HGL_SCHEMA_FIELD_SINCE(plugins,5,2))
+
+    struct MeshHolder
+    {
+        std::vector<std::vector<uint16>> groups;                        //仅Packed格式支持嵌套数组
+        std::vector<Transform> transforms;
+    };
+
+    HGL_SCHEMA(MeshHolder,1,
+        HGL_SCHEMA_FIELD(groups,1),
+        HGL_SCHEMA_FIELD(transforms,2))
+}//namespace game
+
+using namespace game;
+
+namespace
+{
+    MeshRecord MakeMesh(std::mt19937 &rng,uint32 id)
+    {
+        MeshRecord m;
+
+        m.id=id;
+        m.flags=uint16(rng());
+        m.lod=LodMode(rng()%3);
+        for(float &b:m.bounds)b=float(rng()%1000)*0.5f;
+        for(int i=0;i<3;i++){m.transform.position[i]=float(i);m.transform.scale[i]=1.0f;}
+        m.transform.rotation[3]=1.0f;
+        m.visible=(rng()&1);
+        m.layer=int32(rng()%64)-32;
+        m.name="mesh_"+std::to_string(id);
+        m.weights.resize(rng()%8);
+        for(float &w:m.weights)w=float(rng()%100)/100.0f;
+        m.indices.resize(rng()%64);
+        for(uint32 &i:m.indices)i=rng()%4096;
+
+        return m;
+    }
+
+    void TestRoundTrip()
+    {
+        std::cout<<"[TestRoundTrip]"<<std::endl;
+
+        std::mt19937 rng(7);
+
+        Scene scene;
+        scene.title="test scene";
+        for(uint32 i=0;i<100;i++)
+            scene.meshes.push_back(MakeMesh(rng,i));
+        scene.tags={"outdoor","","night"};
+
+        //Packed
+        {
+            std::vector<uint8> buf;
+            bool ok=SchemaEncode(scene,buf);
+            CHECK(ok);
+            CHECK(buf.size()==SchemaSize(scene));
+
+            Scene out;
+            ByteSpanReader r(buf);
+            ok=SchemaRead(r,out);
+            CHECK(ok);
+            CHECK(r.eof());
+            CHECK(out==scene);
+
+            //截断的数据必须失败
+            for(size_t cut:{size_t(0),size_t(3),buf.size()/2,buf.size()-1})
+            {
+                Scene bad;
+                ByteSpanReader br(buf.data(),cut);
+                ok=SchemaRead(br,bad);
+                CHECK(!ok);
+            }
+        }
+
+        //Tagged
+        {
+            std::vector<uint8> buf;
+            bool ok=SchemaEncodeTagged(scene,buf);
+            CHECK(ok);
+            CHECK(buf.size()==SchemaTaggedSize(scene));
+
+            Scene out;
+            ByteSpanReader r(buf);
+            ok=SchemaReadTagged(r,out);
+            CHECK(ok);
+            CHECK(out==scene);
+        }
+
+        //ChunkedByteWriter输出，回填正文长度
+        {
+            std::vector<uint8> buf;
+            MemoryByteSink sink(buf);
+
+            {
+                ChunkedByteWriterConfig config;
+                config.block_size=512;
+                ChunkedByteWriter w(&sink,config);
+
+                bool ok=SchemaWrite(w,scene);
+                CHECK(ok);
+                ok=SchemaWriteTagged(w,scene.meshes[3]);
+                CHECK(ok);
+                ok=w.Finish();
+                CHECK(ok);
+            }
+
+            std::vector<uint8> expect;
+            SchemaEncode(scene,expect);
+            SchemaEncodeTagged(scene.meshes[3],expect);
+            CHECK(buf==expect);
+        }
+
+        //嵌套数组与Raw数组
+        {
+            MeshHolder h;
+            h.groups={{1,2,3},{},{7}};
+            h.transforms.resize(2);
+            h.transforms[1].scale[2]=4.0f;
+
+            std::vector<uint8> buf;
+            bool ok=SchemaEncode(h,buf);
+            CHECK(ok);
+
+            MeshHolder out;
+            ByteSpanReader r(buf);
+            ok=SchemaRead(r,out);
+            CHECK(ok);
+            CHECK(out.groups==h.groups);
+            CHECK(out.transforms==h.transforms);
+        }
+    }
+
+    void TestVersioning()
+    {
+        std::cout<<"[TestVersioning]"<<std::endl;
+
+        ConfigV2 v2;
+        v2.width=1920;
+        v2.height=1080;
+        v2.title="main";
+        v2.seed=42;
+        v2.plugins={"audio","net"};
+
+        ConfigV1 v1;
+        v1.width=640;
+        v1.height=480;
+        v1.title="old";
+
+        //Packed：旧程序读新数据，跳过尾部新字段
+        {
+            std::vector<uint8> buf;
+            SchemaEncode(v2,buf);
+            buf.push_back(0xEE);                                        //后续数据
+
+            ConfigV1 out;
+            ByteSpanReader r(buf);
+            bool ok=SchemaRead(r,out);
+            CHECK(ok);
+            CHECK(out.width==1920&&out.height==1080&&out.title=="main");
+
+            uint8 next;
+            ok=r.u8(next);
+            CHECK(ok&&next==0xEE);
+        }
+
+        //Packed：新程序读旧数据，新字段保持默认值
+        {
+            std::vector<uint8> buf;
+            SchemaEncode(v1,buf);
+
+            ConfigV2 out;
+            ByteSpanReader r(buf);
+            bool ok=SchemaRead(r,out);
+            CHECK(ok);
+            CHECK(out.width==640&&out.title=="old");
+            CHECK(out.seed==-1&&out.plugins.empty());
+        }
+
+        //Tagged：双向
+        {
+            std::vector<uint8> buf;
+            SchemaEncodeTagged(v2,buf);
+
+            ConfigV1 out;
+            ByteSpanReader r(buf);
+            bool ok=SchemaReadTagged(r,out);
+            CHECK(ok);
+            CHECK(out.width==1920&&out.title=="main");
+
+            buf.clear();
+            SchemaEncodeTagged(v1,buf);
+
+            ConfigV2 out2;
+            ByteSpanReader r2(buf);
+            ok=SchemaReadTagged(r2,out2);
+            CHECK(ok);
+            CHECK(out2.height==480&&out2.seed==-1);
+        }
+
+        //版本号为0的数据无效
+        {
+            const uint8 bad[]={0,0,0,0,0};
+            ConfigV1 out;
+            ByteSpanReader r(bad,sizeof(bad));
+            bool ok=SchemaRead(r,out);
+            CHECK(!ok);
+        }
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestRoundTrip();
+    TestVersioning();
+
+    std::cout<<"[BinarySchemaTest] All tests passed"<<std::endl;
+    return 0;
+}
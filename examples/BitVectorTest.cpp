@@ -0,0 +1,256 @@
+﻿/**
+ * 位向量测试
+ *
+ * 1.单个位读写、区间设置、Resize 与 std::vector<bool> 一致
+ * 2.And/Or/Xor/AndNot/Not/Count（各指令集档次实现结果一致）
+ * 3.Count/FindNext/ForEachSetBit
+ * 4.Rank/Select 与逐位计算结果一致
+ *
+ * 批量运算、位计数、遍历与rank/select的性能见 benchmark/BitVectorBench.cpp
+ */
+
+#include<hgl/type/BitVector.h>
+#include<iostream>
+#include<vector>
+#include<random>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    void RandomFill(BitVector &bv,std::vector<bool> &ref,std::mt19937_64 &rng,const uint32 density)
+    {
+        for(size_t i=0;i<bv.GetCount();i++)
+        {
+            const bool v=(rng()%100)<density;
+            bv.Set(i,v);
+            ref[i]=v;
+        }
+    }
+
+    bool Same(const BitVector &bv,const std::vector<bool> &ref)
+    {
+        if(bv.GetCount()!=ref.size())return false;
+
+        for(size_t i=0;i<ref.size();i++)
+            if(bv.Get(i)!=ref[i])return false;
+
+        return true;
+    }
+
+    void TestBasic()
+    {
+        std::cout<<"[TestBasic]"<<std::endl;
+
+        std::mt19937_64 rng(1);
+
+        for(size_t n:{0,1,63,64,65,511,512,513,1000,4099})
+        {
+            BitVector bv(n);
+            std::vector<bool> ref(n,false);
+
+            CHECK(bv.None());
+            CHECK(bv.FindFirst()==-1);
+
+            RandomFill(bv,ref,rng,30);
+            CHECK(Same(bv,ref));
+
+            for(int r=0;r<50&&n;r++)
+            {
+                size_t a=rng()%(n+1),b=rng()%(n+1);
+                if(a>b)std::swap(a,b);
+
+                const bool v=rng()&1;
+                bv.SetRange(a,b,v);
+                for(size_t i=a;i<b;i++)ref[i]=v;
+
+                const size_t f=rng()%n;
+                bv.Flip(f);
+                ref[f]=!ref[f];
+            }
+            CHECK(Same(bv,ref));
+
+            //Resize 新增的位
+            bv.Resize(n+70,true);
+            ref.resize(n+70,true);
+            CHECK(Same(bv,ref));
+
+            bv.Resize(n/2);
+            ref.resize(n/2);
+            CHECK(Same(bv,ref));
+
+            bv.Resize(n+5);
+            ref.resize(n+5,false);
+            CHECK(Same(bv,ref));
+
+            bv.Not();
+            ref.flip();
+            CHECK(Same(bv,ref));
+
+            //尾部位保持为0
+            bv.SetAll(true);
+            CHECK(bv.Count()==n+5);
+        }
+    }
+
+    void TestBulk()
+    {
+        std::cout<<"[TestBulk]"<<std::endl;
+
+        using namespace bit_vector_detail;
+
+        std::mt19937_64 rng(2);
+
+        for(size_t n:{1,100,640,1000,4097,100003})
+        {
+            BitVector a(n),b(n);
+            std::vector<bool> ra(n),rb(n);
+
+            RandomFill(a,ra,rng,50);
+            RandomFill(b,rb,rng,40);
+
+            BitVector x=a;  x.And(b);
+            BitVector y=a;  y.Or(b);
+            BitVector z=a;  z^=b;
+            BitVector w=a;  w.AndNot(b);
+
+            for(size_t i=0;i<n;i++)
+            {
+                CHECK(x.Get(i)==(ra[i]&&rb[i]));
+                CHECK(y.Get(i)==(ra[i]||rb[i]));
+                CHECK(z.Get(i)==(ra[i]!=rb[i]));
+                CHECK(w.Get(i)==(ra[i]&&!rb[i]));
+            }
+
+            //直接调用标量实现核对
+            std::vector<uint64> s(a.GetData(),a.GetData()+a.GetWordCount());
+            BulkScalar<BitOp::Xor>(s.data(),b.GetData(),s.size());
+            CHECK(std::equal(s.begin(),s.end(),z.GetData()));
+
+            CHECK(PopCountScalar(a.GetData(),a.GetWordCount())==a.Count());
+
+            //逐一核对当前CPU支持的各档次实现
+            for(int t=0;t<=int(GetCpuTier());t++)
+            {
+                std::vector<uint64> v(a.GetData(),a.GetData()+a.GetWordCount());
+                BulkOp(BitOp::AndNot,v.data(),b.GetData(),v.size(),CpuTier(t));
+                CHECK(std::equal(v.begin(),v.end(),w.GetData()));
+
+                CHECK(PopCount(a.GetData(),a.GetWordCount(),CpuTier(t))==a.Count());
+            }
+
+            //长度不同时不做修改
+            BitVector c(n+1);
+            const bool changed=x.Or(c);
+            CHECK(!changed);
+            CHECK(x==(BitVector(a)&=b));
+        }
+    }
+
+    void TestCountFind()
+    {
+        std::cout<<"[TestCountFind]"<<std::endl;
+
+        std::mt19937_64 rng(3);
+
+        for(uint32 density:{0,1,10,50,99,100})
+        {
+            const size_t n=5000+rng()%200;
+
+            BitVector bv(n);
+            std::vector<bool> ref(n);
+            RandomFill(bv,ref,rng,density);
+
+            for(int r=0;r<200;r++)
+            {
+                size_t a=rng()%(n+1),b=rng()%(n+1);
+                if(a>b)std::swap(a,b);
+
+                uint64 expect=0;
+                for(size_t i=a;i<b;i++)expect+=ref[i];
+
+                CHECK(bv.Count(a,b)==expect);
+            }
+
+            std::vector<size_t> expect_bits;
+            for(size_t i=0;i<n;i++)
+                if(ref[i])expect_bits.push_back(i);
+
+            std::vector<size_t> bits;
+            const size_t bit_count=bv.GetSetBits(bits);
+            CHECK(bit_count==expect_bits.size());
+            CHECK(bits==expect_bits);
+
+            //FindNext 逐个遍历
+            size_t k=0;
+            for(int64 p=bv.FindFirst();p>=0;p=bv.FindNext(size_t(p)+1))
+                CHECK(size_t(p)==expect_bits[k++]);
+            CHECK(k==expect_bits.size());
+
+            CHECK(bv.Any()==!expect_bits.empty());
+        }
+    }
+
+    void TestRankSelect()
+    {
+        std::cout<<"[TestRankSelect]"<<std::endl;
+
+        std::mt19937_64 rng(4);
+
+        for(uint32 density:{0,1,3,50,97,100})
+        for(size_t n:{1,64,511,512,513,20000,100001})
+        {
+            BitVector bv(n);
+            std::vector<bool> ref(n);
+            RandomFill(bv,ref,rng,density);
+
+            CHECK(bv.Rank1(0)==-1);                //尚未建立索引
+
+            bv.BuildRankIndex();
+            CHECK(bv.IsRankIndexValid());
+
+            std::vector<size_t> ones,zeros;
+            int64 rank=0;
+
+            for(size_t i=0;i<=n;i++)
+            {
+                CHECK(bv.Rank1(i)==rank);
+                CHECK(bv.Rank0(i)==int64(i)-rank);
+
+                if(i<n)
+                {
+                    if(ref[i]){ones.push_back(i);++rank;}
+                    else zeros.push_back(i);
+                }
+            }
+
+            for(size_t k=0;k<ones.size();k++)
+                CHECK(bv.Select1(k)==int64(ones[k]));
+
+            for(size_t k=0;k<zeros.size();k++)
+                CHECK(bv.Select0(k)==int64(zeros[k]));
+
+            CHECK(bv.Select1(ones.size())==-1);
+            CHECK(bv.Select0(zeros.size())==-1);
+
+            //修改后索引失效
+            bv.Flip(0);
+            CHECK(!bv.IsRankIndexValid());
+            CHECK(bv.Select1(0)==-1);
+        }
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestBasic();
+    TestBulk();
+    TestCountFind();
+    TestRankSelect();
+
+    std::cout<<"[BitVectorTest] All tests passed"<<std::endl;
+
+    return 0;
+}
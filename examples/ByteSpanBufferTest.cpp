@@ -0,0 +1,216 @@
+﻿/**
+ * ByteSpanReader / ByteSpanWriter 测试
+ *
+ * 性能对比见 benchmark/ByteSpanBufferBench.cpp
+ */
+
+#include<hgl/type/ByteSpanBuffer.h>
+#include<hgl/type/StdByteBuffer.h>
+#include<iostream>
+#include<vector>
+#include<string>
+#include<limits>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    void TestFixedValues()
+    {
+        std::cout<<"[TestFixedValues]"<<std::endl;
+
+        uint8 buffer[64];
+        ByteSpanWriter w(buffer,sizeof(buffer));
+
+        bool ok=w.u8(0xAB);
+        ok&=w.u16(0x1234);
+        ok&=w.u32(0xDEADBEEF);
+        ok&=w.u64(0x0102030405060708ull);
+        ok&=w.i32(-5);
+        ok&=w.f32(1.5f);
+        ok&=w.f64(-2.25);
+        CHECK(ok);
+        CHECK(w.tell()==1+2+4+8+4+4+8);
+
+        //与 ByteWriter 的u32编码一致（小端）
+        CHECK(buffer[3]==0xEF&&buffer[6]==0xDE);
+
+        ByteSpanReader r(w.written());
+
+        uint8 a;uint16 b;uint32 c;uint64 d;int32 e;float f;double g;
+        ok=r.u8(a);
+        ok&=r.u16(b);
+        ok&=r.u32(c);
+        ok&=r.u64(d);
+        ok&=r.i32(e);
+        ok&=r.f32(f);
+        ok&=r.f64(g);
+        CHECK(ok);
+        CHECK(a==0xAB&&b==0x1234&&c==0xDEADBEEF&&d==0x0102030405060708ull);
+        CHECK(e==-5&&f==1.5f&&g==-2.25);
+        CHECK(r.eof());
+        ok=r.u8(a);
+        CHECK(!ok);
+
+        //空间不足时不写入
+        ByteSpanWriter small(buffer,3);
+        ok=small.u16(1);
+        CHECK(ok);
+        ok=small.u32(1);
+        CHECK(!ok);
+        CHECK(small.tell()==2);
+
+        //与 ByteReader 互通
+        std::vector<uint8_t> vec;
+        ByteWriter bw(vec);
+        bw.u32(0xCAFEBABE);
+        bw.i32(-100);
+
+        ByteSpanReader vr(vec);
+        ok=vr.u32(c);
+        ok&=vr.i32(e);
+        CHECK(ok&&c==0xCAFEBABE&&e==-100);
+    }
+
+    void TestVarint()
+    {
+        std::cout<<"[TestVarint]"<<std::endl;
+
+        CHECK(zigzag_encode(int32(0))==0);
+        CHECK(zigzag_encode(int32(-1))==1);
+        CHECK(zigzag_encode(int32(1))==2);
+        CHECK(zigzag_decode(zigzag_encode(std::numeric_limits<int64>::min()))==std::numeric_limits<int64>::min());
+
+        const uint64 u_values[]={0,1,127,128,255,16383,16384,0xFFFFFFFFull,0x100000000ull,~0ull};
+        const int64  i_values[]={0,-1,1,-64,64,std::numeric_limits<int64>::min(),std::numeric_limits<int64>::max()};
+
+        std::vector<uint8> buffer(256);
+        ByteSpanWriter w(buffer.data(),buffer.size());
+
+        bool ok=true;
+
+        for(uint64 v:u_values)ok&=w.varu64(v);
+        for(int64 v:i_values)ok&=w.vari64(v);
+        ok&=w.varu32(300);
+        ok&=w.vari32(-300);
+        CHECK(ok);
+
+        ByteSpanReader r(buffer.data(),w.tell());
+
+        for(uint64 v:u_values){uint64 x=0;ok=r.varu64(x);CHECK(ok&&x==v);}
+        for(int64 v:i_values){int64 x=0;ok=r.vari64(x);CHECK(ok&&x==v);}
+        {uint32 x=0;ok=r.varu32(x);CHECK(ok&&x==300);}
+        {int32 x=0;ok=r.vari32(x);CHECK(ok&&x==-300);}
+        CHECK(r.eof());
+
+        CHECK(varint_size(127)==1);
+        CHECK(varint_size(128)==2);
+        CHECK(varint_size(~0ull)==VARINT64_MAX_BYTES);
+
+        //截断的varint：慢速路径必须失败且不移动位置
+        const uint8 truncated[]={0x80,0x80};
+        ByteSpanReader tr(truncated,sizeof(truncated));
+        uint64 x;
+        ok=tr.varu64(x);
+        CHECK(!ok);
+        CHECK(tr.tell()==0);
+
+        //第10字节只能携带第63位，更高的位不能被静默丢弃
+        {
+            uint8 overlong[10]={0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0x01};
+
+            ByteSpanReader max_reader(overlong,sizeof(overlong));
+            ok=max_reader.varu64(x);
+            CHECK(ok&&x==~0ull);
+
+            overlong[9]=0x02;
+
+            ByteSpanReader bad_reader(overlong,sizeof(overlong));
+            ok=bad_reader.varu64(x);
+            CHECK(!ok&&bad_reader.tell()==0);
+        }
+
+        //varu32拒绝超出32位的值
+        uint8 big[16];
+        ByteSpanWriter bw(big,sizeof(big));
+        bw.varu64(0x100000000ull);
+        ByteSpanReader br(big,bw.tell());
+        uint32 y;
+        ok=br.varu32(y);
+        CHECK(!ok);
+
+        //剩余空间不足10字节时的写入
+        uint8 tiny[2];
+        ByteSpanWriter tw(tiny,sizeof(tiny));
+        ok=tw.varu64(300);
+        CHECK(ok);
+        ok=tw.varu64(1);
+        CHECK(!ok);
+    }
+
+    void TestBulkAndString()
+    {
+        std::cout<<"[TestBulkAndString]"<<std::endl;
+
+        std::vector<float> src(1000);
+        for(size_t i=0;i<src.size();i++)src[i]=float(i)*0.5f;
+
+        std::string long_str(70000,'x');
+        long_str[0]='A';
+        long_str.back()='Z';
+
+        std::vector<uint8> buffer(src.size()*sizeof(float)+long_str.size()+64);
+        ByteSpanWriter w(buffer.data(),buffer.size());
+
+        bool ok=w.array(src.data(),src.size());
+        ok&=w.string(long_str);
+        ok&=w.string("");
+        CHECK(ok);
+
+        ByteSpanReader r(buffer.data(),w.tell());
+
+        std::vector<float> dst;
+        ok=r.array(dst,src.size());
+        CHECK(ok&&dst==src);
+
+        std::string_view sv;
+        ok=r.string_view(sv);
+        CHECK(ok);
+        CHECK(sv.size()==70000&&sv.front()=='A'&&sv.back()=='Z');
+        CHECK(sv.data()==reinterpret_cast<const char *>(buffer.data())+src.size()*sizeof(float)+varint_size(70000));
+
+        std::string empty="not empty";
+        ok=r.string(empty);
+        CHECK(ok&&empty.empty());
+        CHECK(r.eof());
+
+        //声明长度超出剩余数据
+        uint8 bad[8];
+        ByteSpanWriter bw(bad,sizeof(bad));
+        bw.varu64(100);
+        ByteSpanReader br(bad,bw.tell());
+        ok=br.string(empty);
+        CHECK(!ok);
+        CHECK(br.tell()==0);
+
+        //非检查版：一次require后连续读取
+        ByteSpanReader ur(buffer.data(),w.tell());
+        CHECK(ur.require(3*sizeof(float)));
+        const float f0=ur.f32_unchecked();
+        const float f1=ur.f32_unchecked();
+        const float f2=ur.f32_unchecked();
+        CHECK(f0==0.0f&&f1==0.5f&&f2==1.0f);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestFixedValues();
+    TestVarint();
+    TestBulkAndString();
+
+    std::cout<<"[ByteSpanBufferTest] All tests passed"<<std::endl;
+    return 0;
+}
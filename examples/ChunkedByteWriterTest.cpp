@@ -0,0 +1,297 @@
+﻿/**
+ * ChunkedByteWriter 测试
+ *
+ * 与 ByteWriter(vector)+fwrite 的耗时、内存对比见 benchmark/ChunkedByteWriterBench.cpp
+ */
+
+#include<hgl/type/ChunkedByteWriter.h>
+#include<hgl/type/MappedFile.h>
+#include<hgl/type/StdByteBuffer.h>
+#include<iostream>
+#include<vector>
+#include<string>
+#include<thread>
+#include<cstdio>
+#include<fcntl.h>
+#include<unistd.h>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    std::string TempFileName(const char *tag)
+    {
+        return std::string("/tmp/hgl_chunked_writer_")+tag+"_"+std::to_string(getpid())+".bin";
+    }
+
+    ChunkedByteWriterConfig SmallBlocks(size_t max_blocks=64)
+    {
+        ChunkedByteWriterConfig config;
+        config.block_size=256;
+        config.block_align=64;
+        config.flush_blocks=2;
+        config.max_blocks=max_blocks;
+        return config;
+    }
+
+    /**
+     * 以相同顺序写入ByteSpanWriter与ChunkedByteWriter，结果应逐字节一致
+     */
+    template<typename W>
+    void WriteSample(W &w)
+    {
+        for(uint32 i=0;i<2000;i++)
+        {
+            w.u8(uint8(i));
+            w.u16(uint16(i*3));
+            w.u32(i*2654435761u);
+            w.u64(uint64(i)<<40|i);
+            w.f32(float(i)*0.25f);
+            w.f64(-double(i));
+            w.varu64(uint64(i)*uint64(i)*977);
+            w.vari32(-int32(i));
+            w.string(std::string(i%37,char('a'+i%26)));
+        }
+
+        std::vector<uint32> big(5000);
+        for(uint32 i=0;i<big.size();i++)big[i]=i;
+        w.array(big.data(),big.size());                                 //超过块大小，走直接输出路径
+    }
+
+    void TestMatchesSpanWriter()
+    {
+        std::cout<<"[TestMatchesSpanWriter]"<<std::endl;
+
+        std::vector<uint8> expect(1<<20);
+        ByteSpanWriter sw(expect.data(),expect.size());
+        WriteSample(sw);
+        expect.resize(sw.tell());
+
+        std::vector<uint8> out;
+        MemoryByteSink sink(out);
+
+        {
+            ChunkedByteWriter w(&sink,SmallBlocks());
+            WriteSample(w);
+            CHECK(w.tell()==expect.size());
+            const bool finished=w.Finish();
+            CHECK(finished);
+
+            const ChunkedByteWriterStats stats=w.GetStats();
+            CHECK(stats.total_bytes==expect.size());
+            CHECK(stats.flushed_bytes==expect.size());
+            CHECK(stats.direct_bytes==5000*sizeof(uint32));
+            CHECK(stats.peak_pending_blocks<=3);
+            CHECK(stats.allocated_blocks<=3);
+        }
+
+        CHECK(out==expect);
+    }
+
+    /**
+     * 嵌套的长度前缀段，跨越多个数据块
+     */
+    void WriteSections(ChunkedByteWriter &w)
+    {
+        auto outer=w.BeginSection();
+        CHECK(outer.IsValid());
+
+        for(uint32 s=0;s<10;s++)
+        {
+            auto inner=w.BeginSection();
+            auto count=w.Reserve<uint16>();
+
+            const uint32 n=s*50;
+            for(uint32 i=0;i<n;i++)
+                w.u32(s*1000+i);
+
+            bool ok=w.Patch(count,uint16(n));
+            ok&=w.EndSection(inner);
+            CHECK(ok);
+        }
+
+        const bool ended=w.EndSection(outer);
+        CHECK(ended);
+    }
+
+    void VerifySections(const uint8 *data,size_t size)
+    {
+        ByteSpanReader r(data,size);
+
+        uint32 outer_length=0;
+        bool ok=r.u32(outer_length);
+        CHECK(ok&&outer_length==size-4);
+
+        for(uint32 s=0;s<10;s++)
+        {
+            uint32 inner_length=0;
+            uint16 n=0;
+            ok=r.u32(inner_length);
+            ok&=r.u16(n);
+            CHECK(ok&&n==s*50);
+            CHECK(inner_length==2u+n*4u);
+
+            for(uint32 i=0;i<n;i++)
+            {
+                uint32 v=0;
+                ok=r.u32(v);
+                CHECK(ok&&v==s*1000+i);
+            }
+        }
+
+        CHECK(r.eof());
+    }
+
+    void TestBackPatch()
+    {
+        std::cout<<"[TestBackPatch]"<<std::endl;
+
+        //可回写的目标：占位所在块照常输出，稍后通过Patch修改
+        {
+            std::vector<uint8> out;
+            MemoryByteSink sink(out);
+            ChunkedByteWriter w(&sink,SmallBlocks());
+
+            WriteSections(w);
+            CHECK(w.GetStats().peak_pending_blocks<=3);
+            const bool finished=w.Finish();
+            CHECK(finished);
+
+            VerifySections(out.data(),out.size());
+        }
+
+        //不可回写的目标：占位之后的块被保留到回填为止
+        {
+            std::vector<uint8> out;
+            CallbackByteSink sink([&out](const uint8 *data,size_t size)
+            {
+                out.insert(out.end(),data,data+size);
+                return true;
+            });
+
+            ChunkedByteWriter w(&sink,SmallBlocks());
+
+            WriteSections(w);
+            CHECK(out.empty());                                        //外层段未结束，什么都不能输出
+            const bool finished=w.Finish();
+            CHECK(finished);
+
+            VerifySections(out.data(),out.size());
+        }
+
+        //不可回写且超出内存上限
+        {
+            size_t written=0;
+            CallbackByteSink sink([&written](const uint8 *,size_t size){written+=size;return true;});
+            ChunkedByteWriter w(&sink,SmallBlocks(4));
+
+            auto r=w.Reserve<uint32>();
+            CHECK(r.IsValid());
+
+            bool ok=true;
+            for(int i=0;i<1000&&ok;i++)
+                ok=w.u32(i);
+
+            CHECK(!ok&&w.IsFailed());
+            ok=w.u8(1);
+            CHECK(!ok);
+            ok=w.Finish();
+            CHECK(!ok);
+        }
+
+        //未回填就结束
+        {
+            std::vector<uint8> out;
+            MemoryByteSink sink(out);
+            ChunkedByteWriter w(&sink,SmallBlocks());
+
+            w.Reserve<uint32>();
+            w.u32(1);
+            const bool finished=w.Finish();
+            CHECK(!finished);
+            CHECK(out.size()==8);
+        }
+    }
+
+    void TestFdSink()
+    {
+        std::cout<<"[TestFdSink]"<<std::endl;
+
+        //普通文件：writev聚集写出，pwrite回填
+        {
+            const std::string filename=TempFileName("fd");
+            const int fd=open(filename.c_str(),O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC,0644);
+            CHECK(fd>=0);
+
+            {
+                FdByteSink sink(fd,true);
+                CHECK(sink.CanPatch());
+
+                ChunkedByteWriter w(&sink,SmallBlocks());
+                WriteSections(w);
+                const bool finished=w.Finish();
+                CHECK(finished);
+            }
+
+            MappedFile mf;
+            const bool opened=mf.Open(filename.c_str());
+            CHECK(opened);
+            VerifySections(mf.GetData(),mf.GetSize());
+
+            std::remove(filename.c_str());
+        }
+
+        //管道：不可回写，由另一个线程读出
+        {
+            int fds[2];
+            const int result=pipe(fds);
+            CHECK(result==0);
+
+            std::vector<uint8> received;
+            std::thread reader([&]()
+            {
+                uint8 buf[4096];
+                ssize_t n;
+
+                while((n=read(fds[0],buf,sizeof(buf)))>0)
+                    received.insert(received.end(),buf,buf+n);
+
+                close(fds[0]);
+            });
+
+            {
+                FdByteSink sink(fds[1],true);
+                CHECK(!sink.CanPatch());
+
+                ChunkedByteWriter w(&sink,SmallBlocks());
+                WriteSections(w);
+                const bool finished=w.Finish();
+                CHECK(finished);
+            }
+
+            reader.join();
+            VerifySections(received.data(),received.size());
+        }
+
+        //无效描述符
+        {
+            FdByteSink sink(-1);
+            ChunkedByteWriter w(&sink,SmallBlocks());
+            w.u32(1);
+            const bool finished=w.Finish();
+            CHECK(!finished);
+        }
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestMatchesSpanWriter();
+    TestBackPatch();
+    TestFdSink();
+
+    std::cout<<"[ChunkedByteWriterTest] All tests passed"<<std::endl;
+    return 0;
+}
@@ -0,0 +1,166 @@
+﻿/**
+ * 压缩有序整数数组测试
+ *
+ * 1.各种分布（密集、稀疏、超大间隔、重复、等差、负数）下 Find/Get/Decode 与原数组一致
+ * 2.查找结果与 FindDataPositionInSortedArray 一致
+ * 3.加 --large 参数时测试压缩数据超过4GB（块偏移超出32位）的情况，需要约12GB内存
+ *
+ * 占用内存与查找延迟的对比见 benchmark/CompressedSortedArrayBench.cpp
+ */
+
+#include<hgl/type/CompressedSortedArray.h>
+#include<hgl/type/ArrayItemProcess.h>
+#include<iostream>
+#include<vector>
+#include<random>
+#include<algorithm>
+#include<cstring>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    template<typename T>
+    std::vector<T> MakeSorted(std::mt19937_64 &rng,const size_t n,const T start,const uint64 max_gap)
+    {
+        std::vector<T> v(n);
+        T cur=start;
+
+        for(size_t i=0;i<n;i++)
+        {
+            v[i]=cur;
+            cur=T(cur+T(max_gap?rng()%(max_gap+1):0));
+        }
+
+        return v;
+    }
+
+    template<typename T>
+    void Check(const std::vector<T> &values,std::mt19937_64 &rng)
+    {
+        const int64 n=int64(values.size());
+
+        CompressedSortedArray<T> csa;
+        bool ok=csa.Build(values.data(),n);
+        CHECK(ok);
+        CHECK(csa.GetCount()==n);
+
+        std::vector<T> decoded(values.size());
+        csa.Decode(decoded.data());
+        CHECK(decoded==values);
+
+        for(int64 i=0;i<n;i++)
+        {
+            CHECK(csa.Get(i)==values[i]);
+
+            const int64 pos=csa.Find(values[i]);
+            CHECK(pos>=0&&values[pos]==values[i]);
+        }
+
+        //不存在的值，包括两端之外
+        for(int r=0;r<2000;r++)
+        {
+            const T probe=T(values[rng()%n]+T(int64(rng()%7)-3));
+            const int64 expect=FindDataPositionInSortedArray(values.data(),n,probe);
+            const int64 pos=csa.Find(probe);
+
+            CHECK((expect<0)==(pos<0));
+            if(pos>=0)CHECK(values[pos]==probe);
+        }
+    }
+
+    void TestDistribution()
+    {
+        std::cout<<"[TestDistribution]"<<std::endl;
+
+        std::mt19937_64 rng(1);
+
+        for(size_t n:{1,2,127,128,129,1000,5000})
+        {
+            Check(MakeSorted<int64>(rng,n,0,1),rng);                    //重复很多
+            Check(MakeSorted<int64>(rng,n,-5000,10),rng);               //密集，含负数
+            Check(MakeSorted<int64>(rng,n,1000000,100000),rng);
+            Check(MakeSorted<int64>(rng,n,-(int64(1)<<62),int64(1)<<50),rng);   //超过56位的差值，原样存储
+            Check(MakeSorted<int64>(rng,n,7,0),rng);                    //全部相同
+
+            std::vector<int64> step(n);                                 //等差
+            for(size_t i=0;i<n;i++)step[i]=int64(i)*37-100;
+            Check(step,rng);
+
+            Check(MakeSorted<uint32>(rng,n,0,5000),rng);
+            Check(MakeSorted<int32>(rng,n,-100000,50),rng);
+            Check(MakeSorted<uint64>(rng,n,~uint64(0)-n*3,2),rng);     //接近上限
+        }
+
+        //混合位宽：一部分块密集，一部分块稀疏
+        std::vector<int64> mixed;
+        int64 cur=0;
+        for(int i=0;i<3000;i++)
+        {
+            mixed.push_back(cur);
+            cur+=((i/128)&1)?int64(rng()%(uint64(1)<<30)):int64(rng()%4);
+        }
+        Check(mixed,rng);
+
+        //无序或空数据
+        CompressedSortedArray<int64> csa;
+        const int64 unsorted[]={1,3,2};
+        bool ok=csa.Build(unsorted,3);
+        CHECK(!ok);
+        ok=csa.Build(nullptr,0);
+        CHECK(!ok);
+        CHECK(csa.GetCount()==0&&csa.Find(1)==-1);
+    }
+
+    /**
+     * 压缩数据超过4GB：块内差值交替为0与2^35，每值占36位
+     */
+    void TestLargeOffset()
+    {
+        constexpr uint64 BIG_DELTA=uint64(1)<<35;
+        constexpr size_t BLOCK_COUNT=7600000;                       //每块572字节，共约4.35GB
+        constexpr size_t N=BLOCK_COUNT*CompressedSortedArray<uint64>::BLOCK_SIZE;
+
+        std::vector<uint64> values(N);
+        uint64 cur=0;
+
+        for(size_t i=0;i<N;i++)
+        {
+            values[i]=cur;
+            cur+=(i&1)?BIG_DELTA:0;
+        }
+
+        CompressedSortedArray<uint64> csa;
+        const bool ok=csa.Build(values.data(),int64(N));
+        CHECK(ok);
+        CHECK(csa.GetBytes()>(uint64(1)<<32));
+
+        std::mt19937_64 rng(7);
+
+        for(int i=0;i<10000;i++)
+        {
+            const size_t index=N-1-size_t(rng()%(N/4));             //集中在偏移超过4GB的尾部
+
+            CHECK(csa.Get(int64(index))==values[index]);
+
+            const int64 pos=csa.Find(values[index]);
+            CHECK(pos>=0&&values[size_t(pos)]==values[index]);
+        }
+
+        std::cout<<"[TestLargeOffset] "<<csa.GetBytes()<<" bytes OK"<<std::endl;
+    }
+}//namespace
+
+int main(int argc,char **argv)
+{
+    TestDistribution();
+
+    if(argc>1&&strcmp(argv[1],"--large")==0)
+        TestLargeOffset();
+
+    std::cout<<"[CompressedSortedArrayTest] All tests passed"<<std::endl;
+
+    return 0;
+}
@@ -0,0 +1,409 @@
+﻿/**
+ * 并发队列测试
+ *
+ * 1.SPSCQueue/MPMCQueue 单线程语义：容量、先进先出、满/空、批量、非平凡类型的析构
+ * 2.多线程：每个值恰好取出一次，每个消费者看到的同一生产者的数据保持顺序
+ * 3.BlockingQueue 超时、阻塞唤醒、批量
+ *
+ * 吞吐量与延迟百分位（对比 std::deque+std::mutex+std::condition_variable）见 benchmark/ConcurrentQueueBench.cpp
+ */
+
+#include<hgl/thread/BlockingQueue.h>
+#include<iostream>
+#include<vector>
+#include<string>
+#include<thread>
+#include<chrono>
+#include<algorithm>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    /**
+     * 统计存活数量的类型，检查队列是否正确构造/析构
+     */
+    struct Tracked
+    {
+        static inline std::atomic<int> alive{0};
+
+        std::string text;
+
+        Tracked(){++alive;}
+        explicit Tracked(int v):text(std::to_string(v)){++alive;}
+        Tracked(const Tracked &t):text(t.text){++alive;}
+        Tracked(Tracked &&t)noexcept:text(std::move(t.text)){++alive;}
+        ~Tracked(){--alive;}
+
+        Tracked &operator=(const Tracked &)=default;
+        Tracked &operator=(Tracked &&)=default;
+    };
+
+    template<typename Q>
+    void TestSingleThread(const char *name)
+    {
+        std::cout<<"[TestSingleThread] "<<name<<std::endl;
+
+        {
+            Q q(5);
+            int v;
+
+            CHECK(q.GetCapacity()==8);
+            bool ok=q.TryPop(v);
+            CHECK(q.IsEmpty()&&!ok);
+
+            for(int i=0;i<8;i++)
+            {
+                ok=q.TryPush(i);
+                CHECK(ok);
+            }
+
+            ok=q.TryPush(100);
+            CHECK(!ok);
+            CHECK(q.GetCount()==8);
+
+            for(int i=0;i<8;i++)
+            {
+                ok=q.TryPop(v);
+                CHECK(ok&&v==i);
+            }
+
+            ok=q.TryPop(v);
+            CHECK(!ok);
+
+            //批量：环绕、部分成功
+            const int src[10]={0,1,2,3,4,5,6,7,8,9};
+            int dst[10]={};
+
+            size_t n=q.PushBatch(src,3);
+            CHECK(n==3);
+            n=q.PopBatch(dst,2);
+            CHECK(n==2&&dst[0]==0&&dst[1]==1);
+            n=q.PushBatch(src+3,10-3);                              //剩余7个空位
+            CHECK(n==7);
+            n=q.PushBatch(src,1);
+            CHECK(n==0);
+
+            //数量为0的批量立即返回（满或非空时都不会卡住）
+            n=q.PushBatch(src,0);
+            CHECK(n==0);
+            n=q.PopBatch(dst,0);
+            CHECK(n==0&&q.GetCount()==8);
+
+            n=q.PopBatch(dst,10);
+            CHECK(n==8);
+
+            for(int i=0;i<8;i++)
+                CHECK(dst[i]==i+2);
+        }
+
+        //非平凡类型：队列销毁时析构剩余元素
+        {
+            using TQ=std::conditional_t<std::is_same_v<Q,SPSCQueue<int>>,SPSCQueue<Tracked>,MPMCQueue<Tracked>>;
+
+            {
+                TQ q(4);
+
+                q.TryEmplace(1);
+                q.TryPush(Tracked(2));
+                q.TryEmplace(3);
+
+                Tracked t;
+                const bool popped=q.TryPop(t);
+                CHECK(popped&&t.text=="1");
+                CHECK(Tracked::alive==3);                          //t+2个在队列中
+            }
+
+            CHECK(Tracked::alive==0);
+        }
+    }
+
+    void TestSPSCThreaded()
+    {
+        std::cout<<"[TestSPSCThreaded]"<<std::endl;
+
+        constexpr uint64 COUNT=1000000;
+
+        SPSCQueue<uint64> q(256);
+
+        std::thread producer([&]
+        {
+            uint64 buf[16];
+            uint64 next=0;
+
+            while(next<COUNT)
+            {
+                if(next%3==0)                                       //混合单个与批量
+                {
+                    if(q.TryPush(next))
+                        ++next;
+                    else
+                        std::this_thread::yield();
+
+                    continue;
+                }
+
+                const size_t n=size_t(std::min<uint64>(16,COUNT-next));
+
+                for(size_t i=0;i<n;i++)
+                    buf[i]=next+i;
+
+                const size_t pushed=q.PushBatch(buf,n);
+
+                if(!pushed)
+                    std::this_thread::yield();
+
+                next+=pushed;
+            }
+        });
+
+        uint64 expect=0;
+        uint64 buf[32];
+
+        while(expect<COUNT)
+        {
+            const size_t n=q.PopBatch(buf,32);
+
+            if(!n)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            for(size_t i=0;i<n;i++)
+                CHECK(buf[i]==expect+i);
+
+            expect+=n;
+        }
+
+        producer.join();
+        CHECK(q.IsEmpty());
+    }
+
+    /**
+     * 多生产者多消费者：值为 生产者序号<<32|序列号
+     */
+    template<typename PushF,typename PopF>
+    void RunMPMC(int producers,int consumers,uint64 per_producer,PushF &&push,PopF &&pop)
+    {
+        std::vector<std::vector<uint8>> seen(producers,std::vector<uint8>(per_producer,0));
+        std::atomic<uint64> total{0};
+
+        const uint64 count=per_producer*producers;
+
+        std::vector<std::thread> threads;
+
+        for(int p=0;p<producers;p++)
+            threads.emplace_back([&,p]
+            {
+                for(uint64 i=0;i<per_producer;i++)
+                    push((uint64(p)<<32)|i);
+            });
+
+        for(int c=0;c<consumers;c++)
+            threads.emplace_back([&]
+            {
+                std::vector<int64> last(producers,-1);
+                uint64 v;
+
+                while(total.load(std::memory_order_relaxed)<count)
+                {
+                    if(!pop(v))
+                        continue;
+
+                    const int p=int(v>>32);
+                    const int64 i=int64(v&0xFFFFFFFF);
+
+                    CHECK(i>last[p]);                              //同一生产者的数据保持顺序
+                    last[p]=i;
+
+                    seen[p][i]++;                                   //每个值只会被一个消费者取到，写入不冲突
+                    total.fetch_add(1,std::memory_order_relaxed);
+                }
+            });
+
+        for(auto &t:threads)
+            t.join();
+
+        CHECK(total==count);
+
+        for(auto &s:seen)
+            for(uint8 x:s)
+                CHECK(x==1);
+    }
+
+    void TestMPMCThreaded()
+    {
+        std::cout<<"[TestMPMCThreaded]"<<std::endl;
+
+        MPMCQueue<uint64> q(64);
+
+        RunMPMC(4,3,100000,
+                [&](uint64 v){while(!q.TryPush(v))std::this_thread::yield();},
+                [&](uint64 &v){if(q.TryPop(v))return true;std::this_thread::yield();return false;});
+
+        CHECK(q.IsEmpty());
+
+        //批量
+        std::atomic<uint64> sum{0};
+        constexpr int PRODUCERS=3;
+        constexpr uint64 PER=60000;
+
+        std::vector<std::thread> threads;
+
+        for(int p=0;p<PRODUCERS;p++)
+            threads.emplace_back([&]
+            {
+                uint64 buf[8];
+
+                for(uint64 i=0;i<PER;i+=8)
+                {
+                    for(int k=0;k<8;k++)buf[k]=i+k+1;
+
+                    size_t done=0;
+
+                    while(done<8)
+                    {
+                        const size_t n=q.PushBatch(buf+done,8-done);
+
+                        if(!n)std::this_thread::yield();
+
+                        done+=n;
+                    }
+                }
+            });
+
+        std::atomic<uint64> popped{0};
+
+        for(int c=0;c<2;c++)
+            threads.emplace_back([&]
+            {
+                uint64 buf[13];
+
+                while(popped.load()<PRODUCERS*PER)
+                {
+                    const size_t n=q.PopBatch(buf,13);
+
+                    if(!n){std::this_thread::yield();continue;}
+
+                    uint64 s=0;
+                    for(size_t i=0;i<n;i++)s+=buf[i];
+
+                    sum.fetch_add(s);
+                    popped.fetch_add(n);
+                }
+            });
+
+        for(auto &t:threads)
+            t.join();
+
+        CHECK(popped==PRODUCERS*PER);
+        CHECK(sum==PRODUCERS*(PER*(PER+1)/2));
+    }
+
+    void TestBlocking()
+    {
+        std::cout<<"[TestBlocking]"<<std::endl;
+
+        {
+            BlockingMPMCQueue<int> q(2);
+            int v;
+
+            const auto earliest=std::chrono::steady_clock::now()+std::chrono::milliseconds(8);
+            bool ok=q.Pop(v,int64(10000));
+            CHECK(!ok);
+            CHECK(std::chrono::steady_clock::now()>=earliest);
+
+            ok=q.TryPush(1);
+            CHECK(ok);
+            ok=q.TryPush(2);
+            CHECK(ok);
+            ok=q.TryPush(3);
+            CHECK(!ok);
+            ok=q.Push(3,int64(5000));
+            CHECK(!ok);
+            CHECK(q.GetCount()==2);
+
+            ok=q.TryPop(v);
+            CHECK(ok&&v==1);
+            ok=q.Push(3,int64(5000));
+            CHECK(ok);
+            ok=q.Pop(v,int64(0));
+            CHECK(ok&&v==2);
+            q.Pop(v);
+            CHECK(v==3&&q.IsEmpty());
+        }
+
+        //消费者先阻塞，生产者后写入
+        {
+            BlockingSPSCQueue<int> q(4);
+            int got=0;
+
+            std::thread consumer([&]{q.Pop(got);});
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            q.Push(42);
+            consumer.join();
+            CHECK(got==42);
+        }
+
+        //多生产者多消费者，阻塞版本
+        {
+            BlockingMPMCQueue<uint64> q(32);
+
+            RunMPMC(3,3,50000,
+                    [&](uint64 v){q.Push(v);},
+                    [&](uint64 &v){return q.Pop(v,int64(1000));});
+        }
+
+        //批量：容量小于批量大小
+        {
+            BlockingMPMCQueue<uint64> q(16);
+            constexpr uint64 COUNT=100000;
+
+            std::thread producer([&]
+            {
+                std::vector<uint64> buf(50);
+
+                for(uint64 i=0;i<COUNT;i+=50)
+                {
+                    for(uint64 k=0;k<50;k++)buf[k]=i+k;
+
+                    q.PushBatch(buf.data(),50);
+                }
+            });
+
+            uint64 expect=0;
+            uint64 buf[20];
+
+            while(expect<COUNT)
+            {
+                const size_t n=q.PopBatch(buf,20);
+
+                CHECK(n>=1&&n<=20);
+
+                for(size_t i=0;i<n;i++)
+                    CHECK(buf[i]==expect+i);
+
+                expect+=n;
+            }
+
+            producer.join();
+        }
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestSingleThread<SPSCQueue<int>>("SPSCQueue");
+    TestSingleThread<MPMCQueue<int>>("MPMCQueue");
+    TestSPSCThreaded();
+    TestMPMCThreaded();
+    TestBlocking();
+
+    std::cout<<"[ConcurrentQueueTest] All tests passed"<<std::endl;
+
+    return 0;
+}
@@ -0,0 +1,241 @@
+﻿/**
+ * CPU指令集检测与按档次分派测试
+ *
+ * 1.检测结果自洽（档次所需的指令集全部存在，依赖关系成立）
+ * 2.HGL_CPU_TIER 解析与限制（可用 HGL_CPU_TIER=sse42 等运行本程序验证降档）
+ * 3.CpuDispatch 缺档回退、首次调用并发解析
+ * 4.BitVector 各档次内核结果一致
+ *
+ * 分派调用开销、各档次位计数与异或吞吐见 benchmark/CpuDispatchBench.cpp
+ */
+
+#include<hgl/platform/CpuDispatch.h>
+#include<hgl/type/BitVector.h>
+#include<iostream>
+#include<vector>
+#include<thread>
+#include<random>
+#include<cstring>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    void PrintFeature(const char *title,const CpuFeature &cf)
+    {
+        std::cout<<"  "<<title<<":";
+
+        const struct{const char *name;bool value;} list[]=
+        {
+            {"ssse3",cf.ssse3},{"sse4.1",cf.sse41},{"sse4.2",cf.sse42},{"popcnt",cf.popcnt},
+            {"avx",cf.avx},{"avx2",cf.avx2},{"fma",cf.fma},{"f16c",cf.f16c},{"bmi1",cf.bmi1},{"bmi2",cf.bmi2},
+            {"avx512f",cf.avx512f},{"avx512bw",cf.avx512bw},{"avx512dq",cf.avx512dq},{"avx512vl",cf.avx512vl},
+            {"sha",cf.sha}
+        };
+
+        for(const auto &f:list)
+            if(f.value)
+                std::cout<<" "<<f.name;
+
+        std::cout<<std::endl;
+    }
+
+    bool SameFeature(const CpuFeature &a,const CpuFeature &b)
+    {
+        return memcmp(&a,&b,sizeof(CpuFeature))==0;
+    }
+
+    void TestDetect()
+    {
+        const CpuFeature &detected=cpu_detail::GetCpuInfo().detected;
+        const CpuFeature &cf=GetCpuFeature();
+        const CpuTier hw_tier=cpu_detail::DetectCpuTier(detected);
+
+        std::cout<<"[TestDetect] hardware tier "<<GetCpuTierName(hw_tier)<<", using "<<GetCpuTierName(GetCpuTier())<<std::endl;
+        PrintFeature("detected",detected);
+
+        //依赖关系：需要操作系统保存YMM/ZMM的指令集一定带有其前置项
+        CHECK(!detected.avx2||detected.avx);
+        CHECK(!detected.fma||detected.avx);
+        CHECK(!detected.f16c||detected.avx);
+        CHECK(!detected.avx512bw||detected.avx512f);
+        CHECK(!detected.avx512vl||detected.avx512f);
+
+        CHECK(GetCpuTier()<=hw_tier);
+
+        if(GetCpuTier()>=CpuTier::SSE42)
+            CHECK(cf.ssse3&&cf.sse41&&cf.sse42&&cf.popcnt);
+
+        if(GetCpuTier()>=CpuTier::AVX2)
+            CHECK(cf.avx&&cf.avx2&&cf.fma&&cf.f16c&&cf.bmi1&&cf.bmi2);
+
+        if(GetCpuTier()>=CpuTier::AVX512)
+            CHECK(cf.avx512f&&cf.avx512bw&&cf.avx512dq&&cf.avx512vl);
+    }
+
+    void TestOverride()
+    {
+        std::cout<<"[TestOverride]"<<std::endl;
+
+        CpuTier t;
+
+        bool ok=cpu_detail::ParseCpuTier("scalar",t);
+        CHECK(ok&&t==CpuTier::Scalar);
+        ok=cpu_detail::ParseCpuTier("SSE42",t);
+        CHECK(ok&&t==CpuTier::SSE42);
+        ok=cpu_detail::ParseCpuTier("Avx2",t);
+        CHECK(ok&&t==CpuTier::AVX2);
+        ok=cpu_detail::ParseCpuTier("avx512",t);
+        CHECK(ok&&t==CpuTier::AVX512);
+
+        t=CpuTier::SSE42;
+        for(const char *bad:{(const char *)nullptr,"","avx","avx2x","sse4.2"})
+        {
+            ok=cpu_detail::ParseCpuTier(bad,t);
+            CHECK(!ok);
+        }
+        CHECK(t==CpuTier::SSE42);                                   //失败时不修改
+
+        const CpuFeature &detected=cpu_detail::GetCpuInfo().detected;
+
+        const CpuFeature none=cpu_detail::LimitCpuFeature(detected,CpuTier::Scalar);
+        CHECK(!none.ssse3&&!none.sse42&&!none.popcnt&&!none.avx2&&!none.bmi2&&!none.avx512f&&!none.sha);
+
+        const CpuFeature v3=cpu_detail::LimitCpuFeature(detected,CpuTier::AVX2);
+        CHECK(!v3.avx512f&&!v3.avx512bw&&v3.avx2==detected.avx2&&v3.sha==detected.sha);
+
+        CHECK(SameFeature(cpu_detail::LimitCpuFeature(detected,CpuTier::AVX512),detected));
+
+        if(cpu_detail::GetCpuTierOverride(t))
+        {
+            std::cout<<"  HGL_CPU_TIER="<<GetCpuTierName(t)<<std::endl;
+            PrintFeature("limited",GetCpuFeature());
+
+            CHECK(GetCpuTier()<=t);
+
+            if(t<cpu_detail::DetectCpuTier(detected))
+                CHECK(SameFeature(GetCpuFeature(),cpu_detail::LimitCpuFeature(detected,t)));
+        }
+        else
+        {
+            CHECK(SameFeature(GetCpuFeature(),detected));
+            CHECK(GetCpuTier()==cpu_detail::DetectCpuTier(detected));
+        }
+    }
+
+    int ImplScalar(int v){return v*10+0;}
+    int ImplSSE42 (int v){return v*10+1;}
+    int ImplAVX2  (int v){return v*10+2;}
+    int ImplAVX512(int v){return v*10+3;}
+
+    void TestDispatch()
+    {
+        std::cout<<"[TestDispatch]"<<std::endl;
+
+        const CpuDispatch<int(int)> full(ImplScalar,ImplSSE42,ImplAVX2,ImplAVX512);
+
+        for(int t=0;t<int(CpuTier::RANGE_SIZE);t++)
+        {
+            CHECK(full.Select(CpuTier(t))==CpuTier(t));
+            CHECK(full.Get(CpuTier(t))(7)==70+t);
+        }
+
+        CHECK(full(5)==50+int(GetCpuTier()));
+        CHECK(full.GetTier()==GetCpuTier());
+
+        //缺少的档次回退到更低档次
+        const CpuDispatch<int(int)> partial(ImplScalar,nullptr,ImplAVX2);
+
+        CHECK(partial.Select(CpuTier::Scalar)==CpuTier::Scalar);
+        CHECK(partial.Select(CpuTier::SSE42 )==CpuTier::Scalar);
+        CHECK(partial.Select(CpuTier::AVX2  )==CpuTier::AVX2);
+        CHECK(partial.Select(CpuTier::AVX512)==CpuTier::AVX2);
+
+        const CpuDispatch<int(int)> scalar_only(ImplScalar);
+
+        CHECK(scalar_only.Get(CpuTier::AVX512)==ImplScalar);
+        CHECK(scalar_only(3)==30);
+
+        //多线程同时首次调用
+        for(int round=0;round<20;round++)
+        {
+            const CpuDispatch<int(int)> fresh(ImplScalar,ImplSSE42,ImplAVX2,ImplAVX512);
+
+            std::vector<std::thread> threads;
+            std::vector<int> result(8);
+
+            for(int i=0;i<8;i++)
+                threads.emplace_back([&,i]{result[i]=fresh(i);});
+
+            for(auto &th:threads)
+                th.join();
+
+            for(int i=0;i<8;i++)
+                CHECK(result[i]==i*10+int(GetCpuTier()));
+        }
+    }
+
+    void TestKernel()
+    {
+        std::cout<<"[TestKernel] BitVector tiers 0.."<<int(GetCpuTier())<<std::endl;
+
+        using namespace bit_vector_detail;
+
+        std::mt19937_64 rng(3);
+
+        //覆盖各档次主循环与尾部的所有余数
+        for(size_t count=0;count<=70;count++)
+        {
+            std::vector<uint64> a(count),b(count);
+
+            for(size_t i=0;i<count;i++)
+            {
+                a[i]=rng();
+                b[i]=rng();
+            }
+
+            const uint64 expect_count=PopCountScalar(a.data(),count);
+
+            for(int op=0;op<int(BitOp::RANGE_SIZE);op++)
+            {
+                std::vector<uint64> expect(a);
+
+                if(BitOp(op)==BitOp::And   )BulkScalar<BitOp::And   >(expect.data(),b.data(),count);else
+                if(BitOp(op)==BitOp::Or    )BulkScalar<BitOp::Or    >(expect.data(),b.data(),count);else
+                if(BitOp(op)==BitOp::Xor   )BulkScalar<BitOp::Xor   >(expect.data(),b.data(),count);else
+                                            BulkScalar<BitOp::AndNot>(expect.data(),b.data(),count);
+
+                for(int t=0;t<=int(GetCpuTier());t++)
+                {
+                    //前后各留一个哨兵，检查掩码读写不越界
+                    std::vector<uint64> dst(count+2,0xDEADBEEFull);
+                    std::copy(a.begin(),a.end(),dst.begin()+1);
+
+                    BulkOp(BitOp(op),dst.data()+1,b.data(),count,CpuTier(t));
+
+                    CHECK(dst.front()==0xDEADBEEFull&&dst.back()==0xDEADBEEFull);
+                    CHECK(std::equal(expect.begin(),expect.end(),dst.begin()+1));
+                }
+            }
+
+            for(int t=0;t<=int(GetCpuTier());t++)
+                CHECK(PopCount(a.data(),count,CpuTier(t))==expect_count);
+
+            CHECK(PopCount(a.data(),count)==expect_count);
+        }
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestDetect();
+    TestOverride();
+    TestDispatch();
+    TestKernel();
+
+    std::cout<<"[CpuDispatchTest] All tests passed"<<std::endl;
+
+    return 0;
+}
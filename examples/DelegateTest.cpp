@@ -0,0 +1,182 @@
+﻿/**
+ * 编译期绑定委托与属性测试
+ *
+ * 1.Delegate 绑定成员函数/const成员函数/普通函数/lambda，比较与清空
+ * 2.BoundMethod 直接调用
+ * 3.BoundProperty/BoundPropertyRead 的读写与各运算符与 Property 行为一致
+ *
+ * 读写属性、调用回调的性能对比见 benchmark/DelegateBench.cpp
+ */
+
+#include<hgl/platform/compiler/Delegate.h>
+#include<iostream>
+#include<string>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace delegate_test                                             //模板实参用到的类不放在匿名名字空间中
+{
+    class Counter
+    {
+    public:
+
+        int64 total=0;
+
+        int Add(int v){total+=v;return int(total);}
+        int Get()const{return int(total);}
+        void Append(std::string &out,const std::string &s)const{out+=s;}
+    };
+
+    int Twice(int v){return v*2;}
+
+    void TestDelegate()
+    {
+        std::cout<<"[TestDelegate]"<<std::endl;
+
+        Counter c;
+
+        Delegate<int(int)> d;
+        CHECK(!d&&d==nullptr);
+
+        d=Delegate<int(int)>::Bind<&Counter::Add>(&c);
+        CHECK(d);
+        const int r3=d(3);
+        const int r4=d(4);
+        CHECK(r3==3&&r4==7&&c.total==7);
+
+        //同一对象同一函数相等
+        CHECK(d==Delegate<int(int)>::Bind<&Counter::Add>(&c));
+
+        Counter c2;
+        CHECK(!(d==Delegate<int(int)>::Bind<&Counter::Add>(&c2)));
+
+        //const成员函数
+        Delegate<int()> get=Delegate<int()>::Bind<&Counter::Get>(&c);
+        CHECK(get()==7);
+
+        //普通函数
+        Delegate<int(int)> f=Delegate<int(int)>::Bind<&Twice>();
+        CHECK(f(21)==42);
+        CHECK(!(f==d));
+
+        //lambda：捕获两个指针或一个指针加整数
+        int base=100;
+        Delegate<int(int)> l=[&base,&c](int v){return base+v+int(c.total);};
+        CHECK(l(1)==108);
+
+        Delegate<int(int)> l2=[k=5](int v){return v*k;};
+        CHECK(l2(3)==15);
+
+        //引用参数
+        std::string out;
+        Delegate<void(std::string &,const std::string &)> app=Delegate<void(std::string &,const std::string &)>::Bind<&Counter::Append>(&c);
+        app(out,"ab");
+        app(out,"cd");
+        CHECK(out=="abcd");
+
+        d.Clear();
+        CHECK(!d);
+
+        //BoundMethod
+        BoundMethod<&Counter::Add> bm(&c);
+        const int rbm=bm(3);
+        CHECK(rbm==10);
+
+        BoundMethod<&Counter::Get> bg(&c);
+        CHECK(bg()==10);
+    }
+
+    /**
+     * 新旧两种属性写法
+     */
+    class OldStyle:public _Object
+    {
+        int width=0;
+
+        int GetWidth()const{return width;}
+        void SetWidth(int w){width=w;}
+
+    public:
+
+        Property<int> Width;
+
+        OldStyle()
+        {
+            cmSetProperty(Width,this,OldStyle::GetWidth,OldStyle::SetWidth);
+        }
+    };
+
+    class NewStyle
+    {
+        int width=0;
+        int set_count=0;
+
+        int GetWidth()const{return width;}
+        void SetWidth(int w){width=w;++set_count;}
+
+        int GetSetCount()const{return set_count;}
+
+    public:
+
+        BoundProperty<&NewStyle::GetWidth,&NewStyle::SetWidth> Width{this};
+        BoundPropertyRead<&NewStyle::GetSetCount> SetCount{this};
+    };
+
+    void TestProperty()
+    {
+        std::cout<<"[TestProperty]"<<std::endl;
+
+        OldStyle o;
+        NewStyle n;
+
+        static_assert(sizeof(n.Width)==sizeof(void *));
+
+        auto check=[&]{CHECK(int(o.Width)==int(n.Width));};
+
+        o.Width=10;     n.Width=10;     check();
+        o.Width+=5;     n.Width+=5;     check();
+        o.Width-=3;     n.Width-=3;     check();
+        o.Width*=4;     n.Width*=4;     check();
+        o.Width/=3;     n.Width/=3;     check();
+        o.Width%=7;     n.Width%=7;     check();
+        o.Width|=0x30;  n.Width|=0x30;  check();
+        o.Width&=0x3C;  n.Width&=0x3C;  check();
+        o.Width<<=2;    n.Width<<=2;    check();
+        o.Width>>=1;    n.Width>>=1;    check();
+
+        CHECK(++o.Width==++n.Width);
+        CHECK(o.Width++==n.Width++);
+        check();
+        CHECK(--o.Width==--n.Width);
+        CHECK(o.Width--==n.Width--);
+        check();
+
+        CHECK((o.Width>>1)==(n.Width>>1));
+        CHECK((o.Width<<1)==(n.Width<<1));
+        CHECK(o.Width==int(n.Width)&&n.Width==int(o.Width));
+        CHECK(!(n.Width!=int(o.Width)));
+
+        //属性之间赋值是赋值，不是重新绑定
+        NewStyle n2;
+        n2.Width=n.Width;
+        CHECK(int(n2.Width)==int(n.Width));
+        n2.Width=1;
+        CHECK(int(n.Width)!=1);
+
+        CHECK(n.SetCount==14);
+    }
+}//namespace delegate_test
+
+using namespace delegate_test;
+
+int main(int,char **)
+{
+    TestDelegate();
+    TestProperty();
+
+    std::cout<<"[DelegateTest] All tests passed"<<std::endl;
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+﻿/**
+ * HashMap/HashSet 测试
+ *
+ * 性能对比见 benchmark/HashMapBench.cpp
+ */
+
+#include<hgl/type/HashMap.h>
+#include<iostream>
+#include<string>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    /**
+     * 统计分配量的memory_resource
+     */
+    class CountingResource:public std::pmr::memory_resource
+    {
+        std::pmr::memory_resource *upstream;
+
+    public:
+
+        size_t allocated=0;
+        size_t count=0;
+
+        explicit CountingResource(std::pmr::memory_resource *up):upstream(up){}
+
+    protected:
+
+        void *do_allocate(size_t bytes,size_t align) override
+        {
+            allocated+=bytes;
+            ++count;
+            return upstream->allocate(bytes,align);
+        }
+
+        void do_deallocate(void *p,size_t bytes,size_t align) override{upstream->deallocate(p,bytes,align);}
+        bool do_is_equal(const std::pmr::memory_resource &other)const noexcept override{return this==&other;}
+    };
+
+    enum class AssetType
+    {
+        Texture,
+        Mesh,
+        Sound
+    };
+
+    struct GridKey
+    {
+        int32 x,y,z;
+
+        bool operator==(const GridKey &)const=default;
+    };
+
+    void TestBasic()
+    {
+        std::cout<<"[TestBasic]"<<std::endl;
+
+        //整数/指针/枚举键经过混合，不再是原值
+        CHECK(OptimalHash<uint64>()(1)!=1);
+        CHECK(OptimalHash<uint64>()(1)!=OptimalHash<uint64>()(2));
+
+        int objects[4];
+        CHECK(OptimalHash<int *>()(&objects[0])!=uint64(reinterpret_cast<uintptr_t>(&objects[0])));
+
+        HashMap<uint32,std::string> names;
+        for(uint32 i=0;i<1000;i++)
+            names[i*16]="id"+std::to_string(i);
+
+        CHECK(names.size()==1000);
+        CHECK(names.find(160)->second=="id10");
+        CHECK(names.find(161)==names.end());
+        const size_t erased=names.erase(160);
+        CHECK(erased==1);
+        CHECK(!names.contains(160));
+
+        HashMap<AssetType,int> by_type{{AssetType::Mesh,2},{AssetType::Sound,3}};
+        CHECK(by_type[AssetType::Mesh]==2);
+
+        HashSet<const void *> ptrs;
+        for(int &o:objects)ptrs.insert(&o);
+        CHECK(ptrs.size()==4&&ptrs.contains(&objects[2]));
+
+        HashSet<GridKey> cells;
+        cells.insert({1,2,3});
+        cells.insert({1,2,3});
+        cells.insert({3,2,1});
+        CHECK(cells.size()==2);
+        CHECK(cells.contains(GridKey{3,2,1}));
+    }
+
+    void TestHeterogeneousLookup()
+    {
+        std::cout<<"[TestHeterogeneousLookup]"<<std::endl;
+
+        HashMap<std::string,int> map;
+        map["texture"]=1;
+        map["mesh"]=2;
+        map["material"]=3;
+
+        //从一段文本中直接以 指针+长度 查找，不构造std::string
+        const char *text="load mesh and material";
+        CHECK(map.find(std::string_view(text+5,4))->second==2);
+        CHECK(map.find(std::string_view(text+14,8))->second==3);
+        CHECK(map.find(std::string_view(text,4))==map.end());
+
+        const char *cstr="texture";
+        CHECK(map.contains(cstr));
+        CHECK(map.count(std::string_view("mesh"))==1);
+
+        //哈希与键的表示方式无关
+        OptimalStringHash<char> h;
+        CHECK(h(std::string("mesh"))==h(std::string_view(text+5,4)));
+        CHECK(h("mesh")==h(std::string_view("mesh")));
+
+        //宽字符
+        HashMap<std::u16string,int> wmap;
+        wmap[u"名称"]=7;
+        const char16_t wtext[]=u"xx名称yy";
+        CHECK(wmap.find(std::u16string_view(wtext+2,2))->second==7);
+
+        HashSet<std::u32string> wset{U"a",U"bc"};
+        CHECK(wset.contains(std::u32string_view(U"bc")));
+    }
+
+    void TestPmr()
+    {
+        std::cout<<"[TestPmr]"<<std::endl;
+
+        CountingResource counter(std::pmr::new_delete_resource());
+
+        {
+            std::pmr::monotonic_buffer_resource arena(64*1024,&counter);
+
+            pmr::HashMap<uint64,uint64> map(&arena);
+            map.reserve(1000);
+
+            for(uint64 i=0;i<1000;i++)
+                map[i]=i*i;
+
+            CHECK(map.size()==1000);
+            CHECK(map.find(999)->second==999*999);
+
+            pmr::HashSet<std::pmr::string> set(&arena);
+            set.emplace("alpha");
+            set.emplace("a string long enough to leave the small string buffer");
+            CHECK(set.contains(std::string_view("alpha")));
+
+            CHECK(counter.count>0);
+        }
+
+        std::cout<<"  arena upstream allocations: "<<counter.count<<", "<<counter.allocated/1024<<" KB"<<std::endl;
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestBasic();
+    TestHeterogeneousLookup();
+    TestPmr();
+
+    std::cout<<"[HashMapTest] All tests passed"<<std::endl;
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+﻿/**
+ * 整数/指针哈希质量测试
+ *
+ * 1.雪崩统计：翻转输入的每一位，统计输出每一位翻转的概率（理想值0.5）
+ * 2.桶分布：典型键（顺序ID、对齐地址、真实堆地址）放入2^k个桶，分别按低位与高位取桶
+ *   （ankerl::unordered_dense 使用高位），统计最大桶负载与卡方值
+ *
+ * 稠密表查找吞吐见 benchmark/HashQualityBench.cpp
+ */
+
+#include<hgl/util/hash/QuickHash.h>
+#include<iostream>
+#include<iomanip>
+#include<vector>
+#include<memory>
+#include<random>
+#include<cmath>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    constexpr HashMixPolicy policies[]={HashMixPolicy::Identity,HashMixPolicy::WyMix,HashMixPolicy::Murmur};
+    constexpr const char *policy_names[]={"Identity","WyMix","Murmur"};
+
+    uint64 Mix(HashMixPolicy policy,uint64 v)
+    {
+        switch(policy)
+        {
+            case HashMixPolicy::WyMix:  return HashMix64<HashMixPolicy::WyMix>(v);
+            case HashMixPolicy::Murmur: return HashMix64<HashMixPolicy::Murmur>(v);
+            default:                    return HashMix64<HashMixPolicy::Identity>(v);
+        }
+    }
+
+    struct AvalancheResult
+    {
+        double mean_bias;           ///<|P(翻转)-0.5| 的平均值
+        double max_bias;            ///<|P(翻转)-0.5| 的最大值
+    };
+
+    AvalancheResult Avalanche(HashMixPolicy policy,uint32 samples)
+    {
+        std::vector<uint32> flips(64*64,0);
+        std::mt19937_64 rng(99);
+
+        for(uint32 s=0;s<samples;s++)
+        {
+            const uint64 x=rng();
+            const uint64 h=Mix(policy,x);
+
+            for(int in=0;in<64;in++)
+            {
+                const uint64 d=h^Mix(policy,x^(uint64(1)<<in));
+
+                for(int out=0;out<64;out++)
+                    flips[in*64+out]+=uint32((d>>out)&1);
+            }
+        }
+
+        AvalancheResult r{0,0};
+
+        for(uint32 f:flips)
+        {
+            const double bias=std::fabs(double(f)/samples-0.5);
+
+            r.mean_bias+=bias;
+            r.max_bias=std::max(r.max_bias,bias);
+        }
+
+        r.mean_bias/=double(flips.size());
+        return r;
+    }
+
+    struct BucketResult
+    {
+        uint32 max_load;
+        double chi2_ratio;          ///<卡方/自由度，均匀分布约为1
+        double empty_ratio;
+    };
+
+    BucketResult Buckets(HashMixPolicy policy,const std::vector<uint64> &keys,int bits,bool high_bits)
+    {
+        const size_t bucket_count=size_t(1)<<bits;
+        std::vector<uint32> load(bucket_count,0);
+
+        for(uint64 k:keys)
+        {
+            const uint64 h=Mix(policy,k);
+            const size_t index=high_bits?size_t(h>>(64-bits)):size_t(h&(bucket_count-1));
+
+            ++load[index];
+        }
+
+        const double expect=double(keys.size())/double(bucket_count);
+        double chi2=0;
+        size_t empty=0;
+        uint32 max_load=0;
+
+        for(uint32 l:load)
+        {
+            chi2+=(l-expect)*(l-expect)/expect;
+            empty+=(l==0);
+            max_load=std::max(max_load,l);
+        }
+
+        return {max_load,chi2/double(bucket_count-1),double(empty)/double(bucket_count)};
+    }
+
+    void TestAvalanche()
+    {
+        std::cout<<"[Avalanche] bias of output bit flip probability from 0.5"<<std::endl;
+
+        for(size_t p=0;p<3;p++)
+        {
+            const AvalancheResult r=Avalanche(policies[p],20000);
+
+            std::cout<<"  "<<std::left<<std::setw(9)<<policy_names[p]<<std::right
+                     <<" mean "<<std::fixed<<std::setprecision(4)<<r.mean_bias<<"  max "<<r.max_bias<<std::endl;
+
+            if(policies[p]!=HashMixPolicy::Identity)
+            {
+                CHECK(r.mean_bias<0.01);
+                CHECK(r.max_bias<0.05);
+            }
+            else
+                CHECK(r.mean_bias>0.4);
+        }
+    }
+
+    void TestBuckets()
+    {
+        std::cout<<"\n[Buckets] 65536 keys into 65536 buckets (max load / chi2 per dof / empty ratio)"<<std::endl;
+
+        constexpr size_t count=65536;
+        constexpr int bits=16;
+
+        std::vector<std::unique_ptr<uint64[]>> blocks;
+        std::vector<uint64> sequential(count),aligned(count),heap(count);
+
+        for(size_t i=0;i<count;i++)
+        {
+            sequential[i]=i;
+            aligned[i]=0x7f0000000000ull+i*4096;                        //页对齐地址
+            blocks.emplace_back(new uint64[3]);
+            heap[i]=reinterpret_cast<uint64>(blocks.back().get());
+        }
+
+        const struct{const char *name;const std::vector<uint64> *keys;} sets[]=
+        {
+            {"sequential id",&sequential},
+            {"page aligned",&aligned},
+            {"heap pointers",&heap},
+        };
+
+        for(const auto &set:sets)
+        {
+            std::cout<<"  "<<set.name<<std::endl;
+
+            for(size_t p=0;p<3;p++)
+            {
+                const BucketResult low =Buckets(policies[p],*set.keys,bits,false);
+                const BucketResult high=Buckets(policies[p],*set.keys,bits,true);
+
+                std::cout<<"    "<<std::left<<std::setw(9)<<policy_names[p]<<std::right<<std::setprecision(2)
+                         <<" low bits: "<<std::setw(6)<<low.max_load<<" / "<<std::setw(10)<<low.chi2_ratio<<" / "<<low.empty_ratio
+                         <<"   high bits: "<<std::setw(6)<<high.max_load<<" / "<<std::setw(10)<<high.chi2_ratio<<" / "<<high.empty_ratio<<std::endl;
+
+                if(policies[p]!=HashMixPolicy::Identity)
+                {
+                    //泊松分布下65536个桶的最大负载一般不超过10
+                    CHECK(low.max_load<=12&&high.max_load<=12);
+                    CHECK(low.chi2_ratio<1.1&&high.chi2_ratio<1.1);
+                }
+            }
+        }
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestAvalanche();
+    TestBuckets();
+
+    std::cout<<"[HashQualityTest] All tests passed"<<std::endl;
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+﻿/**
+ * MappedFile 测试
+ *
+ * 各种映射配置与pread窗口读取的内容一致性、边界情况。
+ * 与"整个文件读入std::vector后解析"的耗时对比见 benchmark/MappedFileBench.cpp
+ */
+
+#include<hgl/type/MappedFile.h>
+#include<hgl/type/StdByteBuffer.h>
+#include<iostream>
+#include<fstream>
+#include<vector>
+#include<string>
+#include<cstdio>
+#include<cstring>
+#include<unistd.h>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    std::string TempFileName(const char *tag)
+    {
+        return std::string("/tmp/hgl_mapped_file_")+tag+"_"+std::to_string(getpid())+".bin";
+    }
+
+    void WriteFile(const std::string &filename,const std::vector<uint8_t> &data)
+    {
+        std::ofstream out(filename,std::ios::binary|std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(data.data()),std::streamsize(data.size()));
+    }
+
+    uint64 Checksum(ByteSpanReader reader)
+    {
+        uint64 sum=0;
+        const size_t count=reader.left()/sizeof(uint64);
+
+        if(reader.require(count*sizeof(uint64)))
+            for(size_t i=0;i<count;i++)
+                sum+=reader.u64_unchecked();
+
+        uint8 tail;
+        while(reader.u8(tail))
+            sum+=tail;
+
+        return sum;
+    }
+
+    /**
+     * 以固定大小的窗口逐段计算校验和（窗口为8的倍数时与Checksum结果相同）
+     */
+    uint64 ChecksumWindowed(const MappedFile &mf,size_t window)
+    {
+        uint64 sum=0;
+
+        for(size_t offset=0;offset<mf.GetSize();offset+=window)
+            sum+=Checksum(mf.GetReader(offset,window));
+
+        return sum;
+    }
+
+    void TestReadBack(const MappedFileConfig &config,MappedFileMode expect_mode)
+    {
+        const std::string filename=TempFileName("rw");
+
+        std::vector<uint8_t> data;
+        ByteWriter writer(data);
+        writer.u32(0x46474C48);                 //'HLGF'
+        writer.i32(-12345);
+        writer.string("asset-pack");
+        for(uint32 i=0;i<100000;i++)
+            writer.u32(i*2654435761u);
+
+        WriteFile(filename,data);
+
+        MappedFile mf;
+        const bool opened=mf.Open(filename.c_str(),config);
+        CHECK(opened);
+        CHECK(mf.GetMode()==expect_mode);
+        CHECK(mf.GetSize()==data.size());
+
+        ByteSpanReader reader=mf.GetReader();
+
+        uint32 magic;
+        int32 value;
+        uint8 name_length;
+        bool ok=reader.u32(magic);
+        ok&=reader.i32(value);
+        ok&=reader.u8(name_length);
+        CHECK(ok&&magic==0x46474C48&&value==-12345&&name_length==10);
+
+        std::string_view name(reinterpret_cast<const char *>(reader.current()),name_length);
+        CHECK(name=="asset-pack");
+        reader.skip(name_length);
+
+        for(uint32 i=0;i<100000;i++)
+        {
+            uint32 v=0;
+            ok=reader.u32(v);
+            CHECK(ok&&v==i*2654435761u);
+        }
+        CHECK(reader.eof());
+
+        //分段读取器
+        ByteSpanReader part=mf.GetReader(4,4);
+        ok=part.i32(value);
+        CHECK(ok&&value==-12345&&part.eof());
+        CHECK(mf.GetReader(data.size()+10,4).left()==0);
+
+        ok=mf.Advise(MappedFileAdvice::Random,100,4096);
+        ok&=mf.Advise(MappedFileAdvice::WillNeed);
+        CHECK(ok);
+
+        //移动语义
+        MappedFile moved(std::move(mf));
+        CHECK(!mf.IsOpen());
+        CHECK(moved.IsOpen()&&moved.GetSize()==data.size());
+
+        moved.Close();
+        CHECK(!moved.IsOpen());
+
+        std::remove(filename.c_str());
+    }
+
+    void TestEdgeCases()
+    {
+        std::cout<<"[TestEdgeCases]"<<std::endl;
+
+        MappedFile mf;
+        bool ok=mf.Open(nullptr);
+        CHECK(!ok);
+        ok=mf.Open("/nonexistent/path/file.bin");
+        CHECK(!ok);
+        ok=mf.Open("/tmp");                                 //目录不是普通文件
+        CHECK(!ok);
+
+        const std::string filename=TempFileName("empty");
+        WriteFile(filename,{});
+
+        ok=mf.Open(filename.c_str());
+        CHECK(ok);
+        CHECK(mf.GetSize()==0);
+        CHECK(mf.GetReader().eof());
+
+        std::remove(filename.c_str());
+    }
+
+    void TestWindowed()
+    {
+        std::cout<<"[TestWindowed]"<<std::endl;
+
+        const std::string filename=TempFileName("window");
+
+        std::vector<uint8_t> data(100003);
+        for(size_t i=0;i<data.size();i++)
+            data[i]=uint8_t(i*131);
+
+        WriteFile(filename,data);
+
+        MappedFileConfig config;
+        config.force_buffered=true;
+        config.read_chunk_size=1000;                        //窗口由多次pread拼成
+
+        MappedFile mf;
+        const bool opened=mf.Open(filename.c_str(),config);
+        CHECK(opened);
+        CHECK(mf.GetMode()==MappedFileMode::Buffered);
+        CHECK(mf.GetData()==nullptr);                       //不整体读入内存
+
+        //逐窗口读取，每个窗口内容与文件一致
+        for(size_t offset=0;offset<data.size();offset+=4096)
+        {
+            ByteSpanReader window=mf.GetReader(offset,4096);
+            const size_t expect=(data.size()-offset<4096)?data.size()-offset:4096;
+
+            CHECK(window.left()==expect);
+            CHECK(memcmp(window.current(),data.data()+offset,expect)==0);
+        }
+
+        //窗口内的子区间直接复用缓冲区，不重新读取
+        ByteSpanReader window=mf.GetReader(8192,4096);
+        ByteSpanReader inner=mf.GetReader(9000,100);
+        CHECK(inner.current()==window.current()+(9000-8192));
+        CHECK(memcmp(inner.current(),data.data()+9000,100)==0);
+
+        //窗口外的区间重新读取
+        ByteSpanReader other=mf.GetReader(50001,7);
+        CHECK(other.left()==7&&memcmp(other.current(),data.data()+50001,7)==0);
+
+        CHECK(mf.GetReader(data.size(),1).left()==0);
+        CHECK(mf.GetReader(data.size()-2,100).left()==2);
+        CHECK(ChecksumWindowed(mf,65536)==Checksum(ByteSpanReader(data)));
+
+        std::remove(filename.c_str());
+    }
+}//namespace
+
+int main(int,char **)
+{
+    std::cout<<"[TestReadBack] mmap"<<std::endl;
+    TestReadBack(MappedFileConfig(),MappedFileMode::Mmap);
+
+    {
+        std::cout<<"[TestReadBack] mmap + populate + huge pages"<<std::endl;
+        MappedFileConfig config;
+        config.populate=true;
+        config.huge_pages=true;
+        TestReadBack(config,MappedFileMode::Mmap);
+    }
+
+    {
+        std::cout<<"[TestReadBack] pread fallback"<<std::endl;
+        MappedFileConfig config;
+        config.force_buffered=true;
+        config.read_chunk_size=4096;
+        TestReadBack(config,MappedFileMode::Buffered);
+    }
+
+    TestEdgeCases();
+    TestWindowed();
+
+    std::cout<<"[MappedFileTest] All tests passed"<<std::endl;
+    return 0;
+}
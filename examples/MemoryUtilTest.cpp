@@ -0,0 +1,145 @@
+﻿/**
+ * 内存操作函数测试
+ *
+ * mem_copy/mem_fill/mem_fill_pattern/mem_zero 在各种长度、起始对齐下与逐元素结果一致（含非临时存储路径）
+ * 性能对比见 benchmark/MemoryUtilBench.cpp
+ */
+
+#include<hgl/type/MemoryUtil.h>
+#include<iostream>
+#include<vector>
+#include<random>
+#include<cstdlib>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    struct Pixel12                                                  ///<长度不能整除32，走倍增复制
+    {
+        uint32 r,g,b;
+
+        bool operator==(const Pixel12 &)const=default;
+    };
+
+    struct Vec4                                                     ///<16字节，走模式块填充
+    {
+        float x,y,z,w;
+
+        bool operator==(const Vec4 &)const=default;
+    };
+
+    template<typename T>
+    void CheckFill(const T &value,const size_t max_count)
+    {
+        std::vector<T> buf(max_count+8);
+
+        for(size_t offset=0;offset<4;offset++)
+        for(size_t n:{size_t(0),size_t(1),size_t(3),size_t(17),size_t(100),size_t(1000),max_count})
+        {
+            std::fill(buf.begin(),buf.end(),T{});
+
+            mem_fill(buf.data()+offset,value,n);
+
+            for(size_t i=0;i<buf.size();i++)
+                CHECK(buf[i]==((i>=offset&&i<offset+n)?value:T{}));
+
+            std::fill(buf.begin(),buf.end(),T{});
+
+            mem_fill_pattern(buf.data()+offset,&value,n);
+
+            for(size_t i=0;i<buf.size();i++)
+                CHECK(buf[i]==((i>=offset&&i<offset+n)?value:T{}));
+        }
+    }
+
+    void TestCorrectness()
+    {
+        std::cout<<"[TestCorrectness] stream threshold "<<mem_get_stream_threshold()<<std::endl;
+
+        std::mt19937 rng(1);
+
+        constexpr size_t max_bytes=1<<20;
+
+        std::vector<uint8> src(max_bytes+64),dst(max_bytes+64);
+        for(auto &v:src)v=uint8(rng());
+
+        for(size_t threshold:{size_t(HGL_MEM_STREAM_THRESHOLD),size_t(256)})     //第二轮强制走非临时存储
+        {
+            mem_set_stream_threshold(threshold);
+
+            //复制：各种源/目标偏移与长度
+            for(int r=0;r<300;r++)
+            {
+                const size_t so=rng()%33,doff=rng()%33;
+                const size_t n=(r<100)?rng()%600:rng()%max_bytes;
+
+                std::fill(dst.begin(),dst.end(),uint8(0xCD));
+                mem_copy(dst.data()+doff,src.data()+so,n);
+
+                CHECK(memcmp(dst.data()+doff,src.data()+so,n)==0);
+                for(size_t i=0;i<doff;i++)CHECK(dst[i]==0xCD);
+                for(size_t i=doff+n;i<dst.size();i++)CHECK(dst[i]==0xCD);
+            }
+
+            //清零
+            for(int r=0;r<100;r++)
+            {
+                const size_t off=rng()%33;
+                const size_t n=rng()%max_bytes;
+
+                std::fill(dst.begin(),dst.end(),uint8(0xCD));
+                mem_zero(dst.data()+off,n);
+
+                for(size_t i=0;i<dst.size();i++)
+                    CHECK(dst[i]==((i>=off&&i<off+n)?0:0xCD));
+            }
+
+            //填充：各种元素长度，起始地址不对齐元素
+            CheckFill<uint8>(0x5A,100000);
+            CheckFill<uint16>(0x1234,100000);
+            CheckFill<uint32>(0xDEADBEEF,100000);
+            CheckFill<uint64>(0x0123456789ABCDEFull,50000);
+            CheckFill<Vec4>({1,2,3,4},20000);
+            CheckFill<Pixel12>({7,8,9},30000);
+
+            //uint32数组从非4字节对齐地址开始
+            {
+                std::vector<uint8> raw(4096+16);
+                uint32 *p=reinterpret_cast<uint32 *>(raw.data()+1);
+                const uint32 v=0xA1B2C3D4;
+
+                mem_fill(p,v,1000);
+
+                for(size_t i=0;i<1000;i++)
+                {
+                    uint32 t;
+                    memcpy(&t,raw.data()+1+i*4,4);
+                    CHECK(t==v);
+                }
+            }
+
+            //显式非临时存储接口
+            mem_copy_stream(dst.data()+3,src.data()+5,max_bytes-7);
+            CHECK(memcmp(dst.data()+3,src.data()+5,max_bytes-7)==0);
+
+            mem_zero_stream(dst.data()+1,max_bytes);
+            for(size_t i=1;i<=max_bytes;i++)CHECK(dst[i]==0);
+        }
+
+        mem_set_stream_threshold(0);                                //0为禁用
+        CHECK(mem_get_stream_threshold()==~size_t(0));
+
+        mem_set_stream_threshold(HGL_MEM_STREAM_THRESHOLD);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestCorrectness();
+
+    std::cout<<"[MemoryUtilTest] All tests passed"<<std::endl;
+    return 0;
+}
@@ -0,0 +1,216 @@
+﻿/**
+ * MultiStringMatcher 多模式匹配测试
+ *
+ * 1.与逐模式strstr的结果逐一对比（随机小字母表，大量重叠匹配），分别测试Aho-Corasick/Teddy
+ * 2.忽略大小写、宽字符、精确查找（与find_str_in_array对比）
+ *
+ * 日志过滤与名称查找的性能对比见 benchmark/MultiStringMatchBench.cpp
+ */
+
+#include<hgl/type/Str.MultiMatch.h>
+#include<hgl/type/Str.StringArray.h>
+#include<iostream>
+#include<vector>
+#include<string>
+#include<random>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    const char *EngineName(MultiMatchEngine e)
+    {
+        switch(e)
+        {
+            case MultiMatchEngine::AhoCorasick: return "AhoCorasick";
+            case MultiMatchEngine::TeddySSSE3:  return "TeddySSSE3";
+            case MultiMatchEngine::TeddyAVX2:   return "TeddyAVX2";
+            default:                            return "Auto";
+        }
+    }
+
+    /**
+     * 参考实现：逐模式、逐位置比较
+     */
+    std::vector<MultiMatchResult> Naive(const std::vector<std::string> &patterns,const std::string &text,bool icase)
+    {
+        std::vector<MultiMatchResult> result;
+
+        for(size_t pos=0;pos<text.size();pos++)
+            for(size_t p=0;p<patterns.size();p++)
+            {
+                const std::string &pat=patterns[p];
+
+                if(pat.empty()||pos+pat.size()>text.size())continue;
+
+                const bool eq=icase?hgl::stricmp(text.c_str()+pos,pat.c_str(),pat.size())==0
+                                   :text.compare(pos,pat.size(),pat)==0;
+
+                if(eq)
+                    result.push_back({pos,uint32(pat.size()),int(p)});
+            }
+
+        return result;
+    }
+
+    bool Same(const std::vector<MultiMatchResult> &a,const std::vector<MultiMatchResult> &b)
+    {
+        if(a.size()!=b.size())return false;
+
+        for(size_t i=0;i<a.size();i++)
+            if(a[i].start!=b[i].start||a[i].length!=b[i].length||a[i].pattern!=b[i].pattern)
+                return false;
+
+        return true;
+    }
+
+    void TestRandom()
+    {
+        std::cout<<"[TestRandom]"<<std::endl;
+
+        std::mt19937 rng(17);
+        const MultiMatchEngine engines[]={MultiMatchEngine::AhoCorasick,MultiMatchEngine::TeddySSSE3,MultiMatchEngine::TeddyAVX2};
+
+        for(int round=0;round<300;round++)
+        {
+            const bool icase=(round%3)==0;
+            const int pattern_count=1+int(rng()%(round<200?64:300));
+            const char *alphabet=icase?"abcABC":"abcd";
+            const size_t alpha_len=strlen(alphabet);
+
+            std::vector<std::string> patterns(pattern_count);
+            for(auto &p:patterns)
+            {
+                const size_t len=1+rng()%6;
+                for(size_t i=0;i<len;i++)
+                    p.push_back(alphabet[rng()%alpha_len]);
+            }
+
+            if(round%7==0&&pattern_count>1)patterns[rng()%pattern_count]="";    //空模式被跳过
+            if(round%5==0)patterns.push_back(patterns[0]);              //重复模式各自报告
+
+            std::string text;
+            const size_t text_len=rng()%300;
+            for(size_t i=0;i<text_len;i++)
+                text.push_back(alphabet[rng()%alpha_len]);
+
+            std::vector<const char *> list;
+            for(auto &p:patterns)list.push_back(p.c_str());
+
+            const std::vector<MultiMatchResult> expect=Naive(patterns,text,icase);
+
+            for(MultiMatchEngine e:engines)
+            {
+                MultiStringMatcher<char> matcher;
+                const bool ok=matcher.Build(int(list.size()),list.data(),icase,e);
+
+                CHECK(ok);
+
+                std::vector<MultiMatchResult> got;
+                matcher.FindAll(text.c_str(),text.size(),got);
+
+                if(!Same(got,expect))
+                {
+                    std::cout<<"  mismatch: engine "<<EngineName(matcher.GetEngine())<<" round "<<round<<std::endl;
+                    std::abort();
+                }
+
+                CHECK(matcher.Count(text.c_str(),text.size())==expect.size());
+                CHECK(matcher.Contains(text.c_str(),text.size())==!expect.empty());
+            }
+        }
+    }
+
+    void TestBasic()
+    {
+        std::cout<<"[TestBasic]"<<std::endl;
+
+        const char *keywords[]={"error","warn","fatal","timeout","err",nullptr};
+
+        MultiStringMatcher<char> matcher;
+        bool ok=matcher.Build(keywords);
+        CHECK(ok);
+        CHECK(matcher.GetPatternCount()==5);
+
+        std::cout<<"  engine: "<<EngineName(matcher.GetEngine())<<", states "<<matcher.GetStateCount()<<", classes "<<matcher.GetClassCount()<<std::endl;
+
+        const std::string line="[net] connection timeout, error code 7; ERROR again";
+        std::vector<MultiMatchResult> r;
+
+        const size_t found=matcher.FindAll(line.c_str(),line.size(),r);
+        CHECK(found==3);                                                //timeout, error, err
+        CHECK(r[0].pattern==3&&r[0].start==17);
+        CHECK(r[1].pattern==0&&r[1].start==26&&r[1].length==5);
+        CHECK(r[2].pattern==4&&r[2].start==26);
+
+        //忽略大小写
+        MultiStringMatcher<char> icase;
+        ok=icase.Build(keywords,true);
+        CHECK(ok);
+        CHECK(icase.Count(line.c_str(),line.size())==5);              //另有ERROR, ERR
+
+        //精确查找与find_str_in_array一致（find_str_in_array不区分大小写）
+        for(const char *s:{"warn","WARN","Fatal","er","errors","timeout",""})
+            CHECK(icase.Match(s)==find_str_in_array(keywords,s));
+
+        CHECK(matcher.Match("WARN")==-1);
+        CHECK(matcher.Match("warn")==1);
+        CHECK(matcher.Match("errorX",5)==0);
+
+        //回调中止
+        int seen=0;
+        ok=matcher.Scan(line.c_str(),line.size(),[&seen](const MultiMatchResult &){return ++seen<2;});
+        CHECK(!ok&&seen==2);
+
+        //空列表
+        MultiStringMatcher<char> empty;
+        const char *none[]={nullptr};
+        ok=empty.Build(none);
+        CHECK(!ok);
+        CHECK(!empty.Contains(line.c_str(),line.size()));
+        CHECK(empty.Match("error")==-1);
+    }
+
+    void TestWide()
+    {
+        std::cout<<"[TestWide]"<<std::endl;
+
+        const char16_t *names[]={u"纹理",u"网格",u"Mesh",u"纹理贴图",nullptr};
+
+        MultiStringMatcher<char16_t> matcher;
+        bool ok=matcher.Build(names,true);
+        CHECK(ok);
+        CHECK(matcher.GetEngine()==MultiMatchEngine::AhoCorasick);
+
+        const std::u16string text=u"加载MESH与纹理贴图";
+        std::vector<MultiMatchResult> r;
+
+        const size_t found=matcher.FindAll(text.c_str(),text.size(),r);
+        CHECK(found==3);
+        CHECK(r[0].pattern==2&&r[0].start==2);
+        CHECK(r[1].pattern==0&&r[1].start==7);
+        CHECK(r[2].pattern==3&&r[2].start==7&&r[2].length==4);
+
+        CHECK(matcher.Match(u"mesh")==2);
+        CHECK(matcher.Match(u"纹理")==0);
+        CHECK(matcher.Match(u"纹")==-1);
+
+        const wchar_t *wnames[]={L"αβ",L"β",nullptr};
+        MultiStringMatcher<wchar_t> wm;
+        ok=wm.Build(wnames);
+        CHECK(ok);
+        CHECK(wm.Count(L"αβγβ",4)==3);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestBasic();
+    TestWide();
+    TestRandom();
+
+    std::cout<<"[MultiStringMatchTest] All tests passed"<<std::endl;
+    return 0;
+}
@@ -0,0 +1,250 @@
+﻿/**
+ * 多播事件测试
+ *
+ * 1.增删目标、重复与空目标、按对象移除、清空
+ * 2.回调中增删目标（快照语义，不死锁），旧快照在读者离开后回收
+ * 3.Post/Flush 延迟模式按顺序整批分发
+ * 4.多线程：触发线程与增删线程并发
+ *
+ * 每个目标的分发耗时（对比手写的 vector<EventFunc>+mutex）见 benchmark/MulticastEventBench.cpp
+ */
+
+#include<hgl/platform/compiler/MulticastEvent.h>
+#include<iostream>
+#include<vector>
+#include<string>
+#include<thread>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    using ValueEvent=MulticastEvent<void (_Object::*)(int)>;
+
+    class Listener:public _Object
+    {
+    public:
+
+        int64 sum=0;
+        int calls=0;
+
+        void OnValue(int v)
+        {
+            sum+=v;
+            ++calls;
+        }
+
+        void OnOther(int v)
+        {
+            sum-=v;
+        }
+    };
+
+    class Source
+    {
+    public:
+
+        DefMulticastEvent(OnValue,(int));
+        DefMulticastEvent(OnText,(const std::string &,int));
+    };
+
+    void TestBasic()
+    {
+        std::cout<<"[TestBasic]"<<std::endl;
+
+        Source src;
+        Listener a,b;
+
+        CHECK(src.OnValue.IsEmpty());
+        src.OnValue(1);                                             //没有目标
+
+        bool ok=AddEventCall(src.OnValue,&a,Listener,OnValue);
+        CHECK(ok);
+        ok=AddEventCall(src.OnValue,&a,Listener,OnValue);          //重复
+        CHECK(!ok);
+        ok=AddEventCall(src.OnValue,&a,Listener,OnOther);          //同一对象的另一个函数
+        CHECK(ok);
+        ok=AddEventCall(src.OnValue,&b,Listener,OnValue);
+        CHECK(ok);
+        ok=src.OnValue.Add(ValueEvent::Target());                   //空目标
+        CHECK(!ok);
+        CHECK(src.OnValue.GetCount()==3);
+
+        src.OnValue(5);
+        CHECK(a.sum==0&&a.calls==1);
+        CHECK(b.sum==5&&b.calls==1);
+
+        ok=RemoveEventCall(src.OnValue,&a,Listener,OnOther);
+        CHECK(ok);
+        ok=RemoveEventCall(src.OnValue,&a,Listener,OnOther);
+        CHECK(!ok);
+        src.OnValue(2);
+        CHECK(a.sum==2&&b.sum==7);
+
+        int removed=src.OnValue.RemoveObject(&a);
+        CHECK(removed==1);
+        removed=src.OnValue.RemoveObject(&a);
+        CHECK(removed==0);
+        src.OnValue(1);
+        CHECK(a.sum==2&&b.sum==8);
+
+        src.OnValue.Clear();
+        CHECK(src.OnValue.IsEmpty()&&src.OnValue.GetCount()==0);
+        src.OnValue(1);
+        CHECK(b.sum==8);
+
+        //没有读者时旧快照立即回收
+        CHECK(src.OnValue.GetRetiredCount()==0);
+
+        //引用参数
+        class TextListener:public _Object
+        {
+        public:
+            std::string text;
+            void OnText(const std::string &s,int n){for(int i=0;i<n;i++)text+=s;}
+        }tl;
+
+        ok=AddEventCall(src.OnText,&tl,TextListener,OnText);
+        CHECK(ok);
+        src.OnText(std::string("ab"),2);
+        CHECK(tl.text=="abab");
+    }
+
+    /**
+     * 在回调中增删目标
+     */
+    class Reentrant:public _Object
+    {
+    public:
+
+        ValueEvent *event=nullptr;
+        Listener *other=nullptr;
+        int calls=0;
+
+        void OnValue(int v)
+        {
+            ++calls;
+
+            if(v==1)AddEventCall(*event,other,Listener,OnValue);      //本次不会被调用
+            if(v==2)event->RemoveObject(this);                          //本次仍在调用中
+            if(v==3)event->Post(4);
+        }
+    };
+
+    void TestReentrant()
+    {
+        std::cout<<"[TestReentrant]"<<std::endl;
+
+        ValueEvent event;
+        Reentrant r;
+        Listener l;
+
+        r.event=&event;
+        r.other=&l;
+
+        AddEventCall(event,&r,Reentrant,OnValue);
+
+        event(1);
+        CHECK(r.calls==1&&l.calls==0&&event.GetCount()==2);
+
+        //读区间中退役的快照要等读者离开后才能回收
+        CHECK(event.GetRetiredCount()==1);
+        event.Reclaim();
+        CHECK(event.GetRetiredCount()==0);
+
+        event(2);
+        CHECK(r.calls==2&&l.calls==1&&event.GetCount()==1);
+
+        event(5);
+        CHECK(r.calls==2&&l.calls==2);
+
+        //延迟模式
+        AddEventCall(event,&r,Reentrant,OnValue);
+
+        event.Post(3);
+        event.Post(10);
+        CHECK(event.GetPostedCount()==2);
+        int flushed=event.Flush();
+        CHECK(flushed==2);                                          //回调中Post的4留到下一次
+        CHECK(l.sum==2+5+3+10);
+        CHECK(event.GetPostedCount()==1);
+        flushed=event.Flush();
+        CHECK(flushed==1);
+        CHECK(l.sum==2+5+3+10+4);
+        flushed=event.Flush();
+        CHECK(flushed==0);
+
+        event.Post(7);
+        event.Clear();
+        flushed=event.Flush();
+        CHECK(flushed==1);                                          //没有目标时仍清空队列
+        CHECK(event.GetPostedCount()==0);
+    }
+
+    class AtomicListener:public _Object
+    {
+    public:
+
+        std::atomic<int64> calls{0};
+
+        void OnValue(int){calls.fetch_add(1,std::memory_order_relaxed);}
+    };
+
+    /**
+     * 两个线程触发，一个线程反复增删，检查增删不影响常驻目标的调用次数
+     */
+    void TestConcurrent()
+    {
+        std::cout<<"[TestConcurrent]"<<std::endl;
+
+        ValueEvent event;
+        AtomicListener fixed;
+        std::vector<AtomicListener> temp(16);
+        std::atomic<bool> stop{false};
+
+        AddEventCall(event,&fixed,AtomicListener,OnValue);
+
+        constexpr int FIRE_COUNT=200000;
+
+        auto fire=[&]
+        {
+            for(int i=0;i<FIRE_COUNT;i++)
+                event.Call(0);
+        };
+
+        std::thread writer([&]
+        {
+            while(!stop.load())
+            {
+                for(AtomicListener &l:temp)AddEventCall(event,&l,AtomicListener,OnValue);
+                for(AtomicListener &l:temp)event.RemoveObject(&l);
+            }
+        });
+
+        std::thread r1(fire),r2(fire);
+
+        r1.join();
+        r2.join();
+        stop=true;
+        writer.join();
+
+        CHECK(event.GetCount()==1);
+        CHECK(fixed.calls==FIRE_COUNT*2);
+
+        event.Reclaim();
+        CHECK(event.GetRetiredCount()==0);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestBasic();
+    TestReentrant();
+    TestConcurrent();
+
+    std::cout<<"[MulticastEventTest] All tests passed"<<std::endl;
+
+    return 0;
+}
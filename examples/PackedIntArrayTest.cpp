@@ -0,0 +1,203 @@
+﻿/**
+ * 位压缩整数数组与位流测试
+ *
+ * 1.PackedIntArray 1~32位各宽度的 Get/Set/Add/Resize/Assign/Unpack 与普通数组一致
+ * 2.BitStreamWriter/BitStreamReader 随机位宽往返、一元编码、字节对齐、越界检测
+ *
+ * 与 uint32 数组比较占用内存与解码速度见 benchmark/PackedIntArrayBench.cpp
+ */
+
+#include<hgl/type/PackedIntArray.h>
+#include<hgl/type/BitStream.h>
+#include<iostream>
+#include<vector>
+#include<random>
+#include<cstring>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    void TestPackedIntArray()
+    {
+        std::cout<<"[TestPackedIntArray]"<<std::endl;
+
+        std::mt19937 rng(1);
+
+        CHECK(PackedIntArray::BitsRequired(0)==1);
+        CHECK(PackedIntArray::BitsRequired(1)==1);
+        CHECK(PackedIntArray::BitsRequired(255)==8);
+        CHECK(PackedIntArray::BitsRequired(256)==9);
+        CHECK(PackedIntArray::BitsRequired(0xFFFFFFFF)==32);
+
+        PackedIntArray bad;
+        bool ok=bad.Init(0);
+        CHECK(!ok);
+        ok=bad.Init(33);
+        CHECK(!ok);
+
+        for(uint32 bits=1;bits<=32;bits++)
+        {
+            const uint32 mask=uint32(low_bits_mask(bits));
+
+            for(size_t n:{0,1,7,8,9,63,100,1003})
+            {
+                std::vector<uint32> ref(n);
+                for(auto &v:ref)v=rng()&mask;
+
+                //逐个Set
+                PackedIntArray pa(bits,n);
+                CHECK(pa.GetCount()==n&&pa.GetBytes()==(n*bits+7)/8);
+
+                for(size_t i=0;i<n;i++)pa.Set(i,ref[i]);
+                for(size_t i=0;i<n;i++)CHECK(pa[i]==ref[i]);
+
+                //Set不影响相邻元素，超出位宽被截掉
+                if(n>2)
+                {
+                    pa.Set(1,0xFFFFFFFF);
+                    CHECK(pa[0]==ref[0]&&pa[1]==mask&&pa[2]==ref[2]);
+                    pa.Set(1,ref[1]);
+                }
+
+                //Assign与Add
+                PackedIntArray pb(bits);
+                pb.Assign(ref.data(),n);
+                CHECK(pb.GetBytes()==pa.GetBytes());
+                CHECK(n==0||memcmp(pa.GetData(),pb.GetData(),pa.GetBytes())==0);
+
+                PackedIntArray pc(bits);
+                for(uint32 v:ref)pc.Add(v);
+                for(size_t i=0;i<n;i++)CHECK(pc[i]==ref[i]);
+
+                //各种起点与长度的Unpack
+                std::vector<uint32> out(n+1);
+                for(int r=0;r<20&&n;r++)
+                {
+                    const size_t start=rng()%n;
+                    const size_t len=rng()%(n-start+1);
+
+                    const bool unpacked=pa.Unpack(out.data(),start,len);
+                    CHECK(unpacked);
+
+                    for(size_t i=0;i<len;i++)
+                        CHECK(out[i]==ref[start+i]);
+                }
+                bool unpacked=pa.Unpack(out.data(),0,n);
+                CHECK(unpacked&&std::equal(ref.begin(),ref.end(),out.begin()));
+                unpacked=pa.Unpack(out.data(),n,1);
+                CHECK(!unpacked);
+
+                //缩小后再放大，新增元素为0
+                pa.Resize(n/2);
+                pa.Resize(n);
+                for(size_t i=0;i<n;i++)
+                    CHECK(pa[i]==(i<n/2?ref[i]:0));
+            }
+        }
+    }
+
+    void TestBitStream()
+    {
+        std::cout<<"[TestBitStream]"<<std::endl;
+
+        std::mt19937_64 rng(2);
+
+        for(int round=0;round<50;round++)
+        {
+            const size_t count=rng()%2000;
+
+            std::vector<uint32> widths(count);
+            std::vector<uint64> values(count);
+            std::vector<uint8> buffer{0xAB};                            //写入器追加到已有数据之后
+
+            uint64 total_bits=0;
+
+            {
+                BitStreamWriter bw(buffer);
+
+                for(size_t i=0;i<count;i++)
+                {
+                    widths[i]=uint32(rng()%65);
+                    values[i]=rng();
+                    bw.write_bits(values[i],widths[i]);
+
+                    total_bits+=widths[i];
+                }
+
+                CHECK(bw.tell_bits()==total_bits);
+                const size_t flushed=bw.flush();
+                CHECK(flushed==(total_bits+7)/8);
+            }
+
+            CHECK(buffer[0]==0xAB);
+
+            BitStreamReader br(buffer.data()+1,buffer.size()-1);
+
+            for(size_t i=0;i<count;i++)
+            {
+                uint32 w=widths[i];
+                uint64 v=0;
+
+                if(w>BitStreamReader::MAX_READ_BITS)                    //超过56位分两次读
+                {
+                    v=br.read_bits(32);
+                    v|=br.read_bits(w-32)<<32;
+                }
+                else
+                    v=br.read_bits(w);
+
+                CHECK(v==(values[i]&low_bits_mask(w)));
+            }
+
+            CHECK(br.tell_bits()==total_bits);
+            CHECK(!br.overrun());
+            CHECK(br.left_bits()<8);
+        }
+
+        //一元编码、单个位、字节对齐、peek/skip
+        std::vector<uint8> buffer;
+        BitStreamWriter bw(buffer);
+
+        for(uint32 i=0;i<100;i++)bw.write_unary(i);
+        bw.write_bit(true);
+        bw.align_to_byte();
+        bw.write_bits(0x5A,8);
+        bw.flush();
+
+        BitStreamReader br(buffer);
+
+        for(uint32 i=0;i<100;i++)
+        {
+            const uint32 unary=br.read_unary();
+            CHECK(unary==i);
+        }
+
+        const bool bit=br.read_bit();
+        CHECK(bit);
+        br.align_to_byte();
+        CHECK(br.tell_bits()%8==0);
+        CHECK(br.peek_bits(4)==0xA);
+        br.skip_bits(4);
+        uint64 low=br.read_bits(4);
+        CHECK(low==0x5);
+        CHECK(br.left_bits()==0&&!br.overrun());
+
+        //越界读到0
+        low=br.read_bits(20);
+        CHECK(low==0);
+        CHECK(br.overrun());
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestPackedIntArray();
+    TestBitStream();
+
+    std::cout<<"[PackedIntArrayTest] All tests passed"<<std::endl;
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+﻿/**
+ * 完美哈希字符串表测试
+ *
+ * 1.编译期构建与查找（static_assert）
+ * 2.随机键集合（各种字符类型、各种数量）全部可查到，不存在的键全部查不到
+ * 3.忽略大小写与 find_str_in_array 结果一致；重复键只保留第一个
+ * 4.枚举名称双向转换
+ *
+ * 与 find_str_in_array、HashMap<std::string_view> 的性能对比见 benchmark/PerfectHashTableBench.cpp
+ */
+
+#include<hgl/type/PerfectHashTable.h>
+#include<hgl/type/Str.StringArray.h>
+#include<hgl/type/HashMap.h>
+#include<iostream>
+#include<vector>
+#include<string>
+#include<random>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    constexpr const char *keywords[]={"if","else","while","for","return","break","continue","switch","case","default"};
+    constexpr StaticStringTable keyword_table(keywords);
+
+    static_assert(keyword_table.IsValid());
+    static_assert(keyword_table.Find("while")==2);
+    static_assert(keyword_table.Find("default")==9);
+    static_assert(keyword_table.Find("whil")==-1);
+    static_assert(keyword_table.Find("While")==-1);
+
+    constexpr const char16_t *wide_keys[]={u"纹理",u"网格",u"材质"};
+    constexpr StaticStringTable<char16_t,3,true> wide_table(wide_keys);
+
+    static_assert(wide_table.Find(u"材质")==2);
+
+    enum class BlendMode
+    {
+        Opaque=1,
+        Mask,
+        Alpha,
+        Additive,
+
+        ENUM_CLASS_RANGE(Opaque,Additive)
+    };
+
+    constexpr const char *blend_mode_names[]={"Opaque","Mask","Alpha","Additive"};
+    constexpr EnumNameTable<BlendMode,4> blend_mode_table(blend_mode_names);
+
+    constexpr BlendMode ParseBlendMode(const char *name)
+    {
+        BlendMode mode=BlendMode::Opaque;
+        blend_mode_table.ToEnum(name,mode);
+        return mode;
+    }
+
+    static_assert(ParseBlendMode("Alpha")==BlendMode::Alpha);
+    static_assert(blend_mode_table.ToName(BlendMode::Additive)[0]=='A');
+
+    std::string RandomWord(std::mt19937 &rng,size_t max_len)
+    {
+        std::string s;
+        const size_t len=1+rng()%max_len;
+
+        for(size_t i=0;i<len;i++)
+            s.push_back(char('a'+rng()%26));
+
+        return s;
+    }
+
+    template<typename CharT>
+    std::basic_string<CharT> Widen(const std::string &s)
+    {
+        std::basic_string<CharT> w;
+        for(char c:s)w.push_back(CharT(c)+(sizeof(CharT)>1?CharT(0x4E00):CharT(0)));     //宽字符使用CJK区
+        return w;
+    }
+
+    template<typename CharT>
+    void TestRandom(const char *name)
+    {
+        std::mt19937 rng(41);
+
+        for(size_t n:{1,2,3,7,100,1000,20000})
+        {
+            HashSet<std::string> unique;
+            while(unique.size()<n)unique.insert(RandomWord(rng,10));
+
+            std::vector<std::basic_string<CharT>> strings;
+            for(const std::string &s:unique)strings.push_back(Widen<CharT>(s));
+
+            std::vector<const CharT *> list;
+            for(auto &s:strings)list.push_back(s.c_str());
+
+            PerfectHashStringTable<CharT> table;
+            bool ok=table.Build(int(list.size()),list.data());
+            CHECK(ok);
+
+            for(size_t i=0;i<n;i++)
+            {
+                CHECK(table.Find(list[i])==int(i));
+                CHECK(table.Find(strings[i].c_str(),int(strings[i].size()))==int(i));
+            }
+
+            for(int i=0;i<10000;i++)
+            {
+                const std::string w=RandomWord(rng,10);
+
+                if(!unique.contains(w))
+                    CHECK(table.Find(Widen<CharT>(w).c_str())==-1);
+            }
+        }
+
+        std::cout<<"  "<<name<<" ok"<<std::endl;
+    }
+
+    void TestCompat()
+    {
+        std::cout<<"[TestCompat]"<<std::endl;
+
+        const char *list[]={"Texture","Mesh","Sound","mesh","Font",nullptr};
+
+        PerfectHashStringTable<char,true> table;
+        bool ok=table.Build(list);
+        CHECK(ok);
+        CHECK(table.GetCount()==5);
+
+        for(const char *q:{"texture","MESH","Mesh","sound","font","fonts","","Tex"})
+            CHECK(table.Find(q)==find_str_in_array(list,q));
+
+        for(const char *q:{"MESH","Font","xyz"})
+            CHECK(table.Find(q)==find_str_in_array(5,list,q));
+
+        //区分大小写时"Mesh"与"mesh"是两个键
+        PerfectHashStringTable<char> exact(5,list);
+        CHECK(exact.Find("Mesh")==1);
+        CHECK(exact.Find("mesh")==3);
+        CHECK(exact.Find("MESH")==-1);
+
+        //按长度查找子串
+        const char *text="load Sound now";
+        CHECK(table.Find(text+5,5)==2);
+        CHECK(table.Find(std::string_view(text+5,4))==-1);
+    }
+
+    void TestEnum()
+    {
+        std::cout<<"[TestEnum]"<<std::endl;
+
+        BlendMode mode;
+        ENUM_CLASS_FOR(BlendMode,int,i)
+        {
+            const BlendMode m=FromInt<BlendMode>(i);
+            const char *name=blend_mode_table.ToName(m);
+
+            CHECK(name);
+            bool ok=blend_mode_table.ToEnum(name,mode);
+            CHECK(ok&&mode==m);
+        }
+
+        bool ok=blend_mode_table.ToEnum("alpha",mode);
+        CHECK(!ok);
+        CHECK(blend_mode_table.ToName(BlendMode(0))==nullptr);
+
+        constexpr EnumNameTable<BlendMode,4,char,true> icase(blend_mode_names);
+        ok=icase.ToEnum(std::string_view("ADDITIVE"),mode);
+        CHECK(ok&&mode==BlendMode::Additive);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    std::cout<<"[TestRandom]"<<std::endl;
+    TestRandom<char>("char");
+    TestRandom<char16_t>("char16_t");
+    TestRandom<char32_t>("char32_t");
+    TestRandom<wchar_t>("wchar_t");
+
+    TestCompat();
+    TestEnum();
+
+    std::cout<<"[PerfectHashTableTest] All tests passed"<<std::endl;
+
+    return 0;
+}
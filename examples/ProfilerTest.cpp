@@ -0,0 +1,214 @@
+﻿/**
+ * 性能采样测试
+ *
+ * 1.TscClock 单调性与校准精度
+ * 2.LatencyHistogram 桶边界、百分位误差、合并、多线程记录
+ * 3.区间/计数器的多线程记录与Chrome trace导出
+ *
+ * 读时钟、记录区间、直方图、计数器的单次开销见 benchmark/ProfilerBench.cpp
+ */
+
+#define HGL_PROFILER
+
+#include<hgl/time/Profiler.h>
+#include<hgl/time/TscClock.h>
+#include<iostream>
+#include<vector>
+#include<thread>
+#include<chrono>
+#include<cstdio>
+#include<cstdlib>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    size_t CountOf(const std::string &str,const char *sub)
+    {
+        size_t n=0;
+
+        for(size_t pos=str.find(sub);pos!=std::string::npos;pos=str.find(sub,pos+1))
+            ++n;
+
+        return n;
+    }
+
+    void TestClock()
+    {
+        std::cout<<"[TestClock] hardware="<<TscClock::IsHardware()<<", "<<1.0/TscClock::NanosecondsPerTick()<<" ticks/ns"<<std::endl;
+
+        uint64 prev=TscClock::Now();
+
+        for(int i=0;i<100000;i++)
+        {
+            const uint64 t=TscClock::Now();
+
+            CHECK(t>=prev);
+            prev=t;
+        }
+
+        const uint64 t0=TscClock::Now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        const uint64 ns=TscClock::ToNanoseconds(TscClock::Now()-t0);
+
+        CHECK(ns>=29000000&&ns<200000000);
+        CHECK(TscClock::SinceOrigin(0)==0);
+    }
+
+    void TestHistogram()
+    {
+        std::cout<<"[TestHistogram]"<<std::endl;
+
+        //每个值都落在所在桶的上下界之内，桶连续无空隙
+        for(uint64 v:{uint64(0),uint64(1),uint64(31),uint64(32),uint64(33),uint64(63),uint64(64),uint64(1000),uint64(123456789),~uint64(0)})
+        {
+            const size_t i=LatencyHistogram::BucketIndex(v);
+
+            CHECK(i<LatencyHistogram::BUCKET_COUNT);
+            CHECK(LatencyHistogram::BucketLowerBound(i)<=v&&v<=LatencyHistogram::BucketUpperBound(i));
+        }
+
+        for(size_t i=0;i+1<LatencyHistogram::BUCKET_COUNT;i++)
+            CHECK(LatencyHistogram::BucketUpperBound(i)+1==LatencyHistogram::BucketLowerBound(i+1));
+
+        auto *h=new LatencyHistogram;
+
+        CHECK(h->GetCount()==0&&h->GetPercentile(50)==0&&h->GetMin()==0);
+
+        for(uint64 v=1;v<=100000;v++)
+            h->Record(v);
+
+        CHECK(h->GetCount()==100000);
+        CHECK(h->GetMin()==1&&h->GetMax()==100000);
+        CHECK(h->GetMean()==50000.5);
+
+        for(double p:{1.0,50.0,90.0,99.0,99.9})
+        {
+            const double expect=p*1000;
+            const double got=double(h->GetPercentile(p));
+
+            CHECK(got>=expect&&got<=expect*(1.0+1.0/LatencyHistogram::SUB_COUNT)+1);
+        }
+
+        CHECK(h->GetPercentile(100)==100000);
+
+        auto *h2=new LatencyHistogram;
+
+        h2->Record(5,10);
+        h2->Record(1000000);
+        h->Merge(*h2);
+
+        CHECK(h->GetCount()==100011&&h->GetMin()==1&&h->GetMax()==1000000);
+
+        uint64 seen=0;
+        h->ForEachBucket([&](uint64 lo,uint64 hi,uint64 n){CHECK(lo<=hi);seen+=n;});
+        CHECK(seen==100011);
+
+        //多线程同时记录
+        h->Reset();
+
+        std::vector<std::thread> threads;
+
+        for(int t=0;t<4;t++)
+            threads.emplace_back([h,t]
+            {
+                for(int i=0;i<50000;i++)
+                    h->Record(uint64(t*1000+i%1000));
+            });
+
+        for(auto &th:threads)
+            th.join();
+
+        CHECK(h->GetCount()==200000&&h->GetMin()==0&&h->GetMax()==3999);
+
+        delete h2;
+        delete h;
+    }
+
+    void Work(int depth)
+    {
+        HGL_PROFILE_FUNCTION();
+
+        HGL_PROFILE_COUNTER_ADD("work calls",1);
+
+        if(depth>0)
+        {
+            HGL_PROFILE_ZONE("nested \"zone\"");
+
+            Work(depth-1);
+        }
+    }
+
+    void TestZones()
+    {
+        std::cout<<"[TestZones]"<<std::endl;
+
+        Profiler::Reset();
+        HGL_PROFILE_THREAD_NAME("main");
+
+        constexpr int THREADS=4;
+        constexpr int LOOPS=3000;                                   //每次Work(2)记录5个区间，跨越多个缓冲块
+
+        std::vector<std::thread> threads;
+
+        for(int t=0;t<THREADS;t++)
+            threads.emplace_back([]
+            {
+                HGL_PROFILE_THREAD_NAME("worker");
+
+                for(int i=0;i<LOOPS;i++)
+                    Work(2);
+            });
+
+        //记录进行中导出不应出错
+        std::string partial;
+        Profiler::ExportChromeTrace(partial);
+
+        for(auto &th:threads)
+            th.join();
+
+        {
+            HGL_PROFILE_ZONE("main zone");
+            Profiler::SampleCounters();
+        }
+
+        CHECK(Profiler::GetZoneCount()==uint64(THREADS*LOOPS*5+1));
+        CHECK(Profiler::GetDroppedCount()==0);
+        CHECK(Profiler::FindCounter("work calls")->Get()==THREADS*LOOPS*3);
+        CHECK(Profiler::FindCounter("none")==nullptr);
+
+        std::string json;
+        Profiler::ExportChromeTrace(json);
+
+        CHECK(json.front()=='{'&&json.find("]}")!=std::string::npos);
+        CHECK(CountOf(json,"\"ph\":\"X\"")==size_t(THREADS*LOOPS*5+1));
+        CHECK(CountOf(json,"\"name\":\"Work\"")==size_t(THREADS*LOOPS*3));
+        CHECK(CountOf(json,"\"name\":\"nested \\\"zone\\\"\"")==size_t(THREADS*LOOPS*2));
+        CHECK(CountOf(json,"\"thread_name\"")==size_t(THREADS+1));
+        CHECK(json.find("{\"name\":\"work calls\",\"ph\":\"C\"")!=std::string::npos);
+        CHECK(json.find("\"value\":36000")!=std::string::npos);
+
+        const bool saved=Profiler::SaveChromeTrace("ProfilerTest.json");
+
+        CHECK(saved);
+
+        Profiler::Reset();
+        CHECK(Profiler::GetZoneCount()==0);
+        CHECK(Profiler::FindCounter("work calls")->Get()==0);
+
+        std::remove("ProfilerTest.json");
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestClock();
+    TestHistogram();
+    TestZones();
+
+    std::cout<<"[ProfilerTest] All tests passed"<<std::endl;
+
+    return 0;
+}
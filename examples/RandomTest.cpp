@@ -0,0 +1,342 @@
+﻿/**
+ * 随机数生成器测试
+ *
+ * 1.与 wyrand/wy2u01/wy2gau 的结果一致，Jump/Stream 与逐个生成一致
+ * 2.AVX2批量填充与标量实现使用相同的随机数序列
+ * 3.统计检验：均值、方差、卡方、整数范围、正态分布、单位向量
+ * 4.多线程各自独立的流
+ *
+ * 各种批量填充的吞吐量（对比 std::mt19937）见 benchmark/RandomBench.cpp
+ */
+
+#include<hgl/math/Random.h>
+#include<iostream>
+#include<vector>
+#include<thread>
+#include<algorithm>
+#include<cmath>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+using namespace hgl::random_detail;
+
+namespace
+{
+    void TestSequence()
+    {
+        std::cout<<"[TestSequence]"<<std::endl;
+
+        uint64 seed=12345;
+        Random rng(12345);
+
+        for(int i=0;i<1000;i++)
+        {
+            const uint64 v=rng.NextU64();
+            CHECK(v==wyrand(&seed));
+        }
+
+        //Jump 与逐个生成一致
+        Random a(99),b(99);
+        for(int i=0;i<777;i++)a.NextU64();
+        b.Jump(777);
+        const uint64 va=a.NextU64();
+        const uint64 vb=b.NextU64();
+        CHECK(va==vb);
+
+        //子流
+        Random base(5);
+        Random s3=base.Stream(3);
+        Random manual(5);
+        manual.Jump(3*STREAM_STRIDE);
+        CHECK(s3.GetState()==manual.GetState());
+        const uint64 v0=base.Stream(0).NextU64();
+        const uint64 v1=base.Stream(1).NextU64();
+        CHECK(v0!=v1);
+
+        //double与wy2u01相同
+        Random c(7),d(7);
+        for(int i=0;i<100;i++)
+        {
+            const double v=c.NextDouble();
+            const double expect=wy2u01(d.NextU64());
+            CHECK(v==expect);
+        }
+    }
+
+    /**
+     * 用AVX2与标量分别填充，比较结果与填充后的状态
+     */
+    void TestBatchMatchesScalar()
+    {
+        std::cout<<"[TestBatchMatchesScalar]"<<std::endl;
+
+        for(size_t n:{0,1,2,3,7,8,9,15,16,17,100,1001})
+        {
+            //FillU64
+            {
+                Random a(n);
+                uint64 state=n;
+                std::vector<uint64> x(n),y(n);
+
+                a.FillU64(x.data(),n);
+                FillU64Scalar(state,y.data(),n);
+
+                CHECK(x==y&&a.GetState()==state);
+            }
+
+            //FillU32
+            {
+                Random a(n);
+                uint64 state=n;
+                std::vector<uint32> x(n),y(n);
+
+                a.FillU32(x.data(),n);
+                FillPairScalar(state,n,[&y](size_t k,uint32 r){y[k]=r;});
+
+                CHECK(x==y&&a.GetState()==state);
+            }
+
+            //FillInt
+            for(auto [lo,hi]:{std::pair<int32,int32>{-10,10},{0,0},{INT32_MIN,INT32_MAX},{100,1099}})
+            {
+                Random a(n);
+                uint64 state=n;
+                std::vector<int32> x(n),y(n);
+
+                a.FillInt(x.data(),n,lo,hi);
+                FillPairScalar(state,n,[&y,lo,hi](size_t k,uint32 r){y[k]=int32(uint32(lo)+U32ToRange(r,uint32(hi)-uint32(lo)+1));});
+
+                CHECK(x==y&&a.GetState()==state);
+            }
+
+            //FillFloat/FillDouble/FillGaussian
+            {
+                Random a(n),b(n),c(n);
+                uint64 sa=n,sb=n,sc=n;
+                std::vector<float> fx(n),fy(n),gx(n),gy(n);
+                std::vector<double> dx(n),dy(n);
+
+                a.FillFloat(fx.data(),n,-2,3);
+                FillPairScalar(sa,n,[&fy](size_t k,uint32 r){fy[k]=U32ToFloat(r)*5.0f-2.0f;});
+
+                b.FillDouble(dx.data(),n,10,20);
+                for(size_t i=0;i<n;i++)dy[i]=U64ToDouble(Next(sb))*10.0+10.0;
+
+                c.FillGaussian(gx.data(),n,1,2);
+                for(size_t i=0;i<n;i++)gy[i]=GauToFloat(Next(sc),1,2);
+
+                for(size_t i=0;i<n;i++)
+                {
+                    CHECK(std::fabs(fx[i]-fy[i])<1e-6f);
+                    CHECK(std::fabs(dx[i]-dy[i])<1e-12);
+                    CHECK(std::fabs(gx[i]-gy[i])<1e-5f);
+                }
+
+                CHECK(a.GetState()==sa&&b.GetState()==sb&&c.GetState()==sc);
+            }
+
+            //单位向量
+            {
+                Random a(n),b(n);
+                uint64 sa=n,sb=n;
+                std::vector<float> x2(n*2),y2(n*2),x3(n*3),y3(n*3);
+
+                a.FillUnitVector2(x2.data(),n);
+                FillPairScalar(sa,n,[&y2](size_t k,uint32 r){UnitCircle(r,y2[k*2],y2[k*2+1]);});
+
+                b.FillUnitVector3(x3.data(),n);
+                for(size_t i=0;i<n;i++)
+                {
+                    const uint64 r=Next(sb);
+                    UnitSphere(uint32(r),uint32(r>>32),y3[i*3],y3[i*3+1],y3[i*3+2]);
+                }
+
+                for(size_t i=0;i<n*2;i++)CHECK(std::fabs(x2[i]-y2[i])<1e-6f);
+                for(size_t i=0;i<n*3;i++)CHECK(std::fabs(x3[i]-y3[i])<1e-6f);
+
+                CHECK(a.GetState()==sa&&b.GetState()==sb);
+            }
+        }
+    }
+
+    void TestStatistics()
+    {
+        std::cout<<"[TestStatistics]"<<std::endl;
+
+        constexpr size_t n=1<<22;
+        Random rng(2024);
+
+        //均匀float：均值1/2，方差1/12，范围[0,1)
+        {
+            std::vector<float> v(n);
+            rng.FillFloat(v.data(),n);
+
+            double sum=0,sum2=0;
+            for(float f:v)
+            {
+                CHECK(f>=0.0f&&f<1.0f);
+                sum+=f;
+                sum2+=double(f)*f;
+            }
+
+            const double mean=sum/n,var=sum2/n-mean*mean;
+            std::cout<<"  float mean "<<mean<<" var "<<var<<std::endl;
+            CHECK(std::fabs(mean-0.5)<0.002);
+            CHECK(std::fabs(var-1.0/12)<0.002);
+        }
+
+        //32位整数高8位与低8位的卡方检验（255自由度，临界值约330@0.1%）
+        {
+            std::vector<uint32> v(n);
+            rng.FillU32(v.data(),n);
+
+            for(int shift:{0,24})
+            {
+                std::vector<double> bucket(256,0);
+                for(uint32 x:v)bucket[(x>>shift)&0xFF]++;
+
+                const double expect=double(n)/256;
+                double chi2=0;
+                for(double b:bucket)chi2+=(b-expect)*(b-expect)/expect;
+
+                std::cout<<"  u32 byte@"<<shift<<" chi2 "<<chi2<<std::endl;
+                CHECK(chi2<330);
+            }
+        }
+
+        //整数范围：所有值都出现且不越界
+        {
+            std::vector<int32> v(n);
+            rng.FillInt(v.data(),n,-3,6);
+
+            std::vector<size_t> bucket(10,0);
+            for(int32 x:v)
+            {
+                CHECK(x>=-3&&x<=6);
+                bucket[x+3]++;
+            }
+
+            for(size_t b:bucket)
+                CHECK(std::fabs(double(b)/n-0.1)<0.002);
+
+            for(int i=0;i<10000;i++)
+            {
+                const int32 x=rng.NextInt(5,7);
+                CHECK(x>=5&&x<=7);
+                const uint32 y=rng.NextBelow(3);
+                CHECK(y<3);
+            }
+        }
+
+        //double与正态分布
+        {
+            std::vector<double> d(n);
+            rng.FillDouble(d.data(),n,-1,1);
+
+            double sum=0;
+            for(double x:d){CHECK(x>=-1&&x<1);sum+=x;}
+            CHECK(std::fabs(sum/n)<0.002);
+
+            std::vector<float> g(n);
+            rng.FillGaussian(g.data(),n,10,2);
+
+            double gs=0,gs2=0;
+            size_t within_1sigma=0;
+            for(float x:g)
+            {
+                gs+=x;
+                gs2+=double(x)*x;
+                within_1sigma+=(std::fabs(x-10)<2);
+            }
+
+            const double mean=gs/n,var=gs2/n-mean*mean;
+            std::cout<<"  gaussian mean "<<mean<<" var "<<var<<" within 1 sigma "<<double(within_1sigma)/n<<std::endl;
+            CHECK(std::fabs(mean-10)<0.01);
+            CHECK(std::fabs(var-4)<0.02);
+            CHECK(std::fabs(double(within_1sigma)/n-0.667)<0.005);   //三个均匀分布之和为2/3（正态分布为68.3%）
+        }
+
+        //单位向量：长度为1，均值为0，各轴方差1/2(2D)、1/3(3D)
+        {
+            std::vector<float> v2(n*2),v3(n*3);
+            rng.FillUnitVector2(v2.data(),n);
+            rng.FillUnitVector3(v3.data(),n);
+
+            double m2[2]={},q2[2]={},m3[3]={},q3[3]={};
+
+            for(size_t i=0;i<n;i++)
+            {
+                const float *p=&v2[i*2];
+                CHECK(std::fabs(p[0]*p[0]+p[1]*p[1]-1.0f)<1e-5f);
+                for(int k=0;k<2;k++){m2[k]+=p[k];q2[k]+=double(p[k])*p[k];}
+
+                const float *q=&v3[i*3];
+                CHECK(std::fabs(q[0]*q[0]+q[1]*q[1]+q[2]*q[2]-1.0f)<1e-5f);
+                for(int k=0;k<3;k++){m3[k]+=q[k];q3[k]+=double(q[k])*q[k];}
+            }
+
+            for(int k=0;k<2;k++)CHECK(std::fabs(m2[k]/n)<0.002&&std::fabs(q2[k]/n-0.5)<0.002);
+            for(int k=0;k<3;k++)CHECK(std::fabs(m3[k]/n)<0.002&&std::fabs(q3[k]/n-1.0/3)<0.002);
+        }
+    }
+
+    void TestThreads()
+    {
+        std::cout<<"[TestThreads]"<<std::endl;
+
+        constexpr int thread_count=4;
+        std::vector<uint64> first(thread_count);
+        std::vector<std::thread> threads;
+
+        for(int t=0;t<thread_count;t++)
+            threads.emplace_back([&first,t]
+            {
+                Random &rng=Random::ThisThread();
+
+                CHECK(&rng==&Random::ThisThread());
+                first[t]=rng.NextU64();
+            });
+
+        for(auto &th:threads)th.join();
+
+        std::sort(first.begin(),first.end());
+        CHECK(std::unique(first.begin(),first.end())==first.end());
+
+        //同一种子的子流并行生成，结果与单线程按流生成一致
+        constexpr size_t per_stream=100000;
+        std::vector<float> parallel(per_stream*thread_count),serial(per_stream*thread_count);
+
+        const Random seed(777);
+
+        threads.clear();
+        for(int t=0;t<thread_count;t++)
+            threads.emplace_back([&parallel,&seed,t]
+            {
+                Random r=seed.Stream(t);
+                r.FillFloat(parallel.data()+t*per_stream,per_stream);
+            });
+
+        for(auto &th:threads)th.join();
+
+        for(int t=0;t<thread_count;t++)
+        {
+            Random r=seed.Stream(t);
+            r.FillFloat(serial.data()+t*per_stream,per_stream);
+        }
+
+        CHECK(parallel==serial);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestSequence();
+    TestBatchMatchesScalar();
+    TestStatistics();
+    TestThreads();
+
+    std::cout<<"[RandomTest] All tests passed"<<std::endl;
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+﻿/**
+ * SlabPool 测试
+ *
+ * - 基础分配/释放、Create/Release 构造析构配对
+ * - 跨线程释放、线程退出后缓存归还
+ *
+ * 多线程吞吐量对比见 benchmark/SlabPoolBench.cpp
+ */
+
+#include<hgl/type/SlabPool.h>
+#include<iostream>
+#include<vector>
+#include<thread>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    struct Node
+    {
+        static std::atomic<int> alive;
+
+        int64 key;
+        int64 value;
+        Node *left;
+        Node *right;
+
+        Node():key(0),value(0),left(nullptr),right(nullptr){++alive;}
+        Node(int64 k,int64 v):key(k),value(v),left(nullptr),right(nullptr){++alive;}
+        Node(const Node &n):key(n.key),value(n.value),left(nullptr),right(nullptr){++alive;}
+        ~Node(){--alive;}
+    };
+
+    std::atomic<int> Node::alive{0};
+
+    void TestBasic()
+    {
+        std::cout<<"[TestBasic]"<<std::endl;
+
+        SlabPool<Node> pool(256,32);
+        std::vector<Node *> list;
+
+        for(int i=0;i<1000;i++)
+            list.push_back(pool.Create(i,i*2));
+
+        CHECK(Node::alive==1000);
+
+        for(int i=0;i<1000;i++)
+            CHECK(list[i]->key==i&&list[i]->value==i*2);
+
+        SlabPoolStats stats=pool.GetStats();
+        CHECK(stats.live==1000);
+        CHECK(stats.peak_live==1000);
+        CHECK(stats.peak_handed_out>=stats.peak_live);
+        CHECK(stats.reserved_bytes>=int64(1000*sizeof(Node)));
+
+        Node copy(7,8);
+        Node *p=pool.Create(copy);
+        CHECK(p->key==7&&p->value==8);
+        pool.Release(p);
+
+        for(Node *n:list)
+            pool.Release(n);
+
+        CHECK(Node::alive==1);            //只剩下copy
+        CHECK(pool.GetStats().live==0);
+
+        //归还后的内存应被复用，不应继续增长
+        const int64 slabs=pool.GetStats().slab_count;
+
+        for(int round=0;round<10;round++)
+        {
+            list.clear();
+            for(int i=0;i<1000;i++)list.push_back(pool.Allocate());
+            for(Node *n:list)pool.Deallocate(n);
+        }
+
+        stats=pool.GetStats();
+        CHECK(stats.slab_count==slabs);
+        CHECK(stats.peak_live>=1000&&stats.peak_live<=1001);     //多出的一个是copy
+        std::cout<<"  slabs="<<slabs<<" peak_live="<<stats.peak_live<<" peak_handed_out="<<stats.peak_handed_out<<std::endl;
+    }
+
+    void TestCrossThread()
+    {
+        std::cout<<"[TestCrossThread]"<<std::endl;
+
+        SlabPool<Node> pool(128,16);
+        std::vector<Node *> list(5000);
+
+        std::thread producer([&]
+        {
+            for(auto &n:list)
+                n=pool.Create();
+        });
+        producer.join();
+
+        CHECK(pool.GetStats().live==5000);         //生产线程已退出，计数由退出时归并
+
+        std::thread consumer([&]
+        {
+            for(auto *n:list)
+                pool.Release(n);
+        });
+        consumer.join();
+
+        SlabPoolStats stats=pool.GetStats();
+        CHECK(stats.live==0);
+        CHECK(stats.thread_caches==0);
+        CHECK(stats.depot_free==stats.slab_count*pool.GetObjectsPerSlab());
+        CHECK(Node::alive==0);
+    }
+
+    void TestPoolReuse()
+    {
+        std::cout<<"[TestPoolReuse]"<<std::endl;
+
+        //池反复创建销毁时槽位会复用，线程缓存需要识别出旧池遗留的缓存
+        for(int i=0;i<8;i++)
+        {
+            SlabPool<Node> pool(64,8);
+
+            Node *n=pool.Create(i,i);
+            CHECK(n->key==i);
+            pool.Release(n);
+            CHECK(pool.GetStats().live==0);
+        }
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestBasic();
+    TestCrossThread();
+    TestPoolReuse();
+
+    std::cout<<"[SlabPoolTest] All tests passed"<<std::endl;
+    return 0;
+}
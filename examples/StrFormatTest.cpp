@@ -0,0 +1,281 @@
+﻿/**
+ * strfmt 格式化输出测试（性能对比见 benchmark/StrFormatBench.cpp）
+ *
+ * 1.整数/字符/布尔/浮点/字符串/指针各种格式说明的输出
+ * 2.宽度、对齐、填充、符号、前缀、精度
+ * 3.与snprintf逐一对比随机整数和浮点数的输出
+ * 4.缓冲区不足时截断、长度计算、FormatBuffer扩容
+ * 5.wchar_t/char16_t
+ */
+
+#include<hgl/type/Str.Format.h>
+#include<iostream>
+#include<string>
+#include<string_view>
+#include<random>
+#include<cstdio>
+#include<cstdlib>
+#include<cstring>
+#include<cmath>
+#include<limits>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    enum class Level:int8
+    {
+        Info=1,
+        Error=-2
+    };
+
+    /**
+     * 格式化到固定缓冲区并与期望结果比较，同时核对strfmt_length
+     */
+    template<typename ...Args>
+    bool Check(const char *expect,FormatString<char,Args...> fmt,const Args &...args)
+    {
+        char buf[1024];
+
+        const int len=strfmt(buf,int(sizeof(buf)),fmt,args...);
+
+        if(len!=int(strlen(expect))||strcmp(buf,expect)!=0)
+        {
+            std::cout<<"  mismatch: got \""<<buf<<"\" expect \""<<expect<<"\""<<std::endl;
+            return(false);
+        }
+
+        return strfmt_length(fmt,args...)==size_t(len);
+    }
+
+    void TestInteger()
+    {
+        std::cout<<"[TestInteger]"<<std::endl;
+
+        CHECK(Check("0",                       "{}",0));
+        CHECK(Check("-123 456",                "{} {}",-123,456u));
+        CHECK(Check("-9223372036854775808",    "{}",std::numeric_limits<int64>::min()));
+        CHECK(Check("18446744073709551615",    "{}",std::numeric_limits<uint64>::max()));
+        CHECK(Check("-128 255",                "{} {}",int8(-128),uint8(255)));
+        CHECK(Check("ff FF 0xff 0XFF",         "{:x} {:X} {:#x} {:#X}",255,255,255,255));
+        CHECK(Check("17 017 101 0b101 0B101",  "{:o} {:#o} {:b} {:#b} {:#B}",15,15,5,5,5));
+        CHECK(Check("-0x10",                   "{:#x}",-16));
+        CHECK(Check("+5 -5  5",                "{:+} {:+} {: }",5,-5,5));
+        CHECK(Check("   42|42   | 42 ",        "{:5}|{:<5}|{:^4}",42,42,42));
+        CHECK(Check("*42**",                   "{:*^5}",42));
+        CHECK(Check("00042 -0042 +0x02a",      "{:05} {:05} {:+#06x}",42,-42,42));
+        CHECK(Check("   -42",                  "{:>06}",-42));          //指定对齐时忽略0
+        CHECK(Check("1 -2",                    "{} {}",Level::Info,Level::Error));
+        CHECK(Check("7",                       "{:d}",7ll));
+    }
+
+    void TestCharBool()
+    {
+        std::cout<<"[TestCharBool]"<<std::endl;
+
+        CHECK(Check("a|a  |  a|65|0x41",       "{}|{:<3}|{:>3}|{:d}|{:#x}",'a','a','a','A','A'));
+        CHECK(Check("true false",              "{} {:s}",true,false));
+        CHECK(Check("1 0 true ",               "{:d} {:d} {:5}",true,false,true));
+    }
+
+    void TestFloat()
+    {
+        std::cout<<"[TestFloat]"<<std::endl;
+
+        CHECK(Check("0.1 0.1",                 "{} {}",0.1,0.1f));             //最短往返表示，float不会扩展成double的尾数
+        CHECK(Check("1e+20 1.5 -0",            "{} {} {}",1e20,1.5,-0.0));
+        CHECK(Check("3.142 3.14159 3.141593",  "{:.3f} {:.5f} {:f}",3.14159265,3.14159265,3.14159265));
+        CHECK(Check("1.235e+03 1.235E+03",     "{:.3e} {:.3E}",1234.56,1234.56));
+        CHECK(Check("1.23e+06 0.0001",         "{:.3g} {:g}",1234567.0,0.0001));
+        CHECK(Check("3.14",                    "{:.3}",3.14159));
+        CHECK(Check("inf -inf nan INF",        "{} {} {} {:F}",HUGE_VAL,-HUGE_VAL,std::nan(""),HUGE_VAL));
+        CHECK(Check("  1.50|-001.50|+1.5",     "{:6.2f}|{:07.2f}|{:+}",1.5,-1.5,1.5));
+        CHECK(Check("   inf",                  "{:06}",HUGE_VAL));              //非有限值不补0
+        CHECK(Check("2.5",                     "{}",2.5L));
+    }
+
+    void TestString()
+    {
+        std::cout<<"[TestString]"<<std::endl;
+
+        const char *cstr="hello";
+        char array[16]="array";
+        const std::string str="string";
+        const std::string_view sv("view-of-text",4);
+        const char *null_str=nullptr;
+
+        CHECK(Check("hello array string view", "{} {} {} {}",cstr,array,str,sv));
+        CHECK(Check("lit",                     "{}","lit"));
+        CHECK(Check("[]",                      "[{}]",null_str));
+        CHECK(Check("hel|hello     |   hello|  hello   ","{:.3}|{:10}|{:>8}|{:^10}",cstr,cstr,cstr,cstr));
+        CHECK(Check("==hello==",               "{:=^9s}",cstr));
+        CHECK(Check("{} {x} }{",               "{{}} {{{}}} }}{{",'x'));
+        CHECK(Check("no args",                 "no args"));
+        CHECK(Check("",                        ""));
+    }
+
+    void TestPointer()
+    {
+        std::cout<<"[TestPointer]"<<std::endl;
+
+        const int value=0;
+        char expect[64];
+
+        snprintf(expect,sizeof(expect),"0x%llx",(unsigned long long)reinterpret_cast<std::uintptr_t>(&value));
+
+        CHECK(Check(expect,"{}",&value));
+        CHECK(Check("0x0 0x0","{} {:p}",nullptr,static_cast<void *>(nullptr)));
+        CHECK(Check("   0x10","{:>7}",reinterpret_cast<const void *>(std::uintptr_t(16))));
+    }
+
+    /**
+     * 随机数值与snprintf逐一对比
+     */
+    void TestAgainstPrintf()
+    {
+        std::cout<<"[TestAgainstPrintf]"<<std::endl;
+
+        std::mt19937_64 rng(11);
+
+        char a[512],b[512];
+
+        for(int i=0;i<200000;i++)
+        {
+            const int64 iv=int64(rng())>>(rng()%64);
+            const uint64 uv=rng()>>(rng()%64);
+
+            strfmt(a,sizeof(a),"{} {} {:x} {:#X} {:o} {:+08}",iv,uv,uv,uv,uv,int32(iv));
+            snprintf(b,sizeof(b),"%lld %llu %llx %#llX %llo %+08d",(long long)iv,(unsigned long long)uv,(unsigned long long)uv,(unsigned long long)uv,(unsigned long long)uv,int32(iv));
+
+            if(uv==0)                                   //printf的%#X对0不加前缀
+                snprintf(b,sizeof(b),"%lld 0 0 0X0 0 %+08d",(long long)iv,int32(iv));
+
+            CHECK(strcmp(a,b)==0);
+
+            uint64 bits=rng();
+            double dv;
+            memcpy(&dv,&bits,sizeof(dv));
+
+            if(!std::isfinite(dv)||std::fabs(dv)>1e200)
+                dv=double(int64(bits))/double(1ll<<(rng()%60));
+
+            strfmt(a,sizeof(a),"{:.6e} {:.10g} {:g} {:12.3f} {:.0f} {:+.17g}",dv,dv,dv,dv,dv,dv);
+            snprintf(b,sizeof(b),"%.6e %.10g %g %12.3f %.0f %+.17g",dv,dv,dv,dv,dv,dv);
+            CHECK(strcmp(a,b)==0);
+
+            //最短表示可以无损读回
+            strfmt(a,sizeof(a),"{}",dv);
+            CHECK(strtod(a,nullptr)==dv);
+        }
+    }
+
+    void TestTruncate()
+    {
+        std::cout<<"[TestTruncate]"<<std::endl;
+
+        char buf[8];
+        memset(buf,'#',sizeof(buf));
+
+        int len=strfmt(buf,8,"{}-{}",1234,5678);                   //需要9个字符
+        CHECK(len==-1);
+        CHECK(strcmp(buf,"1234-56")==0);
+
+        len=strfmt(buf,8,"{}",1234567);
+        CHECK(len==7);
+        CHECK(strcmp(buf,"1234567")==0);
+
+        len=strfmt(buf,1,"{}",5);
+        CHECK(len==-1);
+        CHECK(buf[0]==0);
+
+        len=strfmt(buf,0,"{}",5);
+        CHECK(len==-1);
+        len=strfmt<char>(nullptr,8,"x");
+        CHECK(len==-1);
+
+        CHECK(strfmt_length("{:>100}",1)==100);
+        CHECK(strfmt_length("{} {}",std::string(1000,'x'),-1)==1003);
+
+        //固定缓冲区继续追加时计算完整长度
+        char small[4];
+        FormatSink<char> sink(small,sizeof(small));
+
+        strfmt(sink,"{}{}",12,345);
+        sink.Terminate();
+        CHECK(sink.IsTruncated()&&sink.GetLength()==3&&sink.GetTotalLength()==5);
+        CHECK(strcmp(small,"123")==0);
+    }
+
+    void TestBuffer()
+    {
+        std::cout<<"[TestBuffer]"<<std::endl;
+
+        FormatBuffer<char,16> fb;
+        std::string expect;
+
+        for(int i=0;i<1000;i++)
+        {
+            strfmt(fb,"[{}:{:.2f}]",i,i*0.5);
+
+            char tmp[64];
+            snprintf(tmp,sizeof(tmp),"[%d:%.2f]",i,i*0.5);
+            expect+=tmp;
+        }
+
+        CHECK(!fb.IsTruncated());
+        CHECK(fb.GetLength()==expect.size());
+        CHECK(fb.GetCapacity()>=expect.size());
+        CHECK(expect==fb.c_str());
+        CHECK(fb.GetView()==expect);
+
+        fb.Clear();
+        strfmt(fb,"{}","again");
+        CHECK(fb.GetView()=="again");
+
+        //单次写入超过倍增容量
+        FormatBuffer<char,8> big;
+        const std::string long_text(5000,'z');
+
+        strfmt(big,"<{}>",long_text);
+        CHECK(big.GetLength()==5002&&big.GetView().substr(1,5000)==long_text);
+    }
+
+    void TestWide()
+    {
+        std::cout<<"[TestWide]"<<std::endl;
+
+        wchar_t wbuf[128];
+
+        int len=strfmt(wbuf,128,L"{} {:x} {:.2f} {} {:>4}",-12,255u,2.5,L"wide",L'c');
+        CHECK(len==21);
+        CHECK(wcscmp(wbuf,L"-12 ff 2.50 wide    c")==0);
+
+        char16_t ubuf[64];
+        const char16_t expect[]=u"n=42 s=中文 1e+10";
+
+        len=strfmt(ubuf,64,u"n={} s={} {}",42,u"中文",1e10);
+        CHECK(len==int(std::char_traits<char16_t>::length(expect)));
+        CHECK(std::u16string_view(ubuf)==expect);
+
+        CHECK(strfmt_length<wchar_t>(L"{:08.3f}",-1.0)==8);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestInteger();
+    TestCharBool();
+    TestFloat();
+    TestString();
+    TestPointer();
+    TestAgainstPrintf();
+    TestTruncate();
+    TestBuffer();
+    TestWide();
+
+    std::cout<<"[StrFormatTest] All tests passed"<<std::endl;
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+﻿/**
+ * StringPool 字符串驻留池测试
+ *
+ * 1.基本功能：句柄稳定、相同内容句柄相同、Find不插入、缓存的哈希与ComputeOptimalHash一致
+ * 2.多种字符类型
+ * 3.多线程并发驻留同一批字符串，所有线程得到的句柄必须一致
+ *
+ * 名称比较与查表的性能对比见 benchmark/StringPoolBench.cpp
+ */
+
+#include<hgl/type/StringPool.h>
+#include<iostream>
+#include<vector>
+#include<string>
+#include<thread>
+#include<cstring>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    std::string MakeName(uint32 i)
+    {
+        return "material/asset_"+std::to_string(i*2654435761u)+".mat";
+    }
+
+    void TestBasic()
+    {
+        std::cout<<"[TestBasic]"<<std::endl;
+
+        StringPool<char> pool;
+
+        const StringHandle a=pool.Intern("diffuse");
+        const StringHandle b=pool.Intern(std::string_view("normal"));
+        const char text[]="xxdiffusexx";
+        const StringHandle c=pool.Intern(text+2,7);
+
+        CHECK(a&&b);
+        CHECK(a==c);
+        CHECK(a!=b);
+        CHECK(pool.Get(a)=="diffuse");
+        CHECK(std::strcmp(pool.c_str(b),"normal")==0);
+        CHECK(pool.GetLength(a)==7);
+        CHECK(pool.GetHash(a)==ComputeOptimalHash("diffuse",7));
+        CHECK(pool.GetHash(a)==OptimalStringHash<char>()("diffuse"));
+
+        //空字符串与空句柄
+        const StringHandle empty_handle=pool.Intern("");
+        const StringHandle null_handle=pool.Intern(nullptr);
+        CHECK(!empty_handle&&!null_handle);
+        CHECK(pool.Get(StringHandle{}).empty());
+        CHECK(*pool.c_str(StringHandle{})==0);
+        CHECK(pool.GetHash(StringHandle{})==0);
+
+        //Find不插入
+        CHECK(pool.Find("normal")==b);
+        CHECK(!pool.Find("specular"));
+        CHECK(pool.GetCount()==2);
+
+        //大量插入后原有句柄与地址保持不变
+        const char *addr=pool.c_str(a);
+        std::vector<StringHandle> handles;
+
+        for(uint32 i=0;i<100000;i++)
+            handles.push_back(pool.Intern(MakeName(i)));
+
+        CHECK(pool.c_str(a)==addr);
+        CHECK(pool.Get(a)=="diffuse");
+
+        for(uint32 i=0;i<100000;i++)
+        {
+            const StringHandle again=pool.Intern(MakeName(i));
+
+            CHECK(pool.Get(handles[i])==MakeName(i));
+            CHECK(again==handles[i]);
+        }
+
+        //超过arena块大小的长字符串
+        const std::string big(200000,'z');
+        const StringHandle hb=pool.Intern(big);
+        const StringHandle hb_again=pool.Intern(big);
+        CHECK(pool.Get(hb)==big);
+        CHECK(hb_again==hb);
+
+        const StringPoolStats st=pool.GetStats();
+
+        CHECK(st.string_count==100003);
+        CHECK(st.arena_used<=st.arena_reserved);
+        CHECK(st.shard_count==16);
+
+        std::cout<<"  strings "<<st.string_count<<", chars "<<st.char_bytes/1024<<" KB, arena "<<st.arena_used/1024
+                 <<"/"<<st.arena_reserved/1024<<" KB in "<<st.arena_blocks<<" blocks, index "<<st.index_bytes/1024<<" KB"<<std::endl;
+
+        //句柄可直接作为哈希表键
+        HashMap<StringHandle,int> by_name;
+        by_name[a]=1;
+        by_name[b]=2;
+        const StringHandle normal=pool.Intern("normal");
+        CHECK(by_name.find(normal)->second==2);
+    }
+
+    /**
+     * 伪造或其它池的句柄不能越界读取
+     */
+    void TestInvalidHandle()
+    {
+        std::cout<<"[TestInvalidHandle]"<<std::endl;
+
+        StringPool<char,0> single;                                      //无分片时局部序号占满32位
+        const StringHandle h=single.Intern("only");
+
+        for(const uint32 id:{0xFFFFFFFFu,0xFFFFFC00u,0x80000000u,h.id+1})
+        {
+            const StringHandle forged{id};
+
+            CHECK(single.Get(forged).empty());
+            CHECK(*single.c_str(forged)==0);
+            CHECK(single.GetLength(forged)==0);
+            CHECK(single.GetHash(forged)==0);
+        }
+
+        StringPool<char> pool;
+        const StringHandle forged{0xFFFFFFFFu};
+
+        CHECK(pool.Get(forged).empty()&&pool.GetHash(forged)==0);
+        CHECK(single.Get(h)=="only");
+    }
+
+    template<typename CharT>
+    void TestCharType(const CharT *s1,const CharT *s2)
+    {
+        StringPool<CharT,2> pool(1024);
+
+        const StringHandle h1=pool.Intern(s1);
+        const StringHandle h2=pool.Intern(s2);
+        const StringHandle h1_again=pool.Intern(std::basic_string<CharT>(s1));
+
+        CHECK(h1!=h2);
+        CHECK(h1_again==h1);
+        CHECK(pool.Get(h2)==std::basic_string_view<CharT>(s2));
+        CHECK(pool.GetHash(h1)==OptimalStringHash<CharT>()(s1));
+        CHECK(pool.GetStats().shard_count==4);
+    }
+
+    void TestCharTypes()
+    {
+        std::cout<<"[TestCharTypes]"<<std::endl;
+
+        TestCharType<char>("纹理","网格");
+        TestCharType<wchar_t>(L"纹理",L"网格");
+        TestCharType<char16_t>(u"纹理",u"网格");
+        TestCharType<char32_t>(U"纹理",U"网格");
+        TestCharType<char8_t>(u8"纹理",u8"网格");
+    }
+
+    void TestThreads()
+    {
+        std::cout<<"[TestThreads]"<<std::endl;
+
+        constexpr uint32 thread_count=8;
+        constexpr uint32 name_count=16384;                         //2的幂，奇数步长可遍历全部名称
+
+        StringPool<char> pool;
+        std::vector<std::string> names(name_count);
+
+        for(uint32 i=0;i<name_count;i++)
+            names[i]=MakeName(i);
+
+        std::vector<std::vector<StringHandle>> result(thread_count,std::vector<StringHandle>(name_count));
+        std::vector<std::thread> threads;
+
+        for(uint32 t=0;t<thread_count;t++)
+        {
+            threads.emplace_back([&,t]()
+            {
+                //每个线程以不同顺序驻留，同时读取刚得到的句柄
+                for(uint32 k=0;k<name_count;k++)
+                {
+                    const uint32 i=(k*(t*2+1)+t*977)%name_count;
+                    const StringHandle h=pool.Intern(names[i]);
+
+                    result[t][i]=h;
+
+                    if(pool.GetLength(h)!=names[i].size())
+                        std::abort();
+                }
+            });
+        }
+
+        for(auto &th:threads)
+            th.join();
+
+        for(uint32 t=1;t<thread_count;t++)
+            CHECK(result[t]==result[0]);
+
+        for(uint32 i=0;i<name_count;i++)
+            CHECK(pool.Get(result[0][i])==names[i]);
+
+        CHECK(pool.GetCount()==name_count);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestBasic();
+    TestCharTypes();
+    TestInvalidHandle();
+    TestThreads();
+
+    std::cout<<"[StringPoolTest] All tests passed"<<std::endl;
+
+    return 0;
+}
@@ -0,0 +1,340 @@
+﻿/**
+ * 同步原语测试
+ *
+ * 1.FutexMutex/TicketLock 互斥正确性、TryLock
+ * 2.SeqLock 读者永远读到完整的一份数据
+ * 3.Semaphore 计数、超时、生产者/消费者
+ * 4.EventCount 配合无锁计数器阻塞等待，超时
+ *
+ * 1~64线程争用下与 pthread_mutex_t/pthread_rwlock_t/sem_t 的性能对比见 benchmark/SyncPrimitiveBench.cpp
+ */
+
+#include<hgl/thread/FutexMutex.h>
+#include<hgl/thread/TicketLock.h>
+#include<hgl/thread/SeqLock.h>
+#include<hgl/thread/Semaphore.h>
+#include<hgl/thread/EventCount.h>
+#include<iostream>
+#include<vector>
+#include<thread>
+#include<mutex>
+#include<chrono>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    template<typename F>
+    void RunThreads(int count,F &&f)
+    {
+        std::vector<std::thread> threads;
+
+        for(int i=0;i<count;i++)
+            threads.emplace_back([&f,i]{f(i);});
+
+        for(auto &t:threads)
+            t.join();
+    }
+
+    template<typename L>
+    void TestLock(const char *name)
+    {
+        std::cout<<"[TestLock] "<<name<<std::endl;
+
+        L lock;
+
+        bool locked=lock.TryLock();
+        CHECK(locked);
+        CHECK(lock.IsLocked());
+        locked=lock.TryLock();
+        CHECK(!locked);
+        lock.Unlock();
+        CHECK(!lock.IsLocked());
+
+        {
+            std::lock_guard<L> guard(lock);
+            CHECK(lock.IsLocked());
+        }
+        CHECK(!lock.IsLocked());
+
+        constexpr int THREADS=8;
+        constexpr int64 PER_THREAD=20000;
+
+        int64 counter=0;                                            //非原子，由锁保护
+        int64 check[2]={0,0};
+
+        RunThreads(THREADS,[&](int id)
+        {
+            for(int64 i=0;i<PER_THREAD;i++)
+            {
+                if((i&7)==0&&lock.TryLock())
+                {
+                    ++counter;
+                    lock.Unlock();
+                    continue;
+                }
+
+                std::lock_guard<L> guard(lock);
+
+                ++counter;
+                check[id&1]+=1;
+                check[id&1]-=1;
+            }
+        });
+
+        CHECK(counter==THREADS*PER_THREAD);
+        CHECK(check[0]==0&&check[1]==0);
+    }
+
+    struct Triple
+    {
+        uint64 a,b,c;
+        uint32 d;
+    };
+
+    void TestSeqLock()
+    {
+        std::cout<<"[TestSeqLock]"<<std::endl;
+
+        SeqLock<Triple> sl;
+
+        Triple t=sl.Load();
+        CHECK(t.a==0&&t.b==0&&t.c==0&&t.d==0);
+
+        sl.Store({1,2,3,4});
+        t=sl.Load();
+        CHECK(t.a==1&&t.b==2&&t.c==3&&t.d==4);
+        CHECK(sl.GetVersion()==1);
+
+        sl.Update([](Triple &v){v.a+=10;v.d=99;});
+        t=sl.Load();
+        CHECK(t.a==11&&t.b==2&&t.d==99&&sl.GetVersion()==2);
+
+        //两个写者、三个读者，读者检查 b==a*2、c==a*3、d==a低32位
+        constexpr uint64 WRITES=50000;
+
+        std::atomic<bool> writing{true};
+        std::atomic<int64> reads{0};
+
+        sl.Store({0,0,0,0});
+
+        std::thread readers[3];
+
+        for(auto &r:readers)
+            r=std::thread([&]
+            {
+                uint64 last=0;
+
+                while(writing.load(std::memory_order_relaxed))
+                {
+                    const Triple v=sl.Load();
+
+                    CHECK(v.b==v.a*2&&v.c==v.a*3&&v.d==uint32(v.a));
+                    CHECK(v.a>=last);                              //单调：写入的是递增的值
+                    last=v.a;
+
+                    reads.fetch_add(1,std::memory_order_relaxed);
+                }
+            });
+
+        RunThreads(2,[&](int)
+        {
+            for(uint64 i=0;i<WRITES;i++)
+                sl.Update([](Triple &v){++v.a;v.b=v.a*2;v.c=v.a*3;v.d=uint32(v.a);});
+        });
+
+        writing=false;
+
+        for(auto &r:readers)
+            r.join();
+
+        t=sl.Load();
+        CHECK(t.a==WRITES*2&&t.c==WRITES*6);
+        CHECK(reads>0);
+    }
+
+    void TestSemaphore()
+    {
+        std::cout<<"[TestSemaphore]"<<std::endl;
+
+        Semaphore sem(2);
+
+        CHECK(sem.GetCount()==2);
+        bool acquired=sem.TryAcquire();
+        CHECK(acquired);
+        acquired=sem.TryAcquire();
+        CHECK(acquired);
+        acquired=sem.TryAcquire();
+        CHECK(!acquired);
+
+        const auto earliest=std::chrono::steady_clock::now()+std::chrono::milliseconds(15);
+        acquired=sem.Acquire(int64(20000));                         //20ms超时
+        CHECK(!acquired);
+        CHECK(std::chrono::steady_clock::now()>=earliest);
+
+        acquired=sem.Acquire(int64(0));
+        CHECK(!acquired);
+
+        sem.Release(3);
+        CHECK(sem.GetCount()==3);
+        sem.Acquire();
+        acquired=sem.Acquire(int64(1000));
+        CHECK(acquired);
+        CHECK(sem.GetCount()==1);
+        sem.Acquire();
+
+        //一个生产者、四个消费者；最后用 Release(4) 让消费者退出
+        constexpr int ITEMS=20000;
+        constexpr int CONSUMERS=4;
+
+        Semaphore items;
+        std::atomic<int> consumed{0};
+
+        std::vector<std::thread> consumers;
+
+        for(int c=0;c<CONSUMERS;c++)
+            consumers.emplace_back([&]
+            {
+                for(;;)
+                {
+                    items.Acquire();
+
+                    if(consumed.fetch_add(1)>=ITEMS)
+                        return;
+                }
+            });
+
+        for(int i=0;i<ITEMS;i++)
+        {
+            items.Release();
+
+            if((i&1023)==0)
+                std::this_thread::yield();
+        }
+
+        items.Release(CONSUMERS);
+
+        for(auto &c:consumers)
+            c.join();
+
+        CHECK(consumed==ITEMS+CONSUMERS);
+        CHECK(items.GetCount()==0);
+
+        //被阻塞的线程能被唤醒
+        Semaphore gate;
+        std::atomic<bool> passed{false};
+
+        std::thread waiter([&]{gate.Acquire();passed=true;});
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(!passed);
+
+        gate.Release();
+        waiter.join();
+        CHECK(passed);
+    }
+
+    void TestEventCount()
+    {
+        std::cout<<"[TestEventCount]"<<std::endl;
+
+        EventCount ec;
+
+        //超时
+        {
+            const EventCount::Key key=ec.PrepareWait();
+
+            const auto earliest=std::chrono::steady_clock::now()+std::chrono::milliseconds(8);
+            const bool woken=ec.Wait(key,10000);
+            CHECK(!woken);
+            CHECK(std::chrono::steady_clock::now()>=earliest);
+        }
+
+        //PrepareWait 之后的 Notify 不会丢失
+        {
+            const EventCount::Key key=ec.PrepareWait();
+
+            ec.NotifyOne();
+            ec.Wait(key);                                           //立即返回
+        }
+
+        //无锁计数器当作队列：生产者加1后通知，消费者用CAS取走，取不到时等待
+        constexpr int ITEMS=20000;
+        constexpr int CONSUMERS=3;
+
+        std::atomic<int> available{0};
+        std::atomic<int> taken{0};
+        std::atomic<bool> done{false};
+
+        auto try_take=[&]
+        {
+            int v=available.load(std::memory_order_acquire);
+
+            while(v>0)
+                if(available.compare_exchange_weak(v,v-1,std::memory_order_acquire))
+                    return true;
+
+            return false;
+        };
+
+        std::vector<std::thread> consumers;
+
+        for(int c=0;c<CONSUMERS;c++)
+            consumers.emplace_back([&]
+            {
+                for(;;)
+                {
+                    if(try_take())
+                    {
+                        taken.fetch_add(1);
+                        continue;
+                    }
+
+                    if(done.load(std::memory_order_acquire)&&available.load()==0)
+                        return;
+
+                    const EventCount::Key key=ec.PrepareWait();
+
+                    if(available.load()>0||done.load())
+                    {
+                        ec.CancelWait();
+                        continue;
+                    }
+
+                    ec.Wait(key);
+                }
+            });
+
+        for(int i=0;i<ITEMS;i++)
+        {
+            available.fetch_add(1,std::memory_order_release);
+            ec.NotifyOne();
+
+            if((i&1023)==0)
+                std::this_thread::yield();
+        }
+
+        done=true;
+        ec.NotifyAll();
+
+        for(auto &c:consumers)
+            c.join();
+
+        CHECK(taken==ITEMS);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestLock<FutexMutex>("FutexMutex");
+    TestLock<TicketLock>("TicketLock");
+    TestSeqLock();
+    TestSemaphore();
+    TestEventCount();
+
+    std::cout<<"[SyncPrimitiveTest] All tests passed"<<std::endl;
+
+    return 0;
+}
@@ -0,0 +1,365 @@
+﻿/**
+ * 工作窃取任务调度器测试
+ *
+ * 1.WorkStealingDeque 单线程语义与多线程窃取（每个元素恰好被取出一次）
+ * 2.任务提交/等待、依赖（菱形）、后续任务、任务中创建任务
+ * 3.ParallelFor 的单元素与区间两种写法、嵌套、无工作线程
+ * 4.CPU绑定/NUMA配置
+ *
+ * ColorFormat/Str.NumberArray 现有批量函数按区间并行的性能见 benchmark/TaskSchedulerBench.cpp
+ */
+
+#include<hgl/thread/TaskScheduler.h>
+#include<iostream>
+#include<vector>
+#include<array>
+
+#include"TestCheck.h"
+
+using namespace hgl;
+
+namespace
+{
+    void TestDeque()
+    {
+        std::cout<<"[TestDeque]"<<std::endl;
+
+        WorkStealingDeque<int64> dq(4);
+        int64 v;
+
+        CHECK(dq.GetCapacity()==16);
+        bool popped_any=dq.Pop(v);
+        bool stolen_any=dq.Steal(v);
+        CHECK(!popped_any&&!stolen_any);
+
+        for(int64 i=0;i<100;i++)                                    //超过容量，自动扩容
+            dq.Push(i);
+
+        CHECK(dq.GetCount()==100&&dq.GetCapacity()==128);
+
+        popped_any=dq.Pop(v);
+        CHECK(popped_any&&v==99);                                   //底部后进先出
+        stolen_any=dq.Steal(v);
+        CHECK(stolen_any&&v==0);                                    //顶部先进先出
+        CHECK(dq.GetCount()==98);
+
+        //所有者一边压入一边弹出，三个线程窃取，每个值恰好取出一次
+        constexpr int64 COUNT=200000;
+
+        WorkStealingDeque<int64> shared;
+        std::vector<std::atomic<uint8>> seen(COUNT);
+        std::atomic<bool> producing{true};
+        std::atomic<int64> stolen{0};
+
+        std::vector<std::thread> thieves;
+
+        for(int t=0;t<3;t++)
+            thieves.emplace_back([&]
+            {
+                int64 x;
+
+                while(producing.load(std::memory_order_acquire)||!shared.IsEmpty())
+                {
+                    if(shared.Steal(x))
+                    {
+                        seen[x].fetch_add(1,std::memory_order_relaxed);
+                        stolen.fetch_add(1,std::memory_order_relaxed);
+                    }
+                    else
+                        std::this_thread::yield();
+                }
+            });
+
+        int64 popped=0;
+
+        for(int64 i=0;i<COUNT;i++)
+        {
+            shared.Push(i);
+
+            if((i%3)==0&&shared.Pop(v))
+            {
+                seen[v].fetch_add(1,std::memory_order_relaxed);
+                ++popped;
+            }
+        }
+
+        while(shared.Pop(v))
+        {
+            seen[v].fetch_add(1,std::memory_order_relaxed);
+            ++popped;
+        }
+
+        producing.store(false,std::memory_order_release);
+
+        for(auto &t:thieves)
+            t.join();
+
+        CHECK(popped+stolen.load()==COUNT);
+
+        for(auto &s:seen)
+            CHECK(s.load()==1);
+    }
+
+    void TestTasks(TaskScheduler &ts)
+    {
+        std::cout<<"[TestTasks] workers="<<ts.GetWorkerCount()<<std::endl;
+
+        //提交与等待
+        std::atomic<int> value{0};
+
+        TaskRef a=ts.Run([&]{value.fetch_add(1);});
+        bool ok=ts.Wait(a);
+        CHECK(ok&&a.IsDone()&&value==1);
+        ok=ts.Submit(a);                                            //不能重复提交
+        CHECK(!ok);
+
+        TaskRef none;
+        ok=ts.Wait(none);
+        CHECK(!ok);
+
+        TaskRef unsubmitted=ts.Create([&]{value.fetch_add(100);});
+        ok=ts.Wait(unsubmitted);
+        CHECK(!ok&&!unsubmitted.IsDone());
+
+        //菱形依赖：top -> left,right -> bottom
+        std::vector<int> order;
+        std::mutex order_lock;
+        auto log=[&](int id){std::lock_guard<std::mutex> lock(order_lock);order.push_back(id);};
+
+        TaskRef top   =ts.Create([&]{log(0);});
+        TaskRef left  =ts.Create([&]{log(1);});
+        TaskRef right =ts.Create([&]{log(2);});
+        TaskRef bottom=ts.Create([&]{log(3);});
+
+        ok=ts.AddDependency(top,left);
+        CHECK(ok);
+        ok=ts.AddDependency(top,right);
+        CHECK(ok);
+        ok=ts.AddDependency(left,bottom);
+        CHECK(ok);
+        ok=ts.AddDependency(right,bottom);
+        CHECK(ok);
+        ok=ts.AddDependency(top,top);
+        CHECK(!ok);
+
+        ts.Submit(bottom);                                          //提交顺序与执行顺序无关
+        ts.Submit(left);
+        ts.Submit(right);
+        CHECK(!bottom.IsDone());
+        ts.Submit(top);
+
+        ok=ts.AddDependency(top,left);                              //left已提交
+        CHECK(!ok);
+
+        ts.Wait(bottom);
+        CHECK(order.size()==4&&order.front()==0&&order.back()==3);
+
+        //对已完成任务设置依赖：立即满足
+        TaskRef after_done=ts.Create([&]{value.fetch_add(10);});
+        ok=ts.AddDependency(top,after_done);
+        CHECK(ok);
+        ts.Submit(after_done);
+        ts.Wait(after_done);
+        CHECK(value==11);
+
+        //前置任务未提交就被释放：已提交与之后提交的后续任务都被取消，不执行但视为完成，取消沿依赖链传递
+        std::atomic<int> cancelled_runs{0};
+        TaskRef orphan,orphan_tail,late;
+
+        {
+            TaskRef never=ts.Create([&]{cancelled_runs.fetch_add(1);});
+
+            orphan=ts.Then(never,[&]{cancelled_runs.fetch_add(1);});
+            orphan_tail=ts.Then(orphan,[&]{cancelled_runs.fetch_add(1);});
+
+            late=ts.Create([&]{cancelled_runs.fetch_add(1);});
+            ok=ts.AddDependency(never,late);
+            CHECK(ok);
+        }
+
+        ok=ts.Submit(late);
+        CHECK(ok);
+
+        ts.WaitAll();                                               //不会因为计数泄漏而卡住
+
+        ok=ts.Wait(orphan_tail);
+        CHECK(ok&&orphan.IsDone()&&orphan_tail.IsDone()&&late.IsDone());
+        CHECK(orphan.IsCancelled()&&orphan_tail.IsCancelled()&&late.IsCancelled());
+        CHECK(cancelled_runs==0);
+        CHECK(!a.IsCancelled());
+
+        //后续任务链
+        int64 chain=0;
+        TaskRef c=ts.Run([&]{chain=1;});
+
+        for(int i=0;i<100;i++)
+            c=ts.Then(c,[&]{chain=chain*3%1000003;});
+
+        ts.Wait(c);
+
+        int64 expect=1;
+        for(int i=0;i<100;i++)expect=expect*3%1000003;
+        CHECK(chain==expect);
+
+        //任务中创建并等待子任务
+        std::atomic<int64> sum{0};
+
+        TaskRef parent=ts.Run([&]
+        {
+            std::vector<TaskRef> children;
+
+            for(int i=1;i<=64;i++)
+                children.push_back(ts.Run([&sum,i]{sum.fetch_add(i);}));
+
+            for(auto &ch:children)
+                ts.Wait(ch);
+        });
+
+        ts.Wait(parent);
+        CHECK(sum==64*65/2);
+
+        //大的可调用对象放在堆上
+        std::array<int64,16> big{};
+        for(int i=0;i<16;i++)big[i]=i;
+
+        std::atomic<int64> big_sum{0};
+        TaskRef bt=ts.Run([big,&big_sum]{int64 s=0;for(auto x:big)s+=x;big_sum=s;});
+        ts.Wait(bt);
+        CHECK(big_sum==120);
+
+        //WaitAll
+        std::atomic<int> n{0};
+        for(int i=0;i<1000;i++)
+            ts.Run([&]{n.fetch_add(1);});
+
+        ts.WaitAll();
+        CHECK(n==1000);
+    }
+
+    void TestParallelFor(TaskScheduler &ts)
+    {
+        std::cout<<"[TestParallelFor] workers="<<ts.GetWorkerCount()<<std::endl;
+
+        constexpr int64 N=100003;
+
+        std::vector<int64> data(N,0);
+
+        //单元素写法
+        ts.ParallelFor(0,N,[&](int64 i){data[i]+=i;});
+
+        for(int64 i=0;i<N;i++)
+            CHECK(data[i]==i);
+
+        //区间写法，指定粒度
+        std::atomic<int64> calls{0};
+
+        ts.ParallelFor(0,N,[&](int64 b,int64 e)
+        {
+            CHECK(e-b>=1&&e-b<=1000);
+            calls.fetch_add(1);
+
+            for(int64 i=b;i<e;i++)
+                data[i]*=2;
+        },1000);
+
+        CHECK(calls>=(N+999)/1000);
+
+        for(int64 i=0;i<N;i++)
+            CHECK(data[i]==i*2);
+
+        //空区间与单元素
+        ts.ParallelFor(5,5,[&](int64){CHECK(false);});
+        ts.ParallelFor(7,8,[&](int64 i){data[i]=-1;});
+        CHECK(data[7]==-1);
+
+        //嵌套
+        constexpr int ROWS=64,COLS=257;
+        std::vector<int> grid(ROWS*COLS,0);
+
+        ts.ParallelFor(0,ROWS,[&](int64 r)
+        {
+            ts.ParallelFor(0,COLS,[&](int64 c){grid[r*COLS+c]=int(r*COLS+c);},16);
+        },1);
+
+        for(int i=0;i<ROWS*COLS;i++)
+            CHECK(grid[i]==i);
+    }
+
+    void TestConfig()
+    {
+        std::cout<<"[TestConfig]"<<std::endl;
+
+        //没有工作线程：全部在调用线程执行
+        {
+            TaskScheduler::Config cfg;
+            cfg.worker_count=0;
+
+            TaskScheduler ts(cfg);
+
+            CHECK(ts.GetWorkerCount()==0&&ts.GetCurrentWorkerIndex()==-1);
+
+            TestTasks(ts);
+            TestParallelFor(ts);
+        }
+
+        //多个工作线程（可能多于CPU数）
+        {
+            TaskScheduler::Config cfg;
+            cfg.worker_count=4;
+
+            TaskScheduler ts(cfg);
+
+            std::atomic<int> inside{-2};
+            TaskRef probe=ts.Run([&]{inside=ts.GetCurrentWorkerIndex();});
+
+            while(!probe.IsDone())                                  //不用Wait，以免调用线程自己执行
+                std::this_thread::yield();
+
+            CHECK(inside>=0&&inside<4);
+
+            TestTasks(ts);
+            TestParallelFor(ts);
+        }
+
+        //绑定CPU与NUMA
+        {
+            TaskScheduler::Config cfg;
+            cfg.worker_count=3;
+            cfg.pin_threads=true;
+            cfg.numa_aware=true;
+
+            TaskScheduler ts(cfg);
+
+            std::cout<<"  numa nodes: "<<ts.GetNumaNodeCount()<<", worker cpu:";
+
+            for(int i=0;i<ts.GetWorkerCount();i++)
+                std::cout<<" "<<ts.GetWorkerCpu(i)<<"(node "<<ts.GetWorkerNumaNode(i)<<")";
+
+            std::cout<<std::endl;
+
+        #ifdef __linux__
+            for(int i=0;i<ts.GetWorkerCount();i++)
+                CHECK(ts.GetWorkerCpu(i)>=0&&ts.GetWorkerNumaNode(i)>=0);
+        #endif//__linux__
+
+            TestParallelFor(ts);
+        }
+
+        //默认调度器
+        std::atomic<int64> s{0};
+        parallel_for(0,1000,[&](int64 i){s.fetch_add(i);});
+        CHECK(s==999*1000/2);
+    }
+}//namespace
+
+int main(int,char **)
+{
+    TestDeque();
+    TestTasks(TaskScheduler::Default());
+    TestParallelFor(TaskScheduler::Default());
+    TestConfig();
+
+    std::cout<<"[TaskSchedulerTest] All tests passed"<<std::endl;
+
+    return 0;
+}
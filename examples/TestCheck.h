@@ -0,0 +1,15 @@
+﻿#pragma once
+
+#include<iostream>
+#include<cstdlib>
+
+/**
+ * 示例程序共用的检查宏
+ *
+ * 与assert不同，NDEBUG下同样生效：条件不成立时输出条件文本与行号，然后abort。
+ * 有副作用的调用要先单独执行，再用CHECK检查其结果。
+ */
+#define CHECK(cond) do { if(!(cond)) { \
+    std::cerr << "CHECK failed: " #cond " (at line " << __LINE__ << ")" << std::endl; \
+    std::abort(); \
+} } while(0)
@@ -131,13 +131,24 @@ namespace
     void TestComputeOptimalHash()
     {
         int v = 12345;
-        uint64 hv = ComputeOptimalHash(v);
+        uint64 hv = ComputeOptimalHash<HashMixPolicy::Identity>(v);
         ExpectEqual(hv, static_cast<uint64>(v), "Integral identity");
 
         void *p = reinterpret_cast<void *>(0x12345678);
-        uint64 hp = ComputeOptimalHash(p);
+        uint64 hp = ComputeOptimalHash<HashMixPolicy::Identity>(p);
         ExpectEqual(hp, reinterpret_cast<uint64>(p), "Pointer identity");
 
+        // 默认混合：不再是原值，且确定性
+        ExpectNotEqual(ComputeOptimalHash(v), static_cast<uint64>(v), "Integral mixed");
+        ExpectEqual(ComputeOptimalHash(v), ComputeOptimalHash<HashMixPolicy::WyMix>(v), "Default policy is WyMix");
+        ExpectEqual(ComputeOptimalHash(v), HashMix64(static_cast<uint64>(v)), "Integral mix matches HashMix64");
+        ExpectNotEqual(ComputeOptimalHash(p), reinterpret_cast<uint64>(p), "Pointer mixed");
+        ExpectEqual(ComputeOptimalHash<HashMixPolicy::Murmur>(uint64(0x12345678)), ComputeOptimalHash<HashMixPolicy::Murmur>(p), "Pointer and integer mix alike");
+        ExpectNotEqual(ComputeOptimalHash<HashMixPolicy::Murmur>(v), ComputeOptimalHash<HashMixPolicy::WyMix>(v), "Policies differ");
+
+        // MurmurHash3 fmix64 参考值
+        ExpectEqual(HashMix64<HashMixPolicy::Murmur>(1), 0xb456bcfc34c2cb2cull, "fmix64(1)");
+
         struct POD
         {
             int a;
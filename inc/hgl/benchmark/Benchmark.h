@@ -0,0 +1,299 @@
+﻿#pragma once
+
+#include<hgl/time/TscClock.h>
+#include<vector>
+#include<string>
+
+#if defined(_MSC_VER)&&!defined(__clang__)
+    #include<intrin.h>
+#endif
+
+/**
+ * 微基准测试框架
+ *
+ *     void BM_Copy(hgl::BenchmarkState &state)
+ *     {
+ *         std::vector<int> src(state.GetArg()),dst(state.GetArg());       //准备数据，不计时
+ *
+ *         for(auto _:state)                                                //计时循环，次数由框架自动确定
+ *         {
+ *             memcpy(dst.data(),src.data(),src.size()*sizeof(int));
+ *             hgl::ClobberMemory();
+ *         }
+ *
+ *         state.SetBytesProcessed(src.size()*sizeof(int));                 //每次迭代处理的字节数
+ *     }
+ *
+ *     HGL_BENCHMARK(BM_Copy)->Arg(1024)->Arg(65536);
+ *
+ *     HGL_BENCHMARK_MAIN();
+ *
+ * 每个测试先用递增的迭代次数预热并确定单次运行的迭代数（约 min_time 毫秒），
+ * 再重复运行若干次，报告每次迭代耗时的中位数、中位数绝对偏差(MAD)与最小值。
+ * Linux上可用 perf_event_open 时同时读取CPU周期、指令数、分支预测失败数。
+ *
+ * 命令行参数：
+ *     --filter=子串          只运行名称包含子串的测试
+ *     --min_time=毫秒        单次运行的目标时长（默认50）
+ *     --repetitions=N        重复次数（默认5）
+ *     --json=文件名          结果另存为JSON，用于回归对比
+ *     --no_perf              不读取性能计数器
+ *     --large                同时运行由 LargeArgs() 标记的大参数（如GB级缓冲区）
+ *     --list                 只列出测试名称
+ */
+
+namespace hgl
+{
+    /**
+     * 阻止编译器把value的计算优化掉（值被视为已被读取）
+     */
+    template<typename T>
+    inline void DoNotOptimize(const T &value)
+    {
+#if defined(_MSC_VER)&&!defined(__clang__)
+        const volatile char *p=reinterpret_cast<const volatile char *>(&value);
+        (void)*p;
+        _ReadWriteBarrier();
+#else
+        asm volatile("":: "r,m"(value):"memory");
+#endif
+    }
+
+    /**
+     * 阻止编译器把value的计算优化掉，并假定value之后可能被修改
+     */
+    template<typename T>
+    inline void DoNotOptimize(T &value)
+    {
+#if defined(_MSC_VER)&&!defined(__clang__)
+        volatile char *p=reinterpret_cast<volatile char *>(&value);
+        *p=*p;
+        _ReadWriteBarrier();
+#else
+    #if defined(__clang__)
+        asm volatile("":"+r,m"(value)::"memory");
+    #else
+        asm volatile("":"+m,r"(value)::"memory");
+    #endif
+#endif
+    }
+
+    /**
+     * 强制之前的内存写入在此完成（编译器屏障）
+     */
+    inline void ClobberMemory()
+    {
+#if defined(_MSC_VER)&&!defined(__clang__)
+        _ReadWriteBarrier();
+#else
+        asm volatile("":::"memory");
+#endif
+    }
+
+    class BenchmarkPerfCounters;
+
+    /**
+     * 传给测试函数的运行状态
+     */
+    class BenchmarkState
+    {
+    public:
+
+        static constexpr int PERF_COUNTER_COUNT=3;                  ///<周期、指令、分支预测失败
+
+    private:
+
+        uint64 iterations;
+        int64 arg;
+
+        uint64 bytes_per_iteration=0;
+        uint64 items_per_iteration=0;
+        std::string label;
+
+        BenchmarkPerfCounters *perf;
+
+        uint64 start_ticks=0;
+        uint64 elapsed_ticks=0;
+        uint64 perf_start[PERF_COUNTER_COUNT]={};
+        uint64 perf_elapsed[PERF_COUNTER_COUNT]={};
+        bool running=false;
+
+        friend class BenchmarkRunner;
+
+    public:
+
+        struct [[maybe_unused]] Value{};                            ///<for(auto _:state) 中的 _，不会产生未使用变量警告
+
+        struct Iterator
+        {
+            uint64 remaining;
+            BenchmarkState *state;
+
+            bool operator!=(const Iterator &)
+            {
+                if(remaining)
+                    return(true);
+
+                state->PauseTiming();
+                return(false);
+            }
+
+            void operator++(){--remaining;}
+            Value operator*()const{return {};}
+        };
+
+        BenchmarkState(uint64 n,int64 a,BenchmarkPerfCounters *pc):iterations(n),arg(a),perf(pc){}
+
+        NO_COPY_NO_MOVE(BenchmarkState)
+
+        Iterator begin(){ResumeTiming();return {iterations,this};}
+        Iterator end(){return {0,this};}
+
+        uint64  GetIterations()const{return iterations;}
+        int64   GetArg()const{return arg;}                          ///<由 Arg() 注册的参数，没有时为0
+
+        void PauseTiming();                                         ///<暂停计时（如每次迭代都要重新准备数据时）
+        void ResumeTiming();
+
+        void SetBytesProcessed(const uint64 n){bytes_per_iteration=n;}     ///<每次迭代处理的字节数，用于计算吞吐量与周期/字节
+        void SetItemsProcessed(const uint64 n){items_per_iteration=n;}     ///<每次迭代处理的条目数
+        void SetLabel(const std::string &str){label=str;}
+    };//class BenchmarkState
+
+    using BenchmarkFunc=void(*)(BenchmarkState &);
+
+    /**
+     * 注册的测试
+     */
+    class BenchmarkInfo
+    {
+        std::string name;
+        BenchmarkFunc func;
+        std::vector<int64> args;
+        int64 large_arg=0;                                          ///<>0时参数>=此值的运行需要 --large
+
+        friend class BenchmarkRunner;
+
+    public:
+
+        BenchmarkInfo(const char *n,BenchmarkFunc f):name(n),func(f){}
+
+        NO_COPY_NO_MOVE(BenchmarkInfo)
+
+        /**
+         * 增加一组参数，每个参数单独运行一次，名称为 "name/arg"
+         */
+        BenchmarkInfo *Arg(const int64 a){args.push_back(a);return this;}
+
+        /**
+         * 从start到limit（含）每次乘以multiplier
+         */
+        BenchmarkInfo *Range(int64 start,const int64 limit,const int64 multiplier=8)
+        {
+            if(start<=0||multiplier<2)
+                return this;
+
+            for(;start<=limit;start*=multiplier)
+                args.push_back(start);
+
+            return this;
+        }
+
+        /**
+         * 参数>=min_arg的运行占用大量内存或时间，默认不运行，指定 --large 时才运行
+         */
+        BenchmarkInfo *LargeArgs(const int64 min_arg){large_arg=min_arg;return this;}
+    };//class BenchmarkInfo
+
+    /**
+     * 登记测试（通常通过 HGL_BENCHMARK 在静态初始化时调用）
+     */
+    BenchmarkInfo *RegisterBenchmark(const char *name,BenchmarkFunc func);
+
+    /**
+     * 单个测试（含参数）的结果
+     */
+    struct BenchmarkResult
+    {
+        std::string name;
+        std::string label;
+
+        uint64 iterations;                                          ///<每次运行的迭代数
+        int repetitions;
+
+        double median_ns;                                           ///<每次迭代耗时
+        double mad_ns;                                              ///<中位数绝对偏差
+        double min_ns;
+        double mean_ns;
+
+        double bytes_per_second;                                    ///<没有设置 SetBytesProcessed 时为0
+        double items_per_second;
+
+        bool   hardware_cycles;                                     ///<cycles来自性能计数器；否则为时间戳计数器
+        double cycles_per_iteration;
+        double cycles_per_byte;                                     ///<没有设置 SetBytesProcessed 时为0
+        double instructions_per_iteration;                          ///<没有性能计数器时为0
+        double branch_misses_per_iteration;
+    };//struct BenchmarkResult
+
+    /**
+     * 运行已登记的测试
+     */
+    class BenchmarkRunner
+    {
+    public:
+
+        struct Config
+        {
+            std::string filter;
+            double min_time_ms=50;
+            int repetitions=5;
+            std::string json_file;
+            bool use_perf=true;
+            bool list_only=false;
+            bool large=false;                                       ///<运行 LargeArgs() 标记的参数
+        };
+
+    private:
+
+        Config config;
+
+        BenchmarkResult Run(const BenchmarkInfo *,const std::string &name,int64 arg,BenchmarkPerfCounters *);
+
+    public:
+
+        BenchmarkRunner()=default;
+        explicit BenchmarkRunner(const Config &c):config(c){}
+
+        const Config &GetConfig()const{return config;}
+
+        /**
+         * 解析命令行参数
+         * @return 遇到无法识别的参数返回false
+         */
+        bool ParseArgs(int argc,char **argv);
+
+        /**
+         * 运行所有匹配的测试，结果输出到stdout
+         */
+        std::vector<BenchmarkResult> RunAll();
+
+        /**
+         * 结果转为JSON
+         */
+        static std::string ToJson(const std::vector<BenchmarkResult> &);
+    };//class BenchmarkRunner
+
+    /**
+     * 解析命令行、运行全部测试，可选输出JSON
+     * @return 进程返回值
+     */
+    int RunBenchmarks(int argc,char **argv);
+}//namespace hgl
+
+#define HGL_BENCHMARK_CONCAT_INNER(a,b) a##b
+#define HGL_BENCHMARK_CONCAT(a,b)       HGL_BENCHMARK_CONCAT_INNER(a,b)
+
+#define HGL_BENCHMARK(func)     [[maybe_unused]] static hgl::BenchmarkInfo *HGL_BENCHMARK_CONCAT(hgl_benchmark_,__LINE__)=hgl::RegisterBenchmark(#func,func)
+
+#define HGL_BENCHMARK_MAIN()    int main(int argc,char **argv){return hgl::RunBenchmarks(argc,argv);}
@@ -0,0 +1,297 @@
+﻿#pragma once
+
+#include<hgl/type/Str.Format.h>
+#include<hgl/thread/SPSCByteRing.h>
+#include<hgl/time/TscClock.h>
+#include<atomic>
+#include<utility>
+
+/**
+ * 异步日志
+ *
+ *     HGL_LOG_INFO("request {} from {}:{} took {:.3f} ms",id,host,port,ms);
+ *
+ * 格式串在编译期解析并检查参数类型（与strfmt相同），每个调用位置生成一份静态的 LogSite。
+ * 调用线程只把 LogSite 指针、时间戳和参数的原始值写入本线程的无锁环形缓冲区，
+ * 格式化与写出全部由后台线程完成：按时间戳合并各线程的记录、批量格式化后一次写出到 ByteSink（如 FdByteSink）。
+ *
+ * 缓冲区写满时按 LogConfig::overflow 处理：丢弃（计数，由后台线程输出丢弃条数）或等待后台线程腾出空间。
+ */
+
+namespace hgl
+{
+    class ByteSink;
+
+    enum class LogLevel:uint8
+    {
+        Trace,
+        Debug,
+        Info,
+        Warning,
+        Error,
+        Fatal,
+        Off,                ///<仅用于设置级别，关闭所有输出
+
+        BEGIN_RANGE =Trace,
+        END_RANGE   =Off,
+        RANGE_SIZE  =END_RANGE-BEGIN_RANGE+1
+    };
+
+    /**
+     * 线程缓冲区写满时的处理方式
+     */
+    enum class LogOverflowPolicy:uint8
+    {
+        Drop,               ///<丢弃新记录并计数，调用线程永不等待
+        Block,              ///<唤醒后台线程并等待空间（退避，最终让出时间片）
+
+        BEGIN_RANGE =Drop,
+        END_RANGE   =Block,
+        RANGE_SIZE  =END_RANGE-BEGIN_RANGE+1
+    };
+
+    /**
+     * 日志调用位置的静态描述，由 HGL_LOG 在编译期生成
+     */
+    struct LogSite
+    {
+        LogLevel                level;
+        const char *            file;
+        int                     line;
+        FormatView<char>        format;
+        const FormatArgType *   arg_types;                          ///<format.count个
+    };//struct LogSite
+
+    struct LogConfig
+    {
+        ByteSink *          sink                =nullptr;           ///<输出目标（不转移所有权，Stop前必须有效）
+        LogLevel            level               =LogLevel::Info;
+        LogOverflowPolicy   overflow            =LogOverflowPolicy::Drop;
+        uint32              thread_buffer_size  =256*1024;          ///<每个线程的环形缓冲区字节数（线程第一次写日志时分配，之后不再改变）
+        uint32              flush_interval_us   =1000;              ///<后台线程空闲时的最长等待时间
+        uint32              batch_size          =64*1024;           ///<输出累积到此字节数即写出
+        bool                source_location     =false;             ///<行尾附加 (文件:行号)
+    };//struct LogConfig
+
+    namespace log_detail
+    {
+        constexpr size_t MAX_ARGS           =32;                    ///<单条日志最多参数个数
+        constexpr uint32 MAX_STRING_LENGTH  =1024;                  ///<字符串参数最多记录的字节数，超出部分截断
+
+        /**
+         * 环形缓冲区中一条记录的开头，其后依次是各参数的原始值
+         */
+        struct RecordHeader
+        {
+            const LogSite * site;
+            uint64          ticks;                                  ///<TscClock::Now()
+        };
+
+        struct ThreadBuffer
+        {
+            SPSCByteRing        ring;
+            std::atomic<uint64> dropped{0};                         ///<只由所属线程增加
+            std::atomic<bool>   retired{false};                     ///<所属线程已退出
+            uint64              thread_id;
+            uint64              reported_dropped=0;                 ///<后台线程已输出过的丢弃数
+
+            explicit ThreadBuffer(size_t size):ring(size){}
+        };
+
+        inline std::atomic<uint8> min_level{uint8(LogLevel::Off)}; ///<未Start时为Off，调用只是一次读取
+        inline thread_local ThreadBuffer *tls_buffer=nullptr;
+
+        ThreadBuffer *RegisterThread();
+        void *ReserveSlow(ThreadBuffer *,size_t);
+        void Wake();
+
+        inline bool IsEnabled(const LogLevel level)
+        {
+            return uint8(level)>=min_level.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * 复制字符串参数<br>
+         * 日志中的字符串通常只有几到几十字节，用8字节块加重叠尾部内联复制，避免调用memcpy的固定开销
+         */
+        inline void CopyString(uint8 *dst,const char *src,const size_t n)
+        {
+            if(n>=8)
+            {
+                for(size_t i=0;i+8<n;i+=8)
+                    memcpy(dst+i,src+i,8);
+
+                memcpy(dst+n-8,src+n-8,8);
+            }
+            else if(n>=4)
+            {
+                memcpy(dst,src,4);
+                memcpy(dst+n-4,src+n-4,4);
+            }
+            else
+            {
+                for(size_t i=0;i<n;i++)
+                    dst[i]=uint8(src[i]);
+            }
+        }
+
+        /**
+         * 各类参数在记录中占用的字节数
+         */
+        template<FormatArgType TYPE>
+        inline size_t ArgSize(const FormatArg<char> &arg)
+        {
+            if constexpr(TYPE==FormatArgType::Bool||TYPE==FormatArgType::Char)  return 1;
+            else if constexpr(TYPE==FormatArgType::Float)                       return sizeof(float);
+            else if constexpr(TYPE==FormatArgType::String)                      return sizeof(uint32)+(arg.s.length<MAX_STRING_LENGTH?arg.s.length:MAX_STRING_LENGTH);
+            else                                                                return 8;
+        }
+
+        template<FormatArgType TYPE>
+        inline uint8 *EncodeArg(uint8 *p,const FormatArg<char> &arg)
+        {
+            if constexpr(TYPE==FormatArgType::Bool)     {*p=arg.b?1:0;                  return p+1;}
+            else if constexpr(TYPE==FormatArgType::Char){*p=uint8(arg.c);               return p+1;}
+            else if constexpr(TYPE==FormatArgType::Int) {memcpy(p,&arg.i,8);            return p+8;}
+            else if constexpr(TYPE==FormatArgType::UInt){memcpy(p,&arg.u,8);            return p+8;}
+            else if constexpr(TYPE==FormatArgType::Float){memcpy(p,&arg.f,sizeof(float));return p+sizeof(float);}
+            else if constexpr(TYPE==FormatArgType::Double){memcpy(p,&arg.d,8);          return p+8;}
+            else if constexpr(TYPE==FormatArgType::Pointer)
+            {
+                const uint64 v=uint64(reinterpret_cast<std::uintptr_t>(arg.p));
+
+                memcpy(p,&v,8);
+                return p+8;
+            }
+            else
+            {
+                const uint32 len=uint32(arg.s.length<MAX_STRING_LENGTH?arg.s.length:MAX_STRING_LENGTH);
+
+                memcpy(p,&len,sizeof(uint32));
+                CopyString(p+sizeof(uint32),arg.s.str,len);
+                return p+sizeof(uint32)+len;
+            }
+        }
+
+        template<typename ...Args,size_t ...I>
+        inline void WriteRecord(const LogSite &site,const uint64 ticks,const FormatArg<char> *list,std::index_sequence<I...>)
+        {
+            [[maybe_unused]] constexpr FormatArgType types[]={format_detail::GetFormatArgType<char,Args>()...,FormatArgType::None};
+
+            ThreadBuffer *tb=tls_buffer;
+
+            if(!tb)
+            {
+                tb=RegisterThread();
+
+                if(!tb)
+                    return;
+            }
+
+            const size_t size=sizeof(RecordHeader)+(size_t(0)+...+ArgSize<types[I]>(list[I]));
+
+            uint8 *p=static_cast<uint8 *>(tb->ring.Reserve(size));
+
+            if(!p)
+            {
+                p=static_cast<uint8 *>(ReserveSlow(tb,size));
+
+                if(!p)
+                    return;
+            }
+
+            const RecordHeader header{&site,ticks};
+
+            memcpy(p,&header,sizeof(RecordHeader));
+            p+=sizeof(RecordHeader);
+
+            ((p=EncodeArg<types[I]>(p,list[I])),...);
+
+            tb->ring.Commit();
+
+            //平时由后台线程定时取走；错误级别或缓冲区过半时立即唤醒
+            if(site.level>=LogLevel::Error||tb->ring.IsHalfFull())
+                Wake();
+        }
+
+        /**
+         * 每个调用位置（Tag）与参数类型组合一份的静态数据
+         */
+        template<typename Tag,typename ...Args> struct SiteHolder
+        {
+            static constexpr BasicFormatString<char,Args...> format{Tag::Format()};
+            static constexpr FormatArgType types[sizeof...(Args)+1]={format_detail::GetFormatArgType<char,Args>()...,FormatArgType::None};
+            static constexpr LogSite site{Tag::Level(),Tag::File(),Tag::Line(),format.GetView(),types};
+        };
+
+        template<typename Tag,typename ...Args>
+        inline void Write(const Args &...args)
+        {
+            static_assert(sizeof...(Args)<=MAX_ARGS,"too many log arguments");
+
+            const uint64 ticks=TscClock::Now();
+            const FormatArg<char> list[sizeof...(Args)+1]={format_detail::MakeFormatArg<char>(args)...};
+
+            WriteRecord<std::remove_cvref_t<Args>...>(SiteHolder<Tag,std::remove_cvref_t<Args>...>::site,ticks,list,std::index_sequence_for<Args...>{});
+        }
+    }//namespace log_detail
+
+    /**
+     * 异步日志的全局控制
+     */
+    class AsyncLog
+    {
+    public:
+
+        /**
+         * 启动后台线程
+         * @return 已经启动或未指定输出目标时返回false
+         */
+        static bool Start(const LogConfig &);
+
+        /**
+         * 输出所有已记录的内容后停止后台线程<br>
+         * 调用时其它线程应已停止写日志，之后的调用被忽略。
+         */
+        static void Stop();
+
+        /**
+         * 等待调用之前各线程已写入的记录全部写出
+         */
+        static void Flush();
+
+        static bool IsRunning();
+
+        static void SetLevel(LogLevel);
+        static LogLevel GetLevel();
+
+        static uint64 GetWrittenCount();                           ///<已写出的记录数
+        static uint64 GetDroppedCount();                           ///<因缓冲区已满或记录过长而丢弃的记录数
+    };//class AsyncLog
+}//namespace hgl
+
+/**
+ * 写一条日志，level须为常量，fmt须为字符串字面量
+ */
+#define HGL_LOG(log_level,fmt,...)  do                                                                      \
+                                    {                                                                       \
+                                        if(hgl::log_detail::IsEnabled(log_level))                           \
+                                        {                                                                   \
+                                            struct hgl_log_tag                                              \
+                                            {                                                               \
+                                                static constexpr hgl::LogLevel Level(){return log_level;}   \
+                                                static constexpr const auto &Format(){return fmt;}          \
+                                                static constexpr const char *File(){return __FILE__;}       \
+                                                static constexpr int Line(){return __LINE__;}               \
+                                            };                                                              \
+                                                                                                            \
+                                            hgl::log_detail::Write<hgl_log_tag>(__VA_ARGS__);               \
+                                        }                                                                   \
+                                    }while(0)
+
+#define HGL_LOG_TRACE(fmt,...)      HGL_LOG(hgl::LogLevel::Trace,  fmt __VA_OPT__(,) __VA_ARGS__)
+#define HGL_LOG_DEBUG(fmt,...)      HGL_LOG(hgl::LogLevel::Debug,  fmt __VA_OPT__(,) __VA_ARGS__)
+#define HGL_LOG_INFO(fmt,...)       HGL_LOG(hgl::LogLevel::Info,   fmt __VA_OPT__(,) __VA_ARGS__)
+#define HGL_LOG_WARNING(fmt,...)    HGL_LOG(hgl::LogLevel::Warning,fmt __VA_OPT__(,) __VA_ARGS__)
+#define HGL_LOG_ERROR(fmt,...)      HGL_LOG(hgl::LogLevel::Error,  fmt __VA_OPT__(,) __VA_ARGS__)
+#define HGL_LOG_FATAL(fmt,...)      HGL_LOG(hgl::LogLevel::Fatal,  fmt __VA_OPT__(,) __VA_ARGS__)
@@ -0,0 +1,630 @@
+﻿#pragma once
+
+#include<hgl/platform/CpuFeature.h>
+#include<wyhash/wyhash.h>
+#include<atomic>
+#include<chrono>
+#include<cmath>
+
+namespace hgl
+{
+    namespace random_detail
+    {
+        constexpr uint64 WYRAND_INC=0x2d358dccaa6c78a5ull;             ///<wyrand每步增加的常数
+        constexpr uint64 WYRAND_XOR=0x8bb84b93962eacc9ull;
+
+        constexpr uint64 STREAM_STRIDE=uint64(1)<<40;                   ///<每个流可生成的数量，流之间不会重叠
+
+        constexpr float  FLOAT_NORM =1.0f/float(1<<24);
+        constexpr float  GAU_NORM   =1.0f/float(1<<20);
+
+        /**
+         * 取32位随机数的高24位得到[0,1)的float
+         */
+        inline float U32ToFloat(const uint32 r){return float(r>>8)*FLOAT_NORM;}
+
+        /**
+         * 与 wy2u01 结果相同：取高52位作为尾数得到[1,2)，再减1
+         */
+        inline double U64ToDouble(const uint64 r){return wy2u01(r);}
+
+        /**
+         * 以[lo,lo+range)均匀映射32位随机数（Lemire乘法映射，range为0表示2^32）
+         */
+        inline uint32 U32ToRange(const uint32 r,const uint32 range){return range?uint32((uint64(r)*range)>>32):r;}
+
+        //sin(πt)与cos(πt)，|t|<=0.5，泰勒展开到11/12次，误差小于1e-7
+        inline void SinCosPi(const float t,float &s,float &c)
+        {
+            const float x=t*3.14159265358979f;
+            const float x2=x*x;
+
+            s=x*(1.0f+x2*(-1.0f/6+x2*(1.0f/120+x2*(-1.0f/5040+x2*(1.0f/362880+x2*(-1.0f/39916800))))));
+            c=1.0f+x2*(-0.5f+x2*(1.0f/24+x2*(-1.0f/720+x2*(1.0f/40320+x2*(-1.0f/3628800+x2*(1.0f/479001600))))));
+        }
+
+        /**
+         * 近似正态分布：同 wy2gau，三个21位均匀分布之和（均值3*2^20，方差2^40）
+         */
+        inline uint32 GauSum(const uint64 r){return uint32((r&0x1FFFFF)+((r>>21)&0x1FFFFF)+((r>>42)&0x1FFFFF));}
+
+        inline float GauToFloat(const uint64 r,const float mean,const float stddev)
+        {
+            return float(GauSum(r))*(GAU_NORM*stddev)+(mean-3.0f*stddev);
+        }
+
+        /**
+         * 由32位随机数得到单位圆上的点：角度=π*(t+b)，t∈[-0.5,0.5)，b为0或1
+         */
+        inline void UnitCircle(const uint32 r,float &x,float &y)
+        {
+            float s,c;
+
+            SinCosPi(U32ToFloat(r)-0.5f,s,c);
+
+            const float sign=(r&1)?-1.0f:1.0f;
+
+            x=c*sign;
+            y=s*sign;
+        }
+
+        /**
+         * z在[-1,1)均匀分布，再在该高度的圆上取均匀角度（Archimedes），得到单位球面上的均匀分布
+         */
+        inline void UnitSphere(const uint32 rz,const uint32 ra,float &x,float &y,float &z)
+        {
+            float cx,cy;
+
+            z=U32ToFloat(rz)*2.0f-1.0f;
+            UnitCircle(ra,cx,cy);
+
+            const float r=std::sqrt(std::max(0.0f,1.0f-z*z));
+
+            x=cx*r;
+            y=cy*r;
+        }
+
+        //---------------------------------------------------------------------------------------------
+        // 标量批量实现，作为AVX2实现的参考
+        //---------------------------------------------------------------------------------------------
+
+        inline uint64 Next(uint64 &state){return wyrand(&state);}
+
+        inline void FillU64Scalar(uint64 &state,uint64 *out,const size_t n)
+        {
+            for(size_t i=0;i<n;i++)
+                out[i]=Next(state);
+        }
+
+        /**
+         * 每个64位随机数拆成两个32位，n为奇数时最后一个的高32位被丢弃
+         */
+        template<typename F>
+        inline void FillPairScalar(uint64 &state,const size_t n,F &&func)
+        {
+            size_t i=0;
+
+            for(;i+2<=n;i+=2)
+            {
+                const uint64 r=Next(state);
+
+                func(i  ,uint32(r));
+                func(i+1,uint32(r>>32));
+            }
+
+            if(i<n)
+                func(i,uint32(Next(state)));
+        }
+
+#ifdef HGL_SIMD_X86
+        /**
+         * 4路并行的wymix：64x64->128位乘法以4次32位乘法拼出，返回高低64位的异或
+         */
+        HGL_TARGET_ISA("avx2")
+        inline __m256i Mix4(const __m256i s)
+        {
+            const __m256i a=s;
+            const __m256i b=_mm256_xor_si256(s,_mm256_set1_epi64x(int64(WYRAND_XOR)));
+
+            const __m256i a_hi=_mm256_srli_epi64(a,32);
+            const __m256i b_hi=_mm256_srli_epi64(b,32);
+
+            const __m256i ll=_mm256_mul_epu32(a,b);
+            const __m256i lh=_mm256_mul_epu32(a,b_hi);
+            const __m256i hl=_mm256_mul_epu32(a_hi,b);
+            const __m256i hh=_mm256_mul_epu32(a_hi,b_hi);
+
+            const __m256i low32=_mm256_set1_epi64x(0xFFFFFFFF);
+
+            const __m256i mid=_mm256_add_epi64(_mm256_add_epi64(_mm256_srli_epi64(ll,32),_mm256_and_si256(lh,low32)),_mm256_and_si256(hl,low32));
+
+            const __m256i lo=_mm256_or_si256(_mm256_slli_epi64(mid,32),_mm256_and_si256(ll,low32));
+            const __m256i hi=_mm256_add_epi64(_mm256_add_epi64(hh,_mm256_srli_epi64(mid,32)),
+                                              _mm256_add_epi64(_mm256_srli_epi64(lh,32),_mm256_srli_epi64(hl,32)));
+
+            return _mm256_xor_si256(lo,hi);
+        }
+
+        /**
+         * 依次生成4个随机数的状态生成器：第j路的状态为 state+(j+1)*INC，每次前进4*INC
+         */
+        struct Stream4
+        {
+            __m256i s;
+            __m256i step;
+
+            HGL_TARGET_ISA("avx2")
+            explicit Stream4(const uint64 state)
+            {
+                s=_mm256_set_epi64x(int64(state+4*WYRAND_INC),int64(state+3*WYRAND_INC),int64(state+2*WYRAND_INC),int64(state+WYRAND_INC));
+                step=_mm256_set1_epi64x(int64(4*WYRAND_INC));
+            }
+
+            HGL_TARGET_ISA("avx2")
+            __m256i Next()
+            {
+                const __m256i r=Mix4(s);
+                s=_mm256_add_epi64(s,step);
+                return r;
+            }
+        };
+
+        HGL_TARGET_ISA("avx2")
+        inline __m256 U32ToFloat8(const __m256i r)
+        {
+            return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(r,8)),_mm256_set1_ps(FLOAT_NORM));
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline __m256d U64ToDouble4(const __m256i r)
+        {
+            const __m256i bits=_mm256_or_si256(_mm256_srli_epi64(r,12),_mm256_set1_epi64x(0x3FF0000000000000ll));
+
+            return _mm256_sub_pd(_mm256_castsi256_pd(bits),_mm256_set1_pd(1.0));
+        }
+
+        /**
+         * 与 wy2gau 相同：三个21位字段之和，结果在低32位
+         */
+        HGL_TARGET_ISA("avx2")
+        inline __m128i GauSum4(const __m256i r)
+        {
+            const __m256i mask=_mm256_set1_epi64x(0x1FFFFF);
+
+            const __m256i sum=_mm256_add_epi64(_mm256_add_epi64(_mm256_and_si256(r,mask),
+                                                                _mm256_and_si256(_mm256_srli_epi64(r,21),mask)),
+                                                                _mm256_and_si256(_mm256_srli_epi64(r,42),mask));
+
+            return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(sum,_mm256_setr_epi32(0,2,4,6,0,0,0,0)));
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline __m256 MulAdd8(const __m256 a,const __m256 b,const float k)
+        {
+            return _mm256_add_ps(_mm256_mul_ps(a,b),_mm256_set1_ps(k));
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline void SinCosPi8(const __m256 t,__m256 &s,__m256 &c)
+        {
+            const __m256 x=_mm256_mul_ps(t,_mm256_set1_ps(3.14159265358979f));
+            const __m256 x2=_mm256_mul_ps(x,x);
+
+            __m256 ps=_mm256_set1_ps(-1.0f/39916800);
+            ps=MulAdd8(ps,x2, 1.0f/362880);
+            ps=MulAdd8(ps,x2,-1.0f/5040);
+            ps=MulAdd8(ps,x2, 1.0f/120);
+            ps=MulAdd8(ps,x2,-1.0f/6);
+            ps=MulAdd8(ps,x2, 1.0f);
+            s=_mm256_mul_ps(ps,x);
+
+            __m256 pc=_mm256_set1_ps(1.0f/479001600);
+            pc=MulAdd8(pc,x2,-1.0f/3628800);
+            pc=MulAdd8(pc,x2, 1.0f/40320);
+            pc=MulAdd8(pc,x2,-1.0f/720);
+            pc=MulAdd8(pc,x2, 1.0f/24);
+            pc=MulAdd8(pc,x2,-0.5f);
+            c=MulAdd8(pc,x2, 1.0f);
+        }
+
+        /**
+         * 8个单位圆上的点（与 UnitCircle 相同）
+         */
+        HGL_TARGET_ISA("avx2")
+        inline void UnitCircle8(const __m256i r,__m256 &x,__m256 &y)
+        {
+            __m256 s,c;
+
+            SinCosPi8(_mm256_sub_ps(U32ToFloat8(r),_mm256_set1_ps(0.5f)),s,c);
+
+            const __m256 sign=_mm256_castsi256_ps(_mm256_slli_epi32(r,31));       //最低位移到符号位
+
+            x=_mm256_xor_ps(c,sign);
+            y=_mm256_xor_ps(s,sign);
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline void FillU64AVX2(uint64 &state,uint64 *out,const size_t n)
+        {
+            Stream4 st(state);
+            size_t i=0;
+
+            for(;i+4<=n;i+=4)
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out+i),st.Next());
+
+            state+=i*WYRAND_INC;
+
+            FillU64Scalar(state,out+i,n-i);
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline void FillU32AVX2(uint64 &state,uint32 *out,const size_t n)
+        {
+            Stream4 st(state);
+            size_t i=0;
+
+            for(;i+8<=n;i+=8)
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out+i),st.Next());
+
+            state+=(i/2)*WYRAND_INC;
+
+            FillPairScalar(state,n-i,[out=out+i](const size_t k,const uint32 r){out[k]=r;});
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline void FillRangeAVX2(uint64 &state,uint32 *out,const size_t n,const uint32 lo,const uint32 range)
+        {
+            Stream4 st(state);
+            size_t i=0;
+
+            if(range)
+            {
+                const __m256i vr=_mm256_set1_epi32(int(range));
+                const __m256i vlo=_mm256_set1_epi32(int(lo));
+
+                for(;i+8<=n;i+=8)
+                {
+                    const __m256i r=st.Next();
+
+                    //偶数位置：乘积的高32位在64位的高半；奇数位置先右移32位再乘
+                    const __m256i even=_mm256_srli_epi64(_mm256_mul_epu32(r,vr),32);
+                    const __m256i odd=_mm256_mul_epu32(_mm256_srli_epi64(r,32),vr);
+
+                    const __m256i v=_mm256_blend_epi32(even,odd,0xAA);
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out+i),_mm256_add_epi32(v,vlo));
+                }
+            }
+            else
+            {
+                for(;i+8<=n;i+=8)
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out+i),_mm256_add_epi32(st.Next(),_mm256_set1_epi32(int(lo))));
+            }
+
+            state+=(i/2)*WYRAND_INC;
+
+            FillPairScalar(state,n-i,[out=out+i,lo,range](const size_t k,const uint32 r){out[k]=lo+U32ToRange(r,range);});
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline void FillFloatAVX2(uint64 &state,float *out,const size_t n,const float lo,const float scale)
+        {
+            Stream4 st(state);
+            size_t i=0;
+
+            const __m256 vlo=_mm256_set1_ps(lo);
+            const __m256 vscale=_mm256_set1_ps(scale);
+
+            for(;i+8<=n;i+=8)
+                _mm256_storeu_ps(out+i,_mm256_add_ps(_mm256_mul_ps(U32ToFloat8(st.Next()),vscale),vlo));
+
+            state+=(i/2)*WYRAND_INC;
+
+            FillPairScalar(state,n-i,[out=out+i,lo,scale](const size_t k,const uint32 r){out[k]=U32ToFloat(r)*scale+lo;});
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline void FillDoubleAVX2(uint64 &state,double *out,const size_t n,const double lo,const double scale)
+        {
+            Stream4 st(state);
+            size_t i=0;
+
+            const __m256d vlo=_mm256_set1_pd(lo);
+            const __m256d vscale=_mm256_set1_pd(scale);
+
+            for(;i+4<=n;i+=4)
+                _mm256_storeu_pd(out+i,_mm256_add_pd(_mm256_mul_pd(U64ToDouble4(st.Next()),vscale),vlo));
+
+            state+=i*WYRAND_INC;
+
+            for(;i<n;i++)
+                out[i]=U64ToDouble(Next(state))*scale+lo;
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline void FillGaussianAVX2(uint64 &state,float *out,const size_t n,const float mean,const float stddev)
+        {
+            Stream4 st(state);
+            size_t i=0;
+
+            const __m128 vnorm=_mm_set1_ps(GAU_NORM*stddev);           //与 GauToFloat 相同的运算顺序
+            const __m128 vmean=_mm_set1_ps(mean-3.0f*stddev);
+
+            for(;i+4<=n;i+=4)
+            {
+                const __m128 v=_mm_cvtepi32_ps(GauSum4(st.Next()));
+
+                _mm_storeu_ps(out+i,_mm_add_ps(_mm_mul_ps(v,vnorm),vmean));
+            }
+
+            state+=i*WYRAND_INC;
+
+            for(;i<n;i++)
+                out[i]=GauToFloat(Next(state),mean,stddev);
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline void FillUnitVector2AVX2(uint64 &state,float *out,const size_t n)
+        {
+            Stream4 st(state);
+            size_t i=0;
+
+            for(;i+8<=n;i+=8)
+            {
+                __m256 vx,vy;
+
+                UnitCircle8(st.Next(),vx,vy);
+
+                //交错为x,y,x,y...
+                const __m256 lo=_mm256_unpacklo_ps(vx,vy);              //x0y0x1y1 x4y4x5y5
+                const __m256 hi=_mm256_unpackhi_ps(vx,vy);              //x2y2x3y3 x6y6x7y7
+
+                _mm256_storeu_ps(out+i*2  ,_mm256_permute2f128_ps(lo,hi,0x20));
+                _mm256_storeu_ps(out+i*2+8,_mm256_permute2f128_ps(lo,hi,0x31));
+            }
+
+            state+=(i/2)*WYRAND_INC;
+
+            FillPairScalar(state,n-i,[out=out+i*2](const size_t k,const uint32 r){UnitCircle(r,out[k*2],out[k*2+1]);});
+        }
+
+        HGL_TARGET_ISA("avx2")
+        inline void FillUnitVector3AVX2(uint64 &state,float *out,const size_t n)
+        {
+            Stream4 st(state);
+            size_t i=0;
+
+            alignas(32) float x[8],y[8],z[8];
+
+            for(;i+8<=n;i+=8)
+            {
+                //与标量相同：第k个向量用第k个64位随机数，低32位定z，高32位定角度
+                const __m256 a=_mm256_castsi256_ps(st.Next());
+                const __m256 b=_mm256_castsi256_ps(st.Next());
+
+                const __m256i rz=_mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(a,b,_MM_SHUFFLE(2,0,2,0))),_MM_SHUFFLE(3,1,2,0));
+                const __m256i ra=_mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(a,b,_MM_SHUFFLE(3,1,3,1))),_MM_SHUFFLE(3,1,2,0));
+
+                const __m256 vz=_mm256_sub_ps(_mm256_mul_ps(U32ToFloat8(rz),_mm256_set1_ps(2.0f)),_mm256_set1_ps(1.0f));
+
+                __m256 cx,cy;
+                UnitCircle8(ra,cx,cy);
+
+                const __m256 r=_mm256_sqrt_ps(_mm256_max_ps(_mm256_setzero_ps(),_mm256_sub_ps(_mm256_set1_ps(1.0f),_mm256_mul_ps(vz,vz))));
+
+                _mm256_store_ps(x,_mm256_mul_ps(cx,r));
+                _mm256_store_ps(y,_mm256_mul_ps(cy,r));
+                _mm256_store_ps(z,vz);
+
+                float *p=out+i*3;
+
+                for(int k=0;k<8;k++)
+                {
+                    p[k*3  ]=x[k];
+                    p[k*3+1]=y[k];
+                    p[k*3+2]=z[k];
+                }
+            }
+
+            state+=i*WYRAND_INC;                                        //每8个向量用了8个64位随机数
+
+            for(;i<n;i++)
+            {
+                const uint64 r=Next(state);
+
+                UnitSphere(uint32(r),uint32(r>>32),out[i*3],out[i*3+1],out[i*3+2]);
+            }
+        }
+#endif//HGL_SIMD_X86
+    }//namespace random_detail
+
+    /**
+     * 基于wyrand的快速伪随机数生成器（非加密用途）<br>
+     * <ul>
+     *  <li>状态只有64位，wyrand本质上是对计数器的混合，所以 Jump 可以O(1)跳过任意个数</li>
+     *  <li>Stream(i) 得到互不重叠的第i个子流(每个流2^40个数)，用于多线程并行生成可复现的结果</li>
+     *  <li>ThisThread() 取得当前线程独立的生成器</li>
+     *  <li>Fill* 系列批量生成，在支持AVX2的CPU上一次生成4个64位随机数，使用的随机数序列与标量实现相同</li>
+     * </ul>
+     * 批量填充32位数值/float时，每个64位随机数拆成两个使用；Next* 系列每次使用一个完整的64位随机数。
+     */
+    class Random
+    {
+        uint64 state;
+
+    public:
+
+        explicit Random(const uint64 seed=0):state(seed){}
+
+        void SetSeed(const uint64 seed){state=seed;}
+        uint64 GetState()const{return state;}
+
+        /**
+         * 跳过count个64位随机数
+         */
+        void Jump(const uint64 count){state+=count*random_detail::WYRAND_INC;}
+
+        /**
+         * 得到第index个子流，不同子流之间不重叠（各2^40个64位随机数）
+         */
+        Random Stream(const uint64 index)const
+        {
+            Random r(state);
+            r.Jump(index*random_detail::STREAM_STRIDE);
+            return r;
+        }
+
+        /**
+         * 取得当前线程的生成器，各线程依次使用全局种子的不同子流
+         */
+        static Random &ThisThread()
+        {
+            static const uint64 base_seed=wyhash64(uint64(std::chrono::steady_clock::now().time_since_epoch().count()),
+                                                   uint64(reinterpret_cast<uintptr_t>(&base_seed)));
+            static std::atomic<uint64> thread_index{0};
+
+            thread_local Random rng=Random(base_seed).Stream(thread_index.fetch_add(1,std::memory_order_relaxed));
+
+            return rng;
+        }
+
+    public: //单个数值
+
+        uint64 NextU64(){return random_detail::Next(state);}
+        uint32 NextU32(){return uint32(NextU64()>>32);}
+        bool   NextBool(){return NextU64()>>63;}
+
+        /**
+         * [0,bound)之间的整数（Lemire无除法映射，bound为0时返回0）
+         */
+        uint32 NextBelow(const uint32 bound){return uint32((uint64(NextU32())*bound)>>32);}
+
+        /**
+         * [min_value,max_value]之间的整数
+         */
+        int32 NextInt(const int32 min_value,const int32 max_value)
+        {
+            const uint32 range=uint32(max_value)-uint32(min_value)+1;
+
+            return int32(uint32(min_value)+random_detail::U32ToRange(NextU32(),range));
+        }
+
+        float  NextFloat(){return float(NextU64()>>40)*random_detail::FLOAT_NORM;}                             ///<[0,1)
+        double NextDouble(){return random_detail::U64ToDouble(NextU64());}                                      ///<[0,1)
+
+        float  NextFloat(const float min_value,const float max_value){return min_value+NextFloat()*(max_value-min_value);}
+        double NextDouble(const double min_value,const double max_value){return min_value+NextDouble()*(max_value-min_value);}
+
+        /**
+         * 近似正态分布（三个均匀分布之和，同 wy2gau，取值限制在均值±3倍标准差内）
+         */
+        double NextGaussian(const double mean=0,const double stddev=1){return wy2gau(NextU64())*stddev+mean;}
+
+    public: //批量填充
+
+        void FillU64(uint64 *out,const size_t n)
+        {
+#ifdef HGL_SIMD_X86
+            if(GetCpuFeature().avx2){random_detail::FillU64AVX2(state,out,n);return;}
+#endif//HGL_SIMD_X86
+
+            random_detail::FillU64Scalar(state,out,n);
+        }
+
+        void FillU32(uint32 *out,const size_t n)
+        {
+#ifdef HGL_SIMD_X86
+            if(GetCpuFeature().avx2){random_detail::FillU32AVX2(state,out,n);return;}
+#endif//HGL_SIMD_X86
+
+            random_detail::FillPairScalar(state,n,[out](const size_t k,const uint32 r){out[k]=r;});
+        }
+
+        /**
+         * 填充[min_value,max_value]之间的整数
+         */
+        void FillInt(int32 *out,const size_t n,const int32 min_value,const int32 max_value)
+        {
+            const uint32 lo=uint32(min_value);
+            const uint32 range=uint32(max_value)-lo+1;
+            uint32 *u=reinterpret_cast<uint32 *>(out);
+
+#ifdef HGL_SIMD_X86
+            if(GetCpuFeature().avx2){random_detail::FillRangeAVX2(state,u,n,lo,range);return;}
+#endif//HGL_SIMD_X86
+
+            random_detail::FillPairScalar(state,n,[u,lo,range](const size_t k,const uint32 r){u[k]=lo+random_detail::U32ToRange(r,range);});
+        }
+
+        /**
+         * 填充[min_value,max_value)之间均匀分布的float（24位精度）
+         */
+        void FillFloat(float *out,const size_t n,const float min_value=0,const float max_value=1)
+        {
+            const float scale=max_value-min_value;
+
+#ifdef HGL_SIMD_X86
+            if(GetCpuFeature().avx2){random_detail::FillFloatAVX2(state,out,n,min_value,scale);return;}
+#endif//HGL_SIMD_X86
+
+            random_detail::FillPairScalar(state,n,[out,min_value,scale](const size_t k,const uint32 r){out[k]=random_detail::U32ToFloat(r)*scale+min_value;});
+        }
+
+        /**
+         * 填充[min_value,max_value)之间均匀分布的double（52位精度）
+         */
+        void FillDouble(double *out,const size_t n,const double min_value=0,const double max_value=1)
+        {
+            const double scale=max_value-min_value;
+
+#ifdef HGL_SIMD_X86
+            if(GetCpuFeature().avx2){random_detail::FillDoubleAVX2(state,out,n,min_value,scale);return;}
+#endif//HGL_SIMD_X86
+
+            for(size_t i=0;i<n;i++)
+                out[i]=random_detail::U64ToDouble(NextU64())*scale+min_value;
+        }
+
+        /**
+         * 填充近似正态分布的float（同 NextGaussian）
+         */
+        void FillGaussian(float *out,const size_t n,const float mean=0,const float stddev=1)
+        {
+#ifdef HGL_SIMD_X86
+            if(GetCpuFeature().avx2){random_detail::FillGaussianAVX2(state,out,n,mean,stddev);return;}
+#endif//HGL_SIMD_X86
+
+            for(size_t i=0;i<n;i++)
+                out[i]=random_detail::GauToFloat(NextU64(),mean,stddev);
+        }
+
+        /**
+         * 填充n个均匀分布的二维单位向量，按x,y交错存放（out至少2n个float）
+         */
+        void FillUnitVector2(float *out,const size_t n)
+        {
+#ifdef HGL_SIMD_X86
+            if(GetCpuFeature().avx2){random_detail::FillUnitVector2AVX2(state,out,n);return;}
+#endif//HGL_SIMD_X86
+
+            random_detail::FillPairScalar(state,n,[out](const size_t k,const uint32 r){random_detail::UnitCircle(r,out[k*2],out[k*2+1]);});
+        }
+
+        /**
+         * 填充n个均匀分布在单位球面上的三维向量，按x,y,z交错存放（out至少3n个float）
+         */
+        void FillUnitVector3(float *out,const size_t n)
+        {
+#ifdef HGL_SIMD_X86
+            if(GetCpuFeature().avx2){random_detail::FillUnitVector3AVX2(state,out,n);return;}
+#endif//HGL_SIMD_X86
+
+            for(size_t i=0;i<n;i++)
+            {
+                const uint64 r=NextU64();
+
+                random_detail::UnitSphere(uint32(r),uint32(r>>32),out[i*3],out[i*3+1],out[i*3+2]);
+            }
+        }
+    };//class Random
+}//namespace hgl
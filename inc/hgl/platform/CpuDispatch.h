@@ -0,0 +1,93 @@
+﻿#pragma once
+
+#include<hgl/platform/CpuFeature.h>
+#include<atomic>
+
+namespace hgl
+{
+    /**
+     * 按指令集档次分派的函数<br>
+     * 各档次实现放在独立的编译单元中，用该档次的编译开关编译（见src/CMakeLists.txt中的HGL_ISA_*_FLAGS），
+     * 第一次调用时按 GetCpuTier() 选出不高于当前档次的最佳实现并缓存，之后每次调用只是一次原子读取加间接调用。
+     *
+     * 构造函数为constexpr，全局对象在静态初始化阶段即完成，不存在初始化顺序问题。
+     *
+     * 注意：per-ISA编译单元只能导出入口函数，其余代码放在匿名名字空间中。
+     * 内联函数与模板的非内联副本由链接器任选一份，若选中高档次编译的副本，低档次CPU上会执行非法指令。
+     */
+    template<typename F> class CpuDispatch;
+
+    template<typename R,typename ...Args> class CpuDispatch<R(Args...)>
+    {
+    public:
+
+        using Func=R(*)(Args...);
+
+    private:
+
+        Func impl[size_t(CpuTier::RANGE_SIZE)];
+        mutable std::atomic<Func> resolved;
+
+    public:
+
+        /**
+         * @param scalar    基础实现，不可为nullptr
+         * @param sse42     SSE4.2档次实现，nullptr表示沿用更低档次
+         * @param avx2      AVX2档次实现，同上
+         * @param avx512    AVX-512档次实现，同上
+         */
+        constexpr CpuDispatch(Func scalar,Func sse42=nullptr,Func avx2=nullptr,Func avx512=nullptr)
+            :impl{scalar,sse42,avx2,avx512},resolved(nullptr)
+        {
+        }
+
+        NO_COPY_NO_MOVE(CpuDispatch)
+
+        /**
+         * 取得不高于指定档次、且有实现的最高档次
+         */
+        CpuTier Select(const CpuTier tier)const
+        {
+            size_t t=size_t(tier);
+
+            while(t>0&&!impl[t])
+                --t;
+
+            return CpuTier(t);
+        }
+
+        /**
+         * 取得指定档次下使用的实现（测试时可直接比较各档次结果）
+         */
+        Func Get(const CpuTier tier)const
+        {
+            return impl[size_t(Select(tier))];
+        }
+
+        /**
+         * 当前CPU下实际使用的档次
+         */
+        CpuTier GetTier()const
+        {
+            return Select(GetCpuTier());
+        }
+
+        Func Resolve()const
+        {
+            const Func f=Get(GetCpuTier());
+
+            resolved.store(f,std::memory_order_relaxed);                //并发首次调用写入的是同一个值
+            return f;
+        }
+
+        R operator()(Args ...args)const
+        {
+            Func f=resolved.load(std::memory_order_relaxed);
+
+            if(!f)
+                f=Resolve();
+
+            return f(args...);
+        }
+    };//template<typename R,typename ...Args> class CpuDispatch<R(Args...)>
+}//namespace hgl
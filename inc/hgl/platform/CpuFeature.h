@@ -0,0 +1,283 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<cstdlib>
+
+#if HGL_CPU==HGL_CPU_X86_64||HGL_CPU==HGL_CPU_X86_32
+    #define HGL_SIMD_X86                                                        ///<可以使用x86 SIMD内部函数（运行时检测后调用）
+    #include<immintrin.h>
+    #if defined(_MSC_VER)&&!defined(__clang__)
+        #include<intrin.h>
+    #else
+        #include<cpuid.h>
+    #endif
+#endif
+
+/**
+ * 为单个函数开启指定指令集（GCC/Clang），调用前必须用 GetCpuFeature() 确认CPU支持。
+ * MSVC不需要开关即可使用内部函数，宏为空。
+ */
+#if defined(_MSC_VER)&&!defined(__clang__)
+    #define HGL_TARGET_ISA(isa)
+#else
+    #define HGL_TARGET_ISA(isa)     __attribute__((target(isa)))
+#endif
+
+namespace hgl
+{
+    /**
+     * 运行时检测到的CPU指令集支持情况
+     */
+    struct CpuFeature
+    {
+        bool ssse3;
+        bool sse41;
+        bool sse42;
+        bool popcnt;
+        bool avx;                   ///<含操作系统对YMM寄存器的支持，下同
+        bool avx2;
+        bool fma;
+        bool f16c;
+        bool bmi1;
+        bool bmi2;
+        bool avx512f;               ///<含操作系统对ZMM/k寄存器的支持，下同
+        bool avx512bw;
+        bool avx512dq;
+        bool avx512vl;
+        bool sha;
+    };//struct CpuFeature
+
+    /**
+     * 指令集档次，per-ISA编译单元按档次划分（对应x86-64-v1~v4）
+     */
+    enum class CpuTier
+    {
+        Scalar,         ///<基础指令集(x86-64为SSE2)
+        SSE42,          ///<SSSE3+SSE4.1+SSE4.2+POPCNT
+        AVX2,           ///<AVX+AVX2+FMA+F16C+BMI1+BMI2
+        AVX512,         ///<AVX512F+BW+DQ+VL
+
+        BEGIN_RANGE =Scalar,
+        END_RANGE   =AVX512,
+        RANGE_SIZE  =END_RANGE-BEGIN_RANGE+1
+    };
+
+    constexpr const char *CPU_TIER_NAME[size_t(CpuTier::RANGE_SIZE)]=
+    {
+        "scalar",
+        "sse42",
+        "avx2",
+        "avx512"
+    };
+
+    inline const char *GetCpuTierName(const CpuTier tier)
+    {
+        return CPU_TIER_NAME[size_t(tier)];
+    }
+
+    namespace cpu_detail
+    {
+#ifdef HGL_SIMD_X86
+        inline void CpuId(uint32 r[4],const uint32 leaf,const uint32 sub)
+        {
+    #if defined(_MSC_VER)&&!defined(__clang__)
+            int v[4];
+
+            __cpuidex(v,int(leaf),int(sub));
+
+            for(int i=0;i<4;i++)
+                r[i]=uint32(v[i]);
+    #else
+            __cpuid_count(leaf,sub,r[0],r[1],r[2],r[3]);
+    #endif
+        }
+
+        /**
+         * 读取XCR0（操作系统在上下文切换时保存的寄存器组），调用前必须确认OSXSAVE
+         */
+        inline uint64 ReadXCR0()
+        {
+    #if defined(_MSC_VER)&&!defined(__clang__)
+            return _xgetbv(0);
+    #else
+            uint32 lo,hi;
+
+            __asm__ volatile("xgetbv":"=a"(lo),"=d"(hi):"c"(0));
+
+            return (uint64(hi)<<32)|lo;
+    #endif
+        }
+#endif//HGL_SIMD_X86
+
+        inline CpuFeature DetectCpuFeature()
+        {
+            CpuFeature cf{};
+
+#ifdef HGL_SIMD_X86
+            uint32 r[4];
+
+            CpuId(r,0,0);
+            const uint32 max_leaf=r[0];
+
+            CpuId(r,1,0);
+            cf.ssse3 =(r[2]&(1u<<9))!=0;
+            cf.sse41 =(r[2]&(1u<<19))!=0;
+            cf.sse42 =(r[2]&(1u<<20))!=0;
+            cf.popcnt=(r[2]&(1u<<23))!=0;
+
+            const bool osxsave=(r[2]&(1u<<27))!=0;
+            const uint64 xcr0=osxsave?ReadXCR0():0;
+            const bool ymm_os=(xcr0&0x06)==0x06;                    //XMM+YMM
+            const bool zmm_os=(xcr0&0xE6)==0xE6;                    //再加opmask+ZMM高256位+ZMM16-31
+
+            cf.avx   =ymm_os&&(r[2]&(1u<<28))!=0;
+            cf.fma   =cf.avx&&(r[2]&(1u<<12))!=0;
+            cf.f16c  =cf.avx&&(r[2]&(1u<<29))!=0;
+
+            if(max_leaf>=7)
+            {
+                CpuId(r,7,0);
+                cf.bmi1    =(r[1]&(1u<<3))!=0;
+                cf.avx2    =cf.avx&&(r[1]&(1u<<5))!=0;
+                cf.bmi2    =(r[1]&(1u<<8))!=0;
+                cf.avx512f =zmm_os&&(r[1]&(1u<<16))!=0;
+                cf.avx512dq=cf.avx512f&&(r[1]&(1u<<17))!=0;
+                cf.sha     =(r[1]&(1u<<29))!=0;
+                cf.avx512bw=cf.avx512f&&(r[1]&(1u<<30))!=0;
+                cf.avx512vl=cf.avx512f&&(r[1]&(1u<<31))!=0;
+            }
+#endif//HGL_SIMD_X86
+
+            return cf;
+        }
+
+        inline CpuTier DetectCpuTier(const CpuFeature &cf)
+        {
+            if(!(cf.ssse3&&cf.sse41&&cf.sse42&&cf.popcnt))
+                return CpuTier::Scalar;
+
+            if(!(cf.avx&&cf.avx2&&cf.fma&&cf.f16c&&cf.bmi1&&cf.bmi2))
+                return CpuTier::SSE42;
+
+            if(!(cf.avx512f&&cf.avx512bw&&cf.avx512dq&&cf.avx512vl))
+                return CpuTier::AVX2;
+
+            return CpuTier::AVX512;
+        }
+
+        /**
+         * 解析档次名称（不区分大小写）
+         */
+        inline bool ParseCpuTier(const char *name,CpuTier &tier)
+        {
+            if(!name)
+                return(false);
+
+            for(size_t t=0;t<size_t(CpuTier::RANGE_SIZE);t++)
+            {
+                const char *a=name;
+                const char *b=CPU_TIER_NAME[t];
+
+                while(*a&&(*a|0x20)==*b)
+                {
+                    ++a;
+                    ++b;
+                }
+
+                if(*a==0&&*b==0)
+                {
+                    tier=CpuTier(t);
+                    return(true);
+                }
+            }
+
+            return(false);
+        }
+
+        /**
+         * 读取环境变量 HGL_CPU_TIER，用于测试时强制降低档次（无法高于实际检测结果）
+         */
+        inline bool GetCpuTierOverride(CpuTier &tier)
+        {
+#if defined(_MSC_VER)&&!defined(__clang__)
+            char *value=nullptr;
+            size_t len=0;
+
+            if(_dupenv_s(&value,&len,"HGL_CPU_TIER")!=0||!value)
+                return(false);
+
+            const bool result=ParseCpuTier(value,tier);
+
+            free(value);
+            return result;
+#else
+            return ParseCpuTier(getenv("HGL_CPU_TIER"),tier);
+#endif
+        }
+
+        /**
+         * 清除高于指定档次的指令集标记
+         */
+        inline CpuFeature LimitCpuFeature(CpuFeature cf,const CpuTier tier)
+        {
+            if(tier<CpuTier::AVX512)
+                cf.avx512f=cf.avx512bw=cf.avx512dq=cf.avx512vl=false;
+
+            if(tier<CpuTier::AVX2)
+                cf.avx=cf.avx2=cf.fma=cf.f16c=cf.bmi1=cf.bmi2=false;
+
+            if(tier<CpuTier::SSE42)
+                cf.ssse3=cf.sse41=cf.sse42=cf.popcnt=cf.sha=false;
+
+            return cf;
+        }
+
+        struct CpuInfo
+        {
+            CpuFeature  detected;                                   ///<硬件实际支持
+            CpuFeature  feature;                                    ///<经 HGL_CPU_TIER 限制后
+            CpuTier     tier;
+
+            CpuInfo()
+            {
+                detected=DetectCpuFeature();
+                tier=DetectCpuTier(detected);
+
+                CpuTier forced;
+
+                if(GetCpuTierOverride(forced)&&forced<tier)
+                {
+                    tier=forced;
+                    feature=LimitCpuFeature(detected,forced);
+                }
+                else
+                {
+                    feature=detected;
+                }
+            }
+        };//struct CpuInfo
+
+        inline const CpuInfo &GetCpuInfo()
+        {
+            static const CpuInfo info;
+
+            return info;
+        }
+    }//namespace cpu_detail
+
+    /**
+     * 取得CPU指令集支持情况（第一次调用时检测，已应用 HGL_CPU_TIER 限制）
+     */
+    inline const CpuFeature &GetCpuFeature()
+    {
+        return cpu_detail::GetCpuInfo().feature;
+    }
+
+    /**
+     * 取得当前使用的指令集档次（已应用 HGL_CPU_TIER 限制）
+     */
+    inline CpuTier GetCpuTier()
+    {
+        return cpu_detail::GetCpuInfo().tier;
+    }
+}//namespace hgl
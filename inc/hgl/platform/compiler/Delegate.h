@@ -0,0 +1,294 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<type_traits>
+#include<utility>
+#include<cstring>
+#include<new>
+
+namespace hgl
+{
+    namespace delegate_detail
+    {
+        /**
+         * 成员函数指针的类型信息
+         */
+        template<typename F> struct MemberFuncTraits;
+
+        template<typename C,typename R,typename ...A> struct MemberFuncTraits<R (C::*)(A...)>
+        {
+            using Class=C;
+            using Return=R;
+            using Object=C;
+        };
+
+        template<typename C,typename R,typename ...A> struct MemberFuncTraits<R (C::*)(A...)const>
+        {
+            using Class=C;
+            using Return=R;
+            using Object=const C;
+        };
+
+        template<typename C,typename R,typename ...A> struct MemberFuncTraits<R (C::*)(A...)noexcept>:MemberFuncTraits<R (C::*)(A...)>{};
+        template<typename C,typename R,typename ...A> struct MemberFuncTraits<R (C::*)(A...)const noexcept>:MemberFuncTraits<R (C::*)(A...)const>{};
+
+        template<auto F> using ClassOf=typename MemberFuncTraits<decltype(F)>::Class;
+        template<auto F> using ObjectOf=typename MemberFuncTraits<decltype(F)>::Object;
+        template<auto F> using ReturnOf=typename MemberFuncTraits<decltype(F)>::Return;
+    }//namespace delegate_detail
+
+    /**
+     * 编译期绑定的成员函数调用<br>
+     * 成员函数作为模板参数，对象中只保存this指针，调用是直接调用，可以被完全内联。
+     * 目标在编译期已知时用它代替 EventFunc。
+     *
+     * <pre>
+     * BoundMethod<&Foo::OnClick> cb(foo);
+     * cb(x,y);                                 //等同于 foo->OnClick(x,y)
+     * </pre>
+     */
+    template<auto F> class BoundMethod
+    {
+        using Object=delegate_detail::ObjectOf<F>;
+
+        Object *obj=nullptr;
+
+    public:
+
+        BoundMethod()=default;
+        explicit BoundMethod(Object *o):obj(o){}
+
+        void Bind(Object *o){obj=o;}
+        Object *GetObject()const{return obj;}
+
+        explicit operator bool()const{return obj!=nullptr;}
+
+        template<typename ...ARGS>
+        decltype(auto) operator()(ARGS &&...args)const
+        {
+            return (obj->*F)(std::forward<ARGS>(args)...);
+        }
+    };//template<auto F> class BoundMethod
+
+    template<typename Sig,size_t BUFFER_SIZE=sizeof(void *)*2> class Delegate;
+
+    /**
+     * 委托（EventFunc 的替代品）<br>
+     * 成员函数用模板参数绑定（Bind<&Class::Func>(obj)），在编译期生成一个直接调用该函数的跳板函数，
+     * 调用时只有一次普通函数指针调用，没有 EventFunc 的成员函数指针分派；构造点可见时编译器能把调用内联为直接调用。
+     *
+     * lambda等可调用对象保存在内部的小缓冲区中，不申请堆内存。要求可平凡复制、可平凡析构、不超过BUFFER_SIZE字节
+     * （捕获一两个指针或整数的lambda都满足），不满足时编译报错。
+     *
+     * 与 EventFunc 不同，目标类不需要从 _Object 派生。
+     */
+    template<typename R,typename ...A,size_t BUFFER_SIZE> class Delegate<R(A...),BUFFER_SIZE>
+    {
+    public:
+
+        using Stub=R (*)(const void *,A...);
+
+    private:
+
+        alignas(void *) unsigned char storage[BUFFER_SIZE];
+        Stub stub=nullptr;
+
+        template<auto F>
+        static R MemberStub(const void *s,A ...args)
+        {
+            using Object=delegate_detail::ObjectOf<F>;
+
+            Object *obj;
+            memcpy(&obj,s,sizeof(obj));
+
+            return (obj->*F)(std::forward<A>(args)...);
+        }
+
+        template<auto F>
+        static R FunctionStub(const void *,A ...args)
+        {
+            return F(std::forward<A>(args)...);
+        }
+
+        template<typename L>
+        static R CallableStub(const void *s,A ...args)
+        {
+            return (*std::launder(reinterpret_cast<const L *>(s)))(std::forward<A>(args)...);
+        }
+
+        template<typename T>
+        void Store(const T &value)
+        {
+            memset(storage,0,BUFFER_SIZE);                          //比较时按整个缓冲区比较
+            new(storage) T(value);
+        }
+
+    public:
+
+        Delegate(){memset(storage,0,BUFFER_SIZE);}
+        Delegate(std::nullptr_t):Delegate(){}
+
+        /**
+         * 从lambda等可调用对象构造
+         */
+        template<typename L,typename=std::enable_if_t<!std::is_same_v<std::decay_t<L>,Delegate>
+                                                     &&std::is_invocable_r_v<R,const std::decay_t<L> &,A...>>>
+        Delegate(L &&callable)
+        {
+            using T=std::decay_t<L>;
+
+            static_assert(sizeof(T)<=BUFFER_SIZE,"callable too large for Delegate small buffer, increase BUFFER_SIZE");
+            static_assert(alignof(T)<=alignof(void *),"callable over-aligned for Delegate small buffer");
+            static_assert(std::is_trivially_copyable_v<T>&&std::is_trivially_destructible_v<T>,"Delegate only stores trivially copyable callables");
+
+            Store(T(std::forward<L>(callable)));
+            stub=&CallableStub<T>;
+        }
+
+        /**
+         * 绑定成员函数
+         */
+        template<auto F>
+        static Delegate Bind(delegate_detail::ObjectOf<F> *obj)
+        {
+            Delegate d;
+
+            d.Store(obj);
+            d.stub=&MemberStub<F>;
+            return d;
+        }
+
+        /**
+         * 绑定普通函数或静态成员函数
+         */
+        template<auto F>
+        static Delegate Bind()
+        {
+            Delegate d;
+
+            d.stub=&FunctionStub<F>;
+            return d;
+        }
+
+        void Clear()
+        {
+            memset(storage,0,BUFFER_SIZE);
+            stub=nullptr;
+        }
+
+        explicit operator bool()const{return stub!=nullptr;}
+        bool operator !()const{return stub==nullptr;}
+
+        /**
+         * 绑定的是同一个函数与同一个对象（或内容相同的可调用对象）
+         */
+        bool operator==(const Delegate &d)const
+        {
+            return stub==d.stub&&memcmp(storage,d.storage,BUFFER_SIZE)==0;
+        }
+
+        bool operator==(std::nullptr_t)const{return stub==nullptr;}
+
+        R operator()(A ...args)const
+        {
+            return stub(storage,std::forward<A>(args)...);
+        }
+    };//class Delegate<R(A...),BUFFER_SIZE>
+
+    /**
+     * 编译期绑定的只读属性（PropertyRead 的替代品）<br>
+     * Get函数作为模板参数，对象中只保存所属对象的指针，读取直接调用Get函数，可以被完全内联。
+     *
+     * 由于保存了所属对象指针，不可复制构造；所属类需要复制时应自行实现复制构造并重新绑定。
+     */
+    template<auto Get> class BoundPropertyRead
+    {
+    public:
+
+        using Owner=delegate_detail::ClassOf<Get>;
+        using T=std::remove_cvref_t<delegate_detail::ReturnOf<Get>>;
+
+    protected:
+
+        Owner *owner;
+
+    public:
+
+        explicit BoundPropertyRead(Owner *o):owner(o){}
+
+        BoundPropertyRead(const BoundPropertyRead &)=delete;
+
+        T Value()const{return (owner->*Get)();}
+
+        operator T()const{return Value();}
+
+        bool operator == (const T &v)const{return Value()==v;}
+        bool operator != (const T &v)const{return Value()!=v;}
+    };//template<auto Get> class BoundPropertyRead
+
+    /**
+     * 编译期绑定的属性（Property 的替代品）<br>
+     * Get/Set函数作为模板参数，读写都直接调用，在循环中访问时和直接调用Get/Set一样可以被内联，没有 Property 的两次成员函数指针间接调用。
+     *
+     * <pre>
+     * class Foo
+     * {
+     *     int width=0;
+     *
+     *     int GetWidth()const{return width;}
+     *     void SetWidth(int w){width=w;}
+     *
+     * public:
+     *
+     *     BoundProperty<&Foo::GetWidth,&Foo::SetWidth> Width{this};
+     * };
+     *
+     * foo.Width=10;
+     * foo.Width+=5;
+     * int w=foo.Width;
+     * </pre>
+     */
+    template<auto Get,auto Set> class BoundProperty:public BoundPropertyRead<Get>
+    {
+        static_assert(std::is_same_v<delegate_detail::ClassOf<Get>,delegate_detail::ClassOf<Set>>,"Get and Set must be members of the same class");
+
+        using Base=BoundPropertyRead<Get>;
+
+    public:
+
+        using typename Base::T;
+        using typename Base::Owner;
+        using Base::Value;
+
+        explicit BoundProperty(Owner *o):Base(o){}
+
+        void SetValue(const T &v){(this->owner->*Set)(v);}
+
+        BoundProperty &operator = (const T &v){SetValue(v);return *this;}
+        BoundProperty &operator = (const BoundProperty &v){SetValue(v.Value());return *this;}
+
+        T operator !()const{return !Value();}
+        T operator ~()const{return ~Value();}
+
+        T operator ++ ()    {   T v=Value();    SetValue(++v);  return v;   }               ///<前置++
+        T operator -- ()    {   T v=Value();    SetValue(--v);  return v;   }               ///<前置--
+
+        T operator ++ (int) {   T r=Value();    T v=r;  SetValue(++v);  return r;   }       ///<后置++
+        T operator -- (int) {   T r=Value();    T v=r;  SetValue(--v);  return r;   }       ///<后置--
+
+        void operator += (const T &v)  {   SetValue(Value() + v);  }
+        void operator -= (const T &v)  {   SetValue(Value() - v);  }
+        void operator *= (const T &v)  {   SetValue(Value() * v);  }
+        void operator /= (const T &v)  {   SetValue(Value() / v);  }
+        void operator %= (const T &v)  {   SetValue(Value() % v);  }
+
+        void operator &= (const T &v)  {   SetValue(Value() & v);  }
+        void operator |= (const T &v)  {   SetValue(Value() | v);  }
+
+        void operator >>= (int n)   {   SetValue(Value()>>n);   }
+        void operator <<= (int n)   {   SetValue(Value()<<n);   }
+
+        T operator >> (int n)const  {   return Value()>>n;  }
+        T operator << (int n)const  {   return Value()<<n;  }
+    };//template<auto Get,auto Set> class BoundProperty
+}//namespace hgl
@@ -45,6 +45,11 @@ namespace hgl
                 vp_func=f;
             }
 
+            EventFunc(const SelfClass &ef)
+            {
+                memcpy(this,&ef,sizeof(SelfClass));                 //与operator=一致，按整块复制
+            }
+
             void ClearFunc()
             {
                 memset(this,0,sizeof(SelfClass));
@@ -135,6 +140,11 @@ namespace hgl
                 vp_func=f;
             }
 
+            EventFunc(const SelfClass &ef)
+            {
+                memcpy(this,&ef,sizeof(SelfClass));                 //与operator=一致，按整块复制
+            }
+
             bool operator !()const
             {
                 if(!vp_func)return(true);
@@ -0,0 +1,444 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<atomic>
+#include<mutex>
+#include<vector>
+#include<tuple>
+#include<new>
+#include<cstring>
+#include<type_traits>
+
+namespace hgl
+{
+    namespace multicast_event_detail
+    {
+        template<typename Func> struct FuncArgs;
+
+        template<typename R,typename ...A> struct FuncArgs<R (_Object::*)(A...)>
+        {
+            using Tuple=std::tuple<std::decay_t<A>...>;
+        };
+
+        template<typename R,typename ...A> struct FuncArgs<R (_Object::*)(A...)const>
+        {
+            using Tuple=std::tuple<std::decay_t<A>...>;
+        };
+
+        constexpr size_t CACHE_LINE=64;
+    }//namespace multicast_event_detail
+
+    /**
+     * 多播事件<br>
+     * 保存多个 EventFunc 目标，触发时依次调用。
+     *
+     * <ul>
+     *  <li>目标保存在一块连续内存中（快照），触发时顺序遍历</li>
+     *  <li>增删目标时复制出新快照再原子替换（copy-on-write），触发不加锁，也不会被增删阻塞</li>
+     *  <li>旧快照按两阶段读者计数（类似RCU的宽限期）回收：增删时检查，读者全部离开旧快照后才释放，
+     *      增删本身也从不等待读者，所以在回调中增删本事件是安全的</li>
+     *  <li>Post/Flush 为延迟模式：Post 把参数放入队列（任意线程），Flush 在一次读区间内把整批事件分发给当前的全部目标，
+     *      通常每帧调用一次</li>
+     * </ul>
+     *
+     * 一次触发总是作用于开始时的快照：回调中新增的目标从下一次触发开始生效，回调中移除的目标本次仍会被调用。
+     *
+     * Func与 DefEvent 中的相同，如 void (_Object::*)(int)，回调的返回值被忽略。
+     */
+    template<typename Func> class MulticastEvent
+    {
+    public:
+
+        using Target=EventFunc<void,Func>;
+        using ArgsTuple=typename multicast_event_detail::FuncArgs<Func>::Tuple;
+
+    private:
+
+        /**
+         * 目标快照，count个Target紧随其后
+         */
+        struct alignas(Target) Snapshot
+        {
+            uint32 count;
+
+            Target *Items(){return reinterpret_cast<Target *>(this+1);}
+            const Target *Items()const{return reinterpret_cast<const Target *>(this+1);}
+        };
+
+        struct Retired
+        {
+            Snapshot *snapshot;
+            uint64 flip;                                                ///<退役时的epoch翻转次数
+        };
+
+        std::atomic<Snapshot *> current{nullptr};
+
+        alignas(multicast_event_detail::CACHE_LINE) std::atomic<uint32> epoch{0};
+        std::atomic<uint32> readers[2]{};                               ///<两个epoch各自的在读数量
+
+        alignas(multicast_event_detail::CACHE_LINE) std::mutex write_lock;
+        std::vector<Retired> retired;
+        uint64 flip_count=0;
+
+        std::mutex queue_lock;
+        std::vector<ArgsTuple> queue;
+        std::vector<ArgsTuple> flushing;                                ///<Flush时与queue交换，保留容量
+
+    private:
+
+        static Snapshot *CreateSnapshot(const uint32 count)
+        {
+            Snapshot *ss=static_cast<Snapshot *>(::operator new(sizeof(Snapshot)+sizeof(Target)*count));
+
+            ss->count=count;
+            return ss;
+        }
+
+        static void FreeSnapshot(Snapshot *ss)
+        {
+            ::operator delete(ss);
+        }
+
+        static bool Same(const Target &a,const Target &b)
+        {
+            return memcmp(&a,&b,sizeof(Target))==0;                   //与EventFunc一样按整个结构比较，omf可能不止一个指针长
+        }
+
+        /**
+         * 进入读区间，返回所用的计数器
+         */
+        std::atomic<uint32> &ReadLock()
+        {
+            std::atomic<uint32> &counter=readers[epoch.load(std::memory_order_seq_cst)&1];
+
+            counter.fetch_add(1,std::memory_order_seq_cst);             //必须先于读取current
+            return counter;
+        }
+
+        static void ReadUnlock(std::atomic<uint32> &counter)
+        {
+            counter.fetch_sub(1,std::memory_order_release);
+        }
+
+        /**
+         * 回收已无读者的旧快照（调用时持有write_lock）<br>
+         * 另一个epoch的读者数为0时才翻转epoch；快照退役后经过两次翻转，退役前进入的读者（无论在哪个epoch）必然都已离开。
+         */
+        void TryReclaim()
+        {
+            for(int i=0;i<2&&!retired.empty();i++)
+            {
+                const uint32 e=epoch.load(std::memory_order_relaxed);
+
+                if(readers[e^1].load(std::memory_order_seq_cst))
+                    break;
+
+                epoch.store(e^1,std::memory_order_seq_cst);
+                ++flip_count;
+            }
+
+            size_t keep=0;
+
+            for(const Retired &r:retired)
+            {
+                if(flip_count>=r.flip+2)
+                    FreeSnapshot(r.snapshot);
+                else
+                    retired[keep++]=r;
+            }
+
+            retired.resize(keep);
+        }
+
+        /**
+         * 发布新快照（调用时持有write_lock）
+         */
+        void Publish(Snapshot *ss)
+        {
+            Snapshot *old=current.exchange(ss,std::memory_order_seq_cst);
+
+            if(old)
+                retired.push_back({old,flip_count});
+
+            TryReclaim();
+        }
+
+        /**
+         * 复制出去掉满足条件的目标的新快照
+         * @return 去掉的数量
+         */
+        template<typename Pred>
+        int RemoveIf(Pred pred)
+        {
+            std::lock_guard<std::mutex> lock(write_lock);
+
+            const Snapshot *old=current.load(std::memory_order_relaxed);
+
+            if(!old)
+                return 0;
+
+            const Target *src=old->Items();
+            uint32 keep=0;
+
+            for(uint32 i=0;i<old->count;i++)
+                if(!pred(src[i]))
+                    ++keep;
+
+            if(keep==old->count)
+                return 0;
+
+            Snapshot *ss=nullptr;
+
+            if(keep)
+            {
+                ss=CreateSnapshot(keep);
+
+                Target *dst=ss->Items();
+
+                for(uint32 i=0;i<old->count;i++)
+                    if(!pred(src[i]))
+                        new(dst++) Target(src[i]);
+            }
+
+            const int removed=int(old->count-keep);
+
+            Publish(ss);
+            return removed;
+        }
+
+        template<typename ...ARGS>
+        static void Dispatch(const Snapshot *ss,ARGS &...args)
+        {
+            const Target *t=ss->Items();
+            const Target *end=t+ss->count;
+
+            for(;t<end;++t)
+                (*t)(args...);
+        }
+
+    public:
+
+        MulticastEvent()=default;
+
+        NO_COPY_NO_MOVE(MulticastEvent)
+
+        /**
+         * 析构时不能再有其它线程在触发本事件
+         */
+        ~MulticastEvent()
+        {
+            FreeSnapshot(current.exchange(nullptr));
+
+            for(const Retired &r:retired)
+                FreeSnapshot(r.snapshot);
+        }
+
+        /**
+         * 增加目标
+         * @return 目标为空或已存在时返回false
+         */
+        bool Add(const Target &target)
+        {
+            if(!target)
+                return false;
+
+            std::lock_guard<std::mutex> lock(write_lock);
+
+            const Snapshot *old=current.load(std::memory_order_relaxed);
+            const uint32 count=old?old->count:0;
+
+            for(uint32 i=0;i<count;i++)
+                if(Same(old->Items()[i],target))
+                    return false;
+
+            Snapshot *ss=CreateSnapshot(count+1);
+
+            Target *dst=ss->Items();
+
+            for(uint32 i=0;i<count;i++)
+                new(dst+i) Target(old->Items()[i]);
+
+            new(dst+count) Target(target);
+
+            Publish(ss);
+            return true;
+        }
+
+        bool Add(void *obj_this,void *func){return Add(Target(obj_this,func));}
+
+        /**
+         * 移除目标
+         * @return 目标不存在时返回false
+         */
+        bool Remove(const Target &target)
+        {
+            return RemoveIf([&target](const Target &t){return Same(t,target);})>0;
+        }
+
+        bool Remove(void *obj_this,void *func){return Remove(Target(obj_this,func));}
+
+        /**
+         * 移除属于指定对象的全部目标，对象销毁前调用
+         * @return 移除的数量
+         */
+        int RemoveObject(const void *obj_this)
+        {
+            return RemoveIf([obj_this](const Target &t){return t.vp_this==obj_this;});
+        }
+
+        /**
+         * 移除全部目标
+         */
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(write_lock);
+
+            if(current.load(std::memory_order_relaxed))
+                Publish(nullptr);
+        }
+
+        /**
+         * 当前目标数量（其它线程可能正在增删，仅供参考）
+         */
+        int GetCount()const
+        {
+            const Snapshot *ss=current.load(std::memory_order_acquire);
+
+            return ss?int(ss->count):0;
+        }
+
+        bool IsEmpty()const{return !current.load(std::memory_order_acquire);}
+
+        /**
+         * 等待回收的旧快照数量
+         */
+        int GetRetiredCount()
+        {
+            std::lock_guard<std::mutex> lock(write_lock);
+
+            return int(retired.size());
+        }
+
+        /**
+         * 尝试回收旧快照（增删时会自动进行，仅在长期不再增删时需要手动调用）
+         */
+        void Reclaim()
+        {
+            std::lock_guard<std::mutex> lock(write_lock);
+
+            TryReclaim();
+        }
+
+        /**
+         * 立即触发，依次调用全部目标
+         */
+        template<typename ...ARGS>
+        void Call(ARGS...args)
+        {
+            if(!current.load(std::memory_order_relaxed))                //没有目标时不进入读区间
+                return;
+
+            std::atomic<uint32> &counter=ReadLock();
+
+            if(const Snapshot *ss=current.load(std::memory_order_seq_cst))
+                Dispatch(ss,args...);
+
+            ReadUnlock(counter);
+        }
+
+        template<typename ...ARGS>
+        void operator()(ARGS...args){Call(args...);}
+
+        /**
+         * 延迟触发：保存参数，在下一次Flush时分发（可在任意线程调用）
+         */
+        template<typename ...ARGS>
+        void Post(ARGS &&...args)
+        {
+            std::lock_guard<std::mutex> lock(queue_lock);
+
+            queue.emplace_back(std::forward<ARGS>(args)...);
+        }
+
+        int GetPostedCount()
+        {
+            std::lock_guard<std::mutex> lock(queue_lock);
+
+            return int(queue.size());
+        }
+
+        /**
+         * 分发全部延迟事件（按Post的顺序，每个事件调用全部目标）<br>
+         * 整批事件只进入一次读区间，使用同一个快照。回调中Post的事件留到下一次Flush。
+         * 同一时间只能有一个线程调用Flush。
+         * @return 分发的事件数量
+         */
+        int Flush()
+        {
+            {
+                std::lock_guard<std::mutex> lock(queue_lock);
+
+                if(queue.empty())
+                    return 0;
+
+                flushing.swap(queue);
+            }
+
+            const int count=int(flushing.size());
+
+            if(current.load(std::memory_order_relaxed))
+            {
+                std::atomic<uint32> &counter=ReadLock();
+
+                if(const Snapshot *ss=current.load(std::memory_order_seq_cst))
+                {
+                    for(ArgsTuple &args:flushing)
+                        std::apply([ss](auto &...a){Dispatch(ss,a...);},args);
+                }
+
+                ReadUnlock(counter);
+            }
+
+            flushing.clear();
+            return count;
+        }
+    };//template<typename Func> class MulticastEvent
+
+    #define DefMulticastEvent(name,intro)                   MulticastEvent<void (_Object:: *)intro> name;
+
+    #define AddEventCall(event_obj,obj_this,class_name,event_func)      (event_obj).Add(obj_this,GetMemberFuncPointer(class_name,event_func))
+    #define RemoveEventCall(event_obj,obj_this,class_name,event_func)   (event_obj).Remove(obj_this,GetMemberFuncPointer(class_name,event_func))
+
+    /*
+
+    使用方法:
+
+        class Button
+        {
+        public:
+
+            DefMulticastEvent(OnClick,(Button *,int));
+        };
+
+        class Panel:public _Object
+        {
+            void ClickProc(Button *,int);
+
+            void Init(Button *btn)
+            {
+                AddEventCall(btn->OnClick,this,Panel,ClickProc);
+            }
+
+            void Close(Button *btn)
+            {
+                btn->OnClick.RemoveObject(this);
+            }
+        };
+
+        btn->OnClick(btn,0);                //立即触发
+
+        btn->OnClick.Post(btn,0);           //延迟触发
+        ...
+        btn->OnClick.Flush();               //每帧一次
+    */
+}//namespace hgl
@@ -3,9 +3,12 @@
 #include<stdarg.h>
 #include<cstddef>
 #include<stdio.h>
+#include<wchar.h>
 
 namespace hgl
 {
+    // 新代码请使用 hgl/type/Str.Format.h 中的 strfmt：编译期检查格式与参数类型，不依赖locale，支持char16_t
+
     // 计算格式化字符串所需的长度（不包括 null 终止符）
     template<typename T> int vsprintf_length(const T *format, va_list va);
 
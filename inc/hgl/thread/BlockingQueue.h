@@ -0,0 +1,183 @@
+﻿#pragma once
+
+#include<hgl/thread/Semaphore.h>
+#include<hgl/thread/SPSCQueue.h>
+#include<hgl/thread/MPMCQueue.h>
+
+namespace hgl
+{
+    /**
+     * 给无锁有界队列加上阻塞等待<br>
+     * 用两个 Semaphore 分别计数“可读元素”与“空闲槽位”：队列满时 Push 阻塞，空时 Pop 阻塞，
+     * 不满不空时只比底层队列多一次信号量CAS，没有阻塞者时 Release 也不进入内核。
+     *
+     * Q为 SPSCQueue<T> 或 MPMCQueue<T>（需要 TryEmplace/TryPop/PushBatch/PopBatch/GetCapacity）；
+     * 使用SPSCQueue时同样只能有一个生产者与一个消费者。
+     */
+    template<typename Q> class BlockingQueue
+    {
+    public:
+
+        using T=typename Q::ValueType;
+
+    private:
+
+        Q queue;
+
+        Semaphore items;                                            ///<已写入完成、尚未被领取的元素数
+        Semaphore slots;                                            ///<空闲槽位数
+
+        /**
+         * 信号量保证有空位/有元素，但MPMC中排在前面的位置可能还在被别的线程写入/读出，短暂等它完成
+         */
+        template<typename ...ARGS>
+        void PushReserved(ARGS &&...args)
+        {
+            Backoff backoff;
+
+            while(!queue.TryEmplace(std::forward<ARGS>(args)...))
+                backoff.Pause();
+
+            items.Release();
+        }
+
+        void PopReserved(T &out)
+        {
+            Backoff backoff;
+
+            while(!queue.TryPop(out))
+                backoff.Pause();
+
+            slots.Release();
+        }
+
+    public:
+
+        explicit BlockingQueue(size_t capacity):queue(capacity),slots(uint32(queue.GetCapacity())){}
+
+        NO_COPY_NO_MOVE(BlockingQueue)
+
+        size_t GetCapacity()const{return queue.GetCapacity();}
+        size_t GetCount()const{return items.GetCount();}
+        bool IsEmpty()const{return items.GetCount()==0;}
+
+        /**
+         * 写入，队列满时阻塞
+         */
+        void Push(const T &value){slots.Acquire();PushReserved(value);}
+        void Push(T &&value){slots.Acquire();PushReserved(std::move(value));}
+
+        /**
+         * 写入，队列满时最多等待timeout_us微秒
+         * @return 超时返回false
+         */
+        bool Push(const T &value,const int64 timeout_us)
+        {
+            if(!slots.Acquire(timeout_us))
+                return(false);
+
+            PushReserved(value);
+            return(true);
+        }
+
+        bool TryPush(const T &value)
+        {
+            if(!slots.TryAcquire())
+                return(false);
+
+            PushReserved(value);
+            return(true);
+        }
+
+        /**
+         * 取出，队列空时阻塞
+         */
+        void Pop(T &out){items.Acquire();PopReserved(out);}
+
+        /**
+         * 取出，队列空时最多等待timeout_us微秒
+         * @return 超时返回false
+         */
+        bool Pop(T &out,const int64 timeout_us)
+        {
+            if(!items.Acquire(timeout_us))
+                return(false);
+
+            PopReserved(out);
+            return(true);
+        }
+
+        bool TryPop(T &out)
+        {
+            if(!items.TryAcquire())
+                return(false);
+
+            PopReserved(out);
+            return(true);
+        }
+
+        /**
+         * 写入全部count个元素，空位不足时阻塞等待；每次有空位时尽量一次写入多个
+         */
+        void PushBatch(const T *values,size_t count)
+        {
+            while(count>0)
+            {
+                slots.Acquire();
+
+                const size_t reserved=1+slots.TryAcquireMany(uint32(std::min<size_t>(count-1,0x7FFFFFFF)));
+
+                size_t done=0;
+                Backoff backoff;
+
+                while(done<reserved)
+                {
+                    const size_t n=queue.PushBatch(values+done,reserved-done);
+
+                    if(n==0)
+                        backoff.Pause();
+
+                    done+=n;
+                }
+
+                items.Release(uint32(reserved));
+
+                values+=reserved;
+                count-=reserved;
+            }
+        }
+
+        /**
+         * 取出最多max_count个元素，队列空时阻塞直到至少有一个
+         * @return 取出的数量（>=1）
+         */
+        size_t PopBatch(T *out,size_t max_count)
+        {
+            if(max_count==0)
+                return 0;
+
+            items.Acquire();
+
+            const size_t reserved=1+items.TryAcquireMany(uint32(std::min<size_t>(max_count-1,0x7FFFFFFF)));
+
+            size_t done=0;
+            Backoff backoff;
+
+            while(done<reserved)
+            {
+                const size_t n=queue.PopBatch(out+done,reserved-done);
+
+                if(n==0)
+                    backoff.Pause();
+
+                done+=n;
+            }
+
+            slots.Release(uint32(reserved));
+            return reserved;
+        }
+    };//template<typename Q> class BlockingQueue
+
+    template<typename T> using BlockingSPSCQueue=BlockingQueue<SPSCQueue<T>>;
+    template<typename T> using BlockingMPMCQueue=BlockingQueue<MPMCQueue<T>>;
+}//namespace hgl
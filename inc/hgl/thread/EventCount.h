@@ -0,0 +1,114 @@
+﻿#pragma once
+
+#include<hgl/thread/Futex.h>
+
+namespace hgl
+{
+    /**
+     * 事件计数：让无锁数据结构的使用者在“没有数据”时阻塞，而数据结构本身不需要加锁<br>
+     * 等待方的固定写法：
+     * <pre>
+     * for(;;)
+     * {
+     *     if(queue.TryPop(v))break;                    //快速路径
+     *
+     *     const EventCount::Key key=ec.PrepareWait();
+     *
+     *     if(queue.TryPop(v)){ec.CancelWait();break;}  //登记后再检查一次
+     *
+     *     ec.Wait(key);                                //登记之后若有 Notify，这里立即返回
+     * }
+     * </pre>
+     * 通知方先让条件成立（如压入数据），再调用 NotifyOne/NotifyAll；没有等待者时 Notify 只是一次读取。
+     *
+     * 参见 Dmitry Vyukov 的 eventcount 与 folly::EventCount。
+     */
+    class EventCount
+    {
+        alignas(64) std::atomic<uint32> epoch{0};                  ///<每次有等待者时的Notify加1，futex等待在它上面
+        std::atomic<uint32> waiters{0};                             ///<已 PrepareWait 尚未 Wait/CancelWait 的线程数
+
+        void DoNotify(const int n)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);    //条件成立的写入先于读取等待者数量
+
+            if(waiters.load(std::memory_order_relaxed)==0)
+                return;
+
+            epoch.fetch_add(1,std::memory_order_seq_cst);
+            FutexWake(epoch,n);
+        }
+
+    public:
+
+        using Key=uint32;
+
+        EventCount()=default;
+        ~EventCount()=default;
+
+        NO_COPY_NO_MOVE(EventCount)
+
+        /**
+         * 登记为等待者，之后必须调用 Wait 或 CancelWait 之一
+         */
+        Key PrepareWait()
+        {
+            waiters.fetch_add(1,std::memory_order_seq_cst);
+
+            const Key key=epoch.load(std::memory_order_seq_cst);
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);    //读取纪元先于重新检查条件
+
+            return key;
+        }
+
+        /**
+         * 登记后发现条件已经成立，取消等待
+         */
+        void CancelWait()
+        {
+            waiters.fetch_sub(1,std::memory_order_seq_cst);
+        }
+
+        /**
+         * 阻塞直到 PrepareWait 之后有 Notify
+         */
+        void Wait(const Key key)
+        {
+            while(epoch.load(std::memory_order_acquire)==key)
+                FutexWait(epoch,key);
+
+            waiters.fetch_sub(1,std::memory_order_seq_cst);
+        }
+
+        /**
+         * 同 Wait，最多等待timeout_us微秒
+         * @return 超时返回false
+         */
+        bool Wait(const Key key,const int64 timeout_us)
+        {
+            const auto deadline=std::chrono::steady_clock::now()+std::chrono::microseconds(timeout_us);
+
+            bool notified=true;
+
+            while(epoch.load(std::memory_order_acquire)==key)
+            {
+                const int64 remain=std::chrono::duration_cast<std::chrono::microseconds>(deadline-std::chrono::steady_clock::now()).count();
+
+                if(remain<=0)
+                {
+                    notified=false;
+                    break;
+                }
+
+                FutexWait(epoch,key,remain);
+            }
+
+            waiters.fetch_sub(1,std::memory_order_seq_cst);
+            return notified;
+        }
+
+        void NotifyOne(){DoNotify(1);}
+        void NotifyAll(){DoNotify(0x7FFFFFFF);}
+    };//class EventCount
+}//namespace hgl
@@ -0,0 +1,140 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<atomic>
+#include<thread>
+#include<chrono>
+
+#if HGL_OS==HGL_OS_Linux||HGL_OS==HGL_OS_Android
+    #define HGL_FUTEX                                               ///<可以直接使用Linux futex系统调用
+    #include<linux/futex.h>
+    #include<sys/syscall.h>
+    #include<unistd.h>
+    #include<time.h>
+    #include<errno.h>
+#endif//HGL_OS==HGL_OS_Linux
+
+#if HGL_CPU==HGL_CPU_X86_64||HGL_CPU==HGL_CPU_X86_32
+    #include<immintrin.h>
+#endif
+
+namespace hgl
+{
+    /**
+     * 自旋等待时提示CPU（x86为pause，ARM为yield），降低功耗并让出超线程的执行资源
+     */
+    inline void CpuPause()
+    {
+#if HGL_CPU==HGL_CPU_X86_64||HGL_CPU==HGL_CPU_X86_32
+        _mm_pause();
+#elif (HGL_CPU==HGL_CPU_ARMv7||HGL_CPU==HGL_CPU_ARMv8||HGL_CPU==HGL_CPU_ARMv9)&&(defined(__GNUC__)||defined(__clang__))
+        __asm__ __volatile__("yield");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    /**
+     * 是否值得在挂起前自旋：只有一个CPU时，自旋期间持锁者/生产者不可能运行，自旋纯属浪费
+     */
+    inline bool IsSpinUseful()
+    {
+        static const bool useful=std::thread::hardware_concurrency()>1;
+
+        return useful;
+    }
+
+    /**
+     * 指数退避：每次等待的pause数加倍，到上限后改为让出时间片（线程数多于CPU数时持有锁的线程才能运行）
+     */
+    class Backoff
+    {
+        uint32 count=1;
+
+    public:
+
+        static constexpr uint32 MAX_PAUSE=1024;
+
+        void Pause()
+        {
+            if(count<=MAX_PAUSE)
+            {
+                for(uint32 i=0;i<count;i++)
+                    CpuPause();
+
+                count<<=1;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        void Reset(){count=1;}
+    };//class Backoff
+
+    /**
+     * 如果 *addr==expected 则阻塞，直到被 FutexWake 唤醒（可能虚假唤醒，调用方需重新检查条件）
+     * @param timeout_us 超时微秒数，<0为不超时
+     * @return 超时返回false，其它情况返回true
+     */
+    inline bool FutexWait(std::atomic<uint32> &addr,const uint32 expected,const int64 timeout_us=-1)
+    {
+#ifdef HGL_FUTEX
+        static_assert(sizeof(std::atomic<uint32>)==sizeof(uint32),"futex needs a plain 32-bit word");
+
+        timespec ts,*pts=nullptr;
+
+        if(timeout_us>=0)
+        {
+            ts.tv_sec =time_t(timeout_us/1000000);
+            ts.tv_nsec=long(timeout_us%1000000)*1000;
+            pts=&ts;
+        }
+
+        if(syscall(SYS_futex,reinterpret_cast<uint32 *>(&addr),FUTEX_WAIT_PRIVATE,expected,pts,nullptr,0)==-1)
+            return errno!=ETIMEDOUT;
+
+        return true;
+#else
+        if(timeout_us<0)
+        {
+            addr.wait(expected,std::memory_order_relaxed);
+            return true;
+        }
+
+        //std::atomic::wait没有超时版本，轮询
+        const auto deadline=std::chrono::steady_clock::now()+std::chrono::microseconds(timeout_us);
+
+        while(addr.load(std::memory_order_relaxed)==expected)
+        {
+            if(std::chrono::steady_clock::now()>=deadline)
+                return false;
+
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
+        return true;
+#endif//HGL_FUTEX
+    }
+
+    /**
+     * 唤醒最多count个在addr上等待的线程
+     */
+    inline void FutexWake(std::atomic<uint32> &addr,const int count=1)
+    {
+#ifdef HGL_FUTEX
+        syscall(SYS_futex,reinterpret_cast<uint32 *>(&addr),FUTEX_WAKE_PRIVATE,count,nullptr,nullptr,0);
+#else
+        if(count==1)
+            addr.notify_one();
+        else
+            addr.notify_all();
+#endif//HGL_FUTEX
+    }
+
+    inline void FutexWakeAll(std::atomic<uint32> &addr)
+    {
+        FutexWake(addr,0x7FFFFFFF);
+    }
+}//namespace hgl
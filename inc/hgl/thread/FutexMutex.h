@@ -0,0 +1,103 @@
+﻿#pragma once
+
+#include<hgl/thread/Futex.h>
+#include<algorithm>
+
+namespace hgl
+{
+    /**
+     * 自适应互斥锁（先自旋，再挂起）<br>
+     * 状态只有一个32位整数：0未锁定，1锁定且无等待者，2锁定且可能有等待者（Drepper "Futexes Are Tricky" 中的mutex3）。
+     * 无竞争时加锁/解锁各一次原子操作，不进入内核；解锁时只有状态为2才调用 FutexWake。
+     *
+     * 竞争时先自旋，自旋次数按最近几次实际等到锁所用的次数动态调整（同glibc PTHREAD_MUTEX_ADAPTIVE_NP）：
+     * 临界区很短时自旋就能拿到锁，避免挂起/唤醒的系统调用；临界区长时很快放弃自旋。
+     *
+     * 不可重入，只能由加锁的线程解锁。同时提供 lock/unlock/try_lock，可以配合 std::lock_guard 使用。
+     */
+    class FutexMutex
+    {
+        std::atomic<uint32> state{0};
+        std::atomic<int32> spin_estimate{MIN_SPIN*8};               ///<自旋次数的估计值（x8定点数，只是提示，不需要精确）
+
+    public:
+
+        static constexpr int32 MIN_SPIN=16;
+        static constexpr int32 MAX_SPIN=512;
+
+    private:
+
+        void LockSlow()
+        {
+            //只有一个CPU时不自旋，直接挂起让持锁者运行
+            const int32 limit=IsSpinUseful()?std::min(MAX_SPIN,std::max(MIN_SPIN,spin_estimate.load(std::memory_order_relaxed)/8)*2):0;
+
+            for(int32 spin=0;spin<limit;spin++)
+            {
+                if(state.load(std::memory_order_relaxed)==0)
+                {
+                    uint32 expected=0;
+
+                    if(state.compare_exchange_weak(expected,1,std::memory_order_acquire,std::memory_order_relaxed))
+                    {
+                        //把本次所用次数计入估计值：est+=(spin-est)/8
+                        const int32 est=spin_estimate.load(std::memory_order_relaxed);
+                        spin_estimate.store(est+(spin*8-est)/8,std::memory_order_relaxed);
+                        return;
+                    }
+                }
+
+                CpuPause();
+            }
+
+            if(limit)
+            {
+                const int32 est=spin_estimate.load(std::memory_order_relaxed);
+                spin_estimate.store(est+(limit*8-est)/8,std::memory_order_relaxed);
+            }
+
+            //挂起：把状态设为2，这样解锁者知道需要唤醒
+            uint32 c=state.exchange(2,std::memory_order_acquire);
+
+            while(c!=0)
+            {
+                FutexWait(state,2);
+                c=state.exchange(2,std::memory_order_acquire);
+            }
+        }
+
+    public:
+
+        FutexMutex()=default;
+        ~FutexMutex()=default;
+
+        NO_COPY_NO_MOVE(FutexMutex)
+
+        void Lock()
+        {
+            uint32 expected=0;
+
+            if(!state.compare_exchange_strong(expected,1,std::memory_order_acquire,std::memory_order_relaxed))
+                LockSlow();
+        }
+
+        bool TryLock()
+        {
+            uint32 expected=0;
+
+            return state.compare_exchange_strong(expected,1,std::memory_order_acquire,std::memory_order_relaxed);
+        }
+
+        void Unlock()
+        {
+            if(state.exchange(0,std::memory_order_release)==2)
+                FutexWake(state,1);
+        }
+
+        bool IsLocked()const{return state.load(std::memory_order_relaxed)!=0;}
+
+        void lock(){Lock();}
+        bool try_lock(){return TryLock();}
+        void unlock(){Unlock();}
+    };//class FutexMutex
+}//namespace hgl
@@ -0,0 +1,217 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<atomic>
+#include<memory>
+#include<new>
+#include<utility>
+#include<type_traits>
+#include<algorithm>
+
+namespace hgl
+{
+    /**
+     * 有界多生产者/多消费者无锁队列（Dmitry Vyukov 的 bounded MPMC queue）<br>
+     * 每个槽位带一个序号：序号==位置 表示空闲可写，序号==位置+1 表示已写入可读。
+     * 生产者/消费者各自用一次CAS抢占入队/出队位置，然后只操作自己抢到的槽位，
+     * 不同位置的读写互不干扰，也没有ABA问题。
+     *
+     * 批量操作一次CAS抢占连续多个位置。
+     */
+    template<typename T> class alignas(64) MPMCQueue
+    {
+        static constexpr size_t CACHE_LINE=64;
+
+        struct Cell
+        {
+            std::atomic<size_t> seq;
+            alignas(T) unsigned char data[sizeof(T)];
+
+            T *Get(){return std::launder(reinterpret_cast<T *>(data));}
+        };
+
+        const size_t capacity;
+        const size_t mask;
+        std::unique_ptr<Cell[]> cells;
+
+        alignas(CACHE_LINE) std::atomic<size_t> enqueue_pos{0};
+        alignas(CACHE_LINE) std::atomic<size_t> dequeue_pos{0};
+
+        static size_t RoundCapacity(size_t n)
+        {
+            size_t c=2;
+
+            while(c<n)
+                c<<=1;
+
+            return c;
+        }
+
+        /**
+         * 从pos开始连续最多max个位置中，槽位序号为 pos+i+offset 的数量
+         */
+        size_t CountReady(const size_t pos,const size_t max,const size_t offset)
+        {
+            size_t n=0;
+
+            while(n<max&&cells[(pos+n)&mask].seq.load(std::memory_order_acquire)==pos+n+offset)
+                ++n;
+
+            return n;
+        }
+
+        /**
+         * 抢占最多max个连续位置
+         * @param pos_var enqueue_pos或dequeue_pos
+         * @param offset 入队为0，出队为1
+         * @return 抢到的数量，起始位置写入start
+         */
+        size_t Claim(std::atomic<size_t> &pos_var,const size_t max,const size_t offset,size_t &start)
+        {
+            if(!max)return 0;                                       //否则CountReady恒为0，会被当作被抢先而一直重试
+
+            size_t pos=pos_var.load(std::memory_order_relaxed);
+
+            for(;;)
+            {
+                const size_t n=CountReady(pos,max,offset);
+
+                if(n==0)
+                {
+                    const intptr_t dif=intptr_t(cells[pos&mask].seq.load(std::memory_order_acquire))-intptr_t(pos+offset);
+
+                    if(dif<0)                                       //满（入队）或空（出队）
+                        return 0;
+
+                    pos=pos_var.load(std::memory_order_relaxed);    //被别的线程抢先
+                    continue;
+                }
+
+                if(pos_var.compare_exchange_weak(pos,pos+n,std::memory_order_relaxed,std::memory_order_relaxed))
+                {
+                    start=pos;
+                    return n;
+                }
+            }
+        }
+
+    public:
+
+        using ValueType=T;
+
+        /**
+         * @param cap 容量（会取整到2的幂）
+         */
+        explicit MPMCQueue(size_t cap):capacity(RoundCapacity(cap)),mask(RoundCapacity(cap)-1),cells(new Cell[RoundCapacity(cap)])
+        {
+            for(size_t i=0;i<capacity;i++)
+                cells[i].seq.store(i,std::memory_order_relaxed);
+        }
+
+        ~MPMCQueue()
+        {
+            if constexpr(!std::is_trivially_destructible_v<T>)
+            {
+                const size_t e=enqueue_pos.load(std::memory_order_relaxed);
+
+                for(size_t d=dequeue_pos.load(std::memory_order_relaxed);d!=e;d++)
+                    cells[d&mask].Get()->~T();
+            }
+        }
+
+        NO_COPY_NO_MOVE(MPMCQueue)
+
+        size_t GetCapacity()const{return capacity;}
+
+        /**
+         * 近似的元素数量（含正在写入/读出的）
+         */
+        size_t GetCount()const
+        {
+            const size_t e=enqueue_pos.load(std::memory_order_acquire);
+            const size_t d=dequeue_pos.load(std::memory_order_acquire);
+
+            return e>d?e-d:0;
+        }
+
+        bool IsEmpty()const{return GetCount()==0;}
+
+        template<typename ...ARGS>
+        bool TryEmplace(ARGS &&...args)
+        {
+            size_t pos=0;
+
+            if(!Claim(enqueue_pos,1,0,pos))
+                return(false);
+
+            Cell &c=cells[pos&mask];
+
+            new(c.data) T(std::forward<ARGS>(args)...);
+            c.seq.store(pos+1,std::memory_order_release);
+            return(true);
+        }
+
+        bool TryPush(const T &value){return TryEmplace(value);}
+        bool TryPush(T &&value){return TryEmplace(std::move(value));}
+
+        bool TryPop(T &out)
+        {
+            size_t pos=0;
+
+            if(!Claim(dequeue_pos,1,1,pos))
+                return(false);
+
+            Cell &c=cells[pos&mask];
+            T *p=c.Get();
+
+            out=std::move(*p);
+            p->~T();
+
+            c.seq.store(pos+capacity,std::memory_order_release);
+            return(true);
+        }
+
+        /**
+         * 一次抢占最多count个连续位置并写入
+         * @return 实际写入的数量
+         */
+        size_t PushBatch(const T *items,size_t count)
+        {
+            size_t pos=0;
+            const size_t n=Claim(enqueue_pos,count,0,pos);
+
+            for(size_t i=0;i<n;i++)
+            {
+                Cell &c=cells[(pos+i)&mask];
+
+                new(c.data) T(items[i]);
+                c.seq.store(pos+i+1,std::memory_order_release);
+            }
+
+            return n;
+        }
+
+        /**
+         * 一次抢占最多count个连续位置并取出
+         * @return 实际取出的数量
+         */
+        size_t PopBatch(T *out,size_t count)
+        {
+            size_t pos=0;
+            const size_t n=Claim(dequeue_pos,count,1,pos);
+
+            for(size_t i=0;i<n;i++)
+            {
+                Cell &c=cells[(pos+i)&mask];
+                T *p=c.Get();
+
+                out[i]=std::move(*p);
+                p->~T();
+
+                c.seq.store(pos+i+capacity,std::memory_order_release);
+            }
+
+            return n;
+        }
+    };//template<typename T> class MPMCQueue
+}//namespace hgl
@@ -0,0 +1,205 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<atomic>
+#include<memory>
+
+namespace hgl
+{
+    /**
+     * 变长记录的单生产者/单消费者无锁字节环<br>
+     * 与 SPSCQueue 相同：生产者只写 tail，消费者只写 head，各自缓存对方的下标。
+     * 每条记录前有8字节的帧头，数据按8字节对齐；环尾放不下时写一个填充帧后从头开始，记录总是连续的。
+     *
+     * 生产者：
+     * <pre>
+     * void *p=ring.Reserve(size);      //nullptr表示空间不足
+     * ...写入size字节...
+     * ring.Commit();
+     * </pre>
+     * 消费者：
+     * <pre>
+     * uint32 size;
+     * const void *p=ring.Peek(size);   //nullptr表示没有记录
+     * ...读取...
+     * ring.Release();
+     * </pre>
+     */
+    class alignas(64) SPSCByteRing
+    {
+        static constexpr size_t CACHE_LINE=64;
+
+        struct FrameHeader
+        {
+            uint32 size;                                            ///<数据字节数（不含帧头与对齐）
+            uint32 padding;                                         ///<非0为填充帧
+        };
+
+    public:
+
+        static constexpr size_t FRAME_SIZE=sizeof(FrameHeader);
+        static constexpr size_t ALIGNMENT=8;
+
+    private:
+
+        const size_t capacity;
+        const size_t mask;
+        std::unique_ptr<uint64[]> storage;
+
+        alignas(CACHE_LINE) std::atomic<size_t> tail{0};           ///<生产者写
+        size_t head_cache=0;                                        ///<生产者看到的head
+        size_t reserved=0;                                          ///<Reserve后Commit要发布的tail
+
+        alignas(CACHE_LINE) std::atomic<size_t> head{0};           ///<消费者写
+        size_t tail_cache=0;                                        ///<消费者看到的tail
+        size_t peeked=0;                                            ///<Peek后Release要发布的head
+
+        uint8 *At(const size_t i)const{return reinterpret_cast<uint8 *>(storage.get())+(i&mask);}
+
+        static size_t RoundCapacity(size_t n)
+        {
+            size_t c=256;
+
+            while(c<n)
+                c<<=1;
+
+            return c;
+        }
+
+        static size_t AlignSize(const size_t n){return (n+ALIGNMENT-1)&~(ALIGNMENT-1);}
+
+    public:
+
+        /**
+         * @param cap 字节容量（会取整到2的幂，最小256）
+         */
+        explicit SPSCByteRing(size_t cap)
+            :capacity(RoundCapacity(cap)),mask(RoundCapacity(cap)-1),storage(new uint64[RoundCapacity(cap)/sizeof(uint64)])
+        {
+        }
+
+        NO_COPY_NO_MOVE(SPSCByteRing)
+
+        size_t GetCapacity()const{return capacity;}
+
+        /**
+         * 单条记录的最大数据长度<br>
+         * 限制为容量的一半，保证环尾的填充帧加上记录总能在消费者取空后放下。
+         */
+        size_t GetMaxRecordSize()const{return capacity/2-FRAME_SIZE;}
+
+        /**
+         * 近似的已用字节数
+         */
+        size_t GetUsed()const{return tail.load(std::memory_order_acquire)-head.load(std::memory_order_acquire);}
+        bool IsEmpty()const{return GetUsed()==0;}
+
+        /**
+         * 生产者：已用空间是否超过一半<br>
+         * 先用缓存的head判断，只有缓存值超过一半时才重新读取head，平时不触碰消费者的缓存行。
+         */
+        bool IsHalfFull()
+        {
+            const size_t t=tail.load(std::memory_order_relaxed);
+
+            if(t-head_cache<capacity/2)
+                return(false);
+
+            head_cache=head.load(std::memory_order_acquire);
+
+            return t-head_cache>=capacity/2;
+        }
+
+        /**
+         * 生产者：预留一条记录的空间
+         * @return 数据区指针（8字节对齐），空间不足或记录过长返回nullptr
+         */
+        void *Reserve(const size_t size)
+        {
+            if(size>GetMaxRecordSize())
+                return(nullptr);
+
+            const size_t need=FRAME_SIZE+AlignSize(size);
+
+            size_t t=tail.load(std::memory_order_relaxed);
+
+            const size_t room=capacity-(t&mask);
+            const size_t pad=(room<need)?room:0;                    //环尾放不下，整个跳过
+
+            if(capacity-(t-head_cache)<pad+need)
+            {
+                head_cache=head.load(std::memory_order_acquire);
+
+                if(capacity-(t-head_cache)<pad+need)
+                    return(nullptr);
+            }
+
+            if(pad)
+            {
+                FrameHeader *fh=reinterpret_cast<FrameHeader *>(At(t));
+
+                fh->size=uint32(pad-FRAME_SIZE);
+                fh->padding=1;
+
+                t+=pad;
+            }
+
+            FrameHeader *fh=reinterpret_cast<FrameHeader *>(At(t));
+
+            fh->size=uint32(size);
+            fh->padding=0;
+
+            reserved=t+need;
+            return At(t)+FRAME_SIZE;
+        }
+
+        /**
+         * 生产者：发布最近一次Reserve的记录
+         */
+        void Commit()
+        {
+            tail.store(reserved,std::memory_order_release);
+        }
+
+        /**
+         * 消费者：取得下一条记录，Release之前数据保持有效
+         * @param size 返回数据长度
+         * @return 数据区指针，没有记录返回nullptr
+         */
+        const void *Peek(uint32 &size)
+        {
+            size_t h=head.load(std::memory_order_relaxed);
+
+            for(;;)
+            {
+                if(tail_cache==h)
+                {
+                    tail_cache=tail.load(std::memory_order_acquire);
+
+                    if(tail_cache==h)
+                        return(nullptr);
+                }
+
+                const FrameHeader *fh=reinterpret_cast<const FrameHeader *>(At(h));
+
+                if(!fh->padding)
+                {
+                    size=fh->size;
+                    peeked=h+FRAME_SIZE+AlignSize(fh->size);
+                    return At(h)+FRAME_SIZE;
+                }
+
+                h+=FRAME_SIZE+fh->size;                             //填充帧总是延伸到环尾
+                head.store(h,std::memory_order_release);
+            }
+        }
+
+        /**
+         * 消费者：释放最近一次Peek的记录
+         */
+        void Release()
+        {
+            head.store(peeked,std::memory_order_release);
+        }
+    };//class SPSCByteRing
+}//namespace hgl
@@ -0,0 +1,190 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<atomic>
+#include<memory>
+#include<new>
+#include<utility>
+#include<type_traits>
+#include<algorithm>
+
+namespace hgl
+{
+    /**
+     * 有界单生产者/单消费者无锁环形队列<br>
+     * 生产者只写 tail，消费者只写 head，两者分放在不同的缓存行。
+     * 各自还缓存一份对方的下标：只有缓存值显示“满”或“空”时才去读对方的原子变量，
+     * 稳定流动时每次操作不会触碰对方的缓存行（Rigtorp SPSCQueue 的做法）。
+     *
+     * 对象整体按缓存行对齐，不会与相邻数据共享缓存行。
+     *
+     * 只能有一个线程 Push，一个线程 Pop（可以是不同线程）。
+     */
+    template<typename T> class alignas(64) SPSCQueue
+    {
+        static constexpr size_t CACHE_LINE=64;
+
+        struct alignas(T) Slot
+        {
+            unsigned char data[sizeof(T)];
+        };
+
+        const size_t capacity;
+        const size_t mask;
+        std::unique_ptr<Slot[]> slots;
+
+        alignas(CACHE_LINE) std::atomic<size_t> tail{0};           ///<生产者写
+        size_t head_cache=0;                                        ///<生产者看到的head
+
+        alignas(CACHE_LINE) std::atomic<size_t> head{0};           ///<消费者写
+        size_t tail_cache=0;                                        ///<消费者看到的tail
+
+        T *At(size_t i){return std::launder(reinterpret_cast<T *>(slots[i&mask].data));}
+
+        static size_t RoundCapacity(size_t n)
+        {
+            size_t c=2;
+
+            while(c<n)
+                c<<=1;
+
+            return c;
+        }
+
+        /**
+         * 生产者：可写入的数量，缓存值不足want时才重新读取head
+         */
+        size_t FreeForPush(const size_t t,const size_t want)
+        {
+            size_t n=capacity-(t-head_cache);
+
+            if(n<want)
+            {
+                head_cache=head.load(std::memory_order_acquire);
+                n=capacity-(t-head_cache);
+            }
+
+            return n;
+        }
+
+        /**
+         * 消费者：可读取的数量，缓存值不足want时才重新读取tail
+         */
+        size_t ReadyForPop(const size_t h,const size_t want)
+        {
+            size_t n=tail_cache-h;
+
+            if(n<want)
+            {
+                tail_cache=tail.load(std::memory_order_acquire);
+                n=tail_cache-h;
+            }
+
+            return n;
+        }
+
+    public:
+
+        using ValueType=T;
+
+        /**
+         * @param cap 容量（会取整到2的幂）
+         */
+        explicit SPSCQueue(size_t cap):capacity(RoundCapacity(cap)),mask(RoundCapacity(cap)-1),slots(new Slot[RoundCapacity(cap)]){}
+
+        ~SPSCQueue()
+        {
+            if constexpr(!std::is_trivially_destructible_v<T>)
+            {
+                const size_t t=tail.load(std::memory_order_relaxed);
+
+                for(size_t h=head.load(std::memory_order_relaxed);h!=t;h++)
+                    At(h)->~T();
+            }
+        }
+
+        NO_COPY_NO_MOVE(SPSCQueue)
+
+        size_t GetCapacity()const{return capacity;}
+
+        /**
+         * 近似的元素数量
+         */
+        size_t GetCount()const{return tail.load(std::memory_order_acquire)-head.load(std::memory_order_acquire);}
+        bool IsEmpty()const{return GetCount()==0;}
+
+        template<typename ...ARGS>
+        bool TryEmplace(ARGS &&...args)
+        {
+            const size_t t=tail.load(std::memory_order_relaxed);
+
+            if(FreeForPush(t,1)==0)
+                return(false);
+
+            new(slots[t&mask].data) T(std::forward<ARGS>(args)...);
+
+            tail.store(t+1,std::memory_order_release);
+            return(true);
+        }
+
+        bool TryPush(const T &value){return TryEmplace(value);}
+        bool TryPush(T &&value){return TryEmplace(std::move(value));}
+
+        bool TryPop(T &out)
+        {
+            const size_t h=head.load(std::memory_order_relaxed);
+
+            if(ReadyForPop(h,1)==0)
+                return(false);
+
+            T *p=At(h);
+
+            out=std::move(*p);
+            p->~T();
+
+            head.store(h+1,std::memory_order_release);
+            return(true);
+        }
+
+        /**
+         * 尽量写入count个元素，只发布一次
+         * @return 实际写入的数量
+         */
+        size_t PushBatch(const T *items,size_t count)
+        {
+            const size_t t=tail.load(std::memory_order_relaxed);
+            const size_t n=std::min(count,FreeForPush(t,count));
+
+            for(size_t i=0;i<n;i++)
+                new(slots[(t+i)&mask].data) T(items[i]);
+
+            if(n)
+                tail.store(t+n,std::memory_order_release);
+
+            return n;
+        }
+
+        /**
+         * 尽量取出最多count个元素，只发布一次
+         * @return 实际取出的数量
+         */
+        size_t PopBatch(T *out,size_t count)
+        {
+            const size_t h=head.load(std::memory_order_relaxed);
+            const size_t n=std::min(count,ReadyForPop(h,count));
+
+            for(size_t i=0;i<n;i++)
+            {
+                T *p=At(h+i);
+
+                out[i]=std::move(*p);
+                p->~T();
+            }
+
+            if(n)
+                head.store(h+n,std::memory_order_release);
+
+            return n;
+        }
+    };//template<typename T> class SPSCQueue
+}//namespace hgl
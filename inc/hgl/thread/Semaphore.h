@@ -0,0 +1,176 @@
+﻿#pragma once
+
+#include<hgl/thread/Futex.h>
+#include<algorithm>
+
+namespace hgl
+{
+    /**
+     * 轻量信号量<br>
+     * 计数在用户态原子变量中，负数表示有多少线程已经阻塞。有计数时 Acquire 只是一次CAS，
+     * 没有阻塞者时 Release 只是一次加法，都不进入内核；只有真正需要唤醒阻塞者时才发出与被唤醒人数相同的唤醒令牌并 FutexWake，
+     * 被唤醒者尚未运行时后续的 Release 不会重复进行系统调用。
+     * 计数为0时（多CPU下）先短暂自旋，然后在唤醒令牌上挂起。
+     *
+     * 参见 Jeff Preshing 的 LightweightSemaphore。
+     */
+    class Semaphore
+    {
+        std::atomic<int32> count;                                   ///<可用计数，负数为阻塞线程数
+        std::atomic<uint32> wakeups{0};                             ///<已发出尚未被领取的唤醒令牌
+
+    public:
+
+        static constexpr int SPIN_COUNT=64;                         ///<挂起前的自旋次数
+
+    private:
+
+        bool TryDecrement()
+        {
+            int32 c=count.load(std::memory_order_relaxed);
+
+            while(c>0)
+                if(count.compare_exchange_weak(c,c-1,std::memory_order_acquire,std::memory_order_relaxed))
+                    return(true);
+
+            return(false);
+        }
+
+        /**
+         * 领取一个唤醒令牌
+         * @param timeout_us <0为不超时
+         */
+        bool TakeWakeup(const int64 timeout_us)
+        {
+            const auto deadline=std::chrono::steady_clock::now()+std::chrono::microseconds(timeout_us<0?0:timeout_us);
+
+            for(;;)
+            {
+                uint32 w=wakeups.load(std::memory_order_acquire);
+
+                while(w>0)
+                    if(wakeups.compare_exchange_weak(w,w-1,std::memory_order_acquire,std::memory_order_relaxed))
+                        return(true);
+
+                int64 remain=-1;
+
+                if(timeout_us>=0)
+                {
+                    remain=std::chrono::duration_cast<std::chrono::microseconds>(deadline-std::chrono::steady_clock::now()).count();
+
+                    if(remain<=0)
+                        return(false);
+                }
+
+                FutexWait(wakeups,0,remain);
+            }
+        }
+
+        bool AcquireSlow(const int64 timeout_us)
+        {
+            const int spin=IsSpinUseful()?SPIN_COUNT:0;
+
+            for(int i=0;i<spin;i++)
+            {
+                CpuPause();
+
+                if(TryDecrement())
+                    return(true);
+            }
+
+            if(timeout_us==0)
+                return(false);
+
+            if(count.fetch_sub(1,std::memory_order_acquire)>0)              //减完仍有计数，直接得到
+                return(true);
+
+            if(TakeWakeup(timeout_us))
+                return(true);
+
+            //超时：撤销登记；撤销前若已有 Release 算上了自己，它的唤醒令牌一定会到，必须领取
+            int32 c=count.load(std::memory_order_relaxed);
+
+            while(c<0)
+                if(count.compare_exchange_weak(c,c+1,std::memory_order_relaxed,std::memory_order_relaxed))
+                    return(false);
+
+            TakeWakeup(-1);
+            return(true);
+        }
+
+    public:
+
+        explicit Semaphore(uint32 initial=0):count(int32(initial)){}
+        ~Semaphore()=default;
+
+        NO_COPY_NO_MOVE(Semaphore)
+
+        bool TryAcquire(){return TryDecrement();}
+
+        /**
+         * 不阻塞地获取最多max个计数
+         * @return 实际获取的数量
+         */
+        uint32 TryAcquireMany(const uint32 max)
+        {
+            int32 c=count.load(std::memory_order_relaxed);
+
+            while(c>0)
+            {
+                const int32 n=std::min(c,int32(max));
+
+                if(count.compare_exchange_weak(c,c-n,std::memory_order_acquire,std::memory_order_relaxed))
+                    return uint32(n);
+            }
+
+            return 0;
+        }
+
+        /**
+         * 获取一个计数，没有时阻塞
+         */
+        void Acquire()
+        {
+            if(!TryDecrement())
+                AcquireSlow(-1);
+        }
+
+        /**
+         * 获取一个计数，最多等待timeout_us微秒
+         * @return 超时返回false
+         */
+        bool Acquire(const int64 timeout_us)
+        {
+            return TryDecrement()||AcquireSlow(timeout_us<0?0:timeout_us);
+        }
+
+        /**
+         * 释放n个计数
+         */
+        void Release(const uint32 n=1)
+        {
+            if(n==0)
+                return;
+
+            const int32 old=count.fetch_add(int32(n),std::memory_order_release);
+
+            if(old>=0)                                                      //没有阻塞者
+                return;
+
+            const uint32 wake=std::min(uint32(-old),n);
+
+            wakeups.fetch_add(wake,std::memory_order_release);
+            FutexWake(wakeups,int(wake));
+        }
+
+        /**
+         * 可用计数（有线程阻塞时为0）
+         */
+        uint32 GetCount()const
+        {
+            const int32 c=count.load(std::memory_order_relaxed);
+
+            return c>0?uint32(c):0;
+        }
+    };//class Semaphore
+}//namespace hgl
@@ -0,0 +1,137 @@
+﻿#pragma once
+
+#include<hgl/thread/Futex.h>
+#include<type_traits>
+#include<cstring>
+
+namespace hgl
+{
+    /**
+     * 顺序锁，用于读多写少的小块数据（如时间戳、统计值、相机参数）<br>
+     * 读者完全不写共享内存：读序号、复制数据、再读序号，两次序号相同且为偶数即读到完整的一份，否则重试。
+     * 读者之间、读者与写者之间都没有缓存行争抢，读取开销接近直接复制。
+     * 写者之间用序号本身互斥（奇数表示正在写）。
+     *
+     * 数据按8字节原子字保存并用relaxed原子操作读写，读者与写者并发时没有数据竞争（Boehm, "Can Seqlocks Get Along with Programming Language Memory Models?"）。
+     *
+     * T必须可平凡复制。写者很频繁时读者可能反复重试。
+     */
+    template<typename T> class SeqLock
+    {
+        static_assert(std::is_trivially_copyable_v<T>,"SeqLock only holds trivially copyable types");
+
+        static constexpr size_t WORDS=(sizeof(T)+7)/8;
+
+        alignas(64) std::atomic<uint32> seq{0};
+        std::atomic<uint64> data[WORDS];
+
+        void CopyOut(T &out)const
+        {
+            uint64 tmp[WORDS];
+
+            for(size_t i=0;i<WORDS;i++)
+                tmp[i]=data[i].load(std::memory_order_relaxed);
+
+            memcpy(&out,tmp,sizeof(T));
+        }
+
+        void CopyIn(const T &value)
+        {
+            uint64 tmp[WORDS]={};
+
+            memcpy(tmp,&value,sizeof(T));
+
+            for(size_t i=0;i<WORDS;i++)
+                data[i].store(tmp[i],std::memory_order_relaxed);
+        }
+
+        uint32 WriteBegin()
+        {
+            Backoff backoff;
+
+            for(;;)
+            {
+                uint32 s=seq.load(std::memory_order_relaxed);
+
+                if(!(s&1)&&seq.compare_exchange_weak(s,s+1,std::memory_order_relaxed,std::memory_order_relaxed))
+                {
+                    std::atomic_thread_fence(std::memory_order_release);    //序号变为奇数先于数据写入被看到
+                    return s;
+                }
+
+                backoff.Pause();
+            }
+        }
+
+        void WriteEnd(const uint32 s)
+        {
+            seq.store(s+2,std::memory_order_release);
+        }
+
+    public:
+
+        SeqLock(){CopyIn(T{});}
+        explicit SeqLock(const T &value){CopyIn(value);}
+
+        NO_COPY_NO_MOVE(SeqLock)
+
+        /**
+         * 尝试读取一次，与写者冲突时返回false
+         */
+        bool TryLoad(T &out)const
+        {
+            const uint32 s0=seq.load(std::memory_order_acquire);
+
+            if(s0&1)
+                return(false);
+
+            CopyOut(out);
+
+            std::atomic_thread_fence(std::memory_order_acquire);            //数据读取先于第二次读序号
+
+            return seq.load(std::memory_order_relaxed)==s0;
+        }
+
+        /**
+         * 读取完整的一份数据（冲突时重试）
+         */
+        T Load()const
+        {
+            T result;
+
+            while(!TryLoad(result))
+                CpuPause();
+
+            return result;
+        }
+
+        void Store(const T &value)
+        {
+            const uint32 s=WriteBegin();
+
+            CopyIn(value);
+            WriteEnd(s);
+        }
+
+        /**
+         * 读出-修改-写回，func(T &)在写锁内执行，期间其它写者等待
+         */
+        template<typename F>
+        void Update(F &&func)
+        {
+            const uint32 s=WriteBegin();
+
+            T value;
+            CopyOut(value);
+            func(value);
+            CopyIn(value);
+
+            WriteEnd(s);
+        }
+
+        /**
+         * 写入次数
+         */
+        uint32 GetVersion()const{return seq.load(std::memory_order_acquire)>>1;}
+    };//template<typename T> class SeqLock
+}//namespace hgl
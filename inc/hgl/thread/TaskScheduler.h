@@ -0,0 +1,435 @@
+﻿#pragma once
+
+#include<hgl/thread/WorkStealingDeque.h>
+#include<hgl/type/SlabPool.h>
+#include<atomic>
+#include<mutex>
+#include<condition_variable>
+#include<thread>
+#include<deque>
+#include<vector>
+#include<memory>
+#include<utility>
+#include<type_traits>
+#include<algorithm>
+#include<cstring>
+#include<new>
+
+namespace hgl
+{
+    class TaskScheduler;
+
+    namespace task_detail
+    {
+        constexpr size_t INLINE_BYTES=48;                           ///<可调用对象不超过此长度时直接存放在任务中
+
+        /**
+         * 任务
+         */
+        struct Task
+        {
+            void (*invoke)(Task *)=nullptr;                         ///<调用可调用对象
+            void (*destroy)(Task *)=nullptr;                        ///<析构可调用对象
+
+            alignas(16) uint8 storage[INLINE_BYTES];                ///<可调用对象，或指向堆上可调用对象的指针
+
+            TaskScheduler *scheduler=nullptr;
+
+            std::atomic<int32> pending{1};                          ///<未完成的前置任务数+1(尚未提交)
+            std::atomic<int32> refs{1};
+            std::atomic<uint32> done{0};
+            std::atomic<bool> submitted{false};
+            std::atomic<bool> cancelled{false};                     ///<前置任务未提交就被释放，不再执行
+
+            std::mutex successor_lock;
+            std::vector<Task *> successors;                         ///<完成后要通知的后续任务（各持有一个引用）
+            bool finished=false;                                    ///<由successor_lock保护
+
+            template<typename F>
+            void SetCallable(F &&f)
+            {
+                using L=std::decay_t<F>;
+
+                if constexpr(sizeof(L)<=INLINE_BYTES&&alignof(L)<=16)
+                {
+                    new(storage) L(std::forward<F>(f));
+
+                    invoke =[](Task *t){(*std::launder(reinterpret_cast<L *>(t->storage)))();};
+                    destroy=[](Task *t){std::launder(reinterpret_cast<L *>(t->storage))->~L();};
+                }
+                else
+                {
+                    L *p=new L(std::forward<F>(f));
+
+                    memcpy(storage,&p,sizeof(p));
+
+                    invoke =[](Task *t){L *p;memcpy(&p,t->storage,sizeof(p));(*p)();};
+                    destroy=[](Task *t){L *p;memcpy(&p,t->storage,sizeof(p));delete p;};
+                }
+            }
+        };//struct Task
+    }//namespace task_detail
+
+    /**
+     * 任务句柄（引用计数）
+     */
+    class TaskRef
+    {
+        task_detail::Task *task=nullptr;
+
+        friend class TaskScheduler;
+
+        explicit TaskRef(task_detail::Task *t):task(t){}                //接管一个引用
+
+    public:
+
+        TaskRef()=default;
+        TaskRef(const TaskRef &tr):task(tr.task){if(task)task->refs.fetch_add(1,std::memory_order_relaxed);}
+        TaskRef(TaskRef &&tr)noexcept:task(tr.task){tr.task=nullptr;}
+        ~TaskRef(){Reset();}
+
+        TaskRef &operator=(const TaskRef &tr)
+        {
+            if(this!=&tr)
+            {
+                TaskRef tmp(tr);
+                std::swap(task,tmp.task);
+            }
+
+            return *this;
+        }
+
+        TaskRef &operator=(TaskRef &&tr)noexcept
+        {
+            std::swap(task,tr.task);
+            return *this;
+        }
+
+        inline void Reset();
+
+        bool IsValid()const{return task!=nullptr;}
+        explicit operator bool()const{return task!=nullptr;}
+
+        bool IsSubmitted()const{return task&&task->submitted.load(std::memory_order_acquire);}
+        bool IsDone()const{return task&&task->done.load(std::memory_order_acquire);}
+        bool IsCancelled()const{return task&&task->cancelled.load(std::memory_order_acquire);}
+    };//class TaskRef
+
+    /**
+     * 工作窃取任务调度器<br>
+     * <ul>
+     *  <li>每个工作线程一个 Chase-Lev 双端队列：任务中产生的新任务压入自己的队列，空闲线程从别的队列顶部窃取</li>
+     *  <li>非工作线程提交的任务进入一个加锁的注入队列</li>
+     *  <li>任务之间可以设置依赖（AddDependency）与后续任务（Then），前置任务全部完成后才会被调度</li>
+     *  <li>Wait/ParallelFor 的调用线程在等待期间也执行任务，工作线程数量为0时全部任务由调用线程执行</li>
+     *  <li>Linux下可把工作线程绑定到CPU，并按NUMA节点分配，窃取时优先选择同一节点的线程</li>
+     * </ul>
+     *
+     * 任务对象从 SlabPool 分配；不超过48字节的可调用对象直接存放在任务中。
+     */
+    class TaskScheduler
+    {
+    public:
+
+        struct Config
+        {
+            int  worker_count   =-1;                                ///<工作线程数量，-1为CPU数量-1（至少1）
+            bool pin_threads    =false;                             ///<把每个工作线程绑定到一个CPU（仅Linux）
+            bool numa_aware     =false;                             ///<按NUMA节点轮流分配工作线程，优先窃取同节点任务（仅Linux）
+        };
+
+    private:
+
+        using Task=task_detail::Task;
+
+        struct alignas(64) Worker
+        {
+            TaskScheduler *scheduler=nullptr;
+            int index=0;
+            int numa_node=0;
+            int cpu=-1;                                             ///<绑定的CPU，-1为未绑定
+
+            WorkStealingDeque<Task *> deque;
+            std::vector<int> victims;                               ///<窃取顺序：同节点的在前
+            uint64 rng=0;
+
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        int numa_node_count=1;
+        std::vector<std::vector<int>> node_cpus;                    ///<各NUMA节点可用的CPU（仅numa_aware时）
+
+        SlabPool<Task> task_pool;
+
+        std::mutex inject_lock;
+        std::deque<Task *> inject_queue;
+        std::atomic<int64> inject_count{0};
+
+        alignas(64) std::atomic<int32> sleeping{0};
+        std::mutex sleep_lock;
+        std::condition_variable sleep_cv;
+        int wake_signals=0;                                         ///<由sleep_lock保护
+        bool stopping=false;                                        ///<由sleep_lock保护
+        std::atomic<bool> stop_flag{false};
+
+        std::atomic<int64> live_tasks{0};                           ///<已提交尚未完成的任务数
+
+    private:
+
+        friend class TaskRef;
+
+        void PlaceWorkers(const Config &);
+        void WorkerMain(Worker *);
+
+        Worker *GetCurrentWorker()const;
+
+        Task *FindWork(Worker *self);
+        bool HasWork()const;
+        void WakeWorker();
+
+        void Schedule(Task *);
+        void Execute(Task *);
+        void Finish(Task *);
+        void ReleaseTask(Task *);
+
+        Task *AllocTask()
+        {
+            Task *t=task_pool.Create();
+
+            t->scheduler=this;
+            return t;
+        }
+
+        template<typename F>
+        Task *CreateTask(F &&f)
+        {
+            Task *t=AllocTask();
+
+            t->SetCallable(std::forward<F>(f));
+            return t;
+        }
+
+        /**
+         * 创建并立即调度一个内部任务（没有句柄）
+         */
+        template<typename F>
+        void Spawn(F &&f)
+        {
+            Task *t=CreateTask(std::forward<F>(f));
+
+            t->submitted.store(true,std::memory_order_relaxed);
+            t->pending.store(0,std::memory_order_relaxed);
+
+            live_tasks.fetch_add(1,std::memory_order_relaxed);
+            Schedule(t);
+        }
+
+        /**
+         * 当前线程自己的队列是否为空（非工作线程看注入队列）
+         */
+        bool LocalQueueEmpty()const
+        {
+            Worker *w=GetCurrentWorker();
+
+            return w?w->deque.IsEmpty():inject_count.load(std::memory_order_relaxed)==0;
+        }
+
+        /**
+         * 执行一个找到的任务，没有找到返回false
+         */
+        bool HelpOnce();
+
+        template<typename F>
+        struct ForState
+        {
+            F *body;
+            int64 grain;
+            std::atomic<int64> remaining;
+        };
+
+        template<typename F>
+        static void CallRange(F &body,int64 b,const int64 e)
+        {
+            if constexpr(std::is_invocable_v<F &,int64,int64>)
+                body(b,e);
+            else
+                for(;b<e;b++)
+                    body(b);
+        }
+
+        /**
+         * 惰性二分：本线程队列为空（说明其它线程可能缺活）时才把剩余区间对半分出去，否则按粒度顺序执行
+         */
+        template<typename F>
+        void ForRange(ForState<F> *state,int64 b,int64 e)
+        {
+            while(b<e)
+            {
+                if(e-b>state->grain*2&&LocalQueueEmpty())
+                {
+                    const int64 mid=b+(e-b)/2;
+
+                    Spawn([this,state,mid,e]{ForRange(state,mid,e);});
+                    e=mid;
+                    continue;
+                }
+
+                const int64 c=std::min(e,b+state->grain);
+
+                CallRange(*state->body,b,c);
+
+                const int64 n=c-b;
+                b=c;
+
+                state->remaining.fetch_sub(n,std::memory_order_acq_rel);    //此后不能再访问state（调用方可能已返回）
+            }
+        }
+
+    public:
+
+        explicit TaskScheduler(const Config &config);
+        TaskScheduler():TaskScheduler(Config()){}
+        ~TaskScheduler();
+
+        NO_COPY_NO_MOVE(TaskScheduler)
+
+        /**
+         * 全局默认调度器（首次使用时创建）
+         */
+        static TaskScheduler &Default();
+
+        int GetWorkerCount()const{return int(workers.size());}
+        int GetThreadCount()const{return int(workers.size())+1;}            ///<含调用线程
+        int GetNumaNodeCount()const{return numa_node_count;}
+
+        /**
+         * 当前线程在本调度器中的工作线程序号，非工作线程返回-1
+         */
+        int GetCurrentWorkerIndex()const
+        {
+            Worker *w=GetCurrentWorker();
+
+            return w?w->index:-1;
+        }
+
+        /**
+         * 取得工作线程绑定的CPU，未绑定返回-1
+         */
+        int GetWorkerCpu(int index)const{return (index>=0&&index<GetWorkerCount())?workers[index]->cpu:-1;}
+        int GetWorkerNumaNode(int index)const{return (index>=0&&index<GetWorkerCount())?workers[index]->numa_node:-1;}
+
+        /**
+         * 创建任务，在 Submit 之前不会执行（可以先设置依赖）
+         */
+        template<typename F>
+        TaskRef Create(F &&f)
+        {
+            return TaskRef(CreateTask(std::forward<F>(f)));
+        }
+
+        /**
+         * 提交任务，前置任务全部完成后被调度
+         * @return 任务无效或已提交过返回false
+         */
+        bool Submit(const TaskRef &);
+
+        /**
+         * 创建并提交任务
+         */
+        template<typename F>
+        TaskRef Run(F &&f)
+        {
+            TaskRef tr=Create(std::forward<F>(f));
+
+            Submit(tr);
+            return tr;
+        }
+
+        /**
+         * 设置依赖：after 在 before 完成后才执行<br>
+         * before 尚未提交就释放了最后一个引用时，after 被取消：不再执行，但照常视为完成（Wait返回，并继续取消它的后续任务）
+         * @return after 已经提交过（可能已在执行）时返回false
+         */
+        bool AddDependency(const TaskRef &before,const TaskRef &after);
+
+        /**
+         * 创建 before 的后续任务并提交
+         */
+        template<typename F>
+        TaskRef Then(const TaskRef &before,F &&f)
+        {
+            TaskRef tr=Create(std::forward<F>(f));
+
+            AddDependency(before,tr);
+            Submit(tr);
+            return tr;
+        }
+
+        /**
+         * 等待任务完成，等待期间执行其它任务
+         * @return 任务无效或未提交时返回false
+         */
+        bool Wait(const TaskRef &);
+
+        /**
+         * 等待所有已提交的任务完成
+         */
+        void WaitAll();
+
+        /**
+         * 对[begin,end)并行执行body<br>
+         * body可以是 body(int64 i) 或 body(int64 range_begin,int64 range_end)，后者可以直接调用现有的批量处理函数。
+         * grain为每次调用body处理的最多元素数，也是可被其它线程窃取的最小区间；0时按线程数自动取值（约每线程8段）。
+         * 区间只在本线程队列为空（其它线程可能缺活）时才对半拆分，所以实际拆分数随空闲线程数自适应。
+         * 调用线程也参与执行，返回时全部执行完毕。
+         */
+        template<typename F>
+        void ParallelFor(const int64 begin,const int64 end,F &&body,int64 grain=0)
+        {
+            if(end<=begin)
+                return;
+
+            const int64 n=end-begin;
+
+            if(grain<=0)
+                grain=std::max<int64>(1,n/(int64(GetThreadCount())*8));
+
+            if(workers.empty()||n<=grain)
+            {
+                for(int64 b=begin;b<end;b+=grain)
+                    CallRange(body,b,std::min(end,b+grain));
+
+                return;
+            }
+
+            using Body=std::remove_reference_t<F>;
+
+            ForState<Body> state{&body,grain,{n}};
+
+            ForRange(&state,begin,end);
+
+            while(state.remaining.load(std::memory_order_acquire)>0)
+                if(!HelpOnce())
+                    std::this_thread::yield();
+        }
+    };//class TaskScheduler
+
+    inline void TaskRef::Reset()
+    {
+        if(task)
+        {
+            task->scheduler->ReleaseTask(task);
+            task=nullptr;
+        }
+    }
+
+    /**
+     * 在默认调度器上并行执行，见 TaskScheduler::ParallelFor
+     */
+    template<typename F>
+    inline void parallel_for(const int64 begin,const int64 end,F &&body,const int64 grain=0)
+    {
+        TaskScheduler::Default().ParallelFor(begin,end,std::forward<F>(body),grain);
+    }
+}//namespace hgl
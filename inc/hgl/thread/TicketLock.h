@@ -0,0 +1,81 @@
+﻿#pragma once
+
+#include<hgl/thread/Futex.h>
+#include<algorithm>
+
+namespace hgl
+{
+    /**
+     * 排队自旋锁<br>
+     * 按申请顺序获得锁（公平，不会饿死）。等待时按自己前面排队的线程数量退避，
+     * 前面人越多等得越久，减少对 serving 所在缓存行的争抢；退避到上限后让出时间片。
+     *
+     * 只适合极短的临界区，且线程数最好不超过CPU数：排在前面的线程被换出时后面全部要等它重新被调度。
+     * 同时提供 lock/unlock/try_lock，可以配合 std::lock_guard 使用。
+     */
+    class TicketLock
+    {
+        alignas(64) std::atomic<uint32> next{0};                   ///<下一个发出的号
+        alignas(64) std::atomic<uint32> serving{0};                ///<当前持有锁的号
+
+    public:
+
+        static constexpr uint32 PAUSE_PER_WAITER=32;                ///<前面每个等待者对应的pause数
+
+        TicketLock()=default;
+        ~TicketLock()=default;
+
+        NO_COPY_NO_MOVE(TicketLock)
+
+        void Lock()
+        {
+            const uint32 ticket=next.fetch_add(1,std::memory_order_relaxed);
+
+            uint32 cur=serving.load(std::memory_order_acquire);
+
+            if(cur==ticket)
+                return;
+
+            Backoff backoff;
+
+            for(;;)
+            {
+                const uint32 ahead=ticket-cur;
+
+                if(ahead>1)                                         //前面还有别的等待者：按人数估计等待时间
+                {
+                    const uint32 n=std::min((ahead-1)*PAUSE_PER_WAITER,Backoff::MAX_PAUSE);
+
+                    for(uint32 i=0;i<n;i++)
+                        CpuPause();
+                }
+
+                backoff.Pause();                                    //持锁者迟迟不释放（可能被换出）时逐渐退避到让出时间片
+
+                cur=serving.load(std::memory_order_acquire);
+
+                if(cur==ticket)
+                    return;
+            }
+        }
+
+        bool TryLock()
+        {
+            const uint32 cur=serving.load(std::memory_order_acquire);
+            uint32 expected=cur;
+
+            return next.compare_exchange_strong(expected,cur+1,std::memory_order_acquire,std::memory_order_relaxed);
+        }
+
+        void Unlock()
+        {
+            serving.store(serving.load(std::memory_order_relaxed)+1,std::memory_order_release);
+        }
+
+        bool IsLocked()const{return next.load(std::memory_order_relaxed)!=serving.load(std::memory_order_relaxed);}
+
+        void lock(){Lock();}
+        bool try_lock(){return TryLock();}
+        void unlock(){Unlock();}
+    };//class TicketLock
+}//namespace hgl
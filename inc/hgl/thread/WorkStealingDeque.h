@@ -0,0 +1,154 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<atomic>
+#include<vector>
+#include<memory>
+#include<type_traits>
+
+namespace hgl
+{
+    /**
+     * Chase-Lev 工作窃取双端队列<br>
+     * 所有者线程在底部 Push/Pop（后进先出，缓存友好），其它线程从顶部 Steal（先进先出，偷到的是最早、通常也是最大的任务）。
+     * 所有者操作无锁且通常无原子读改写，只有与窃取者争最后一个元素时才用CAS。
+     *
+     * 内存序按 Lê, Pop, Cohen, Zappa Nardelli (PPoPP 2013) 的C11版本，栅栏改为等价的seq_cst原子操作。
+     * 扩容时旧的环形数组保留到队列销毁，窃取者可能仍在读取。
+     *
+     * T必须是可平凡复制、不超过8字节的类型（通常是指针）。
+     */
+    template<typename T> class WorkStealingDeque
+    {
+        static_assert(std::is_trivially_copyable_v<T>&&sizeof(T)<=8,"WorkStealingDeque only stores small trivially copyable values");
+
+        struct Ring
+        {
+            int64 capacity;
+            int64 mask;
+            std::unique_ptr<std::atomic<T>[]> items;
+
+            explicit Ring(int64 cap):capacity(cap),mask(cap-1),items(new std::atomic<T>[size_t(cap)]){}
+
+            T Get(int64 i)const{return items[size_t(i&mask)].load(std::memory_order_relaxed);}
+            void Put(int64 i,T v){items[size_t(i&mask)].store(v,std::memory_order_relaxed);}
+        };
+
+        alignas(64) std::atomic<int64> top{0};                     ///<窃取端
+        alignas(64) std::atomic<int64> bottom{0};                  ///<所有者端
+        std::atomic<Ring *> ring;
+
+        std::vector<std::unique_ptr<Ring>> rings;                   ///<全部环形数组（含已替换的），只由所有者修改
+
+        Ring *Grow(Ring *old,const int64 b,const int64 t)
+        {
+            Ring *r=new Ring(old->capacity*2);
+
+            for(int64 i=t;i<b;i++)
+                r->Put(i,old->Get(i));
+
+            rings.emplace_back(r);
+            ring.store(r,std::memory_order_release);
+            return r;
+        }
+
+    public:
+
+        /**
+         * @param capacity 初始容量（会取整到2的幂），满时自动加倍
+         */
+        explicit WorkStealingDeque(int64 capacity=256)
+        {
+            int64 cap=16;
+
+            while(cap<capacity)
+                cap<<=1;
+
+            rings.emplace_back(new Ring(cap));
+            ring.store(rings.back().get(),std::memory_order_relaxed);
+        }
+
+        NO_COPY_NO_MOVE(WorkStealingDeque)
+
+        /**
+         * 压入底部（仅所有者线程）
+         */
+        void Push(T value)
+        {
+            const int64 b=bottom.load(std::memory_order_relaxed);
+            const int64 t=top.load(std::memory_order_acquire);
+            Ring *r=ring.load(std::memory_order_relaxed);
+
+            if(b-t>=r->capacity)
+                r=Grow(r,b,t);
+
+            r->Put(b,value);
+            bottom.store(b+1,std::memory_order_release);
+        }
+
+        /**
+         * 从底部取出（仅所有者线程）
+         */
+        bool Pop(T &value)
+        {
+            const int64 b=bottom.load(std::memory_order_relaxed)-1;
+            Ring *r=ring.load(std::memory_order_relaxed);
+
+            bottom.store(b,std::memory_order_seq_cst);
+
+            int64 t=top.load(std::memory_order_seq_cst);
+
+            if(t>b)                                                 //空
+            {
+                bottom.store(b+1,std::memory_order_relaxed);
+                return false;
+            }
+
+            value=r->Get(b);
+
+            if(t==b)                                                //最后一个，与窃取者竞争
+            {
+                const bool won=top.compare_exchange_strong(t,t+1,std::memory_order_seq_cst,std::memory_order_relaxed);
+
+                bottom.store(b+1,std::memory_order_relaxed);
+                return won;
+            }
+
+            return true;
+        }
+
+        /**
+         * 从顶部窃取（任意线程）
+         * @return 队列为空或与其它线程竞争失败时返回false
+         */
+        bool Steal(T &value)
+        {
+            int64 t=top.load(std::memory_order_seq_cst);
+            const int64 b=bottom.load(std::memory_order_seq_cst);
+
+            if(t>=b)
+                return false;
+
+            const Ring *r=ring.load(std::memory_order_acquire);
+
+            value=r->Get(t);
+
+            return top.compare_exchange_strong(t,t+1,std::memory_order_seq_cst,std::memory_order_relaxed);
+        }
+
+        /**
+         * 近似的元素数量（其它线程同时操作时仅供参考）
+         */
+        int64 GetCount()const
+        {
+            const int64 b=bottom.load(std::memory_order_relaxed);
+            const int64 t=top.load(std::memory_order_relaxed);
+
+            return b>t?b-t:0;
+        }
+
+        bool IsEmpty()const{return GetCount()==0;}
+
+        int64 GetCapacity()const{return ring.load(std::memory_order_relaxed)->capacity;}
+    };//template<typename T> class WorkStealingDeque
+}//namespace hgl
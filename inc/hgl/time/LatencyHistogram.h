@@ -0,0 +1,207 @@
+﻿#pragma once
+
+#include<hgl/time/TscClock.h>
+#include<atomic>
+#include<bit>
+
+namespace hgl
+{
+    /**
+     * HDR风格的延迟直方图（对数分段+段内线性细分）<br>
+     * 小于32的值各占一个桶；更大的值按2的幂分段，每段再均分32个桶，相对误差不超过1/32（约3%）。
+     * 覆盖完整的uint64范围，不需要预先指定上限。
+     *
+     * 计数为relaxed原子变量，多个线程可以同时 Record()；统计类函数读到的是近似一致的快照。
+     */
+    class LatencyHistogram
+    {
+    public:
+
+        static constexpr uint32 SUB_BITS    =5;
+        static constexpr uint64 SUB_COUNT   =uint64(1)<<SUB_BITS;
+        static constexpr size_t BUCKET_COUNT=size_t((64-SUB_BITS+1)*SUB_COUNT);
+
+    private:
+
+        std::atomic<uint64> buckets[BUCKET_COUNT];
+        std::atomic<uint64> total{0};
+        std::atomic<uint64> sum{0};
+        std::atomic<uint64> min_value{~uint64(0)};
+        std::atomic<uint64> max_value{0};
+
+    public:
+
+        static size_t BucketIndex(const uint64 v)
+        {
+            if(v<SUB_COUNT)
+                return size_t(v);
+
+            const uint32 shift=uint32(std::bit_width(v))-1-SUB_BITS;
+
+            return size_t((shift+1)*SUB_COUNT+((v>>shift)-SUB_COUNT));
+        }
+
+        /**
+         * 桶能表示的最小值
+         */
+        static uint64 BucketLowerBound(const size_t index)
+        {
+            if(index<SUB_COUNT)
+                return index;
+
+            const uint32 shift=uint32(index/SUB_COUNT)-1;
+
+            return (SUB_COUNT+index%SUB_COUNT)<<shift;
+        }
+
+        /**
+         * 桶能表示的最大值
+         */
+        static uint64 BucketUpperBound(const size_t index)
+        {
+            if(index<SUB_COUNT)
+                return index;
+
+            const uint32 shift=uint32(index/SUB_COUNT)-1;
+
+            return BucketLowerBound(index)+((uint64(1)<<shift)-1);
+        }
+
+    public:
+
+        LatencyHistogram(){Reset();}
+
+        NO_COPY_NO_MOVE(LatencyHistogram)
+
+        void Record(const uint64 value,const uint64 count=1)
+        {
+            buckets[BucketIndex(value)].fetch_add(count,std::memory_order_relaxed);
+            total.fetch_add(count,std::memory_order_relaxed);
+            sum.fetch_add(value*count,std::memory_order_relaxed);
+
+            uint64 cur=min_value.load(std::memory_order_relaxed);
+            while(value<cur&&!min_value.compare_exchange_weak(cur,value,std::memory_order_relaxed));
+
+            cur=max_value.load(std::memory_order_relaxed);
+            while(value>cur&&!max_value.compare_exchange_weak(cur,value,std::memory_order_relaxed));
+        }
+
+        /**
+         * 清空（不能与Record并发）
+         */
+        void Reset()
+        {
+            for(auto &b:buckets)
+                b.store(0,std::memory_order_relaxed);
+
+            total.store(0,std::memory_order_relaxed);
+            sum.store(0,std::memory_order_relaxed);
+            min_value.store(~uint64(0),std::memory_order_relaxed);
+            max_value.store(0,std::memory_order_relaxed);
+        }
+
+        /**
+         * 把另一个直方图的数据累加进来
+         */
+        void Merge(const LatencyHistogram &other)
+        {
+            for(size_t i=0;i<BUCKET_COUNT;i++)
+            {
+                const uint64 n=other.buckets[i].load(std::memory_order_relaxed);
+
+                if(n)
+                    buckets[i].fetch_add(n,std::memory_order_relaxed);
+            }
+
+            total.fetch_add(other.total.load(std::memory_order_relaxed),std::memory_order_relaxed);
+            sum.fetch_add(other.sum.load(std::memory_order_relaxed),std::memory_order_relaxed);
+
+            const uint64 omin=other.min_value.load(std::memory_order_relaxed);
+            const uint64 omax=other.max_value.load(std::memory_order_relaxed);
+
+            uint64 cur=min_value.load(std::memory_order_relaxed);
+            while(omin<cur&&!min_value.compare_exchange_weak(cur,omin,std::memory_order_relaxed));
+
+            cur=max_value.load(std::memory_order_relaxed);
+            while(omax>cur&&!max_value.compare_exchange_weak(cur,omax,std::memory_order_relaxed));
+        }
+
+        uint64 GetCount ()const{return total.load(std::memory_order_relaxed);}
+        uint64 GetMin   ()const{return GetCount()?min_value.load(std::memory_order_relaxed):0;}
+        uint64 GetMax   ()const{return max_value.load(std::memory_order_relaxed);}
+
+        double GetMean()const
+        {
+            const uint64 n=GetCount();
+
+            return n?double(sum.load(std::memory_order_relaxed))/double(n):0;
+        }
+
+        /**
+         * 百分位数
+         * @param percentile 0-100
+         * @return 落在该百分位的桶的上界（不超过记录到的最大值）；没有数据时返回0
+         */
+        uint64 GetPercentile(const double percentile)const
+        {
+            const uint64 n=GetCount();
+
+            if(n==0)
+                return 0;
+
+            uint64 rank=uint64(percentile/100.0*double(n)+0.5);
+
+            if(rank<1)rank=1;
+            if(rank>n)rank=n;
+
+            uint64 seen=0;
+
+            for(size_t i=0;i<BUCKET_COUNT;i++)
+            {
+                seen+=buckets[i].load(std::memory_order_relaxed);
+
+                if(seen>=rank)
+                {
+                    const uint64 ub=BucketUpperBound(i);
+                    const uint64 mx=GetMax();
+
+                    return ub<mx?ub:mx;
+                }
+            }
+
+            return GetMax();
+        }
+
+        /**
+         * 遍历非空桶
+         * @param func void(uint64 lower,uint64 upper,uint64 count)
+         */
+        template<typename F>
+        void ForEachBucket(F &&func)const
+        {
+            for(size_t i=0;i<BUCKET_COUNT;i++)
+            {
+                const uint64 n=buckets[i].load(std::memory_order_relaxed);
+
+                if(n)
+                    func(BucketLowerBound(i),BucketUpperBound(i),n);
+            }
+        }
+    };//class LatencyHistogram
+
+    /**
+     * 作用域计时，析构时把经过的纳秒数记入直方图
+     */
+    class ScopedLatency
+    {
+        LatencyHistogram &hist;
+        uint64 begin;
+
+    public:
+
+        explicit ScopedLatency(LatencyHistogram &h):hist(h),begin(TscClock::Now()){}
+        ~ScopedLatency(){hist.Record(TscClock::ToNanoseconds(TscClock::Now()-begin));}
+
+        NO_COPY_NO_MOVE(ScopedLatency)
+    };//class ScopedLatency
+}//namespace hgl
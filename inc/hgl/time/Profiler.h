@@ -0,0 +1,204 @@
+﻿#pragma once
+
+#include<hgl/time/LatencyHistogram.h>
+#include<atomic>
+#include<string>
+
+/**
+ * 热点路径性能采样
+ *
+ * 定义 HGL_PROFILER 时以下宏才会生成代码，否则全部展开为空语句，没有任何运行时开销：
+ *
+ *     HGL_PROFILE_ZONE("name")             作用域计时区间，写入当前线程的无锁缓冲区
+ *     HGL_PROFILE_FUNCTION()               以函数名为区间名
+ *     HGL_PROFILE_COUNTER_ADD("name",n)    具名原子计数器累加
+ *     HGL_PROFILE_LATENCY(hist)            作用域耗时记入 LatencyHistogram
+ *     HGL_PROFILE_THREAD_NAME("name")      设置导出时显示的线程名
+ *
+ * 采样结果用 Profiler::ExportChromeTrace() 导出为Chrome trace JSON，可在 chrome://tracing 或 Perfetto 中查看。
+ */
+
+namespace hgl
+{
+    /**
+     * 区间的静态描述，每个 HGL_PROFILE_ZONE 位置一份
+     */
+    struct ProfileZoneSite
+    {
+        const char *name;
+        const char *file;
+        int         line;
+    };//struct ProfileZoneSite
+
+    /**
+     * 具名计数器<br>
+     * 构造时登记到全局链表（通常为函数内static对象），累加为一次relaxed原子加法。
+     */
+    class ProfileCounter
+    {
+        const char *name;
+        std::atomic<int64> value{0};
+        ProfileCounter *next;
+
+        friend class Profiler;
+
+    public:
+
+        explicit ProfileCounter(const char *);
+
+        NO_COPY_NO_MOVE(ProfileCounter)
+
+        const char *GetName()const{return name;}
+        int64 Get()const{return value.load(std::memory_order_relaxed);}
+
+        void Add(const int64 n){value.fetch_add(n,std::memory_order_relaxed);}
+        void Set(const int64 n){value.store(n,std::memory_order_relaxed);}
+    };//class ProfileCounter
+
+    namespace profile_detail
+    {
+        struct ZoneEvent
+        {
+            const ProfileZoneSite *site;
+            uint64 begin;
+            uint64 end;
+        };
+
+        constexpr uint32 CHUNK_EVENTS=4096;                         ///<每块事件数
+        constexpr uint32 MAX_CHUNKS_PER_THREAD=256;                 ///<每线程最多保留的块数（约3200万字节），超出后丢弃
+
+        /**
+         * 只由所属线程追加；导出线程按 count 读取已发布的部分
+         */
+        struct ZoneChunk
+        {
+            std::atomic<uint32> count{0};
+            std::atomic<ZoneChunk *> next{nullptr};
+            ZoneEvent events[CHUNK_EVENTS];
+        };
+
+        struct ThreadBuffer
+        {
+            ZoneChunk *         head;
+            ZoneChunk *         current;
+            uint32              chunk_count;
+            std::atomic<uint64> dropped{0};
+
+            uint64              thread_id;
+            std::string         thread_name;                        ///<受 Profiler 全局锁保护
+        };
+
+        ThreadBuffer *RegisterThread();
+        ZoneChunk *AppendChunk(ThreadBuffer *);
+
+        inline thread_local ThreadBuffer *tls_buffer=nullptr;
+
+        inline void RecordZone(const ProfileZoneSite *site,const uint64 begin,const uint64 end)
+        {
+            ThreadBuffer *tb=tls_buffer;
+
+            if(!tb)
+                tb=RegisterThread();
+
+            ZoneChunk *chunk=tb->current;
+            uint32 n=chunk->count.load(std::memory_order_relaxed);
+
+            if(n==CHUNK_EVENTS)
+            {
+                chunk=AppendChunk(tb);
+
+                if(!chunk)
+                    return;
+
+                n=0;
+            }
+
+            chunk->events[n]={site,begin,end};
+            chunk->count.store(n+1,std::memory_order_release);
+        }
+    }//namespace profile_detail
+
+    /**
+     * 作用域区间，构造时记录开始计数，析构时写入当前线程缓冲区
+     */
+    class ProfileZone
+    {
+        const ProfileZoneSite *site;
+        uint64 begin;
+
+    public:
+
+        explicit ProfileZone(const ProfileZoneSite *s):site(s),begin(TscClock::Now()){}
+        ~ProfileZone(){profile_detail::RecordZone(site,begin,TscClock::Now());}
+
+        NO_COPY_NO_MOVE(ProfileZone)
+    };//class ProfileZone
+
+    /**
+     * 采样数据的全局管理
+     */
+    class Profiler
+    {
+    public:
+
+        /**
+         * 设置当前线程在导出结果中的名字
+         */
+        static void SetThreadName(const char *);
+
+        /**
+         * 记录一次所有计数器的当前值，导出为Chrome trace的计数器曲线
+         */
+        static void SampleCounters();
+
+        /**
+         * 查找计数器
+         * @return 不存在返回nullptr
+         */
+        static ProfileCounter *FindCounter(const char *name);
+
+        /**
+         * 已记录的区间数量
+         */
+        static uint64 GetZoneCount();
+
+        /**
+         * 因缓冲区已满而丢弃的区间数量
+         */
+        static uint64 GetDroppedCount();
+
+        /**
+         * 导出为Chrome trace JSON（追加到out），可以在其它线程仍在记录时调用
+         */
+        static void ExportChromeTrace(std::string &out);
+
+        /**
+         * 导出为Chrome trace JSON文件
+         */
+        static bool SaveChromeTrace(const char *filename);
+
+        /**
+         * 清除所有区间、计数器曲线并把计数器归零<br>
+         * 调用时不能有线程正在记录。
+         */
+        static void Reset();
+    };//class Profiler
+}//namespace hgl
+
+#define HGL_PROFILE_CONCAT_INNER(a,b)   a##b
+#define HGL_PROFILE_CONCAT(a,b)         HGL_PROFILE_CONCAT_INNER(a,b)
+
+#ifdef HGL_PROFILER
+    #define HGL_PROFILE_ZONE(zone_name)         static const hgl::ProfileZoneSite HGL_PROFILE_CONCAT(hgl_profile_site_,__LINE__){zone_name,__FILE__,__LINE__};    \
+                                                hgl::ProfileZone HGL_PROFILE_CONCAT(hgl_profile_zone_,__LINE__)(&HGL_PROFILE_CONCAT(hgl_profile_site_,__LINE__))
+    #define HGL_PROFILE_FUNCTION()              HGL_PROFILE_ZONE(__func__)
+    #define HGL_PROFILE_COUNTER_ADD(name,n)     do{static hgl::ProfileCounter hgl_profile_counter(name);hgl_profile_counter.Add(n);}while(0)
+    #define HGL_PROFILE_LATENCY(hist)           hgl::ScopedLatency HGL_PROFILE_CONCAT(hgl_profile_latency_,__LINE__)(hist)
+    #define HGL_PROFILE_THREAD_NAME(name)       hgl::Profiler::SetThreadName(name)
+#else
+    #define HGL_PROFILE_ZONE(zone_name)         ((void)0)
+    #define HGL_PROFILE_FUNCTION()              ((void)0)
+    #define HGL_PROFILE_COUNTER_ADD(name,n)     ((void)0)
+    #define HGL_PROFILE_LATENCY(hist)           ((void)0)
+    #define HGL_PROFILE_THREAD_NAME(name)       ((void)0)
+#endif//HGL_PROFILER
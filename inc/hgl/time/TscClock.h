@@ -0,0 +1,197 @@
+﻿#pragma once
+
+#include<hgl/platform/CpuFeature.h>
+#include<chrono>
+#include<thread>
+
+#ifdef HGL_SIMD_X86
+    #if defined(_MSC_VER)&&!defined(__clang__)
+        #include<intrin.h>
+    #else
+        #include<x86intrin.h>
+        #include<cpuid.h>
+    #endif
+#endif//HGL_SIMD_X86
+
+namespace hgl
+{
+    namespace tsc_detail
+    {
+        inline uint64 SteadyNanoseconds()
+        {
+            return uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+#ifdef HGL_SIMD_X86
+        /**
+         * 是否为不变TSC（频率恒定，不随变频/睡眠改变，各核同步）
+         */
+        inline bool HasInvariantTsc()
+        {
+    #if defined(_MSC_VER)&&!defined(__clang__)
+            int r[4];
+
+            __cpuid(r,0x80000000);
+            if(uint32(r[0])<0x80000007)
+                return(false);
+
+            __cpuid(r,0x80000007);
+            return (r[3]&(1<<8))!=0;
+    #else
+            unsigned int a,b,c,d;
+
+            if(!__get_cpuid(0x80000007,&a,&b,&c,&d))
+                return(false);
+
+            return (d&(1<<8))!=0;
+    #endif
+        }
+
+        inline uint64 ReadTicks(){return __rdtsc();}
+
+        constexpr bool HARDWARE_COUNTER=true;
+#elif (HGL_CPU==HGL_CPU_ARMv8||HGL_CPU==HGL_CPU_ARMv9)&&(defined(__GNUC__)||defined(__clang__))
+        inline bool HasInvariantTsc(){return true;}                //通用计时器频率固定
+
+        inline uint64 ReadTicks()
+        {
+            uint64 v;
+
+            asm volatile("mrs %0, cntvct_el0":"=r"(v));
+            return v;
+        }
+
+        constexpr bool HARDWARE_COUNTER=true;
+#else
+        inline bool HasInvariantTsc(){return false;}
+        inline uint64 ReadTicks(){return SteadyNanoseconds();}
+
+        constexpr bool HARDWARE_COUNTER=false;
+#endif
+
+        struct Calibration
+        {
+            bool    hardware;                                       ///<是否使用硬件计数器
+            double  ns_per_tick;
+            uint64  origin;                                         ///<校准时的计数值，作为时间零点
+        };
+
+        inline Calibration Calibrate()
+        {
+            Calibration c;
+
+            c.hardware=HARDWARE_COUNTER&&HasInvariantTsc();
+
+            if(!c.hardware)
+            {
+                c.ns_per_tick=1.0;
+                c.origin=SteadyNanoseconds();
+                return c;
+            }
+
+            //与steady_clock对比一段时间得出频率，两端各取三次中间隔最短的一次，减少被中断打断的误差
+            auto sample=[](uint64 &ns,uint64 &ticks)
+            {
+                uint64 best=~uint64(0);
+
+                for(int i=0;i<3;i++)
+                {
+                    const uint64 t0=ReadTicks();
+                    const uint64 n =SteadyNanoseconds();
+                    const uint64 t1=ReadTicks();
+
+                    if(t1-t0<best)
+                    {
+                        best=t1-t0;
+                        ns=n;
+                        ticks=t0+(t1-t0)/2;
+                    }
+                }
+            };
+
+            uint64 ns0=0,ticks0=0,ns1=0,ticks1=0;
+
+            sample(ns0,ticks0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            sample(ns1,ticks1);
+
+            c.ns_per_tick=double(ns1-ns0)/double(ticks1-ticks0);
+            c.origin=ticks0;
+            return c;
+        }
+
+        inline const Calibration &GetCalibration()
+        {
+            static const Calibration c=Calibrate();
+
+            return c;
+        }
+    }//namespace tsc_detail
+
+    /**
+     * 低开销单调时钟<br>
+     * x86上使用不变TSC（rdtsc），ARMv8上使用通用计时器（cntvct_el0），读取只需十几个时钟周期、不进入内核；
+     * 其它平台或TSC不可靠时退回 steady_clock（纳秒为单位）。
+     *
+     * Now() 返回原始计数，只在需要显示时再用 ToNanoseconds() 换算，第一次使用时与 steady_clock 对比校准频率（约20毫秒）。
+     */
+    class TscClock
+    {
+    public:
+
+        /**
+         * 读取原始计数
+         */
+        static uint64 Now()
+        {
+            if constexpr(tsc_detail::HARDWARE_COUNTER)
+            {
+                static const bool hardware=tsc_detail::GetCalibration().hardware;
+
+                if(hardware)
+                    return tsc_detail::ReadTicks();
+            }
+
+            return tsc_detail::SteadyNanoseconds();
+        }
+
+        static bool     IsHardware      (){return tsc_detail::GetCalibration().hardware;}
+        static double   NanosecondsPerTick(){return tsc_detail::GetCalibration().ns_per_tick;}
+
+        /**
+         * 计数差换算为纳秒
+         */
+        static uint64 ToNanoseconds(const uint64 ticks)
+        {
+            return uint64(double(ticks)*tsc_detail::GetCalibration().ns_per_tick);
+        }
+
+        /**
+         * 计数值换算为自校准时刻起的纳秒数（早于校准时刻的返回0）
+         */
+        static uint64 SinceOrigin(const uint64 ticks)
+        {
+            const uint64 origin=tsc_detail::GetCalibration().origin;
+
+            return ticks>origin?ToNanoseconds(ticks-origin):0;
+        }
+    };//class TscClock
+
+    /**
+     * 计时器，构造时开始计时
+     */
+    class TscStopwatch
+    {
+        uint64 start;
+
+    public:
+
+        TscStopwatch():start(TscClock::Now()){}
+
+        void Restart(){start=TscClock::Now();}
+
+        uint64 ElapsedTicks()const{return TscClock::Now()-start;}
+        double ElapsedNs    ()const{return double(ElapsedTicks())*TscClock::NanosecondsPerTick();}
+        double ElapsedMs    ()const{return ElapsedNs()/1000000.0;}
+    };//class TscStopwatch
+}//namespace hgl
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include<hgl/CoreType.h>
 #include<hgl/type/MemoryUtil.h>
+#include<hgl/type/ObjectUtil.h>
 #include<initializer_list>
 #include<type_traits>
 
@@ -0,0 +1,982 @@
+﻿#pragma once
+
+#include<hgl/type/ByteSpanBuffer.h>
+#include<hgl/type/ChunkedByteWriter.h>
+#include<string>
+#include<tuple>
+#include<utility>
+#include<vector>
+#include<type_traits>
+
+/**
+ * 结构体二进制序列化描述<br>
+ * 在结构体所在的命名空间中声明，编解码代码在编译期按字段列表展开，没有虚函数调用。
+ *
+ * <pre>
+ * struct MeshInfo
+ * {
+ *     uint32 id;
+ *     float bounds[6];
+ *     std::string name;
+ *     std::vector<uint32> indices;
+ *     uint32 material=0;                              //版本2新增
+ * };
+ *
+ * HGL_SCHEMA(MeshInfo,2,
+ *     HGL_SCHEMA_FIELD(id,1),
+ *     HGL_SCHEMA_FIELD(bounds,2),
+ *     HGL_SCHEMA_FIELD(name,3),
+ *     HGL_SCHEMA_FIELD(indices,4),
+ *     HGL_SCHEMA_FIELD_SINCE(material,5,2))
+ * </pre>
+ *
+ * 字段编号用于Tagged格式，在同一结构中必须唯一且不为0；
+ * 新版本的字段只能追加在末尾，并用 HGL_SCHEMA_FIELD_SINCE 标明加入的版本。
+ */
+#define HGL_SCHEMA(Type,Version,...)    inline constexpr auto hgl_schema_of(const Type *)  \
+                                        {                                                   \
+                                            using SchemaType=Type;                          \
+                                            return ::hgl::SchemaInfo<Version,__VA_ARGS__>{};\
+                                        }
+
+#define HGL_SCHEMA_FIELD(member,id)                 ::hgl::SchemaField<&SchemaType::member,id>
+#define HGL_SCHEMA_FIELD_SINCE(member,id,since)     ::hgl::SchemaField<&SchemaType::member,id,since>
+
+namespace hgl
+{
+    template<typename> struct SchemaMemberTraits;
+
+    template<typename C,typename M> struct SchemaMemberTraits<M C::*>
+    {
+        using Class=C;
+        using Type=M;
+    };
+
+    /**
+     * 字段描述
+     * @tparam Member 成员指针
+     * @tparam Id 字段编号
+     * @tparam Since 加入此字段的版本
+     */
+    template<auto Member,uint32 Id,uint32 Since=1>
+    struct SchemaField
+    {
+        using Class=typename SchemaMemberTraits<decltype(Member)>::Class;
+        using Type =typename SchemaMemberTraits<decltype(Member)>::Type;
+
+        static constexpr auto   member  =Member;
+        static constexpr uint32 id      =Id;
+        static constexpr uint32 since   =Since;
+
+        static_assert(Id>0,"schema field id must be non-zero");
+        static_assert(Since>0,"schema field version starts from 1");
+
+        static       Type &get(      Class &obj){return obj.*Member;}
+        static const Type &get(const Class &obj){return obj.*Member;}
+    };//struct SchemaField
+
+    /**
+     * 结构描述（由 HGL_SCHEMA 生成）
+     */
+    template<uint32 Version,typename ...Fields>
+    struct SchemaInfo
+    {
+        using FieldList=std::tuple<Fields...>;
+
+        static constexpr uint32 version=Version;
+        static constexpr size_t count=sizeof...(Fields);
+
+        static_assert(Version>0,"schema version starts from 1");
+        static_assert(count>0,"schema must have at least one field");
+
+    private:
+
+        static constexpr bool CheckFields()
+        {
+            const uint32 ids   []={Fields::id...};
+            const uint32 since []={Fields::since...};
+
+            for(size_t i=0;i<count;i++)
+            {
+                if(since[i]>Version)return false;
+                if(i>0&&since[i]<since[i-1])return false;
+
+                for(size_t j=0;j<i;j++)
+                    if(ids[i]==ids[j])return false;
+            }
+
+            return true;
+        }
+
+        static_assert(CheckFields(),"schema field ids must be unique, and fields must be ordered by non-decreasing version no greater than the schema version");
+    };//struct SchemaInfo
+
+    template<typename T>
+    concept HasSchema=requires{hgl_schema_of(static_cast<const T *>(nullptr));};
+
+    template<HasSchema T>
+    using SchemaOf=decltype(hgl_schema_of(static_cast<const T *>(nullptr)));
+
+    namespace schema_detail
+    {
+        template<typename T> struct IsVector:std::false_type{};
+        template<typename E,typename A> struct IsVector<std::vector<E,A>>:std::true_type{};
+
+        enum class Kind
+        {
+            Scalar,         ///<数值与枚举
+            Bool,
+            Object,         ///<有Schema描述的结构
+            String,
+            Vector,
+            Raw,            ///<其它可平凡复制的类型，按内存原样存储
+        };
+
+        /**
+         * Raw类型按内存原样写出：结构中的填充字节也会写出，其值不确定。
+         * 需要逐字节确定的输出时，应使用没有填充的类型，或为其声明Schema。
+         */
+
+        template<typename T>
+        constexpr Kind KindOf()
+        {
+            if constexpr(HasSchema<T>)                                      return Kind::Object;
+            else if constexpr(std::is_same_v<T,bool>)                       return Kind::Bool;
+            else if constexpr(std::is_arithmetic_v<T>||std::is_enum_v<T>)   return Kind::Scalar;
+            else if constexpr(std::is_same_v<T,std::string>)                return Kind::String;
+            else if constexpr(IsVector<T>::value)                           return Kind::Vector;
+            else
+            {
+                using E=std::remove_all_extents_t<T>;
+
+                static_assert(std::is_trivially_copyable_v<T>,"unsupported schema field type");
+                static_assert(!std::is_pointer_v<E>&&!std::is_member_pointer_v<E>&&!std::is_null_pointer_v<E>,"pointers cannot be serialized, the address is only valid in this process");
+                return Kind::Raw;
+            }
+        }
+
+        template<typename T>
+        struct ScalarType{using type=T;};
+
+        template<typename T> requires std::is_enum_v<T>
+        struct ScalarType<T>{using type=std::underlying_type_t<T>;};
+
+        template<typename T>
+        using ScalarOf=typename ScalarType<T>::type;
+
+        /**
+         * 是否可以直接按内存复制（小端机器上的数值，以及其它可平凡复制的类型）
+         */
+        template<typename T>
+        constexpr bool IsMemcpyable()
+        {
+            constexpr Kind kind=KindOf<T>();
+
+            if constexpr(kind==Kind::Raw)
+                return true;
+            else if constexpr(kind==Kind::Scalar)
+                return HGL_ENDIAN!=HGL_BIG_ENDIAN||sizeof(T)==1;
+            else
+                return false;
+        }
+
+        template<typename Info,size_t I>
+        using FieldAt=std::tuple_element_t<I,typename Info::FieldList>;
+
+        /**
+         * 从第I个字段开始，版本相同且可直接复制的连续字段的结束位置
+         */
+        template<typename Info,size_t I>
+        constexpr size_t RunEnd()
+        {
+            constexpr uint32 since=FieldAt<Info,I>::since;
+
+            return [&]<size_t ...K>(std::index_sequence<K...>)
+            {
+                const bool ok[]={(IsMemcpyable<typename FieldAt<Info,K>::Type>()&&FieldAt<Info,K>::since==since)...};
+
+                size_t end=I;
+                while(end<Info::count&&ok[end])
+                    ++end;
+
+                return end;
+            }(std::make_index_sequence<Info::count>());
+        }
+
+        template<typename F,typename T>
+        const uint8 *FieldAddress(const T &obj){return reinterpret_cast<const uint8 *>(&F::get(obj));}
+
+        /**
+         * 字段[I,E)在内存中是否首尾相接（成员偏移是常量，优化后此判断在编译期完成）
+         */
+        template<typename Info,size_t I,size_t E,typename T>
+        bool IsContiguous(const T &obj)
+        {
+            return [&]<size_t ...K>(std::index_sequence<K...>)
+            {
+                return ((FieldAddress<FieldAt<Info,I+K+1>>(obj)==FieldAddress<FieldAt<Info,I+K>>(obj)+sizeof(typename FieldAt<Info,I+K>::Type))&&...);
+            }(std::make_index_sequence<E-I-1>());
+        }
+
+        template<typename Info,size_t I,size_t E,typename T>
+        size_t RunBytes(const T &obj)
+        {
+            using Last=FieldAt<Info,E-1>;
+
+            return size_t(FieldAddress<Last>(obj)+sizeof(typename Last::Type)-FieldAddress<FieldAt<Info,I>>(obj));
+        }
+
+        //==============================================================================================
+        // Packed格式
+        // 对象 = varint版本号 + u32正文长度 + 正文；正文按声明顺序存放字段，不带字段编号
+        //==============================================================================================
+
+        inline size_t BodyBegin(ByteSpanWriter &w)
+        {
+            const size_t pos=w.tell();
+
+            return w.u32(0)?pos:size_t(-1);
+        }
+
+        inline bool BodyEnd(ByteSpanWriter &w,size_t pos)
+        {
+            if(pos==size_t(-1))
+                return false;
+
+            const size_t body=w.tell()-pos-sizeof(uint32);
+
+            if(body>0xFFFFFFFFull)
+                return false;
+
+            const uint32 length=to_little_endian(uint32(body));
+
+            std::memcpy(w.begin()+pos,&length,sizeof(uint32));
+            return true;
+        }
+
+        inline ChunkedByteWriter::Reservation BodyBegin(ChunkedByteWriter &w){return w.BeginSection();}
+
+        inline bool BodyEnd(ChunkedByteWriter &w,const ChunkedByteWriter::Reservation &r)
+        {
+            return r.IsValid()&&w.EndSection(r);
+        }
+
+        template<typename W,typename T> bool WritePacked(W &,const T &);
+        template<typename T> bool ReadPacked(ByteSpanReader &,T &);
+        template<typename T> size_t PackedSize(const T &);
+
+        template<typename T,typename W>
+        bool WritePackedValue(W &w,const T &v)
+        {
+            constexpr Kind kind=KindOf<T>();
+
+            if constexpr(kind==Kind::Scalar)    return w.value(static_cast<ScalarOf<T>>(v));
+            else if constexpr(kind==Kind::Bool) return w.u8(v?1:0);
+            else if constexpr(kind==Kind::Object)return WritePacked(w,v);
+            else if constexpr(kind==Kind::String)return w.string(v);
+            else if constexpr(kind==Kind::Raw)  return w.bytes(&v,sizeof(T));
+            else
+            {
+                using E=typename T::value_type;
+
+                if(!w.varu64(v.size()))
+                    return false;
+
+                if constexpr(IsMemcpyable<E>())
+                    return w.bytes(v.data(),v.size()*sizeof(E));
+                else
+                {
+                    for(const auto &e:v)
+                        if(!WritePackedValue<E>(w,e))
+                            return false;
+
+                    return true;
+                }
+            }
+        }
+
+        template<typename T>
+        bool ReadPackedValue(ByteSpanReader &r,T &v)
+        {
+            constexpr Kind kind=KindOf<T>();
+
+            if constexpr(kind==Kind::Scalar)
+            {
+                ScalarOf<T> s;
+
+                if(!r.value(s))
+                    return false;
+
+                v=static_cast<T>(s);
+                return true;
+            }
+            else if constexpr(kind==Kind::Bool)
+            {
+                uint8 b;
+
+                if(!r.u8(b))
+                    return false;
+
+                v=(b!=0);
+                return true;
+            }
+            else if constexpr(kind==Kind::Object)return ReadPacked(r,v);
+            else if constexpr(kind==Kind::String)return r.string(v);
+            else if constexpr(kind==Kind::Raw)  return r.bytes(&v,sizeof(T));
+            else
+            {
+                using E=typename T::value_type;
+
+                uint64 count;
+
+                if(!r.varu64(count)||count>r.left())                        //每个元素至少1字节，防止恶意长度
+                    return false;
+
+                if constexpr(IsMemcpyable<E>())
+                {
+                    if(count>r.left()/sizeof(E))
+                        return false;
+
+                    v.resize(size_t(count));
+                    return r.bytes(v.data(),size_t(count)*sizeof(E));
+                }
+                else
+                {
+                    v.clear();
+                    v.reserve(size_t(count));
+
+                    for(uint64 i=0;i<count;i++)
+                    {
+                        E e{};
+
+                        if(!ReadPackedValue<E>(r,e))
+                            return false;
+
+                        v.push_back(std::move(e));
+                    }
+
+                    return true;
+                }
+            }
+        }
+
+        template<typename T>
+        size_t PackedValueSize(const T &v)
+        {
+            constexpr Kind kind=KindOf<T>();
+
+            if constexpr(kind==Kind::Scalar)    return sizeof(ScalarOf<T>);
+            else if constexpr(kind==Kind::Bool) return 1;
+            else if constexpr(kind==Kind::Object)return PackedSize(v);
+            else if constexpr(kind==Kind::String)return varint_size(v.size())+v.size();
+            else if constexpr(kind==Kind::Raw)  return sizeof(T);
+            else
+            {
+                using E=typename T::value_type;
+
+                size_t size=varint_size(v.size());
+
+                if constexpr(IsMemcpyable<E>())
+                    size+=v.size()*sizeof(E);
+                else
+                    for(const auto &e:v)
+                        size+=PackedValueSize<E>(e);
+
+                return size;
+            }
+        }
+
+        template<typename Info,size_t I,typename W,typename T>
+        bool WritePackedFields(W &w,const T &obj)
+        {
+            if constexpr(I==Info::count)
+                return true;
+            else
+            {
+                using F=FieldAt<Info,I>;
+                constexpr size_t E=RunEnd<Info,I>();
+
+                if constexpr(E>I+1)
+                {
+                    if(IsContiguous<Info,I,E>(obj))
+                        return w.bytes(FieldAddress<F>(obj),RunBytes<Info,I,E>(obj))
+                            &&WritePackedFields<Info,E>(w,obj);
+                }
+
+                return WritePackedValue<typename F::Type>(w,F::get(obj))
+                     &&WritePackedFields<Info,I+1>(w,obj);
+            }
+        }
+
+        template<typename Info,size_t I,typename T>
+        bool ReadPackedFields(ByteSpanReader &r,T &obj,uint32 data_version)
+        {
+            if constexpr(I==Info::count)
+                return true;
+            else
+            {
+                using F=FieldAt<Info,I>;
+
+                if(F::since>data_version)                                   //旧版本数据没有之后的字段，保留默认值
+                    return true;
+
+                constexpr size_t E=RunEnd<Info,I>();
+
+                if constexpr(E>I+1)
+                {
+                    if(IsContiguous<Info,I,E>(obj))
+                        return r.bytes(const_cast<uint8 *>(FieldAddress<F>(obj)),RunBytes<Info,I,E>(obj))
+                            &&ReadPackedFields<Info,E>(r,obj,data_version);
+                }
+
+                return ReadPackedValue<typename F::Type>(r,F::get(obj))
+                     &&ReadPackedFields<Info,I+1>(r,obj,data_version);
+            }
+        }
+
+        template<typename Info,size_t I,typename T>
+        size_t PackedFieldsSize(const T &obj)
+        {
+            if constexpr(I==Info::count)
+                return 0;
+            else
+            {
+                using F=FieldAt<Info,I>;
+
+                return PackedValueSize<typename F::Type>(F::get(obj))+PackedFieldsSize<Info,I+1>(obj);
+            }
+        }
+
+        template<typename W,typename T>
+        bool WritePacked(W &w,const T &obj)
+        {
+            using Info=SchemaOf<T>;
+
+            if(!w.varu32(Info::version))
+                return false;
+
+            const auto body=BodyBegin(w);
+
+            return WritePackedFields<Info,0>(w,obj)&&BodyEnd(w,body);
+        }
+
+        template<typename T>
+        bool ReadPacked(ByteSpanReader &r,T &obj)
+        {
+            using Info=SchemaOf<T>;
+
+            uint32 data_version;
+            uint32 length;
+
+            if(!r.varu32(data_version)||data_version==0)
+                return false;
+
+            if(!r.u32(length)||!r.require(length))
+                return false;
+
+            ByteSpanReader body(r.current(),length);
+
+            if(!ReadPackedFields<Info,0>(body,obj,data_version))
+                return false;
+
+            if(data_version<=Info::version&&!body.eof())                 //同版本或旧版本不应有多余数据
+                return false;
+
+            return r.skip(length);                                          //新版本数据：跳过不认识的尾部字段
+        }
+
+        template<typename T>
+        size_t PackedSize(const T &obj)
+        {
+            using Info=SchemaOf<T>;
+
+            return varint_size(Info::version)+sizeof(uint32)+PackedFieldsSize<Info,0>(obj);
+        }
+
+        //==============================================================================================
+        // Tagged格式（类似protobuf）
+        // 每个字段 = varint键(编号<<3|类型) + 值；整数为varint（有符号数ZigZag），float/double为定长，
+        // 其它为varint长度+数据。数值数组紧凑存放；对象/字符串数组每个元素单独一个键。
+        //==============================================================================================
+
+        enum WireType:uint32
+        {
+            WIRE_VARINT =0,
+            WIRE_FIXED64=1,
+            WIRE_LENGTH =2,
+            WIRE_FIXED32=5,
+        };
+
+        template<typename T>
+        constexpr WireType WireTypeOf()
+        {
+            constexpr Kind kind=KindOf<T>();
+
+            if constexpr(kind==Kind::Bool)
+                return WIRE_VARINT;
+            else if constexpr(kind==Kind::Scalar)
+            {
+                using S=ScalarOf<T>;
+
+                static_assert(sizeof(S)<=8,"unsupported scalar size");
+
+                if constexpr(std::is_same_v<S,float>)           return WIRE_FIXED32;
+                else if constexpr(std::is_floating_point_v<S>)  return WIRE_FIXED64;
+                else                                            return WIRE_VARINT;
+            }
+            else
+                return WIRE_LENGTH;
+        }
+
+        template<typename T>
+        uint64 ToVarint(const T &v)
+        {
+            if constexpr(std::is_same_v<T,bool>)
+                return v?1:0;
+            else
+            {
+                using S=ScalarOf<T>;
+
+                if constexpr(std::is_signed_v<S>)
+                    return zigzag_encode(int64(static_cast<S>(v)));
+                else
+                    return uint64(static_cast<S>(v));
+            }
+        }
+
+        template<typename T>
+        T FromVarint(uint64 u)
+        {
+            if constexpr(std::is_same_v<T,bool>)
+                return u!=0;
+            else
+            {
+                using S=ScalarOf<T>;
+
+                if constexpr(std::is_signed_v<S>)
+                    return static_cast<T>(static_cast<S>(zigzag_decode(u)));
+                else
+                    return static_cast<T>(static_cast<S>(u));
+            }
+        }
+
+        template<typename T>
+        constexpr bool IsPackedRepeated()
+        {
+            constexpr Kind kind=KindOf<T>();
+
+            return kind==Kind::Scalar||kind==Kind::Bool;
+        }
+
+        /**
+         * 是否是每个元素单独一个键的数组（对象、字符串等非数值数组）
+         */
+        template<typename T>
+        constexpr bool IsRepeatedLength()
+        {
+            if constexpr(KindOf<T>()==Kind::Vector)
+                return !IsPackedRepeated<typename T::value_type>();
+            else
+                return false;
+        }
+
+        template<typename T> size_t TaggedSize(const T &);
+        template<typename W,typename T> bool WriteTagged(W &,const T &);
+        template<typename T> bool ReadTagged(ByteSpanReader &,T &);
+
+        /**
+         * 标量的值部分（不含键）
+         */
+        template<typename T,typename W>
+        bool WriteTaggedScalar(W &w,const T &v)
+        {
+            constexpr WireType wire=WireTypeOf<T>();
+
+            if constexpr(wire==WIRE_VARINT)         return w.varu64(ToVarint(v));
+            else                                    return w.value(static_cast<ScalarOf<T>>(v));
+        }
+
+        template<typename T>
+        size_t TaggedScalarSize(const T &v)
+        {
+            if constexpr(WireTypeOf<T>()==WIRE_VARINT)  return varint_size(ToVarint(v));
+            else                                        return sizeof(ScalarOf<T>);
+        }
+
+        template<typename T>
+        bool ReadTaggedScalar(ByteSpanReader &r,T &v)
+        {
+            if constexpr(WireTypeOf<T>()==WIRE_VARINT)
+            {
+                uint64 u;
+
+                if(!r.varu64(u))
+                    return false;
+
+                v=FromVarint<T>(u);
+                return true;
+            }
+            else
+            {
+                ScalarOf<T> s;
+
+                if(!r.value(s))
+                    return false;
+
+                v=static_cast<T>(s);
+                return true;
+            }
+        }
+
+        /**
+         * 长度前缀类型的内容长度（不含长度本身）
+         */
+        template<typename T>
+        size_t TaggedPayloadSize(const T &v)
+        {
+            constexpr Kind kind=KindOf<T>();
+
+            if constexpr(kind==Kind::Object)        return TaggedSize(v);
+            else if constexpr(kind==Kind::String)   return v.size();
+            else if constexpr(kind==Kind::Raw)      return sizeof(T);
+            else
+            {
+                using E=typename T::value_type;
+
+                static_assert(IsPackedRepeated<E>(),"only scalar vectors are length-delimited");
+
+                if constexpr(WireTypeOf<E>()!=WIRE_VARINT)
+                    return v.size()*sizeof(ScalarOf<E>);
+                else
+                {
+                    size_t size=0;
+
+                    for(const auto &e:v)
+                        size+=varint_size(ToVarint<E>(e));
+
+                    return size;
+                }
+            }
+        }
+
+        template<typename T,typename W>
+        bool WriteTaggedPayload(W &w,const T &v)
+        {
+            constexpr Kind kind=KindOf<T>();
+
+            if constexpr(kind==Kind::Object)        return WriteTagged(w,v);
+            else if constexpr(kind==Kind::String)   return w.bytes(v.data(),v.size());
+            else if constexpr(kind==Kind::Raw)      return w.bytes(&v,sizeof(T));
+            else
+            {
+                using E=typename T::value_type;
+
+                if constexpr(WireTypeOf<E>()!=WIRE_VARINT&&IsMemcpyable<E>())
+                    return w.bytes(v.data(),v.size()*sizeof(E));
+                else
+                {
+                    for(const auto &e:v)
+                        if(!WriteTaggedScalar<E>(w,e))
+                            return false;
+
+                    return true;
+                }
+            }
+        }
+
+        template<typename T>
+        bool ReadTaggedPayload(ByteSpanReader &r,T &v)
+        {
+            constexpr Kind kind=KindOf<T>();
+
+            if constexpr(kind==Kind::Object)        return ReadTagged(r,v);
+            else if constexpr(kind==Kind::String)   {v.assign(reinterpret_cast<const char *>(r.current()),r.left());return r.skip(r.left());}
+            else if constexpr(kind==Kind::Raw)      return r.left()==sizeof(T)&&r.bytes(&v,sizeof(T));
+            else
+            {
+                using E=typename T::value_type;
+
+                if constexpr(WireTypeOf<E>()!=WIRE_VARINT&&IsMemcpyable<E>())
+                {
+                    if(r.left()%sizeof(E))
+                        return false;
+
+                    const size_t old=v.size();
+                    const size_t count=r.left()/sizeof(E);
+
+                    v.resize(old+count);
+                    return r.bytes(v.data()+old,count*sizeof(E));
+                }
+                else
+                {
+                    while(!r.eof())
+                    {
+                        E e{};
+
+                        if(!ReadTaggedScalar<E>(r,e))
+                            return false;
+
+                        v.push_back(e);
+                    }
+
+                    return true;
+                }
+            }
+        }
+
+        constexpr uint64 TaggedKey(uint32 id,WireType wire){return (uint64(id)<<3)|wire;}
+
+        template<typename F,typename W,typename T>
+        bool WriteTaggedField(W &w,const T &obj)
+        {
+            using V=typename F::Type;
+            const V &v=F::get(obj);
+
+            if constexpr(IsPackedRepeated<V>())
+            {
+                return w.varu64(TaggedKey(F::id,WireTypeOf<V>()))&&WriteTaggedScalar<V>(w,v);
+            }
+            else if constexpr(IsRepeatedLength<V>())
+            {
+                using E=typename V::value_type;
+
+                static_assert(KindOf<E>()!=Kind::Vector,"nested vectors are not supported by the tagged format");
+
+                for(const auto &e:v)                                        //每个元素单独一个键
+                    if(!w.varu64(TaggedKey(F::id,WIRE_LENGTH))
+                     ||!w.varu64(TaggedPayloadSize<E>(e))
+                     ||!WriteTaggedPayload<E>(w,e))
+                        return false;
+
+                return true;
+            }
+            else
+            {
+                if constexpr(KindOf<V>()==Kind::Vector)
+                    if(v.empty())
+                        return true;
+
+                return w.varu64(TaggedKey(F::id,WIRE_LENGTH))
+                     &&w.varu64(TaggedPayloadSize<V>(v))
+                     &&WriteTaggedPayload<V>(w,v);
+            }
+        }
+
+        template<typename F,typename T>
+        size_t TaggedFieldSize(const T &obj)
+        {
+            using V=typename F::Type;
+            const V &v=F::get(obj);
+
+            if constexpr(IsPackedRepeated<V>())
+            {
+                return varint_size(TaggedKey(F::id,WireTypeOf<V>()))+TaggedScalarSize<V>(v);
+            }
+            else if constexpr(IsRepeatedLength<V>())
+            {
+                using E=typename V::value_type;
+
+                size_t size=0;
+
+                for(const auto &e:v)
+                {
+                    const size_t payload=TaggedPayloadSize<E>(e);
+
+                    size+=varint_size(TaggedKey(F::id,WIRE_LENGTH))+varint_size(payload)+payload;
+                }
+
+                return size;
+            }
+            else
+            {
+                if constexpr(KindOf<V>()==Kind::Vector)
+                    if(v.empty())
+                        return 0;
+
+                const size_t payload=TaggedPayloadSize<V>(v);
+
+                return varint_size(TaggedKey(F::id,WIRE_LENGTH))+varint_size(payload)+payload;
+            }
+        }
+
+        /**
+         * 读取一个字段的值，类型不符时视为未知字段跳过
+         * @return false表示数据损坏
+         */
+        template<typename F,typename T>
+        bool ReadTaggedField(ByteSpanReader &r,T &obj,uint32 wire,bool &handled)
+        {
+            using V=typename F::Type;
+            V &v=F::get(obj);
+
+            if constexpr(IsPackedRepeated<V>())
+            {
+                if(wire!=WireTypeOf<V>())
+                    return true;
+
+                handled=true;
+                return ReadTaggedScalar<V>(r,v);
+            }
+            else
+            {
+                if(wire!=WIRE_LENGTH)
+                    return true;
+
+                handled=true;
+
+                uint64 length;
+                const uint8 *payload;
+
+                if(!r.varu64(length)||length>r.left()||!r.bytes_view(payload,size_t(length)))
+                    return false;
+
+                ByteSpanReader sub(payload,size_t(length));
+
+                if constexpr(IsRepeatedLength<V>())
+                {
+                    using E=typename V::value_type;
+
+                    E e{};
+
+                    if(!ReadTaggedPayload<E>(sub,e))
+                        return false;
+
+                    v.push_back(std::move(e));
+                    return true;
+                }
+                else
+                    return ReadTaggedPayload<V>(sub,v);
+            }
+        }
+
+        inline bool SkipTaggedValue(ByteSpanReader &r,uint32 wire)
+        {
+            switch(wire)
+            {
+                case WIRE_VARINT:   {uint64 u;return r.varu64(u);}
+                case WIRE_FIXED64:  return r.skip(8);
+                case WIRE_FIXED32:  return r.skip(4);
+                case WIRE_LENGTH:   {uint64 n;return r.varu64(n)&&n<=r.left()&&r.skip(size_t(n));}
+                default:            return false;
+            }
+        }
+
+        template<typename W,typename T>
+        bool WriteTagged(W &w,const T &obj)
+        {
+            using Info=SchemaOf<T>;
+
+            return [&]<size_t ...I>(std::index_sequence<I...>)
+            {
+                return (WriteTaggedField<FieldAt<Info,I>>(w,obj)&&...);
+            }(std::make_index_sequence<Info::count>());
+        }
+
+        template<typename T>
+        size_t TaggedSize(const T &obj)
+        {
+            using Info=SchemaOf<T>;
+
+            return [&]<size_t ...I>(std::index_sequence<I...>)
+            {
+                return (TaggedFieldSize<FieldAt<Info,I>>(obj)+...);
+            }(std::make_index_sequence<Info::count>());
+        }
+
+        template<typename T>
+        bool ReadTagged(ByteSpanReader &r,T &obj)
+        {
+            using Info=SchemaOf<T>;
+
+            while(!r.eof())
+            {
+                uint64 key;
+
+                if(!r.varu64(key))
+                    return false;
+
+                const uint64 id=key>>3;
+                const uint32 wire=uint32(key&7);
+                bool handled=false;
+
+                const bool ok=[&]<size_t ...I>(std::index_sequence<I...>)
+                {
+                    return ((FieldAt<Info,I>::id!=id||ReadTaggedField<FieldAt<Info,I>>(r,obj,wire,handled))&&...);
+                }(std::make_index_sequence<Info::count>());
+
+                if(!ok)
+                    return false;
+
+                if(!handled&&!SkipTaggedValue(r,wire))                      //不认识的字段
+                    return false;
+            }
+
+            return true;
+        }
+    }//namespace schema_detail
+
+    //==================================================================================================
+    // Packed格式：按声明顺序紧凑存储，连续的可平凡复制字段整段memcpy
+    // 带版本号与正文长度，旧程序可以跳过新版本追加的字段，新程序读取旧数据时新字段保留默认值
+    //==================================================================================================
+
+    /**
+     * 以Packed格式写入对象
+     * @param w ByteSpanWriter 或 ChunkedByteWriter
+     */
+    template<typename W,HasSchema T>
+    inline bool SchemaWrite(W &w,const T &obj){return schema_detail::WritePacked(w,obj);}
+
+    /**
+     * 读取Packed格式对象，数据中没有的字段保持原值
+     */
+    template<HasSchema T>
+    inline bool SchemaRead(ByteSpanReader &r,T &obj){return schema_detail::ReadPacked(r,obj);}
+
+    /**
+     * 计算Packed格式的编码长度
+     */
+    template<HasSchema T>
+    inline size_t SchemaSize(const T &obj){return schema_detail::PackedSize(obj);}
+
+    /**
+     * 以Packed格式编码对象，追加到vector末尾
+     */
+    template<HasSchema T>
+    inline bool SchemaEncode(const T &obj,std::vector<uint8> &out)
+    {
+        const size_t old=out.size();
+
+        out.resize(old+SchemaSize(obj));
+
+        ByteSpanWriter w(out.data()+old,out.size()-old);
+        return SchemaWrite(w,obj);
+    }
+
+    //==================================================================================================
+    // Tagged格式：类似protobuf的 编号+类型 键值对，可任意增删字段，体积更小但编解码较慢
+    //==================================================================================================
+
+    template<typename W,HasSchema T>
+    inline bool SchemaWriteTagged(W &w,const T &obj){return schema_detail::WriteTagged(w,obj);}
+
+    /**
+     * 读取Tagged格式对象，一直读到reader末尾
+     */
+    template<HasSchema T>
+    inline bool SchemaReadTagged(ByteSpanReader &r,T &obj){return schema_detail::ReadTagged(r,obj);}
+
+    template<HasSchema T>
+    inline size_t SchemaTaggedSize(const T &obj){return schema_detail::TaggedSize(obj);}
+
+    template<HasSchema T>
+    inline bool SchemaEncodeTagged(const T &obj,std::vector<uint8> &out)
+    {
+        const size_t old=out.size();
+
+        out.resize(old+SchemaTaggedSize(obj));
+
+        ByteSpanWriter w(out.data()+old,out.size()-old);
+        return SchemaWriteTagged(w,obj);
+    }
+}//namespace hgl
@@ -0,0 +1,300 @@
+﻿#pragma once
+
+#include<hgl/type/ByteSpanBuffer.h>
+#include<bit>
+
+namespace hgl
+{
+    /**
+     * 低n位的掩码，n可以为0~64
+     */
+    constexpr uint64 low_bits_mask(const uint32 n) noexcept
+    {
+        return n>=64?~uint64(0):(uint64(1)<<n)-1;
+    }
+
+    /**
+     * 位流写入器<br>
+     * 位序为LSB优先（先写入的位在字节的低位，与DEFLATE相同），结果追加到 std::vector 末尾。
+     * 内部使用64位缓冲，每积满64位才写出一次。
+     */
+    class BitStreamWriter
+    {
+        std::vector<uint8> &out;
+        size_t base;                                                    ///<构造时vector中已有的数据长度
+
+        uint64 buffer=0;                                                ///<尚未写出的位（低位在前）
+        uint32 buffer_bits=0;                                           ///<buffer中的有效位数，始终<64
+
+        uint64 flushed_bits=0;                                          ///<已写入out的位数
+
+    private:
+
+        void store_word(const uint64 word)
+        {
+            const uint64 le=to_little_endian(word);
+            const size_t pos=out.size();
+
+            out.resize(pos+sizeof(uint64));
+            std::memcpy(out.data()+pos,&le,sizeof(uint64));
+
+            flushed_bits+=64;
+        }
+
+    public:
+
+        explicit BitStreamWriter(std::vector<uint8> &buffer):out(buffer),base(buffer.size()){}
+
+        NO_COPY_NO_MOVE(BitStreamWriter)
+
+        /**
+         * 写入value的低n位(n为0~64)
+         */
+        void write_bits(uint64 value,const uint32 n)
+        {
+            value&=low_bits_mask(n);
+
+            const uint32 total=buffer_bits+n;
+
+            buffer|=value<<buffer_bits;                                 //buffer_bits<64
+
+            if(total<64)
+            {
+                buffer_bits=total;
+                return;
+            }
+
+            store_word(buffer);
+
+            //buffer_bits为0时value已全部写出，否则留下高位部分
+            buffer=buffer_bits?value>>(64-buffer_bits):0;
+            buffer_bits=total-64;
+        }
+
+        void write_bit(const bool bit){write_bits(bit,1);}
+
+        /**
+         * 写入一元编码：value个0后跟一个1
+         */
+        void write_unary(uint32 value)
+        {
+            while(value>=32)
+            {
+                write_bits(0,32);
+                value-=32;
+            }
+
+            write_bits(uint64(1)<<value,value+1);
+        }
+
+        /**
+         * 用0补齐到字节边界
+         */
+        void align_to_byte()
+        {
+            const uint32 pad=(8-(buffer_bits&7))&7;
+
+            if(pad)
+                write_bits(0,pad);
+        }
+
+        /**
+         * 已写入的总位数
+         */
+        uint64 tell_bits()const{return flushed_bits+buffer_bits;}
+
+        /**
+         * 将缓冲中剩余的位写出（不足一字节的部分补0），之后仍可继续写入，但会从新的字节开始
+         * @return 本写入器写出的总字节数
+         */
+        size_t flush()
+        {
+            align_to_byte();
+
+            const uint32 bytes=buffer_bits/8;
+
+            if(bytes)
+            {
+                const uint64 le=to_little_endian(buffer);
+                const size_t pos=out.size();
+
+                out.resize(pos+bytes);
+                std::memcpy(out.data()+pos,&le,bytes);
+
+                flushed_bits+=buffer_bits;
+                buffer=0;
+                buffer_bits=0;
+            }
+
+            return out.size()-base;
+        }
+    };//class BitStreamWriter
+
+    /**
+     * 位流读取器（与 BitStreamWriter 对应，零拷贝）<br>
+     * 内部保持一个至少56位的64位缓冲，剩余数据足够时一次无分支地补充8字节，
+     * 因此 read_bits(n) 通常只有一个可预测的分支。
+     *
+     * 读取超出数据末尾时返回0，并可通过 overrun() 检测。
+     */
+    class BitStreamReader
+    {
+        const uint8 *data;
+        const uint8 *end;
+        const uint8 *ptr;                                               ///<下一个要装入缓冲的字节
+
+        uint64 buffer=0;
+        uint32 buffer_bits=0;                                           ///<buffer中的有效位数
+        size_t pad_bytes=0;                                             ///<超出末尾后补入的0字节数
+
+    public:
+
+        static constexpr uint32 MAX_READ_BITS=56;                       ///<单次可读取的最大位数
+
+    private:
+
+        void refill_slow()
+        {
+            while(buffer_bits<=MAX_READ_BITS)
+            {
+                uint64 byte=0;
+
+                if(ptr<end)
+                    byte=*ptr++;
+                else
+                    ++pad_bytes;
+
+                buffer|=byte<<buffer_bits;
+                buffer_bits+=8;
+            }
+        }
+
+        /**
+         * 补充缓冲，之后至少有56位可用
+         */
+        void refill()
+        {
+            if(end-ptr>=8)
+            {
+                uint64 word;
+                std::memcpy(&word,ptr,sizeof(uint64));
+
+                buffer|=to_little_endian(word)<<buffer_bits;
+                ptr+=(63-buffer_bits)>>3;                               //实际装入的整字节数
+                buffer_bits|=56;
+            }
+            else
+                refill_slow();
+        }
+
+    public:
+
+        BitStreamReader(const void *buffer,size_t length)
+            : data(static_cast<const uint8 *>(buffer)),end(data+length),ptr(data)
+        {
+        }
+
+        explicit BitStreamReader(std::span<const uint8> buffer):BitStreamReader(buffer.data(),buffer.size()){}
+        explicit BitStreamReader(const std::vector<uint8> &buffer):BitStreamReader(buffer.data(),buffer.size()){}
+
+        /**
+         * 已读取的位数
+         */
+        uint64 tell_bits()const{return uint64(ptr-data+pad_bytes)*8-buffer_bits;}
+
+        uint64 total_bits()const{return uint64(end-data)*8;}
+
+        /**
+         * 剩余的位数（越界后为0）
+         */
+        uint64 left_bits()const
+        {
+            const uint64 pos=tell_bits();
+            return pos<total_bits()?total_bits()-pos:0;
+        }
+
+        /**
+         * 是否读取到了数据末尾之后
+         */
+        bool overrun()const{return tell_bits()>total_bits();}
+
+        /**
+         * 查看接下来的n位(n为0~56)，不移动读取位置
+         */
+        uint64 peek_bits(const uint32 n)
+        {
+            if(buffer_bits<n)
+                refill();
+
+            return buffer&low_bits_mask(n);
+        }
+
+        /**
+         * 跳过n位(n为0~56)，通常与 peek_bits 配合使用
+         */
+        void skip_bits(const uint32 n)
+        {
+            if(buffer_bits<n)
+                refill();
+
+            buffer>>=n;
+            buffer_bits-=n;
+        }
+
+        /**
+         * 读取n位(n为0~56)
+         */
+        uint64 read_bits(const uint32 n)
+        {
+            if(buffer_bits<n)
+                refill();
+
+            const uint64 value=buffer&low_bits_mask(n);
+
+            buffer>>=n;
+            buffer_bits-=n;
+            return value;
+        }
+
+        bool read_bit(){return read_bits(1);}
+
+        /**
+         * 读取一元编码（连续0的个数，跳过结尾的1）
+         * @return 0的个数，越界时返回已读到的0的个数
+         */
+        uint32 read_unary()
+        {
+            uint32 count=0;
+
+            for(;;)
+            {
+                if(buffer_bits<32)
+                    refill();
+
+                const uint64 window=buffer&low_bits_mask(32);
+
+                if(window)
+                {
+                    const uint32 zeros=uint32(std::countr_zero(window));
+
+                    skip_bits(zeros+1);
+                    return count+zeros;
+                }
+
+                skip_bits(32);
+                count+=32;
+
+                if(overrun())
+                    return count;
+            }
+        }
+
+        /**
+         * 跳到下一个字节边界
+         */
+        void align_to_byte()
+        {
+            skip_bits(uint32(tell_bits()&7?8-(tell_bits()&7):0));
+        }
+    };//class BitStreamReader
+}//namespace hgl
@@ -0,0 +1,577 @@
+﻿#pragma once
+
+#include<hgl/platform/CpuFeature.h>
+#include<hgl/type/BitOperations.h>
+#include<vector>
+#include<algorithm>
+#include<type_traits>
+
+namespace hgl
+{
+    namespace bit_vector_detail
+    {
+        enum class BitOp
+        {
+            And,            ///<dst&=src
+            Or,             ///<dst|=src
+            Xor,            ///<dst^=src
+            AndNot,         ///<dst&=~src
+
+            BEGIN_RANGE =And,
+            END_RANGE   =AndNot,
+            RANGE_SIZE  =END_RANGE-BEGIN_RANGE+1
+        };
+
+        template<BitOp OP>
+        constexpr uint64 Apply(const uint64 a,const uint64 b)
+        {
+            if constexpr(OP==BitOp::And)    return a&b;
+            if constexpr(OP==BitOp::Or)     return a|b;
+            if constexpr(OP==BitOp::Xor)    return a^b;
+            if constexpr(OP==BitOp::AndNot) return a&~b;
+        }
+
+        template<BitOp OP>
+        inline void BulkScalar(uint64 *dst,const uint64 *src,const size_t count)
+        {
+            for(size_t i=0;i<count;i++)
+                dst[i]=Apply<OP>(dst[i],src[i]);
+        }
+
+        inline uint64 PopCountScalar(const uint64 *data,const size_t count)
+        {
+            uint64 total=0;
+
+            for(size_t i=0;i<count;i++)
+                total+=std::popcount(data[i]);
+
+            return total;
+        }
+
+        /**
+         * 批量位运算与位计数，按 GetCpuTier() 分派到 src/Type/BitVector.*.cpp 中各指令集档次的实现
+         */
+        void BulkOp(BitOp op,uint64 *dst,const uint64 *src,size_t count);
+        uint64 PopCount(const uint64 *data,size_t count);
+
+        /**
+         * 使用不高于指定档次的实现（tier不可高于 GetCpuTier()），供测试逐一核对各档次
+         */
+        void BulkOp(BitOp op,uint64 *dst,const uint64 *src,size_t count,CpuTier tier);
+        uint64 PopCount(const uint64 *data,size_t count,CpuTier tier);
+
+        template<BitOp OP>
+        inline void Bulk(uint64 *dst,const uint64 *src,const size_t count)
+        {
+            BulkOp(OP,dst,src,count);
+        }
+
+        /**
+         * 每个字节中第k个为1的位的位置表，[byte*8+k]
+         */
+        struct SelectInByteTable
+        {
+            uint8 pos[256*8]{};
+
+            constexpr SelectInByteTable()
+            {
+                for(uint32 b=0;b<256;b++)
+                {
+                    uint32 k=0;
+
+                    for(uint32 i=0;i<8;i++)
+                        if(b&(1u<<i))
+                            pos[b*8+k++]=uint8(i);
+                }
+            }
+        };
+
+        inline constexpr SelectInByteTable select_in_byte;
+
+        /**
+         * 返回64位字中第k个(从0开始)为1的位的位置，要求 k<popcount(word)
+         */
+        inline uint32 SelectInWord(const uint64 word,const uint32 k)
+        {
+#if defined(__BMI2__)&&HGL_CPU==HGL_CPU_X86_64
+            return uint32(std::countr_zero(_pdep_u64(uint64(1)<<k,word)));
+#else
+            //broadword：先求各字节的前缀计数，再并行比较找出所在字节，最后查表（Vigna）
+            constexpr uint64 ONES=0x0101010101010101ULL;
+            constexpr uint64 HIGH=0x8080808080808080ULL;
+
+            uint64 s=word-((word>>1)&0x5555555555555555ULL);
+            s=(s&0x3333333333333333ULL)+((s>>2)&0x3333333333333333ULL);
+            s=(s+(s>>4))&0x0F0F0F0F0F0F0F0FULL;
+
+            const uint64 prefix=s*ONES;                             //第i字节为前i+1个字节中1的数量
+            const uint64 le=(((uint64(k)*ONES)|HIGH)-prefix)&HIGH;  //prefix<=k的字节最高位为1
+            const uint32 byte=uint32(((le>>7)*ONES)>>56);           //所在字节
+            const uint32 before=uint32((prefix<<8)>>(byte*8))&0xFF;      //前byte个字节中1的数量
+
+            return byte*8+select_in_byte.pos[((word>>(byte*8))&0xFF)*8+k-before];
+#endif
+        }
+    }//namespace bit_vector_detail
+
+    /**
+     * 动态位向量<br>
+     * <ul>
+     *  <li>按64位字存储，超出长度的尾部位恒为0</li>
+     *  <li>And/Or/Xor/AndNot 与位计数在支持AVX2的CPU上使用AVX2（运行时检测）</li>
+     *  <li>ForEachSetBit/FindNext 用 tzcnt 逐个跳到下一个为1的位</li>
+     *  <li>BuildRankIndex 后 Rank 为O(1)（rank9结构，每512位16字节，约占3%），Select 由每1024个1的采样定位到相邻的几个块后顺序查找</li>
+     * </ul>
+     * 修改位向量会使rank/select索引失效，需要重新调用 BuildRankIndex。
+     */
+    class BitVector
+    {
+    public:
+
+        static constexpr size_t WORD_BITS   =64;
+        static constexpr size_t BLOCK_BITS  =512;                   ///<rank9 每个块的位数
+        static constexpr size_t SELECT_SAMPLE=1024;                 ///<每多少个1记录一次所在的块
+
+    private:
+
+        std::vector<uint64> words;
+        size_t bit_count=0;
+
+        std::vector<uint64> rank_index;                             ///<每块两个值：块前1的数量、块内各字前1的数量(7x9位)
+        std::vector<uint32> select_sample;
+        uint64 total_ones=0;
+        bool rank_valid=false;
+
+    private:
+
+        static constexpr size_t WordCount(const size_t bits){return (bits+WORD_BITS-1)/WORD_BITS;}
+
+        void ClearTail()
+        {
+            const size_t rem=bit_count%WORD_BITS;
+
+            if(rem)
+                words.back()&=(uint64(1)<<rem)-1;
+        }
+
+        template<bit_vector_detail::BitOp OP>
+        bool Bulk(const BitVector &bv)
+        {
+            if(bv.bit_count!=bit_count)
+                return false;
+
+            bit_vector_detail::Bulk<OP>(words.data(),bv.words.data(),words.size());
+            rank_valid=false;
+            return true;
+        }
+
+        /**
+         * 第b块之前0的数量
+         */
+        uint64 ZerosBeforeBlock(const size_t b)const{return uint64(b)*BLOCK_BITS-rank_index[b*2];}
+
+    public:
+
+        BitVector()=default;
+
+        explicit BitVector(const size_t count,const bool value=false){Resize(count,value);}
+
+        size_t GetCount()const{return bit_count;}
+        size_t GetWordCount()const{return words.size();}
+        const uint64 *GetData()const{return words.data();}
+              uint64 *GetData(){rank_valid=false;return words.data();}       ///<直接修改后需保证尾部位为0
+        bool IsEmpty()const{return bit_count==0;}
+
+        /**
+         * 调整长度，新增的位设为value
+         */
+        void Resize(const size_t count,const bool value=false)
+        {
+            const size_t old_count=bit_count;
+
+            words.resize(WordCount(count),0);
+            bit_count=count;
+
+            if(value&&count>old_count)
+                SetRange(old_count,count,true);
+            else
+                ClearTail();
+
+            rank_valid=false;
+        }
+
+        void Clear()
+        {
+            words.clear();
+            bit_count=0;
+            rank_index.clear();
+            select_sample.clear();
+            rank_valid=false;
+        }
+
+        bool Get(const size_t index)const
+        {
+            return (words[index/WORD_BITS]>>(index%WORD_BITS))&1;
+        }
+
+        bool operator[](const size_t index)const{return Get(index);}
+
+        void Set(const size_t index)
+        {
+            words[index/WORD_BITS]|=uint64(1)<<(index%WORD_BITS);
+            rank_valid=false;
+        }
+
+        void Set(const size_t index,const bool value)
+        {
+            const uint64 mask=uint64(1)<<(index%WORD_BITS);
+            uint64 &w=words[index/WORD_BITS];
+
+            w=(w&~mask)|((uint64(0)-uint64(value))&mask);
+            rank_valid=false;
+        }
+
+        void Reset(const size_t index)
+        {
+            words[index/WORD_BITS]&=~(uint64(1)<<(index%WORD_BITS));
+            rank_valid=false;
+        }
+
+        void Flip(const size_t index)
+        {
+            words[index/WORD_BITS]^=uint64(1)<<(index%WORD_BITS);
+            rank_valid=false;
+        }
+
+        void SetAll(const bool value)
+        {
+            std::fill(words.begin(),words.end(),value?~uint64(0):uint64(0));
+            ClearTail();
+            rank_valid=false;
+        }
+
+        /**
+         * 设置[begin,end)范围内的所有位
+         */
+        void SetRange(size_t begin,const size_t end,const bool value)
+        {
+            if(begin>=end||end>bit_count)return;
+
+            size_t w=begin/WORD_BITS;
+            const size_t last=(end-1)/WORD_BITS;
+
+            const uint64 first_mask=~uint64(0)<<(begin%WORD_BITS);
+            const uint64 last_mask=~uint64(0)>>(WORD_BITS-1-(end-1)%WORD_BITS);
+
+            if(w==last)
+            {
+                const uint64 mask=first_mask&last_mask;
+                words[w]=value?(words[w]|mask):(words[w]&~mask);
+            }
+            else
+            {
+                words[w]=value?(words[w]|first_mask):(words[w]&~first_mask);
+
+                std::fill(words.begin()+w+1,words.begin()+last,value?~uint64(0):uint64(0));
+
+                words[last]=value?(words[last]|last_mask):(words[last]&~last_mask);
+            }
+
+            rank_valid=false;
+        }
+
+        /**
+         * 取反所有位
+         */
+        void Not()
+        {
+            for(uint64 &w:words)w=~w;
+
+            ClearTail();
+            rank_valid=false;
+        }
+
+        /**
+         * 批量位运算，两者长度必须相同
+         * @return 长度不同时返回false，不做任何修改
+         */
+        bool And   (const BitVector &bv){return Bulk<bit_vector_detail::BitOp::And   >(bv);}
+        bool Or    (const BitVector &bv){return Bulk<bit_vector_detail::BitOp::Or    >(bv);}
+        bool Xor   (const BitVector &bv){return Bulk<bit_vector_detail::BitOp::Xor   >(bv);}
+        bool AndNot(const BitVector &bv){return Bulk<bit_vector_detail::BitOp::AndNot>(bv);}
+
+        BitVector &operator&=(const BitVector &bv){And(bv);return *this;}
+        BitVector &operator|=(const BitVector &bv){Or(bv);return *this;}
+        BitVector &operator^=(const BitVector &bv){Xor(bv);return *this;}
+
+        bool operator==(const BitVector &bv)const{return bit_count==bv.bit_count&&words==bv.words;}
+
+        /**
+         * 为1的位的数量
+         */
+        uint64 Count()const
+        {
+            return bit_vector_detail::PopCount(words.data(),words.size());
+        }
+
+        /**
+         * [begin,end)范围内为1的位的数量
+         */
+        uint64 Count(const size_t begin,size_t end)const
+        {
+            if(end>bit_count)end=bit_count;
+            if(begin>=end)return 0;
+
+            const size_t first=begin/WORD_BITS;
+            const size_t last=(end-1)/WORD_BITS;
+
+            const uint64 first_mask=~uint64(0)<<(begin%WORD_BITS);
+            const uint64 last_mask=~uint64(0)>>(WORD_BITS-1-(end-1)%WORD_BITS);
+
+            if(first==last)
+                return std::popcount(words[first]&first_mask&last_mask);
+
+            return std::popcount(words[first]&first_mask)
+                  +bit_vector_detail::PopCount(words.data()+first+1,last-first-1)
+                  +std::popcount(words[last]&last_mask);
+        }
+
+        bool Any()const
+        {
+            for(const uint64 w:words)
+                if(w)return true;
+
+            return false;
+        }
+
+        bool None()const{return !Any();}
+
+        /**
+         * 查找from及之后第一个为1的位
+         * @return 位置，没有返回-1
+         */
+        int64 FindNext(const size_t from)const
+        {
+            if(from>=bit_count)return -1;
+
+            size_t w=from/WORD_BITS;
+            uint64 bits=words[w]&(~uint64(0)<<(from%WORD_BITS));
+
+            for(;;)
+            {
+                if(bits)
+                    return int64(w*WORD_BITS+std::countr_zero(bits));
+
+                if(++w>=words.size())
+                    return -1;
+
+                bits=words[w];
+            }
+        }
+
+        int64 FindFirst()const{return FindNext(0);}
+
+        /**
+         * 按从小到大的顺序对每个为1的位调用 func(size_t index)
+         */
+        template<typename F>
+        void ForEachSetBit(F &&func)const
+        {
+            const size_t count=words.size();
+
+            for(size_t w=0;w<count;w++)
+            {
+                uint64 bits=words[w];
+
+                while(bits)
+                {
+                    func(size_t(w*WORD_BITS+std::countr_zero(bits)));
+                    bits&=bits-1;
+                }
+            }
+        }
+
+        /**
+         * 将所有为1的位的位置写入output
+         * @return 写入的数量
+         */
+        template<typename T>
+        size_t GetSetBits(std::vector<T> &output)const
+        {
+            output.clear();
+            ForEachSetBit([&output](const size_t index){output.push_back(T(index));});
+            return output.size();
+        }
+
+    public: //rank/select
+
+        /**
+         * 建立rank/select索引
+         */
+        void BuildRankIndex()
+        {
+            const size_t word_count=words.size();
+            const size_t block_count=(word_count+7)/8;
+
+            rank_index.assign(block_count*2+2,0);
+            select_sample.clear();
+
+            uint64 total=0;
+
+            for(size_t b=0;b<block_count;b++)
+            {
+                rank_index[b*2]=total;
+
+                uint64 rel=0;
+                uint64 in_block=0;
+
+                for(size_t j=0;j<8;j++)
+                {
+                    const size_t w=b*8+j;
+
+                    if(j)
+                        rel|=in_block<<(9*(j-1));
+
+                    if(w<word_count)
+                    {
+                        const uint64 c=std::popcount(words[w]);
+
+                        //记录第k*SELECT_SAMPLE个1所在的块
+                        while(select_sample.size()*SELECT_SAMPLE<total+in_block+c)
+                            select_sample.push_back(uint32(b));
+
+                        in_block+=c;
+                    }
+                }
+
+                rank_index[b*2+1]=rel;
+                total+=in_block;
+            }
+
+            rank_index[block_count*2]=total;                        //哨兵块
+            select_sample.push_back(uint32(block_count));
+
+            total_ones=total;
+            rank_valid=true;
+        }
+
+        bool IsRankIndexValid()const{return rank_valid;}
+
+        /**
+         * [0,index)范围内为1的位的数量，O(1)
+         * @return 索引无效时返回-1
+         */
+        int64 Rank1(size_t index)const
+        {
+            if(!rank_valid)return -1;
+            if(index>=bit_count)return int64(total_ones);
+
+            const size_t w=index/WORD_BITS;
+            const size_t b=w/8;
+            const size_t j=w%8;
+
+            const uint64 rel=(rank_index[b*2+1]>>((9*(j-1))&63))&0x1FF;
+
+            return int64(rank_index[b*2]
+                        +(j?rel:0)
+                        +uint64(std::popcount(words[w]&((uint64(1)<<(index%WORD_BITS))-1))));
+        }
+
+        /**
+         * [0,index)范围内为0的位的数量
+         */
+        int64 Rank0(const size_t index)const
+        {
+            const int64 ones=Rank1(index);
+
+            return ones<0?-1:int64(std::min(index,bit_count))-ones;
+        }
+
+        /**
+         * 第k个(从0开始)为1的位的位置
+         * @return 位置，k超出范围或索引无效时返回-1
+         */
+        int64 Select1(const uint64 k)const
+        {
+            if(!rank_valid||k>=total_ones)return -1;
+
+            //由采样确定块范围，范围大时先二分，最后在相邻几个块中顺序查找
+            size_t lo=select_sample[k/SELECT_SAMPLE];
+            size_t hi=select_sample[k/SELECT_SAMPLE+1]+1;                  //末尾有哨兵，下一项总是存在
+
+            while(hi-lo>8)
+            {
+                const size_t mid=(lo+hi)/2;
+
+                if(rank_index[mid*2]<=k)
+                    lo=mid;
+                else
+                    hi=mid;
+            }
+
+            while(rank_index[(lo+1)*2]<=k)                          //哨兵块的计数为总数，必然停止
+                ++lo;
+
+            uint64 remain=k-rank_index[lo*2];
+            const uint64 rel=rank_index[lo*2+1];
+
+            size_t j=0;
+
+            while(j<7&&((rel>>(9*j))&0x1FF)<=remain)                //rel的第j项是前j+1个字中1的数量
+                ++j;
+
+            if(j)
+                remain-=(rel>>(9*(j-1)))&0x1FF;
+
+            const size_t w=lo*8+j;
+
+            return int64(w*WORD_BITS+bit_vector_detail::SelectInWord(words[w],uint32(remain)));
+        }
+
+        /**
+         * 第k个(从0开始)为0的位的位置
+         * @return 位置，k超出范围或索引无效时返回-1
+         */
+        int64 Select0(const uint64 k)const
+        {
+            if(!rank_valid||k>=bit_count-total_ones)return -1;
+
+            const size_t block_count=(words.size()+7)/8;
+
+            size_t lo=0,hi=block_count;
+
+            while(hi-lo>1)
+            {
+                const size_t mid=(lo+hi)/2;
+
+                if(ZerosBeforeBlock(mid)<=k)
+                    lo=mid;
+                else
+                    hi=mid;
+            }
+
+            uint64 remain=k-ZerosBeforeBlock(lo);
+            const uint64 rel=rank_index[lo*2+1];
+
+            size_t j=0;
+
+            while(j<7&&(64*(j+1)-((rel>>(9*j))&0x1FF))<=remain)
+                ++j;
+
+            if(j)
+                remain-=64*j-((rel>>(9*(j-1)))&0x1FF);
+
+            const size_t w=lo*8+j;
+
+            return int64(w*WORD_BITS+bit_vector_detail::SelectInWord(~words[w],uint32(remain)));
+        }
+
+        /**
+         * 索引占用的字节数
+         */
+        size_t GetRankIndexBytes()const
+        {
+            return rank_index.size()*sizeof(uint64)+select_sample.size()*sizeof(uint32);
+        }
+    };//class BitVector
+}//namespace hgl
@@ -0,0 +1,158 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<cstring>
+#include<functional>
+#include<utility>
+#include<vector>
+
+namespace hgl
+{
+    /**
+     * 一段待输出的连续数据
+     */
+    struct ByteSinkSpan
+    {
+        const uint8 *   data;
+        size_t          size;
+    };//struct ByteSinkSpan
+
+    /**
+     * 字节输出目标<br>
+     * ChunkedByteWriter 每次把若干个写满的数据块一起交给 Write()，
+     * 实现者可以一次性聚集写出（如writev），不必逐块调用。
+     */
+    class ByteSink
+    {
+    public:
+
+        virtual ~ByteSink()=default;
+
+        /**
+         * 按顺序写出多段数据
+         * @return 是否全部写出成功
+         */
+        virtual bool Write(const ByteSinkSpan *spans,size_t count)=0;
+
+        /**
+         * 是否支持修改已经写出的数据（可寻址的目标，如普通文件、内存）
+         */
+        virtual bool CanPatch()const{return false;}
+
+        /**
+         * 修改已经写出的数据
+         * @param offset 相对于此目标第一次Write起点的偏移
+         */
+        virtual bool Patch(uint64 /*offset*/,const void *,size_t){return false;}
+
+        /**
+         * 所有数据写出完毕后调用
+         */
+        virtual bool Finish(){return true;}
+    };//class ByteSink
+
+    /**
+     * 追加到 std::vector 的输出目标
+     */
+    class MemoryByteSink:public ByteSink
+    {
+        std::vector<uint8> &out;
+        size_t base;                                                    ///<构造时vector中已有的数据长度
+
+    public:
+
+        explicit MemoryByteSink(std::vector<uint8> &buffer):out(buffer),base(buffer.size()){}
+
+        bool Write(const ByteSinkSpan *spans,size_t count) override
+        {
+            size_t total=0;
+
+            for(size_t i=0;i<count;i++)
+                total+=spans[i].size;
+
+            size_t pos=out.size();
+            out.resize(pos+total);
+
+            for(size_t i=0;i<count;i++)
+            {
+                std::memcpy(out.data()+pos,spans[i].data,spans[i].size);
+                pos+=spans[i].size;
+            }
+
+            return true;
+        }
+
+        bool CanPatch()const override{return true;}
+
+        bool Patch(uint64 offset,const void *data,size_t size) override
+        {
+            if(offset+size>out.size()-base)
+                return false;
+
+            std::memcpy(out.data()+base+offset,data,size);
+            return true;
+        }
+    };//class MemoryByteSink
+
+    /**
+     * 回调函数输出目标（如压缩器、网络发送、校验计算）<br>
+     * 回调函数逐段调用，返回false表示输出失败。
+     */
+    class CallbackByteSink:public ByteSink
+    {
+    public:
+
+        using WriteFunc=std::function<bool(const uint8 *,size_t)>;
+
+    private:
+
+        WriteFunc func;
+
+    public:
+
+        explicit CallbackByteSink(WriteFunc f):func(std::move(f)){}
+
+        bool Write(const ByteSinkSpan *spans,size_t count) override
+        {
+            if(!func)
+                return false;
+
+            for(size_t i=0;i<count;i++)
+                if(!func(spans[i].data,spans[i].size))
+                    return false;
+
+            return true;
+        }
+    };//class CallbackByteSink
+
+    /**
+     * 文件描述符输出目标（POSIX）<br>
+     * 多段数据以 writev 一次性写出，自动处理部分写入与EINTR。
+     * 可寻址的文件（lseek成功）支持Patch，以pwrite回写。
+     */
+    class FdByteSink:public ByteSink
+    {
+        int fd;
+        bool close_on_destroy;
+        bool seekable;
+        int64 base;                                                     ///<构造时的文件位置
+
+    public:
+
+        /**
+         * @param file_descriptor 已打开的可写文件描述符
+         * @param close_fd 析构时是否关闭文件描述符
+         */
+        FdByteSink(int file_descriptor,bool close_fd=false);
+        ~FdByteSink() override;
+
+        NO_COPY_NO_MOVE(FdByteSink)
+
+        int GetFD()const{return fd;}
+
+        bool Write(const ByteSinkSpan *spans,size_t count) override;
+
+        bool CanPatch()const override{return seekable;}
+        bool Patch(uint64 offset,const void *data,size_t size) override;
+    };//class FdByteSink
+}//namespace hgl
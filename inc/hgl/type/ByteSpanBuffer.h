@@ -0,0 +1,594 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<cstdint>
+#include<cstddef>
+#include<cstring>
+#include<span>
+#include<string>
+#include<string_view>
+#include<vector>
+#include<type_traits>
+
+namespace hgl
+{
+    //==================================================================================================
+    // 字节序与ZigZag编码 / Byte Order & ZigZag Encoding
+    //==================================================================================================
+
+    /**
+     * 字节序反转（仅对1/2/4/8字节整数）
+     */
+    template<typename T>
+    constexpr T byte_swap(T value) noexcept
+    {
+        static_assert(std::is_integral_v<T>,"byte_swap only support integral types");
+
+        if constexpr(sizeof(T)==1)
+        {
+            return value;
+        }
+        else
+        {
+            using UT=std::make_unsigned_t<T>;
+
+            UT u=static_cast<UT>(value);
+            UT r=0;
+
+            for(size_t i=0;i<sizeof(T);i++)
+            {
+                r=static_cast<UT>((r<<8)|(u&0xFF));
+                u=static_cast<UT>(u>>8);
+            }
+
+            return static_cast<T>(r);
+        }
+    }
+
+    /**
+     * 将数值从本机字节序转换为小端（在小端CPU上为空操作）
+     */
+    template<typename T>
+    inline T to_little_endian(T value) noexcept
+    {
+    #if HGL_ENDIAN == HGL_BIG_ENDIAN
+        if constexpr(std::is_floating_point_v<T>)
+        {
+            using UT=std::conditional_t<sizeof(T)==4,uint32,uint64>;
+
+            UT u;
+            std::memcpy(&u,&value,sizeof(T));
+            u=byte_swap(u);
+            std::memcpy(&value,&u,sizeof(T));
+            return value;
+        }
+        else
+            return byte_swap(value);
+    #else
+        return value;
+    #endif//HGL_ENDIAN
+    }
+
+    template<typename T>
+    inline T from_little_endian(T value) noexcept
+    {
+        return to_little_endian(value);
+    }
+
+    constexpr uint32 zigzag_encode(const int32 value) noexcept{return (uint32(value)<<1)^uint32(value>>31);}
+    constexpr uint64 zigzag_encode(const int64 value) noexcept{return (uint64(value)<<1)^uint64(value>>63);}
+    constexpr int32  zigzag_decode(const uint32 value) noexcept{return int32(value>>1)^-int32(value&1);}
+    constexpr int64  zigzag_decode(const uint64 value) noexcept{return int64(value>>1)^-int64(value&1);}
+
+    /**
+     * 计算数值以LEB128变长编码后的字节数
+     */
+    constexpr size_t varint_size(uint64 value) noexcept
+    {
+        size_t size=1;
+
+        while(value>=0x80)
+        {
+            value>>=7;
+            ++size;
+        }
+
+        return size;
+    }
+
+    constexpr size_t VARINT32_MAX_BYTES=5;
+    constexpr size_t VARINT64_MAX_BYTES=10;
+
+    /**
+     * 将数值以LEB128编码写入指定内存（不检查空间，调用者需保证至少VARINT64_MAX_BYTES字节）
+     * @return 写入的字节数
+     */
+    inline size_t varint_encode_unchecked(uint8 *p,uint64 value) noexcept
+    {
+        uint8 *start=p;
+
+        while(value>=0x80)
+        {
+            *p++=uint8(value|0x80);
+            value>>=7;
+        }
+
+        *p++=uint8(value);
+        return size_t(p-start);
+    }
+
+    template<typename T>
+    concept ByteSpanValue=std::is_arithmetic_v<T>&&!std::is_same_v<T,bool>;
+
+    /**
+     * 基于任意内存区域的只读字节流（零拷贝）<br>
+     * 所有多字节数值以小端存储，与 ByteWriter/ByteReader 保持一致。
+     *
+     * 每个读取函数都有检查版与非检查版：
+     * - u32(value)等检查版在越界时返回false，不移动读取位置
+     * - 先调用 require(n) 做一次边界检查后，可以连续调用 *_unchecked 系列函数
+     */
+    class ByteSpanReader
+    {
+        const uint8 *data;
+        size_t size;
+        size_t offset;
+
+    private:
+
+        bool varint_slow(uint64 &value,size_t max_bytes)
+        {
+            uint64 result=0;
+            size_t pos=offset;
+
+            for(size_t i=0;i<max_bytes;i++)
+            {
+                if(pos>=size)
+                    return false;
+
+                const uint8 byte=data[pos++];
+
+                if(i==VARINT64_MAX_BYTES-1&&(byte&0x7E))                //第10字节只能携带第63位
+                    return false;
+
+                result|=uint64(byte&0x7F)<<(7*i);
+
+                if(!(byte&0x80))
+                {
+                    value=result;
+                    offset=pos;
+                    return true;
+                }
+            }
+
+            return false;                                               //超过最大长度，数据损坏
+        }
+
+        bool varint(uint64 &value,size_t max_bytes)
+        {
+            if(size-offset<VARINT64_MAX_BYTES)
+                return varint_slow(value,max_bytes);
+
+            //快速路径：剩余空间足够容纳最长编码，无需逐字节检查边界
+            const uint8 *p=data+offset;
+
+            if(p[0]<0x80)                                               //单字节是最常见的情况
+            {
+                value=p[0];
+                ++offset;
+                return true;
+            }
+
+            uint64 result=0;
+
+            for(size_t i=0;i<max_bytes;i++)
+            {
+                const uint8 byte=p[i];
+
+                if(i==VARINT64_MAX_BYTES-1&&(byte&0x7E))
+                    return false;
+
+                result|=uint64(byte&0x7F)<<(7*i);
+
+                if(!(byte&0x80))
+                {
+                    value=result;
+                    offset+=i+1;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    public:
+
+        ByteSpanReader(const void *buffer,size_t length)
+            : data(static_cast<const uint8 *>(buffer)),size(buffer?length:0),offset(0)
+        {
+        }
+
+        explicit ByteSpanReader(std::span<const uint8> buffer)
+            : data(buffer.data()),size(buffer.size()),offset(0)
+        {
+        }
+
+        explicit ByteSpanReader(const std::vector<uint8_t> &buffer)
+            : data(buffer.data()),size(buffer.size()),offset(0)
+        {
+        }
+
+        const uint8 *begin  ()const{return data;}
+        const uint8 *current()const{return data+offset;}
+        size_t total        ()const{return size;}
+        size_t tell         ()const{return offset;}
+        size_t left         ()const{return size-offset;}
+        bool   eof          ()const{return offset>=size;}
+
+        /**
+         * 检查剩余字节是否足够，之后可连续使用 *_unchecked 函数读取这些字节
+         */
+        bool require(size_t bytes)const{return bytes<=size-offset;}
+
+        bool seek(size_t pos)
+        {
+            if(pos>size)
+                return false;
+
+            offset=pos;
+            return true;
+        }
+
+        bool skip(size_t bytes)
+        {
+            if(!require(bytes))
+                return false;
+
+            offset+=bytes;
+            return true;
+        }
+
+        //---------------------------------------------------------------------------------------------
+        // 定长数值
+        //---------------------------------------------------------------------------------------------
+
+        template<ByteSpanValue T>
+        T value_unchecked()
+        {
+            T result;
+            std::memcpy(&result,data+offset,sizeof(T));
+            offset+=sizeof(T);
+            return from_little_endian(result);
+        }
+
+        template<ByteSpanValue T>
+        bool value(T &result)
+        {
+            if(!require(sizeof(T)))
+                return false;
+
+            result=value_unchecked<T>();
+            return true;
+        }
+
+        bool u8 (uint8  &v){return value(v);}
+        bool u16(uint16 &v){return value(v);}
+        bool u32(uint32 &v){return value(v);}
+        bool u64(uint64 &v){return value(v);}
+        bool i8 (int8   &v){return value(v);}
+        bool i16(int16  &v){return value(v);}
+        bool i32(int32  &v){return value(v);}
+        bool i64(int64  &v){return value(v);}
+        bool f32(float  &v){return value(v);}
+        bool f64(double &v){return value(v);}
+
+        uint8  u8_unchecked (){return value_unchecked<uint8 >();}
+        uint16 u16_unchecked(){return value_unchecked<uint16>();}
+        uint32 u32_unchecked(){return value_unchecked<uint32>();}
+        uint64 u64_unchecked(){return value_unchecked<uint64>();}
+        int32  i32_unchecked(){return value_unchecked<int32 >();}
+        int64  i64_unchecked(){return value_unchecked<int64 >();}
+        float  f32_unchecked(){return value_unchecked<float >();}
+        double f64_unchecked(){return value_unchecked<double>();}
+
+        //---------------------------------------------------------------------------------------------
+        // 变长整数 (LEB128 / ZigZag)
+        //---------------------------------------------------------------------------------------------
+
+        bool varu64(uint64 &v){return varint(v,VARINT64_MAX_BYTES);}
+
+        bool varu32(uint32 &v)
+        {
+            uint64 tmp;
+
+            if(!varint(tmp,VARINT32_MAX_BYTES)||tmp>0xFFFFFFFFull)
+                return false;
+
+            v=uint32(tmp);
+            return true;
+        }
+
+        bool vari32(int32 &v)
+        {
+            uint32 tmp;
+
+            if(!varu32(tmp))
+                return false;
+
+            v=zigzag_decode(tmp);
+            return true;
+        }
+
+        bool vari64(int64 &v)
+        {
+            uint64 tmp;
+
+            if(!varu64(tmp))
+                return false;
+
+            v=zigzag_decode(tmp);
+            return true;
+        }
+
+        //---------------------------------------------------------------------------------------------
+        // 批量数据
+        //---------------------------------------------------------------------------------------------
+
+        /**
+         * 读取原始字节（复制）
+         */
+        bool bytes(void *out,size_t length)
+        {
+            if(!require(length))
+                return false;
+
+            if(length)
+                std::memcpy(out,data+offset,length);
+
+            offset+=length;
+            return true;
+        }
+
+        /**
+         * 取得原始字节的指针（零拷贝），数据生命周期由底层内存决定
+         */
+        bool bytes_view(const uint8 *&out,size_t length)
+        {
+            if(!require(length))
+                return false;
+
+            out=data+offset;
+            offset+=length;
+            return true;
+        }
+
+        /**
+         * 批量读取数值数组（小端CPU上为一次memcpy）
+         */
+        template<ByteSpanValue T>
+        bool array(T *out,size_t count)
+        {
+            if(count>(size-offset)/sizeof(T))
+                return false;
+
+            if(count)
+                std::memcpy(out,data+offset,count*sizeof(T));
+            offset+=count*sizeof(T);
+
+        #if HGL_ENDIAN == HGL_BIG_ENDIAN
+            for(size_t i=0;i<count;i++)
+                out[i]=from_little_endian(out[i]);
+        #endif//HGL_ENDIAN
+
+            return true;
+        }
+
+        template<ByteSpanValue T>
+        bool array(std::vector<T> &out,size_t count)
+        {
+            if(count>(size-offset)/sizeof(T))
+                return false;
+
+            out.resize(count);
+            return array(out.data(),count);
+        }
+
+        //---------------------------------------------------------------------------------------------
+        // 字符串（变长长度前缀，不限255字节）
+        //---------------------------------------------------------------------------------------------
+
+        bool string_view(std::string_view &out)
+        {
+            const size_t start=offset;
+            uint64 length;
+
+            if(!varu64(length)||length>left())
+            {
+                offset=start;
+                return false;
+            }
+
+            out=std::string_view(reinterpret_cast<const char *>(data+offset),size_t(length));
+            offset+=size_t(length);
+            return true;
+        }
+
+        bool string(std::string &out)
+        {
+            std::string_view sv;
+
+            if(!string_view(sv))
+                return false;
+
+            out.assign(sv.data(),sv.size());
+            return true;
+        }
+    };//class ByteSpanReader
+
+    /**
+     * 基于调用者提供的定长内存的字节写入器<br>
+     * 空间不足时写入函数返回false，不写入任何字节。
+     */
+    class ByteSpanWriter
+    {
+        uint8 *data;
+        size_t capacity;
+        size_t offset;
+
+    public:
+
+        ByteSpanWriter(void *buffer,size_t length)
+            : data(static_cast<uint8 *>(buffer)),capacity(buffer?length:0),offset(0)
+        {
+        }
+
+        explicit ByteSpanWriter(std::span<uint8> buffer)
+            : data(buffer.data()),capacity(buffer.size()),offset(0)
+        {
+        }
+
+        void reset(){offset=0;}
+
+        uint8 *begin        ()const{return data;}
+        uint8 *current      ()const{return data+offset;}
+        size_t total        ()const{return capacity;}
+        size_t tell         ()const{return offset;}
+        size_t left         ()const{return capacity-offset;}
+
+        std::span<const uint8> written()const{return std::span<const uint8>(data,offset);}
+
+        /**
+         * 检查剩余空间是否足够，之后可连续使用 *_unchecked 函数写入这些字节
+         */
+        bool require(size_t bytes)const{return bytes<=capacity-offset;}
+
+        bool skip(size_t bytes)
+        {
+            if(!require(bytes))
+                return false;
+
+            offset+=bytes;
+            return true;
+        }
+
+        //---------------------------------------------------------------------------------------------
+        // 定长数值
+        //---------------------------------------------------------------------------------------------
+
+        template<ByteSpanValue T>
+        void value_unchecked(T v)
+        {
+            v=to_little_endian(v);
+            std::memcpy(data+offset,&v,sizeof(T));
+            offset+=sizeof(T);
+        }
+
+        template<ByteSpanValue T>
+        bool value(T v)
+        {
+            if(!require(sizeof(T)))
+                return false;
+
+            value_unchecked(v);
+            return true;
+        }
+
+        bool u8 (uint8  v){return value(v);}
+        bool u16(uint16 v){return value(v);}
+        bool u32(uint32 v){return value(v);}
+        bool u64(uint64 v){return value(v);}
+        bool i8 (int8   v){return value(v);}
+        bool i16(int16  v){return value(v);}
+        bool i32(int32  v){return value(v);}
+        bool i64(int64  v){return value(v);}
+        bool f32(float  v){return value(v);}
+        bool f64(double v){return value(v);}
+
+        void u8_unchecked (uint8  v){value_unchecked(v);}
+        void u16_unchecked(uint16 v){value_unchecked(v);}
+        void u32_unchecked(uint32 v){value_unchecked(v);}
+        void u64_unchecked(uint64 v){value_unchecked(v);}
+        void i32_unchecked(int32  v){value_unchecked(v);}
+        void i64_unchecked(int64  v){value_unchecked(v);}
+        void f32_unchecked(float  v){value_unchecked(v);}
+        void f64_unchecked(double v){value_unchecked(v);}
+
+        //---------------------------------------------------------------------------------------------
+        // 变长整数 (LEB128 / ZigZag)
+        //---------------------------------------------------------------------------------------------
+
+        bool varu64(uint64 v)
+        {
+            if(left()>=VARINT64_MAX_BYTES)
+            {
+                offset+=varint_encode_unchecked(data+offset,v);
+                return true;
+            }
+
+            const size_t need=varint_size(v);
+
+            if(!require(need))
+                return false;
+
+            offset+=varint_encode_unchecked(data+offset,v);
+            return true;
+        }
+
+        bool varu32(uint32 v){return varu64(v);}
+        bool vari32(int32 v){return varu64(zigzag_encode(v));}
+        bool vari64(int64 v){return varu64(zigzag_encode(v));}
+
+        //---------------------------------------------------------------------------------------------
+        // 批量数据
+        //---------------------------------------------------------------------------------------------
+
+        bool bytes(const void *src,size_t length)
+        {
+            if(!require(length))
+                return false;
+
+            if(length)
+                std::memcpy(data+offset,src,length);
+
+            offset+=length;
+            return true;
+        }
+
+        template<ByteSpanValue T>
+        bool array(const T *src,size_t count)
+        {
+            if(count>(capacity-offset)/sizeof(T))
+                return false;
+
+        #if HGL_ENDIAN == HGL_BIG_ENDIAN
+            for(size_t i=0;i<count;i++)
+                value_unchecked(src[i]);
+        #else
+            if(count)
+                std::memcpy(data+offset,src,count*sizeof(T));
+
+            offset+=count*sizeof(T);
+        #endif//HGL_ENDIAN
+
+            return true;
+        }
+
+        //---------------------------------------------------------------------------------------------
+        // 字符串（变长长度前缀，不限255字节）
+        //---------------------------------------------------------------------------------------------
+
+        bool string(std::string_view str)
+        {
+            if(!require(varint_size(str.size())+str.size()))
+                return false;
+
+            offset+=varint_encode_unchecked(data+offset,str.size());
+
+            if(!str.empty())
+                std::memcpy(data+offset,str.data(),str.size());
+
+            offset+=str.size();
+            return true;
+        }
+    };//class ByteSpanWriter
+}//namespace hgl
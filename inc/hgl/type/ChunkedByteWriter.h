@@ -0,0 +1,544 @@
+﻿#pragma once
+
+#include<hgl/type/ByteSink.h>
+#include<hgl/type/ByteSpanBuffer.h>
+#include<algorithm>
+#include<new>
+
+namespace hgl
+{
+    /**
+     * 分块写入器配置
+     */
+    struct ChunkedByteWriterConfig
+    {
+        size_t  block_size  =64*1024;           ///<每个数据块的字节数（会向上对齐到block_align）
+        size_t  block_align =4096;              ///<数据块内存对齐
+        size_t  flush_blocks=4;                 ///<积累多少个写满的数据块后一次性交给ByteSink
+        size_t  max_blocks  =64;                ///<最多同时持有的数据块数量，决定内存上限
+    };//struct ChunkedByteWriterConfig
+
+    struct ChunkedByteWriterStats
+    {
+        uint64  total_bytes;                    ///<已写入的总字节数
+        uint64  flushed_bytes;                  ///<已交给ByteSink的字节数
+        uint64  sink_calls;                     ///<ByteSink::Write调用次数
+        uint64  direct_bytes;                   ///<大块数据绕过缓冲直接输出的字节数
+        size_t  allocated_blocks;               ///<已分配的数据块数量
+        size_t  peak_pending_blocks;            ///<同时等待输出的数据块峰值
+    };//struct ChunkedByteWriterStats
+
+    /**
+     * 流式分块字节写入器<br>
+     * 数据写入固定大小的对齐数据块，写满若干块后一次性交给 ByteSink 输出，数据块随即回收复用。
+     * 不论输出多大，内存占用都不超过 max_blocks*block_size，也不会有vector扩容时的整体复制。
+     *
+     * 数值编码与 ByteSpanWriter 完全一致（小端、LEB128变长整数、变长长度前缀字符串），
+     * 输出结果可以直接用 ByteSpanReader/MappedFile 读回。
+     *
+     * 回填：Reserve()先占位，之后用Patch()写入真实值（常用于长度字段）。
+     * - ByteSink可回写（文件、内存）时，占位所在的数据块可以照常输出，回填时通过ByteSink::Patch写入
+     * - 否则（管道、回调）占位所在及其后的数据块会被保留到回填为止，超过max_blocks时写入失败
+     *
+     * 任何一次写入失败后，写入器进入失败状态，之后所有写入都返回false。
+     */
+    class ChunkedByteWriter
+    {
+    public:
+
+        /**
+         * 回填占位
+         */
+        struct Reservation
+        {
+            uint64 offset=0;
+            uint32 size=0;
+
+            bool IsValid()const{return size>0;}
+        };//struct Reservation
+
+    private:
+
+        ByteSink *sink;
+        ChunkedByteWriterConfig config;
+
+        std::vector<uint8 *> pending;                                   ///<等待输出的数据块，除最后一块外都已写满
+        std::vector<uint8 *> free_blocks;
+        std::vector<uint64> reservations;                               ///<尚未回填的占位偏移
+        std::vector<ByteSinkSpan> spans;
+
+        uint8 *cur;                                                     ///<当前数据块的写入位置
+        uint8 *end;
+
+        uint64 pending_base;                                            ///<第一个等待输出的数据块在整个输出中的偏移
+        bool failed;
+        bool finished;
+
+        ChunkedByteWriterStats stats;
+
+    private:
+
+        size_t current_used()const{return pending.empty()?0:size_t(cur-pending.back());}
+
+        void Fail()
+        {
+            failed=true;
+            end=cur;                                                    //让快速路径失效
+        }
+
+        uint8 *AllocBlock()
+        {
+            if(!free_blocks.empty())
+            {
+                uint8 *block=free_blocks.back();
+                free_blocks.pop_back();
+                return block;
+            }
+
+            ++stats.allocated_blocks;
+            return static_cast<uint8 *>(::operator new(config.block_size,std::align_val_t(config.block_align)));
+        }
+
+        void FreeBlock(uint8 *block)
+        {
+            ::operator delete(block,std::align_val_t(config.block_align));
+        }
+
+        /**
+         * 不依赖回填的数据可以输出到哪个偏移
+         */
+        uint64 FlushLimit()const
+        {
+            if(reservations.empty()||sink->CanPatch())
+                return ~uint64(0);
+
+            return *std::min_element(reservations.begin(),reservations.end());
+        }
+
+        /**
+         * 输出等待中的数据块
+         * @param include_partial 是否包括未写满的最后一块
+         * @param extra 附加在数据块之后一起输出的数据（可为nullptr）
+         */
+        bool FlushPending(bool include_partial,uint64 limit,const ByteSinkSpan *extra=nullptr)
+        {
+            const size_t last_used=current_used();
+            size_t count=0;
+            uint64 bytes=0;
+
+            spans.clear();
+
+            for(size_t i=0;i<pending.size();i++)
+            {
+                const bool is_last=(i+1==pending.size());
+                const size_t size=is_last?last_used:config.block_size;
+
+                if(is_last&&size<config.block_size&&!include_partial)
+                    break;
+
+                if(pending_base+bytes+size>limit)
+                    break;
+
+                spans.push_back({pending[i],size});
+                bytes+=size;
+                ++count;
+            }
+
+            if(extra)
+                spans.push_back(*extra);
+
+            if(spans.empty())
+                return true;
+
+            if(!sink->Write(spans.data(),spans.size()))
+            {
+                Fail();
+                return false;
+            }
+
+            ++stats.sink_calls;
+            stats.flushed_bytes+=bytes;
+
+            for(size_t i=0;i<count;i++)
+                free_blocks.push_back(pending[i]);
+
+            pending.erase(pending.begin(),pending.begin()+count);
+            pending_base+=bytes;
+
+            if(pending.empty())
+                cur=end=nullptr;
+
+            return true;
+        }
+
+        bool NewBlock()
+        {
+            if(failed||finished)
+                return false;
+
+            if(pending.size()>=config.flush_blocks)
+                if(!FlushPending(false,FlushLimit()))
+                    return false;
+
+            if(pending.size()>=config.max_blocks)                        //被未回填的占位卡住，超出内存上限
+            {
+                Fail();
+                return false;
+            }
+
+            uint8 *block=AllocBlock();
+
+            pending.push_back(block);
+            cur=block;
+            end=block+config.block_size;
+
+            if(pending.size()>stats.peak_pending_blocks)
+                stats.peak_pending_blocks=pending.size();
+
+            return true;
+        }
+
+        bool WriteSlow(const uint8 *src,size_t length)
+        {
+            if(failed)
+                return false;
+
+            while(length>0)
+            {
+                if(cur==end&&!NewBlock())
+                    return false;
+
+                const size_t n=std::min(length,size_t(end-cur));
+
+                std::memcpy(cur,src,n);
+                cur+=n;
+                src+=n;
+                length-=n;
+            }
+
+            return true;
+        }
+
+        /**
+         * 写入处于内存中的数据块（用于回填）
+         */
+        void CopyToPending(uint64 offset,const uint8 *src,size_t length)
+        {
+            while(length>0)
+            {
+                const uint64 rel=offset-pending_base;
+                const size_t index=size_t(rel/config.block_size);
+                const size_t in_block=size_t(rel%config.block_size);
+                const size_t n=std::min(length,config.block_size-in_block);
+
+                std::memcpy(pending[index]+in_block,src,n);
+                offset+=n;
+                src+=n;
+                length-=n;
+            }
+        }
+
+    public:
+
+        /**
+         * @param output 输出目标，生命周期需长于写入器
+         * @param cfg 配置
+         */
+        explicit ChunkedByteWriter(ByteSink *output,const ChunkedByteWriterConfig &cfg=ChunkedByteWriterConfig())
+        {
+            sink=output;
+            config=cfg;
+
+            if(config.block_align<alignof(std::max_align_t))
+                config.block_align=alignof(std::max_align_t);
+
+            if(config.block_size<VARINT64_MAX_BYTES)
+                config.block_size=VARINT64_MAX_BYTES;
+
+            config.block_size=(config.block_size+config.block_align-1)/config.block_align*config.block_align;
+
+            if(config.flush_blocks<1)config.flush_blocks=1;
+            if(config.max_blocks<config.flush_blocks+1)config.max_blocks=config.flush_blocks+1;
+
+            cur=end=nullptr;
+            pending_base=0;
+            failed=(sink==nullptr);
+            finished=false;
+
+            stats={};
+        }
+
+        /**
+         * 析构时若尚未调用Finish()，会自动输出剩余数据
+         */
+        ~ChunkedByteWriter()
+        {
+            if(!finished)
+                Finish();
+
+            for(uint8 *block:pending)
+                FreeBlock(block);
+
+            for(uint8 *block:free_blocks)
+                FreeBlock(block);
+        }
+
+        NO_COPY_NO_MOVE(ChunkedByteWriter)
+
+        bool                            IsFailed    ()const{return failed;}
+        const ChunkedByteWriterConfig & GetConfig   ()const{return config;}
+
+        /**
+         * 当前已写入的总字节数（即下一个写入的偏移）
+         */
+        uint64 tell()const
+        {
+            if(pending.empty())
+                return pending_base;
+
+            return pending_base+uint64(pending.size()-1)*config.block_size+current_used();
+        }
+
+        ChunkedByteWriterStats GetStats()const
+        {
+            ChunkedByteWriterStats result=stats;
+
+            result.total_bytes=tell();
+            return result;
+        }
+
+        /**
+         * 输出所有已写满的数据块（不包括当前未写满的块）
+         */
+        bool Flush()
+        {
+            if(failed)
+                return false;
+
+            return FlushPending(false,FlushLimit());
+        }
+
+        /**
+         * 输出全部剩余数据，并结束ByteSink<br>
+         * 仍有未回填的占位时，数据照常输出，但返回false
+         */
+        bool Finish()
+        {
+            if(finished)
+                return !failed;
+
+            finished=true;
+
+            if(!failed)
+                FlushPending(true,~uint64(0));
+
+            if(!failed&&!sink->Finish())
+                Fail();
+
+            return !failed&&reservations.empty();
+        }
+
+        //---------------------------------------------------------------------------------------------
+        // 原始数据
+        //---------------------------------------------------------------------------------------------
+
+        bool bytes(const void *src,size_t length)
+        {
+            if(length<=size_t(end-cur))
+            {
+                if(length)
+                {
+                    std::memcpy(cur,src,length);
+                    cur+=length;
+                }
+
+                return true;
+            }
+
+            if(failed||finished)
+                return false;
+
+            //大块数据：没有占位卡住时，与等待中的数据块一起直接输出，省去一次复制
+            if(length>=config.block_size&&FlushLimit()==~uint64(0))
+            {
+                const ByteSinkSpan extra{static_cast<const uint8 *>(src),length};
+
+                if(!FlushPending(true,~uint64(0),&extra))
+                    return false;
+
+                stats.flushed_bytes+=length;
+                stats.direct_bytes+=length;
+                pending_base+=length;
+                return true;
+            }
+
+            return WriteSlow(static_cast<const uint8 *>(src),length);
+        }
+
+        //---------------------------------------------------------------------------------------------
+        // 定长数值（小端）
+        //---------------------------------------------------------------------------------------------
+
+        template<ByteSpanValue T>
+        bool value(T v)
+        {
+            v=to_little_endian(v);
+
+            if(size_t(end-cur)>=sizeof(T))
+            {
+                std::memcpy(cur,&v,sizeof(T));
+                cur+=sizeof(T);
+                return true;
+            }
+
+            return WriteSlow(reinterpret_cast<const uint8 *>(&v),sizeof(T));
+        }
+
+        bool u8 (uint8  v){return value(v);}
+        bool u16(uint16 v){return value(v);}
+        bool u32(uint32 v){return value(v);}
+        bool u64(uint64 v){return value(v);}
+        bool i8 (int8   v){return value(v);}
+        bool i16(int16  v){return value(v);}
+        bool i32(int32  v){return value(v);}
+        bool i64(int64  v){return value(v);}
+        bool f32(float  v){return value(v);}
+        bool f64(double v){return value(v);}
+
+        //---------------------------------------------------------------------------------------------
+        // 变长整数
+        //---------------------------------------------------------------------------------------------
+
+        bool varu64(uint64 v)
+        {
+            if(size_t(end-cur)>=VARINT64_MAX_BYTES)
+            {
+                cur+=varint_encode_unchecked(cur,v);
+                return true;
+            }
+
+            uint8 tmp[VARINT64_MAX_BYTES];
+
+            return WriteSlow(tmp,varint_encode_unchecked(tmp,v));
+        }
+
+        bool varu32(uint32 v){return varu64(v);}
+        bool vari32(int32 v){return varu64(zigzag_encode(v));}
+        bool vari64(int64 v){return varu64(zigzag_encode(v));}
+
+        //---------------------------------------------------------------------------------------------
+        // 数组与字符串
+        //---------------------------------------------------------------------------------------------
+
+        template<ByteSpanValue T>
+        bool array(const T *src,size_t count)
+        {
+        #if HGL_ENDIAN == HGL_BIG_ENDIAN
+            for(size_t i=0;i<count;i++)
+                if(!value(src[i]))
+                    return false;
+
+            return true;
+        #else
+            return bytes(src,count*sizeof(T));
+        #endif//HGL_ENDIAN
+        }
+
+        bool string(std::string_view str)
+        {
+            return varu64(str.size())&&bytes(str.data(),str.size());
+        }
+
+        //---------------------------------------------------------------------------------------------
+        // 占位与回填
+        //---------------------------------------------------------------------------------------------
+
+        /**
+         * 占用size字节（先写0），之后用Patch写入真实值
+         * @return 占位信息，失败时IsValid()为false
+         */
+        Reservation Reserve(uint32 size)
+        {
+            Reservation r;
+
+            if(size==0||size>sizeof(uint64))
+                return r;
+
+            const uint64 offset=tell();
+            const uint64 zero=0;
+
+            if(!bytes(&zero,size))
+                return r;
+
+            reservations.push_back(offset);
+
+            r.offset=offset;
+            r.size=size;
+            return r;
+        }
+
+        template<ByteSpanValue T>
+        Reservation Reserve(){return Reserve(sizeof(T));}
+
+        /**
+         * 向占位写入数据
+         */
+        bool Patch(const Reservation &r,const void *data,size_t size)
+        {
+            if(failed||!r.IsValid()||size!=r.size||r.offset+size>tell())
+                return false;
+
+            auto it=std::find(reservations.begin(),reservations.end(),r.offset);
+
+            if(it!=reservations.end())
+                reservations.erase(it);
+
+            const uint8 *src=static_cast<const uint8 *>(data);
+            uint64 offset=r.offset;
+
+            if(offset<pending_base)                                     //已输出的部分交给ByteSink回写
+            {
+                const size_t n=size_t(std::min<uint64>(size,pending_base-offset));
+
+                if(!sink->Patch(offset,src,n))
+                {
+                    Fail();
+                    return false;
+                }
+
+                offset+=n;
+                src+=n;
+                size-=n;
+            }
+
+            CopyToPending(offset,src,size);
+            return true;
+        }
+
+        template<ByteSpanValue T>
+        bool Patch(const Reservation &r,T v)
+        {
+            v=to_little_endian(v);
+
+            return Patch(r,&v,sizeof(T));
+        }
+
+        /**
+         * 开始一段带uint32长度前缀的数据
+         */
+        Reservation BeginSection(){return Reserve<uint32>();}
+
+        /**
+         * 结束一段数据，将其长度（不含长度字段本身）回填到长度前缀
+         */
+        bool EndSection(const Reservation &r)
+        {
+            const uint64 length=tell()-r.offset-sizeof(uint32);
+
+            if(length>0xFFFFFFFFull)
+                return false;
+
+            return Patch(r,uint32(length));
+        }
+    };//class ChunkedByteWriter
+}//namespace hgl
@@ -0,0 +1,312 @@
+﻿#pragma once
+
+#include<hgl/type/PackedIntArray.h>
+#include<type_traits>
+
+namespace hgl
+{
+    /**
+     * 压缩的有序整数数组（只读）<br>
+     * 每BLOCK_SIZE个元素一块，块首值单独存放作为跳跃索引，块内其余元素以差分+FOR编码：
+     * 相邻差值减去块内最小差值后按块内统一位宽紧密排列（同 PackedIntArray 的布局）。
+     *
+     * 查找时先在块首值上二分确定块（每块8字节，索引很小，常驻缓存），再只解码这一块。
+     * 位宽不超过25位的块在支持AVX2的CPU上用AVX2解码。
+     *
+     * 与 FindDataPositionInSortedArray 的语义相同：找到返回索引，没有返回-1；有重复值时返回其中之一。
+     */
+    template<typename T> class CompressedSortedArray
+    {
+        static_assert(std::is_integral_v<T>&&sizeof(T)<=8,"CompressedSortedArray only support integral types");
+
+        using UT=std::make_unsigned_t<T>;
+
+    public:
+
+        static constexpr uint32 BLOCK_SIZE=128;
+        static constexpr uint32 DELTA_COUNT=BLOCK_SIZE-1;           ///<每块中编码的差值数量
+
+    private:
+
+        struct BlockInfo
+        {
+            uint64 min_delta;                                       ///<块内最小差值
+            uint64 offset;                                          ///<在data中的字节偏移(data可超过4GB)
+            uint32 bits;                                            ///<差值位宽，0表示等差，64表示原样存储
+        };
+
+        std::vector<T> block_first;                                 ///<各块第一个值（跳跃索引）
+        std::vector<BlockInfo> block_info;
+        std::vector<uint8> data;                                    ///<末尾额外有PAD_BYTES字节
+
+        int64 count=0;
+        T last_value{};
+
+    private:
+
+        static uint64 Delta(const T a,const T b){return uint64(UT(b)-UT(a));}
+
+        /**
+         * 取块中第k个差值（已去掉min_delta）
+         */
+        uint64 GetDelta(const BlockInfo &bi,const uint32 k)const
+        {
+            const uint64 bit_pos=uint64(k)*bi.bits;
+
+            return (packed_int_detail::Load64(data.data()+bi.offset+bit_pos/8)>>(bit_pos&7))&low_bits_mask(bi.bits);
+        }
+
+        /**
+         * 解码一块中的全部差值（已去掉min_delta），仅用于位宽1~25
+         * @return 解码的数量
+         */
+        uint32 UnpackDelta(uint32 *out,const BlockInfo &bi,const uint32 n)const
+        {
+            uint32 k=0;
+
+#ifdef HGL_SIMD_X86
+            if(GetCpuFeature().avx2)
+            {
+                const uint32 groups=n/8;
+
+                packed_int_detail::UnpackAVX2(out,data.data()+bi.offset,groups,bi.bits,packed_int_detail::GetUnpackControl(bi.bits));
+
+                k=groups*8;
+            }
+#endif//HGL_SIMD_X86
+
+            for(;k<n;k++)
+                out[k]=uint32(GetDelta(bi,k));
+
+            return n;
+        }
+
+        uint32 BlockDeltaCount(const size_t block)const
+        {
+            return uint32(std::min<int64>(count-int64(block)*BLOCK_SIZE,BLOCK_SIZE))-1;
+        }
+
+    public:
+
+        CompressedSortedArray()=default;
+        CompressedSortedArray(const T *values,const int64 n){Build(values,n);}
+
+        /**
+         * 从有序（非递减）数组建立
+         * @return 数据为空或无序时返回false
+         */
+        bool Build(const T *values,const int64 n)
+        {
+            block_first.clear();
+            block_info.clear();
+            data.clear();
+            count=0;
+
+            if(!values||n<=0)
+                return false;
+
+            for(int64 i=1;i<n;i++)
+                if(values[i]<values[i-1])
+                    return false;
+
+            const size_t block_count=size_t((n+BLOCK_SIZE-1)/BLOCK_SIZE);
+
+            block_first.resize(block_count);
+            block_info.resize(block_count);
+
+            for(size_t b=0;b<block_count;b++)
+            {
+                const T *p=values+b*BLOCK_SIZE;
+                const uint32 delta_count=uint32(std::min<int64>(n-int64(b)*BLOCK_SIZE,BLOCK_SIZE))-1;
+
+                uint64 min_delta=~uint64(0),max_delta=0;
+
+                for(uint32 k=0;k<delta_count;k++)
+                {
+                    const uint64 d=Delta(p[k],p[k+1]);
+
+                    min_delta=std::min(min_delta,d);
+                    max_delta=std::max(max_delta,d);
+                }
+
+                if(!delta_count)
+                    min_delta=0;
+
+                uint32 bits=uint32(std::bit_width(max_delta-min_delta));
+
+                if(bits>BitStreamReader::MAX_READ_BITS)                 //单次64位读取放不下，改为原样存储
+                    bits=64;
+
+                BlockInfo &bi=block_info[b];
+
+                bi.min_delta=min_delta;
+                bi.offset=uint64(data.size());
+                bi.bits=bits;
+
+                block_first[b]=p[0];
+
+                if(!bits)continue;
+
+                std::vector<uint8> block;
+                {
+                    BitStreamWriter bw(block);
+
+                    for(uint32 k=0;k<delta_count;k++)
+                        bw.write_bits(Delta(p[k],p[k+1])-min_delta,bits);
+
+                    bw.flush();
+                }
+
+                data.insert(data.end(),block.begin(),block.end());
+            }
+
+            data.resize(data.size()+packed_int_detail::PAD_BYTES,0);
+            data.shrink_to_fit();
+
+            count=n;
+            last_value=values[n-1];
+            return true;
+        }
+
+        int64 GetCount()const{return count;}
+        size_t GetBlockCount()const{return block_first.size();}
+
+        /**
+         * 占用的总字节数（含跳跃索引与块信息）
+         */
+        size_t GetBytes()const
+        {
+            return block_first.size()*sizeof(T)+block_info.size()*sizeof(BlockInfo)+data.size();
+        }
+
+        /**
+         * 取得第index个值，需要解码块内此前的所有差值
+         */
+        T Get(const int64 index)const
+        {
+            const size_t b=size_t(index/BLOCK_SIZE);
+            const uint32 k=uint32(index%BLOCK_SIZE);
+            const BlockInfo &bi=block_info[b];
+
+            UT v=UT(block_first[b])+UT(bi.min_delta*k);
+
+            if(bi.bits)
+                for(uint32 i=0;i<k;i++)
+                    v+=UT(GetDelta(bi,i));
+
+            return T(v);
+        }
+
+        /**
+         * 查找数据的位置
+         * @return 找到返回索引位置，未找到返回-1
+         */
+        int64 Find(const T value)const
+        {
+            if(count<=0||value<block_first[0]||value>last_value)
+                return -1;
+
+            //无分支二分：最后一个块首值<=value的块
+            const T *base=block_first.data();
+            size_t n=block_first.size();
+
+            while(n>1)
+            {
+                const size_t half=n/2;
+
+                base=(base[half]<=value)?base+half:base;
+                n-=half;
+            }
+
+            const size_t b=size_t(base-block_first.data());
+            const int64 block_start=int64(b)*BLOCK_SIZE;
+
+            if(*base==value)
+                return block_start;
+
+            const BlockInfo &bi=block_info[b];
+            const uint32 delta_count=BlockDeltaCount(b);
+            const UT target=UT(value);
+
+            UT v=UT(*base);
+
+            if(bi.bits==0)                                          //等差
+            {
+                if(!bi.min_delta)return -1;
+
+                const uint64 k=uint64(target-v)/bi.min_delta;
+
+                return (k<=delta_count&&UT(v+UT(k*bi.min_delta))==target)?block_start+int64(k):-1;
+            }
+
+            //块内的值都>=块首值，所以按无符号差比较
+            const UT min_delta=UT(bi.min_delta);
+            const UT offset=target-v;
+            UT acc=0;
+
+            if(bi.bits<=packed_int_detail::UNPACK_AVX2_MAX_BITS)
+            {
+                uint32 delta[BLOCK_SIZE];
+
+                UnpackDelta(delta,bi,delta_count);
+
+                for(uint32 k=0;k<delta_count;k++)
+                {
+                    acc+=min_delta+delta[k];
+
+                    if(acc>=offset)
+                        return acc==offset?block_start+k+1:-1;
+                }
+            }
+            else
+            {
+                for(uint32 k=0;k<delta_count;k++)
+                {
+                    acc+=min_delta+UT(GetDelta(bi,k));
+
+                    if(acc>=offset)
+                        return acc==offset?block_start+k+1:-1;
+                }
+            }
+
+            return -1;
+        }
+
+        bool Contains(const T value)const{return Find(value)>=0;}
+
+        /**
+         * 解码全部数据到out(至少GetCount()个元素)
+         */
+        void Decode(T *out)const
+        {
+            uint32 delta[BLOCK_SIZE];
+
+            for(size_t b=0;b<block_first.size();b++)
+            {
+                const BlockInfo &bi=block_info[b];
+                const uint32 delta_count=BlockDeltaCount(b);
+
+                UT v=UT(block_first[b]);
+                *out++=T(v);
+
+                if(bi.bits==0)
+                {
+                    for(uint32 k=0;k<delta_count;k++)
+                        *out++=T(v+=UT(bi.min_delta));
+                }
+                else if(bi.bits<=packed_int_detail::UNPACK_AVX2_MAX_BITS)
+                {
+                    UnpackDelta(delta,bi,delta_count);
+
+                    for(uint32 k=0;k<delta_count;k++)
+                        *out++=T(v+=UT(bi.min_delta)+delta[k]);
+                }
+                else
+                {
+                    for(uint32 k=0;k<delta_count;k++)
+                        *out++=T(v+=UT(bi.min_delta)+UT(GetDelta(bi,k)));
+                }
+            }
+        }
+    };//class CompressedSortedArray
+}//namespace hgl
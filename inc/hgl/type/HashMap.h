@@ -0,0 +1,127 @@
+﻿#pragma once
+
+#include<hgl/util/hash/QuickHash.h>
+#include<ankerl/unordered_dense.h>
+#include<memory_resource>
+#include<string>
+#include<string_view>
+#include<functional>
+
+namespace hgl
+{
+    namespace hash_detail
+    {
+        template<bool Avalanching> struct AvalanchingTag{};
+        template<> struct AvalanchingTag<true>{using is_avalanching=void;};
+    }//namespace hash_detail
+
+    /**
+     * 以 ComputeOptimalHash 计算的哈希函数对象，供 HashMap/HashSet 使用<br>
+     * CN:整数/枚举/指针按Policy混合，结果满足雪崩要求（is_avalanching），ankerl不会再次混合；
+     *    Policy为Identity时不声明is_avalanching，由ankerl自己混合。
+     * EN:Integers, enums and pointers are mixed according to Policy, so the table can trust the hash
+     *    as avalanching and skip its own mixing step. With Identity the table mixes instead.
+     */
+    template<typename T,HashMixPolicy Policy=HashMixPolicy::WyMix>
+    struct OptimalHash:hash_detail::AvalanchingTag<Policy!=HashMixPolicy::Identity||!(std::is_integral_v<T>||std::is_enum_v<T>||std::is_pointer_v<T>)>
+    {
+        uint64 operator()(const T &value)const noexcept
+        {
+            if constexpr(!(std::is_integral_v<T>||std::is_enum_v<T>||std::is_pointer_v<T>))
+            {
+                // CN:按内存逐字节计算，结构中的填充字节必须已清零
+                // EN:Hashes the object representation; padding bytes must be zeroed
+                static_assert(std::is_trivially_copyable_v<T>,"OptimalHash requires a trivially copyable type, provide a custom hasher instead");
+            }
+
+            return ComputeOptimalHash<Policy>(value);
+        }
+    };//struct OptimalHash
+
+    /**
+     * 字符串哈希，支持异构查找：std::basic_string、std::basic_string_view、const CharT * 计算结果相同
+     */
+    template<typename CharT>
+    struct OptimalStringHash
+    {
+        using is_transparent=void;
+        using is_avalanching=void;
+
+        uint64 operator()(std::basic_string_view<CharT> str)const noexcept
+        {
+            return ComputeOptimalHash(str.data(),str.size()*sizeof(CharT));
+        }
+
+        uint64 operator()(const std::basic_string<CharT> &str)const noexcept{return operator()(std::basic_string_view<CharT>(str));}
+        uint64 operator()(const CharT *str)const noexcept{return operator()(std::basic_string_view<CharT>(str));}
+    };//struct OptimalStringHash
+
+    template<typename CharT>
+    struct StringEqual
+    {
+        using is_transparent=void;
+
+        bool operator()(std::basic_string_view<CharT> a,std::basic_string_view<CharT> b)const noexcept{return a==b;}
+    };//struct StringEqual
+
+    /**
+     * 根据键类型选择默认的哈希与比较函数
+     */
+    template<typename K>
+    struct HashTraits
+    {
+        using Hash  =OptimalHash<K>;
+        using Equal =std::equal_to<K>;
+    };
+
+    template<typename CharT,typename Traits,typename Alloc>
+    struct HashTraits<std::basic_string<CharT,Traits,Alloc>>
+    {
+        using Hash  =OptimalStringHash<CharT>;
+        using Equal =StringEqual<CharT>;
+    };
+
+    template<typename CharT>
+    struct HashTraits<std::basic_string_view<CharT>>
+    {
+        using Hash  =OptimalStringHash<CharT>;
+        using Equal =StringEqual<CharT>;
+    };
+
+    /**
+     * 稠密哈希表（ankerl::unordered_dense，数据连续存储，迭代即遍历数组）<br>
+     * 字符串键支持以 std::basic_string_view(ptr,length) 或 const CharT * 直接查找，不需要构造临时字符串：
+     * <pre>
+     * HashMap<std::string,int> map;
+     * map.find(std::string_view(ptr,length));
+     * </pre>
+     * 注意：插入/删除会使迭代器与引用失效（删除时最后一个元素会移动到被删除的位置）。
+     */
+    template<typename K,typename V,
+             typename Hash =typename HashTraits<K>::Hash,
+             typename Equal=typename HashTraits<K>::Equal>
+    using HashMap=ankerl::unordered_dense::map<K,V,Hash,Equal>;
+
+    template<typename K,
+             typename Hash =typename HashTraits<K>::Hash,
+             typename Equal=typename HashTraits<K>::Equal>
+    using HashSet=ankerl::unordered_dense::set<K,Hash,Equal>;
+
+    namespace pmr
+    {
+        /**
+         * 从 std::pmr::memory_resource 分配内存的哈希表<br>
+         * 配合 std::pmr::monotonic_buffer_resource 使用时，整张表的内存来自同一块arena，
+         * 销毁时一次释放；扩容时旧的桶数组不会归还给arena，建议预先reserve。
+         */
+        template<typename K,typename V,
+                 typename Hash =typename HashTraits<K>::Hash,
+                 typename Equal=typename HashTraits<K>::Equal>
+        using HashMap=ankerl::unordered_dense::map<K,V,Hash,Equal,std::pmr::polymorphic_allocator<std::pair<K,V>>>;
+
+        template<typename K,
+                 typename Hash =typename HashTraits<K>::Hash,
+                 typename Equal=typename HashTraits<K>::Equal>
+        using HashSet=ankerl::unordered_dense::set<K,Hash,Equal,std::pmr::polymorphic_allocator<K>>;
+    }//namespace pmr
+}//namespace hgl
@@ -0,0 +1,141 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<hgl/type/ByteSpanBuffer.h>
+
+namespace hgl
+{
+    /**
+     * 文件数据的访问方式
+     */
+    enum class MappedFileMode
+    {
+        None=0,         ///<未打开
+        Mmap,           ///<内存映射
+        Buffered,       ///<映射失败后，以pread按需把请求的区间读入可复用的窗口缓冲区
+
+        BEGIN_RANGE =None,
+        END_RANGE   =Buffered,
+        RANGE_SIZE  =END_RANGE-BEGIN_RANGE+1
+    };//enum class MappedFileMode
+
+    /**
+     * 访问模式提示（对应madvise/posix_fadvise）
+     */
+    enum class MappedFileAdvice
+    {
+        Normal=0,
+        Sequential,     ///<顺序读取，内核会加大预读
+        Random,         ///<随机读取，关闭预读
+        WillNeed,       ///<即将访问，异步预取
+        DontNeed,       ///<不再需要，可以回收页缓存
+
+        BEGIN_RANGE =Normal,
+        END_RANGE   =DontNeed,
+        RANGE_SIZE  =END_RANGE-BEGIN_RANGE+1
+    };//enum class MappedFileAdvice
+
+    /**
+     * 映射配置
+     */
+    struct MappedFileConfig
+    {
+        bool    sequential      =true;          ///<打开后设置顺序访问提示(MADV_SEQUENTIAL)
+        bool    will_need       =false;         ///<打开后请求异步预取整个文件(MADV_WILLNEED)
+        bool    populate        =false;         ///<映射时同步预读所有页(MAP_POPULATE)，适合马上要完整遍历的文件
+        bool    huge_pages      =false;         ///<将映射地址按2MB对齐并请求透明大页(MADV_HUGEPAGE)
+        bool    allow_fallback  =true;          ///<映射失败时退回pread读取
+        bool    force_buffered  =false;         ///<不尝试映射，直接使用pread读取（用于测试或不支持mmap的文件系统）
+
+        size_t  read_chunk_size =4*1024*1024;   ///<pread每次读取的字节数
+    };//struct MappedFileConfig
+
+    /**
+     * 只读内存映射文件<br>
+     * 打开后通过 GetReader() 得到与内存缓冲区完全相同的 ByteSpanReader 接口，
+     * 不需要先把整个文件复制到 std::vector 中。
+     *
+     * 映射失败（例如特殊文件系统）且 allow_fallback 为 true 时，退回到Buffered模式：
+     * 文件不会整个读入内存，GetData() 返回nullptr，GetReader(offset,length) 每次只把请求的区间
+     * pread 到一个可复用的窗口缓冲区，因此多GB的文件也可以按窗口流式读取。
+     * 窗口读取器在下一次读取其它区间、Close或移动后失效，且不能在多个线程中同时取窗口。
+     */
+    class MappedFile
+    {
+        int             fd;
+        const uint8 *   data;
+        size_t          size;
+        MappedFileMode  mode;
+
+        void *          map_base;               ///<munmap时使用的地址
+        size_t          map_length;
+
+        mutable uint8 * buffer;                 ///<Buffered模式下的窗口缓冲区
+        mutable size_t  buffer_capacity;
+        mutable size_t  window_offset;          ///<窗口缓冲区中数据对应的文件位置
+        mutable size_t  window_length;
+
+        size_t          read_chunk_size;
+        bool            huge_buffer;            ///<窗口缓冲区按2MB对齐并请求透明大页
+
+    private:
+
+        bool OpenMapped(const MappedFileConfig &);
+        bool OpenBuffered(const MappedFileConfig &);
+
+        ByteSpanReader ReadWindow(size_t offset,size_t length)const;
+
+    public:
+
+        MappedFile();
+        ~MappedFile();
+
+        NO_COPY(MappedFile)
+
+        MappedFile(MappedFile &&);
+        MappedFile &operator=(MappedFile &&);
+
+        /**
+         * 打开文件
+         * @param filename 文件名
+         * @param config 映射配置
+         * @return 是否成功
+         */
+        bool Open(const char *filename,const MappedFileConfig &config=MappedFileConfig());
+
+        void Close();
+
+        bool                    IsOpen  ()const{return mode!=MappedFileMode::None;}
+        MappedFileMode          GetMode ()const{return mode;}
+        const uint8 *           GetData ()const{return data;}          ///<整个文件的连续内存，仅Mmap模式有效，Buffered模式下为nullptr
+        size_t                  GetSize ()const{return size;}
+
+        /**
+         * 对指定范围设置访问提示（Mmap模式用madvise，Buffered模式用posix_fadvise）
+         */
+        bool Advise(MappedFileAdvice advice,size_t offset=0,size_t length=0);
+
+        /**
+         * 取得整个文件的读取器（Buffered模式下会把整个文件读入窗口缓冲区，大文件请分段读取）
+         */
+        ByteSpanReader GetReader()const{return GetReader(0,size);}
+
+        /**
+         * 取得文件中一段数据的读取器（越界部分会被截断）<br>
+         * Buffered模式下只读取这一段，区间已在当前窗口内时不重复读取；读取失败时返回的读取器较短或为空
+         */
+        ByteSpanReader GetReader(size_t offset,size_t length)const
+        {
+            if(offset>=size)
+                return ByteSpanReader(nullptr,0);
+
+            if(length>size-offset)
+                length=size-offset;
+
+            if(mode==MappedFileMode::Buffered)
+                return ReadWindow(offset,length);
+
+            return ByteSpanReader(data+offset,length);
+        }
+    };//class MappedFile
+}//namespace hgl
@@ -1,13 +1,245 @@
 ﻿#pragma once
 
-#include<hgl/platform/Platform.h>
+#include<hgl/platform/CpuFeature.h>
 #include<cstring>
 #include<type_traits>
 #include<algorithm>
 #include<compare>
+#include<atomic>
+
+/**
+ * 超过此字节数的复制/填充/清零使用非临时存储(non-temporal store)，绕过缓存直接写入内存，
+ * 避免大块数据把缓存中的其它数据挤出。可在运行时用 mem_set_stream_threshold 修改。
+ */
+#ifndef HGL_MEM_STREAM_THRESHOLD
+#define HGL_MEM_STREAM_THRESHOLD    (8*1024*1024)
+#endif//HGL_MEM_STREAM_THRESHOLD
 
 namespace hgl
 {
+    //==================================================================================================
+    // 内存操作 - 底层实现 / Memory Operations - Kernels
+    //==================================================================================================
+
+    namespace mem_detail
+    {
+        inline std::atomic<size_t> stream_threshold{HGL_MEM_STREAM_THRESHOLD};     ///<可被任意线程修改，只用relaxed读写
+
+        inline size_t get_stream_threshold()
+        {
+            return stream_threshold.load(std::memory_order_relaxed);
+        }
+
+        constexpr size_t PATTERN_BYTES = 32;                        ///<填充用的模式块长度
+        constexpr size_t PATTERN_DOUBLING_LIMIT = 16 * 1024;        ///<倍增复制的最大块长度，保持源数据在L1中
+
+        /**
+         * 到下一个HGL_MEM_ALIGN对齐地址的字节数
+         */
+        inline size_t bytes_to_align(const void *p)
+        {
+            return size_t(-reinterpret_cast<uintptr_t>(p)) & (HGL_MEM_ALIGN - 1);
+        }
+
+        /**
+         * 用32字节的模式块填充（模式块的周期必须能整除32），普通存储
+         */
+        inline void fill_pattern(uint8 *dst, size_t bytes, const uint8 *pattern)
+        {
+            while(bytes >= PATTERN_BYTES)
+            {
+                std::memcpy(dst, pattern, PATTERN_BYTES);           //编译为一到两次向量存储
+                dst += PATTERN_BYTES;
+                bytes -= PATTERN_BYTES;
+            }
+
+            std::memcpy(dst, pattern, bytes);
+        }
+
+#ifdef HGL_SIMD_X86
+        constexpr size_t STREAM_PREFETCH = 512;                     ///<预取距离
+
+        /**
+         * 非临时存储复制，dst已对齐到HGL_MEM_ALIGN，bytes为64的倍数
+         */
+        HGL_TARGET_ISA("sse2")
+        inline void stream_copy_sse2(uint8 *dst, const uint8 *src, const size_t bytes)
+        {
+            for(size_t i = 0; i < bytes; i += 64)
+            {
+                _mm_prefetch(reinterpret_cast<const char *>(src + i + STREAM_PREFETCH), _MM_HINT_T0);
+
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 16));
+                const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 32));
+                const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 48));
+
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i), a);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 16), b);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 32), c);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 48), d);
+            }
+
+            _mm_sfence();
+        }
+
+        /**
+         * 非临时存储复制，dst已对齐到32字节，bytes为64的倍数
+         */
+        HGL_TARGET_ISA("avx2")
+        inline void stream_copy_avx2(uint8 *dst, const uint8 *src, const size_t bytes)
+        {
+            for(size_t i = 0; i < bytes; i += 64)
+            {
+                _mm_prefetch(reinterpret_cast<const char *>(src + i + STREAM_PREFETCH), _MM_HINT_T0);
+
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 32));
+
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + i), a);
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + i + 32), b);
+            }
+
+            _mm_sfence();
+        }
+
+        /**
+         * 非临时存储填充，dst已对齐到HGL_MEM_ALIGN且模式相位为0，bytes为64的倍数
+         */
+        HGL_TARGET_ISA("sse2")
+        inline void stream_fill_sse2(uint8 *dst, const size_t bytes, const uint8 *pattern)
+        {
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pattern));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pattern + 16));
+
+            for(size_t i = 0; i < bytes; i += 64)
+            {
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i), lo);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 16), hi);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 32), lo);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + i + 48), hi);
+            }
+
+            _mm_sfence();
+        }
+#endif//HGL_SIMD_X86
+
+        /**
+         * 非临时存储复制（不允许重叠），非x86平台退化为memcpy
+         */
+        inline void stream_copy(void *dst, const void *src, size_t bytes)
+        {
+            uint8 *d = static_cast<uint8 *>(dst);
+            const uint8 *s = static_cast<const uint8 *>(src);
+
+#ifdef HGL_SIMD_X86
+            const bool avx2 = GetCpuFeature().avx2;
+            const size_t align = avx2 ? 32 : HGL_MEM_ALIGN;
+            const size_t head = size_t(-reinterpret_cast<uintptr_t>(d)) & (align - 1);
+
+            if(bytes >= head + 256)
+            {
+                std::memcpy(d, s, head);
+                d += head;
+                s += head;
+                bytes -= head;
+
+                const size_t body = bytes & ~size_t(63);
+
+                if(avx2)
+                    stream_copy_avx2(d, s, body);
+                else
+                    stream_copy_sse2(d, s, body);
+
+                d += body;
+                s += body;
+                bytes -= body;
+            }
+#endif//HGL_SIMD_X86
+
+            std::memcpy(d, s, bytes);
+        }
+
+        /**
+         * 非临时存储填充，pattern为32字节模式块，period为模式周期（能整除32）
+         */
+        inline void stream_fill(void *dst, size_t bytes, const uint8 *pattern, const size_t period)
+        {
+            uint8 *d = static_cast<uint8 *>(dst);
+
+#ifdef HGL_SIMD_X86
+            const size_t head = bytes_to_align(d);
+
+            if(head % period == 0 && bytes >= head + 256)           //对齐后模式相位不变才能直接使用对齐存储
+            {
+                std::memcpy(d, pattern, head);
+                d += head;
+                bytes -= head;
+
+                const size_t body = bytes & ~size_t(63);
+
+                stream_fill_sse2(d, body, pattern);
+
+                d += body;
+                bytes -= body;
+            }
+#else
+            (void)period;
+#endif//HGL_SIMD_X86
+
+            fill_pattern(d, bytes, pattern);
+        }
+
+        /**
+         * 将value重复成32字节模式块，sizeof(T)必须能整除32
+         */
+        template<typename T>
+        inline void make_pattern(uint8 *pattern, const T &value)
+        {
+            for(size_t i = 0; i < PATTERN_BYTES; i += sizeof(T))
+                std::memcpy(pattern + i, &value, sizeof(T));
+        }
+
+        template<typename T>
+        constexpr bool is_pattern_type = std::is_trivially_copyable_v<T> && PATTERN_BYTES % sizeof(T) == 0;
+    }//namespace mem_detail
+
+    /**
+     * 设置使用非临时存储的字节数阈值（为0时禁用非临时存储）
+     */
+    inline void mem_set_stream_threshold(const size_t bytes)
+    {
+        mem_detail::stream_threshold.store(bytes ? bytes : ~size_t(0), std::memory_order_relaxed);
+    }
+
+    inline size_t mem_get_stream_threshold()
+    {
+        return mem_detail::get_stream_threshold();
+    }
+
+    /**
+     * 使用非临时存储复制（不论大小，不允许重叠）<br>
+     * 写入的数据不进入缓存，适合写完之后短时间内不会再读取的大块数据（如上传给GPU的缓冲区）
+     */
+    inline void mem_copy_stream(void *dst, const void *src, const size_t bytes)
+    {
+        if(!dst || !src || bytes == 0) return;
+
+        mem_detail::stream_copy(dst, src, bytes);
+    }
+
+    /**
+     * 使用非临时存储清零（不论大小）
+     */
+    inline void mem_zero_stream(void *dst, const size_t bytes)
+    {
+        if(!dst || bytes == 0) return;
+
+        alignas(16) const uint8 zero[mem_detail::PATTERN_BYTES] = {};
+
+        mem_detail::stream_fill(dst, bytes, zero, 1);
+    }
+
     //==================================================================================================
     // 内存操作 - 复制 / Memory Operations - Copy
     //==================================================================================================
@@ -50,7 +282,7 @@ namespace hgl
     /**
      * 内存复制（数组，要求源和目标内存区域不重叠）
      * 优化策略：
-     * - trivially_copyable 类型：使用 memcpy (最快，字节级复制，性能提升 30-40%)
+     * - trivially_copyable 类型：使用 memcpy (最快，字节级复制，性能提升 30-40%)，超过阈值时使用非临时存储
      * - 非平凡类型：使用 std::copy (正确调用赋值操作符)
      */
     template<typename T>
@@ -60,7 +292,12 @@ namespace hgl
 
         if constexpr(std::is_trivially_copyable_v<T>)
         {
-            std::memcpy(dst, src, count * sizeof(T));
+            const size_t bytes = count * sizeof(T);
+
+            if(bytes >= mem_detail::get_stream_threshold())
+                mem_detail::stream_copy(dst, src, bytes);
+            else
+                std::memcpy(dst, src, bytes);
         }
         else
         {
@@ -103,30 +340,50 @@ namespace hgl
 
     /**
      * 用指定值填充内存（单一值重复）
+     * 优化策略：
+     * - 单字节类型：memset
+     * - 长度能整除32的平凡类型：重复成32字节的模式块后整块存储，超过阈值时使用非临时存储
+     * - 其它类型：std::fill_n
      */
     template<typename T>
     inline void mem_fill(T *data, const T value, const size_t count)
     {
         if(!data || count == 0) return;
 
-        std::fill_n(data, count, value);
-    }
+        if constexpr(mem_detail::is_pattern_type<T>)
+        {
+            const size_t bytes = count * sizeof(T);
+            const size_t threshold = mem_detail::get_stream_threshold();
 
-    /**
-     * 字节填充特化（性能优化）
-     */
-    template<>
-    inline void mem_fill<uint8>(uint8 *data, const uint8 value, const size_t count)
-    {
-        if(!data || count == 0) return;
+            if constexpr(sizeof(T) == 1)
+            {
+                if(bytes < threshold)
+                {
+                    std::memset(data, *reinterpret_cast<const uint8 *>(&value), bytes);
+                    return;
+                }
+            }
 
-        std::memset(data, value, count);
+            alignas(16) uint8 pattern[mem_detail::PATTERN_BYTES];
+
+            mem_detail::make_pattern(pattern, value);
+
+            if(bytes >= threshold)
+                mem_detail::stream_fill(data, bytes, pattern, sizeof(T));
+            else
+                mem_detail::fill_pattern(reinterpret_cast<uint8 *>(data), bytes, pattern);
+        }
+        else
+        {
+            std::fill_n(data, count, value);
+        }
     }
 
     /**
      * 用指定模式填充内存（重复复制同一个对象）
      * 优化策略：
-     * - trivially_copyable 类型：使用 memcpy (最快)
+     * - 长度能整除32的平凡类型：同 mem_fill
+     * - 其它 trivially_copyable 类型：先写入一个，之后每次复制已填充的部分，复制长度逐次倍增（最大16KB，保持源数据在L1中），超过阈值时使用非临时存储
      * - 非平凡类型：使用赋值 (正确处理复制构造/赋值)
      */
     template<typename T>
@@ -134,12 +391,39 @@ namespace hgl
     {
         if(!data || !pattern || count == 0) return;
 
-        if constexpr(std::is_trivially_copyable_v<T>)
+        if constexpr(mem_detail::is_pattern_type<T>)
         {
-            for(size_t i = 0; i < count; i++)
+            mem_fill(data, *pattern, count);
+        }
+        else if constexpr(std::is_trivially_copyable_v<T>)
+        {
+            uint8 *dst = reinterpret_cast<uint8 *>(data);
+            const size_t total = count * sizeof(T);
+
+            //块长度取sizeof(T)的倍数，保证每次复制后模式相位不变
+            const size_t limit = std::max(sizeof(T), mem_detail::PATTERN_DOUBLING_LIMIT / sizeof(T) * sizeof(T));
+
+            //前几个逐个写入（定长memcpy会被内联），小数组不必进入倍增循环
+            const size_t head = std::min<size_t>(count, 8);
+
+            for(size_t i = 0; i < head; i++)
+                std::memcpy(dst + i * sizeof(T), pattern, sizeof(T));
+
+            size_t filled = head * sizeof(T);
+
+            //超过阈值时，开头的块留在缓存中作为源，其余部分用非临时存储写入
+            const bool stream = total >= mem_detail::get_stream_threshold();
+
+            while(filled < total)
             {
-                std::memcpy(data, pattern, sizeof(T));
-                ++data;
+                const size_t chunk = std::min({filled, limit, total - filled});
+
+                if(stream && chunk == limit)
+                    mem_detail::stream_copy(dst + filled, dst, chunk);
+                else
+                    std::memcpy(dst + filled, dst, chunk);
+
+                filled += chunk;
             }
         }
         else
@@ -167,14 +451,20 @@ namespace hgl
     }
 
     /**
-     * 内存清零（数组）
+     * 内存清零（数组），超过阈值时使用非临时存储
      */
     template<typename T>
     inline void mem_zero(T *data, const size_t count)
     {
         //static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
         if(!data || count == 0) return;
-        std::memset(data, 0, count * sizeof(T));
+
+        const size_t bytes = count * sizeof(T);
+
+        if(bytes >= mem_detail::get_stream_threshold())
+            mem_zero_stream(data, bytes);
+        else
+            std::memset(data, 0, bytes);
     }
 
     //==================================================================================================
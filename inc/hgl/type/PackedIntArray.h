@@ -0,0 +1,299 @@
+﻿#pragma once
+
+#include<hgl/platform/CpuFeature.h>
+#include<hgl/type/BitStream.h>
+
+namespace hgl
+{
+    namespace packed_int_detail
+    {
+        constexpr size_t PAD_BYTES=32;                                  ///<尾部预留，使任何位置都可以无检查地读取8~16字节
+
+        /**
+         * 从字节地址处读取小端64位
+         */
+        inline uint64 Load64(const uint8 *p)
+        {
+            uint64 v;
+            std::memcpy(&v,p,sizeof(uint64));
+            return to_little_endian(v);
+        }
+
+        inline void Store64(uint8 *p,const uint64 v)
+        {
+            const uint64 le=to_little_endian(v);
+            std::memcpy(p,&le,sizeof(uint64));
+        }
+
+#ifdef HGL_SIMD_X86
+        /**
+         * 每8个元素正好占bits个字节，且组内各元素的字节偏移与位偏移都相同，
+         * 所以每组只需两次16字节读取、一次vpshufb、一次vpsrlvd即可解出8个元素（bits<=25）。
+         */
+        struct UnpackControl
+        {
+            alignas(32) uint8  shuffle[32];
+            alignas(32) uint32 shift[8];
+            uint32 high_offset;                                         ///<后4个元素所在的16字节的起始偏移
+        };
+
+        inline void InitUnpackControl(UnpackControl &uc,const uint32 bits)
+        {
+            uc.high_offset=(4*bits)>>3;
+
+            for(uint32 k=0;k<8;k++)
+            {
+                const uint32 bit_pos=k*bits;
+                const uint32 byte=(bit_pos>>3)-(k>=4?uc.high_offset:0);
+
+                for(uint32 b=0;b<4;b++)
+                    uc.shuffle[k*4+b]=uint8(byte+b);
+
+                uc.shift[k]=bit_pos&7;
+            }
+        }
+
+        constexpr uint32 UNPACK_AVX2_MAX_BITS=25;
+
+        /**
+         * 取得各位宽(1~25)的解码控制表（第一次调用时生成）
+         */
+        inline const UnpackControl &GetUnpackControl(const uint32 bits)
+        {
+            static const auto table=[]
+            {
+                std::vector<UnpackControl> t(UNPACK_AVX2_MAX_BITS+1);
+
+                for(uint32 b=1;b<=UNPACK_AVX2_MAX_BITS;b++)
+                    InitUnpackControl(t[b],b);
+
+                return t;
+            }();
+
+            return table[bits];
+        }
+
+        /**
+         * 解码groups组(每组8个)元素，src必须指向组的起始字节，之后至少还有32字节可读
+         */
+        HGL_TARGET_ISA("avx2")
+        inline void UnpackAVX2(uint32 *out,const uint8 *src,const size_t groups,const uint32 bits,const UnpackControl &uc)
+        {
+            const __m256i shuffle=_mm256_load_si256(reinterpret_cast<const __m256i *>(uc.shuffle));
+            const __m256i shift  =_mm256_load_si256(reinterpret_cast<const __m256i *>(uc.shift));
+            const __m256i mask   =_mm256_set1_epi32(int((uint64(1)<<bits)-1));
+
+            for(size_t g=0;g<groups;g++)
+            {
+                const __m128i lo=_mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                const __m128i hi=_mm_loadu_si128(reinterpret_cast<const __m128i *>(src+uc.high_offset));
+
+                __m256i v=_mm256_inserti128_si256(_mm256_castsi128_si256(lo),hi,1);
+
+                v=_mm256_shuffle_epi8(v,shuffle);
+                v=_mm256_srlv_epi32(v,shift);
+                v=_mm256_and_si256(v,mask);
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out),v);
+
+                src+=bits;
+                out+=8;
+            }
+        }
+#endif//HGL_SIMD_X86
+    }//namespace packed_int_detail
+
+    /**
+     * 定宽位压缩整数数组<br>
+     * 每个元素占1~32位，按LSB优先紧密排列（第i个元素从第i*bits位开始，小端字节序，可直接序列化）。
+     * <ul>
+     *  <li>Get/Set 为O(1)，各只需一次非对齐64位读取（或读-改-写）</li>
+     *  <li>Unpack 批量解码到uint32数组，bits<=25时在支持AVX2的CPU上使用AVX2</li>
+     * </ul>
+     */
+    class PackedIntArray
+    {
+        std::vector<uint8> data;                                        ///<末尾额外有PAD_BYTES字节
+        size_t count=0;
+        uint32 bits=0;
+        uint32 max_value=0;
+
+    private:
+
+        static size_t ByteCount(const size_t n,const uint32 b){return (n*b+7)/8;}
+
+        void Store(const size_t index,const uint32 value)
+        {
+            const size_t bit_pos=index*bits;
+            uint8 *p=data.data()+bit_pos/8;
+            const uint32 shift=bit_pos&7;
+
+            const uint64 mask=uint64(max_value)<<shift;
+
+            packed_int_detail::Store64(p,(packed_int_detail::Load64(p)&~mask)|((uint64(value&max_value))<<shift));
+        }
+
+    public:
+
+        /**
+         * 存储0~max_value所需的位数
+         */
+        static constexpr uint32 BitsRequired(const uint32 max_value){return max_value?uint32(std::bit_width(max_value)):1;}
+
+    public:
+
+        PackedIntArray()=default;
+
+        PackedIntArray(const uint32 bits_per_value,const size_t n=0){Init(bits_per_value,n);}
+
+        /**
+         * 初始化
+         * @param bits_per_value 每个元素的位数(1~32)
+         * @param n 元素数量，初始值为0
+         * @return 位数不合法时返回false
+         */
+        bool Init(const uint32 bits_per_value,const size_t n=0)
+        {
+            if(bits_per_value<1||bits_per_value>32)
+                return false;
+
+            bits=bits_per_value;
+            max_value=uint32(low_bits_mask(bits));
+            count=0;
+            data.clear();
+
+            Resize(n);
+            return true;
+        }
+
+        /**
+         * 调整元素数量，新增元素为0
+         */
+        void Resize(const size_t n)
+        {
+            if(n<count)                                                 //清除截掉的部分，保证以后增加的元素为0
+            {
+                const size_t bit_pos=n*bits;
+                size_t byte=bit_pos/8;
+
+                if(bit_pos&7)
+                    data[byte++]&=uint8((1u<<(bit_pos&7))-1);
+
+                std::fill(data.begin()+byte,data.end(),0);
+            }
+
+            data.resize(ByteCount(n,bits)+packed_int_detail::PAD_BYTES,0);
+            count=n;
+        }
+
+        void Clear(){Resize(0);}
+
+        size_t GetCount()const{return count;}
+        uint32 GetBits()const{return bits;}
+        uint32 GetMaxValue()const{return max_value;}
+
+        /**
+         * 有效数据的字节数（不含尾部预留）
+         */
+        size_t GetBytes()const{return ByteCount(count,bits);}
+        const uint8 *GetData()const{return data.data();}
+
+        uint32 Get(const size_t index)const
+        {
+            const size_t bit_pos=index*bits;
+
+            return uint32(packed_int_detail::Load64(data.data()+bit_pos/8)>>(bit_pos&7))&max_value;
+        }
+
+        uint32 operator[](const size_t index)const{return Get(index);}
+
+        /**
+         * 设置元素，value超出位宽的部分被截掉
+         */
+        void Set(const size_t index,const uint32 value){Store(index,value);}
+
+        /**
+         * 追加一个元素
+         */
+        void Add(const uint32 value)
+        {
+            Resize(count+1);
+            Store(count-1,value);
+        }
+
+        /**
+         * 用一组数值重新填充（顺序打包，比逐个Set快）
+         */
+        void Assign(const uint32 *values,const size_t n)
+        {
+            count=0;
+            data.assign(ByteCount(n,bits)+packed_int_detail::PAD_BYTES,0);
+            count=n;
+
+            uint8 *p=data.data();
+            uint64 acc=0;
+            uint32 acc_bits=0;
+
+            for(size_t i=0;i<n;i++)
+            {
+                acc|=uint64(values[i]&max_value)<<acc_bits;
+                acc_bits+=bits;
+
+                if(acc_bits>=32)                                        //累积满32位写出4字节
+                {
+                    const uint32 le=to_little_endian(uint32(acc));
+                    std::memcpy(p,&le,sizeof(uint32));
+                    p+=4;
+                    acc>>=32;
+                    acc_bits-=32;
+                }
+            }
+
+            packed_int_detail::Store64(p,acc);                          //剩余不足32位，PAD_BYTES保证可写
+        }
+
+        /**
+         * 批量解码[start,start+n)到out
+         * @return 超出范围时返回false
+         */
+        bool Unpack(uint32 *out,size_t start,size_t n)const
+        {
+            if(start>count||n>count-start)
+                return false;
+
+#if HGL_ENDIAN==HGL_LITTLE_ENDIAN
+            if(bits==32)                                                //与uint32数组布局相同
+            {
+                if(n)
+                    std::memcpy(out,data.data()+start*sizeof(uint32),n*sizeof(uint32));
+
+                return true;
+            }
+#endif//HGL_ENDIAN
+
+#ifdef HGL_SIMD_X86
+            if(bits<=packed_int_detail::UNPACK_AVX2_MAX_BITS&&GetCpuFeature().avx2)
+            {
+                while(n&&(start&7))                                     //对齐到8个元素一组
+                {
+                    *out++=Get(start++);
+                    --n;
+                }
+
+                const size_t groups=n/8;
+
+                packed_int_detail::UnpackAVX2(out,data.data()+start/8*bits,groups,bits,packed_int_detail::GetUnpackControl(bits));
+
+                out+=groups*8;
+                start+=groups*8;
+                n-=groups*8;
+            }
+#endif//HGL_SIMD_X86
+
+            for(size_t i=0;i<n;i++)
+                out[i]=Get(start+i);
+
+            return true;
+        }
+    };//class PackedIntArray
+}//namespace hgl
@@ -0,0 +1,548 @@
+﻿#pragma once
+
+#include<hgl/util/hash/QuickHash.h>
+#include<hgl/type/EnumUtil.h>
+#include<vector>
+#include<string_view>
+#include<type_traits>
+#include<cstring>
+#include<bit>
+
+namespace hgl
+{
+    /**
+     * 静态完美哈希字符串表<br>
+     * CN:对一组固定不变的字符串（关键字表、枚举名称表），以PTHash/CHD方式构建：
+     *    键先按哈希分到约N/2个桶，从最大的桶开始，为每个桶找一个pilot值，使桶内所有键经过pilot扰动后
+     *    落到互不相同的空槽。查找时只需计算一次哈希、读一个pilot、读一个槽，再做一次字符串比较。
+     * EN:PTHash/CHD style table for string sets that never change: one hash, one pilot load,
+     *    one slot load and a single string comparison per lookup.
+     */
+    namespace phash_detail
+    {
+        constexpr uint32 MAX_PILOT  =0xFFFF;
+        constexpr uint32 MAX_SEEDS  =16;                                ///<找不到pilot时更换种子重建的次数
+        constexpr uint32 DUPLICATE  =0xFFFFFFFFu;                       ///<重复键标记（只保留第一个）
+
+        constexpr uint32 BucketCount(size_t n){return uint32(n/2+1);}
+
+        /**
+         * 槽数量：不小于1.25N的2的幂（负载因子0.4-0.8）
+         */
+        constexpr uint32 SlotCount(size_t n){return uint32(std::bit_ceil(n+n/4+2));}
+
+        /**
+         * 把8字节的字符按小端序装入64位整数，每个字符占一个通道
+         */
+        template<typename CharT>
+        constexpr uint64 PackWord(const CharT *str)
+        {
+#if HGL_ENDIAN==HGL_LITTLE_ENDIAN
+            if(!std::is_constant_evaluated())
+            {
+                uint64 w;
+                std::memcpy(&w,str,sizeof(uint64));
+                return w;
+            }
+#endif//HGL_ENDIAN==HGL_LITTLE_ENDIAN
+
+            uint64 w=0;
+
+            for(size_t i=0;i<sizeof(uint64)/sizeof(CharT);i++)
+                w|=uint64(std::make_unsigned_t<CharT>(str[i]))<<(i*sizeof(CharT)*8);
+
+            return w;
+        }
+
+        /**
+         * 不足8字节的字符装入64位整数，未用的通道为0
+         */
+        template<typename CharT>
+        constexpr uint64 PackTail(const CharT *str,const size_t count)
+        {
+            uint64 w=0;
+
+            for(size_t i=0;i<count;i++)
+                w|=uint64(std::make_unsigned_t<CharT>(str[i]))<<(i*sizeof(CharT)*8);
+
+            return w;
+        }
+
+        /**
+         * 将装入的每个通道中的ASCII大写字母转为小写（SWAR，通道宽度为字符宽度）
+         */
+        template<typename CharT>
+        constexpr uint64 FoldPacked(const uint64 w)
+        {
+            constexpr uint32 BITS=sizeof(CharT)*8;
+            constexpr uint64 ONES=~uint64(0)/((uint64(1)<<BITS)-1);                 ///<每个通道最低位为1
+            constexpr uint64 TOP =ONES<<(BITS-1);                                  ///<每个通道最高位
+            constexpr uint64 LOW =~TOP;
+
+            const uint64 v=w&LOW;
+            const uint64 ge_a=v+ONES*((uint64(1)<<(BITS-1))-'A');                   //>= 'A' 时通道最高位为1
+            const uint64 gt_z=v+ONES*((uint64(1)<<(BITS-1))-'Z'-1);                 //>  'Z' 时通道最高位为1
+            const uint64 upper=ge_a&~gt_z&~w&TOP;
+
+            return w|(upper>>(BITS-6));                                             //最高位移到0x20
+        }
+
+        /**
+         * 字符串哈希（编译期与运行期结果相同），每次处理8字节；
+         * 长度不足8字节整数倍时，最后一次读取与前一次重叠，不逐字符处理尾部
+         */
+        template<bool IgnoreCase,typename CharT>
+        constexpr uint64 Hash(const CharT *str,const size_t length,const uint64 seed)
+        {
+            constexpr size_t PER_WORD=sizeof(uint64)/sizeof(CharT);
+
+            uint64 h=seed^(uint64(length)*0x9E3779B97F4A7C15ull);
+
+            auto mix=[&h](uint64 w)
+            {
+                if constexpr(IgnoreCase)
+                    w=FoldPacked<CharT>(w);
+
+                h=(h^w)*0xFF51AFD7ED558CCDull;
+                h^=h>>32;
+            };
+
+            if(length<PER_WORD)
+            {
+                mix(PackTail(str,length));
+            }
+            else
+            {
+                size_t i=0;
+
+                for(;i+PER_WORD<length;i+=PER_WORD)
+                    mix(PackWord(str+i));
+
+                mix(PackWord(str+length-PER_WORD));
+            }
+
+            return h;                               //桶号取高位、槽号再经一次乘法，不需要额外的终结混合
+        }
+
+        template<bool IgnoreCase,typename CharT>
+        constexpr bool Equal(const CharT *a,const CharT *b,const size_t length)
+        {
+            if constexpr(IgnoreCase)
+            {
+                constexpr size_t PER_WORD=sizeof(uint64)/sizeof(CharT);
+
+                size_t i=0;
+
+                for(;i+PER_WORD<=length;i+=PER_WORD)
+                    if(FoldPacked<CharT>(PackWord(a+i))!=FoldPacked<CharT>(PackWord(b+i)))
+                        return false;
+
+                return i==length||FoldPacked<CharT>(PackTail(a+i,length-i))==FoldPacked<CharT>(PackTail(b+i,length-i));
+            }
+            else
+            {
+                if(!std::is_constant_evaluated())
+                    return std::memcmp(a,b,length*sizeof(CharT))==0;
+
+                for(size_t i=0;i<length;i++)
+                    if(a[i]!=b[i])
+                        return false;
+
+                return true;
+            }
+        }
+
+        template<typename CharT>
+        constexpr uint32 Length(const CharT *str)
+        {
+            uint32 len=0;
+
+            if(str)
+                while(str[len])++len;
+
+            return len;
+        }
+
+        /**
+         * 桶号：取哈希高32位按桶数缩放
+         */
+        constexpr uint32 BucketOf(const uint64 h,const uint32 bucket_count)
+        {
+            return uint32(((h>>32)*bucket_count)>>32);
+        }
+
+        /**
+         * 槽号：哈希与pilot的扰动值异或后做乘法哈希，取高位
+         */
+        constexpr uint32 SlotOf(const uint64 h,const uint32 pilot,const uint32 slot_shift)
+        {
+            return uint32(((h^((uint64(pilot)+1)*0x9E3779B97F4A7C15ull))*0xD6E8FEB86659FD93ull)>>slot_shift);
+        }
+
+        /**
+         * 构建完美哈希（编译期/运行期通用，所有数组由调用者提供）
+         * @param keys          键
+         * @param lengths       键长度
+         * @param n             键数量
+         * @param hashes        临时空间，n个
+         * @param order         临时空间，n个
+         * @param bucket_start  临时空间，bucket_count+1个
+         * @param bucket_order  临时空间，bucket_count个
+         * @param slots         输出：槽 -> 键序号，-1为空
+         * @param pilots        输出：每个桶的pilot
+         * @param seed          输出：哈希种子
+         * @return 是否成功
+         */
+        template<bool IgnoreCase,typename CharT,typename SlotT>
+        constexpr bool Build(const CharT *const *keys,const uint32 *lengths,const uint32 n,
+                             uint64 *hashes,uint32 *order,uint32 *bucket_start,uint32 *bucket_order,
+                             SlotT *slots,const uint32 slot_count,const uint32 slot_shift,
+                             uint16 *pilots,const uint32 bucket_count,
+                             uint64 &seed)
+        {
+            for(uint32 attempt=0;attempt<MAX_SEEDS;attempt++)
+            {
+                seed=HashMix64<HashMixPolicy::Murmur>(attempt+0x243F6A8885A308D3ull);
+
+                for(uint32 i=0;i<slot_count;i++)slots[i]=-1;
+                for(uint32 b=0;b<bucket_count;b++)pilots[b]=0;
+                for(uint32 b=0;b<=bucket_count;b++)bucket_start[b]=0;
+
+                //按桶计数排序（桶内保持键的原始顺序）
+                for(uint32 i=0;i<n;i++)
+                {
+                    hashes[i]=Hash<IgnoreCase>(keys[i],lengths[i],seed);
+
+                    if(keys[i])
+                        ++bucket_start[BucketOf(hashes[i],bucket_count)+1];
+                }
+
+                uint32 max_size=0;
+
+                for(uint32 b=0;b<bucket_count;b++)
+                {
+                    max_size=bucket_start[b+1]>max_size?bucket_start[b+1]:max_size;
+                    bucket_start[b+1]+=bucket_start[b];
+                }
+
+                for(uint32 b=0;b<bucket_count;b++)bucket_order[b]=bucket_start[b];     //临时作为写入位置
+
+                for(uint32 i=0;i<n;i++)
+                    if(keys[i])
+                        order[bucket_order[BucketOf(hashes[i],bucket_count)]++]=i;
+
+                //桶按大小从大到小处理
+                uint32 bucket_index=0;
+
+                for(uint32 size=max_size;size>0;size--)
+                    for(uint32 b=0;b<bucket_count;b++)
+                        if(bucket_start[b+1]-bucket_start[b]==size)
+                            bucket_order[bucket_index++]=b;
+
+                bool ok=true;
+
+                for(uint32 bi=0;bi<bucket_index&&ok;bi++)
+                {
+                    const uint32 b=bucket_order[bi];
+                    const uint32 first=bucket_start[b];
+                    const uint32 last=bucket_start[b+1];
+
+                    //同一个桶里哈希相同：内容相同则只保留第一个，否则是64位哈希碰撞，换种子
+                    for(uint32 i=first;i<last&&ok;i++)
+                        for(uint32 j=first;j<i&&order[i]!=DUPLICATE;j++)
+                            if(order[j]!=DUPLICATE&&hashes[order[i]]==hashes[order[j]])
+                            {
+                                if(lengths[order[i]]==lengths[order[j]]&&Equal<IgnoreCase>(keys[order[i]],keys[order[j]],lengths[order[i]]))
+                                    order[i]=DUPLICATE;
+                                else
+                                    ok=false;
+                            }
+
+                    if(!ok)break;
+
+                    uint32 pilot=0;
+
+                    for(;pilot<=MAX_PILOT;pilot++)
+                    {
+                        uint32 placed=first;
+
+                        for(;placed<last;placed++)
+                        {
+                            if(order[placed]==DUPLICATE)continue;
+
+                            const uint32 s=SlotOf(hashes[order[placed]],pilot,slot_shift);
+
+                            if(slots[s]>=0)break;
+
+                            slots[s]=SlotT(order[placed]);
+                        }
+
+                        if(placed==last)break;
+
+                        for(uint32 k=first;k<placed;k++)                //回滚
+                            if(order[k]!=DUPLICATE)
+                                slots[SlotOf(hashes[order[k]],pilot,slot_shift)]=-1;
+                    }
+
+                    if(pilot>MAX_PILOT)
+                        ok=false;
+                    else
+                        pilots[b]=uint16(pilot);
+                }
+
+                if(ok)
+                    return true;
+            }
+
+            return false;
+        }
+    }//namespace phash_detail
+
+    /**
+     * 编译期构建的完美哈希字符串表
+     * <pre>
+     * static constexpr const char *keywords[]={"if","else","while","return"};
+     * static constexpr StaticStringTable keyword_table(keywords);
+     *
+     * static_assert(keyword_table.Find("while")==2);
+     * int index=keyword_table.Find(token,token_length);        //运行时查找，O(1)
+     * </pre>
+     * 重复的键只保留第一个；nullptr键被跳过。键字符串必须在表的生命周期内有效（通常为字符串常量）。
+     *
+     * @tparam CharT 字符类型
+     * @tparam N 键数量
+     * @tparam IgnoreCase 是否忽略ASCII字母大小写（与 stricmp 一致）
+     */
+    template<typename CharT,size_t N,bool IgnoreCase=false>
+    class StaticStringTable
+    {
+        static_assert(N>0&&N<0x7FFFFFFF,"StaticStringTable: invalid key count");
+
+    public:
+
+        static constexpr uint32 KEY_COUNT   =uint32(N);
+        static constexpr uint32 BUCKET_COUNT=phash_detail::BucketCount(N);
+        static constexpr uint32 SLOT_COUNT  =phash_detail::SlotCount(N);
+
+    private:
+
+        using SlotT=std::conditional_t<(N<0x7FFF),int16,int32>;
+
+        static constexpr uint32 SLOT_SHIFT=64-uint32(std::countr_zero(SLOT_COUNT));
+
+        const CharT *keys[N]{};
+        uint32 lengths[N]{};
+        uint16 pilots[BUCKET_COUNT]{};
+        SlotT slots[SLOT_COUNT]{};
+        uint64 seed=0;
+        bool valid=false;
+
+    public:
+
+        constexpr StaticStringTable(const CharT *const (&list)[N])
+        {
+            uint64 hashes[N]{};
+            uint32 order[N]{};
+            uint32 bucket_start[BUCKET_COUNT+1]{};
+            uint32 bucket_order[BUCKET_COUNT]{};
+
+            for(size_t i=0;i<N;i++)
+            {
+                keys[i]=list[i];
+                lengths[i]=phash_detail::Length(list[i]);
+            }
+
+            valid=phash_detail::Build<IgnoreCase>(keys,lengths,KEY_COUNT,hashes,order,bucket_start,bucket_order,
+                                                  slots,SLOT_COUNT,SLOT_SHIFT,pilots,BUCKET_COUNT,seed);
+        }
+
+        constexpr bool IsValid()const{return valid;}
+        constexpr int GetCount()const{return int(N);}
+        constexpr const CharT *GetKey(const int index)const{return (index>=0&&index<int(N))?keys[index]:nullptr;}
+
+        /**
+         * 查找字符串在原列表中的序号
+         * @param str 要查找的字符串（可不以0结尾）
+         * @param length 字符串长度
+         * @return 序号，未找到返回-1
+         */
+        constexpr int Find(const CharT *str,const size_t length)const
+        {
+            if(!str||!valid)return -1;
+
+            const uint64 h=phash_detail::Hash<IgnoreCase>(str,length,seed);
+            const int index=slots[phash_detail::SlotOf(h,pilots[phash_detail::BucketOf(h,BUCKET_COUNT)],SLOT_SHIFT)];
+
+            if(index<0||lengths[index]!=length)
+                return -1;
+
+            return phash_detail::Equal<IgnoreCase>(keys[index],str,length)?index:-1;
+        }
+
+        constexpr int Find(const CharT *str)const{return Find(str,phash_detail::Length(str));}
+        constexpr int Find(const std::basic_string_view<CharT> &str)const{return Find(str.data(),str.size());}
+
+        constexpr bool Contains(const CharT *str,const size_t length)const{return Find(str,length)>=0;}
+        constexpr bool Contains(const CharT *str)const{return Find(str)>=0;}
+    };//class StaticStringTable
+
+    /**
+     * 运行时构建的完美哈希字符串表，用于替代对不变列表反复调用的 find_str_in_array<br>
+     * find_str_in_array 不区分大小写，对应 PerfectHashStringTable<CharT,true>。
+     * 只保存键的指针，键字符串必须在表的生命周期内有效。
+     */
+    template<typename CharT,bool IgnoreCase=false>
+    class PerfectHashStringTable
+    {
+        std::vector<const CharT *> keys;
+        std::vector<uint32> lengths;
+        std::vector<uint16> pilots;
+        std::vector<int32> slots;
+        uint64 seed=0;
+        uint32 bucket_count=0;
+        uint32 slot_shift=0;
+
+    public:
+
+        PerfectHashStringTable()=default;
+
+        /**
+         * @param count 字符串数量
+         * @param list 字符串数组，nullptr被跳过（序号保留）
+         */
+        PerfectHashStringTable(const int count,const CharT **list){Build(count,list);}
+
+        void Clear()
+        {
+            keys.clear();
+            lengths.clear();
+            pilots.clear();
+            slots.clear();
+            bucket_count=0;
+        }
+
+        bool Build(const int count,const CharT **list)
+        {
+            Clear();
+
+            if(count<=0||!list)return false;
+
+            keys.assign(list,list+count);
+            lengths.resize(count);
+
+            for(int i=0;i<count;i++)
+                lengths[i]=phash_detail::Length(list[i]);
+
+            bucket_count=phash_detail::BucketCount(count);
+
+            const uint32 slot_count=phash_detail::SlotCount(count);
+            slot_shift=64-uint32(std::countr_zero(slot_count));
+
+            pilots.resize(bucket_count);
+            slots.resize(slot_count);
+
+            std::vector<uint64> hashes(count);
+            std::vector<uint32> order(count);
+            std::vector<uint32> bucket_start(bucket_count+1);
+            std::vector<uint32> bucket_order(bucket_count);
+
+            if(!phash_detail::Build<IgnoreCase>(keys.data(),lengths.data(),uint32(count),hashes.data(),order.data(),bucket_start.data(),bucket_order.data(),
+                                                slots.data(),slot_count,slot_shift,pilots.data(),bucket_count,seed))
+            {
+                Clear();
+                return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * 以null结尾的列表构建（遇到nullptr或空字符串结束，与 find_str_in_array(list,str) 相同）
+         */
+        bool Build(const CharT **list)
+        {
+            if(!list)return false;
+
+            int count=0;
+            while(list[count]&&list[count][0])
+                ++count;
+
+            return Build(count,list);
+        }
+
+        bool IsValid()const{return bucket_count>0;}
+        int GetCount()const{return int(keys.size());}
+
+        /**
+         * 查找字符串在原列表中的序号
+         * @param str 要查找的字符串
+         * @param str_len 字符串长度，0表示按实际长度
+         * @return 序号，未找到返回-1
+         */
+        int Find(const CharT *str,int str_len=0)const
+        {
+            if(!str||!bucket_count)return -1;
+
+            if(str_len<=0)
+                str_len=int(phash_detail::Length(str));
+
+            const uint64 h=phash_detail::Hash<IgnoreCase>(str,size_t(str_len),seed);
+            const int32 index=slots[phash_detail::SlotOf(h,pilots[phash_detail::BucketOf(h,bucket_count)],slot_shift)];
+
+            if(index<0||lengths[index]!=uint32(str_len))
+                return -1;
+
+            return phash_detail::Equal<IgnoreCase>(keys[index],str,size_t(str_len))?index:-1;
+        }
+
+        int Find(const std::basic_string_view<CharT> &str)const{return str.empty()?-1:Find(str.data(),int(str.size()));}
+    };//class PerfectHashStringTable
+
+    /**
+     * 枚举名称表：名称与 enum class 的 [BEGIN_RANGE,END_RANGE] 一一对应，双向转换均为O(1)
+     * <pre>
+     * enum class BlendMode{Opaque,Mask,Alpha,Additive,ENUM_CLASS_RANGE(Opaque,Additive)};
+     *
+     * static constexpr const char *blend_mode_names[]={"Opaque","Mask","Alpha","Additive"};
+     * static constexpr EnumNameTable<BlendMode,4> blend_mode_table(blend_mode_names);
+     *
+     * BlendMode mode;
+     * if(blend_mode_table.ToEnum("Alpha",mode))...
+     * const char *name=blend_mode_table.ToName(BlendMode::Mask);
+     * </pre>
+     */
+    template<typename E,size_t N,typename CharT=char,bool IgnoreCase=false>
+    class EnumNameTable
+    {
+        static_assert(std::is_enum_v<E>,"EnumNameTable requires an enum type");
+        static_assert(N==RangeSize<E>(),"EnumNameTable: need exactly one name per value in [BEGIN_RANGE,END_RANGE]");
+
+        StaticStringTable<CharT,N,IgnoreCase> table;
+
+    public:
+
+        constexpr EnumNameTable(const CharT *const (&names)[N]):table(names){}
+
+        constexpr bool IsValid()const{return table.IsValid();}
+
+        constexpr const CharT *ToName(const E value)const
+        {
+            RANGE_CHECK_RETURN_NULLPTR(value)
+
+            return table.GetKey(ToInt(value)-ToInt(E::BEGIN_RANGE));
+        }
+
+        constexpr bool ToEnum(const CharT *name,const size_t length,E &value)const
+        {
+            const int index=table.Find(name,length);
+
+            if(index<0)return false;
+
+            value=FromInt<E>(index+ToInt(E::BEGIN_RANGE));
+            return true;
+        }
+
+        constexpr bool ToEnum(const CharT *name,E &value)const{return ToEnum(name,phash_detail::Length(name),value);}
+        constexpr bool ToEnum(const std::basic_string_view<CharT> &name,E &value)const{return ToEnum(name.data(),name.size(),value);}
+    };//class EnumNameTable
+}//namespace hgl
@@ -0,0 +1,498 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<hgl/type/ObjectUtil.h>
+#include<atomic>
+#include<mutex>
+#include<vector>
+#include<utility>
+#include<type_traits>
+
+namespace hgl
+{
+    /**
+     * SlabPool 统计信息
+     */
+    struct SlabPoolStats
+    {
+        int64 live;             ///<当前存活对象数量（已分配且未归还）
+        int64 peak_live;        ///<存活对象峰值（在弹匣与仓库交换及GetStats时采样，两次采样间的短暂尖峰最多漏计每线程一个缓存容量）
+        int64 peak_handed_out;  ///<交给线程缓存的对象数峰值（含缓存中尚未使用的部分，是占用内存的上界）
+        int64 reserved_bytes;   ///<已从系统申请的slab总字节数
+        int64 slab_count;       ///<slab数量
+        int64 depot_free;       ///<全局仓库中的空闲对象数量
+        int64 thread_caches;    ///<当前挂接的线程缓存数量
+    };//struct SlabPoolStats
+
+    namespace slab_pool_detail
+    {
+        /**
+         * 线程缓存基类（由线程本地表持有，在线程退出时归还给所属的池）
+         */
+        struct ThreadCacheBase
+        {
+            void *              owner           =nullptr;       ///<所属池，池销毁后置空
+            uint64              owner_serial    =0;             ///<所属池的序列号，用于识别槽位复用
+
+            ThreadCacheBase *   prev            =nullptr;
+            ThreadCacheBase *   next            =nullptr;
+
+            std::atomic<int64>  alloc_count     {0};            ///<本线程分配次数（仅本线程写）
+            std::atomic<int64>  free_count      {0};            ///<本线程释放次数（仅本线程写）
+
+            virtual ~ThreadCacheBase()=default;
+
+            virtual void OnThreadExit()=0;                      ///<线程退出时调用（已持有注册表锁）
+        };//struct ThreadCacheBase
+
+        /**
+         * 线程缓存注册表锁，只在创建/销毁线程缓存与池时使用，不在分配快速路径上
+         */
+        inline std::mutex &RegistryMutex()
+        {
+            static std::mutex registry_mutex;
+            return registry_mutex;
+        }
+
+        /**
+         * 每线程的缓存表，以池的槽位编号为下标
+         */
+        struct ThreadCacheTable
+        {
+            std::vector<ThreadCacheBase *> caches;
+
+            ~ThreadCacheTable()
+            {
+                std::lock_guard<std::mutex> lock(RegistryMutex());
+
+                for(ThreadCacheBase *tc:caches)
+                {
+                    if(!tc)continue;
+
+                    if(tc->owner)
+                        tc->OnThreadExit();
+
+                    delete tc;
+                }
+            }
+        };//struct ThreadCacheTable
+
+        inline ThreadCacheTable &GetThreadCacheTable()
+        {
+            thread_local ThreadCacheTable table;
+            return table;
+        }
+
+        /**
+         * 池槽位分配器（注册表锁保护）
+         */
+        struct SlotAllocator
+        {
+            std::vector<uint32> free_slots;
+            uint32              next_slot=0;
+            uint64              next_serial=1;
+
+            uint32 Acquire()
+            {
+                if(!free_slots.empty())
+                {
+                    const uint32 slot=free_slots.back();
+                    free_slots.pop_back();
+                    return slot;
+                }
+
+                return next_slot++;
+            }
+
+            void Release(uint32 slot)
+            {
+                free_slots.push_back(slot);
+            }
+        };//struct SlotAllocator
+
+        inline SlotAllocator &GetSlotAllocator()
+        {
+            static SlotAllocator allocator;
+            return allocator;
+        }
+    }//namespace slab_pool_detail
+
+    /**
+     * 定长对象slab池
+     *
+     * 以slab为单位向系统申请整块内存，切分为固定大小的对象槽位。
+     * 每个线程持有一个弹匣（magazine），分配与释放在弹匣内完成，不需要任何锁或原子读改写；
+     * 弹匣耗尽或溢出时以批次为单位与全局仓库（depot）交换。
+     *
+     * 与 ObjectUtil.h 配合：Allocate/Deallocate 只处理原始内存，
+     * Create/Release 则通过 construct_at 系列与 destroy_at 完成构造与析构。
+     *
+     * 注意：
+     * - 可以在任意线程释放任意线程分配的对象
+     * - 池销毁前必须保证没有其它线程还在使用它
+     * - 池销毁时会直接释放所有slab，未Release的对象不会被析构
+     */
+    template<typename T> class SlabPool
+    {
+        struct Slot
+        {
+            alignas(T) unsigned char data[sizeof(T)];
+        };
+
+        struct ThreadCache:public slab_pool_detail::ThreadCacheBase
+        {
+            T **    items;
+            uint32  count;
+            uint32  capacity;
+
+            int64   published_live=0;       ///<上次采样时已计入池的净分配数（持有仓库锁时访问）
+
+        public:
+
+            ThreadCache(uint32 cap)
+            {
+                capacity=cap;
+                count=0;
+                items=new T *[cap];
+            }
+
+            ~ThreadCache() override
+            {
+                delete[] items;
+            }
+
+            void OnThreadExit() override
+            {
+                static_cast<SlabPool<T> *>(owner)->DetachThreadCache(this);
+            }
+        };//struct ThreadCache
+
+    private:
+
+        uint32                      objects_per_slab;
+        uint32                      magazine_size;
+
+        uint32                      slot_index;             ///<线程缓存表中的下标
+        uint64                      serial;                 ///<全局唯一序列号
+
+        mutable std::mutex          depot_lock;
+        std::vector<T *>            depot;                  ///<全局空闲对象仓库
+        std::vector<Slot *>         slab_list;
+        int64                       handed_out=0;           ///<已交给线程缓存的对象数（含缓存中未使用的）
+        int64                       peak_handed_out=0;
+        int64                       sampled_live=0;         ///<各线程最近一次采样的净分配数之和
+        mutable int64               peak_live=0;
+
+        slab_pool_detail::ThreadCacheBase *cache_list=nullptr;  ///<挂接的线程缓存链表（注册表锁保护）
+        int64                       retired_live=0;         ///<已退出线程遗留的净分配数（注册表锁保护）
+
+    private:
+
+        /**
+         * 把线程缓存当前的净分配数计入存活对象采样并更新峰值（已持有depot_lock）
+         */
+        void SampleLive(ThreadCache *tc)
+        {
+            const int64 net=tc->alloc_count.load(std::memory_order_relaxed)
+                           -tc->free_count.load(std::memory_order_relaxed);
+
+            sampled_live+=net-tc->published_live;
+            tc->published_live=net;
+
+            if(sampled_live>peak_live)
+                peak_live=sampled_live;
+        }
+
+        /**
+         * 新建一个slab并将其所有槽位加入仓库（已持有depot_lock）
+         */
+        void GrowSlab()
+        {
+            Slot *slab=allocate_raw_memory<Slot>(int(objects_per_slab));
+
+            slab_list.push_back(slab);
+
+            depot.reserve(depot.size()+objects_per_slab);
+
+            for(int i=int(objects_per_slab)-1;i>=0;i--)             //倒序压入，使得先分配低地址
+                depot.push_back(reinterpret_cast<T *>(slab+i));
+        }
+
+        /**
+         * 从仓库批量取出对象放入线程缓存
+         */
+        void RefillFromDepot(ThreadCache *tc)
+        {
+            std::lock_guard<std::mutex> lock(depot_lock);
+
+            SampleLive(tc);
+
+            if(depot.size()<magazine_size)
+                GrowSlab();
+
+            const size_t start=depot.size()-magazine_size;
+
+            for(uint32 i=0;i<magazine_size;i++)
+                tc->items[tc->count++]=depot[start+i];
+
+            depot.resize(start);
+
+            handed_out+=magazine_size;
+
+            if(handed_out>peak_handed_out)
+                peak_handed_out=handed_out;
+        }
+
+        /**
+         * 将线程缓存中的对象批量归还仓库
+         */
+        void ReturnToDepot(ThreadCache *tc,uint32 number)
+        {
+            std::lock_guard<std::mutex> lock(depot_lock);
+
+            SampleLive(tc);
+
+            tc->count-=number;
+            depot.insert(depot.end(),tc->items+tc->count,tc->items+tc->count+number);
+
+            handed_out-=number;
+        }
+
+        /**
+         * 线程退出时，把缓存全部归还并脱离本池（已持有注册表锁）
+         */
+        void DetachThreadCache(ThreadCache *tc)
+        {
+            if(tc->count>0)
+            {
+                ReturnToDepot(tc,tc->count);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(depot_lock);
+
+                SampleLive(tc);
+            }
+
+            retired_live+=tc->alloc_count.load(std::memory_order_relaxed)
+                         -tc->free_count.load(std::memory_order_relaxed);
+
+            if(tc->prev)tc->prev->next=tc->next;
+            else        cache_list=tc->next;
+
+            if(tc->next)tc->next->prev=tc->prev;
+
+            tc->owner=nullptr;
+            tc->prev=tc->next=nullptr;
+        }
+
+        ThreadCache *CreateThreadCache()
+        {
+            auto &table=slab_pool_detail::GetThreadCacheTable();
+
+            std::lock_guard<std::mutex> lock(slab_pool_detail::RegistryMutex());
+
+            if(table.caches.size()<=slot_index)
+                table.caches.resize(slot_index+1,nullptr);
+
+            delete table.caches[slot_index];                        //旧池已销毁时遗留的缓存（已脱离）
+
+            ThreadCache *tc=new ThreadCache(magazine_size*2);
+
+            tc->owner=this;
+            tc->owner_serial=serial;
+            tc->next=cache_list;
+
+            if(cache_list)cache_list->prev=tc;
+            cache_list=tc;
+
+            table.caches[slot_index]=tc;
+            return tc;
+        }
+
+        ThreadCache *GetThreadCache()
+        {
+            auto &table=slab_pool_detail::GetThreadCacheTable();
+
+            if(slot_index<table.caches.size())
+            {
+                slab_pool_detail::ThreadCacheBase *tc=table.caches[slot_index];
+
+                if(tc&&tc->owner_serial==serial)
+                    return static_cast<ThreadCache *>(tc);
+            }
+
+            return CreateThreadCache();
+        }
+
+        static void Increase(std::atomic<int64> &counter)
+        {
+            //只有本线程写入，使用load+store代替读改写，避免锁前缀指令
+            counter.store(counter.load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+        }
+
+    public:
+
+        /**
+         * @param per_slab 每个slab包含的对象数量
+         * @param magazine 每次与全局仓库交换的对象数量（线程缓存容量为其两倍）
+         */
+        SlabPool(uint32 per_slab=1024,uint32 magazine=64)
+        {
+            magazine_size=(magazine>0?magazine:1);
+            objects_per_slab=(per_slab>magazine_size?per_slab:magazine_size);
+
+            std::lock_guard<std::mutex> lock(slab_pool_detail::RegistryMutex());
+
+            auto &sa=slab_pool_detail::GetSlotAllocator();
+
+            slot_index=sa.Acquire();
+            serial=sa.next_serial++;
+        }
+
+        ~SlabPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(slab_pool_detail::RegistryMutex());
+
+                for(auto *tc=cache_list;tc;tc=tc->next)
+                    tc->owner=nullptr;                          //线程缓存对象由各线程自行释放
+
+                cache_list=nullptr;
+
+                slab_pool_detail::GetSlotAllocator().Release(slot_index);
+            }
+
+            for(Slot *slab:slab_list)
+                deallocate_raw_memory(slab);
+        }
+
+        NO_COPY_NO_MOVE(SlabPool)
+
+        uint32 GetObjectsPerSlab()const{return objects_per_slab;}
+        uint32 GetMagazineSize()const{return magazine_size;}
+
+        /**
+         * 分配一个未构造的对象内存
+         */
+        T *Allocate()
+        {
+            ThreadCache *tc=GetThreadCache();
+
+            if(tc->count==0)
+                RefillFromDepot(tc);
+
+            Increase(tc->alloc_count);
+            return tc->items[--tc->count];
+        }
+
+        /**
+         * 归还一个对象内存（不调用析构）
+         */
+        void Deallocate(T *pointer)
+        {
+            if(!pointer)return;
+
+            ThreadCache *tc=GetThreadCache();
+
+            if(tc->count==tc->capacity)
+                ReturnToDepot(tc,magazine_size);
+
+            Increase(tc->free_count);
+            tc->items[tc->count++]=pointer;
+        }
+
+        /**
+         * 分配并构造对象
+         */
+        template<typename ...ARGS>
+        T *Create(ARGS &&...args)
+        {
+            T *pointer=Allocate();
+
+            try
+            {
+                if constexpr(sizeof...(ARGS)==0)
+                {
+                    construct_at(pointer);
+                }
+                else if constexpr(sizeof...(ARGS)==1&&(std::is_same_v<std::remove_cvref_t<ARGS>,T>&&...))
+                {
+                    if constexpr((std::is_rvalue_reference_v<ARGS &&>&&...))
+                        construct_at_move(pointer,std::forward<ARGS>(args)...);
+                    else
+                        construct_at_copy(pointer,args...);
+                }
+                else
+                {
+                    new (static_cast<void *>(pointer)) T(std::forward<ARGS>(args)...);
+                }
+            }
+            catch(...)
+            {
+                Deallocate(pointer);
+                throw;
+            }
+
+            return pointer;
+        }
+
+        /**
+         * 析构并归还对象
+         */
+        void Release(T *pointer)
+        {
+            if(!pointer)return;
+
+            destroy_at(pointer);
+            Deallocate(pointer);
+        }
+
+        /**
+         * 将当前线程的缓存全部归还全局仓库
+         */
+        void FlushThreadCache()
+        {
+            ThreadCache *tc=GetThreadCache();
+
+            if(tc->count>0)
+                ReturnToDepot(tc,tc->count);
+        }
+
+        /**
+         * 取得统计信息（会遍历所有线程缓存，不要在热路径上调用）
+         */
+        SlabPoolStats GetStats()const
+        {
+            SlabPoolStats stats{};
+
+            {
+                std::lock_guard<std::mutex> lock(slab_pool_detail::RegistryMutex());
+
+                stats.live=retired_live;
+
+                for(auto *tc=cache_list;tc;tc=tc->next)
+                {
+                    stats.live+=tc->alloc_count.load(std::memory_order_relaxed)
+                               -tc->free_count.load(std::memory_order_relaxed);
+                    ++stats.thread_caches;
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(depot_lock);
+
+                if(stats.live>peak_live)
+                    peak_live=stats.live;
+
+                stats.peak_live      =peak_live;
+                stats.peak_handed_out=peak_handed_out;
+                stats.slab_count     =int64(slab_list.size());
+                stats.reserved_bytes =stats.slab_count*int64(objects_per_slab)*int64(sizeof(Slot));
+                stats.depot_free     =int64(depot.size());
+            }
+
+            return stats;
+        }
+    };//template<typename T> class SlabPool
+}//namespace hgl
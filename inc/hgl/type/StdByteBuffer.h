@@ -29,10 +29,12 @@ namespace hgl
 
         void u32(uint32_t value)
         {
-            out.push_back(static_cast<uint8_t>(value & 0xFF));
-            out.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-            out.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-            out.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
+            const uint8_t le[4] = { static_cast<uint8_t>(value & 0xFF),
+                                    static_cast<uint8_t>((value >> 8) & 0xFF),
+                                    static_cast<uint8_t>((value >> 16) & 0xFF),
+                                    static_cast<uint8_t>((value >> 24) & 0xFF) };
+
+            out.insert(out.end(), le, le + 4);
         }
 
         void i32(int32_t value)
@@ -0,0 +1,963 @@
+﻿#pragma once
+
+#include<hgl/type/Str.Number.h>
+#include<hgl/type/MemoryAlloc.h>
+#include<string_view>
+#include<array>
+#include<charconv>
+#include<type_traits>
+
+/**
+ * 类型安全的格式化输出（std::format 子集）
+ *
+ * 格式串在编译期解析并检查：字段数与参数数一致、格式说明与参数类型匹配，错误在编译时报出。
+ * 解析结果（各段文字位置与格式说明）作为常量保存，运行时只做一遍输出，不需要像 vsprintf_length 那样先测量再写入。
+ * 整数使用 Str.Number.h 中的 itos_rl/utos，浮点使用 std::to_chars，均不涉及locale。
+ *
+ * 格式说明：{[:[[fill]align][sign][#][0][width][.precision][type]]}
+ *      align       <左对齐 >右对齐 ^居中（数值默认右对齐，其它默认左对齐）
+ *      sign        + 正数加+号，空格 正数加空格
+ *      #           整数加0x/0b/0前缀
+ *      0           数值用0填充到宽度（符号与前缀之后）
+ *      precision   浮点为小数位数（g为有效位数），字符串为最大长度
+ *      type        整数 d x X o b B，字符 c，浮点 f F e E g G，字符串 s，指针 p
+ *
+ * 只支持按顺序自动编号的字段，{{ 和 }} 输出单个大括号。
+ *
+ *      char buf[256];
+ *      strfmt(buf,sizeof(buf),"{} took {:.3f} ms, {:#x}",name,ms,flags);
+ */
+namespace hgl
+{
+    /**
+     * 格式化参数类别
+     */
+    enum class FormatArgType:uint8
+    {
+        None,               ///<不支持的类型
+        Bool,
+        Char,               ///<与输出相同的字符类型
+        Int,                ///<有符号整数与枚举
+        UInt,               ///<无符号整数与枚举
+        Float,
+        Double,             ///<double与long double
+        String,             ///<字符串指针、数组、std::basic_string/basic_string_view
+        Pointer
+    };
+
+    template<typename CharT> struct FormatStringRef
+    {
+        const CharT *str;
+        size_t length;
+    };
+
+    /**
+     * 类型擦除后的单个参数
+     */
+    template<typename CharT> struct FormatArg
+    {
+        FormatArgType type;
+
+        union
+        {
+            bool                    b;
+            CharT                   c;
+            int64                   i;
+            uint64                  u;
+            float                   f;
+            double                  d;
+            FormatStringRef<CharT>  s;
+            const void *            p;
+        };
+    };//template<typename CharT> struct FormatArg
+
+    /**
+     * 编译期解析出的单个字段格式说明
+     */
+    template<typename CharT> struct FormatSpec
+    {
+        CharT   fill        =CharT(' ');
+        char    align       =0;                 ///<'<' '>' '^'，0为按类型默认
+        char    sign        =0;                 ///<'+' ' '，0为仅负数输出符号
+        bool    alternate   =false;             ///<'#'
+        bool    zero_pad    =false;             ///<'0'
+        char    type        =0;                 ///<0为按类型默认
+        uint16  width       =0;
+        int16   precision   =-1;                ///<-1为未指定
+    };//template<typename CharT> struct FormatSpec
+
+    /**
+     * 格式串中的一段文字
+     */
+    struct FormatSegment
+    {
+        uint32  offset;
+        uint32  length;
+        bool    escaped;                        ///<含有{{或}}，需要逐字符复制
+    };
+
+    /**
+     * 解析后的格式串（与参数类型无关，运行时使用）
+     */
+    template<typename CharT> struct FormatView
+    {
+        const CharT *               str;
+        const FormatSegment *       literal;    ///<count+1段
+        const FormatSpec<CharT> *   spec;       ///<count个
+        size_t                      count;
+    };
+
+    constexpr uint16 FORMAT_MAX_WIDTH       =1024;
+    constexpr int16  FORMAT_MAX_PRECISION   =100;           ///<保证浮点定点输出不超过临时缓冲区
+
+    namespace format_detail
+    {
+        template<typename T> constexpr bool IsCharType=std::is_same_v<T,char>
+                                                     ||std::is_same_v<T,wchar_t>
+                                                     ||std::is_same_v<T,char8_t>
+                                                     ||std::is_same_v<T,char16_t>
+                                                     ||std::is_same_v<T,char32_t>;
+
+        template<typename CharT,typename T>
+        constexpr FormatArgType GetFormatArgType()
+        {
+            using U=std::remove_cvref_t<T>;
+
+            if constexpr(std::is_same_v<U,bool>)                                    return FormatArgType::Bool;
+            else if constexpr(std::is_same_v<U,CharT>)                              return FormatArgType::Char;
+            else if constexpr(IsCharType<U>)                                        return FormatArgType::None;
+            else if constexpr(std::is_integral_v<U>)                                return std::is_signed_v<U>?FormatArgType::Int:FormatArgType::UInt;
+            else if constexpr(std::is_enum_v<U>)                                    return std::is_signed_v<std::underlying_type_t<U>>?FormatArgType::Int:FormatArgType::UInt;
+            else if constexpr(std::is_same_v<U,float>)                              return FormatArgType::Float;
+            else if constexpr(std::is_floating_point_v<U>)                          return FormatArgType::Double;
+            else if constexpr(std::is_array_v<U>)                                   return std::is_same_v<std::remove_cv_t<std::remove_extent_t<U>>,CharT>?FormatArgType::String:FormatArgType::None;
+            else if constexpr(std::is_same_v<U,const CharT *>||std::is_same_v<U,CharT *>) return FormatArgType::String;
+            else if constexpr(std::is_null_pointer_v<U>)                            return FormatArgType::Pointer;
+            else if constexpr(std::is_convertible_v<const U &,std::basic_string_view<CharT>>) return FormatArgType::String;
+            else if constexpr(std::is_pointer_v<U>)                                 return IsCharType<std::remove_cv_t<std::remove_pointer_t<U>>>||std::is_function_v<std::remove_pointer_t<U>>?FormatArgType::None:FormatArgType::Pointer;
+            else                                                                    return FormatArgType::None;
+        }
+
+        template<typename CharT,typename T>
+        inline FormatArg<CharT> MakeFormatArg(const T &value)
+        {
+            using U=std::remove_cvref_t<T>;
+            constexpr FormatArgType type=GetFormatArgType<CharT,T>();
+
+            FormatArg<CharT> arg;
+
+            arg.type=type;
+
+            if constexpr(type==FormatArgType::Bool)         arg.b=value;
+            else if constexpr(type==FormatArgType::Char)    arg.c=value;
+            else if constexpr(type==FormatArgType::Int)     arg.i=int64(value);
+            else if constexpr(type==FormatArgType::UInt)    arg.u=uint64(value);
+            else if constexpr(type==FormatArgType::Float)   arg.f=value;
+            else if constexpr(type==FormatArgType::Double)  arg.d=double(value);
+            else if constexpr(type==FormatArgType::Pointer) arg.p=static_cast<const void *>(value);
+            else if constexpr(std::is_array_v<U>)
+            {
+                arg.s.str=value;
+                arg.s.length=size_t(hgl::strlen(value,std::extent_v<U>));
+            }
+            else if constexpr(std::is_pointer_v<U>)
+            {
+                arg.s.str=value;
+                arg.s.length=value?size_t(hgl::strlen(value)):0;
+            }
+            else
+            {
+                const std::basic_string_view<CharT> sv(value);
+
+                arg.s.str=sv.data();
+                arg.s.length=sv.size();
+            }
+
+            return arg;
+        }
+
+        /**
+         * 在常量求值中调用即产生编译错误，错误信息中可以看到参数文字
+         */
+        inline void FormatError(const char *){}
+
+        constexpr bool IsAlign(const int ch)
+        {
+            return ch=='<'||ch=='>'||ch=='^';
+        }
+
+        constexpr bool IsDigit(const int ch)
+        {
+            return ch>='0'&&ch<='9';
+        }
+
+        constexpr bool IsIntegerType(const char t)
+        {
+            return t=='d'||t=='x'||t=='X'||t=='o'||t=='b'||t=='B';
+        }
+
+        constexpr bool IsFloatType(const char t)
+        {
+            return t=='f'||t=='F'||t=='e'||t=='E'||t=='g'||t=='G';
+        }
+
+        template<typename CharT>
+        constexpr void CheckSpec(const FormatSpec<CharT> &spec,const FormatArgType type)
+        {
+            const char t=spec.type;
+            const bool numeric_flags=spec.sign||spec.alternate||spec.zero_pad;
+
+            switch(type)
+            {
+                case FormatArgType::Int:
+                case FormatArgType::UInt:
+                    if(t&&!IsIntegerType(t))                FormatError("invalid type for integer argument");
+                    if(spec.precision>=0)                   FormatError("precision not allowed for integer argument");
+                    break;
+
+                case FormatArgType::Char:
+                case FormatArgType::Bool:
+                    if(t&&!IsIntegerType(t)&&t!=(type==FormatArgType::Char?'c':'s'))
+                                                            FormatError("invalid type for char/bool argument");
+                    if(spec.precision>=0)                   FormatError("precision not allowed for char/bool argument");
+                    if(!IsIntegerType(t)&&numeric_flags)    FormatError("sign/#/0 need an integer presentation type");
+                    break;
+
+                case FormatArgType::Float:
+                case FormatArgType::Double:
+                    if(t&&!IsFloatType(t))                  FormatError("invalid type for floating-point argument");
+                    if(spec.alternate)                      FormatError("'#' not supported for floating-point argument");
+                    break;
+
+                case FormatArgType::String:
+                    if(t&&t!='s')                           FormatError("invalid type for string argument");
+                    if(numeric_flags)                       FormatError("sign/#/0 not allowed for string argument");
+                    break;
+
+                case FormatArgType::Pointer:
+                    if(t&&t!='p')                           FormatError("invalid type for pointer argument");
+                    if(numeric_flags||spec.precision>=0)    FormatError("sign/#/0/precision not allowed for pointer argument");
+                    break;
+
+                default:
+                    FormatError("unsupported argument type");
+            }
+        }
+
+        /**
+         * 解析{之后到}为止的格式说明，返回}之后的位置
+         */
+        template<typename CharT>
+        constexpr size_t ParseSpec(const CharT *str,const size_t len,size_t pos,FormatSpec<CharT> &spec)
+        {
+            if(pos<len&&str[pos]==':')
+                ++pos;
+            else if(pos>=len||str[pos]!='}')
+                FormatError("only automatic field numbering '{}' is supported");
+
+            if(pos+1<len&&str[pos]!='}'&&str[pos]!='{'&&IsAlign(str[pos+1]))
+            {
+                spec.fill=str[pos];
+                spec.align=char(str[pos+1]);
+                pos+=2;
+            }
+            else if(pos<len&&IsAlign(str[pos]))
+            {
+                spec.align=char(str[pos]);
+                ++pos;
+            }
+
+            if(pos<len&&(str[pos]=='+'||str[pos]==' '||str[pos]=='-'))
+            {
+                spec.sign=(str[pos]=='-')?0:char(str[pos]);
+                ++pos;
+            }
+
+            if(pos<len&&str[pos]=='#')
+            {
+                spec.alternate=true;
+                ++pos;
+            }
+
+            if(pos<len&&str[pos]=='0')
+            {
+                spec.zero_pad=true;
+                ++pos;
+            }
+
+            uint32 width=0;
+
+            while(pos<len&&IsDigit(str[pos]))
+            {
+                width=width*10+uint32(str[pos]-'0');
+                ++pos;
+
+                if(width>FORMAT_MAX_WIDTH)
+                    FormatError("width too large");
+            }
+
+            spec.width=uint16(width);
+
+            if(pos<len&&str[pos]=='.')
+            {
+                ++pos;
+
+                if(pos>=len||!IsDigit(str[pos]))
+                    FormatError("missing precision after '.'");
+
+                int precision=0;
+
+                while(pos<len&&IsDigit(str[pos]))
+                {
+                    precision=precision*10+int(str[pos]-'0');
+                    ++pos;
+
+                    if(precision>FORMAT_MAX_PRECISION)
+                        FormatError("precision too large");
+                }
+
+                spec.precision=int16(precision);
+            }
+
+            if(pos<len&&str[pos]!='}')
+            {
+                if(!((str[pos]>='a'&&str[pos]<='z')||(str[pos]>='A'&&str[pos]<='Z')))
+                    FormatError("invalid format spec");
+
+                spec.type=char(str[pos]);
+                ++pos;
+            }
+
+            if(pos>=len||str[pos]!='}')
+                FormatError("missing '}' in format spec");
+
+            return pos+1;
+        }
+    }//namespace format_detail
+
+    /**
+     * 编译期解析的格式串，由字符串字面量隐式构造
+     */
+    template<typename CharT,typename ...Args> class BasicFormatString
+    {
+        static constexpr size_t ARG_COUNT=sizeof...(Args);
+
+        const CharT *str;
+
+        std::array<FormatSegment,ARG_COUNT+1>       literal{};
+        std::array<FormatSpec<CharT>,ARG_COUNT>     spec{};
+
+    public:
+
+        template<size_t N>
+        consteval BasicFormatString(const CharT (&s)[N]):str(s)
+        {
+            using namespace format_detail;
+
+            constexpr FormatArgType types[]={GetFormatArgType<CharT,Args>()...,FormatArgType::None};
+
+            const size_t len=(N>0&&s[N-1]==0)?N-1:N;
+
+            size_t pos=0;
+            size_t field=0;
+            size_t begin=0;
+            bool escaped=false;
+
+            while(pos<len)
+            {
+                const CharT ch=s[pos];
+
+                if(ch=='{'||ch=='}')
+                {
+                    if(pos+1<len&&s[pos+1]==ch)
+                    {
+                        escaped=true;
+                        pos+=2;
+                        continue;
+                    }
+
+                    if(ch=='}')
+                        FormatError("unmatched '}' in format string");
+
+                    if(field>=ARG_COUNT)
+                        FormatError("more '{}' fields than arguments");
+
+                    literal[field]={uint32(begin),uint32(pos-begin),escaped};
+
+                    pos=ParseSpec(s,len,pos+1,spec[field]);
+                    CheckSpec(spec[field],types[field]);
+
+                    ++field;
+                    begin=pos;
+                    escaped=false;
+                    continue;
+                }
+
+                ++pos;
+            }
+
+            if(field!=ARG_COUNT)
+                FormatError("fewer '{}' fields than arguments");
+
+            literal[ARG_COUNT]={uint32(begin),uint32(len-begin),escaped};
+        }
+
+        constexpr FormatView<CharT> GetView()const
+        {
+            return FormatView<CharT>{str,literal.data(),spec.data(),ARG_COUNT};
+        }
+    };//template<typename CharT,typename ...Args> class BasicFormatString
+
+    /**
+     * 参数列表中使用的格式串类型（不参与模板推导，CharT由输出目标决定，Args由参数决定）
+     */
+    template<typename CharT,typename ...Args>
+    using FormatString=std::type_identity_t<BasicFormatString<CharT,std::remove_cvref_t<Args>...>>;
+
+    /**
+     * 格式化输出目标<br>
+     * 直接使用时为固定缓冲区，写不下的部分计入溢出数；派生类可重载Grow实现扩容
+     */
+    template<typename CharT> class FormatSink
+    {
+    protected:
+
+        CharT *buffer;
+        CharT *cur;
+        CharT *end;                                     ///<最后一个可写位置之后，结尾0另外保留一个位置
+
+        size_t overflow=0;                              ///<未能写入的字符数
+
+        /**
+         * 空间不足时调用，返回后至少需要有need个空位
+         */
+        virtual bool Grow(const size_t){return(false);}
+
+        void AppendSlow(const CharT *str,size_t n)
+        {
+            if(!Grow(n))
+            {
+                const size_t room=size_t(end-cur);
+
+                overflow+=n-room;
+                n=room;
+            }
+
+            for(size_t i=0;i<n;i++)                             //慢速路径，逐个复制
+                *cur++=str[i];
+        }
+
+        void FillSlow(const CharT ch,size_t n)
+        {
+            if(!Grow(n))
+            {
+                const size_t room=size_t(end-cur);
+
+                overflow+=n-room;
+                n=room;
+            }
+
+            for(size_t i=0;i<n;i++)
+                *cur++=ch;
+        }
+
+    public:
+
+        /**
+         * @param buf   输出缓冲区，可以为nullptr（只计算长度）
+         * @param size  缓冲区可容纳的字符数，含结尾0
+         */
+        FormatSink(CharT *buf,const size_t size)
+        {
+            if(!buf||!size)
+                buf=nullptr;
+
+            buffer=cur=buf;
+            end=buf?buf+size-1:nullptr;
+        }
+
+        virtual ~FormatSink()=default;
+
+        NO_COPY_NO_MOVE(FormatSink)
+
+        const CharT *GetData        ()const{return buffer;}
+        size_t       GetLength      ()const{return size_t(cur-buffer);}             ///<已写入的字符数
+        size_t       GetTotalLength ()const{return size_t(cur-buffer)+overflow;}    ///<完整输出所需的字符数
+        bool         IsTruncated    ()const{return overflow>0;}
+
+        void Append(const CharT *str,const size_t n)
+        {
+            if(!n)
+                return;
+
+            if(size_t(end-cur)>=n)
+            {
+                memcpy(cur,str,n*sizeof(CharT));
+                cur+=n;
+            }
+            else
+                AppendSlow(str,n);
+        }
+
+        void Append(const CharT ch)
+        {
+            if(cur<end)
+                *cur++=ch;
+            else
+                AppendSlow(&ch,1);
+        }
+
+        void Fill(const CharT ch,const size_t n)
+        {
+            if(size_t(end-cur)>=n)
+            {
+                for(size_t i=0;i<n;i++)
+                    cur[i]=ch;
+
+                cur+=n;
+            }
+            else
+                FillSlow(ch,n);
+        }
+
+        /**
+         * 取得至少n个字符的连续写入空间，空间不足且无法扩容时返回nullptr
+         */
+        CharT *Reserve(const size_t n)
+        {
+            if(size_t(end-cur)>=n||Grow(n))
+                return cur;
+
+            return(nullptr);
+        }
+
+        void Commit(const size_t n)
+        {
+            cur+=n;
+        }
+
+        /**
+         * 写入结尾0（不计入长度）
+         */
+        void Terminate()
+        {
+            if(cur)
+                *cur=0;
+        }
+
+        void Clear()
+        {
+            cur=buffer;
+            overflow=0;
+        }
+    };//template<typename CharT> class FormatSink
+
+    /**
+     * 可增长的格式化缓冲区，先使用内部INLINE_SIZE个字符的空间，不够时改为堆内存并按倍数扩大
+     */
+    template<typename CharT,size_t INLINE_SIZE=256> class FormatBuffer:public FormatSink<CharT>
+    {
+        CharT inline_buffer[INLINE_SIZE];
+
+    protected:
+
+        bool Grow(const size_t need) override
+        {
+            const size_t length=this->GetLength();
+            const size_t capacity=size_t(this->end-this->buffer)+1;
+
+            size_t new_capacity=capacity*2;
+
+            if(new_capacity<length+need+1)
+                new_capacity=length+need+1;
+
+            new_capacity=(new_capacity+HGL_MEM_ALIGN-1)&~size_t(HGL_MEM_ALIGN-1);   //aligned_alloc要求字节数为对齐值的整数倍
+
+            CharT *new_buffer;
+
+            if(this->buffer==inline_buffer)
+            {
+                new_buffer=array_alloc<CharT>(uint(new_capacity));
+
+                if(!new_buffer)
+                    return(false);
+
+                memcpy(new_buffer,inline_buffer,length*sizeof(CharT));
+            }
+            else
+            {
+                new_buffer=array_realloc<CharT>(this->buffer,uint(new_capacity));
+
+                if(!new_buffer)
+                    return(false);
+            }
+
+            this->buffer=new_buffer;
+            this->cur=new_buffer+length;
+            this->end=new_buffer+new_capacity-1;
+            return(true);
+        }
+
+    public:
+
+        FormatBuffer():FormatSink<CharT>(inline_buffer,INLINE_SIZE){}
+
+        ~FormatBuffer() override
+        {
+            if(this->buffer!=inline_buffer)
+                array_free(this->buffer);
+        }
+
+        NO_COPY_NO_MOVE(FormatBuffer)
+
+        size_t GetCapacity()const{return size_t(this->end-this->buffer);}
+
+        /**
+         * 以0结尾的字符串
+         */
+        const CharT *c_str()
+        {
+            this->Terminate();
+            return this->buffer;
+        }
+
+        std::basic_string_view<CharT> GetView()const
+        {
+            return std::basic_string_view<CharT>(this->buffer,this->GetLength());
+        }
+    };//template<typename CharT,size_t INLINE_SIZE=256> class FormatBuffer
+
+    namespace format_detail
+    {
+        template<typename CharT>
+        inline void AppendAscii(FormatSink<CharT> &out,const char *str,const size_t n)
+        {
+            if constexpr(sizeof(CharT)==1)
+                out.Append(reinterpret_cast<const CharT *>(str),n);
+            else
+                for(size_t i=0;i<n;i++)
+                    out.Append(CharT(str[i]));
+        }
+
+        template<typename CharT>
+        inline void AppendLiteral(FormatSink<CharT> &out,const CharT *str,const FormatSegment &seg)
+        {
+            const CharT *p=str+seg.offset;
+
+            if(!seg.escaped)
+            {
+                out.Append(p,seg.length);
+                return;
+            }
+
+            const CharT *e=p+seg.length;
+
+            while(p<e)
+            {
+                out.Append(*p);
+
+                p+=(*p=='{'||*p=='}')?2:1;
+            }
+        }
+
+        /**
+         * 按宽度与对齐输出 prefix+body，zero_pad时在prefix与body之间补0
+         */
+        template<typename CharT>
+        void WritePadded(FormatSink<CharT> &out,const FormatSpec<CharT> &spec,const char default_align,
+                         const CharT *prefix,const size_t prefix_len,
+                         const CharT *body,const size_t body_len,const bool zero_pad)
+        {
+            const size_t total=prefix_len+body_len;
+            const size_t pad=spec.width>total?spec.width-total:0;
+
+            if(pad==0)
+            {
+                out.Append(prefix,prefix_len);
+                out.Append(body,body_len);
+                return;
+            }
+
+            if(zero_pad)
+            {
+                out.Append(prefix,prefix_len);
+                out.Fill(CharT('0'),pad);
+                out.Append(body,body_len);
+                return;
+            }
+
+            const char align=spec.align?spec.align:default_align;
+            const size_t left=(align=='>')?pad:(align=='^'?pad/2:0);
+
+            out.Fill(spec.fill,left);
+            out.Append(prefix,prefix_len);
+            out.Append(body,body_len);
+            out.Fill(spec.fill,pad-left);
+        }
+
+        template<typename CharT>
+        void FormatInteger(FormatSink<CharT> &out,const FormatSpec<CharT> &spec,const uint64 abs_value,const bool negative)
+        {
+            CharT prefix[4];
+            size_t prefix_len=0;
+
+            if(negative)
+                prefix[prefix_len++]=CharT('-');
+            else if(spec.sign)
+                prefix[prefix_len++]=CharT(spec.sign);
+
+            unsigned int base=10;
+
+            switch(spec.type)
+            {
+                case 'x':case 'X':  base=16;break;
+                case 'o':           base=8; break;
+                case 'b':case 'B':  base=2; break;
+            }
+
+            if(spec.alternate&&base!=10)
+            {
+                prefix[prefix_len++]=CharT('0');
+
+                if(base==16)    prefix[prefix_len++]=CharT(spec.type);
+                if(base==2)     prefix[prefix_len++]=CharT(spec.type);
+            }
+
+            CharT digits[sizeof(uint64)*8+1];
+
+            if(base==10)
+                hgl::utos(digits,int(sizeof(digits)/sizeof(CharT)),abs_value);
+            else
+                hgl::utos(digits,int(sizeof(digits)/sizeof(CharT)),abs_value,base,spec.type=='X');
+
+            WritePadded(out,spec,'>',prefix,prefix_len,digits,size_t(hgl::strlen(digits)),spec.zero_pad&&!spec.align);
+        }
+
+        /**
+         * 无格式说明的十进制整数直接写入输出缓冲区
+         */
+        template<typename CharT,typename IntT>
+        inline void FormatDecimal(FormatSink<CharT> &out,const IntT value)
+        {
+            constexpr int MAX_LENGTH=21;                        //-9223372036854775808
+
+            CharT *p=out.Reserve(MAX_LENGTH+1);
+
+            if(p)
+            {
+                if constexpr(std::is_signed_v<IntT>)
+                    out.Commit(size_t(hgl::itos_rl(p,MAX_LENGTH+1,value)));
+                else
+                    out.Commit(size_t(hgl::strlen(hgl::utos(p,MAX_LENGTH+1,value))));
+
+                return;
+            }
+
+            CharT tmp[MAX_LENGTH+1];
+
+            if constexpr(std::is_signed_v<IntT>)
+                out.Append(tmp,size_t(hgl::itos_rl(tmp,MAX_LENGTH+1,value)));
+            else
+                out.Append(tmp,size_t(hgl::strlen(hgl::utos(tmp,MAX_LENGTH+1,value))));
+        }
+
+        template<typename CharT,typename FloatT>
+        void FormatFloat(FormatSink<CharT> &out,const FormatSpec<CharT> &spec,FloatT value)
+        {
+            const bool negative=std::signbit(value);
+
+            if(negative)
+                value=-value;
+
+            char text[512];                                     //定点输出最大1e308加100位小数
+            std::to_chars_result r;
+
+            const char t=spec.type;
+            const int precision=spec.precision>=0?spec.precision:6;
+
+            if(t=='f'||t=='F')          r=std::to_chars(text,text+sizeof(text),value,std::chars_format::fixed,precision);
+            else if(t=='e'||t=='E')     r=std::to_chars(text,text+sizeof(text),value,std::chars_format::scientific,precision);
+            else if(t=='g'||t=='G')     r=std::to_chars(text,text+sizeof(text),value,std::chars_format::general,precision);
+            else if(spec.precision>=0)  r=std::to_chars(text,text+sizeof(text),value,std::chars_format::general,precision);
+            else                        r=std::to_chars(text,text+sizeof(text),value);          //最短往返表示
+
+            const size_t len=size_t(r.ptr-text);
+
+            if(t=='F'||t=='E'||t=='G')
+                for(size_t i=0;i<len;i++)
+                    if(text[i]>='a'&&text[i]<='z')
+                        text[i]=char(text[i]-'a'+'A');
+
+            CharT prefix[1];
+            size_t prefix_len=0;
+
+            if(negative)
+                prefix[prefix_len++]=CharT('-');
+            else if(spec.sign)
+                prefix[prefix_len++]=CharT(spec.sign);
+
+            const bool zero_pad=spec.zero_pad&&!spec.align&&std::isfinite(value);
+
+            if constexpr(sizeof(CharT)==1)
+            {
+                WritePadded(out,spec,'>',prefix,prefix_len,reinterpret_cast<const CharT *>(text),len,zero_pad);
+            }
+            else
+            {
+                CharT wide[sizeof(text)];
+
+                for(size_t i=0;i<len;i++)
+                    wide[i]=CharT(text[i]);
+
+                WritePadded(out,spec,'>',prefix,prefix_len,wide,len,zero_pad);
+            }
+        }
+
+        template<typename CharT>
+        void FormatValue(FormatSink<CharT> &out,const FormatSpec<CharT> &spec,const FormatArg<CharT> &arg)
+        {
+            const bool plain=(spec.width==0&&spec.sign==0&&!spec.alternate&&spec.precision<0);
+
+            switch(arg.type)
+            {
+                case FormatArgType::Int:
+                    if(plain&&(spec.type==0||spec.type=='d'))
+                        FormatDecimal(out,arg.i);
+                    else
+                        FormatInteger(out,spec,arg.i<0?uint64(0)-uint64(arg.i):uint64(arg.i),arg.i<0);
+                    break;
+
+                case FormatArgType::UInt:
+                    if(plain&&(spec.type==0||spec.type=='d'))
+                        FormatDecimal(out,arg.u);
+                    else
+                        FormatInteger(out,spec,arg.u,false);
+                    break;
+
+                case FormatArgType::Char:
+                    if(IsIntegerType(spec.type))
+                        FormatInteger(out,spec,uint64(std::make_unsigned_t<CharT>(arg.c)),false);
+                    else
+                        WritePadded(out,spec,'<',&arg.c,0,&arg.c,1,false);
+                    break;
+
+                case FormatArgType::Bool:
+                    if(IsIntegerType(spec.type))
+                    {
+                        FormatInteger(out,spec,arg.b?1:0,false);
+                    }
+                    else
+                    {
+                        const CharT text[]={CharT('t'),CharT('r'),CharT('u'),CharT('e'),CharT('f'),CharT('a'),CharT('l'),CharT('s'),CharT('e')};
+
+                        if(arg.b)
+                            WritePadded(out,spec,'<',text,0,text,4,false);
+                        else
+                            WritePadded(out,spec,'<',text,0,text+4,5,false);
+                    }
+                    break;
+
+                case FormatArgType::Float:
+                    FormatFloat(out,spec,arg.f);
+                    break;
+
+                case FormatArgType::Double:
+                    FormatFloat(out,spec,arg.d);
+                    break;
+
+                case FormatArgType::String:
+                {
+                    size_t len=arg.s.length;
+
+                    if(spec.precision>=0&&size_t(spec.precision)<len)
+                        len=size_t(spec.precision);
+
+                    if(spec.width==0)
+                        out.Append(arg.s.str,len);
+                    else
+                        WritePadded(out,spec,'<',arg.s.str,0,arg.s.str,len,false);
+                    break;
+                }
+
+                case FormatArgType::Pointer:
+                {
+                    const CharT prefix[]={CharT('0'),CharT('x')};
+                    CharT digits[sizeof(std::uintptr_t)*2+1];
+
+                    hgl::utos(digits,int(sizeof(digits)/sizeof(CharT)),reinterpret_cast<std::uintptr_t>(arg.p),16,false);
+
+                    WritePadded(out,spec,'>',prefix,2,digits,size_t(hgl::strlen(digits)),false);
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+
+        /**
+         * 运行时格式化主循环，只与CharT相关，各种参数组合共用
+         */
+        template<typename CharT>
+        void VFormat(FormatSink<CharT> &out,const FormatView<CharT> &fv,const FormatArg<CharT> *args)
+        {
+            for(size_t i=0;i<fv.count;i++)
+            {
+                AppendLiteral(out,fv.str,fv.literal[i]);
+                FormatValue(out,fv.spec[i],args[i]);
+            }
+
+            AppendLiteral(out,fv.str,fv.literal[fv.count]);
+        }
+
+        template<typename CharT,typename ...Args>
+        inline void Format(FormatSink<CharT> &out,const FormatView<CharT> &fv,const Args &...args)
+        {
+            const FormatArg<CharT> arg_list[sizeof...(Args)+1]={MakeFormatArg<CharT>(args)...};
+
+            VFormat(out,fv,arg_list);
+        }
+    }//namespace format_detail
+
+    /**
+     * 格式化到固定缓冲区，总是以0结尾
+     * @param buffer    输出缓冲区
+     * @param size      缓冲区可容纳的字符数（含结尾0）
+     * @return 写入的字符数（不含结尾0），缓冲区不足时返回-1（已写入截断的内容）
+     */
+    template<typename CharT,typename ...Args>
+    inline int strfmt(CharT *buffer,const int size,FormatString<CharT,Args...> fmt,const Args &...args)
+    {
+        if(!buffer||size<=0)
+            return(-1);
+
+        FormatSink<CharT> out(buffer,size_t(size));
+
+        format_detail::Format(out,fmt.GetView(),args...);
+        out.Terminate();
+
+        return out.IsTruncated()?-1:int(out.GetLength());
+    }
+
+    /**
+     * 追加格式化结果到输出目标（如FormatBuffer）
+     */
+    template<typename CharT,typename ...Args>
+    inline void strfmt(FormatSink<CharT> &out,FormatString<CharT,Args...> fmt,const Args &...args)
+    {
+        format_detail::Format(out,fmt.GetView(),args...);
+    }
+
+    /**
+     * 计算格式化结果的长度（不含结尾0）
+     */
+    template<typename CharT=char,typename ...Args>
+    inline size_t strfmt_length(FormatString<CharT,Args...> fmt,const Args &...args)
+    {
+        FormatSink<CharT> out(nullptr,0);
+
+        format_detail::Format(out,fmt.GetView(),args...);
+
+        return out.GetTotalLength();
+    }
+}//namespace hgl
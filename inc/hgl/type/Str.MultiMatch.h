@@ -0,0 +1,775 @@
+﻿#pragma once
+#include <hgl/type/Str.Length.h>
+#include <hgl/platform/CpuFeature.h>
+#include <hgl/type/HashMap.h>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace hgl
+{
+    /**
+     * @brief CN: 多模式匹配引擎。
+     * @brief EN: Multi-pattern matching engine.
+     */
+    enum class MultiMatchEngine
+    {
+        Auto,               ///<自动选择（仅作为Build参数）
+        AhoCorasick,        ///<Aho-Corasick 确定自动机，适用于任意数量的模式
+        TeddySSSE3,         ///<Teddy SIMD 预筛选（每次16字节）+ 逐模式校验，仅单字节字符且模式较少时可用
+        TeddyAVX2,          ///<Teddy SIMD 预筛选（每次32字节）+ 逐模式校验
+
+        BEGIN_RANGE =Auto,
+        END_RANGE   =TeddyAVX2,
+        RANGE_SIZE  =END_RANGE-BEGIN_RANGE+1
+    };//enum class MultiMatchEngine
+
+    /**
+     * @brief CN: 一次匹配结果。
+     * @brief EN: A single match.
+     */
+    struct MultiMatchResult
+    {
+        std::size_t start;  ///<匹配起点（字符）
+        uint32 length;      ///<匹配长度（字符）
+        int pattern;        ///<模式在构建列表中的序号
+    };//struct MultiMatchResult
+
+    namespace multi_match_detail
+    {
+        constexpr int TEDDY_MAX_PATTERNS    =64;    ///<超过此数量时每个桶的模式太多，校验开销过大
+        constexpr int TEDDY_AUTO_PATTERNS   =24;    ///<自动选择时使用Teddy的最大模式数量（更多时Aho-Corasick更快）
+        constexpr int TEDDY_BUCKETS         =8;
+        constexpr int TEDDY_MAX_FINGERPRINT =3;     ///<参与预筛选的模式前缀字符数
+
+        /**
+         * Teddy 半字节查找表：lo[k][n]/hi[k][n] 的第b位表示第b个桶中有模式在第k个字符的低/高4位为n。
+         * 两个128位通道内容相同，可直接用于AVX2。
+         */
+        struct alignas(32) TeddyMasks
+        {
+            uint8 lo[TEDDY_MAX_FINGERPRINT][32];
+            uint8 hi[TEDDY_MAX_FINGERPRINT][32];
+            int n;                                  ///<实际使用的前缀字符数(1-3)
+
+            uint8 Lookup(const uint8 *p) const
+            {
+                uint8 m = 0xFF;
+
+                for(int k = 0; k < n; ++k)
+                    m &= lo[k][p[k] & 0x0F] & hi[k][p[k] >> 4];
+
+                return m;
+            }
+        };
+
+#ifdef HGL_SIMD_X86
+        /**
+         * 从pos开始每次检查16字节，返回第一个含候选位置的块起点（bits为块内候选位置，res为各位置的桶掩码），
+         * 没有候选时返回大于limit的值。要求 limit+15+n-1 < 文本长度。
+         */
+        HGL_TARGET_ISA("ssse3")
+        inline std::size_t TeddyFindSSSE3(const TeddyMasks &m, const uint8 *text, std::size_t pos, const std::size_t limit, uint32 &bits, uint8 *res)
+        {
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            const __m128i zero = _mm_setzero_si128();
+
+            for(; pos <= limit; pos += 16)
+            {
+                __m128i r = _mm_set1_epi8(char(0xFF));
+
+                for(int k = 0; k < m.n; ++k)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + pos + k));
+                    const __m128i l = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(m.lo[k])), _mm_and_si128(v, nibble));
+                    const __m128i h = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(m.hi[k])), _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+
+                    r = _mm_and_si128(r, _mm_and_si128(l, h));
+                }
+
+                const uint32 found = uint32(~_mm_movemask_epi8(_mm_cmpeq_epi8(r, zero))) & 0xFFFFu;
+
+                if(found)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(res), r);
+                    bits = found;
+                    return pos;
+                }
+            }
+
+            return pos;
+        }
+
+        /**
+         * 同 TeddyFindSSSE3，每次检查32字节。要求 limit+31+n-1 < 文本长度。
+         */
+        HGL_TARGET_ISA("avx2")
+        inline std::size_t TeddyFindAVX2(const TeddyMasks &m, const uint8 *text, std::size_t pos, const std::size_t limit, uint32 &bits, uint8 *res)
+        {
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+            const __m256i zero = _mm256_setzero_si256();
+
+            for(; pos <= limit; pos += 32)
+            {
+                __m256i r = _mm256_set1_epi8(char(0xFF));
+
+                for(int k = 0; k < m.n; ++k)
+                {
+                    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + pos + k));
+                    const __m256i l = _mm256_shuffle_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(m.lo[k])), _mm256_and_si256(v, nibble));
+                    const __m256i h = _mm256_shuffle_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(m.hi[k])), _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+
+                    r = _mm256_and_si256(r, _mm256_and_si256(l, h));
+                }
+
+                const uint32 found = ~uint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(r, zero)));
+
+                if(found)
+                {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(res), r);
+                    bits = found;
+                    return pos;
+                }
+            }
+
+            return pos;
+        }
+#endif//HGL_SIMD_X86
+    }//namespace multi_match_detail
+
+    /**
+     * @brief CN: 编译后的多模式字符串匹配器。
+     * @brief EN: Compiled multi-pattern string matcher.
+     *
+     * CN: 由一组模式构建一次，之后可在任意文本中报告所有模式的所有出现位置（含重叠），
+     *     以及对整个字符串做精确查找（类似 find_str_in_array，但与模式数量无关）。
+     *     <ul>
+     *      <li>Aho-Corasick：字符先压缩为字符类，再构建完整的确定自动机（每个字符一次查表），匹配状态集中编号在表尾，内循环只有一次比较</li>
+     *      <li>Teddy：单字节字符、模式不超过64个时，用SIMD半字节查表按模式前1-3个字符筛出候选位置，再逐个校验同桶的模式</li>
+     *     </ul>
+     *     忽略大小写仅针对ASCII英文字母，与 stricmp 一致。默认区分大小写，
+     *     要得到与 find_str_in_array（stricmp比较）相同的结果，构建时须传入 icase=true。
+     * EN: Build once from a pattern list, then report every (possibly overlapping) occurrence in a buffer.
+     *     Case folding covers ASCII letters only, matching stricmp. Matching is case-sensitive by default;
+     *     build with icase=true to get the stricmp comparison of find_str_in_array.
+     *
+     * @tparam CharT 字符类型。EN: character type.
+     */
+    template<typename CharT>
+    class MultiStringMatcher
+    {
+        using UChar = std::make_unsigned_t<CharT>;
+
+        bool ignore_case = false;
+        MultiMatchEngine engine = MultiMatchEngine::AhoCorasick;
+
+        int list_count = 0;                             ///<构建列表的长度（含跳过的空模式）
+        int pattern_count = 0;                          ///<有效模式数量
+
+        std::vector<CharT> pattern_text;                ///<所有模式（忽略大小写时已转为小写）
+        std::vector<uint32> pattern_offset;             ///<按列表序号索引
+        std::vector<uint32> pattern_length;             ///<按列表序号索引，0表示该项被跳过
+
+        uint32 byte_class[256] = {};                    ///<字符 -> 字符类，0表示不出现在任何模式中
+        HashMap<uint32, uint32> wide_class;             ///<大于255的字符
+        uint32 class_count = 1;
+
+        std::vector<uint32> next;                       ///<DFA转移表，值为目标状态的行起点（状态号*class_count）
+        uint32 match_row = 0;                           ///<行起点不小于此值的状态有输出
+        std::vector<uint32> out_begin;                  ///<匹配状态的输出区间（按 状态号-首个匹配状态号 索引）
+        std::vector<int> out_ids;
+        std::vector<int> exact;                         ///<恰好以该状态结束的模式（列表中第一个），-1表示没有
+        uint32 state_count = 0;
+
+        multi_match_detail::TeddyMasks teddy{};
+        std::vector<int> bucket_ids[multi_match_detail::TEDDY_BUCKETS];
+
+    private:
+
+        uint32 Fold(const uint32 u) const
+        {
+            return (ignore_case && u >= 'A' && u <= 'Z') ? u + 32 : u;
+        }
+
+        uint32 ClassOf(const CharT ch) const
+        {
+            const uint32 u = uint32(UChar(ch));
+
+            if constexpr(sizeof(CharT) == 1)
+                return byte_class[u];
+            else
+            {
+                if(u < 256)
+                    return byte_class[u];
+
+                const auto it = wide_class.find(u);
+                return it == wide_class.end() ? 0 : it->second;
+            }
+        }
+
+        bool EqualAt(const CharT *text, const int id) const
+        {
+            const CharT *pat = pattern_text.data() + pattern_offset[id];
+            const uint32 len = pattern_length[id];
+
+            if(!ignore_case)
+                return std::memcmp(text, pat, len * sizeof(CharT)) == 0;
+
+            for(uint32 i = 0; i < len; ++i)
+                if(Fold(uint32(UChar(text[i]))) != uint32(UChar(pat[i])))
+                    return false;
+
+            return true;
+        }
+
+        template<typename F>
+        static bool Emit(F &func, const MultiMatchResult &r)
+        {
+            if constexpr(std::is_void_v<std::invoke_result_t<F &, const MultiMatchResult &>>)
+            {
+                func(r);
+                return true;
+            }
+            else
+                return bool(func(r));
+        }
+
+        bool BuildAutomaton()
+        {
+            //1.字符类
+            for(int i = 0; i < list_count; ++i)
+            {
+                const CharT *pat = pattern_text.data() + pattern_offset[i];
+
+                for(uint32 k = 0; k < pattern_length[i]; ++k)
+                {
+                    const uint32 u = uint32(UChar(pat[k]));
+
+                    if(u < 256)
+                    {
+                        if(!byte_class[u])
+                            byte_class[u] = class_count++;
+                    }
+                    else if(wide_class.try_emplace(u, class_count).second)
+                        ++class_count;
+                }
+            }
+
+            if(ignore_case)
+                for(uint32 c = 'A'; c <= 'Z'; ++c)
+                    byte_class[c] = byte_class[c + 32];
+
+            //2.Trie（0为根，转移值0表示没有子节点）
+            const std::size_t cc = class_count;
+            std::vector<uint32> go(cc, 0);
+            std::vector<std::vector<int>> outs(1);
+            exact.assign(1, -1);
+
+            for(int i = 0; i < list_count; ++i)
+            {
+                if(!pattern_length[i]) continue;
+
+                const CharT *pat = pattern_text.data() + pattern_offset[i];
+                uint32 s = 0;
+
+                for(uint32 k = 0; k < pattern_length[i]; ++k)
+                {
+                    const uint32 c = ClassOf(pat[k]);
+                    uint32 t = go[s * cc + c];
+
+                    if(!t)
+                    {
+                        t = uint32(outs.size());
+                        go[s * cc + c] = t;
+                        go.resize(go.size() + cc, 0);
+                        outs.emplace_back();
+                        exact.push_back(-1);
+                    }
+
+                    s = t;
+                }
+
+                if(exact[s] < 0)
+                    exact[s] = i;
+
+                outs[s].push_back(i);
+            }
+
+            state_count = uint32(outs.size());
+
+            if(uint64(state_count) * cc > 0xFFFFFFFFull)
+                return false;
+
+            //3.按广度优先补全失败转移，合并输出
+            std::vector<uint32> fail(state_count, 0);
+            std::vector<uint32> order;
+            order.reserve(state_count);
+
+            for(std::size_t c = 0; c < cc; ++c)
+                if(go[c])
+                    order.push_back(go[c]);
+
+            for(std::size_t qi = 0; qi < order.size(); ++qi)
+            {
+                const uint32 s = order[qi];
+                const uint32 f = fail[s];
+
+                if(!outs[f].empty())
+                    outs[s].insert(outs[s].end(), outs[f].begin(), outs[f].end());
+
+                for(std::size_t c = 0; c < cc; ++c)
+                {
+                    const uint32 t = go[s * cc + c];
+
+                    if(t)
+                    {
+                        fail[t] = go[f * cc + c];
+                        order.push_back(t);
+                    }
+                    else
+                        go[s * cc + c] = go[f * cc + c];
+                }
+            }
+
+            //4.重新编号：无输出的状态在前（根仍为0），扫描时只需比较行起点
+            std::vector<uint32> remap(state_count);
+            uint32 id = 0;
+
+            for(uint32 s = 0; s < state_count; ++s)
+                if(outs[s].empty())
+                    remap[s] = id++;
+
+            const uint32 first_match = id;
+
+            for(uint32 s = 0; s < state_count; ++s)
+                if(!outs[s].empty())
+                    remap[s] = id++;
+
+            match_row = uint32(first_match * cc);
+            next.resize(go.size());
+
+            std::vector<int> exact_remap(state_count);
+            std::vector<uint32> match_states(state_count - first_match);
+
+            for(uint32 s = 0; s < state_count; ++s)
+            {
+                const std::size_t row = std::size_t(remap[s]) * cc;
+
+                for(std::size_t c = 0; c < cc; ++c)
+                    next[row + c] = uint32(remap[go[s * cc + c]] * cc);
+
+                exact_remap[remap[s]] = exact[s];
+
+                if(remap[s] >= first_match)
+                    match_states[remap[s] - first_match] = s;
+            }
+
+            exact.swap(exact_remap);
+
+            out_begin.resize(match_states.size() + 1);
+            out_begin[0] = 0;
+
+            for(std::size_t m = 0; m < match_states.size(); ++m)
+            {
+                const std::vector<int> &o = outs[match_states[m]];
+
+                out_ids.insert(out_ids.end(), o.begin(), o.end());
+                out_begin[m + 1] = uint32(out_ids.size());
+            }
+
+            return true;
+        }
+
+        void BuildTeddy()
+        {
+            using namespace multi_match_detail;
+
+            int min_len = 0x7FFFFFFF;
+            std::vector<int> ids;
+
+            for(int i = 0; i < list_count; ++i)
+                if(pattern_length[i])
+                {
+                    ids.push_back(i);
+                    min_len = std::min(min_len, int(pattern_length[i]));
+                }
+
+            teddy.n = std::min(min_len, TEDDY_MAX_FINGERPRINT);
+
+            //前缀相近的模式放进同一个桶，减少误报
+            std::sort(ids.begin(), ids.end(), [this](const int a, const int b)
+            {
+                return std::memcmp(pattern_text.data() + pattern_offset[a], pattern_text.data() + pattern_offset[b], std::size_t(teddy.n)) < 0;
+            });
+
+            const std::size_t buckets = std::min<std::size_t>(TEDDY_BUCKETS, ids.size());
+
+            for(std::size_t i = 0; i < ids.size(); ++i)
+            {
+                const std::size_t b = i * buckets / ids.size();
+                const uint8 *pat = reinterpret_cast<const uint8 *>(pattern_text.data() + pattern_offset[ids[i]]);
+
+                bucket_ids[b].push_back(ids[i]);
+
+                for(int k = 0; k < teddy.n; ++k)
+                {
+                    uint8 variants[2] = {pat[k], pat[k]};
+
+                    if(ignore_case && pat[k] >= 'a' && pat[k] <= 'z')
+                        variants[1] = uint8(pat[k] - 32);
+
+                    for(const uint8 c : variants)
+                    {
+                        teddy.lo[k][c & 0x0F] |= uint8(1u << b);
+                        teddy.hi[k][c >> 4] |= uint8(1u << b);
+                    }
+                }
+            }
+
+            for(int k = 0; k < teddy.n; ++k)
+            {
+                std::memcpy(teddy.lo[k] + 16, teddy.lo[k], 16);
+                std::memcpy(teddy.hi[k] + 16, teddy.hi[k], 16);
+            }
+        }
+
+        template<typename F>
+        bool ScanAhoCorasick(const CharT *text, const std::size_t length, F &func) const
+        {
+            const uint32 *table = next.data();
+            const uint32 cc = class_count;
+            uint32 row = 0;
+
+            for(std::size_t i = 0; i < length; ++i)
+            {
+                row = table[row + ClassOf(text[i])];
+
+                if(row >= match_row)
+                {
+                    const uint32 m = (row - match_row) / cc;
+
+                    for(uint32 k = out_begin[m]; k < out_begin[m + 1]; ++k)
+                    {
+                        const int id = out_ids[k];
+
+                        if(!Emit(func, MultiMatchResult{i + 1 - pattern_length[id], pattern_length[id], id}))
+                            return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        template<typename F>
+        bool ScanTeddy(const CharT *text, const std::size_t length, F &func) const
+        {
+            const uint8 *p = reinterpret_cast<const uint8 *>(text);
+            const std::size_t n = std::size_t(teddy.n);
+
+            auto verify = [&](const std::size_t pos, uint32 buckets) -> bool
+            {
+                while(buckets)
+                {
+                    const int b = std::countr_zero(buckets);
+                    buckets &= buckets - 1;
+
+                    for(const int id : bucket_ids[b])
+                    {
+                        const uint32 len = pattern_length[id];
+
+                        if(pos + len <= length && EqualAt(text + pos, id))
+                            if(!Emit(func, MultiMatchResult{pos, len, id}))
+                                return false;
+                    }
+                }
+
+                return true;
+            };
+
+            std::size_t pos = 0;
+
+#ifdef HGL_SIMD_X86
+            const std::size_t width = (engine == MultiMatchEngine::TeddyAVX2) ? 32 : 16;
+
+            if(length >= width + n - 1)
+            {
+                const std::size_t limit = length - width - (n - 1);        ///<最后一个完整块的起点
+                alignas(32) uint8 res[32];
+                uint32 bits = 0;
+
+                auto find = [&](const std::size_t from, const std::size_t to) -> std::size_t
+                {
+                    return (width == 32) ? multi_match_detail::TeddyFindAVX2(teddy, p, from, to, bits, res)
+                                         : multi_match_detail::TeddyFindSSSE3(teddy, p, from, to, bits, res);
+                };
+
+                auto report = [&](const std::size_t block) -> bool
+                {
+                    while(bits)
+                    {
+                        const int j = std::countr_zero(bits);
+                        bits &= bits - 1;
+
+                        if(!verify(block + j, res[j]))
+                            return false;
+                    }
+
+                    return true;
+                };
+
+                while(pos <= limit)
+                {
+                    const std::size_t block = find(pos, limit);
+
+                    if(block > limit)
+                    {
+                        pos = block;
+                        break;
+                    }
+
+                    if(!report(block))
+                        return false;
+
+                    pos = block + width;
+                }
+
+                //剩余不足一块：重新检查最后一个完整块，屏蔽已检查过的位置
+                if(pos < limit + width && find(limit, limit) == limit)
+                {
+                    bits &= uint32(~((uint64(1) << (pos - limit)) - 1));
+
+                    if(!report(limit))
+                        return false;
+                }
+
+                pos = length;
+            }
+#endif//HGL_SIMD_X86
+
+            for(; pos + n <= length; ++pos)
+            {
+                const uint8 m = teddy.Lookup(p + pos);
+
+                if(m && !verify(pos, m))
+                    return false;
+            }
+
+            return true;
+        }
+
+    public:
+
+        MultiStringMatcher() = default;
+
+        /**
+         * @brief CN: 清除所有模式。EN: Remove all patterns.
+         */
+        void Clear()
+        {
+            ignore_case = false;
+            engine = MultiMatchEngine::AhoCorasick;
+            list_count = pattern_count = 0;
+            pattern_text.clear();
+            pattern_offset.clear();
+            pattern_length.clear();
+            std::fill(std::begin(byte_class), std::end(byte_class), 0u);
+            wide_class.clear();
+            class_count = 1;
+            next.clear();
+            match_row = 0;
+            out_begin.clear();
+            out_ids.clear();
+            exact.clear();
+            state_count = 0;
+            teddy = {};
+            for(auto &b : bucket_ids) b.clear();
+        }
+
+        /**
+         * @brief CN: 由指定数量的字符串数组构建匹配器。
+         * @brief EN: Build the matcher from an array of strings.
+         *
+         * @param[in] count CN: 数组中元素数量. EN: number of elements in array.
+         * @param[in] list CN: 字符串数组，nullptr或空字符串会被跳过（序号仍保留）. EN: string array; nullptr/empty entries are skipped but keep their index.
+         * @param[in] icase CN: 是否忽略ASCII字母大小写. EN: ignore ASCII letter case.
+         * @param[in] prefer CN: 指定引擎，不可用时退回Aho-Corasick. EN: preferred engine; falls back to Aho-Corasick when unavailable.
+         * @return bool CN/EN: 至少有一个有效模式时返回 true。EN: true if at least one non-empty pattern.
+         */
+        bool Build(const int count, const CharT **list, const bool icase = false, const MultiMatchEngine prefer = MultiMatchEngine::Auto)
+        {
+            Clear();
+
+            if(count <= 0 || !list) return false;
+
+            ignore_case = icase;
+            list_count = count;
+            pattern_offset.resize(count);
+            pattern_length.resize(count);
+
+            for(int i = 0; i < count; ++i)
+            {
+                const int len = hgl::strlen(list[i]);
+
+                pattern_offset[i] = uint32(pattern_text.size());
+                pattern_length[i] = uint32(len);
+
+                for(int k = 0; k < len; ++k)
+                    pattern_text.push_back(CharT(Fold(uint32(UChar(list[i][k])))));
+
+                if(len > 0) ++pattern_count;
+            }
+
+            if(!pattern_count || !BuildAutomaton())
+            {
+                Clear();
+                return false;
+            }
+
+#ifdef HGL_SIMD_X86
+            if constexpr(sizeof(CharT) == 1)
+            {
+                const int max_patterns = (prefer == MultiMatchEngine::Auto) ? multi_match_detail::TEDDY_AUTO_PATTERNS
+                                                                            : multi_match_detail::TEDDY_MAX_PATTERNS;
+
+                if(prefer != MultiMatchEngine::AhoCorasick && pattern_count <= max_patterns)
+                {
+                    const bool avx2 = GetCpuFeature().avx2;
+                    const bool ssse3 = GetCpuFeature().ssse3;
+
+                    if(avx2 && prefer != MultiMatchEngine::TeddySSSE3)
+                        engine = MultiMatchEngine::TeddyAVX2;
+                    else if(ssse3)
+                        engine = MultiMatchEngine::TeddySSSE3;
+
+                    if(engine != MultiMatchEngine::AhoCorasick)
+                        BuildTeddy();
+                }
+            }
+#else
+            (void)prefer;
+#endif//HGL_SIMD_X86
+
+            return true;
+        }
+
+        /**
+         * @brief CN: 由以 null 结尾的字符串列表构建（遇到 nullptr 或空字符串结束，与 find_str_in_array 相同）。
+         * @brief EN: Build from a null-terminated list (stops at nullptr or an empty string, like find_str_in_array).
+         */
+        bool Build(const CharT **list, const bool icase = false, const MultiMatchEngine prefer = MultiMatchEngine::Auto)
+        {
+            if(!list) return false;
+
+            int count = 0;
+            while(list[count] && list[count][0])
+                ++count;
+
+            return Build(count, list, icase, prefer);
+        }
+
+        bool IsIgnoreCase() const { return ignore_case; }
+        MultiMatchEngine GetEngine() const { return engine; }
+        int GetPatternCount() const { return pattern_count; }
+        uint32 GetStateCount() const { return state_count; }
+        uint32 GetClassCount() const { return class_count; }
+
+        /**
+         * @brief CN: 扫描文本并报告所有匹配（含重叠）。
+         * @brief EN: Scan a buffer and report every match, overlaps included.
+         *
+         * CN: Aho-Corasick 按匹配结束位置递增报告，Teddy 按起点递增报告；需要固定顺序时使用 FindAll。
+         *
+         * @param[in] text CN: 文本. EN: text buffer.
+         * @param[in] length CN: 文本长度（字符）. EN: length in characters.
+         * @param[in] func CN: 回调 func(const MultiMatchResult &)，返回 false 时停止扫描. EN: callback; returning false stops the scan.
+         * @return bool CN/EN: 扫描完整结束返回 true，被回调中止返回 false。EN: false if stopped by the callback.
+         */
+        template<typename F>
+        bool Scan(const CharT *text, const std::size_t length, F &&func) const
+        {
+            if(!text || !length || !pattern_count) return true;
+
+            if(engine == MultiMatchEngine::AhoCorasick)
+                return ScanAhoCorasick(text, length, func);
+
+            return ScanTeddy(text, length, func);
+        }
+
+        /**
+         * @brief CN: 文本中是否出现任一模式（找到第一个即返回）。EN: Whether any pattern occurs in the text.
+         */
+        bool Contains(const CharT *text, const std::size_t length) const
+        {
+            return !Scan(text, length, [](const MultiMatchResult &) { return false; });
+        }
+
+        /**
+         * @brief CN: 统计匹配次数（含重叠）。EN: Count matches, overlaps included.
+         */
+        std::size_t Count(const CharT *text, const std::size_t length) const
+        {
+            std::size_t total = 0;
+            Scan(text, length, [&total](const MultiMatchResult &) { ++total; });
+            return total;
+        }
+
+        /**
+         * @brief CN: 取得所有匹配，按起点、模式序号排序。EN: Collect all matches sorted by start then pattern index.
+         * @return std::size_t CN/EN: 匹配数量。EN: number of matches.
+         */
+        std::size_t FindAll(const CharT *text, const std::size_t length, std::vector<MultiMatchResult> &result) const
+        {
+            result.clear();
+            Scan(text, length, [&result](const MultiMatchResult &r) { result.push_back(r); });
+
+            std::sort(result.begin(), result.end(), [](const MultiMatchResult &a, const MultiMatchResult &b)
+            {
+                return a.start != b.start ? a.start < b.start : a.pattern < b.pattern;
+            });
+
+            return result.size();
+        }
+
+        /**
+         * @brief CN: 精确查找整个字符串是哪一个模式，耗时只与字符串长度有关。
+         * @brief EN: Find which pattern equals the whole string; cost depends only on the string length.
+         *
+         * CN: 是否区分大小写由构建时的 icase 决定；find_str_in_array 使用 stricmp，替换它时应以 icase=true 构建。
+         * EN: Case sensitivity follows the icase passed to Build(); find_str_in_array uses stricmp,
+         *     so build with icase=true when replacing it.
+         *
+         * @param[in] str CN: 要查找的字符串. EN: string to look up.
+         * @param[in] str_len CN: 字符串长度，0 表示按实际长度. EN: length; 0 means use strlen.
+         * @return int CN/EN: 列表中第一个相等模式的序号，未找到返回 -1。EN: index of the first equal pattern or -1.
+         */
+        int Match(const CharT *str, int str_len = 0) const
+        {
+            if(!str || !pattern_count) return -1;
+
+            if(str_len <= 0)
+                str_len = hgl::strlen(str);
+
+            if(str_len <= 0) return -1;
+
+            const uint32 *table = next.data();
+            uint32 row = 0;
+
+            for(int i = 0; i < str_len; ++i)
+            {
+                const uint32 c = ClassOf(str[i]);
+
+                if(!c) return -1;
+
+                row = table[row + c];
+            }
+
+            const int id = exact[row / class_count];
+
+            return (id >= 0 && pattern_length[id] == uint32(str_len)) ? id : -1;
+        }
+    };//class MultiStringMatcher
+}//namespace hgl
@@ -0,0 +1,431 @@
+﻿#pragma once
+
+#include<hgl/platform/Platform.h>
+#include<hgl/type/HashMap.h>
+#include<atomic>
+#include<mutex>
+#include<shared_mutex>
+#include<memory>
+#include<vector>
+#include<string_view>
+#include<cstring>
+#include<bit>
+
+namespace hgl
+{
+    /**
+     * 驻留字符串句柄<br>
+     * CN:32位，同一个池中内容相同的字符串句柄必然相同，比较句柄即比较字符串（O(1)）。
+     *    0为空句柄，对应空字符串。不同池产生的句柄不可混用。
+     * EN:32-bit id; equal strings interned in the same pool always get the same handle.
+     *    0 is the null handle and stands for the empty string.
+     */
+    struct StringHandle
+    {
+        uint32 id=0;
+
+        constexpr bool IsValid()const{return id!=0;}
+        constexpr explicit operator bool()const{return id!=0;}
+
+        constexpr bool operator==(const StringHandle &)const=default;
+        constexpr auto operator<=>(const StringHandle &)const=default;
+    };//struct StringHandle
+
+    template<> struct OptimalHash<StringHandle>:OptimalHash<uint32>
+    {
+        uint64 operator()(const StringHandle &h)const noexcept{return OptimalHash<uint32>::operator()(h.id);}
+    };
+
+    /**
+     * StringPool 内存统计
+     */
+    struct StringPoolStats
+    {
+        int64 string_count;     ///<已驻留字符串数量（不含空字符串）
+        int64 char_bytes;       ///<字符串内容字节数（不含结尾0）
+        int64 arena_used;       ///<arena中已使用的字节数（含条目头与对齐）
+        int64 arena_reserved;   ///<arena已申请的字节数
+        int64 arena_blocks;     ///<arena块数量
+        int64 index_bytes;      ///<句柄表与查找表占用的字节数
+        int64 shard_count;      ///<分片数量
+    };//struct StringPoolStats
+
+    namespace string_pool_detail
+    {
+        /**
+         * 条目头，字符串内容紧随其后（以0结尾）
+         */
+        struct alignas(8) EntryHeader
+        {
+            uint64 hash;
+            uint32 length;
+            uint32 reserved;
+        };
+
+        template<typename CharT>
+        struct Key
+        {
+            const CharT *str;
+            uint32 length;
+            uint64 hash;
+        };
+
+        /**
+         * 直接使用已缓存的哈希，查找时不再重新计算
+         */
+        template<typename CharT>
+        struct KeyHash
+        {
+            using is_avalanching=void;
+
+            uint64 operator()(const Key<CharT> &k)const noexcept{return k.hash;}
+        };
+
+        template<typename CharT>
+        struct KeyEqual
+        {
+            bool operator()(const Key<CharT> &a,const Key<CharT> &b)const noexcept
+            {
+                return a.hash==b.hash
+                    &&a.length==b.length
+                    &&std::memcmp(a.str,b.str,a.length*sizeof(CharT))==0;
+            }
+        };
+
+        constexpr uint32 FIRST_PAGE_BITS=10;                    ///<第一页1024个条目，之后每页容量翻倍
+        constexpr uint32 MAX_PAGES      =32-FIRST_PAGE_BITS;
+
+        /**
+         * 返回局部序号所在的页与页内偏移
+         */
+        inline void LocatePage(uint32 local,uint32 &page,uint32 &offset)
+        {
+            const uint64 n=uint64(local)+(uint64(1)<<FIRST_PAGE_BITS);
+            const uint32 top=uint32(std::bit_width(n))-1;
+
+            page=top-FIRST_PAGE_BITS;
+            offset=uint32(n-(uint64(1)<<top));
+        }
+    }//namespace string_pool_detail
+
+    /**
+     * 线程安全的字符串驻留池<br>
+     * <ul>
+     *  <li>字符串内容存放在每个分片自己的arena中，驻留后地址不再变化，直到池销毁</li>
+     *  <li>哈希（wyhash，与 ComputeOptimalHash 相同）在驻留时计算一次并与字符串一起保存</li>
+     *  <li>按哈希把字符串分到 2^SHARD_BITS 个分片，每个分片一把读写锁，已存在字符串的Intern只取读锁</li>
+     *  <li>句柄到字符串/哈希/长度的解析不加锁：条目指针保存在只增长、不搬移的分页表中</li>
+     * </ul>
+     * 跨线程传递句柄时需要经过正常的同步（如队列、锁），否则读取方可能看不到条目内容。
+     *
+     * @tparam CharT 字符类型
+     * @tparam SHARD_BITS 分片数量的位数（默认16个分片）
+     */
+    template<typename CharT,uint32 SHARD_BITS=4>
+    class StringPool
+    {
+        static_assert(SHARD_BITS<=8,"StringPool: too many shards");
+
+    public:
+
+        using StringView=std::basic_string_view<CharT>;
+
+        static constexpr uint32 SHARD_COUNT     =1u<<SHARD_BITS;
+        static constexpr uint32 MAX_PER_SHARD   =uint32((uint64(0xFFFFFFFFu)>>SHARD_BITS));     ///<单个分片最多可驻留的字符串数量
+
+    private:
+
+        using Header=string_pool_detail::EntryHeader;
+        using Key   =string_pool_detail::Key<CharT>;
+        using Table =ankerl::unordered_dense::map<Key,uint32,string_pool_detail::KeyHash<CharT>,string_pool_detail::KeyEqual<CharT>>;
+
+        struct alignas(64) Shard
+        {
+            mutable std::shared_mutex lock;
+
+            Table table;                                                        ///<字符串 -> 局部序号
+
+            std::atomic<std::atomic<const Header *> *> pages[string_pool_detail::MAX_PAGES]={};   ///<局部序号 -> 条目（无锁读取）
+            uint32 count=0;
+
+            std::vector<std::unique_ptr<uint8[]>> blocks;                       ///<arena块
+            uint8 *cur=nullptr;
+            size_t remain=0;
+
+            int64 char_bytes=0;
+            int64 arena_used=0;
+            int64 arena_reserved=0;
+
+            ~Shard()
+            {
+                for(auto &p:pages)
+                    delete[] p.load(std::memory_order_relaxed);
+            }
+        };
+
+        const size_t block_size;
+
+        std::unique_ptr<Shard[]> shards;
+
+    private:
+
+        static constexpr uint32 ShardIndex(uint64 hash)
+        {
+            //ankerl用高位选桶、低8位作指纹，分片取中间的位避免与二者相关
+            return uint32(hash>>32)&(SHARD_COUNT-1);
+        }
+
+        static constexpr uint32 MakeId(uint32 shard,uint32 local){return ((local<<SHARD_BITS)|shard)+1;}
+
+        const Header *Resolve(StringHandle h)const
+        {
+            if(!h.id)
+                return nullptr;
+
+            const uint32 v=h.id-1;
+            const Shard &s=shards[v&(SHARD_COUNT-1)];
+
+            uint32 page,offset;
+            string_pool_detail::LocatePage(v>>SHARD_BITS,page,offset);
+
+            if(page>=string_pool_detail::MAX_PAGES)                     //不可能由本池产生的句柄
+                return nullptr;
+
+            const std::atomic<const Header *> *p=s.pages[page].load(std::memory_order_acquire);
+
+            return p?p[offset].load(std::memory_order_acquire):nullptr;
+        }
+
+        /**
+         * 在分片的arena中分配一个条目（调用者持有写锁）
+         */
+        Header *Allocate(Shard &s,uint32 length)
+        {
+            const size_t need=(sizeof(Header)+(size_t(length)+1)*sizeof(CharT)+alignof(Header)-1)&~(alignof(Header)-1);
+
+            if(need>s.remain)
+            {
+                //大字符串单独一块，不浪费当前块剩余空间
+                const size_t size=need>block_size/4?need:block_size;
+
+                s.blocks.emplace_back(new uint8[size]);
+                s.arena_reserved+=int64(size);
+
+                if(size==need)
+                {
+                    s.arena_used+=int64(need);
+                    return reinterpret_cast<Header *>(s.blocks.back().get());
+                }
+
+                s.cur=s.blocks.back().get();
+                s.remain=size;
+            }
+
+            Header *e=reinterpret_cast<Header *>(s.cur);
+
+            s.cur+=need;
+            s.remain-=need;
+            s.arena_used+=int64(need);
+            return e;
+        }
+
+        void Publish(Shard &s,uint32 local,const Header *e)
+        {
+            uint32 page,offset;
+            string_pool_detail::LocatePage(local,page,offset);
+
+            std::atomic<const Header *> *p=s.pages[page].load(std::memory_order_relaxed);
+
+            if(!p)
+            {
+                const size_t page_size=size_t(1)<<(page+string_pool_detail::FIRST_PAGE_BITS);
+
+                p=new std::atomic<const Header *>[page_size];
+
+                for(size_t i=0;i<page_size;i++)
+                    p[i].store(nullptr,std::memory_order_relaxed);
+
+                s.pages[page].store(p,std::memory_order_release);
+            }
+
+            p[offset].store(e,std::memory_order_release);
+        }
+
+    public:
+
+        /**
+         * @param arena_block_size 每个分片arena块的大小
+         */
+        explicit StringPool(size_t arena_block_size=64*1024)
+            :block_size(arena_block_size<1024?1024:arena_block_size)
+            ,shards(new Shard[SHARD_COUNT])
+        {
+        }
+
+        ~StringPool()=default;
+
+        NO_COPY_NO_MOVE(StringPool)
+
+        /**
+         * 驻留一个字符串，已存在则返回原有句柄
+         * @param str 字符串（可不以0结尾）
+         * @param length 字符数
+         * @return 句柄，空字符串返回空句柄；分片已满时也返回空句柄
+         */
+        StringHandle Intern(const CharT *str,const size_t length)
+        {
+            if(!str||!length||length>0xFFFFFFFFu)
+                return {};
+
+            const Key key{str,uint32(length),ComputeOptimalHash(str,length*sizeof(CharT))};
+            const uint32 si=ShardIndex(key.hash);
+            Shard &s=shards[si];
+
+            {
+                std::shared_lock<std::shared_mutex> rl(s.lock);
+
+                const auto it=s.table.find(key);
+
+                if(it!=s.table.end())
+                    return {MakeId(si,it->second)};
+            }
+
+            std::unique_lock<std::shared_mutex> wl(s.lock);
+
+            {
+                const auto it=s.table.find(key);            //取写锁期间可能已被其它线程插入
+
+                if(it!=s.table.end())
+                    return {MakeId(si,it->second)};
+            }
+
+            if(s.count>=MAX_PER_SHARD)
+                return {};
+
+            Header *e=Allocate(s,key.length);
+            CharT *text=reinterpret_cast<CharT *>(e+1);
+
+            e->hash=key.hash;
+            e->length=key.length;
+            e->reserved=0;
+            std::memcpy(text,str,length*sizeof(CharT));
+            text[length]=0;
+
+            const uint32 local=s.count;
+
+            Publish(s,local,e);
+            s.table.emplace(Key{text,key.length,key.hash},local);
+
+            ++s.count;
+            s.char_bytes+=int64(length*sizeof(CharT));
+
+            return {MakeId(si,local)};
+        }
+
+        StringHandle Intern(const StringView &str){return Intern(str.data(),str.size());}
+        StringHandle Intern(const CharT *str){return str?Intern(str,std::char_traits<CharT>::length(str)):StringHandle{};}
+
+        /**
+         * 查找一个字符串是否已驻留，不会插入
+         * @return 句柄，未找到返回空句柄
+         */
+        StringHandle Find(const StringView &str)const
+        {
+            if(str.empty()||str.size()>0xFFFFFFFFu)
+                return {};
+
+            const Key key{str.data(),uint32(str.size()),ComputeOptimalHash(str.data(),str.size()*sizeof(CharT))};
+            const uint32 si=ShardIndex(key.hash);
+            const Shard &s=shards[si];
+
+            std::shared_lock<std::shared_mutex> rl(s.lock);
+
+            const auto it=s.table.find(key);
+
+            return it==s.table.end()?StringHandle{}:StringHandle{MakeId(si,it->second)};
+        }
+
+        /**
+         * 取得字符串内容（无锁）
+         */
+        StringView Get(StringHandle h)const
+        {
+            const Header *e=Resolve(h);
+
+            return e?StringView(reinterpret_cast<const CharT *>(e+1),e->length):StringView();
+        }
+
+        /**
+         * 取得以0结尾的字符串（无锁），空句柄返回空串而不是nullptr
+         */
+        const CharT *c_str(StringHandle h)const
+        {
+            static constexpr CharT empty[1]={};
+
+            const Header *e=Resolve(h);
+
+            return e?reinterpret_cast<const CharT *>(e+1):empty;
+        }
+
+        /**
+         * 取得驻留时计算的哈希（无锁），与 ComputeOptimalHash(str,length*sizeof(CharT)) 相同；空或无效句柄返回0
+         */
+        uint64 GetHash(StringHandle h)const
+        {
+            const Header *e=Resolve(h);
+
+            return e?e->hash:0;
+        }
+
+        uint32 GetLength(StringHandle h)const
+        {
+            const Header *e=Resolve(h);
+
+            return e?e->length:0;
+        }
+
+        /**
+         * 已驻留字符串数量
+         */
+        int64 GetCount()const
+        {
+            int64 total=0;
+
+            for(uint32 i=0;i<SHARD_COUNT;i++)
+            {
+                std::shared_lock<std::shared_mutex> rl(shards[i].lock);
+                total+=shards[i].count;
+            }
+
+            return total;
+        }
+
+        StringPoolStats GetStats()const
+        {
+            StringPoolStats st{};
+
+            st.shard_count=SHARD_COUNT;
+
+            for(uint32 i=0;i<SHARD_COUNT;i++)
+            {
+                const Shard &s=shards[i];
+                std::shared_lock<std::shared_mutex> rl(s.lock);
+
+                st.string_count     +=s.count;
+                st.char_bytes       +=s.char_bytes;
+                st.arena_used       +=s.arena_used;
+                st.arena_reserved   +=s.arena_reserved;
+                st.arena_blocks     +=int64(s.blocks.size());
+
+                for(uint32 p=0;p<string_pool_detail::MAX_PAGES;p++)
+                    if(s.pages[p].load(std::memory_order_relaxed))
+                        st.index_bytes+=int64(sizeof(void *))<<(p+string_pool_detail::FIRST_PAGE_BITS);
+
+                st.index_bytes+=int64(s.table.values().capacity()*sizeof(typename Table::value_type))
+                               +int64(s.table.bucket_count()*sizeof(typename Table::bucket_type));
+            }
+
+            return st;
+        }
+    };//class StringPool
+}//namespace hgl
@@ -6,20 +6,69 @@
 
 namespace hgl
 {
-    template<typename T>
+    /**
+     * CN:整数/枚举/指针哈希的混合方式
+     * EN:How integers, enums and pointers are mixed into a hash value
+     */
+    enum class HashMixPolicy
+    {
+        Identity=0,     ///<CN:直接使用原值（仅适用于自己再做取模/混合的容器） EN:raw value, only for containers that mix on their own
+        WyMix,          ///<CN:王一Hash的wyhash64，两次128位乘法折叠 EN:wyhash64, two 128-bit multiply-folds
+        Murmur,         ///<CN:MurmurHash3 fmix64终结器，两次乘法 EN:MurmurHash3 fmix64 finalizer, two multiplications
+
+        BEGIN_RANGE =Identity,
+        END_RANGE   =Murmur,
+        RANGE_SIZE  =END_RANGE-BEGIN_RANGE+1
+    };//enum class HashMixPolicy
+
+    /**
+     * CN:将64位整数混合为雪崩良好的哈希值
+     * EN:Mix a 64-bit integer into a well-avalanched hash value
+     */
+    template<HashMixPolicy Policy=HashMixPolicy::WyMix>
+    constexpr uint64 HashMix64(uint64 value)
+    {
+        if constexpr(Policy==HashMixPolicy::WyMix)
+        {
+            // CN:单次_wymix与常数相乘时，低位输出与高位输入无关，雪崩不足，所以使用两轮的wyhash64
+            // EN:a single _wymix against a constant leaves the low output bits blind to the high input bits
+            return wyhash64(value,_wyp[2]);
+        }
+        else if constexpr(Policy==HashMixPolicy::Murmur)
+        {
+            value^=value>>33;
+            value*=0xff51afd7ed558ccdull;
+            value^=value>>33;
+            value*=0xc4ceb9fe1a85ec53ull;
+            value^=value>>33;
+            return value;
+        }
+        else
+        {
+            return value;
+        }
+    }
+
+    /**
+     * CN:计算哈希值。整数/枚举/指针按Policy混合，默认WyMix；
+     *    顺序ID与对齐地址直接作为哈希会在开放寻址表中严重聚集，只有确定容器自己会混合时才用Identity。
+     * EN:Integers, enums and pointers are mixed according to Policy (WyMix by default);
+     *    use Identity only when the container applies its own mixing.
+     */
+    template<HashMixPolicy Policy=HashMixPolicy::WyMix,typename T>
     inline uint64 ComputeOptimalHash(const T& value)
     {
         if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
         {
-            // CN:整数/枚举类型：直接转换（零开销）
-            // EN:Integer/enum types: direct conversion (zero overhead)
-            return static_cast<uint64>(value);
+            // CN:整数/枚举类型：转换后混合
+            // EN:Integer/enum types: convert then mix
+            return HashMix64<Policy>(static_cast<uint64>(value));
         }
         else if constexpr (std::is_pointer_v<T>)
         {
-            // CN:指针类型：使用地址作为哈希
-            // EN:Pointer types: use address as hash
-            return reinterpret_cast<uint64>(value);
+            // CN:指针类型：地址混合后作为哈希（对齐地址的低位恒为0）
+            // EN:Pointer types: mixed address (low bits of aligned addresses are always zero)
+            return HashMix64<Policy>(reinterpret_cast<uint64>(value));
         }
         else
         {
@@ -0,0 +1,522 @@
+﻿#include<hgl/benchmark/Benchmark.h>
+#include<algorithm>
+#include<memory>
+#include<cmath>
+#include<cstring>
+#include<ctime>
+#include<stdio.h>
+#include<stdlib.h>
+
+#ifdef __linux__
+#include<unistd.h>
+#include<sys/syscall.h>
+#include<linux/perf_event.h>
+#endif//__linux__
+
+namespace hgl
+{
+    /**
+     * CPU性能计数器（Linux perf_event_open），打开失败时各项读数为0
+     */
+    class BenchmarkPerfCounters
+    {
+        int fds[BenchmarkState::PERF_COUNTER_COUNT];
+
+    public:
+
+        BenchmarkPerfCounters()
+        {
+            for(int &fd:fds)
+                fd=-1;
+
+#ifdef __linux__
+            const uint64 configs[BenchmarkState::PERF_COUNTER_COUNT]=
+            {
+                PERF_COUNT_HW_CPU_CYCLES,
+                PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_BRANCH_MISSES
+            };
+
+            for(int i=0;i<BenchmarkState::PERF_COUNTER_COUNT;i++)
+            {
+                perf_event_attr attr;
+
+                memset(&attr,0,sizeof(attr));
+                attr.size=sizeof(attr);
+                attr.type=PERF_TYPE_HARDWARE;
+                attr.config=configs[i];
+                attr.exclude_kernel=1;
+                attr.exclude_hv=1;
+
+                fds[i]=int(syscall(SYS_perf_event_open,&attr,0,-1,-1,0));   //当前线程、任意CPU
+            }
+#endif//__linux__
+        }
+
+        ~BenchmarkPerfCounters()
+        {
+#ifdef __linux__
+            for(int fd:fds)
+                if(fd>=0)
+                    close(fd);
+#endif//__linux__
+        }
+
+        NO_COPY_NO_MOVE(BenchmarkPerfCounters)
+
+        bool Has(const int index)const{return fds[index]>=0;}
+
+        void Read(uint64 *values)const
+        {
+            for(int i=0;i<BenchmarkState::PERF_COUNTER_COUNT;i++)
+            {
+                values[i]=0;
+
+#ifdef __linux__
+                if(fds[i]>=0&&read(fds[i],values+i,sizeof(uint64))!=sizeof(uint64))
+                    values[i]=0;
+#endif//__linux__
+            }
+        }
+    };//class BenchmarkPerfCounters
+
+    void BenchmarkState::ResumeTiming()
+    {
+        if(running)
+            return;
+
+        running=true;
+
+        if(perf)
+            perf->Read(perf_start);
+
+        start_ticks=TscClock::Now();
+    }
+
+    void BenchmarkState::PauseTiming()
+    {
+        if(!running)
+            return;
+
+        const uint64 now=TscClock::Now();
+
+        elapsed_ticks+=now-start_ticks;
+
+        if(perf)
+        {
+            uint64 v[PERF_COUNTER_COUNT];
+
+            perf->Read(v);
+
+            for(int i=0;i<PERF_COUNTER_COUNT;i++)
+                perf_elapsed[i]+=v[i]-perf_start[i];
+        }
+
+        running=false;
+    }
+
+    namespace
+    {
+        constexpr uint64 MAX_ITERATIONS=1000000000;
+
+        std::vector<std::unique_ptr<BenchmarkInfo>> &GetRegistry()
+        {
+            static std::vector<std::unique_ptr<BenchmarkInfo>> registry;
+
+            return registry;
+        }
+
+        double Median(std::vector<double> v)
+        {
+            std::sort(v.begin(),v.end());
+
+            const size_t n=v.size();
+
+            return n%2?v[n/2]:(v[n/2-1]+v[n/2])/2;
+        }
+
+        void AppendJsonString(std::string &out,const std::string &str)
+        {
+            out+='"';
+
+            for(const char ch:str)
+            {
+                const unsigned char c=(unsigned char)ch;
+
+                if(c=='"'||c=='\\')
+                {
+                    out+='\\';
+                    out+=ch;
+                }
+                else if(c<0x20)
+                {
+                    char buf[8];
+
+                    snprintf(buf,sizeof(buf),"\\u%04x",c);
+                    out+=buf;
+                }
+                else
+                    out+=ch;
+            }
+
+            out+='"';
+        }
+
+        void AppendJsonNumber(std::string &out,const char *key,const double value)
+        {
+            char buf[64];
+
+            snprintf(buf,sizeof(buf),",\"%s\":%.6g",key,std::isfinite(value)?value:0.0);
+            out+=buf;
+        }
+
+        void AppendJsonInt(std::string &out,const char *key,const uint64 value)
+        {
+            char buf[64];
+
+            snprintf(buf,sizeof(buf),",\"%s\":%llu",key,(unsigned long long)value);
+            out+=buf;
+        }
+
+        /**
+         * 吞吐量显示为 "12.3 GB/s" 或 "45.6 M/s"
+         */
+        std::string FormatRate(double value,const char *unit)
+        {
+            static const char *prefix[]={"","K","M","G","T"};
+
+            int i=0;
+
+            while(value>=1000&&i<4)
+            {
+                value/=1000;
+                ++i;
+            }
+
+            char buf[32];
+
+            snprintf(buf,sizeof(buf),"%.3g %s%s/s",value,prefix[i],unit);
+            return buf;
+        }
+
+        void PrintUsage()
+        {
+            printf("options:\n"
+                   "  --filter=<substr>     run benchmarks whose name contains substr\n"
+                   "  --min_time=<ms>       target duration of one run (default 50)\n"
+                   "  --repetitions=<n>     runs per benchmark (default 5)\n"
+                   "  --json=<file>         also write results as JSON\n"
+                   "  --no_perf             do not read CPU performance counters\n"
+                   "  --large               also run arguments marked with LargeArgs()\n"
+                   "  --list                list benchmark names only\n");
+        }
+    }//namespace
+
+    BenchmarkInfo *RegisterBenchmark(const char *name,BenchmarkFunc func)
+    {
+        auto &registry=GetRegistry();
+
+        registry.push_back(std::make_unique<BenchmarkInfo>(name,func));
+
+        return registry.back().get();
+    }
+
+    bool BenchmarkRunner::ParseArgs(int argc,char **argv)
+    {
+        for(int i=1;i<argc;i++)
+        {
+            const char *a=argv[i];
+
+            auto value_of=[a](const char *key)->const char *
+            {
+                const size_t len=strlen(key);
+
+                return strncmp(a,key,len)==0?a+len:nullptr;
+            };
+
+            const char *v;
+
+            if((v=value_of("--filter=")))               config.filter=v;
+            else if((v=value_of("--min_time=")))        config.min_time_ms=atof(v);
+            else if((v=value_of("--repetitions=")))     config.repetitions=atoi(v);
+            else if((v=value_of("--json=")))            config.json_file=v;
+            else if(strcmp(a,"--no_perf")==0)           config.use_perf=false;
+            else if(strcmp(a,"--list")==0)              config.list_only=true;
+            else if(strcmp(a,"--large")==0)             config.large=true;
+            else
+                return(false);
+        }
+
+        if(config.min_time_ms<=0)config.min_time_ms=50;
+        if(config.repetitions<1)config.repetitions=1;
+
+        return(true);
+    }
+
+    BenchmarkResult BenchmarkRunner::Run(const BenchmarkInfo *info,const std::string &name,const int64 arg,BenchmarkPerfCounters *perf)
+    {
+        const double target_ns=config.min_time_ms*1e6;
+
+        //预热并确定迭代次数：每次按上一次的耗时估算，最多放大100倍
+        uint64 n=1;
+
+        for(;;)
+        {
+            BenchmarkState state(n,arg,nullptr);
+
+            info->func(state);
+            state.PauseTiming();
+
+            const double ns=double(TscClock::ToNanoseconds(state.elapsed_ticks));
+
+            if(ns>=target_ns*0.5||n>=MAX_ITERATIONS)
+            {
+                if(ns>0)
+                    n=uint64(std::clamp(double(n)*target_ns/ns,1.0,double(MAX_ITERATIONS)));
+
+                break;
+            }
+
+            const double scale=ns>0?std::clamp(target_ns*1.2/ns,2.0,100.0):100.0;
+
+            n=std::min<uint64>(uint64(double(n)*scale),MAX_ITERATIONS);
+        }
+
+        BenchmarkResult r{};
+
+        r.name=name;
+        r.iterations=n;
+        r.repetitions=config.repetitions;
+
+        std::vector<double> per_iter;
+        uint64 total_ticks=0;
+        uint64 perf_total[BenchmarkState::PERF_COUNTER_COUNT]={};
+        uint64 bytes=0,items=0;
+
+        for(int rep=0;rep<config.repetitions;rep++)
+        {
+            BenchmarkState state(n,arg,perf);
+
+            info->func(state);
+            state.PauseTiming();
+
+            per_iter.push_back(double(TscClock::ToNanoseconds(state.elapsed_ticks))/double(n));
+            total_ticks+=state.elapsed_ticks;
+
+            for(int i=0;i<BenchmarkState::PERF_COUNTER_COUNT;i++)
+                perf_total[i]+=state.perf_elapsed[i];
+
+            bytes=state.bytes_per_iteration;
+            items=state.items_per_iteration;
+            r.label=state.label;
+        }
+
+        std::vector<double> dev;
+
+        r.median_ns=Median(per_iter);
+
+        for(double v:per_iter)
+            dev.push_back(std::fabs(v-r.median_ns));
+
+        r.mad_ns=Median(dev);
+        r.min_ns=*std::min_element(per_iter.begin(),per_iter.end());
+
+        double sum=0;
+        for(double v:per_iter)sum+=v;
+        r.mean_ns=sum/double(per_iter.size());
+
+        if(r.median_ns>0)
+        {
+            r.bytes_per_second=double(bytes)*1e9/r.median_ns;
+            r.items_per_second=double(items)*1e9/r.median_ns;
+        }
+
+        const double total_iter=double(n)*double(config.repetitions);
+
+        r.hardware_cycles=perf&&perf->Has(0)&&perf_total[0]>0;
+
+        if(r.hardware_cycles)
+            r.cycles_per_iteration=double(perf_total[0])/total_iter;
+        else if(TscClock::IsHardware())
+            r.cycles_per_iteration=double(total_ticks)/total_iter;
+
+        if(bytes)
+            r.cycles_per_byte=r.cycles_per_iteration/double(bytes);
+
+        r.instructions_per_iteration=double(perf_total[1])/total_iter;
+        r.branch_misses_per_iteration=double(perf_total[2])/total_iter;
+
+        return r;
+    }
+
+    std::vector<BenchmarkResult> BenchmarkRunner::RunAll()
+    {
+        std::vector<BenchmarkResult> results;
+
+        std::unique_ptr<BenchmarkPerfCounters> perf;
+
+        if(config.use_perf&&!config.list_only)
+        {
+            perf=std::make_unique<BenchmarkPerfCounters>();
+
+            if(!perf->Has(0))
+                perf.reset();
+        }
+
+        if(!config.list_only)
+        {
+            printf("TSC %s, %.3f GHz; perf counters %s\n",
+                   TscClock::IsHardware()?"on":"off",
+                   1.0/TscClock::NanosecondsPerTick(),
+                   perf?"on":"off (cycles are TSC reference cycles)");
+
+            printf("%-44s %12s %12s %8s %12s %14s %9s %6s\n","benchmark","iterations","median ns","MAD","min ns","throughput","cycles/B","IPC");
+        }
+
+        for(const auto &info:GetRegistry())
+        {
+            std::vector<int64> args=info->args;
+
+            if(args.empty())
+                args.push_back(0);
+
+            for(const int64 arg:args)
+            {
+                if(!config.large&&info->large_arg>0&&arg>=info->large_arg)
+                    continue;
+
+                std::string name=info->name;
+
+                if(!info->args.empty())
+                    name+="/"+std::to_string(arg);
+
+                if(!config.filter.empty()&&name.find(config.filter)==std::string::npos)
+                    continue;
+
+                if(config.list_only)
+                {
+                    printf("%s\n",name.c_str());
+                    continue;
+                }
+
+                const BenchmarkResult r=Run(info.get(),name,arg,perf.get());
+
+                std::string rate;
+
+                if(r.bytes_per_second>0)
+                    rate=FormatRate(r.bytes_per_second,"B");
+                else if(r.items_per_second>0)
+                    rate=FormatRate(r.items_per_second,"");
+
+                char cpb[32]="",ipc[32]="";
+
+                if(r.cycles_per_byte>0)
+                    snprintf(cpb,sizeof(cpb),"%.3f",r.cycles_per_byte);
+
+                if(r.instructions_per_iteration>0&&r.hardware_cycles)
+                    snprintf(ipc,sizeof(ipc),"%.2f",r.instructions_per_iteration/r.cycles_per_iteration);
+
+                printf("%-44s %12llu %12.2f %7.1f%% %12.2f %14s %9s %6s%s%s\n",
+                       r.name.c_str(),
+                       (unsigned long long)r.iterations,
+                       r.median_ns,
+                       r.median_ns>0?r.mad_ns*100/r.median_ns:0.0,
+                       r.min_ns,
+                       rate.c_str(),
+                       cpb,
+                       ipc,
+                       r.label.empty()?"":" ",
+                       r.label.c_str());
+
+                fflush(stdout);
+
+                results.push_back(r);
+            }
+        }
+
+        return results;
+    }
+
+    std::string BenchmarkRunner::ToJson(const std::vector<BenchmarkResult> &results)
+    {
+        std::string out;
+
+        char date[32]="";
+        const time_t now=time(nullptr);
+        strftime(date,sizeof(date),"%Y-%m-%dT%H:%M:%SZ",gmtime(&now));
+
+        out+="{\"context\":{\"date\":\"";
+        out+=date;
+        out+="\",\"tsc_hardware\":";
+        out+=TscClock::IsHardware()?"true":"false";
+        AppendJsonNumber(out,"tsc_ghz",1.0/TscClock::NanosecondsPerTick());
+        out+="},\n\"benchmarks\":[";
+
+        for(size_t i=0;i<results.size();i++)
+        {
+            const BenchmarkResult &r=results[i];
+
+            out+=i?",\n":"\n";
+            out+="{\"name\":";
+            AppendJsonString(out,r.name);
+
+            if(!r.label.empty())
+            {
+                out+=",\"label\":";
+                AppendJsonString(out,r.label);
+            }
+
+            AppendJsonInt(out,"iterations",r.iterations);
+            AppendJsonInt(out,"repetitions",uint64(r.repetitions));
+            AppendJsonNumber(out,"median_ns",r.median_ns);
+            AppendJsonNumber(out,"mad_ns",r.mad_ns);
+            AppendJsonNumber(out,"min_ns",r.min_ns);
+            AppendJsonNumber(out,"mean_ns",r.mean_ns);
+            AppendJsonNumber(out,"bytes_per_second",r.bytes_per_second);
+            AppendJsonNumber(out,"items_per_second",r.items_per_second);
+            out+=",\"hardware_cycles\":";
+            out+=r.hardware_cycles?"true":"false";
+            AppendJsonNumber(out,"cycles_per_iteration",r.cycles_per_iteration);
+            AppendJsonNumber(out,"cycles_per_byte",r.cycles_per_byte);
+            AppendJsonNumber(out,"instructions_per_iteration",r.instructions_per_iteration);
+            AppendJsonNumber(out,"branch_misses_per_iteration",r.branch_misses_per_iteration);
+            out+='}';
+        }
+
+        out+="\n]}\n";
+        return out;
+    }
+
+    int RunBenchmarks(int argc,char **argv)
+    {
+        BenchmarkRunner runner;
+
+        if(!runner.ParseArgs(argc,argv))
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const std::vector<BenchmarkResult> results=runner.RunAll();
+
+        if(!runner.GetConfig().json_file.empty())
+        {
+            const std::string json=BenchmarkRunner::ToJson(results);
+
+            FILE *fp=fopen(runner.GetConfig().json_file.c_str(),"wb");
+
+            if(!fp)
+            {
+                fprintf(stderr,"can't create %s\n",runner.GetConfig().json_file.c_str());
+                return 1;
+            }
+
+            const bool ok=fwrite(json.data(),1,json.size(),fp)==json.size();
+
+            if(fclose(fp)!=0||!ok)
+                return 1;
+        }
+
+        return 0;
+    }
+}//namespace hgl
@@ -0,0 +1,132 @@
+﻿#include<hgl/type/ByteSink.h>
+#include<sys/uio.h>
+#include<unistd.h>
+#include<limits.h>
+#include<fcntl.h>
+#include<errno.h>
+
+namespace hgl
+{
+    namespace
+    {
+    #ifdef IOV_MAX
+        constexpr int MAX_IOV=IOV_MAX;
+    #else
+        constexpr int MAX_IOV=1024;
+    #endif//IOV_MAX
+    }//namespace
+
+    FdByteSink::FdByteSink(int file_descriptor,bool close_fd)
+    {
+        fd=file_descriptor;
+        close_on_destroy=close_fd;
+
+        const off_t pos=(fd>=0)?lseek(fd,0,SEEK_CUR):off_t(-1);
+
+        //O_APPEND下Linux的pwrite会忽略偏移直接追加，不能用于回写
+        seekable=(pos>=0)&&!(fcntl(fd,F_GETFL)&O_APPEND);
+        base=seekable?int64(pos):0;
+    }
+
+    FdByteSink::~FdByteSink()
+    {
+        if(close_on_destroy&&fd>=0)
+            close(fd);
+    }
+
+    bool FdByteSink::Write(const ByteSinkSpan *spans,size_t count)
+    {
+        if(fd<0)
+            return false;
+
+        struct iovec iov[MAX_IOV<64?MAX_IOV:64];
+        constexpr size_t IOV_BATCH=sizeof(iov)/sizeof(iov[0]);
+
+        size_t index=0;                 //下一个尚未放入iov的span
+        size_t skip=0;                  //spans[index]中已写出的字节数
+
+        while(index<count)
+        {
+            size_t n=0;
+
+            for(size_t i=index;i<count&&n<IOV_BATCH;i++)
+            {
+                const size_t offset=(i==index)?skip:0;
+
+                if(spans[i].size<=offset)
+                    continue;
+
+                iov[n].iov_base=const_cast<uint8 *>(spans[i].data)+offset;
+                iov[n].iov_len=spans[i].size-offset;
+                ++n;
+            }
+
+            if(n==0)
+                break;
+
+            const ssize_t result=writev(fd,iov,int(n));
+
+            if(result<0)
+            {
+                if(errno==EINTR)
+                    continue;
+
+                return false;
+            }
+
+            if(result==0)                                               //没有任何进展，再试也一样
+                return false;
+
+            //跳过已完整写出的span，记录部分写出的位置
+            size_t written=size_t(result);
+
+            while(index<count)
+            {
+                const size_t left=spans[index].size-skip;
+
+                if(written<left)
+                {
+                    skip+=written;
+                    break;
+                }
+
+                written-=left;
+                skip=0;
+                ++index;
+            }
+        }
+
+        return true;
+    }
+
+    bool FdByteSink::Patch(uint64 offset,const void *data,size_t size)
+    {
+        if(!seekable)
+            return false;
+
+        const uint8 *p=static_cast<const uint8 *>(data);
+        off_t pos=off_t(base+int64(offset));
+
+        while(size>0)
+        {
+            const ssize_t result=pwrite(fd,p,size,pos);
+
+            if(result<0)
+            {
+                if(errno==EINTR)
+                    continue;
+
+                return false;
+            }
+
+            if(result==0)
+                return false;
+
+            p+=result;
+            pos+=result;
+            size-=size_t(result);
+        }
+
+        return true;
+    }
+}//namespace hgl
@@ -0,0 +1,345 @@
+﻿#include<hgl/type/MappedFile.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<errno.h>
+#include<stdlib.h>
+#include<utility>
+
+namespace hgl
+{
+    namespace
+    {
+        constexpr size_t HUGE_PAGE_SIZE=2*1024*1024;
+
+        int ToMadvise(MappedFileAdvice advice)
+        {
+            switch(advice)
+            {
+                case MappedFileAdvice::Sequential:  return MADV_SEQUENTIAL;
+                case MappedFileAdvice::Random:      return MADV_RANDOM;
+                case MappedFileAdvice::WillNeed:    return MADV_WILLNEED;
+                case MappedFileAdvice::DontNeed:    return MADV_DONTNEED;
+                default:                            return MADV_NORMAL;
+            }
+        }
+
+        int ToFadvise(MappedFileAdvice advice)
+        {
+            switch(advice)
+            {
+                case MappedFileAdvice::Sequential:  return POSIX_FADV_SEQUENTIAL;
+                case MappedFileAdvice::Random:      return POSIX_FADV_RANDOM;
+                case MappedFileAdvice::WillNeed:    return POSIX_FADV_WILLNEED;
+                case MappedFileAdvice::DontNeed:    return POSIX_FADV_DONTNEED;
+                default:                            return POSIX_FADV_NORMAL;
+            }
+        }
+
+        /**
+         * 预留一段按2MB对齐的地址空间，之后用MAP_FIXED把文件映射进来
+         */
+        void *ReserveHugeAligned(size_t length,void *&reserve_base,size_t &reserve_length)
+        {
+            reserve_length=length+HUGE_PAGE_SIZE;
+            reserve_base=mmap(nullptr,reserve_length,PROT_NONE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE,-1,0);
+
+            if(reserve_base==MAP_FAILED)
+            {
+                reserve_base=nullptr;
+                return nullptr;
+            }
+
+            const uintptr_t addr=reinterpret_cast<uintptr_t>(reserve_base);
+            const uintptr_t aligned=(addr+HUGE_PAGE_SIZE-1)&~uintptr_t(HUGE_PAGE_SIZE-1);
+
+            return reinterpret_cast<void *>(aligned);
+        }
+    }//namespace
+
+    MappedFile::MappedFile()
+    {
+        fd=-1;
+        data=nullptr;
+        size=0;
+        mode=MappedFileMode::None;
+        map_base=nullptr;
+        map_length=0;
+        buffer=nullptr;
+        buffer_capacity=0;
+        window_offset=0;
+        window_length=0;
+        read_chunk_size=0;
+        huge_buffer=false;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&mf)
+    {
+        fd          =std::exchange(mf.fd,-1);
+        data        =std::exchange(mf.data,nullptr);
+        size        =std::exchange(mf.size,0);
+        mode        =std::exchange(mf.mode,MappedFileMode::None);
+        map_base    =std::exchange(mf.map_base,nullptr);
+        map_length  =std::exchange(mf.map_length,0);
+        buffer      =std::exchange(mf.buffer,nullptr);
+        buffer_capacity =std::exchange(mf.buffer_capacity,0);
+        window_offset   =std::exchange(mf.window_offset,0);
+        window_length   =std::exchange(mf.window_length,0);
+        read_chunk_size =std::exchange(mf.read_chunk_size,0);
+        huge_buffer     =std::exchange(mf.huge_buffer,false);
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&mf)
+    {
+        if(this!=&mf)
+        {
+            Close();
+
+            fd          =std::exchange(mf.fd,-1);
+            data        =std::exchange(mf.data,nullptr);
+            size        =std::exchange(mf.size,0);
+            mode        =std::exchange(mf.mode,MappedFileMode::None);
+            map_base    =std::exchange(mf.map_base,nullptr);
+            map_length  =std::exchange(mf.map_length,0);
+            buffer      =std::exchange(mf.buffer,nullptr);
+            buffer_capacity =std::exchange(mf.buffer_capacity,0);
+            window_offset   =std::exchange(mf.window_offset,0);
+            window_length   =std::exchange(mf.window_length,0);
+            read_chunk_size =std::exchange(mf.read_chunk_size,0);
+            huge_buffer     =std::exchange(mf.huge_buffer,false);
+        }
+
+        return *this;
+    }
+
+    bool MappedFile::OpenMapped(const MappedFileConfig &config)
+    {
+        int flags=MAP_PRIVATE;
+
+    #ifdef MAP_POPULATE
+        if(config.populate)
+            flags|=MAP_POPULATE;
+    #endif//MAP_POPULATE
+
+        void *reserve_base=nullptr;
+        size_t reserve_length=0;
+        void *hint=nullptr;
+
+        if(config.huge_pages&&size>=HUGE_PAGE_SIZE)
+        {
+            hint=ReserveHugeAligned(size,reserve_base,reserve_length);
+
+            if(hint)
+                flags|=MAP_FIXED;
+        }
+
+        void *addr=mmap(hint,size,PROT_READ,flags,fd,0);
+
+        if(addr==MAP_FAILED)
+        {
+            if(reserve_base)
+                munmap(reserve_base,reserve_length);
+
+            return false;
+        }
+
+        if(reserve_base)
+        {
+            //归还对齐地址前后多预留的部分，只保留文件映射
+            const uintptr_t rb=reinterpret_cast<uintptr_t>(reserve_base);
+            const uintptr_t ab=reinterpret_cast<uintptr_t>(addr);
+            const size_t page=size_t(sysconf(_SC_PAGESIZE));
+            const uintptr_t map_end=(ab+size+page-1)&~uintptr_t(page-1);
+            const uintptr_t reserve_end=rb+reserve_length;
+
+            if(ab>rb)
+                munmap(reserve_base,ab-rb);
+
+            if(reserve_end>map_end)
+                munmap(reinterpret_cast<void *>(map_end),reserve_end-map_end);
+
+        #ifdef MADV_HUGEPAGE
+            madvise(addr,size,MADV_HUGEPAGE);
+        #endif//MADV_HUGEPAGE
+        }
+
+        map_base=addr;
+        map_length=size;
+        data=static_cast<const uint8 *>(addr);
+        mode=MappedFileMode::Mmap;
+
+        if(config.sequential)
+            madvise(addr,size,MADV_SEQUENTIAL);
+
+        if(config.will_need)
+            madvise(addr,size,MADV_WILLNEED);
+
+        return true;
+    }
+
+    bool MappedFile::OpenBuffered(const MappedFileConfig &config)
+    {
+        read_chunk_size=config.read_chunk_size;
+        huge_buffer=config.huge_pages;
+
+    #ifdef POSIX_FADV_SEQUENTIAL
+        if(config.sequential)
+            posix_fadvise(fd,0,0,POSIX_FADV_SEQUENTIAL);
+
+        if(config.will_need)
+            posix_fadvise(fd,0,0,POSIX_FADV_WILLNEED);
+    #endif//POSIX_FADV_SEQUENTIAL
+
+        data=nullptr;                                                   //不整体读入，由ReadWindow按需读取
+        mode=MappedFileMode::Buffered;
+        return true;
+    }
+
+    ByteSpanReader MappedFile::ReadWindow(size_t offset,size_t length)const
+    {
+        if(length==0)
+            return ByteSpanReader(nullptr,0);
+
+        if(offset>=window_offset&&offset+length<=window_offset+window_length)  //已在当前窗口内
+            return ByteSpanReader(buffer+(offset-window_offset),length);
+
+        window_length=0;
+
+        if(length>buffer_capacity)
+        {
+            const size_t alignment=(huge_buffer&&length>=HUGE_PAGE_SIZE)?HUGE_PAGE_SIZE:size_t(HGL_MEM_ALIGN);
+            const size_t alloc_size=(length+alignment-1)&~(alignment-1);
+
+            free(buffer);
+            buffer=static_cast<uint8 *>(aligned_alloc(alignment,alloc_size));
+
+            if(!buffer)
+            {
+                buffer_capacity=0;
+                return ByteSpanReader(nullptr,0);
+            }
+
+            buffer_capacity=alloc_size;
+
+        #ifdef MADV_HUGEPAGE
+            if(alignment==HUGE_PAGE_SIZE)
+                madvise(buffer,alloc_size,MADV_HUGEPAGE);
+        #endif//MADV_HUGEPAGE
+        }
+
+        const size_t chunk=read_chunk_size>0?read_chunk_size:length;
+        size_t pos=0;
+
+        while(pos<length)
+        {
+            const size_t want=(length-pos<chunk)?length-pos:chunk;
+            const ssize_t got=pread(fd,buffer+pos,want,off_t(offset+pos));
+
+            if(got<0)
+            {
+                if(errno==EINTR)
+                    continue;
+
+                break;
+            }
+
+            if(got==0)                                                  //文件在打开后被截断
+                break;
+
+            pos+=size_t(got);
+        }
+
+        window_offset=offset;
+        window_length=pos;
+
+        return ByteSpanReader(buffer,pos);
+    }
+
+    bool MappedFile::Open(const char *filename,const MappedFileConfig &config)
+    {
+        Close();
+
+        if(!filename||!*filename)
+            return false;
+
+        fd=open(filename,O_RDONLY|O_CLOEXEC);
+
+        if(fd<0)
+            return false;
+
+        struct stat st;
+
+        if(fstat(fd,&st)!=0||!S_ISREG(st.st_mode))
+        {
+            Close();
+            return false;
+        }
+
+        size=size_t(st.st_size);
+
+        if(size==0)                                                     //空文件无法映射，视为没有数据可读的Buffered模式
+        {
+            mode=MappedFileMode::Buffered;
+            return true;
+        }
+
+        if(!config.force_buffered&&OpenMapped(config))
+            return true;
+
+        if((config.allow_fallback||config.force_buffered)&&OpenBuffered(config))
+            return true;
+
+        Close();
+        return false;
+    }
+
+    void MappedFile::Close()
+    {
+        if(map_base)
+            munmap(map_base,map_length);
+
+        if(buffer)
+            free(buffer);
+
+        if(fd>=0)
+            close(fd);
+
+        fd=-1;
+        data=nullptr;
+        size=0;
+        mode=MappedFileMode::None;
+        map_base=nullptr;
+        map_length=0;
+        buffer=nullptr;
+        buffer_capacity=0;
+        window_offset=0;
+        window_length=0;
+    }
+
+    bool MappedFile::Advise(MappedFileAdvice advice,size_t offset,size_t length)
+    {
+        if(mode==MappedFileMode::None||offset>size)
+            return false;
+
+        if(length==0||length>size-offset)
+            length=size-offset;
+
+        if(mode==MappedFileMode::Buffered)
+            return posix_fadvise(fd,off_t(offset),off_t(length),ToFadvise(advice))==0;
+
+        //madvise要求起始地址按页对齐
+        const size_t page=size_t(sysconf(_SC_PAGESIZE));
+        const size_t aligned_offset=offset&~(page-1);
+
+        if(madvise(const_cast<uint8 *>(data)+aligned_offset,length+(offset-aligned_offset),ToMadvise(advice))==0)
+            return true;
+
+        return posix_fadvise(fd,off_t(offset),off_t(length),ToFadvise(advice))==0;
+    }
+}//namespace hgl
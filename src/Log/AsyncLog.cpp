@@ -0,0 +1,563 @@
+﻿#include<hgl/log/AsyncLog.h>
+#include<hgl/type/ByteSink.h>
+#include<hgl/thread/EventCount.h>
+#include<mutex>
+#include<thread>
+#include<vector>
+#include<chrono>
+#include<ctime>
+
+#ifdef __linux__
+#include<unistd.h>
+#include<sys/syscall.h>
+#endif//__linux__
+
+namespace hgl
+{
+    namespace
+    {
+        using namespace log_detail;
+
+        constexpr char LEVEL_CHAR[size_t(LogLevel::RANGE_SIZE)]={'T','D','I','W','E','F','-'};
+
+        constexpr size_t DRAIN_BATCH=4096;                          ///<每轮最多处理的记录数，之后先写出再继续
+
+        /**
+         * 全局状态<br>
+         * 线程缓冲区在所属线程退出并被取空后由后台线程释放；状态本身进程结束时也不释放（其它静态对象析构时可能还在写日志）。
+         */
+        struct LogState
+        {
+            std::mutex lock;
+            std::vector<ThreadBuffer *> threads;                   ///<受lock保护
+            std::atomic<uint32> thread_version{0};                  ///<threads每次变化加1
+
+            LogConfig config;
+            std::thread worker;
+            std::atomic<bool> running{false};
+            std::atomic<bool> stopping{false};
+
+            EventCount event;
+
+            std::atomic<uint32> flush_request{0};
+            std::atomic<uint32> flush_done{0};
+
+            std::atomic<uint64> written{0};
+            std::atomic<uint64> dropped_retired{0};                 ///<已释放的线程缓冲区累计丢弃数
+
+            uint64 base_wall_ns=0;                                  ///<Start时的系统时间
+            uint64 base_ticks=0;                                    ///<Start时的TscClock计数
+        };
+
+        LogState &GetState()
+        {
+            static LogState *s=new LogState;
+
+            return *s;
+        }
+
+        uint64 CurrentThreadId()
+        {
+#ifdef __linux__
+            return uint64(syscall(SYS_gettid));
+#else
+            static std::atomic<uint64> next_id{1};
+
+            return next_id.fetch_add(1,std::memory_order_relaxed);
+#endif//__linux__
+        }
+
+        /**
+         * 线程退出时标记缓冲区，由后台线程取空后释放
+         */
+        struct ThreadExitGuard
+        {
+            ~ThreadExitGuard()
+            {
+                if(tls_buffer)
+                {
+                    tls_buffer->retired.store(true,std::memory_order_release);
+                    tls_buffer=nullptr;
+                }
+            }
+        };
+
+        /**
+         * 后台线程的格式化与输出
+         */
+        class LogWriter
+        {
+            LogState &state;
+
+            FormatBuffer<char,64*1024> output;
+
+            int64 cached_second=-1;
+            char time_text[32];                                     ///<当前秒的 "YYYY-MM-DD hh:mm:ss"
+            size_t time_length=0;
+
+            std::vector<ThreadBuffer *> threads;
+            uint32 version=~uint32(0);
+
+            struct Pending
+            {
+                ThreadBuffer *      tb;
+                const uint8 *       data;
+                RecordHeader        header;
+            };
+
+            std::vector<Pending> pending;
+
+        private:
+
+            void UpdateTimeText(const int64 second)
+            {
+                const time_t t=time_t(second);
+                struct tm lt;
+
+#ifdef _WIN32
+                localtime_s(&lt,&t);
+#else
+                localtime_r(&t,&lt);
+#endif//_WIN32
+
+                const int len=strfmt(time_text,int(sizeof(time_text)),"{:04}-{:02}-{:02} {:02}:{:02}:{:02}",
+                                     lt.tm_year+1900,lt.tm_mon+1,lt.tm_mday,lt.tm_hour,lt.tm_min,lt.tm_sec);
+
+                time_length=len>0?size_t(len):0;
+                cached_second=second;
+            }
+
+            /**
+             * 时间、级别、线程号
+             */
+            void WritePrefix(const uint64 ticks,const LogLevel level,const uint64 thread_id)
+            {
+                const uint64 ns=ticks>=state.base_ticks?state.base_wall_ns+TscClock::ToNanoseconds(ticks-state.base_ticks)
+                                                       :state.base_wall_ns-TscClock::ToNanoseconds(state.base_ticks-ticks);
+
+                const int64 second=int64(ns/1000000000);
+
+                if(second!=cached_second)
+                    UpdateTimeText(second);
+
+                output.Append(time_text,time_length);
+                strfmt(output,".{:06} {} [{}] ",uint32((ns/1000)%1000000),LEVEL_CHAR[size_t(level)],thread_id);
+            }
+
+            void WriteRecord(const Pending &rec)
+            {
+                const LogSite *site=rec.header.site;
+
+                FormatArg<char> args[MAX_ARGS+1];
+
+                const uint8 *p=rec.data+sizeof(RecordHeader);
+
+                for(size_t i=0;i<site->format.count;i++)
+                {
+                    FormatArg<char> &arg=args[i];
+
+                    arg.type=site->arg_types[i];
+
+                    switch(arg.type)
+                    {
+                        case FormatArgType::Bool:   arg.b=(*p!=0);              p+=1;break;
+                        case FormatArgType::Char:   arg.c=char(*p);             p+=1;break;
+                        case FormatArgType::Int:    memcpy(&arg.i,p,8);         p+=8;break;
+                        case FormatArgType::UInt:   memcpy(&arg.u,p,8);         p+=8;break;
+                        case FormatArgType::Float:  memcpy(&arg.f,p,sizeof(float));p+=sizeof(float);break;
+                        case FormatArgType::Double: memcpy(&arg.d,p,8);         p+=8;break;
+                        case FormatArgType::Pointer:
+                        {
+                            uint64 v;
+
+                            memcpy(&v,p,8);
+                            arg.p=reinterpret_cast<const void *>(std::uintptr_t(v));
+                            p+=8;
+                            break;
+                        }
+                        default:
+                        {
+                            uint32 len;
+
+                            memcpy(&len,p,sizeof(uint32));
+                            arg.s.str=reinterpret_cast<const char *>(p+sizeof(uint32));
+                            arg.s.length=len;
+                            p+=sizeof(uint32)+len;
+                            break;
+                        }
+                    }
+                }
+
+                WritePrefix(rec.header.ticks,site->level,rec.tb->thread_id);
+
+                format_detail::VFormat(output,site->format,args);
+
+                if(state.config.source_location)
+                    strfmt(output," ({}:{})",site->file,site->line);
+
+                output.Append('\n');
+            }
+
+            void WriteDropped(ThreadBuffer *tb)
+            {
+                const uint64 dropped=tb->dropped.load(std::memory_order_relaxed);
+
+                if(dropped==tb->reported_dropped)
+                    return;
+
+                WritePrefix(TscClock::Now(),LogLevel::Warning,tb->thread_id);
+                strfmt(output,"{} log records dropped (buffer full)\n",dropped-tb->reported_dropped);
+
+                tb->reported_dropped=dropped;
+            }
+
+            void FlushOutput()
+            {
+                if(output.GetLength()==0)
+                    return;
+
+                const ByteSinkSpan span{reinterpret_cast<const uint8 *>(output.GetData()),output.GetLength()};
+
+                state.config.sink->Write(&span,1);
+                output.Clear();
+            }
+
+            bool Peek(Pending &rec)
+            {
+                uint32 size;
+
+                rec.data=static_cast<const uint8 *>(rec.tb->ring.Peek(size));
+
+                if(!rec.data)
+                    return(false);
+
+                memcpy(&rec.header,rec.data,sizeof(RecordHeader));
+                return(true);
+            }
+
+            void UpdateThreadList()
+            {
+                const uint32 v=state.thread_version.load(std::memory_order_acquire);
+
+                if(v==version)
+                    return;
+
+                std::lock_guard<std::mutex> guard(state.lock);
+
+                threads=state.threads;
+                version=state.thread_version.load(std::memory_order_relaxed);
+            }
+
+            /**
+             * 释放已退出并取空的线程缓冲区
+             */
+            void ReleaseRetired()
+            {
+                std::vector<ThreadBuffer *> finished;
+
+                for(ThreadBuffer *tb:threads)
+                    if(tb->retired.load(std::memory_order_acquire)&&tb->ring.IsEmpty())
+                        finished.push_back(tb);
+
+                if(finished.empty())
+                    return;
+
+                {
+                    std::lock_guard<std::mutex> guard(state.lock);
+
+                    for(ThreadBuffer *tb:finished)
+                        std::erase(state.threads,tb);
+
+                    state.thread_version.fetch_add(1,std::memory_order_release);
+                }
+
+                for(ThreadBuffer *tb:finished)
+                {
+                    WriteDropped(tb);
+
+                    state.dropped_retired.fetch_add(tb->dropped.load(std::memory_order_relaxed),std::memory_order_relaxed);
+                    delete tb;
+                }
+
+                FlushOutput();
+                UpdateThreadList();
+            }
+
+        public:
+
+            explicit LogWriter(LogState &s):state(s){}
+
+            /**
+             * 取出各线程已发布的记录，按时间戳合并后格式化
+             * @return 处理的记录数
+             */
+            size_t Drain()
+            {
+                UpdateThreadList();
+
+                pending.clear();
+
+                for(ThreadBuffer *tb:threads)
+                {
+                    Pending rec;
+
+                    rec.tb=tb;
+
+                    if(Peek(rec))
+                        pending.push_back(rec);
+                }
+
+                size_t count=0;
+
+                while(!pending.empty()&&count<DRAIN_BATCH)
+                {
+                    size_t first=0;
+
+                    for(size_t i=1;i<pending.size();i++)
+                        if(pending[i].header.ticks<pending[first].header.ticks)
+                            first=i;
+
+                    Pending &rec=pending[first];
+
+                    WriteRecord(rec);
+                    rec.tb->ring.Release();
+                    ++count;
+
+                    if(output.GetLength()>=state.config.batch_size)
+                        FlushOutput();
+
+                    if(!Peek(rec))
+                    {
+                        rec=pending.back();
+                        pending.pop_back();
+                    }
+                }
+
+                for(ThreadBuffer *tb:threads)
+                    WriteDropped(tb);
+
+                state.written.fetch_add(count,std::memory_order_relaxed);
+
+                FlushOutput();
+                ReleaseRetired();
+
+                return count;
+            }
+
+            bool HasPending()
+            {
+                UpdateThreadList();
+
+                for(ThreadBuffer *tb:threads)
+                    if(!tb->ring.IsEmpty())
+                        return(true);
+
+                return(false);
+            }
+        };//class LogWriter
+
+        void WorkerMain(LogState *state)
+        {
+            LogWriter writer(*state);
+
+            for(;;)
+            {
+                const uint32 request=state->flush_request.load(std::memory_order_acquire);
+                const bool stop=state->stopping.load(std::memory_order_acquire);   //先读取，之后的Drain取得Stop前写入的全部记录
+
+                if(writer.Drain()>0)
+                    continue;
+
+                //所有缓冲区都已取空
+                if(state->flush_done.load(std::memory_order_relaxed)!=request)
+                {
+                    state->flush_done.store(request,std::memory_order_release);
+                    FutexWakeAll(state->flush_done);
+                }
+
+                if(stop)
+                    break;
+
+                const EventCount::Key key=state->event.PrepareWait();
+
+                if(writer.HasPending()
+                 ||state->stopping.load(std::memory_order_acquire)
+                 ||state->flush_request.load(std::memory_order_acquire)!=request)
+                {
+                    state->event.CancelWait();
+                    continue;
+                }
+
+                state->event.Wait(key,int64(state->config.flush_interval_us));
+            }
+        }
+    }//namespace
+
+    namespace log_detail
+    {
+        ThreadBuffer *RegisterThread()
+        {
+            LogState &s=GetState();
+
+            if(!s.running.load(std::memory_order_acquire))
+                return(nullptr);
+
+            ThreadBuffer *tb=new ThreadBuffer(s.config.thread_buffer_size);
+
+            tb->thread_id=CurrentThreadId();
+
+            {
+                std::lock_guard<std::mutex> guard(s.lock);
+
+                s.threads.push_back(tb);
+                s.thread_version.fetch_add(1,std::memory_order_release);
+            }
+
+            static thread_local ThreadExitGuard exit_guard;         //首次注册时构造，线程退出时析构
+            (void)exit_guard;
+
+            tls_buffer=tb;
+            return tb;
+        }
+
+        void *ReserveSlow(ThreadBuffer *tb,size_t size)
+        {
+            LogState &s=GetState();
+
+            if(size<=tb->ring.GetMaxRecordSize()
+             &&s.config.overflow==LogOverflowPolicy::Block)
+            {
+                Backoff backoff;
+
+                for(;;)
+                {
+                    Wake();
+
+                    void *p=tb->ring.Reserve(size);
+
+                    if(p)
+                        return p;
+
+                    if(!s.running.load(std::memory_order_acquire))
+                        break;
+
+                    backoff.Pause();
+                }
+            }
+
+            tb->dropped.store(tb->dropped.load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+            Wake();
+            return(nullptr);
+        }
+
+        void Wake()
+        {
+            GetState().event.NotifyOne();
+        }
+    }//namespace log_detail
+
+    bool AsyncLog::Start(const LogConfig &config)
+    {
+        if(!config.sink)
+            return(false);
+
+        LogState &s=GetState();
+
+        if(s.running.load(std::memory_order_acquire))
+            return(false);
+
+        s.config=config;
+
+        if(s.config.thread_buffer_size<4096)
+            s.config.thread_buffer_size=4096;
+
+        s.base_ticks=TscClock::Now();
+        s.base_wall_ns=uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+        s.stopping.store(false,std::memory_order_relaxed);
+        s.running.store(true,std::memory_order_release);
+
+        s.worker=std::thread(WorkerMain,&s);
+
+        min_level.store(uint8(config.level),std::memory_order_relaxed);
+        return(true);
+    }
+
+    void AsyncLog::Stop()
+    {
+        LogState &s=GetState();
+
+        if(!s.running.load(std::memory_order_acquire))
+            return;
+
+        min_level.store(uint8(LogLevel::Off),std::memory_order_relaxed);
+
+        s.stopping.store(true,std::memory_order_release);
+        s.event.NotifyAll();
+
+        s.worker.join();
+
+        s.running.store(false,std::memory_order_release);
+    }
+
+    void AsyncLog::Flush()
+    {
+        LogState &s=GetState();
+
+        if(!s.running.load(std::memory_order_acquire))
+            return;
+
+        const uint32 request=s.flush_request.fetch_add(1,std::memory_order_seq_cst)+1;
+
+        s.event.NotifyAll();
+
+        for(;;)
+        {
+            const uint32 done=s.flush_done.load(std::memory_order_acquire);
+
+            if(int32(done-request)>=0||!s.running.load(std::memory_order_acquire))
+                break;
+
+            FutexWait(s.flush_done,done,1000);
+        }
+    }
+
+    bool AsyncLog::IsRunning()
+    {
+        return GetState().running.load(std::memory_order_acquire);
+    }
+
+    void AsyncLog::SetLevel(const LogLevel level)
+    {
+        LogState &s=GetState();
+
+        s.config.level=level;
+
+        if(s.running.load(std::memory_order_acquire))
+            min_level.store(uint8(level),std::memory_order_relaxed);
+    }
+
+    LogLevel AsyncLog::GetLevel()
+    {
+        return GetState().config.level;
+    }
+
+    uint64 AsyncLog::GetWrittenCount()
+    {
+        return GetState().written.load(std::memory_order_relaxed);
+    }
+
+    uint64 AsyncLog::GetDroppedCount()
+    {
+        LogState &s=GetState();
+
+        uint64 total=s.dropped_retired.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> guard(s.lock);
+
+        for(ThreadBuffer *tb:s.threads)
+            total+=tb->dropped.load(std::memory_order_relaxed);
+
+        return total;
+    }
+}//namespace hgl
@@ -0,0 +1,557 @@
+﻿#include<hgl/thread/TaskScheduler.h>
+#include<algorithm>
+#include<string>
+
+#ifdef __linux__
+#include<pthread.h>
+#include<sched.h>
+#include<stdio.h>
+#endif//__linux__
+
+namespace hgl
+{
+    namespace
+    {
+        thread_local void *tls_worker=nullptr;                      ///<当前线程所属的 TaskScheduler::Worker
+
+        constexpr int SPIN_BEFORE_SLEEP=64;                         ///<空闲时入睡前的查找次数
+
+        uint64 NextRandom(uint64 &s)
+        {
+            s^=s<<13;
+            s^=s>>7;
+            s^=s<<17;
+            return s;
+        }
+
+    #ifdef __linux__
+        /**
+         * 解析 "0-3,8-11" 格式的CPU列表
+         */
+        std::vector<int> ParseCpuList(const char *str)
+        {
+            std::vector<int> result;
+
+            while(*str)
+            {
+                char *end;
+
+                const long first=strtol(str,&end,10);
+
+                if(end==str)
+                    break;
+
+                long last=first;
+                str=end;
+
+                if(*str=='-')
+                {
+                    last=strtol(str+1,&end,10);
+                    str=end;
+                }
+
+                for(long i=first;i<=last;i++)
+                    result.push_back(int(i));
+
+                if(*str!=',')
+                    break;
+
+                ++str;
+            }
+
+            return result;
+        }
+
+        /**
+         * 读取各NUMA节点上当前进程可以使用的CPU，没有NUMA信息时视为一个节点
+         */
+        std::vector<std::vector<int>> GetNumaNodeCpus(const cpu_set_t &allowed)
+        {
+            std::vector<std::vector<int>> nodes;
+
+            for(int n=0;;n++)
+            {
+                char path[64];
+                snprintf(path,sizeof(path),"/sys/devices/system/node/node%d/cpulist",n);
+
+                FILE *fp=fopen(path,"r");
+
+                if(!fp)
+                    break;
+
+                char line[4096];
+                std::vector<int> cpus;
+
+                if(fgets(line,sizeof(line),fp))
+                    for(int cpu:ParseCpuList(line))
+                        if(cpu<CPU_SETSIZE&&CPU_ISSET(cpu,&allowed))
+                            cpus.push_back(cpu);
+
+                fclose(fp);
+
+                if(!cpus.empty())
+                    nodes.push_back(std::move(cpus));
+            }
+
+            if(nodes.empty())
+            {
+                std::vector<int> cpus;
+
+                for(int cpu=0;cpu<CPU_SETSIZE;cpu++)
+                    if(CPU_ISSET(cpu,&allowed))
+                        cpus.push_back(cpu);
+
+                nodes.push_back(std::move(cpus));
+            }
+
+            return nodes;
+        }
+    #endif//__linux__
+    }//namespace
+
+    TaskScheduler::TaskScheduler(const Config &config)
+    {
+        int count=config.worker_count;
+
+        if(count<0)
+            count=std::max(1,int(std::thread::hardware_concurrency())-1);
+
+        for(int i=0;i<count;i++)
+        {
+            Worker *w=new Worker;
+
+            w->scheduler=this;
+            w->index=i;
+            w->rng=0x9E3779B97F4A7C15ull*uint64(i+1);
+
+            workers.emplace_back(w);
+        }
+
+        PlaceWorkers(config);
+
+        for(auto &w:workers)
+        {
+            Worker *p=w.get();
+
+            p->thread=std::thread([this,p]{WorkerMain(p);});
+        }
+    }
+
+    TaskScheduler::~TaskScheduler()
+    {
+        WaitAll();
+
+        {
+            std::lock_guard<std::mutex> lock(sleep_lock);
+            stopping=true;
+        }
+
+        stop_flag.store(true,std::memory_order_release);
+        sleep_cv.notify_all();
+
+        for(auto &w:workers)
+            if(w->thread.joinable())
+                w->thread.join();
+    }
+
+    TaskScheduler &TaskScheduler::Default()
+    {
+        static TaskScheduler scheduler;
+
+        return scheduler;
+    }
+
+    /**
+     * 分配工作线程所在的NUMA节点与CPU，并生成窃取顺序
+     */
+    void TaskScheduler::PlaceWorkers(const Config &config)
+    {
+        const int count=GetWorkerCount();
+
+    #ifdef __linux__
+        if(config.pin_threads||config.numa_aware)
+        {
+            cpu_set_t allowed;
+
+            CPU_ZERO(&allowed);
+
+            if(sched_getaffinity(0,sizeof(allowed),&allowed)==0)
+            {
+                const std::vector<std::vector<int>> nodes=GetNumaNodeCpus(allowed);
+
+                if(config.numa_aware)
+                {
+                    numa_node_count=int(nodes.size());
+
+                    //轮流分配到各节点，同节点内依次使用各CPU
+                    for(int i=0;i<count;i++)
+                    {
+                        const int node=i%numa_node_count;
+                        const std::vector<int> &cpus=nodes[node];
+
+                        workers[i]->numa_node=node;
+
+                        if(config.pin_threads)
+                            workers[i]->cpu=cpus[(i/numa_node_count)%cpus.size()];
+                    }
+                }
+                else
+                {
+                    std::vector<int> cpus;
+
+                    for(const auto &n:nodes)
+                        cpus.insert(cpus.end(),n.begin(),n.end());
+
+                    if(!cpus.empty())
+                        for(int i=0;i<count;i++)
+                            workers[i]->cpu=cpus[i%cpus.size()];
+                }
+
+                node_cpus=nodes;
+            }
+        }
+    #else
+        (void)config;
+    #endif//__linux__
+
+        //窃取顺序：同节点的其它线程在前，各自从不同位置开始以免都去偷同一个
+        for(int i=0;i<count;i++)
+        {
+            Worker *w=workers[i].get();
+
+            for(int pass=0;pass<2;pass++)
+                for(int k=1;k<count;k++)
+                {
+                    const int v=(i+k)%count;
+
+                    if((workers[v]->numa_node==w->numa_node)==(pass==0))
+                        w->victims.push_back(v);
+                }
+        }
+    }
+
+    void TaskScheduler::WorkerMain(Worker *w)
+    {
+        tls_worker=w;
+
+    #ifdef __linux__
+        {
+            char name[16];
+            snprintf(name,sizeof(name),"hgl.worker.%d",w->index);
+            pthread_setname_np(pthread_self(),name);
+
+            cpu_set_t set;
+            CPU_ZERO(&set);
+
+            if(w->cpu>=0)
+            {
+                CPU_SET(w->cpu,&set);
+                pthread_setaffinity_np(pthread_self(),sizeof(set),&set);
+            }
+            else if(numa_node_count>1)                              //只绑定到节点
+            {
+                for(int cpu:node_cpus[w->numa_node])
+                    CPU_SET(cpu,&set);
+
+                pthread_setaffinity_np(pthread_self(),sizeof(set),&set);
+            }
+        }
+    #endif//__linux__
+
+        int idle=0;
+
+        while(!stop_flag.load(std::memory_order_acquire))
+        {
+            Task *t=FindWork(w);
+
+            if(t)
+            {
+                Execute(t);
+                idle=0;
+                continue;
+            }
+
+            if(++idle<SPIN_BEFORE_SLEEP)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            idle=0;
+
+            //先登记为睡眠再检查一次，与 WakeWorker 中“先放入任务再检查睡眠数”配对，不会漏掉唤醒
+            sleeping.fetch_add(1,std::memory_order_seq_cst);
+
+            if(HasWork())
+            {
+                sleeping.fetch_sub(1,std::memory_order_relaxed);
+                continue;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(sleep_lock);
+
+                sleep_cv.wait(lock,[this]{return stopping||wake_signals>0;});
+
+                if(wake_signals>0)
+                    --wake_signals;
+            }
+
+            sleeping.fetch_sub(1,std::memory_order_relaxed);
+        }
+
+        tls_worker=nullptr;
+    }
+
+    TaskScheduler::Worker *TaskScheduler::GetCurrentWorker()const
+    {
+        Worker *w=static_cast<Worker *>(tls_worker);
+
+        return (w&&w->scheduler==this)?w:nullptr;
+    }
+
+    bool TaskScheduler::HasWork()const
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(inject_count.load(std::memory_order_relaxed)>0)
+            return(true);
+
+        for(const auto &w:workers)
+            if(!w->deque.IsEmpty())
+                return(true);
+
+        return(false);
+    }
+
+    void TaskScheduler::WakeWorker()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(sleeping.load(std::memory_order_relaxed)<=0)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(sleep_lock);
+            ++wake_signals;
+        }
+
+        sleep_cv.notify_one();
+    }
+
+    TaskScheduler::Task *TaskScheduler::FindWork(Worker *self)
+    {
+        Task *t;
+
+        if(self&&self->deque.Pop(t))
+            return t;
+
+        if(inject_count.load(std::memory_order_relaxed)>0)
+        {
+            std::lock_guard<std::mutex> lock(inject_lock);
+
+            if(!inject_queue.empty())
+            {
+                t=inject_queue.front();
+                inject_queue.pop_front();
+                inject_count.fetch_sub(1,std::memory_order_relaxed);
+                return t;
+            }
+        }
+
+        if(self)
+        {
+            for(int v:self->victims)
+                if(workers[v]->deque.Steal(t))
+                    return t;
+        }
+        else if(!workers.empty())
+        {
+            static thread_local uint64 rng=uint64(reinterpret_cast<uintptr_t>(&rng))|1;
+
+            const size_t count=workers.size();
+            const size_t start=size_t(NextRandom(rng)%count);
+
+            for(size_t i=0;i<count;i++)
+                if(workers[(start+i)%count]->deque.Steal(t))
+                    return t;
+        }
+
+        return nullptr;
+    }
+
+    bool TaskScheduler::HelpOnce()
+    {
+        Task *t=FindWork(GetCurrentWorker());
+
+        if(!t)
+            return(false);
+
+        Execute(t);
+        return(true);
+    }
+
+    void TaskScheduler::Schedule(Task *t)
+    {
+        Worker *w=GetCurrentWorker();
+
+        if(w)
+        {
+            w->deque.Push(t);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(inject_lock);
+
+            inject_queue.push_back(t);
+            inject_count.fetch_add(1,std::memory_order_relaxed);
+        }
+
+        WakeWorker();
+    }
+
+    void TaskScheduler::Execute(Task *t)
+    {
+        if(!t->cancelled.load(std::memory_order_acquire))
+            t->invoke(t);
+
+        t->destroy(t);                                              //尽早释放捕获的资源
+        t->destroy=nullptr;
+
+        Finish(t);
+    }
+
+    void TaskScheduler::Finish(Task *t)
+    {
+        std::vector<Task *> next;
+
+        {
+            std::lock_guard<std::mutex> lock(t->successor_lock);
+
+            t->finished=true;
+            next.swap(t->successors);
+        }
+
+        t->done.store(1,std::memory_order_release);
+        t->done.notify_all();
+
+        const bool cancelled=t->cancelled.load(std::memory_order_relaxed);
+
+        for(Task *s:next)
+        {
+            if(cancelled)                                           //取消沿依赖链传递
+                s->cancelled.store(true,std::memory_order_release);
+
+            if(s->pending.fetch_sub(1,std::memory_order_acq_rel)==1)
+                Schedule(s);
+
+            ReleaseTask(s);
+        }
+
+        live_tasks.fetch_sub(1,std::memory_order_acq_rel);
+
+        ReleaseTask(t);                                             //调度器持有的引用
+    }
+
+    void TaskScheduler::ReleaseTask(Task *t)
+    {
+        if(t->refs.fetch_sub(1,std::memory_order_acq_rel)!=1)
+            return;
+
+        if(t->destroy)                                              //从未执行
+            t->destroy(t);
+
+        //只有从未提交的任务在此时还有后续任务（提交过的在Finish中已取走），它永远不会完成，
+        //所以取消后续任务并代替它解除依赖，已提交的后续任务照常走完调度流程以扣减live_tasks
+        for(Task *s:t->successors)
+        {
+            s->cancelled.store(true,std::memory_order_release);
+
+            if(s->pending.fetch_sub(1,std::memory_order_acq_rel)==1)
+                Schedule(s);
+
+            ReleaseTask(s);
+        }
+
+        task_pool.Release(t);
+    }
+
+    bool TaskScheduler::Submit(const TaskRef &tr)
+    {
+        Task *t=tr.task;
+
+        if(!t||t->scheduler!=this)
+            return(false);
+
+        if(t->submitted.exchange(true,std::memory_order_acq_rel))
+            return(false);
+
+        t->refs.fetch_add(1,std::memory_order_relaxed);             //执行完成前由调度器持有
+        live_tasks.fetch_add(1,std::memory_order_relaxed);
+
+        if(t->pending.fetch_sub(1,std::memory_order_acq_rel)==1)
+            Schedule(t);
+
+        return(true);
+    }
+
+    bool TaskScheduler::AddDependency(const TaskRef &before,const TaskRef &after)
+    {
+        Task *b=before.task;
+        Task *a=after.task;
+
+        if(!b||!a||a==b||a->scheduler!=this||b->scheduler!=this)
+            return(false);
+
+        if(a->submitted.load(std::memory_order_acquire))
+            return(false);
+
+        std::lock_guard<std::mutex> lock(b->successor_lock);
+
+        if(b->finished)                                             //已经完成，无需等待
+            return(true);
+
+        a->pending.fetch_add(1,std::memory_order_relaxed);
+        a->refs.fetch_add(1,std::memory_order_relaxed);
+
+        b->successors.push_back(a);
+        return(true);
+    }
+
+    bool TaskScheduler::Wait(const TaskRef &tr)
+    {
+        Task *t=tr.task;
+
+        if(!t||!t->submitted.load(std::memory_order_acquire))
+            return(false);
+
+        int idle=0;
+
+        while(!t->done.load(std::memory_order_acquire))
+        {
+            if(HelpOnce())
+            {
+                idle=0;
+                continue;
+            }
+
+            if(++idle<SPIN_BEFORE_SLEEP)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            //任务正在其它线程执行或在等待前置任务，不再有可帮忙的工作时阻塞
+            t->done.wait(0,std::memory_order_acquire);
+        }
+
+        return(true);
+    }
+
+    void TaskScheduler::WaitAll()
+    {
+        while(live_tasks.load(std::memory_order_acquire)>0)
+            if(!HelpOnce())
+                std::this_thread::yield();
+    }
+}//namespace hgl
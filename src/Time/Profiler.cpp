@@ -0,0 +1,324 @@
+﻿#include<hgl/time/Profiler.h>
+#include<mutex>
+#include<vector>
+#include<cstring>
+#include<stdio.h>
+
+#ifdef __linux__
+#include<unistd.h>
+#include<sys/syscall.h>
+#endif//__linux__
+
+namespace hgl
+{
+    namespace
+    {
+        using namespace profile_detail;
+
+        struct CounterSample
+        {
+            const ProfileCounter *counter;
+            uint64 ticks;
+            int64 value;
+        };
+
+        /**
+         * 线程缓冲区登记表<br>
+         * 缓冲区在线程退出后仍保留以便导出，进程结束时也不释放（其它静态对象析构时可能还在记录）。
+         */
+        struct Registry
+        {
+            std::mutex lock;
+            std::vector<ThreadBuffer *> threads;
+            std::vector<CounterSample> counter_samples;
+        };
+
+        Registry &GetRegistry()
+        {
+            static Registry *r=new Registry;
+
+            return *r;
+        }
+
+        std::atomic<ProfileCounter *> counter_list{nullptr};
+
+        uint64 CurrentThreadId()
+        {
+#ifdef __linux__
+            return uint64(syscall(SYS_gettid));
+#else
+            static std::atomic<uint64> next_id{1};
+
+            return next_id.fetch_add(1,std::memory_order_relaxed);
+#endif//__linux__
+        }
+
+        void AppendJsonString(std::string &out,const char *str)
+        {
+            out+='"';
+
+            for(;*str;++str)
+            {
+                const unsigned char c=(unsigned char)*str;
+
+                if(c=='"'||c=='\\')
+                {
+                    out+='\\';
+                    out+=char(c);
+                }
+                else if(c<0x20)
+                {
+                    char buf[8];
+
+                    snprintf(buf,sizeof(buf),"\\u%04x",c);
+                    out+=buf;
+                }
+                else
+                    out+=char(c);
+            }
+
+            out+='"';
+        }
+
+        /**
+         * 计数值换算为微秒（Chrome trace的时间单位），保留到纳秒
+         */
+        void AppendMicroseconds(std::string &out,const uint64 ns)
+        {
+            char buf[32];
+
+            snprintf(buf,sizeof(buf),"%llu.%03u",(unsigned long long)(ns/1000),unsigned(ns%1000));
+            out+=buf;
+        }
+
+        void AppendInt(std::string &out,const int64 v)
+        {
+            char buf[24];
+
+            snprintf(buf,sizeof(buf),"%lld",(long long)v);
+            out+=buf;
+        }
+    }//namespace
+
+    namespace profile_detail
+    {
+        ThreadBuffer *RegisterThread()
+        {
+            ThreadBuffer *tb=new ThreadBuffer;
+
+            tb->head=new ZoneChunk;
+            tb->current=tb->head;
+            tb->chunk_count=1;
+            tb->thread_id=CurrentThreadId();
+
+            Registry &r=GetRegistry();
+            {
+                std::lock_guard<std::mutex> guard(r.lock);
+                r.threads.push_back(tb);
+            }
+
+            tls_buffer=tb;
+            return tb;
+        }
+
+        ZoneChunk *AppendChunk(ThreadBuffer *tb)
+        {
+            if(tb->chunk_count>=MAX_CHUNKS_PER_THREAD)
+            {
+                tb->dropped.fetch_add(1,std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            ZoneChunk *chunk=new ZoneChunk;
+
+            tb->current->next.store(chunk,std::memory_order_release);
+            tb->current=chunk;
+            ++tb->chunk_count;
+
+            return chunk;
+        }
+    }//namespace profile_detail
+
+    ProfileCounter::ProfileCounter(const char *n):name(n)
+    {
+        next=counter_list.load(std::memory_order_relaxed);
+
+        while(!counter_list.compare_exchange_weak(next,this,std::memory_order_release,std::memory_order_relaxed));
+    }
+
+    void Profiler::SetThreadName(const char *name)
+    {
+        ThreadBuffer *tb=tls_buffer;
+
+        if(!tb)
+            tb=RegisterThread();
+
+        Registry &r=GetRegistry();
+        std::lock_guard<std::mutex> guard(r.lock);
+
+        tb->thread_name=name?name:"";
+    }
+
+    void Profiler::SampleCounters()
+    {
+        const uint64 now=TscClock::Now();
+
+        Registry &r=GetRegistry();
+        std::lock_guard<std::mutex> guard(r.lock);
+
+        for(ProfileCounter *c=counter_list.load(std::memory_order_acquire);c;c=c->next)
+            r.counter_samples.push_back({c,now,c->Get()});
+    }
+
+    ProfileCounter *Profiler::FindCounter(const char *name)
+    {
+        if(!name)
+            return nullptr;
+
+        for(ProfileCounter *c=counter_list.load(std::memory_order_acquire);c;c=c->next)
+            if(strcmp(c->name,name)==0)
+                return c;
+
+        return nullptr;
+    }
+
+    uint64 Profiler::GetZoneCount()
+    {
+        Registry &r=GetRegistry();
+        std::lock_guard<std::mutex> guard(r.lock);
+
+        uint64 total=0;
+
+        for(ThreadBuffer *tb:r.threads)
+            for(ZoneChunk *c=tb->head;c;c=c->next.load(std::memory_order_acquire))
+                total+=c->count.load(std::memory_order_acquire);
+
+        return total;
+    }
+
+    uint64 Profiler::GetDroppedCount()
+    {
+        Registry &r=GetRegistry();
+        std::lock_guard<std::mutex> guard(r.lock);
+
+        uint64 total=0;
+
+        for(ThreadBuffer *tb:r.threads)
+            total+=tb->dropped.load(std::memory_order_relaxed);
+
+        return total;
+    }
+
+    void Profiler::ExportChromeTrace(std::string &out)
+    {
+        Registry &r=GetRegistry();
+        std::lock_guard<std::mutex> guard(r.lock);
+
+        out+="{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+        bool first=true;
+
+        auto begin_event=[&]()
+        {
+            if(!first)
+                out+=",\n";
+
+            first=false;
+        };
+
+        for(ThreadBuffer *tb:r.threads)
+        {
+            if(!tb->thread_name.empty())
+            {
+                begin_event();
+                out+="{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+                AppendInt(out,int64(tb->thread_id));
+                out+=",\"args\":{\"name\":";
+                AppendJsonString(out,tb->thread_name.c_str());
+                out+="}}";
+            }
+
+            for(ZoneChunk *c=tb->head;c;c=c->next.load(std::memory_order_acquire))
+            {
+                const uint32 count=c->count.load(std::memory_order_acquire);
+
+                for(uint32 i=0;i<count;i++)
+                {
+                    const ZoneEvent &e=c->events[i];
+
+                    begin_event();
+                    out+="{\"name\":";
+                    AppendJsonString(out,e.site->name);
+                    out+=",\"ph\":\"X\",\"pid\":1,\"tid\":";
+                    AppendInt(out,int64(tb->thread_id));
+                    out+=",\"ts\":";
+                    AppendMicroseconds(out,TscClock::SinceOrigin(e.begin));
+                    out+=",\"dur\":";
+                    AppendMicroseconds(out,TscClock::ToNanoseconds(e.end-e.begin));
+                    out+='}';
+                }
+            }
+        }
+
+        for(const CounterSample &s:r.counter_samples)
+        {
+            begin_event();
+            out+="{\"name\":";
+            AppendJsonString(out,s.counter->name);
+            out+=",\"ph\":\"C\",\"pid\":1,\"ts\":";
+            AppendMicroseconds(out,TscClock::SinceOrigin(s.ticks));
+            out+=",\"args\":{\"value\":";
+            AppendInt(out,s.value);
+            out+="}}";
+        }
+
+        out+="]}\n";
+    }
+
+    bool Profiler::SaveChromeTrace(const char *filename)
+    {
+        if(!filename)
+            return(false);
+
+        std::string json;
+
+        ExportChromeTrace(json);
+
+        FILE *fp=fopen(filename,"wb");
+
+        if(!fp)
+            return(false);
+
+        const bool ok=fwrite(json.data(),1,json.size(),fp)==json.size();
+
+        return (fclose(fp)==0)&&ok;
+    }
+
+    void Profiler::Reset()
+    {
+        Registry &r=GetRegistry();
+        std::lock_guard<std::mutex> guard(r.lock);
+
+        for(ThreadBuffer *tb:r.threads)
+        {
+            ZoneChunk *c=tb->head->next.exchange(nullptr,std::memory_order_relaxed);
+
+            while(c)
+            {
+                ZoneChunk *next=c->next.load(std::memory_order_relaxed);
+                delete c;
+                c=next;
+            }
+
+            tb->head->count.store(0,std::memory_order_relaxed);
+            tb->current=tb->head;
+            tb->chunk_count=1;
+            tb->dropped.store(0,std::memory_order_relaxed);
+        }
+
+        r.counter_samples.clear();
+
+        for(ProfileCounter *c=counter_list.load(std::memory_order_acquire);c;c=c->next)
+            c->Set(0);
+    }
+}//namespace hgl
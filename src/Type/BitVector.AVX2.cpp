@@ -0,0 +1,118 @@
+﻿/**
+ * BitVector AVX2档次内核（以 HGL_ISA_AVX2_FLAGS 编译）
+ */
+
+#include"BitVectorKernel.h"
+
+#ifdef HGL_SIMD_X86
+
+#if !defined(__AVX2__)
+    #error "BitVector.AVX2.cpp must be compiled with HGL_ISA_AVX2_FLAGS"
+#endif
+
+namespace hgl
+{
+    namespace bit_vector_detail
+    {
+        namespace
+        {
+            enum class Op{And,Or,Xor,AndNot};
+
+            template<Op OP>
+            inline __m256i Apply256(const __m256i a,const __m256i b)
+            {
+                if constexpr(OP==Op::And)    return _mm256_and_si256(a,b);
+                if constexpr(OP==Op::Or)     return _mm256_or_si256(a,b);
+                if constexpr(OP==Op::Xor)    return _mm256_xor_si256(a,b);
+                if constexpr(OP==Op::AndNot) return _mm256_andnot_si256(b,a);
+            }
+
+            template<Op OP>
+            inline uint64 Apply64(const uint64 a,const uint64 b)
+            {
+                if constexpr(OP==Op::And)    return a&b;
+                if constexpr(OP==Op::Or)     return a|b;
+                if constexpr(OP==Op::Xor)    return a^b;
+                if constexpr(OP==Op::AndNot) return a&~b;
+            }
+
+            template<Op OP>
+            void Bulk(uint64 *dst,const uint64 *src,const size_t count)
+            {
+                size_t i=0;
+
+                for(;i+8<=count;i+=8)
+                {
+                    __m256i *d=reinterpret_cast<__m256i *>(dst+i);
+                    const __m256i *s=reinterpret_cast<const __m256i *>(src+i);
+
+                    const __m256i r0=Apply256<OP>(_mm256_loadu_si256(d  ),_mm256_loadu_si256(s  ));
+                    const __m256i r1=Apply256<OP>(_mm256_loadu_si256(d+1),_mm256_loadu_si256(s+1));
+
+                    _mm256_storeu_si256(d  ,r0);
+                    _mm256_storeu_si256(d+1,r1);
+                }
+
+                for(;i<count;i++)
+                    dst[i]=Apply64<OP>(dst[i],src[i]);
+            }
+
+            inline uint64 PopCount64(const uint64 v)
+            {
+    #if HGL_CPU==HGL_CPU_X86_64
+                return uint64(_mm_popcnt_u64(v));
+    #else
+                return uint64(_mm_popcnt_u32(uint32(v)))+uint64(_mm_popcnt_u32(uint32(v>>32)));
+    #endif
+            }
+        }//namespace
+
+        namespace avx2
+        {
+            void And   (uint64 *dst,const uint64 *src,size_t count){Bulk<Op::And   >(dst,src,count);}
+            void Or    (uint64 *dst,const uint64 *src,size_t count){Bulk<Op::Or    >(dst,src,count);}
+            void Xor   (uint64 *dst,const uint64 *src,size_t count){Bulk<Op::Xor   >(dst,src,count);}
+            void AndNot(uint64 *dst,const uint64 *src,size_t count){Bulk<Op::AndNot>(dst,src,count);}
+
+            /**
+             * 半字节查表 + vpsadbw 累加（Mula/Kurz/Lemire），少于16个字时直接用popcnt
+             */
+            uint64 PopCount(const uint64 *data,size_t count)
+            {
+                uint64 total=0;
+                size_t i=0;
+
+                if(count>=16)
+                {
+                    const __m256i lookup=_mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,
+                                                          0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+                    const __m256i nibble=_mm256_set1_epi8(0x0F);
+
+                    __m256i acc=_mm256_setzero_si256();
+
+                    for(;i+4<=count;i+=4)
+                    {
+                        const __m256i v=_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data+i));
+                        const __m256i lo=_mm256_shuffle_epi8(lookup,_mm256_and_si256(v,nibble));
+                        const __m256i hi=_mm256_shuffle_epi8(lookup,_mm256_and_si256(_mm256_srli_epi16(v,4),nibble));
+
+                        acc=_mm256_add_epi64(acc,_mm256_sad_epu8(_mm256_add_epi8(lo,hi),_mm256_setzero_si256()));
+                    }
+
+                    alignas(32) uint64 lane[4];
+
+                    _mm256_store_si256(reinterpret_cast<__m256i *>(lane),acc);     //_mm256_extract_epi64仅x86-64可用
+
+                    total=lane[0]+lane[1]+lane[2]+lane[3];
+                }
+
+                for(;i<count;i++)
+                    total+=PopCount64(data[i]);
+
+                return total;
+            }
+        }//namespace avx2
+    }//namespace bit_vector_detail
+}//namespace hgl
+
+#endif//HGL_SIMD_X86
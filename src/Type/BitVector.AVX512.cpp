@@ -0,0 +1,127 @@
+﻿/**
+ * BitVector AVX-512档次内核（以 HGL_ISA_AVX512_FLAGS 编译）
+ */
+
+#if defined(__GNUC__)&&!defined(__clang__)
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"         //GCC12 avx512fintrin.h中_mm512_undefined_*的误报
+#endif
+
+#include"BitVectorKernel.h"
+
+#ifdef HGL_SIMD_X86
+
+#if !defined(__AVX512F__)||!defined(__AVX512BW__)
+    #error "BitVector.AVX512.cpp must be compiled with HGL_ISA_AVX512_FLAGS"
+#endif
+
+namespace hgl
+{
+    namespace bit_vector_detail
+    {
+        namespace
+        {
+            enum class Op{And,Or,Xor,AndNot};
+
+            template<Op OP>
+            inline __m512i Apply512(const __m512i a,const __m512i b)
+            {
+                if constexpr(OP==Op::And)    return _mm512_and_si512(a,b);
+                if constexpr(OP==Op::Or)     return _mm512_or_si512(a,b);
+                if constexpr(OP==Op::Xor)    return _mm512_xor_si512(a,b);
+                if constexpr(OP==Op::AndNot) return _mm512_andnot_si512(b,a);
+            }
+
+            /**
+             * 取得从i开始最多8个字的掩码
+             */
+            inline __mmask8 TailMask(const size_t remain)
+            {
+                return remain>=8?__mmask8(0xFF):__mmask8((1u<<remain)-1);
+            }
+
+            /**
+             * 尾部用掩码读写，不需要标量循环
+             */
+            template<Op OP>
+            void Bulk(uint64 *dst,const uint64 *src,const size_t count)
+            {
+                size_t i=0;
+
+                for(;i+16<=count;i+=16)
+                {
+                    const __m512i r0=Apply512<OP>(_mm512_loadu_si512(dst+i  ),_mm512_loadu_si512(src+i  ));
+                    const __m512i r1=Apply512<OP>(_mm512_loadu_si512(dst+i+8),_mm512_loadu_si512(src+i+8));
+
+                    _mm512_storeu_si512(dst+i  ,r0);
+                    _mm512_storeu_si512(dst+i+8,r1);
+                }
+
+                for(;i<count;i+=8)
+                {
+                    const __mmask8 m=TailMask(count-i);
+
+                    const __m512i r=Apply512<OP>(_mm512_maskz_loadu_epi64(m,dst+i),_mm512_maskz_loadu_epi64(m,src+i));
+
+                    _mm512_mask_storeu_epi64(dst+i,m,r);
+                }
+            }
+
+            inline uint64 PopCount64(const uint64 v)
+            {
+    #if HGL_CPU==HGL_CPU_X86_64
+                return uint64(_mm_popcnt_u64(v));
+    #else
+                return uint64(_mm_popcnt_u32(uint32(v)))+uint64(_mm_popcnt_u32(uint32(v>>32)));
+    #endif
+            }
+        }//namespace
+
+        namespace avx512
+        {
+            void And   (uint64 *dst,const uint64 *src,size_t count){Bulk<Op::And   >(dst,src,count);}
+            void Or    (uint64 *dst,const uint64 *src,size_t count){Bulk<Op::Or    >(dst,src,count);}
+            void Xor   (uint64 *dst,const uint64 *src,size_t count){Bulk<Op::Xor   >(dst,src,count);}
+            void AndNot(uint64 *dst,const uint64 *src,size_t count){Bulk<Op::AndNot>(dst,src,count);}
+
+            /**
+             * AVX2版本的512位扩展（vpshufb查表需要AVX512BW），少于16个字时直接用popcnt
+             */
+            uint64 PopCount(const uint64 *data,size_t count)
+            {
+                if(count<16)
+                {
+                    uint64 total=0;
+
+                    for(size_t i=0;i<count;i++)
+                        total+=PopCount64(data[i]);
+
+                    return total;
+                }
+
+                const __m512i lookup=_mm512_broadcast_i32x4(_mm_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4));
+                const __m512i nibble=_mm512_set1_epi8(0x0F);
+
+                __m512i acc=_mm512_setzero_si512();
+                size_t i=0;
+
+                const auto accumulate=[&](const __m512i v)
+                {
+                    const __m512i lo=_mm512_shuffle_epi8(lookup,_mm512_and_si512(v,nibble));
+                    const __m512i hi=_mm512_shuffle_epi8(lookup,_mm512_and_si512(_mm512_srli_epi16(v,4),nibble));
+
+                    acc=_mm512_add_epi64(acc,_mm512_sad_epu8(_mm512_add_epi8(lo,hi),_mm512_setzero_si512()));
+                };
+
+                for(;i+8<=count;i+=8)
+                    accumulate(_mm512_loadu_si512(data+i));
+
+                if(i<count)
+                    accumulate(_mm512_maskz_loadu_epi64(TailMask(count-i),data+i));
+
+                return uint64(_mm512_reduce_add_epi64(acc));
+            }
+        }//namespace avx512
+    }//namespace bit_vector_detail
+}//namespace hgl
+
+#endif//HGL_SIMD_X86
@@ -0,0 +1,32 @@
+﻿/**
+ * BitVector SSE4.2档次内核（以 HGL_ISA_SSE42_FLAGS 编译）
+ */
+
+#include"BitVectorKernel.h"
+
+#ifdef HGL_SIMD_X86
+
+namespace hgl
+{
+    namespace bit_vector_detail
+    {
+        namespace sse42
+        {
+            uint64 PopCount(const uint64 *data,size_t count)
+            {
+                uint64 total=0;
+
+                for(size_t i=0;i<count;i++)
+    #if HGL_CPU==HGL_CPU_X86_64
+                    total+=uint64(_mm_popcnt_u64(data[i]));
+    #else
+                    total+=uint64(_mm_popcnt_u32(uint32(data[i])))+uint64(_mm_popcnt_u32(uint32(data[i]>>32)));
+    #endif
+
+                return total;
+            }
+        }//namespace sse42
+    }//namespace bit_vector_detail
+}//namespace hgl
+
+#endif//HGL_SIMD_X86
@@ -0,0 +1,65 @@
+﻿#include<hgl/type/BitVector.h>
+#include<hgl/platform/CpuDispatch.h>
+#include"BitVectorKernel.h"
+
+namespace hgl
+{
+    namespace bit_vector_detail
+    {
+        namespace
+        {
+            using BulkFunc=CpuDispatch<void(uint64 *,const uint64 *,size_t)>;
+
+#ifdef HGL_SIMD_X86
+            #define HGL_BIT_VECTOR_KERNEL(name)  name##Scalar,nullptr,avx2::name,avx512::name
+#else
+            #define HGL_BIT_VECTOR_KERNEL(name)  name##Scalar
+#endif//HGL_SIMD_X86
+
+            void AndScalar   (uint64 *dst,const uint64 *src,size_t count){BulkScalar<BitOp::And   >(dst,src,count);}
+            void OrScalar    (uint64 *dst,const uint64 *src,size_t count){BulkScalar<BitOp::Or    >(dst,src,count);}
+            void XorScalar   (uint64 *dst,const uint64 *src,size_t count){BulkScalar<BitOp::Xor   >(dst,src,count);}
+            void AndNotScalar(uint64 *dst,const uint64 *src,size_t count){BulkScalar<BitOp::AndNot>(dst,src,count);}
+
+            const BulkFunc bulk_func[size_t(BitOp::RANGE_SIZE)]=
+            {
+                BulkFunc(HGL_BIT_VECTOR_KERNEL(And)),
+                BulkFunc(HGL_BIT_VECTOR_KERNEL(Or)),
+                BulkFunc(HGL_BIT_VECTOR_KERNEL(Xor)),
+                BulkFunc(HGL_BIT_VECTOR_KERNEL(AndNot))
+            };
+
+            #undef HGL_BIT_VECTOR_KERNEL
+
+            const CpuDispatch<uint64(const uint64 *,size_t)> popcount_func
+            {
+                PopCountScalar
+#ifdef HGL_SIMD_X86
+                ,sse42::PopCount
+                ,avx2::PopCount
+                ,avx512::PopCount
+#endif//HGL_SIMD_X86
+            };
+        }//namespace
+
+        void BulkOp(BitOp op,uint64 *dst,const uint64 *src,size_t count)
+        {
+            bulk_func[size_t(op)](dst,src,count);
+        }
+
+        uint64 PopCount(const uint64 *data,size_t count)
+        {
+            return popcount_func(data,count);
+        }
+
+        void BulkOp(BitOp op,uint64 *dst,const uint64 *src,size_t count,CpuTier tier)
+        {
+            bulk_func[size_t(op)].Get(tier)(dst,src,count);
+        }
+
+        uint64 PopCount(const uint64 *data,size_t count,CpuTier tier)
+        {
+            return popcount_func.Get(tier)(data,count);
+        }
+    }//namespace bit_vector_detail
+}//namespace hgl
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+/**
+ * BitVector 各指令集档次的内核入口，实现分别位于 BitVector.<ISA>.cpp（以对应档次的编译开关编译）
+ * 这些编译单元只包含本文件，避免把库中的内联函数以高档次指令编译出副本
+ */
+
+#include<hgl/platform/CpuFeature.h>
+
+namespace hgl
+{
+    namespace bit_vector_detail
+    {
+#ifdef HGL_SIMD_X86
+        namespace sse42
+        {
+            uint64 PopCount(const uint64 *data,size_t count);
+        }//namespace sse42
+
+        namespace avx2
+        {
+            void And   (uint64 *dst,const uint64 *src,size_t count);
+            void Or    (uint64 *dst,const uint64 *src,size_t count);
+            void Xor   (uint64 *dst,const uint64 *src,size_t count);
+            void AndNot(uint64 *dst,const uint64 *src,size_t count);
+
+            uint64 PopCount(const uint64 *data,size_t count);
+        }//namespace avx2
+
+        namespace avx512
+        {
+            void And   (uint64 *dst,const uint64 *src,size_t count);
+            void Or    (uint64 *dst,const uint64 *src,size_t count);
+            void Xor   (uint64 *dst,const uint64 *src,size_t count);
+            void AndNot(uint64 *dst,const uint64 *src,size_t count);
+
+            uint64 PopCount(const uint64 *data,size_t count);
+        }//namespace avx512
+#endif//HGL_SIMD_X86
+    }//namespace bit_vector_detail
+}//namespace hgl